@@ -0,0 +1,503 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Generates parametrically scaled synthetic Fortran sources for the
+   benchmark suite, output is deterministic for a given set of parameters. */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef struct
+{
+	const char* dir;
+	const char* name;
+	bool        free_form;
+	unsigned    units;
+	unsigned    stmts;
+	unsigned    depth;
+	unsigned    data;
+	unsigned    includes;
+	unsigned    labels;
+	unsigned    ident_len;
+	unsigned    seed;
+} gen_opts_t;
+
+static const gen_opts_t GEN_OPTS_DEFAULT =
+{
+	.dir       = ".",
+	.name      = "bench",
+	.free_form = false,
+	.units     = 1,
+	.stmts     = 100,
+	.depth     = 4,
+	.data      = 0,
+	.includes  = 0,
+	.labels    = 10,
+	.ident_len = 0,
+	.seed      = 1,
+};
+
+/* Number of local variables assigned to in each program unit. */
+#define GEN_VARS 16
+
+/* Longest variable name, including the numeric suffix. */
+#define GEN_IDENT_MAX 63
+
+
+static unsigned gen__ident_len = 0;
+
+/* Variable names are padded to gen__ident_len, to produce identifier
+   heavy source. The result is only valid until the next call. */
+static const char* gen__var(unsigned v)
+{
+	static char name[GEN_IDENT_MAX + 1];
+
+	char suffix[16];
+	int slen = snprintf(suffix, sizeof(suffix), "%u", v);
+
+	int pad = (int)gen__ident_len - slen;
+	if (pad < 1) pad = 1;
+
+	memset(name, 'V', pad);
+	snprintf(&name[pad], (sizeof(name) - pad), "%s", suffix);
+	return name;
+}
+
+
+static unsigned gen__rand_state;
+
+static unsigned gen__rand(void)
+{
+	gen__rand_state = (gen__rand_state * 1103515245) + 12345;
+	return ((gen__rand_state >> 16) & 0x7FFF);
+}
+
+
+typedef struct
+{
+	FILE*    fp;
+	bool     free_form;
+	char*    buff;
+	unsigned size, max;
+} gen_stmt_t;
+
+static bool gen_stmt__append(gen_stmt_t* s, const char* str)
+{
+	unsigned len = strlen(str);
+	if ((s->size + len + 1) > s->max)
+	{
+		unsigned nmax = (s->max << 1);
+		if (nmax < (s->size + len + 1))
+			nmax = (s->size + len + 1);
+		if (nmax < 256)
+			nmax = 256;
+		char* nbuff = (char*)realloc(s->buff, nmax);
+		if (!nbuff) return false;
+		s->buff = nbuff;
+		s->max  = nmax;
+	}
+	memcpy(&s->buff[s->size], str, (len + 1));
+	s->size += len;
+	return true;
+}
+
+static bool gen_stmt__appendf(gen_stmt_t* s, const char* format, ...)
+	__attribute__ ((format (printf, 2, 3)));
+
+static bool gen_stmt__appendf(gen_stmt_t* s, const char* format, ...)
+{
+	char str[256];
+	va_list args;
+	va_start(args, format);
+	int len = vsnprintf(str, sizeof(str), format, args);
+	va_end(args);
+	if ((len < 0) || ((unsigned)len >= sizeof(str)))
+		return false;
+	return gen_stmt__append(s, str);
+}
+
+/* Writes the buffered statement, wrapping it with continuation lines.
+   Statements are only broken at spaces, so that free form is valid. */
+static void gen_stmt__flush(gen_stmt_t* s, unsigned label)
+{
+	const char* text = (s->buff ? s->buff : "");
+	unsigned width = (s->free_form ? 78 : 66);
+
+	bool first = true;
+	while (true)
+	{
+		unsigned len = strlen(text);
+		bool     cont = (len > width);
+		if (cont)
+		{
+			for (len = width; (len > 0) && (text[len] != ' '); len--);
+			if (len == 0) len = width;
+		}
+
+		if (s->free_form)
+		{
+			if (first && (label > 0))
+				fprintf(s->fp, "%u ", label);
+			fprintf(s->fp, "%s%.*s%s\n",
+				(first ? "" : "  "), len, text, (cont ? " &" : ""));
+		}
+		else
+		{
+			if (first && (label > 0))
+				fprintf(s->fp, "%-5u %.*s\n", label, len, text);
+			else
+				fprintf(s->fp, "     %c%.*s\n",
+					(first ? ' ' : '&'), len, text);
+		}
+
+		if (!cont) break;
+		text = &text[len];
+		first = false;
+	}
+
+	s->size = 0;
+	if (s->buff)
+		s->buff[0] = '\0';
+}
+
+static void gen_comment(const gen_stmt_t* s, const char* text)
+{
+	fprintf(s->fp, "%s %s\n", (s->free_form ? "!" : "C"), text);
+}
+
+
+static bool gen_operand(gen_stmt_t* s)
+{
+	unsigned r = gen__rand();
+	if (r & 1)
+		return gen_stmt__append(s, gen__var((r >> 1) % GEN_VARS));
+	return gen_stmt__appendf(s, "%u", ((r >> 1) % 97) + 1);
+}
+
+/* Expressions nest exactly depth parentheses deep with one operator
+   per level, so their length grows linearly with depth. */
+static bool gen_expr(gen_stmt_t* s, unsigned depth)
+{
+	static const char* op[] = { "+", "-", "*" };
+
+	if (depth == 0)
+		return gen_operand(s);
+
+	return gen_stmt__append(s, "(")
+		&& gen_expr(s, (depth - 1))
+		&& gen_stmt__appendf(s, " %s ", op[gen__rand() % 3])
+		&& gen_operand(s)
+		&& gen_stmt__append(s, ")");
+}
+
+static bool gen_include_file(
+	const gen_opts_t* opts, unsigned index)
+{
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%s_inc%u.%s",
+		opts->dir, opts->name, index, (opts->free_form ? "f90" : "f"));
+
+	FILE* fp = fopen(path, "w");
+	if (!fp) return false;
+
+	gen_stmt_t s = { .fp = fp, .free_form = opts->free_form };
+	bool success
+		= gen_stmt__appendf(&s, "INTEGER C%uA, C%uB, C%uC", index, index, index);
+	if (success)
+	{
+		gen_stmt__flush(&s, 0);
+		success = gen_stmt__appendf(&s,
+			"COMMON /CB%u/ C%uA, C%uB, C%uC", index, index, index, index);
+		if (success) gen_stmt__flush(&s, 0);
+	}
+
+	free(s.buff);
+	return ((fclose(fp) == 0) && success);
+}
+
+static bool gen_unit(
+	gen_stmt_t* s, const gen_opts_t* opts, unsigned unit)
+{
+	bool is_main = (unit == 0);
+
+	char name[32];
+	if (is_main)
+		snprintf(name, sizeof(name), "BENCH");
+	else
+		snprintf(name, sizeof(name), "SUB%u", unit);
+
+	if (is_main)
+	{
+		if (!gen_stmt__appendf(s, "PROGRAM %s", name))
+			return false;
+	}
+	else if (!gen_stmt__appendf(s, "SUBROUTINE %s(ARG)", name))
+	{
+		return false;
+	}
+	gen_stmt__flush(s, 0);
+
+	if (!is_main)
+	{
+		if (!gen_stmt__append(s, "INTEGER ARG"))
+			return false;
+		gen_stmt__flush(s, 0);
+	}
+
+	if (!gen_stmt__append(s, "INTEGER"))
+		return false;
+	unsigned v;
+	for (v = 0; v < GEN_VARS; v++)
+	{
+		if (!gen_stmt__appendf(s, "%s %s", (v > 0 ? "," : ""), gen__var(v)))
+			return false;
+	}
+	gen_stmt__flush(s, 0);
+
+	unsigned i;
+	for (i = 0; i < opts->includes; i++)
+	{
+		if (!gen_stmt__appendf(s, "INCLUDE '%s_inc%u.%s'",
+			opts->name, i, (opts->free_form ? "f90" : "f")))
+			return false;
+		gen_stmt__flush(s, 0);
+	}
+
+	if (opts->data > 0)
+	{
+		if (!gen_stmt__appendf(s, "INTEGER TAB(%u)", opts->data))
+			return false;
+		gen_stmt__flush(s, 0);
+
+		for (i = 0; i < opts->data; i += 16)
+		{
+			unsigned last = i + 16;
+			if (last > opts->data)
+				last = opts->data;
+			if (!gen_stmt__appendf(s, "DATA (TAB(%s), %s = %u, %u) /",
+				gen__var(0), gen__var(0), (i + 1), last))
+				return false;
+			unsigned j;
+			for (j = i; j < last; j++)
+			{
+				if (!gen_stmt__appendf(s, "%s %u",
+					(j > i ? "," : ""), (gen__rand() % 1000)))
+					return false;
+			}
+			if (!gen_stmt__append(s, " /"))
+				return false;
+			gen_stmt__flush(s, 0);
+		}
+	}
+
+	for (v = 0; v < GEN_VARS; v++)
+	{
+		if (!gen_stmt__appendf(s, "%s = %u", gen__var(v), (v + 1)))
+			return false;
+		gen_stmt__flush(s, 0);
+	}
+
+	/* Labels are placed on CONTINUE statements and always targeted by a
+	   forward GO TO, so that every label is referenced exactly once. */
+	unsigned label = 0;
+	for (i = 0; i < opts->stmts; i++)
+	{
+		if ((label == 0) && ((gen__rand() % 100) < opts->labels))
+		{
+			label = (i % 99999) + 1;
+			if (!gen_stmt__appendf(s, "IF (%s .GT. 0) GO TO %u",
+				gen__var(gen__rand() % GEN_VARS), label))
+				return false;
+			gen_stmt__flush(s, 0);
+			continue;
+		}
+
+		if (!gen_stmt__appendf(s, "%s = ", gen__var(gen__rand() % GEN_VARS))
+			|| !gen_expr(s, opts->depth))
+			return false;
+		gen_stmt__flush(s, 0);
+
+		if ((label > 0) && ((gen__rand() % 4) == 0))
+		{
+			if (!gen_stmt__append(s, "CONTINUE"))
+				return false;
+			gen_stmt__flush(s, label);
+			label = 0;
+		}
+	}
+	if (label > 0)
+	{
+		if (!gen_stmt__append(s, "CONTINUE"))
+			return false;
+		gen_stmt__flush(s, label);
+	}
+
+	if (is_main)
+	{
+		for (i = 1; i < opts->units; i++)
+		{
+			if (!gen_stmt__appendf(s, "CALL SUB%u(%s)", i, gen__var(i % GEN_VARS)))
+				return false;
+			gen_stmt__flush(s, 0);
+		}
+	}
+
+	if (opts->free_form)
+	{
+		if (!gen_stmt__appendf(s, "END %s %s",
+			(is_main ? "PROGRAM" : "SUBROUTINE"), name))
+			return false;
+	}
+	else if (!gen_stmt__append(s, "END"))
+	{
+		return false;
+	}
+	gen_stmt__flush(s, 0);
+	return true;
+}
+
+static bool gen_file(const gen_opts_t* opts)
+{
+	unsigned i;
+	for (i = 0; i < opts->includes; i++)
+	{
+		if (!gen_include_file(opts, i))
+			return false;
+	}
+
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%s.%s",
+		opts->dir, opts->name, (opts->free_form ? "f90" : "f"));
+
+	FILE* fp = fopen(path, "w");
+	if (!fp) return false;
+
+	gen_stmt_t s = { .fp = fp, .free_form = opts->free_form };
+
+	char comment[256];
+	snprintf(comment, sizeof(comment),
+		"Generated: %s units=%u stmts=%u depth=%u data=%u includes=%u labels=%u",
+		(opts->free_form ? "free" : "fixed"),
+		opts->units, opts->stmts, opts->depth,
+		opts->data, opts->includes, opts->labels);
+	gen_comment(&s, comment);
+
+	bool success = true;
+	for (i = 0; success && (i < opts->units); i++)
+		success = gen_unit(&s, opts, i);
+
+	free(s.buff);
+	return ((fclose(fp) == 0) && success);
+}
+
+
+static void gen_usage(const char* name)
+{
+	fprintf(stderr, "%s [OPTIONS]\n", name);
+	fprintf(stderr, "Options:\n");
+	fprintf(stderr, "  --dir <path>      Output directory\n");
+	fprintf(stderr, "  --name <name>     Output file name, without extension\n");
+	fprintf(stderr, "  --free-form       Emit F90 free form source\n");
+	fprintf(stderr, "  --units <n>       Number of program units\n");
+	fprintf(stderr, "  --stmts <n>       Statements per program unit\n");
+	fprintf(stderr, "  --depth <n>       Expression nesting depth\n");
+	fprintf(stderr, "  --data <n>        DATA table size per program unit\n");
+	fprintf(stderr, "  --includes <n>    INCLUDE files per program unit\n");
+	fprintf(stderr, "  --labels <n>      Percentage of statements carrying a label\n");
+	fprintf(stderr, "  --ident-len <n>   Minimum variable name length\n");
+	fprintf(stderr, "  --seed <n>        Random seed\n");
+}
+
+static bool gen__uint(const char* str, unsigned* value)
+{
+	if (!str) return false;
+	char* end;
+	unsigned long v = strtoul(str, &end, 10);
+	if ((end == str) || (*end != '\0'))
+		return false;
+	*value = v;
+	return true;
+}
+
+int main(int argc, const char* argv[])
+{
+	gen_opts_t opts = GEN_OPTS_DEFAULT;
+
+	int i;
+	for (i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* param = ((i + 1) < argc ? argv[i + 1] : NULL);
+
+		bool valid = true;
+		if (strcmp(arg, "--free-form") == 0)
+		{
+			opts.free_form = true;
+			continue;
+		}
+		else if (strcmp(arg, "--dir") == 0)
+			opts.dir = param;
+		else if (strcmp(arg, "--name") == 0)
+			opts.name = param;
+		else if (strcmp(arg, "--units") == 0)
+			valid = gen__uint(param, &opts.units);
+		else if (strcmp(arg, "--stmts") == 0)
+			valid = gen__uint(param, &opts.stmts);
+		else if (strcmp(arg, "--depth") == 0)
+			valid = gen__uint(param, &opts.depth);
+		else if (strcmp(arg, "--data") == 0)
+			valid = gen__uint(param, &opts.data);
+		else if (strcmp(arg, "--includes") == 0)
+			valid = gen__uint(param, &opts.includes);
+		else if (strcmp(arg, "--labels") == 0)
+			valid = gen__uint(param, &opts.labels);
+		else if (strcmp(arg, "--ident-len") == 0)
+			valid = gen__uint(param, &opts.ident_len);
+		else if (strcmp(arg, "--seed") == 0)
+			valid = gen__uint(param, &opts.seed);
+		else
+			valid = false;
+
+		if (!valid || !param)
+		{
+			fprintf(stderr, "Error: Invalid argument '%s'\n", arg);
+			gen_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		i++;
+	}
+
+	if ((opts.units == 0) || (opts.labels > 100)
+		|| (opts.ident_len > GEN_IDENT_MAX))
+	{
+		gen_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	gen__rand_state = opts.seed;
+	gen__ident_len  = opts.ident_len;
+	if (!gen_file(&opts))
+	{
+		fprintf(stderr, "Error: Failed to write '%s/%s'\n",
+			opts.dir, opts.name);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
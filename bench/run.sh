@@ -0,0 +1,121 @@
+#!/bin/sh
+# Generates each scaled corpus, runs ofc over it and writes a JSON report.
+#
+# Usage: run.sh FRONTEND GENERATOR OUTDIR
+#
+# Each series scales one parameter while the others stay at their base
+# value, "exponent" is the measured growth of total time relative to the
+# previous point in the series, so 1.0 is linear and 2.0 is quadratic.
+# Every series is run once as fixed form F77 and once as free form F90,
+# BENCH_FORMS selects a subset.
+
+FRONTEND=$1
+GEN=$2
+OUT=$3
+
+if [ -z "$FRONTEND" ] || [ -z "$GEN" ] || [ -z "$OUT" ]; then
+	echo "Usage: $0 FRONTEND GENERATOR OUTDIR" >&2
+	exit 1
+fi
+
+BASE_UNITS=${BENCH_UNITS:-1}
+BASE_STMTS=${BENCH_STMTS:-1000}
+BASE_DEPTH=${BENCH_DEPTH:-4}
+BASE_DATA=${BENCH_DATA:-0}
+BASE_INCLUDES=${BENCH_INCLUDES:-0}
+BASE_LABELS=${BENCH_LABELS:-10}
+BASE_IDENTS=${BENCH_IDENTS:-0}
+FORMS=${BENCH_FORMS:-fixed free}
+
+SERIES="
+stmts:1000 2000 4000 8000
+depth:8 16 32 64
+units:10 20 40 80
+data:1000 2000 4000 8000
+includes:4 8 16 32
+labels:0 25 50 100
+idents:8 16 32 63
+"
+
+mkdir -p "$OUT" || exit 1
+REPORT="$OUT/report.json"
+
+printf '{\n  "frontend": "%s",\n  "results": [' "$FRONTEND" > "$REPORT"
+
+first=1
+failed=0
+for form in $FORMS; do
+	case $form in
+		fixed) form_arg=""; ext=f ;;
+		free)  form_arg="--free-form"; ext=f90 ;;
+		*) echo "Error: Unknown form '$form'" >&2; exit 1 ;;
+	esac
+
+	while IFS=: read -r param values; do
+		[ -z "$param" ] && continue
+
+		prev_value=""
+		prev_total=""
+		for value in $values; do
+			units=$BASE_UNITS; stmts=$BASE_STMTS; depth=$BASE_DEPTH
+			data=$BASE_DATA; includes=$BASE_INCLUDES; labels=$BASE_LABELS
+			idents=$BASE_IDENTS
+			eval "$param=$value"
+
+			name="${form}_${param}_${value}"
+			dir="$OUT/$name"
+			mkdir -p "$dir" || exit 1
+
+			"$GEN" --dir "$dir" --name bench $form_arg \
+				--units "$units" --stmts "$stmts" --depth "$depth" \
+				--data "$data" --includes "$includes" --labels "$labels" \
+				--ident-len "$idents" || exit 1
+
+			"$FRONTEND" --no-warn --time-phases --sema-tree \
+				"$dir/bench.$ext" > /dev/null 2> "$dir/stderr.txt"
+			status=$?
+			times=$(sed -n 's/^Time:\(.*\): \(.*\)$/\1 \2/p' "$dir/stderr.txt")
+			total=$(echo "$times" | awk '$1 == "total" { print $2 }')
+			if [ $status -ne 0 ] || [ -z "$total" ]; then
+				echo "Error: ofc failed on $name, see $dir/stderr.txt" >&2
+				failed=1
+				total=0
+			fi
+
+			exponent=$(awk -v v="$value" -v pv="$prev_value" \
+				-v t="$total" -v pt="$prev_total" 'BEGIN {
+					if ((pv == "") || (pv <= 0) || (v == pv) || (pt <= 0) || (t <= 0))
+						print "null";
+					else
+						printf "%.3f", log(t / pt) / log(v / pv);
+				}')
+
+			if [ $first -eq 0 ]; then printf ',' >> "$REPORT"; fi
+			first=0
+
+			{
+				printf '\n    { "corpus": "%s", "form": "%s", "param": "%s", "value": %s,\n' \
+					"$name" "$form" "$param" "$value"
+				printf '      "units": %s, "stmts": %s, "depth": %s, "data": %s, "includes": %s, "labels": %s, "idents": %s,\n' \
+					"$units" "$stmts" "$depth" "$data" "$includes" "$labels" "$idents"
+				printf '      "bytes": %s, "status": %s, "exponent": %s,\n' \
+					"$(cat "$dir"/bench*.$ext | wc -c)" "$status" "$exponent"
+				printf '      "phases": {'
+				echo "$times" | awk 'NF == 2 {
+					printf "%s \"%s\": %s", (n++ ? "," : ""), $1, $2 }'
+				printf ' } }'
+			} >> "$REPORT"
+
+			printf '%-22s %10ss  exponent %s\n' "$name" "$total" "$exponent"
+
+			prev_value=$value
+			prev_total=$total
+		done
+	done <<-END_SERIES
+	$SERIES
+	END_SERIES
+done
+
+printf '\n  ]\n}\n' >> "$REPORT"
+echo "Report written to $REPORT"
+exit $failed
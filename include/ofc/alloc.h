@@ -0,0 +1,87 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_alloc_h__
+#define __ofc_alloc_h__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Every allocation is accounted to the subsystem which owns it. */
+typedef enum
+{
+	OFC_ALLOC_MISC = 0,
+	OFC_ALLOC_FILE,
+	OFC_ALLOC_SPARSE,
+	OFC_ALLOC_PARSE,
+	OFC_ALLOC_PARSE_DEBUG,
+	OFC_ALLOC_SEMA,
+	OFC_ALLOC_SEMA_DECL,
+	OFC_ALLOC_SEMA_EXPR,
+	OFC_ALLOC_TYPEVAL,
+	OFC_ALLOC_HASHMAP,
+	OFC_ALLOC_COLSTR,
+	OFC_ALLOC_DIAG,
+
+	OFC_ALLOC_TAG_COUNT
+} ofc_alloc_tag_e;
+
+const char* ofc_alloc_tag_name(ofc_alloc_tag_e tag);
+
+/* These behave like their C library counterparts, except that memory from
+   one must only be freed or reallocated by the others. ofc_realloc only
+   uses tag when ptr is NULL, a block keeps the tag it was allocated with. */
+void* ofc_alloc(ofc_alloc_tag_e tag, size_t size);
+void* ofc_calloc(ofc_alloc_tag_e tag, size_t count, size_t size);
+void* ofc_realloc(ofc_alloc_tag_e tag, void* ptr, size_t size);
+char* ofc_strdup(ofc_alloc_tag_e tag, const char* str);
+void  ofc_free(void* ptr);
+
+/* A backend replaces malloc, realloc and free for one tag, for example
+   with a pool or an arena. It must be safe to call from any thread. */
+typedef struct
+{
+	void* (*alloc)(void* param, size_t size);
+	void* (*realloc)(void* param, void* ptr, size_t size);
+	void  (*free)(void* param, void* ptr);
+	void* param;
+} ofc_alloc_backend_t;
+
+/* Passing NULL restores malloc, a tag's backend can only be changed
+   while none of its allocations are live. */
+bool ofc_alloc_backend_set(
+	ofc_alloc_tag_e tag, const ofc_alloc_backend_t* backend);
+
+/* Bucket i counts requests of up to 16 << i bytes,
+   the last bucket counts everything larger. */
+#define OFC_ALLOC_HISTOGRAM_SIZE 16
+
+typedef struct
+{
+	size_t   live, peak;
+	uint64_t allocs, reallocs, frees;
+	uint64_t histogram[OFC_ALLOC_HISTOGRAM_SIZE];
+} ofc_alloc_stats_t;
+
+/* Passing OFC_ALLOC_TAG_COUNT gives the totals over every tag. Other
+   threads report their counts in batches, and as they exit. */
+void ofc_alloc_stats(
+	ofc_alloc_tag_e tag, ofc_alloc_stats_t* stats);
+
+/* Machine readable, one line per tag, for the benchmark suite. */
+bool ofc_alloc_report(int fd);
+
+#endif
@@ -35,6 +35,20 @@ typedef enum
 	PARSE_ONLY,
 	PARSE_TREE,
 	SEMA_TREE,
+	STREAM,
+	TIME_PHASES,
+	MEM_STATS,
+	DATAFLOW,
+	CALL_GRAPH_DOT,
+	CALL_GRAPH_BIN,
+	PROJECT,
+	INCREMENTAL,
+	SERVER,
+	EMIT_F90,
+	DIAG_JSON,
+	DIAG_SARIF,
+	DIAG_LIMIT,
+	JOBS,
 	FIXED_FORM,
 	FREE_FORM,
 	TAB_FORM,
@@ -49,6 +63,8 @@ typedef enum
 typedef enum
 {
 	GLOB_NONE = 0,
+	GLOB_INT,
+	GLOB_STR,
 	LANG_NONE,
 	LANG_INT
 
@@ -68,9 +84,12 @@ typedef struct
 typedef struct
 {
 	const ofc_cliarg_body_t* body;
-	int  value;
-	/* This will become a union when more argument
-	   value types are needed. */
+
+	union
+	{
+		int         value;
+		const char* str;
+	};
 } ofc_cliarg_t;
 
 typedef struct
@@ -91,6 +110,9 @@ void print_usage(const char* name);
 ofc_cliarg_t* ofc_cliarg_create(
 	const ofc_cliarg_body_t* arg_prop,
 	int value);
+ofc_cliarg_t* ofc_cliarg_create_str(
+	const ofc_cliarg_body_t* arg_prop,
+	const char* str);
 void ofc_cliarg_delete(ofc_cliarg_t* arg);
 
 ofc_cliarg_list_t* ofc_cliarg_list_create(void);
@@ -24,10 +24,33 @@ ofc_colstr_t* ofc_colstr_create(
 	unsigned cols, unsigned ext);
 void ofc_colstr_delete(ofc_colstr_t* cstr);
 
+/* Free form lines are up to cols long and have no label field,
+   printers keep the comments from the source in free form. */
+ofc_colstr_t* ofc_colstr_create_free(unsigned cols);
+bool ofc_colstr_is_free(const ofc_colstr_t* cstr);
+
+/* An empty buffer with the same columns and form as cstr. */
+ofc_colstr_t* ofc_colstr_create_like(
+	const ofc_colstr_t* cstr);
+
+/* Empties cstr so it can be reused once it's been written out. */
+void ofc_colstr_reset(ofc_colstr_t* cstr);
+
 bool ofc_colstr_newline(
 	ofc_colstr_t* cstr, unsigned indent,
 	const unsigned* label);
 
+/* Writes a comment on its own line, without the leading '!'. */
+bool ofc_colstr_comment(
+	ofc_colstr_t* cstr, unsigned indent,
+	const char* base, unsigned size);
+
+/* Writes a comment after the current line if it fits,
+   otherwise on a line of its own. */
+bool ofc_colstr_comment_trailing(
+	ofc_colstr_t* cstr, unsigned indent,
+	const char* base, unsigned size);
+
 #include <stdarg.h>
 
 bool ofc_colstr_write_escaped(
@@ -47,6 +70,15 @@ bool ofc_colstr_atomic_writef(
 	ofc_colstr_t* cstr,
 	const char* format, ...);
 
+/* Appends src as if it had been written to cstr, this is only
+   equivalent when the first thing written to src was a newline. */
+bool ofc_colstr_append(
+	ofc_colstr_t* cstr, const ofc_colstr_t* src);
+
 bool ofc_colstr_fdprint(ofc_colstr_t* cstr, int fd);
 
+/* What's been written so far, which isn't NUL terminated. */
+const char* ofc_colstr_get(
+	const ofc_colstr_t* cstr, unsigned* size);
+
 #endif
@@ -0,0 +1,105 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __ofc_context_h__
+#define __ofc_context_h__
+
+#include <stdbool.h>
+
+#include "ofc/global_opts.h"
+#include "ofc/lang_opts.h"
+#include "ofc/diag.h"
+#include "ofc/hashmap.h"
+#include "ofc/file.h"
+#include "ofc/sparse.h"
+#include "ofc/sema.h"
+
+typedef struct ofc_sema_typeval__block_s ofc_sema_typeval__block_t;
+typedef union  ofc_sema_typeval__pool_u  ofc_sema_typeval__pool_t;
+
+/* A context owns everything the front end would otherwise keep per
+   process. Contexts are independent and the trees analysed in one
+   belong to it. Callers mustn't use a context from two threads at once,
+   but while one does the front end's own parse and print workers enter
+   it too, they only read its options and trees and add diagnostics
+   through its sink, which is locked. */
+typedef struct ofc_context_s
+{
+	ofc_global_opts_t global_opts;
+
+	unsigned target_logical_size;
+	unsigned target_integer_size;
+	unsigned target_real_size;
+	unsigned target_pointer_size;
+
+	/* NULL for the default context, which uses the shared sink. */
+	ofc_diag_t* diag;
+
+	ofc_hashmap_t*             sema_type_map;
+	ofc_sema_typeval__pool_t*  sema_typeval_pool;
+	ofc_sema_typeval__block_t* sema_typeval_block;
+
+	/* Cached by ofc_sema_type_*_default, they're owned by the map. */
+	struct
+	{
+		const ofc_sema_type_t* logical;
+		const ofc_sema_type_t* integer;
+		const ofc_sema_type_t* real;
+		const ofc_sema_type_t* dbl;
+		const ofc_sema_type_t* complex;
+		const ofc_sema_type_t* dbl_complex;
+		const ofc_sema_type_t* byte;
+		const ofc_sema_type_t* subroutine;
+		const ofc_sema_type_t* type;
+		const ofc_sema_type_t* record;
+	} sema_type_default;
+
+	ofc_file_t*            file;
+	ofc_sparse_t*          condense;
+	ofc_parse_stmt_list_t* program;
+	ofc_sema_scope_t*      sema;
+} ofc_context_t;
+
+ofc_context_t* ofc_context_create(
+	const ofc_global_opts_t* global_opts);
+void ofc_context_delete(ofc_context_t* context);
+
+/* The context used by the ofc executable, and by any thread
+   which hasn't entered another one. */
+ofc_context_t* ofc_context_default(void);
+
+/* The calling thread's context. */
+ofc_context_t* ofc_context_current(void);
+
+/* Makes context current on the calling thread until it's left,
+   returns the context to pass to ofc_context_leave. */
+ofc_context_t* ofc_context_enter(ofc_context_t* context);
+void ofc_context_leave(ofc_context_t* previous);
+
+/* The number of threads to work on, one per CPU unless it's set. */
+unsigned ofc_context_jobs(const ofc_context_t* context);
+
+ofc_diag_t* ofc_context_diag(ofc_context_t* context);
+
+/* Analyses text as the contents of path, the tree is valid until the
+   context analyses something else or is deleted. Returns NULL only when
+   the source couldn't be preprocessed, parsed or analysed at all, a tree
+   may still be returned for a source with errors so count them in the
+   context's sink, which holds the diagnostics either way. */
+const ofc_sema_scope_t* ofc_context_analyse(
+	ofc_context_t* context,
+	const char* path, const char* text,
+	const ofc_lang_opts_t* lang_opts);
+
+#endif
@@ -0,0 +1,107 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_diag_h__
+#define __ofc_diag_h__
+
+#include <stdbool.h>
+
+typedef enum
+{
+	OFC_DIAG_ERROR = 0,
+	OFC_DIAG_WARNING,
+
+	OFC_DIAG_SEVERITY_COUNT
+} ofc_diag_severity_e;
+
+typedef enum
+{
+	OFC_DIAG_FORMAT_TEXT = 0,
+	OFC_DIAG_FORMAT_JSON,
+	OFC_DIAG_FORMAT_SARIF,
+} ofc_diag_format_e;
+
+/* A diagnostic sink collects diagnostics until it's flushed,
+   all functions are safe to call from multiple threads. */
+typedef struct ofc_diag_s ofc_diag_t;
+
+ofc_diag_t* ofc_diag_create(void);
+void        ofc_diag_delete(ofc_diag_t* diag);
+
+/* The sink used by ofc_file_error and ofc_file_warning,
+   the current context's sink unless it's the default context. */
+ofc_diag_t* ofc_diag_default(void);
+
+/* Makes ofc_diag_default return diag on the calling thread,
+   passing NULL restores the shared sink. */
+void ofc_diag_redirect(ofc_diag_t* diag);
+
+void ofc_diag_set_format(
+	ofc_diag_t* diag, ofc_diag_format_e format);
+
+/* Text diagnostics are written to fd in batches as they're added,
+   when the sink is synced, and if we're killed by a fatal signal,
+   rather than only when flushed. They're still kept until flushed,
+   -1 stops this. */
+void ofc_diag_set_output(
+	ofc_diag_t* diag, int fd);
+
+/* Writes any text diagnostics not yet written to the output. */
+bool ofc_diag_sync(ofc_diag_t* diag);
+
+/* Limit the number of times an identical warning message is reported,
+   zero means there's no limit. */
+void ofc_diag_set_limit(
+	ofc_diag_t* diag, unsigned limit);
+
+/* Context is the source text the diagnostic points into, col is
+   relative to its last line. Duplicate diagnostics are dropped. */
+bool ofc_diag_add(
+	ofc_diag_t* diag, ofc_diag_severity_e severity,
+	const char* path, bool positional,
+	unsigned row, unsigned col,
+	const char* context, const char* message);
+
+unsigned ofc_diag_count(
+	const ofc_diag_t* diag, ofc_diag_severity_e severity);
+
+typedef struct
+{
+	ofc_diag_severity_e severity;
+	const char*         path;
+	bool                positional;
+	unsigned            row, col;
+	const char*         context;
+	const char*         message;
+} ofc_diag_info_t;
+
+/* Calls func for each diagnostic in the order they were added until
+   it returns false, func mustn't add diagnostics to the same sink. */
+bool ofc_diag_foreach(
+	ofc_diag_t* diag, void* param,
+	bool (*func)(const ofc_diag_info_t* info, void* param));
+
+/* Adds every diagnostic in src to diag in the order they were added. */
+bool ofc_diag_merge(ofc_diag_t* diag, ofc_diag_t* src);
+
+/* Drops every diagnostic and forgets all counts and repeats. */
+void ofc_diag_reset(ofc_diag_t* diag);
+
+/* Writes text diagnostics not yet written to an output in the order
+   they were added, or sorts the others by file and position and writes
+   them as one document, to fd in a single write, then empties the sink. */
+bool ofc_diag_flush(ofc_diag_t* diag, int fd);
+
+#endif
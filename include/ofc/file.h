@@ -26,12 +26,18 @@ typedef struct
 	char*           strz;
 	ofc_lang_opts_t opts;
 	unsigned        size;
+	bool            mapped;
 	unsigned        ref;
 } ofc_file_t;
 
 /* Path must be valid for as long as the ofc_file_t* is */
 ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts);
 ofc_file_t* ofc_file_create_include(const char* path, ofc_lang_opts_t opts, const char* include);
+/* Takes a copy of strz in place of reading path. */
+ofc_file_t* ofc_file_create_strz(const char* path, ofc_lang_opts_t opts, const char* strz);
+/* Maps path rather than reading it, so that text which is no longer
+   needed can be given back with ofc_file_release. */
+ofc_file_t* ofc_file_create_mapped(const char* path, ofc_lang_opts_t opts);
 bool        ofc_file_reference(ofc_file_t* file);
 void        ofc_file_delete(ofc_file_t* file);
 
@@ -43,6 +49,10 @@ ofc_lang_opts_t ofc_file_get_lang_opts(const ofc_file_t* file);
 char* ofc_file_include_path(
 	const ofc_file_t* file, const char* path);
 
+/* Drops the pages of a mapped file which are wholly before ptr, they're
+   read from the file again if anything refers to them later. */
+void ofc_file_release(const ofc_file_t* file, const char* ptr);
+
 bool ofc_file_get_position(
 	const ofc_file_t* file, const char* ptr,
 	unsigned* row, unsigned* col);
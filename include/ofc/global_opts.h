@@ -17,6 +17,8 @@
 #define __ofc_global_opts_h__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include "ofc/diag.h"
 
 typedef struct
 {
@@ -26,6 +28,26 @@ typedef struct
 	bool parse_only;
 	bool parse_print;
 	bool sema_print;
+	bool time_phases;
+	bool mem_stats;
+	bool dataflow;
+	bool call_graph_dot;
+	bool call_graph_bin;
+	bool server;
+	bool stream;
+
+	ofc_diag_format_e diag_format;
+	unsigned          diag_limit;
+
+	unsigned jobs;
+
+	const char* project;
+	const char* incremental;
+
+	/* The directory --emit-f90 writes to, and every source it converts. */
+	const char*        emit_f90;
+	const char* const* sources;
+	unsigned           source_count;
 
 } ofc_global_opts_t;
 
@@ -38,6 +60,21 @@ static const ofc_global_opts_t
 	.parse_only           = false,
 	.parse_print          = false,
 	.sema_print           = false,
+	.time_phases          = false,
+	.mem_stats            = false,
+	.dataflow             = false,
+	.call_graph_dot       = false,
+	.call_graph_bin       = false,
+	.server               = false,
+	.stream               = false,
+	.diag_format          = OFC_DIAG_FORMAT_TEXT,
+	.diag_limit           = 0,
+	.jobs                 = 0,
+	.project              = NULL,
+	.incremental          = NULL,
+	.emit_f90             = NULL,
+	.sources              = NULL,
+	.source_count         = 0,
 };
 
 #endif
@@ -0,0 +1,37 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_numfmt_h__
+#define __ofc_numfmt_h__
+
+#include <stdint.h>
+#include "ofc/real.h"
+
+/* Large enough for any number either function writes. */
+#define OFC_NUMFMT_MAX 64
+
+/* Writes value in decimal, returns the number of characters written. */
+unsigned ofc_numfmt_integer(char* buff, int64_t value);
+
+/* Writes value as a REAL constant once it's rounded to the binary format
+   with size bytes, or kept as it is when size is zero. We write the fewest
+   digits which read back as the same value, laid out like printf's %G would
+   for precision, and exp is the exponent letter of the constant's kind.
+   Returns the number of characters written. */
+unsigned ofc_numfmt_real(
+	char* buff, ofc_real_t value,
+	unsigned size, unsigned precision, char exp);
+
+#endif
@@ -16,6 +16,7 @@
 #ifndef __ofc_parse_h__
 #define __ofc_parse_h__
 
+#include <ofc/alloc.h>
 #include <ofc/sparse.h>
 #include <ofc/str_ref.h>
 #include <ofc/fctype.h>
@@ -25,6 +25,12 @@ bool ofc_parse_file_include(
 
 ofc_parse_stmt_list_t* ofc_parse_file(const ofc_sparse_t* src);
 
+/* Prints the top level statements, mostly whole program units,
+   as ofc_parse_stmt_list_print does but concurrently. */
+bool ofc_parse_file_print_units(
+	ofc_colstr_t* cs,
+	const ofc_parse_stmt_list_t* list);
+
 bool ofc_parse_file_print(
 	ofc_colstr_t* cs,
 	const ofc_parse_stmt_list_t* list);
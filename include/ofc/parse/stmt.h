@@ -293,6 +293,13 @@ bool ofc_parse_stmt_sublist(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len);
+/* Stops before the first statement which starts at or after end. */
+bool ofc_parse_stmt_sublist_until(
+	ofc_parse_stmt_list_t* list,
+	const ofc_sparse_t* src, const char* ptr,
+	const char* end,
+	ofc_parse_debug_t* debug,
+	unsigned* len);
 ofc_parse_stmt_list_t* ofc_parse_stmt_list(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
@@ -309,6 +316,11 @@ bool ofc_parse_stmt_list_foreach(
 bool ofc_parse_stmt_list_print(
 	ofc_colstr_t* cs, unsigned indent,
 	const ofc_parse_stmt_list_t* list);
+/* Prints the statements from start up to but not including end. */
+bool ofc_parse_stmt_list_print_range(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_parse_stmt_list_t* list,
+	unsigned start, unsigned end);
 
 bool ofc_parse_stmt_list_contains_error(
 	const ofc_parse_stmt_list_t* list);
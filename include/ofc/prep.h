@@ -23,4 +23,16 @@ ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file);
 ofc_sparse_t* ofc_prep_condense(ofc_sparse_t* unformat);
 ofc_sparse_t* ofc_prep(ofc_file_t* file);
 
+/* Unformats file from *offset to the end of the next program unit,
+   and moves *offset to the line after it. */
+ofc_sparse_t* ofc_prep_unformat_unit(
+	ofc_file_t* file, unsigned* offset);
+
+/* Preprocesses a file one program unit at a time, so only the unit
+   being worked on needs to be in memory. Call with *offset at zero,
+   *condense is NULL once the whole file has been read. */
+bool ofc_prep_unit(
+	ofc_file_t* file, unsigned* offset,
+	ofc_sparse_t** condense);
+
 #endif
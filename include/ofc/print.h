@@ -0,0 +1,36 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_print_h__
+#define __ofc_print_h__
+
+#include <stdbool.h>
+
+#include "ofc/colstr.h"
+
+/* Prints one part, the first thing it writes must be a newline. */
+typedef bool (*ofc_print_part_f)(
+	ofc_colstr_t* cs, unsigned indent,
+	const void* param, unsigned part);
+
+/* Prints count parts to cs in order. When there's more than one job the
+   parts are printed concurrently into their own buffers, which are then
+   appended to cs, so the result is the same either way. */
+bool ofc_print_parts(
+	ofc_colstr_t* cs, unsigned indent,
+	const void* param, unsigned count,
+	ofc_print_part_f func);
+
+#endif
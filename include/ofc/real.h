@@ -0,0 +1,36 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_real_h__
+#define __ofc_real_h__
+
+#include <stdlib.h>
+#include <float.h>
+
+/* REAL constants are held in binary128 where the compiler and C library
+   support it, so that REAL*16 keeps its precision, otherwise we fall
+   back to long double. */
+#if defined(__HAVE_FLOAT128) && __HAVE_FLOAT128 && defined(__FLT128_MANT_DIG__)
+#define OFC_REAL_BINARY128
+typedef _Float128 ofc_real_t;
+#define OFC_REAL_MANT_DIG __FLT128_MANT_DIG__
+#define OFC_REAL_DIG      __FLT128_DIG__
+#else
+typedef long double ofc_real_t;
+#define OFC_REAL_MANT_DIG LDBL_MANT_DIG
+#define OFC_REAL_DIG      LDBL_DIG
+#endif
+
+#endif
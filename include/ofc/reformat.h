@@ -0,0 +1,32 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_reformat_h__
+#define __ofc_reformat_h__
+
+#include <stdbool.h>
+
+#include "ofc/lang_opts.h"
+
+/* Analyses each source and writes it as free form F90 into dir, keeping
+   relative paths below it. Sources are handled concurrently in their own
+   contexts, and their diagnostics go to the shared sink. Returns false if
+   any source failed, the others are still written. */
+bool ofc_reformat_f90(
+	const char* dir,
+	const char* const* path, unsigned count,
+	const ofc_lang_opts_t* lang_opts);
+
+#endif
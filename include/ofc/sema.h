@@ -18,6 +18,7 @@
 
 #include <ofc/parse.h>
 #include <ofc/hashmap.h>
+#include <ofc/real.h>
 
 typedef struct ofc_sema_stmt_s     ofc_sema_stmt_t;
 typedef struct ofc_sema_scope_s    ofc_sema_scope_t;
@@ -38,6 +39,7 @@ typedef struct ofc_sema_format_label_list_s ofc_sema_format_label_list_t;
 
 #include <ofc/sema/array.h>
 #include <ofc/sema/structure.h>
+#include <ofc/sema/fold.h>
 #include <ofc/sema/typeval.h>
 #include <ofc/sema/parameter.h>
 #include <ofc/sema/equiv.h>
@@ -47,6 +49,11 @@ typedef struct ofc_sema_format_label_list_s ofc_sema_format_label_list_t;
 #include <ofc/sema/intrinsic.h>
 #include <ofc/sema/io.h>
 #include <ofc/sema/arg.h>
+#include <ofc/sema/callgraph.h>
+#include <ofc/sema/project.h>
+#include <ofc/sema/incremental.h>
+#include <ofc/sema/index.h>
+#include <ofc/sema/dataflow.h>
 
 #include <ofc/sema/stmt.h>
 #include <ofc/sema/type.h>
@@ -21,11 +21,18 @@ typedef struct
 {
 	ofc_sema_expr_t* first;
 	ofc_sema_expr_t* last;
+
+	/* Resolved shape, only valid once the array's shape is resolved. */
+	int64_t  lower;
+	uint64_t extent;
+	uint64_t stride;
 } ofc_sema_array_dims_t;
 
 typedef struct
 {
 	unsigned              dimensions;
+	bool                  shape_resolved;
+	uint64_t              total;
 	ofc_sema_array_dims_t segment[0];
 } ofc_sema_array_t;
 
@@ -50,6 +57,27 @@ bool ofc_sema_array_total(
 	const ofc_sema_array_t* array,
 	unsigned* total);
 
+/* Resolves constant bounds once and caches them on the array,
+   fails for assumed size/shape or non-constant bounds. */
+bool ofc_sema_array_shape_resolve(
+	const ofc_sema_array_t* array);
+bool ofc_sema_array_total64(
+	const ofc_sema_array_t* array,
+	uint64_t* total);
+
+/* Column-major conversion between subscripts and element offsets. */
+bool ofc_sema_array_subscript_offset(
+	const ofc_sema_array_t* array,
+	const int64_t* subscript,
+	uint64_t* offset);
+bool ofc_sema_array_offset_subscript(
+	const ofc_sema_array_t* array,
+	uint64_t offset, int64_t* subscript);
+bool ofc_sema_array_subscript_print(
+	ofc_colstr_t* cs,
+	const ofc_sema_array_t* array,
+	const int64_t* subscript);
+
 bool ofc_sema_array_print(
 	ofc_colstr_t* cs,
 	const ofc_sema_array_t* array);
@@ -0,0 +1,126 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_callgraph_h__
+#define __ofc_sema_callgraph_h__
+
+typedef struct
+{
+	/* Only set for dummy arguments. */
+	ofc_str_ref_t          name;
+	const ofc_sema_type_t* type;
+	bool                   is_array;
+	bool                   alt_return;
+} ofc_sema_call_arg_t;
+
+typedef struct
+{
+	bool             is_function;
+	ofc_str_ref_t    caller;
+	ofc_sparse_ref_t name;
+	ofc_sparse_ref_t src;
+
+	/* Return type as seen by the caller, functions only. */
+	const ofc_sema_type_t* type;
+
+	unsigned             count;
+	ofc_sema_call_arg_t* arg;
+
+	/* Valid once the graph is linked. */
+	unsigned caller_node;
+	unsigned callee_node;
+	bool     mismatch;
+} ofc_sema_call_t;
+
+/* Interface of a procedure as seen by its callers. */
+typedef struct
+{
+	bool                   is_function;
+	const ofc_sema_type_t* type;
+	unsigned               count;
+	ofc_sema_call_arg_t*   arg;
+} ofc_sema_signature_t;
+
+typedef struct
+{
+	ofc_str_ref_t name;
+	unsigned      index;
+
+	/* NULL for procedures defined outside of this source. */
+	const ofc_sema_scope_t* scope;
+	ofc_sema_signature_t*   signature;
+} ofc_sema_callgraph_node_t;
+
+typedef struct
+{
+	bool case_sensitive;
+
+	unsigned          count, size;
+	ofc_sema_call_t** call;
+
+	bool                        linked;
+	unsigned                    node_count;
+	ofc_sema_callgraph_node_t** node;
+	ofc_hashmap_t*              node_map;
+} ofc_sema_callgraph_t;
+
+ofc_sema_signature_t* ofc_sema_signature_create(
+	bool is_function,
+	const ofc_sema_type_t* type,
+	unsigned count);
+ofc_sema_signature_t* ofc_sema_signature(
+	const ofc_sema_scope_t* scope,
+	const ofc_sema_decl_t*  decl);
+void ofc_sema_signature_delete(
+	ofc_sema_signature_t* signature);
+
+/* Warns about each way call doesn't match signature, origin names
+   the file the callee was defined in when it's not this one. */
+bool ofc_sema_call_check(
+	ofc_sema_call_t* call,
+	const ofc_sema_signature_t* signature,
+	const char* origin);
+
+ofc_sema_callgraph_t* ofc_sema_callgraph_create(
+	bool case_sensitive);
+void ofc_sema_callgraph_delete(
+	ofc_sema_callgraph_t* graph);
+
+/* Records a CALL or function reference made from scope in the
+   graph owned by the root scope, args may be NULL. */
+bool ofc_sema_callgraph_add(
+	ofc_sema_scope_t* scope,
+	bool is_function,
+	ofc_sparse_ref_t name,
+	ofc_sparse_ref_t src,
+	const ofc_sema_type_t* type,
+	const ofc_sema_expr_list_t* args);
+
+/* Resolves every call against the program units of root and
+   warns about calls which don't match the callee's signature. */
+bool ofc_sema_callgraph_link(
+	ofc_sema_callgraph_t* graph,
+	const ofc_sema_scope_t* root);
+
+bool ofc_sema_callgraph_print_dot(
+	const ofc_sema_callgraph_t* graph, int fd);
+
+/* Little-endian: "OFCG", version, node count, edge count,
+   then each node as kind and length prefixed name, then each
+   edge as caller, callee, call count and flags. */
+bool ofc_sema_callgraph_write(
+	const ofc_sema_callgraph_t* graph, int fd);
+
+#endif
@@ -0,0 +1,24 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_dataflow_h__
+#define __ofc_sema_dataflow_h__
+
+/* Warns where a local scalar may be used before it's set, where a value
+   assigned to one is never used, and where one is set but never used.
+   Returns false only if the analysis couldn't be run. */
+bool ofc_sema_dataflow(const ofc_sema_scope_t* scope);
+
+#endif
@@ -214,6 +214,9 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 	const ofc_sema_decl_t* decl);
 bool ofc_sema_decl_print_name(ofc_colstr_t* cs,
 	const ofc_sema_decl_t* decl);
+bool ofc_sema_decl_procedure_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_decl_t* decl);
 
 bool ofc_sema_decl_list_stmt_func_print(
 	ofc_colstr_t* cs, unsigned indent,
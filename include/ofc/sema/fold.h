@@ -0,0 +1,60 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_fold_h__
+#define __ofc_sema_fold_h__
+
+/* Arithmetic for constant folding, size is the number of bytes in the
+   result's kind. Integer results are worked out exactly in 128 bits and
+   fail when they don't fit in size bytes. */
+bool ofc_sema_fold_integer_fits(unsigned size, int64_t value);
+bool ofc_sema_fold_integer_add(
+	unsigned size, int64_t a, int64_t b, int64_t* result);
+bool ofc_sema_fold_integer_subtract(
+	unsigned size, int64_t a, int64_t b, int64_t* result);
+bool ofc_sema_fold_integer_multiply(
+	unsigned size, int64_t a, int64_t b, int64_t* result);
+bool ofc_sema_fold_integer_divide(
+	unsigned size, int64_t a, int64_t b, int64_t* result);
+bool ofc_sema_fold_integer_power(
+	unsigned size, int64_t a, int64_t b, int64_t* result);
+bool ofc_sema_fold_integer_negate(
+	unsigned size, int64_t a, int64_t* result);
+
+/* Truncates toward zero, fails when the value is out of range. */
+bool ofc_sema_fold_integer_from_real(
+	unsigned size, ofc_real_t value, int64_t* result);
+
+/* REAL results are rounded once to the binary format with size bytes,
+   the host's float and double are used directly when they match it. */
+ofc_real_t ofc_sema_fold_real_round(unsigned size, ofc_real_t value);
+ofc_real_t ofc_sema_fold_real_add(
+	unsigned size, ofc_real_t a, ofc_real_t b);
+ofc_real_t ofc_sema_fold_real_subtract(
+	unsigned size, ofc_real_t a, ofc_real_t b);
+ofc_real_t ofc_sema_fold_real_multiply(
+	unsigned size, ofc_real_t a, ofc_real_t b);
+ofc_real_t ofc_sema_fold_real_divide(
+	unsigned size, ofc_real_t a, ofc_real_t b);
+ofc_real_t ofc_sema_fold_real_power(
+	unsigned size, ofc_real_t a, ofc_real_t b);
+
+/* Reads a decimal number with an optional E, D or Q exponent,
+   correctly rounded to size bytes. */
+bool ofc_sema_fold_real_parse(
+	unsigned size, const char* str, unsigned len,
+	ofc_real_t* value);
+
+#endif
@@ -0,0 +1,55 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_incremental_h__
+#define __ofc_sema_incremental_h__
+
+/* An incremental cache remembers the diagnostics of each program unit
+   of a source file, keyed on a hash of the unit's text. When no unit's
+   declarations have changed, unchanged units only have their
+   specification statements analysed and their diagnostics replayed. */
+typedef struct ofc_sema_incremental_s ofc_sema_incremental_t;
+
+ofc_sema_incremental_t* ofc_sema_incremental_create(void);
+
+/* A missing or unreadable cache is treated as empty. */
+ofc_sema_incremental_t* ofc_sema_incremental_load(const char* path);
+void ofc_sema_incremental_delete(
+	ofc_sema_incremental_t* incremental);
+
+/* Returns the list to analyse in place of the list parsed from file,
+   which lives until the next view is made. Units are only reused
+   when reuse is set, otherwise the cache is just refreshed. */
+const ofc_parse_stmt_list_t* ofc_sema_incremental_view(
+	ofc_sema_incremental_t* incremental,
+	const ofc_file_t* file,
+	const ofc_parse_stmt_list_t* list,
+	bool reuse);
+
+/* Records the diagnostics of each unit in the view and writes the
+   cache to path. */
+bool ofc_sema_incremental_save(
+	const ofc_sema_incremental_t* incremental,
+	const char* path);
+
+/* Like save, but replaces the cache in memory. */
+bool ofc_sema_incremental_record(
+	ofc_sema_incremental_t* incremental);
+
+void ofc_sema_incremental_stats(
+	const ofc_sema_incremental_t* incremental,
+	unsigned* reused, unsigned* total);
+
+#endif
@@ -0,0 +1,77 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_index_h__
+#define __ofc_sema_index_h__
+
+/* Maps positions in the source to the innermost node of each kind
+   which covers them. Nodes from included files are indexed by their
+   position in the include's sparse. */
+
+typedef enum
+{
+	OFC_SEMA_INDEX_PARSE_STMT = 0,
+	OFC_SEMA_INDEX_SCOPE,
+	OFC_SEMA_INDEX_STMT,
+	OFC_SEMA_INDEX_EXPR,
+	OFC_SEMA_INDEX_LHS,
+	OFC_SEMA_INDEX_DECL,
+
+	OFC_SEMA_INDEX_COUNT
+} ofc_sema_index_e;
+
+typedef struct
+{
+	ofc_sema_index_e type;
+	ofc_sparse_ref_t src;
+
+	union
+	{
+		const ofc_parse_stmt_t* parse_stmt;
+		const ofc_sema_scope_t* scope;
+		const ofc_sema_stmt_t*  stmt;
+		const ofc_sema_expr_t*  expr;
+		const ofc_sema_lhs_t*   lhs;
+		const ofc_sema_decl_t*  decl;
+	};
+} ofc_sema_index_node_t;
+
+typedef struct ofc_sema_index_s ofc_sema_index_t;
+
+/* Scope may be NULL to only index the parse tree, both must
+   outlive the index. */
+ofc_sema_index_t* ofc_sema_index_create(
+	const ofc_parse_stmt_list_t* program,
+	const ofc_sema_scope_t* scope);
+void ofc_sema_index_delete(
+	ofc_sema_index_t* index);
+
+unsigned ofc_sema_index_count(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type);
+
+/* Finds the innermost node of type which covers ptr, where ptr
+   points into the text of a sparse. */
+const ofc_sema_index_node_t* ofc_sema_index_find(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type, const char* ptr);
+
+/* Like find, but for a pointer into the file sparse was read from. */
+const ofc_sema_index_node_t* ofc_sema_index_find_file(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type,
+	const ofc_sparse_t* sparse, const char* fptr);
+
+#endif
@@ -18,10 +18,17 @@
 
 typedef struct ofc_sema_intrinsic_s ofc_sema_intrinsic_t;
 
+/* Lookups are into constant tables, so are safe from any thread. */
 const ofc_sema_intrinsic_t* ofc_sema_intrinsic(
 	const ofc_sema_scope_t* scope,
 	ofc_str_ref_t name);
 
+/* Intrinsic subroutines are kept apart, since a few share
+   their names with intrinsic functions. */
+const ofc_sema_intrinsic_t* ofc_sema_intrinsic_subroutine(
+	const ofc_sema_scope_t* scope,
+	ofc_str_ref_t name);
+
 /* This takes ownership of args and deletes on failure. */
 ofc_sema_expr_list_t* ofc_sema_intrinsic_cast(
 	ofc_sparse_ref_t src,
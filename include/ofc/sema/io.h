@@ -45,6 +45,111 @@ typedef enum
 	OFC_SEMA_CALL_ARG_COUNT
 } ofc_sema_call_arg_e;
 
+typedef enum
+{
+	OFC_SEMA_IO_SPEC_UNIT = 0,
+	OFC_SEMA_IO_SPEC_FMT,
+	OFC_SEMA_IO_SPEC_IOSTAT,
+	OFC_SEMA_IO_SPEC_REC,
+	OFC_SEMA_IO_SPEC_ERR,
+	OFC_SEMA_IO_SPEC_END,
+	OFC_SEMA_IO_SPEC_EOR,
+	OFC_SEMA_IO_SPEC_ADVANCE,
+	OFC_SEMA_IO_SPEC_SIZE,
+	OFC_SEMA_IO_SPEC_ACCESS,
+	OFC_SEMA_IO_SPEC_ACTION,
+	OFC_SEMA_IO_SPEC_BLANK,
+	OFC_SEMA_IO_SPEC_DELIM,
+	OFC_SEMA_IO_SPEC_FILE,
+	OFC_SEMA_IO_SPEC_FORM,
+	OFC_SEMA_IO_SPEC_PAD,
+	OFC_SEMA_IO_SPEC_POSITION,
+	OFC_SEMA_IO_SPEC_RECL,
+	OFC_SEMA_IO_SPEC_STATUS,
+	OFC_SEMA_IO_SPEC_DIRECT,
+	OFC_SEMA_IO_SPEC_EXIST,
+	OFC_SEMA_IO_SPEC_FORMATTED,
+	OFC_SEMA_IO_SPEC_NAME,
+	OFC_SEMA_IO_SPEC_NAMED,
+	OFC_SEMA_IO_SPEC_NEXTREC,
+	OFC_SEMA_IO_SPEC_NUMBER,
+	OFC_SEMA_IO_SPEC_OPENED,
+	OFC_SEMA_IO_SPEC_READ,
+	OFC_SEMA_IO_SPEC_READWRITE,
+	OFC_SEMA_IO_SPEC_SEQUENTIAL,
+	OFC_SEMA_IO_SPEC_UNFORMATTED,
+	OFC_SEMA_IO_SPEC_WRITE,
+
+	OFC_SEMA_IO_SPEC_COUNT
+} ofc_sema_io_spec_e;
+
+typedef enum
+{
+	/* Not accepted by the statement. */
+	OFC_SEMA_IO_SPEC_TYPE_NONE = 0,
+
+	/* Classified only, the statement checks the value itself. */
+	OFC_SEMA_IO_SPEC_TYPE_CUSTOM,
+
+	/* Positive INTEGER expression. */
+	OFC_SEMA_IO_SPEC_TYPE_UNIT,
+	/* INTEGER expression, which mustn't be a negative constant. */
+	OFC_SEMA_IO_SPEC_TYPE_INTEGER,
+	/* CHARACTER expression, constants must be one of values. */
+	OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+	/* Label of an executable statement. */
+	OFC_SEMA_IO_SPEC_TYPE_LABEL,
+	/* INTEGER variable expression. */
+	OFC_SEMA_IO_SPEC_TYPE_VARIABLE,
+
+	/* Variables assigned by the statement, these are lhs. */
+	OFC_SEMA_IO_SPEC_TYPE_OUT_INTEGER,
+	OFC_SEMA_IO_SPEC_TYPE_OUT_LOGICAL,
+	OFC_SEMA_IO_SPEC_TYPE_OUT_CHARACTER,
+} ofc_sema_io_spec_type_e;
+
+/* One row of a statement's specifier table, indexed by ofc_sema_io_spec_e.
+   Position is where the specifier may appear un-named, counting from 1,
+   desc lists the allowed values in diagnostics. */
+typedef struct
+{
+	unsigned                position;
+	ofc_sema_io_spec_type_e type;
+	const char* const*      values;
+	const char*             desc;
+} ofc_sema_io_spec_t;
+
+typedef struct
+{
+	const char*               name;
+	const ofc_sema_io_spec_t* table;
+
+	uint64_t                    given;
+	const ofc_parse_call_arg_t* arg[OFC_SEMA_IO_SPEC_COUNT];
+} ofc_sema_io_params_t;
+
+/* Matches each parameter in list to a specifier in table,
+   name is the statement used in diagnostics. */
+bool ofc_sema_io_params(
+	const ofc_parse_call_arg_list_t* list,
+	const ofc_sema_io_spec_t* table, const char* name,
+	ofc_sema_io_params_t* params);
+
+/* Analyses a specifier according to its row in the table, these
+   succeed and set the result to NULL when it wasn't given. */
+bool ofc_sema_io_spec_expr(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_io_params_t* params,
+	ofc_sema_io_spec_e spec,
+	ofc_sema_expr_t** expr);
+bool ofc_sema_io_spec_lhs(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_io_params_t* params,
+	ofc_sema_io_spec_e spec,
+	ofc_sema_lhs_t** lhs);
+
 bool ofc_sema_io_compare_types(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt,
@@ -0,0 +1,45 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_sema_project_h__
+#define __ofc_sema_project_h__
+
+/* A project index summarizes the procedures and COMMON blocks each
+   source file of a program defines, so that a file can be checked
+   against the rest of the program without reanalysing it. */
+typedef struct ofc_sema_project_s ofc_sema_project_t;
+
+/* The index is mapped rather than read, a missing index is empty, and
+   one which is corrupt or from another version is treated as empty and
+   sets discarded. An exclusive lock on path.lock is held until the
+   project is deleted, so runs updating the same index don't race. */
+ofc_sema_project_t* ofc_sema_project_load(
+	const char* path, bool* discarded);
+void ofc_sema_project_delete(ofc_sema_project_t* project);
+
+/* Warns about external calls and COMMON blocks in root which don't
+   match their definitions in the project's other source files. */
+bool ofc_sema_project_check(
+	const ofc_sema_project_t* project,
+	const char* source, ofc_sema_scope_t* root);
+
+/* Writes project to path, with the summary of source replaced,
+   unless that leaves it unchanged. */
+bool ofc_sema_project_update(
+	const ofc_sema_project_t* project,
+	const char* source, const ofc_sema_scope_t* root,
+	const char* path);
+
+#endif
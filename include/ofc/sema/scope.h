@@ -46,6 +46,9 @@ struct ofc_sema_scope_s
 	ofc_str_ref_t        name;
 	ofc_sema_arg_list_t* args;
 
+	/* A program unit's source, from its first statement to its END. */
+	ofc_sparse_ref_t src;
+
 	bool external;
 	bool intrinsic;
 
@@ -66,6 +69,18 @@ struct ofc_sema_scope_s
 		ofc_sema_stmt_list_t* stmt;
 		ofc_sema_expr_t*      expr;
 	};
+
+	/* Memoized name resolution, adding a decl or adding or modifying
+	   a spec bumps the epoch of the scope holding it, which invalidates
+	   entries in that scope and its children. Only the outermost
+	   scope's counters are used. */
+	ofc_hashmap_t* cache;
+	unsigned       cache_decl_epoch;
+	unsigned       cache_spec_epoch;
+	unsigned       cache_hit, cache_miss;
+
+	/* Only allocated on the outermost scope. */
+	ofc_sema_callgraph_t* callgraph;
 };
 
 
@@ -114,6 +129,21 @@ ofc_sema_spec_t* ofc_sema_scope_spec_modify(
 ofc_sema_spec_t* ofc_sema_scope_spec_find_final(
 	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name);
 
+/* Result is owned by the scope and only valid until it's next modified. */
+const ofc_sema_spec_t* ofc_sema_scope_spec_find_final_cached(
+	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name);
+
+/* Doesn't touch the scope's cache, so printers on several threads can
+   share a scope. */
+ofc_sema_spec_t* ofc_sema_scope_spec_find_final_uncached(
+	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name);
+
+void ofc_sema_scope_cache_invalidate(
+	const ofc_sema_scope_t* scope);
+void ofc_sema_scope_cache_stats(
+	const ofc_sema_scope_t* scope,
+	unsigned* hit, unsigned* miss);
+
 bool ofc_sema_scope_equiv_add(
 	ofc_sema_scope_t* scope, ofc_sema_equiv_t* equiv);
 
@@ -148,6 +178,13 @@ bool ofc_sema_scope_print(
 	ofc_colstr_t* cs, unsigned indent,
 	const ofc_sema_scope_t* scope);
 
+/* Prints scope like ofc_sema_scope_print, calling func after each
+   program unit so that cs can be written out and reset as we go. */
+bool ofc_sema_scope_print_units(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_scope_t* scope, void* param,
+	bool (*func)(ofc_colstr_t* cs, void* param));
+
 ofc_sema_scope_list_t* ofc_sema_scope_list_create(void);
 
 bool ofc_sema_scope_list_add(
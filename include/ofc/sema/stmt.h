@@ -133,7 +133,7 @@ struct ofc_sema_stmt_s
 
 			ofc_sema_expr_t* end;
 			ofc_sema_expr_t* eor;
-			ofc_sema_expr_t* size;
+			ofc_sema_lhs_t*  size;
 
 			ofc_sema_lhs_list_t* iolist;
 		} io_read;
@@ -387,4 +387,11 @@ bool ofc_sema_stmt_list_print(
 	ofc_sema_label_map_t* label_map,
 	const ofc_sema_stmt_list_t* stmt_list);
 
+/* In free form, prints the comments after the last statement of a
+   block's list, up to the statement which ends the block. */
+bool ofc_sema_stmt_block_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_stmt_t* block,
+	const ofc_sema_stmt_list_t* list);
+
 #endif
@@ -20,11 +20,16 @@ typedef enum
 {
 	OFC_SEMA_STRUCTURE_VAX_STRUCTURE,
 	OFC_SEMA_STRUCTURE_VAX_UNION,
+	OFC_SEMA_STRUCTURE_VAX_MAP,
 	OFC_SEMA_STRUCTURE_F90_TYPE,
 } ofc_sema_structure_e;
 
 typedef struct ofc_sema_structure_s ofc_sema_structure_t;
 
+/* Flattened member table, sizes and lookup maps, built once
+   a structure is complete and dropped if it's modified. */
+typedef struct ofc_sema_structure_layout_s ofc_sema_structure_layout_t;
+
 typedef struct
 {
 	bool is_structure;
@@ -45,6 +50,9 @@ struct ofc_sema_structure_s
 	ofc_sema_structure_member_t** member;
 
 	ofc_hashmap_t* map;
+	bool           case_sensitive;
+
+	ofc_sema_structure_layout_t* layout;
 
 	unsigned refcnt;
 };
@@ -72,6 +72,9 @@ const ofc_sema_type_t* ofc_sema_type_create_pointer(
 const ofc_sema_type_t* ofc_sema_type_create_function(
 	const ofc_sema_type_t* type);
 
+/* Types are shared within the current context until this is called. */
+void ofc_sema_type_map_cleanup(void);
+
 typedef const ofc_sema_type_t* (*ofc_sema_type_f)(void);
 
 const ofc_sema_type_t* ofc_sema_type_logical_default(void);
@@ -133,7 +136,14 @@ bool ofc_sema_type_print(
 	const ofc_sema_type_t* type);
 
 
+/* Absolute kinds are three times their size in bytes. */
+bool ofc_sema_type_kind_absolute(unsigned kind);
 bool ofc_sema_type_kind_size(
 	unsigned def, unsigned kind, unsigned* size);
 
+/* The kind of a type declared with a star size, a COMPLEX kind is
+   that of each part. Returns zero when the size can't be split. */
+unsigned ofc_sema_type_kind_star(
+	ofc_sema_type_e type, unsigned size);
+
 #endif
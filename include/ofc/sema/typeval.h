@@ -18,23 +18,28 @@
 
 typedef struct
 {
-    const ofc_sema_type_t* type;
+	const ofc_sema_type_t* type;
 
 	ofc_sparse_ref_t src;
 
-	struct
+	/* Only the member matching type is valid, CHARACTER values which
+	   fit in character_inline are stored there instead of on the heap,
+	   use ofc_sema_typeval_get_character to access either. REAL and
+	   COMPLEX values are always rounded to the precision of their kind. */
+	union
 	{
-		bool        logical;
-		int64_t     integer;
-		long double real;
+		bool       logical;
+		int64_t    integer;
+		ofc_real_t real;
 
 		struct
 		{
-			long double real;
-			long double imaginary;
+			ofc_real_t real;
+			ofc_real_t imaginary;
 		} complex;
 
 		char* character;
+		char  character_inline[2 * sizeof(ofc_real_t)];
 	};
 } ofc_sema_typeval_t;
 
@@ -50,6 +55,9 @@ ofc_sema_typeval_t* ofc_sema_typeval_literal(
 void ofc_sema_typeval_delete(
 	ofc_sema_typeval_t* typeval);
 
+/* Frees the current context's recycled typevals. */
+void ofc_sema_typeval_pool_cleanup(void);
+
 bool ofc_sema_typeval_compare(
 	const ofc_sema_typeval_t* a,
 	const ofc_sema_typeval_t* b);
@@ -0,0 +1,31 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_server_h__
+#define __ofc_server_h__
+
+#include <stdbool.h>
+
+#include "ofc/lang_opts.h"
+
+/* Answers one JSON request per line read from in_fd with one JSON
+   response per line on out_fd, until in_fd closes or a shutdown
+   request arrives. Files stay parsed and analysed between requests,
+   the protocol is described in server.c. */
+bool ofc_server(
+	const ofc_lang_opts_t* lang_opts,
+	int in_fd, int out_fd);
+
+#endif
@@ -48,6 +48,41 @@ bool ofc_sparse_sequential(
 const char* ofc_sparse_parent_pointer(
 	const ofc_sparse_t* sparse, const char* ptr);
 
+/* Finds the source file text which ptr was read from. */
+const char* ofc_sparse_file_pointer(
+	const ofc_sparse_t* sparse, const char* ptr,
+	const ofc_file_t** file);
+
+/* The reverse of ofc_sparse_file_pointer, when the text at fptr was
+   dropped this finds the next text which wasn't, or NULL if none was
+   kept after it. */
+const char* ofc_sparse_from_file_pointer(
+	const ofc_sparse_t* sparse, const char* fptr);
+
+/* Calls func with each comment directly above the source line ptr
+   was read from, in order and without the comment character. */
+bool ofc_sparse_comments(
+	const ofc_sparse_t* sparse, const char* ptr, void* param,
+	bool (*func)(const char* base, unsigned size, void* param));
+
+/* Calls func with each comment on the source lines ptr through last
+   were read from, both whole lines and those after code. A comment
+   after last belongs to any code following last on its line. */
+bool ofc_sparse_comments_within(
+	const ofc_sparse_t* sparse, const char* ptr, const char* last,
+	void* param, bool (*func)(const char* base, unsigned size, void* param));
+
+/* Calls func with each comment on the source lines after the one ptr
+   was read from, up to those ofc_sparse_comments finds above next. */
+bool ofc_sparse_comments_between(
+	const ofc_sparse_t* sparse, const char* ptr, const char* next,
+	void* param, bool (*func)(const char* base, unsigned size, void* param));
+
+/* Calls func with each comment after the last line of code. */
+bool ofc_sparse_comments_end(
+	const ofc_sparse_t* sparse, void* param,
+	bool (*func)(const char* base, unsigned size, void* param));
+
 ofc_lang_opts_t ofc_sparse_lang_opts(const ofc_sparse_t* sparse);
 
 const char* ofc_sparse_get_include(
@@ -92,6 +127,27 @@ static inline bool ofc_sparse_ref_print(
 	ofc_colstr_t* cs, ofc_sparse_ref_t ref)
 	{ return ofc_str_ref_print(cs, ref.string); }
 
+/* The last character of the source of the statement ref covers, or
+   of its first line when ref covers a block or program unit. */
+const char* ofc_sparse_ref_last(ofc_sparse_ref_t ref);
+const char* ofc_sparse_ref_head_last(ofc_sparse_ref_t ref);
+
+/* Write the comments the functions above find to cs, when trailing is
+   set the first follows the current line if it fits. */
+bool ofc_sparse_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr);
+bool ofc_sparse_comments_within_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr, const char* last,
+	bool trailing);
+bool ofc_sparse_comments_between_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr, const char* next);
+bool ofc_sparse_comments_end_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse);
+
 
 #include <stdarg.h>
 
@@ -0,0 +1,424 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ofc/alloc.h"
+
+
+/* Each block starts with a header so that it can be accounted for
+   when it's freed, which keeps user memory maximally aligned. */
+typedef struct
+{
+	_Alignas(max_align_t) size_t size;
+	ofc_alloc_tag_e tag;
+} ofc_alloc__header_t;
+
+static const char* ofc_alloc__tag_name[] =
+{
+	"misc",
+	"file",
+	"sparse",
+	"parse",
+	"parse-debug",
+	"sema",
+	"sema-decl",
+	"sema-expr",
+	"typeval",
+	"hashmap",
+	"colstr",
+	"diag",
+};
+
+/* The last entry holds the totals over every tag. */
+typedef struct
+{
+	int64_t  live, peak;
+	uint64_t allocs, reallocs, frees;
+	uint64_t histogram[OFC_ALLOC_HISTOGRAM_SIZE];
+} ofc_alloc__shared_t;
+
+static ofc_alloc__shared_t ofc_alloc__shared[OFC_ALLOC_TAG_COUNT + 1];
+
+/* Atomic counters on every allocation would slow the whole front end
+   down, so each thread batches its counts until it has moved enough
+   bytes or made enough requests. Each batch remembers the highest its
+   live bytes reached, so peaks are exact with one thread, and with more
+   may be under by what the other threads haven't yet reported. */
+#define OFC_ALLOC__FLUSH_BYTES 65536
+#define OFC_ALLOC__FLUSH_OPS   4096
+
+typedef struct
+{
+	int64_t  live[OFC_ALLOC_TAG_COUNT];
+	int64_t  high[OFC_ALLOC_TAG_COUNT];
+	int64_t  total_live, total_high;
+	uint64_t allocs[OFC_ALLOC_TAG_COUNT];
+	uint64_t reallocs[OFC_ALLOC_TAG_COUNT];
+	uint64_t frees[OFC_ALLOC_TAG_COUNT];
+	uint64_t histogram[OFC_ALLOC_TAG_COUNT][OFC_ALLOC_HISTOGRAM_SIZE];
+	unsigned ops;
+	bool     registered;
+} ofc_alloc__local_t;
+
+static _Thread_local ofc_alloc__local_t ofc_alloc__local;
+
+static pthread_key_t  ofc_alloc__key;
+static pthread_once_t ofc_alloc__key_once = PTHREAD_ONCE_INIT;
+
+static const ofc_alloc_backend_t* ofc_alloc__backend[OFC_ALLOC_TAG_COUNT];
+
+
+const char* ofc_alloc_tag_name(ofc_alloc_tag_e tag)
+{
+	if (tag >= OFC_ALLOC_TAG_COUNT)
+		return NULL;
+	return ofc_alloc__tag_name[tag];
+}
+
+
+/* High is the most delta reached during the batch. */
+static void ofc_alloc__shared_add(
+	ofc_alloc__shared_t* shared, int64_t delta, int64_t high)
+{
+	int64_t live = __atomic_add_fetch(
+		&shared->live, delta, __ATOMIC_RELAXED);
+	int64_t top = (live - delta + high);
+	if (live > top) top = live;
+
+	int64_t peak = __atomic_load_n(
+		&shared->peak, __ATOMIC_RELAXED);
+	while ((top > peak)
+		&& !__atomic_compare_exchange_n(
+			&shared->peak, &peak, top, true,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static void ofc_alloc__shared_count(
+	ofc_alloc__shared_t* shared,
+	uint64_t allocs, uint64_t reallocs, uint64_t frees,
+	const uint64_t* histogram)
+{
+	__atomic_add_fetch(&shared->allocs, allocs, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&shared->reallocs, reallocs, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&shared->frees, frees, __ATOMIC_RELAXED);
+
+	unsigned i;
+	for (i = 0; i < OFC_ALLOC_HISTOGRAM_SIZE; i++)
+	{
+		if (histogram[i] > 0)
+		{
+			__atomic_add_fetch(&shared->histogram[i],
+				histogram[i], __ATOMIC_RELAXED);
+		}
+	}
+}
+
+static void ofc_alloc__flush(ofc_alloc__local_t* local)
+{
+	ofc_alloc__shared_t* total
+		= &ofc_alloc__shared[OFC_ALLOC_TAG_COUNT];
+
+	unsigned tag;
+	for (tag = 0; tag < OFC_ALLOC_TAG_COUNT; tag++)
+	{
+		if ((local->allocs[tag] + local->reallocs[tag]
+			+ local->frees[tag]) == 0)
+			continue;
+
+		ofc_alloc__shared_add(&ofc_alloc__shared[tag],
+			local->live[tag], local->high[tag]);
+
+		ofc_alloc__shared_count(&ofc_alloc__shared[tag],
+			local->allocs[tag], local->reallocs[tag],
+			local->frees[tag], local->histogram[tag]);
+		ofc_alloc__shared_count(total,
+			local->allocs[tag], local->reallocs[tag],
+			local->frees[tag], local->histogram[tag]);
+
+		local->live[tag]     = 0;
+		local->high[tag]     = 0;
+		local->allocs[tag]   = 0;
+		local->reallocs[tag] = 0;
+		local->frees[tag]    = 0;
+		memset(local->histogram[tag], 0x00,
+			sizeof(local->histogram[tag]));
+	}
+
+	ofc_alloc__shared_add(total,
+		local->total_live, local->total_high);
+	local->total_live = 0;
+	local->total_high = 0;
+	local->ops = 0;
+}
+
+/* Threads that exit hand their counts over as they go. */
+static void ofc_alloc__thread_exit(void* local)
+{
+	ofc_alloc__flush((ofc_alloc__local_t*)local);
+}
+
+static void ofc_alloc__key_create(void)
+{
+	pthread_key_create(
+		&ofc_alloc__key, ofc_alloc__thread_exit);
+}
+
+static ofc_alloc__local_t* ofc_alloc__local_get(void)
+{
+	ofc_alloc__local_t* local = &ofc_alloc__local;
+	if (!local->registered)
+	{
+		pthread_once(&ofc_alloc__key_once,
+			ofc_alloc__key_create);
+		pthread_setspecific(ofc_alloc__key, local);
+		local->registered = true;
+	}
+	return local;
+}
+
+static unsigned ofc_alloc__bucket(size_t size)
+{
+	if (size <= 16)
+		return 0;
+
+	unsigned bucket = (60 - __builtin_clzll(size - 1));
+	if (bucket >= OFC_ALLOC_HISTOGRAM_SIZE)
+		bucket = (OFC_ALLOC_HISTOGRAM_SIZE - 1);
+	return bucket;
+}
+
+static void ofc_alloc__account(
+	ofc_alloc_tag_e tag, size_t size, size_t old_size,
+	bool is_realloc)
+{
+	ofc_alloc__local_t* local = ofc_alloc__local_get();
+
+	if (is_realloc)
+		local->reallocs[tag]++;
+	else
+		local->allocs[tag]++;
+	local->histogram[tag][ofc_alloc__bucket(size)]++;
+
+	int64_t delta = ((int64_t)size - (int64_t)old_size);
+	local->live[tag] += delta;
+	if (local->live[tag] > local->high[tag])
+		local->high[tag] = local->live[tag];
+	local->total_live += delta;
+	if (local->total_live > local->total_high)
+		local->total_high = local->total_live;
+
+	if ((++local->ops >= OFC_ALLOC__FLUSH_OPS)
+		|| (local->live[tag] >= OFC_ALLOC__FLUSH_BYTES))
+		ofc_alloc__flush(local);
+}
+
+
+void* ofc_alloc(ofc_alloc_tag_e tag, size_t size)
+{
+	if ((tag >= OFC_ALLOC_TAG_COUNT)
+		|| (size > (SIZE_MAX - sizeof(ofc_alloc__header_t))))
+		return NULL;
+
+	size_t total = (sizeof(ofc_alloc__header_t) + size);
+
+	const ofc_alloc_backend_t* backend
+		= ofc_alloc__backend[tag];
+	ofc_alloc__header_t* header
+		= (ofc_alloc__header_t*)(backend
+			? backend->alloc(backend->param, total)
+			: malloc(total));
+	if (!header) return NULL;
+
+	header->size = size;
+	header->tag  = tag;
+
+	ofc_alloc__account(tag, size, 0, false);
+	return &header[1];
+}
+
+void* ofc_calloc(ofc_alloc_tag_e tag, size_t count, size_t size)
+{
+	if ((size > 0) && (count > (SIZE_MAX / size)))
+		return NULL;
+
+	void* ptr = ofc_alloc(tag, (count * size));
+	if (!ptr) return NULL;
+
+	memset(ptr, 0x00, (count * size));
+	return ptr;
+}
+
+void* ofc_realloc(ofc_alloc_tag_e tag, void* ptr, size_t size)
+{
+	if (!ptr)
+		return ofc_alloc(tag, size);
+
+	if (size > (SIZE_MAX - sizeof(ofc_alloc__header_t)))
+		return NULL;
+
+	size_t total = (sizeof(ofc_alloc__header_t) + size);
+
+	ofc_alloc__header_t* header
+		= &((ofc_alloc__header_t*)ptr)[-1];
+	size_t old_size = header->size;
+	tag = header->tag;
+
+	const ofc_alloc_backend_t* backend
+		= ofc_alloc__backend[tag];
+	header = (ofc_alloc__header_t*)(backend
+		? backend->realloc(backend->param, header, total)
+		: realloc(header, total));
+	if (!header) return NULL;
+
+	header->size = size;
+
+	ofc_alloc__account(tag, size, old_size, true);
+	return &header[1];
+}
+
+char* ofc_strdup(ofc_alloc_tag_e tag, const char* str)
+{
+	if (!str)
+		return NULL;
+
+	size_t size = (strlen(str) + 1);
+	char* copy = (char*)ofc_alloc(tag, size);
+	if (!copy) return NULL;
+
+	memcpy(copy, str, size);
+	return copy;
+}
+
+void ofc_free(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	ofc_alloc__header_t* header
+		= &((ofc_alloc__header_t*)ptr)[-1];
+	ofc_alloc_tag_e tag = header->tag;
+
+	ofc_alloc__local_t* local = ofc_alloc__local_get();
+	local->frees[tag]++;
+	local->live[tag]  -= header->size;
+	local->total_live -= header->size;
+
+	if ((++local->ops >= OFC_ALLOC__FLUSH_OPS)
+		|| (local->live[tag] <= -OFC_ALLOC__FLUSH_BYTES))
+		ofc_alloc__flush(local);
+
+	const ofc_alloc_backend_t* backend
+		= ofc_alloc__backend[tag];
+	if (backend)
+		backend->free(backend->param, header);
+	else
+		free(header);
+}
+
+
+bool ofc_alloc_backend_set(
+	ofc_alloc_tag_e tag, const ofc_alloc_backend_t* backend)
+{
+	if ((tag >= OFC_ALLOC_TAG_COUNT)
+		|| (backend && (!backend->alloc
+			|| !backend->realloc || !backend->free)))
+		return false;
+
+	ofc_alloc_stats_t stats;
+	ofc_alloc_stats(tag, &stats);
+	if ((stats.allocs - stats.frees) != 0)
+		return false;
+
+	ofc_alloc__backend[tag] = backend;
+	return true;
+}
+
+
+/* Only the calling thread's batched counts can be included. */
+void ofc_alloc_stats(
+	ofc_alloc_tag_e tag, ofc_alloc_stats_t* stats)
+{
+	if (!stats || (tag > OFC_ALLOC_TAG_COUNT))
+		return;
+
+	ofc_alloc__flush(ofc_alloc__local_get());
+
+	const ofc_alloc__shared_t* shared
+		= &ofc_alloc__shared[tag];
+	int64_t live = __atomic_load_n(&shared->live, __ATOMIC_RELAXED);
+	int64_t peak = __atomic_load_n(&shared->peak, __ATOMIC_RELAXED);
+	stats->live     = (live > 0 ? (size_t)live : 0);
+	stats->peak     = (peak > 0 ? (size_t)peak : 0);
+	stats->allocs   = __atomic_load_n(&shared->allocs, __ATOMIC_RELAXED);
+	stats->reallocs = __atomic_load_n(&shared->reallocs, __ATOMIC_RELAXED);
+	stats->frees    = __atomic_load_n(&shared->frees, __ATOMIC_RELAXED);
+
+	unsigned i;
+	for (i = 0; i < OFC_ALLOC_HISTOGRAM_SIZE; i++)
+	{
+		stats->histogram[i] = __atomic_load_n(
+			&shared->histogram[i], __ATOMIC_RELAXED);
+	}
+}
+
+static bool ofc_alloc__report_tag(
+	int fd, const char* name, const ofc_alloc_stats_t* stats)
+{
+	if (dprintf(fd, "Mem:%s: %zu live, %zu peak, %" PRIu64 " allocs, "
+		"%" PRIu64 " reallocs, %" PRIu64 " frees\n",
+		name, stats->live, stats->peak, stats->allocs,
+		stats->reallocs, stats->frees) < 0)
+		return false;
+
+	if (dprintf(fd, "Mem:%s:sizes:", name) < 0)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < OFC_ALLOC_HISTOGRAM_SIZE; i++)
+	{
+		bool last = ((i + 1) == OFC_ALLOC_HISTOGRAM_SIZE);
+		size_t limit = ((size_t)16 << (last ? (i - 1) : i));
+		if (dprintf(fd, " %s%zu:%" PRIu64, (last ? ">" : ""),
+			limit, stats->histogram[i]) < 0)
+			return false;
+	}
+
+	return (dprintf(fd, "\n") >= 0);
+}
+
+bool ofc_alloc_report(int fd)
+{
+	unsigned i;
+	for (i = 0; i <= OFC_ALLOC_TAG_COUNT; i++)
+	{
+		ofc_alloc_stats_t stats;
+		ofc_alloc_stats(i, &stats);
+		if ((stats.allocs + stats.reallocs) == 0)
+			continue;
+
+		if (!ofc_alloc__report_tag(fd,
+			(i < OFC_ALLOC_TAG_COUNT
+				? ofc_alloc__tag_name[i] : "total"),
+			&stats))
+			return false;
+	}
+
+	return true;
+}
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <ofc/alloc.h>
 #include <ofc/cliarg.h>
 
 
@@ -47,6 +48,84 @@ static bool set_global_opts__flag(
 		case SEMA_TREE:
 			global->sema_print = true;
 			break;
+		case TIME_PHASES:
+			global->time_phases = true;
+			break;
+		case MEM_STATS:
+			global->mem_stats = true;
+			break;
+		case DATAFLOW:
+			global->dataflow = true;
+			break;
+		case CALL_GRAPH_DOT:
+			global->call_graph_dot = true;
+			break;
+		case CALL_GRAPH_BIN:
+			global->call_graph_bin = true;
+			break;
+		case SERVER:
+			global->server = true;
+			break;
+		case STREAM:
+			global->stream = true;
+			break;
+		case DIAG_JSON:
+			global->diag_format = OFC_DIAG_FORMAT_JSON;
+			break;
+		case DIAG_SARIF:
+			global->diag_format = OFC_DIAG_FORMAT_SARIF;
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+static bool set_global_opts__num(
+	ofc_global_opts_t* global,
+	int arg_type, unsigned value)
+{
+	if (!global)
+		return false;
+
+	switch (arg_type)
+	{
+		case DIAG_LIMIT:
+			global->diag_limit = value;
+			break;
+		case JOBS:
+			global->jobs = value;
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+static bool set_global_opts__str(
+	ofc_global_opts_t* global,
+	int arg_type, const char* str)
+{
+	if (!global || !str)
+		return false;
+
+	switch (arg_type)
+	{
+		case PROJECT:
+			global->project = str;
+			break;
+
+		case INCREMENTAL:
+			global->incremental = str;
+			break;
+
+		case EMIT_F90:
+			global->emit_f90 = str;
+			break;
 
 		default:
 			return false;
@@ -121,8 +200,22 @@ static const ofc_cliarg_body_t cliargs[] =
 	{ PARSE_ONLY,           "parse-only",           '\0', "Runs the parser only",                       GLOB_NONE, 0, true },
 	{ PARSE_TREE,           "parse-tree",           '\0', "Prints the parse tree",                      GLOB_NONE, 0, true },
 	{ SEMA_TREE,            "sema-tree",            '\0', "Prints the semantic analysis tree",          GLOB_NONE, 0, true },
-	{ FIXED_FORM,           "free-form",            '\0', "Sets free form type",                        LANG_NONE, 0, true },
-	{ FREE_FORM,            "fixed-form",           '\0', "Sets fixed form type",                       LANG_NONE, 0, true },
+	{ STREAM,               "stream",               '\0', "Analyses one program unit at a time",        GLOB_NONE, 0, true },
+	{ TIME_PHASES,          "time-phases",          '\0', "Prints time taken by each phase to stderr",  GLOB_NONE, 0, true },
+	{ MEM_STATS,            "mem-stats",            '\0', "Prints memory use per subsystem on exit",    GLOB_NONE, 0, true },
+	{ DATAFLOW,             "dataflow",             '\0', "Warns of unset uses and unused assignments", GLOB_NONE, 0, true },
+	{ CALL_GRAPH_DOT,       "call-graph-dot",       '\0', "Prints the call graph in DOT format",        GLOB_NONE, 0, true },
+	{ CALL_GRAPH_BIN,       "call-graph-bin",       '\0', "Writes the call graph in binary format",     GLOB_NONE, 0, true },
+	{ DIAG_JSON,            "diag-json",            '\0', "Prints diagnostics as JSON",                 GLOB_NONE, 0, true },
+	{ DIAG_SARIF,           "diag-sarif",           '\0', "Prints diagnostics as SARIF",                GLOB_NONE, 0, true },
+	{ DIAG_LIMIT,           "diag-limit",           '\0', "Limits repeats of each warning to <n>",      GLOB_INT,  1, true },
+	{ JOBS,                 "jobs",                 '\0', "Parses and prints using up to <n> threads",  GLOB_INT,  1, true },
+	{ PROJECT,              "project",              '\0', "Checks against and updates index <path>",    GLOB_STR,  1, true },
+	{ INCREMENTAL,          "incremental",          '\0', "Reuses unchanged results cached in <path>",  GLOB_STR,  1, true },
+	{ SERVER,               "server",               '\0', "Answers JSON requests on stdin, no path",    GLOB_NONE, 0, true },
+	{ EMIT_F90,             "emit-f90",             '\0', "Writes each source as free form F90 <path>", GLOB_STR,  1, true },
+	{ FIXED_FORM,           "fixed-form",           '\0', "Sets fixed form type",                       LANG_NONE, 0, true },
+	{ FREE_FORM,            "free-form",            '\0', "Sets free form type",                        LANG_NONE, 0, true },
 	{ TAB_FORM,             "tab-form",             '\0', "Sets tabbed form type",                      LANG_NONE, 0, true },
 	{ TAB_WIDTH,            "tab-width",            '\0', "Sets tab width <n>",                         LANG_INT,  1, true },
 	{ DEBUG,                "debug",                '\0', "Sets debug mode",                            LANG_NONE, 0, true },
@@ -204,6 +297,12 @@ static bool ofc_cliarg__apply(
 		case GLOB_NONE:
 			return set_global_opts__flag(global_opts, arg_type);
 
+		case GLOB_INT:
+			return set_global_opts__num(global_opts, arg_type, arg->value);
+
+		case GLOB_STR:
+			return set_global_opts__str(global_opts, arg_type, arg->str);
+
 		case LANG_NONE:
 			return set_lang_opts__flag(lang_opts, arg_type);
 
@@ -248,10 +347,13 @@ bool ofc_cliarg_parse(
 		return false;
 	}
 
+	/* Flags come first, everything after them is a source path. */
+	unsigned end = argc;
+
 	ofc_cliarg_list_t* args_list = ofc_cliarg_list_create();
 
 	unsigned i = 1;
-	while (i < (unsigned)argc - 1)
+	while (i < end)
 	{
 		if (argv[i][0] == '-')
 		{
@@ -274,17 +376,36 @@ bool ofc_cliarg_parse(
 					return false;
 				}
 
-				int param = -1;
-				if (arg_body->param_num > 0)
+				if (arg_body->param_type == GLOB_STR)
 				{
-					if (!resolve_param_pos_int(argv[i++], &param))
+					if (i >= end)
 					{
-						fprintf(stderr, "Error: Expected parameter for argument: %s\n", argv[i]);
+						fprintf(stderr, "Error: Expected parameter for argument: %s\n", argv[i - 1]);
 						print_usage(program_name);
 						return false;
 					}
+					resolved_arg = ofc_cliarg_create_str(arg_body, argv[i++]);
+				}
+				else
+				{
+					int param = -1;
+					if (arg_body->param_num > 0)
+					{
+						if (i >= end)
+						{
+							fprintf(stderr, "Error: Expected parameter for argument: %s\n", argv[i - 1]);
+							print_usage(program_name);
+							return false;
+						}
+						if (!resolve_param_pos_int(argv[i++], &param))
+						{
+							fprintf(stderr, "Error: Expected parameter for argument: %s\n", argv[i]);
+							print_usage(program_name);
+							return false;
+						}
+					}
+					resolved_arg = ofc_cliarg_create(arg_body, param);
 				}
-				resolved_arg = ofc_cliarg_create(arg_body, param);
 
 				if (!resolved_arg
 					|| !ofc_cliarg_list_add(args_list, resolved_arg))
@@ -315,23 +436,22 @@ bool ofc_cliarg_parse(
 		}
 		else
 		{
-			fprintf(stderr, "Error: Expected flags followed by file path: %s\n", argv[i]);
-			print_usage(program_name);
-			return false;
+			end = i;
 		}
 	}
 
-	const char* path = argv[argc - 1];
-	const char* source_file_ext = get_file_ext(path);
-
-	*file = ofc_file_create(path, *lang_opts);
-	if (!*file)
+	unsigned paths = ((unsigned)argc - end);
+	for (i = end; i < (unsigned)argc; i++)
 	{
-		fprintf(stderr, "\nError: Failed read source file '%s'\n", path);
-		return false;
+		if (argv[i][0] == '-')
+			break;
 	}
 
-	if (source_file_ext
+	const char* path = (paths > 0 ? argv[end] : NULL);
+	const char* source_file_ext = (path ? get_file_ext(path) : NULL);
+
+	/* With many sources, each is given its form by its own name. */
+	if (source_file_ext && (paths == 1)
 		&& (strcasecmp(source_file_ext, "F90") == 0))
 		*lang_opts = OFC_LANG_OPTS_F90;
 
@@ -340,6 +460,67 @@ bool ofc_cliarg_parse(
 
 	ofc_cliarg_list_delete(args_list);
 
+	/* Only --emit-f90 takes more than one source path. */
+	if ((i < (unsigned)argc)
+		|| ((paths > 1) && !global_opts->emit_f90))
+	{
+		fprintf(stderr, "Error: Expected flags followed by file path: %s\n", path);
+		print_usage(program_name);
+		return false;
+	}
+
+	if (global_opts->server)
+	{
+		if (path)
+		{
+			fprintf(stderr, "Error: A server takes no source path\n");
+			print_usage(program_name);
+			return false;
+		}
+
+		*file = NULL;
+		return true;
+	}
+
+	if (!path)
+	{
+		fprintf(stderr, "Error: Expected source path\n");
+		print_usage(program_name);
+		return false;
+	}
+
+	/* Units are released as soon as they've been analysed,
+	   so nothing which needs the whole program can be made. */
+	if (global_opts->stream
+		&& (global_opts->call_graph_dot || global_opts->call_graph_bin
+			|| global_opts->project || global_opts->incremental
+			|| global_opts->emit_f90))
+	{
+		fprintf(stderr, "Error: --stream only reports diagnostics and prints trees\n");
+		print_usage(program_name);
+		return false;
+	}
+
+	/* Each source is read in its own context as it's converted. */
+	if (global_opts->emit_f90)
+	{
+		global_opts->sources      = &argv[end];
+		global_opts->source_count = paths;
+		*file = NULL;
+		return true;
+	}
+
+	/* The file must be created after the language options are final,
+	   since it keeps its own copy of them. */
+	*file = (global_opts->stream
+		? ofc_file_create_mapped(path, *lang_opts)
+		: ofc_file_create(path, *lang_opts));
+	if (!*file)
+	{
+		fprintf(stderr, "\nError: Failed read source file '%s'\n", path);
+		return false;
+	}
+
 	return true;
 }
 
@@ -369,8 +550,11 @@ void print_usage(const char* name)
 	{
 		unsigned line_len = 0;
 
-		if (cliargs[i].param_type == LANG_INT)
+		if ((cliargs[i].param_type == LANG_INT)
+			|| (cliargs[i].param_type == GLOB_INT))
 			line_len = printf("  --%s <n>", cliargs[i].name);
+		else if (cliargs[i].param_type == GLOB_STR)
+			line_len = printf("  --%s <path>", cliargs[i].name);
 		else
 			line_len = printf("  --%s", cliargs[i].name);
 
@@ -389,7 +573,7 @@ ofc_cliarg_t* ofc_cliarg_create(
 	const ofc_cliarg_body_t* arg_body,
 	int value)
 {
-	ofc_cliarg_t* arg = (ofc_cliarg_t*)malloc(sizeof(ofc_cliarg_t));
+	ofc_cliarg_t* arg = (ofc_cliarg_t*)ofc_alloc(OFC_ALLOC_MISC, sizeof(ofc_cliarg_t));
 	if (!arg)
 		return NULL;
 
@@ -399,18 +583,32 @@ ofc_cliarg_t* ofc_cliarg_create(
 	return arg;
 }
 
+ofc_cliarg_t* ofc_cliarg_create_str(
+	const ofc_cliarg_body_t* arg_body,
+	const char* str)
+{
+	ofc_cliarg_t* arg = (ofc_cliarg_t*)ofc_alloc(OFC_ALLOC_MISC, sizeof(ofc_cliarg_t));
+	if (!arg)
+		return NULL;
+
+	arg->body = arg_body;
+	arg->str  = str;
+
+	return arg;
+}
+
 void ofc_cliarg_delete(ofc_cliarg_t* arg)
 {
 	if (!arg)
 		return;
 
-	free(arg);
+	ofc_free(arg);
 }
 
 ofc_cliarg_list_t* ofc_cliarg_list_create(void)
 {
 	ofc_cliarg_list_t* list
-		= (ofc_cliarg_list_t*)malloc(
+		= (ofc_cliarg_list_t*)ofc_alloc(OFC_ALLOC_MISC,
 			sizeof(ofc_cliarg_list_t));
 	if (!list) return NULL;
 
@@ -452,7 +650,7 @@ bool ofc_cliarg_list_add(
 	}
 
 	ofc_cliarg_t** narg
-		= (ofc_cliarg_t**)realloc(list->arg,
+		= (ofc_cliarg_t**)ofc_realloc(OFC_ALLOC_MISC, list->arg,
 			(sizeof(ofc_cliarg_t*) * (list->count + 1)));
 	if (!narg) return NULL;
 
@@ -471,7 +669,7 @@ void ofc_cliarg_list_delete(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_cliarg_delete(list->arg[i]);
-	free(list->arg);
+	ofc_free(list->arg);
 
-	free(list);
+	ofc_free(list);
 }
@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ofc/alloc.h"
 #include "ofc/colstr.h"
 
 
@@ -27,6 +28,7 @@ struct ofc_colstr_s
 	unsigned col, col_max, col_ext;
 	bool oversize;
 	unsigned oversize_off;
+	bool free;
 };
 
 
@@ -41,7 +43,7 @@ ofc_colstr_t* ofc_colstr_create(
 		return NULL;
 
 	ofc_colstr_t* cstr
-		= (ofc_colstr_t*)malloc(
+		= (ofc_colstr_t*)ofc_alloc(OFC_ALLOC_COLSTR,
 			sizeof(ofc_colstr_t));
 	if (!cstr) return NULL;
 
@@ -52,17 +54,59 @@ ofc_colstr_t* ofc_colstr_create(
 	cstr->col_max  = cols;
 	cstr->col_ext  = ext;
 	cstr->oversize = false;
+	cstr->free     = false;
 
 	return cstr;
 }
 
+ofc_colstr_t* ofc_colstr_create_free(unsigned cols)
+{
+	if (cols == 0)
+		cols = 132;
+
+	/* The last column is kept for the continuation ampersand. */
+	ofc_colstr_t* cstr
+		= ofc_colstr_create((cols - 1), (cols - 1));
+	if (!cstr) return NULL;
+
+	cstr->free = true;
+	return cstr;
+}
+
+ofc_colstr_t* ofc_colstr_create_like(
+	const ofc_colstr_t* cstr)
+{
+	if (!cstr)
+		return NULL;
+
+	ofc_colstr_t* like = ofc_colstr_create(
+		cstr->col_max, cstr->col_ext);
+	if (like) like->free = cstr->free;
+	return like;
+}
+
 void ofc_colstr_delete(ofc_colstr_t* cstr)
 {
 	if (!cstr)
 		return;
 
-	free(cstr->base);
-	free(cstr);
+	ofc_free(cstr->base);
+	ofc_free(cstr);
+}
+
+void ofc_colstr_reset(ofc_colstr_t* cstr)
+{
+	if (!cstr)
+		return;
+
+	cstr->size     = 0;
+	cstr->col      = 0;
+	cstr->oversize = false;
+}
+
+bool ofc_colstr_is_free(const ofc_colstr_t* cstr)
+{
+	return (cstr && cstr->free);
 }
 
 
@@ -82,7 +126,7 @@ static bool ofc_colstr__enlarge(
 			nmax = nsize;
 
 		char* nbase
-			= (char*)realloc(
+			= (char*)ofc_realloc(OFC_ALLOC_COLSTR,
 				cstr->base, nmax);
 		if (!nbase) return false;
 
@@ -107,22 +151,38 @@ bool ofc_colstr_newline(
 		cstr->base[cstr->size++] = '\n';
 
 	unsigned i;
-	if (label)
+	if (cstr->free)
+	{
+		/* Free form has no label field, the label is just followed
+		   by a space, the largest label fits in what we reserved. */
+		i = 0;
+		if (label)
+		{
+			char digits[5];
+			unsigned n = *label, d = 0;
+			do { digits[d++] = '0' + (n % 10); n /= 10; }
+			while ((n > 0) && (d < 5));
+			while (d > 0)
+				cstr->base[cstr->size + i++] = digits[--d];
+			cstr->base[cstr->size + i++] = ' ';
+		}
+	}
+	else if (label)
 	{
 		unsigned d = 10000;
 		for (i = 0; (i < 4) && ((*label / d) == 0); i++, d /= 10)
 			cstr->base[cstr->size + i] = ' ';
 		for (; i < 5; i++, d /= 10)
 			cstr->base[cstr->size + i] = '0' + ((*label / d) % 10);
-		cstr->base[cstr->size + i] = ' ';
+		cstr->base[cstr->size + i++] = ' ';
 	}
 	else
 	{
 		for (i = 0; i < 6; i++)
 			cstr->base[cstr->size + i] = ' ';
 	}
-	cstr->size += 6;
-	cstr->col = 6;
+	cstr->size += i;
+	cstr->col = i;
 
 	unsigned indent_level;
 	for (indent_level = 0; indent_level < indent; indent_level++)
@@ -137,6 +197,63 @@ bool ofc_colstr_newline(
 	return true;
 }
 
+bool ofc_colstr_comment(
+	ofc_colstr_t* cstr, unsigned indent,
+	const char* base, unsigned size)
+{
+	if (!cstr || (!base && (size > 0)))
+		return false;
+
+	/* Long comments are split over several lines,
+	   since they can't be continued. */
+	do
+	{
+		if (!ofc_colstr_newline(cstr, indent, NULL))
+			return false;
+
+		unsigned remain = (cstr->col < cstr->col_max
+			? (cstr->col_max - cstr->col) : 1);
+		unsigned lsize = (size < remain ? size : (remain - 1));
+		if ((lsize == 0) && (size > 0))
+			lsize = 1;
+
+		if (!ofc_colstr__enlarge(cstr, (lsize + 1)))
+			return false;
+
+		cstr->base[cstr->size++] = '!';
+		memcpy(&cstr->base[cstr->size], base, lsize);
+		cstr->size += lsize;
+		cstr->col  += (lsize + 1);
+
+		base += lsize;
+		size -= lsize;
+	} while (size > 0);
+
+	return true;
+}
+
+bool ofc_colstr_comment_trailing(
+	ofc_colstr_t* cstr, unsigned indent,
+	const char* base, unsigned size)
+{
+	if (!cstr || (!base && (size > 0)))
+		return false;
+
+	if ((cstr->size == 0) || cstr->oversize
+		|| ((cstr->col + size + 2) > cstr->col_max))
+		return ofc_colstr_comment(cstr, indent, base, size);
+
+	if (!ofc_colstr__enlarge(cstr, (size + 2)))
+		return false;
+
+	cstr->base[cstr->size++] = ' ';
+	cstr->base[cstr->size++] = '!';
+	memcpy(&cstr->base[cstr->size], base, size);
+	cstr->size += size;
+	cstr->col  += (size + 2);
+	return true;
+}
+
 
 static const char* is_escape(char c)
 {
@@ -527,6 +644,33 @@ bool ofc_colstr_atomic_writef(
 		cstr, buff, len);
 }
 
+bool ofc_colstr_append(
+	ofc_colstr_t* cstr, const ofc_colstr_t* src)
+{
+	if (!cstr || !src)
+		return false;
+	if (src->size == 0)
+		return true;
+
+	/* The newline src started with didn't break the line. */
+	bool first = (cstr->size == 0);
+	if (!ofc_colstr__enlarge(cstr,
+		(src->size + (first ? 0 : 1))))
+		return false;
+
+	if (!first)
+		cstr->base[cstr->size++] = '\n';
+
+	unsigned offset = cstr->size;
+	memcpy(&cstr->base[offset], src->base, src->size);
+	cstr->size += src->size;
+
+	cstr->col          = src->col;
+	cstr->oversize     = src->oversize;
+	cstr->oversize_off = (offset + src->oversize_off);
+	return true;
+}
+
 bool ofc_colstr_fdprint(ofc_colstr_t* cstr, int fd)
 {
 	if (!cstr || !cstr->base)
@@ -535,3 +679,13 @@ bool ofc_colstr_fdprint(ofc_colstr_t* cstr, int fd)
 	return (dprintf(fd, "%.*s\n",
 		cstr->size, cstr->base) > 0);
 }
+
+const char* ofc_colstr_get(
+	const ofc_colstr_t* cstr, unsigned* size)
+{
+	if (!cstr)
+		return NULL;
+
+	if (size) *size = cstr->size;
+	return cstr->base;
+}
@@ -0,0 +1,222 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "ofc/context.h"
+#include "ofc/prep.h"
+#include "ofc/parse/file.h"
+
+
+static ofc_context_t ofc_context__default =
+{
+	.target_logical_size = 4,
+	.target_integer_size = 4,
+	.target_real_size    = 4,
+	.target_pointer_size = sizeof(void*),
+
+	.diag               = NULL,
+	.sema_type_map      = NULL,
+	.sema_typeval_pool  = NULL,
+	.sema_typeval_block = NULL,
+
+	.file     = NULL,
+	.condense = NULL,
+	.program  = NULL,
+	.sema     = NULL,
+};
+static pthread_once_t ofc_context__default_once = PTHREAD_ONCE_INIT;
+
+static _Thread_local ofc_context_t* ofc_context__current = NULL;
+
+
+static void ofc_context__unload(ofc_context_t* context)
+{
+	ofc_sema_scope_delete(context->sema);
+	ofc_parse_stmt_list_delete(context->program);
+	ofc_sparse_delete(context->condense);
+	ofc_file_delete(context->file);
+
+	context->sema     = NULL;
+	context->program  = NULL;
+	context->condense = NULL;
+	context->file     = NULL;
+}
+
+/* Trees must go before the types and typevals they use. */
+static void ofc_context__cleanup(ofc_context_t* context)
+{
+	ofc_context_t* previous
+		= ofc_context_enter(context);
+	ofc_context__unload(context);
+	ofc_sema_typeval_pool_cleanup();
+	ofc_sema_type_map_cleanup();
+	ofc_context_leave(previous);
+}
+
+static void ofc_context__default_cleanup(void)
+{
+	ofc_context__cleanup(&ofc_context__default);
+}
+
+static void ofc_context__default_init(void)
+{
+	ofc_context__default.global_opts = OFC_GLOBAL_OPTS_DEFAULT;
+	atexit(ofc_context__default_cleanup);
+}
+
+ofc_context_t* ofc_context_default(void)
+{
+	pthread_once(&ofc_context__default_once,
+		ofc_context__default_init);
+	return &ofc_context__default;
+}
+
+ofc_context_t* ofc_context_current(void)
+{
+	if (ofc_context__current)
+		return ofc_context__current;
+	return ofc_context_default();
+}
+
+ofc_context_t* ofc_context_enter(ofc_context_t* context)
+{
+	ofc_context_t* previous = ofc_context__current;
+	ofc_context__current = context;
+	return previous;
+}
+
+void ofc_context_leave(ofc_context_t* previous)
+{
+	ofc_context__current = previous;
+}
+
+
+ofc_context_t* ofc_context_create(
+	const ofc_global_opts_t* global_opts)
+{
+	ofc_context_t* context
+		= (ofc_context_t*)ofc_alloc(OFC_ALLOC_MISC,
+			sizeof(ofc_context_t));
+	if (!context) return NULL;
+
+	context->global_opts = (global_opts
+		? *global_opts : OFC_GLOBAL_OPTS_DEFAULT);
+
+	context->target_logical_size = 4;
+	context->target_integer_size = 4;
+	context->target_real_size    = 4;
+	context->target_pointer_size = sizeof(void*);
+
+	context->diag               = ofc_diag_create();
+	context->sema_type_map      = NULL;
+	context->sema_typeval_pool  = NULL;
+	context->sema_typeval_block = NULL;
+	memset(&context->sema_type_default, 0x00,
+		sizeof(context->sema_type_default));
+
+	context->file     = NULL;
+	context->condense = NULL;
+	context->program  = NULL;
+	context->sema     = NULL;
+
+	if (!context->diag)
+	{
+		ofc_free(context);
+		return NULL;
+	}
+
+	ofc_diag_set_format(context->diag,
+		context->global_opts.diag_format);
+	ofc_diag_set_limit(context->diag,
+		context->global_opts.diag_limit);
+	return context;
+}
+
+void ofc_context_delete(ofc_context_t* context)
+{
+	if (!context || (context == &ofc_context__default))
+		return;
+
+	ofc_context__cleanup(context);
+	ofc_diag_delete(context->diag);
+	ofc_free(context);
+}
+
+
+unsigned ofc_context_jobs(const ofc_context_t* context)
+{
+	unsigned jobs = (context ? context->global_opts.jobs : 0);
+	if (jobs > 0) return jobs;
+
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	return (cpus > 0 ? (unsigned)cpus : 1);
+}
+
+ofc_diag_t* ofc_context_diag(ofc_context_t* context)
+{
+	if (!context)
+		return NULL;
+
+	if (!context->diag)
+	{
+		ofc_context_t* previous
+			= ofc_context_enter(context);
+		ofc_diag_t* diag = ofc_diag_default();
+		ofc_context_leave(previous);
+		return diag;
+	}
+
+	return context->diag;
+}
+
+const ofc_sema_scope_t* ofc_context_analyse(
+	ofc_context_t* context,
+	const char* path, const char* text,
+	const ofc_lang_opts_t* lang_opts)
+{
+	if (!context || !path || !lang_opts)
+		return NULL;
+
+	ofc_context_t* previous
+		= ofc_context_enter(context);
+
+	ofc_context__unload(context);
+	ofc_diag_reset(ofc_context_diag(context));
+
+	context->file = (text
+		? ofc_file_create_strz(path, *lang_opts, text)
+		: ofc_file_create(path, *lang_opts));
+	if (context->file)
+		context->condense = ofc_prep(context->file);
+	if (context->condense)
+		context->program = ofc_parse_file(context->condense);
+	if (context->program)
+		context->sema = ofc_sema_scope_global(
+			lang_opts, context->program);
+
+	if (!context->sema && ofc_file_no_errors())
+	{
+		ofc_file_error(context->file, NULL, (!context->condense
+			? "Failed to preprocess source file"
+			: (!context->program ? "Failed to parse program"
+				: "Program failed semantic analysis")));
+	}
+
+	ofc_context_leave(previous);
+	return context->sema;
+}
@@ -0,0 +1,940 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ofc/diag.h"
+#include "ofc/hashmap.h"
+#include "ofc/context.h"
+
+
+typedef struct
+{
+	ofc_diag_severity_e severity;
+	unsigned            file;
+	bool                positional;
+	unsigned            row, col;
+	char*               context;
+	char*               message;
+	unsigned            seq;
+} ofc_diag__entry_t;
+
+typedef struct
+{
+	char*    message;
+	unsigned count;
+} ofc_diag__repeat_t;
+
+typedef struct
+{
+	char*    base;
+	unsigned size, max;
+	bool     fail;
+} ofc_diag__buff_t;
+
+struct ofc_diag_s
+{
+	pthread_mutex_t lock;
+
+	ofc_diag_format_e format;
+	unsigned          limit;
+
+	unsigned file_count;
+	char**   file;
+
+	unsigned            count, max_count;
+	ofc_diag__entry_t** entry;
+	ofc_hashmap_t*      map;
+
+	ofc_hashmap_t* repeat;
+	unsigned       suppressed;
+
+	unsigned total[OFC_DIAG_SEVERITY_COUNT];
+
+	/* Entries before formatted have their text pending or written,
+	   text is only built early for a sink with an output. */
+	int              output;
+	unsigned         formatted;
+	ofc_diag__buff_t pending;
+};
+
+/* Pending text is written once it grows this large. */
+#define OFC_DIAG__PENDING_MAX 65536
+
+
+static uint8_t ofc_diag__strz_hash(const char* strz)
+{
+	uint8_t h = 0;
+	unsigned i;
+	for (i = 0; strz[i] != '\0'; i++)
+		h += strz[i];
+	return h;
+}
+
+static uint8_t ofc_diag__entry_hash(const ofc_diag__entry_t* entry)
+{
+	return ofc_diag__strz_hash(entry->message)
+		+ entry->file + entry->row + entry->col;
+}
+
+static bool ofc_diag__entry_compare(
+	const ofc_diag__entry_t* a, const ofc_diag__entry_t* b)
+{
+	return ((a->severity == b->severity)
+		&& (a->file == b->file)
+		&& (a->positional == b->positional)
+		&& (a->row == b->row)
+		&& (a->col == b->col)
+		&& (strcmp(a->message, b->message) == 0));
+}
+
+static void ofc_diag__entry_delete(ofc_diag__entry_t* entry)
+{
+	if (!entry)
+		return;
+
+	ofc_free(entry->context);
+	ofc_free(entry->message);
+	ofc_free(entry);
+}
+
+static const char* ofc_diag__repeat_key(
+	const ofc_diag__repeat_t* repeat)
+{
+	return (repeat ? repeat->message : NULL);
+}
+
+static void ofc_diag__repeat_delete(
+	ofc_diag__repeat_t* repeat)
+{
+	if (!repeat)
+		return;
+
+	ofc_free(repeat->message);
+	ofc_free(repeat);
+}
+
+
+static void ofc_diag__write(
+	ofc_diag__buff_t* buff, const char* base, unsigned size)
+{
+	if (buff->fail || (size == 0))
+		return;
+
+	if ((buff->size + size) > buff->max)
+	{
+		unsigned nmax = (buff->max << 1);
+		if (nmax < (buff->size + size))
+			nmax = (buff->size + size);
+		if (nmax < 256)
+			nmax = 256;
+
+		char* nbase = (char*)ofc_realloc(OFC_ALLOC_DIAG, buff->base, nmax);
+		if (!nbase)
+		{
+			buff->fail = true;
+			return;
+		}
+		buff->base = nbase;
+		buff->max  = nmax;
+	}
+
+	memcpy(&buff->base[buff->size], base, size);
+	buff->size += size;
+}
+
+static void ofc_diag__write_strz(
+	ofc_diag__buff_t* buff, const char* strz)
+{
+	ofc_diag__write(buff, strz, strlen(strz));
+}
+
+static void ofc_diag__writef(
+	ofc_diag__buff_t* buff, const char* format, ...)
+	__attribute__ ((format (printf, 2, 3)));
+
+static void ofc_diag__writef(
+	ofc_diag__buff_t* buff, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int len = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+
+	if (len <= 0)
+		return;
+
+	char str[len + 1];
+	va_start(args, format);
+	vsnprintf(str, (len + 1), format, args);
+	va_end(args);
+
+	ofc_diag__write(buff, str, len);
+}
+
+static void ofc_diag__write_json_strz(
+	ofc_diag__buff_t* buff, const char* strz)
+{
+	ofc_diag__write_strz(buff, "\"");
+
+	unsigned i, s;
+	for (i = 0, s = 0; strz[i] != '\0'; i++)
+	{
+		unsigned char c = strz[i];
+		if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			continue;
+
+		ofc_diag__write(buff, &strz[s], (i - s));
+		s = (i + 1);
+
+		switch (c)
+		{
+			case '"' : ofc_diag__write_strz(buff, "\\\""); break;
+			case '\\': ofc_diag__write_strz(buff, "\\\\"); break;
+			case '\n': ofc_diag__write(buff, "\\n" , 2); break;
+			case '\r': ofc_diag__write(buff, "\\r" , 2); break;
+			case '\t': ofc_diag__write(buff, "\\t" , 2); break;
+			default:
+				ofc_diag__writef(buff, "\\u%04x", c);
+				break;
+		}
+	}
+	ofc_diag__write(buff, &strz[s], (i - s));
+
+	ofc_diag__write_strz(buff, "\"");
+}
+
+
+static const char* ofc_diag__severity_text[] =
+{
+	"Error",
+	"Warning",
+};
+
+static const char* ofc_diag__severity_level[] =
+{
+	"error",
+	"warning",
+};
+
+/* Formats each entry which hasn't been yet onto the pending text,
+   in the order they were added. */
+static void ofc_diag__print_text(ofc_diag_t* diag)
+{
+	ofc_diag__buff_t* buff = &diag->pending;
+	for (; diag->formatted < diag->count; diag->formatted++)
+	{
+		const ofc_diag__entry_t* entry = diag->entry[diag->formatted];
+		const char* path = diag->file[entry->file];
+
+		ofc_diag__writef(buff, "%s:",
+			ofc_diag__severity_text[entry->severity]);
+		if (path[0] != '\0')
+			ofc_diag__writef(buff, "%s:", path);
+		if (entry->positional)
+			ofc_diag__writef(buff, "%u,%u:", (entry->row + 1), entry->col);
+		ofc_diag__writef(buff, " %s\n", entry->message);
+
+		if (entry->positional && entry->context)
+		{
+			ofc_diag__writef(buff, "%s\n%*s^\n",
+				entry->context, entry->col, "");
+		}
+	}
+}
+
+/* Only calls write, so that it's safe from a signal handler. */
+static bool ofc_diag__write_fd(
+	int fd, const char* base, unsigned size)
+{
+	unsigned off;
+	for (off = 0; off < size;)
+	{
+		ssize_t w = write(fd, &base[off], (size - off));
+		if (w <= 0) return false;
+		off += w;
+	}
+	return true;
+}
+
+/* Writes and empties the pending text. */
+static bool ofc_diag__write_pending(ofc_diag_t* diag, int fd)
+{
+	bool success = (!diag->pending.fail
+		&& ofc_diag__write_fd(fd,
+			diag->pending.base, diag->pending.size));
+	diag->pending.size = 0;
+	diag->pending.fail = false;
+	return success;
+}
+
+
+/* The sink written out if we're killed by a fatal signal. */
+static ofc_diag_t* volatile ofc_diag__fatal_diag = NULL;
+static pthread_once_t       ofc_diag__fatal_once = PTHREAD_ONCE_INIT;
+
+ofc_diag_t* ofc_diag_create(void)
+{
+	ofc_diag_t* diag
+		= (ofc_diag_t*)ofc_alloc(OFC_ALLOC_DIAG,
+			sizeof(ofc_diag_t));
+	if (!diag) return NULL;
+
+	diag->map = ofc_hashmap_create(
+		(void*)ofc_diag__entry_hash,
+		(void*)ofc_diag__entry_compare,
+		NULL, (void*)ofc_diag__entry_delete);
+	diag->repeat = ofc_hashmap_create(
+		NULL, NULL,
+		(void*)ofc_diag__repeat_key,
+		(void*)ofc_diag__repeat_delete);
+	if (!diag->map || !diag->repeat
+		|| (pthread_mutex_init(&diag->lock, NULL) != 0))
+	{
+		ofc_hashmap_delete(diag->map);
+		ofc_hashmap_delete(diag->repeat);
+		ofc_free(diag);
+		return NULL;
+	}
+
+	diag->format = OFC_DIAG_FORMAT_TEXT;
+	diag->limit  = 0;
+
+	diag->file_count = 0;
+	diag->file       = NULL;
+
+	diag->count     = 0;
+	diag->max_count = 0;
+	diag->entry     = NULL;
+
+	diag->suppressed = 0;
+
+	unsigned i;
+	for (i = 0; i < OFC_DIAG_SEVERITY_COUNT; i++)
+		diag->total[i] = 0;
+
+	diag->output    = -1;
+	diag->formatted = 0;
+
+	diag->pending.base = NULL;
+	diag->pending.size = 0;
+	diag->pending.max  = 0;
+	diag->pending.fail = false;
+
+	return diag;
+}
+
+void ofc_diag_delete(ofc_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	if (ofc_diag__fatal_diag == diag)
+		ofc_diag__fatal_diag = NULL;
+
+	/* The map owns the entries. */
+	ofc_hashmap_delete(diag->map);
+	ofc_free(diag->entry);
+
+	ofc_hashmap_delete(diag->repeat);
+
+	unsigned i;
+	for (i = 0; i < diag->file_count; i++)
+		ofc_free(diag->file[i]);
+	ofc_free(diag->file);
+
+	ofc_free(diag->pending.base);
+
+	pthread_mutex_destroy(&diag->lock);
+	ofc_free(diag);
+}
+
+
+static ofc_diag_t*    ofc_diag__default      = NULL;
+static pthread_once_t ofc_diag__default_once = PTHREAD_ONCE_INIT;
+
+static _Thread_local ofc_diag_t* ofc_diag__redirect = NULL;
+
+static void ofc_diag__default_delete(void)
+{
+	ofc_diag_delete(ofc_diag__default);
+	ofc_diag__default = NULL;
+}
+
+static void ofc_diag__default_create(void)
+{
+	ofc_diag__default = ofc_diag_create();
+	if (ofc_diag__default)
+		atexit(ofc_diag__default_delete);
+}
+
+ofc_diag_t* ofc_diag_default(void)
+{
+	if (ofc_diag__redirect)
+		return ofc_diag__redirect;
+
+	ofc_context_t* context = ofc_context_current();
+	if (context->diag)
+		return context->diag;
+
+	pthread_once(&ofc_diag__default_once,
+		ofc_diag__default_create);
+	return ofc_diag__default;
+}
+
+void ofc_diag_redirect(ofc_diag_t* diag)
+{
+	ofc_diag__redirect = diag;
+}
+
+
+void ofc_diag_set_format(
+	ofc_diag_t* diag, ofc_diag_format_e format)
+{
+	if (!diag)
+		return;
+
+	pthread_mutex_lock(&diag->lock);
+	if (diag->output >= 0)
+	{
+		/* Text that's already written stays written,
+		   only later entries change format. */
+		if (diag->format == OFC_DIAG_FORMAT_TEXT)
+			ofc_diag__write_pending(diag, diag->output);
+		if (format == OFC_DIAG_FORMAT_TEXT)
+			ofc_diag__print_text(diag);
+	}
+	diag->format = format;
+	pthread_mutex_unlock(&diag->lock);
+}
+
+static void ofc_diag__fatal(int sig)
+{
+	ofc_diag_t* diag = ofc_diag__fatal_diag;
+	if (diag && (diag->output >= 0)
+		&& (diag->format == OFC_DIAG_FORMAT_TEXT))
+	{
+		ofc_diag__write_fd(diag->output,
+			diag->pending.base, diag->pending.size);
+	}
+
+	/* The handler was reset, so this takes the default action. */
+	raise(sig);
+}
+
+static void ofc_diag__fatal_install(void)
+{
+	static const int fatal[] =
+	{
+		SIGSEGV, SIGBUS, SIGILL, SIGFPE,
+		SIGABRT, SIGTERM, SIGINT, SIGHUP,
+	};
+
+	struct sigaction action;
+	memset(&action, 0x00, sizeof(action));
+	action.sa_handler = ofc_diag__fatal;
+	action.sa_flags   = SA_RESETHAND;
+	sigemptyset(&action.sa_mask);
+
+	unsigned i;
+	for (i = 0; i < (sizeof(fatal) / sizeof(fatal[0])); i++)
+		sigaction(fatal[i], &action, NULL);
+}
+
+void ofc_diag_set_output(
+	ofc_diag_t* diag, int fd)
+{
+	if (!diag)
+		return;
+
+	pthread_mutex_lock(&diag->lock);
+	if ((diag->output >= 0)
+		&& (diag->format == OFC_DIAG_FORMAT_TEXT))
+		ofc_diag__write_pending(diag, diag->output);
+	diag->output = fd;
+	if ((fd >= 0) && (diag->format == OFC_DIAG_FORMAT_TEXT))
+		ofc_diag__print_text(diag);
+	pthread_mutex_unlock(&diag->lock);
+
+	if (fd >= 0)
+	{
+		ofc_diag__fatal_diag = diag;
+		pthread_once(&ofc_diag__fatal_once,
+			ofc_diag__fatal_install);
+	}
+	else if (ofc_diag__fatal_diag == diag)
+	{
+		ofc_diag__fatal_diag = NULL;
+	}
+}
+
+bool ofc_diag_sync(ofc_diag_t* diag)
+{
+	if (!diag)
+		return false;
+
+	pthread_mutex_lock(&diag->lock);
+	bool success = true;
+	if ((diag->output >= 0)
+		&& (diag->format == OFC_DIAG_FORMAT_TEXT))
+	{
+		ofc_diag__print_text(diag);
+		success = ofc_diag__write_pending(diag, diag->output);
+	}
+	pthread_mutex_unlock(&diag->lock);
+	return success;
+}
+
+void ofc_diag_set_limit(
+	ofc_diag_t* diag, unsigned limit)
+{
+	if (!diag)
+		return;
+
+	pthread_mutex_lock(&diag->lock);
+	diag->limit = limit;
+	pthread_mutex_unlock(&diag->lock);
+}
+
+
+/* Files are numbered in order of their first diagnostic,
+   there are rarely more than a handful so search linearly. */
+static bool ofc_diag__file(
+	ofc_diag_t* diag, const char* path, unsigned* index)
+{
+	if (!path) path = "";
+
+	unsigned i;
+	for (i = diag->file_count; i > 0; i--)
+	{
+		if (strcmp(diag->file[i - 1], path) == 0)
+		{
+			*index = (i - 1);
+			return true;
+		}
+	}
+
+	char** nfile = (char**)ofc_realloc(OFC_ALLOC_DIAG, diag->file,
+		(sizeof(char*) * (diag->file_count + 1)));
+	if (!nfile) return false;
+	diag->file = nfile;
+
+	diag->file[diag->file_count] = ofc_strdup(OFC_ALLOC_DIAG, path);
+	if (!diag->file[diag->file_count])
+		return false;
+
+	*index = diag->file_count++;
+	return true;
+}
+
+/* Returns false when the warning has been seen too many times. */
+static bool ofc_diag__repeat(
+	ofc_diag_t* diag, const char* message)
+{
+	if (diag->limit == 0)
+		return true;
+
+	ofc_diag__repeat_t* repeat
+		= ofc_hashmap_find_modify(
+			diag->repeat, message);
+	if (!repeat)
+	{
+		repeat = (ofc_diag__repeat_t*)ofc_alloc(OFC_ALLOC_DIAG,
+			sizeof(ofc_diag__repeat_t));
+		if (!repeat) return true;
+
+		repeat->message = ofc_strdup(OFC_ALLOC_DIAG, message);
+		repeat->count   = 0;
+		if (!repeat->message
+			|| !ofc_hashmap_add(diag->repeat, repeat))
+		{
+			ofc_diag__repeat_delete(repeat);
+			return true;
+		}
+	}
+
+	if (repeat->count >= diag->limit)
+	{
+		diag->suppressed++;
+		return false;
+	}
+
+	repeat->count++;
+	return true;
+}
+
+static bool ofc_diag__add(
+	ofc_diag_t* diag, ofc_diag_severity_e severity,
+	const char* path, bool positional,
+	unsigned row, unsigned col,
+	const char* context, const char* message)
+{
+	ofc_diag__entry_t key =
+	{
+		.severity   = severity,
+		.positional = positional,
+		.row        = (positional ? row : 0),
+		.col        = (positional ? col : 0),
+		.message    = (char*)message,
+	};
+
+	if (!ofc_diag__file(diag, path, &key.file))
+		return false;
+
+	if (ofc_hashmap_find(diag->map, &key))
+		return true;
+
+	if ((severity == OFC_DIAG_WARNING)
+		&& !ofc_diag__repeat(diag, message))
+		return true;
+
+	if (diag->count >= diag->max_count)
+	{
+		unsigned nmax = (diag->max_count << 1);
+		if (nmax == 0) nmax = 16;
+
+		ofc_diag__entry_t** nentry
+			= (ofc_diag__entry_t**)ofc_realloc(OFC_ALLOC_DIAG, diag->entry,
+				(sizeof(ofc_diag__entry_t*) * nmax));
+		if (!nentry) return false;
+		diag->entry     = nentry;
+		diag->max_count = nmax;
+	}
+
+	ofc_diag__entry_t* entry
+		= (ofc_diag__entry_t*)ofc_alloc(OFC_ALLOC_DIAG,
+			sizeof(ofc_diag__entry_t));
+	if (!entry) return false;
+
+	*entry = key;
+	entry->seq     = diag->count;
+	entry->message = ofc_strdup(OFC_ALLOC_DIAG, message);
+	entry->context = (context ? ofc_strdup(OFC_ALLOC_DIAG, context) : NULL);
+	if (!entry->message
+		|| (context && !entry->context)
+		|| !ofc_hashmap_add(diag->map, entry))
+	{
+		ofc_diag__entry_delete(entry);
+		return false;
+	}
+
+	diag->entry[diag->count++] = entry;
+	diag->total[severity]++;
+	return true;
+}
+
+bool ofc_diag_add(
+	ofc_diag_t* diag, ofc_diag_severity_e severity,
+	const char* path, bool positional,
+	unsigned row, unsigned col,
+	const char* context, const char* message)
+{
+	if (!diag || !message
+		|| (severity >= OFC_DIAG_SEVERITY_COUNT))
+		return false;
+
+	pthread_mutex_lock(&diag->lock);
+	bool success = ofc_diag__add(
+		diag, severity, path, positional,
+		row, col, context, message);
+	if (success && (diag->output >= 0)
+		&& (diag->format == OFC_DIAG_FORMAT_TEXT))
+	{
+		ofc_diag__print_text(diag);
+		if (diag->pending.size >= OFC_DIAG__PENDING_MAX)
+			ofc_diag__write_pending(diag, diag->output);
+	}
+	pthread_mutex_unlock(&diag->lock);
+	return success;
+}
+
+unsigned ofc_diag_count(
+	const ofc_diag_t* diag, ofc_diag_severity_e severity)
+{
+	if (!diag || (severity >= OFC_DIAG_SEVERITY_COUNT))
+		return 0;
+
+	ofc_diag_t* mdiag = (ofc_diag_t*)diag;
+	pthread_mutex_lock(&mdiag->lock);
+	unsigned count = diag->total[severity];
+	pthread_mutex_unlock(&mdiag->lock);
+	return count;
+}
+
+bool ofc_diag_foreach(
+	ofc_diag_t* diag, void* param,
+	bool (*func)(const ofc_diag_info_t* info, void* param))
+{
+	if (!diag || !func)
+		return false;
+
+	pthread_mutex_lock(&diag->lock);
+
+	bool success = true;
+	unsigned i;
+	for (i = 0; success && (i < diag->count); i++)
+	{
+		const ofc_diag__entry_t* entry = diag->entry[i];
+
+		ofc_diag_info_t info =
+		{
+			.severity   = entry->severity,
+			.path       = diag->file[entry->file],
+			.positional = entry->positional,
+			.row        = entry->row,
+			.col        = entry->col,
+			.context    = entry->context,
+			.message    = entry->message,
+		};
+		success = func(&info, param);
+	}
+
+	pthread_mutex_unlock(&diag->lock);
+	return success;
+}
+
+
+
+static void ofc_diag__print_json(
+	const ofc_diag_t* diag, ofc_diag__buff_t* buff)
+{
+	ofc_diag__write_strz(buff, "{\n  \"diagnostics\": [");
+
+	unsigned i;
+	for (i = 0; i < diag->count; i++)
+	{
+		const ofc_diag__entry_t* entry = diag->entry[i];
+
+		ofc_diag__writef(buff,
+			"%s\n    { \"severity\": \"%s\", \"file\": ",
+			(i > 0 ? "," : ""),
+			ofc_diag__severity_level[entry->severity]);
+		ofc_diag__write_json_strz(buff, diag->file[entry->file]);
+
+		if (entry->positional)
+		{
+			ofc_diag__writef(buff,
+				", \"line\": %u, \"column\": %u",
+				(entry->row + 1), (entry->col + 1));
+		}
+
+		ofc_diag__write_strz(buff, ", \"message\": ");
+		ofc_diag__write_json_strz(buff, entry->message);
+
+		if (entry->positional && entry->context)
+		{
+			ofc_diag__write_strz(buff, ", \"source\": ");
+			ofc_diag__write_json_strz(buff, entry->context);
+		}
+
+		ofc_diag__write_strz(buff, " }");
+	}
+
+	ofc_diag__writef(buff,
+		"\n  ],\n  \"suppressed\": %u\n}\n",
+		diag->suppressed);
+}
+
+static void ofc_diag__print_sarif(
+	const ofc_diag_t* diag, ofc_diag__buff_t* buff)
+{
+	ofc_diag__write_strz(buff,
+		"{\n"
+		"  \"version\": \"2.1.0\",\n"
+		"  \"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n"
+		"  \"runs\": [\n"
+		"    {\n"
+		"      \"tool\": { \"driver\": { \"name\": \"ofc\" } },\n"
+		"      \"results\": [");
+
+	unsigned i;
+	for (i = 0; i < diag->count; i++)
+	{
+		const ofc_diag__entry_t* entry = diag->entry[i];
+
+		ofc_diag__writef(buff,
+			"%s\n        { \"level\": \"%s\", \"message\": { \"text\": ",
+			(i > 0 ? "," : ""),
+			ofc_diag__severity_level[entry->severity]);
+		ofc_diag__write_json_strz(buff, entry->message);
+		ofc_diag__write_strz(buff, " }");
+
+		ofc_diag__write_strz(buff, ", \"locations\": [ { \"physicalLocation\": { \"artifactLocation\": { \"uri\": ");
+		ofc_diag__write_json_strz(buff, diag->file[entry->file]);
+		ofc_diag__write_strz(buff, " }");
+
+		if (entry->positional)
+		{
+			ofc_diag__writef(buff,
+				", \"region\": { \"startLine\": %u, \"startColumn\": %u }",
+				(entry->row + 1), (entry->col + 1));
+		}
+
+		ofc_diag__write_strz(buff, " } } ] }");
+	}
+
+	ofc_diag__write_strz(buff,
+		"\n      ]\n"
+		"    }\n"
+		"  ]\n"
+		"}\n");
+}
+
+
+static int ofc_diag__entry_order(const void* a, const void* b)
+{
+	const ofc_diag__entry_t* ea = *((const ofc_diag__entry_t**)a);
+	const ofc_diag__entry_t* eb = *((const ofc_diag__entry_t**)b);
+
+	if (ea->file != eb->file)
+		return (ea->file < eb->file ? -1 : 1);
+
+	/* Diagnostics without a position follow those in the file. */
+	if (ea->positional != eb->positional)
+		return (ea->positional ? -1 : 1);
+
+	if (ea->positional)
+	{
+		if (ea->row != eb->row)
+			return (ea->row < eb->row ? -1 : 1);
+		if (ea->col != eb->col)
+			return (ea->col < eb->col ? -1 : 1);
+	}
+
+	if (ea->seq != eb->seq)
+		return (ea->seq < eb->seq ? -1 : 1);
+	return 0;
+}
+
+static void ofc_diag__clear(ofc_diag_t* diag)
+{
+	unsigned i;
+	for (i = 0; i < diag->count; i++)
+	{
+		ofc_hashmap_remove(diag->map, diag->entry[i]);
+		ofc_diag__entry_delete(diag->entry[i]);
+	}
+	diag->count = 0;
+	diag->suppressed = 0;
+
+	diag->formatted    = 0;
+	diag->pending.size = 0;
+	diag->pending.fail = false;
+}
+
+static bool ofc_diag__merge(
+	const ofc_diag_info_t* info, ofc_diag_t* diag)
+{
+	return ofc_diag_add(diag, info->severity,
+		info->path, info->positional,
+		info->row, info->col,
+		info->context, info->message);
+}
+
+bool ofc_diag_merge(ofc_diag_t* diag, ofc_diag_t* src)
+{
+	if (!diag || (diag == src))
+		return false;
+
+	return ofc_diag_foreach(src, diag,
+		(void*)ofc_diag__merge);
+}
+
+
+void ofc_diag_reset(ofc_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	ofc_hashmap_t* repeat = ofc_hashmap_create(
+		NULL, NULL,
+		(void*)ofc_diag__repeat_key,
+		(void*)ofc_diag__repeat_delete);
+
+	pthread_mutex_lock(&diag->lock);
+	ofc_diag__clear(diag);
+
+	unsigned i;
+	for (i = 0; i < OFC_DIAG_SEVERITY_COUNT; i++)
+		diag->total[i] = 0;
+
+	/* Keep the old repeat counts if we can't replace them. */
+	if (repeat)
+	{
+		ofc_hashmap_delete(diag->repeat);
+		diag->repeat = repeat;
+	}
+	pthread_mutex_unlock(&diag->lock);
+}
+
+bool ofc_diag_flush(ofc_diag_t* diag, int fd)
+{
+	if (!diag)
+		return false;
+
+	pthread_mutex_lock(&diag->lock);
+
+	/* Text is written in the order it was added, likely
+	   partly already, only structured documents are sorted. */
+	if (diag->format == OFC_DIAG_FORMAT_TEXT)
+	{
+		ofc_diag__print_text(diag);
+		if (diag->suppressed > 0)
+		{
+			ofc_diag__writef(&diag->pending,
+				"Warning: %u repeated warnings suppressed\n",
+				diag->suppressed);
+		}
+
+		bool success = ofc_diag__write_pending(diag, fd);
+		ofc_diag__clear(diag);
+
+		pthread_mutex_unlock(&diag->lock);
+		return success;
+	}
+
+	qsort(diag->entry, diag->count,
+		sizeof(ofc_diag__entry_t*),
+		ofc_diag__entry_order);
+
+	ofc_diag__buff_t buff =
+	{
+		.base = NULL,
+		.size = 0,
+		.max  = 0,
+		.fail = false,
+	};
+
+	if (diag->format == OFC_DIAG_FORMAT_SARIF)
+		ofc_diag__print_sarif(diag, &buff);
+	else
+		ofc_diag__print_json(diag, &buff);
+
+	bool success = (!buff.fail
+		&& ofc_diag__write_fd(fd, buff.base, buff.size));
+	ofc_free(buff.base);
+
+	ofc_diag__clear(diag);
+
+	pthread_mutex_unlock(&diag->lock);
+	return success;
+}
@@ -18,14 +18,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "ofc/diag.h"
 #include "ofc/fctype.h"
 #include "ofc/file.h"
-#include "ofc/global_opts.h"
-
-extern ofc_global_opts_t global_opts;
+#include "ofc/context.h"
 
 
 static char* ofc_file__read(const char* path, unsigned* size)
@@ -40,7 +40,7 @@ static char* ofc_file__read(const char* path, unsigned* size)
 		return NULL;
 	}
 
-	char* buff = (char*)malloc(fs.st_size + 1);
+	char* buff = (char*)ofc_alloc(OFC_ALLOC_FILE, fs.st_size + 1);
 	if (!buff)
 	{
 		close(fd);
@@ -52,7 +52,7 @@ static char* ofc_file__read(const char* path, unsigned* size)
 
 	if (rsize != fs.st_size)
 	{
-		free(buff);
+		ofc_free(buff);
 		return NULL;
 	}
 
@@ -62,14 +62,110 @@ static char* ofc_file__read(const char* path, unsigned* size)
 	return buff;
 }
 
+/* The mapping is always at least a byte longer than the file, the pages
+   past its end are anonymous so the text is NUL terminated. */
+static size_t ofc_file__map_size(unsigned size)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	return (((size / page) + 1) * page);
+}
+
+static char* ofc_file__map(const char* path, unsigned* size)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0 ) return NULL;
+
+	struct stat fs;
+	if ((fstat(fd, &fs) != 0)
+		|| ((uintmax_t)fs.st_size >= UINT32_MAX))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	size_t map_size = ofc_file__map_size(fs.st_size);
+	char* base = mmap(NULL, map_size, PROT_READ,
+		(MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+	if (base == MAP_FAILED)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	if ((fs.st_size > 0) && (mmap(base, fs.st_size, PROT_READ,
+		(MAP_PRIVATE | MAP_FIXED), fd, 0) == MAP_FAILED))
+	{
+		munmap(base, map_size);
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+
+	if (size) *size = fs.st_size;
+	return base;
+}
+
 ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts)
 {
-	ofc_file_t* file = (ofc_file_t*)malloc(sizeof(ofc_file_t));
+	ofc_file_t* file = (ofc_file_t*)ofc_alloc(OFC_ALLOC_FILE, sizeof(ofc_file_t));
 	if (!file) return NULL;
 
-	file->path = strdup(path);
-	file->strz = ofc_file__read(path, &file->size);
-	file->opts = opts;
+	file->path   = ofc_strdup(OFC_ALLOC_FILE, path);
+	file->strz   = ofc_file__read(path, &file->size);
+	file->opts   = opts;
+	file->mapped = false;
+
+	file->include = NULL;
+
+	file->ref = 0;
+
+	if (!file->path || !file->strz)
+	{
+		ofc_file_delete(file);
+		return NULL;
+	}
+
+	return file;
+}
+
+ofc_file_t* ofc_file_create_strz(
+	const char* path, ofc_lang_opts_t opts, const char* strz)
+{
+	if (!path || !strz)
+		return NULL;
+
+	ofc_file_t* file = (ofc_file_t*)ofc_alloc(OFC_ALLOC_FILE, sizeof(ofc_file_t));
+	if (!file) return NULL;
+
+	file->path   = ofc_strdup(OFC_ALLOC_FILE, path);
+	file->strz   = ofc_strdup(OFC_ALLOC_FILE, strz);
+	file->size   = strlen(strz);
+	file->opts   = opts;
+	file->mapped = false;
+
+	file->include = NULL;
+
+	file->ref = 0;
+
+	if (!file->path || !file->strz)
+	{
+		ofc_file_delete(file);
+		return NULL;
+	}
+
+	return file;
+}
+
+ofc_file_t* ofc_file_create_mapped(
+	const char* path, ofc_lang_opts_t opts)
+{
+	ofc_file_t* file = (ofc_file_t*)ofc_alloc(OFC_ALLOC_FILE, sizeof(ofc_file_t));
+	if (!file) return NULL;
+
+	file->path   = ofc_strdup(OFC_ALLOC_FILE, path);
+	file->strz   = ofc_file__map(path, &file->size);
+	file->opts   = opts;
+	file->mapped = (file->strz != NULL);
 
 	file->include = NULL;
 
@@ -91,7 +187,7 @@ ofc_file_t* ofc_file_create_include(
 	if (!include) return file;
 	if (!file) return NULL;
 
-	file->include = strdup(include);
+	file->include = ofc_strdup(OFC_ALLOC_FILE, include);
 	if (!file->include)
 	{
 		ofc_file_delete(file);
@@ -124,10 +220,13 @@ void ofc_file_delete(ofc_file_t* file)
 		return;
 	}
 
-	free(file->strz);
-	free(file->path);
-	free(file->include);
-	free(file);
+	if (file->mapped)
+		munmap(file->strz, ofc_file__map_size(file->size));
+	else
+		ofc_free(file->strz);
+	ofc_free(file->path);
+	ofc_free(file->include);
+	ofc_free(file);
 }
 
 
@@ -159,7 +258,7 @@ static char* ofc_file__include_path(
 	const char* file, const char* path)
 {
 	if (!file)
-		return strdup(path);
+		return ofc_strdup(OFC_ALLOC_FILE, path);
 
 	unsigned prefix_len = 0;
 
@@ -171,11 +270,11 @@ static char* ofc_file__include_path(
 	}
 
 	if (prefix_len == 0)
-		return strdup(path);
+		return ofc_strdup(OFC_ALLOC_FILE, path);
 
 	unsigned rpath_len = prefix_len + strlen(path);
 
-	char* rpath = malloc(rpath_len + 1);
+	char* rpath = ofc_alloc(OFC_ALLOC_FILE, rpath_len + 1);
 	if (!rpath) return NULL;
 
 	sprintf(rpath, "%.*s%s",
@@ -188,7 +287,7 @@ char* ofc_file_include_path(
 	const ofc_file_t* file, const char* path)
 {
 	if (!file)
-		return strdup(path);
+		return ofc_strdup(OFC_ALLOC_FILE, path);
 
 	if (file->include)
 		return ofc_file__include_path(
@@ -200,6 +299,21 @@ char* ofc_file_include_path(
 
 
 
+void ofc_file_release(const ofc_file_t* file, const char* ptr)
+{
+	if (!file || !file->mapped || !ptr)
+		return;
+
+	uintptr_t pos = ((uintptr_t)ptr - (uintptr_t)file->strz);
+	if (pos > file->size)
+		return;
+
+	size_t page = sysconf(_SC_PAGESIZE);
+	pos -= (pos % page);
+	if (pos > 0)
+		madvise(file->strz, pos, MADV_DONTNEED);
+}
+
 bool ofc_file_get_position(
 	const ofc_file_t* file, const char* ptr,
 	unsigned* row, unsigned* col)
@@ -256,30 +370,30 @@ static bool line_empty(const char* ptr, unsigned len)
 static void ofc_file__debug_va(
 	const ofc_file_t* file,
 	const char* sol, const char* ptr,
-	const char* type, const char* format, va_list args)
+	ofc_diag_severity_e severity,
+	const char* format, va_list args)
 {
-	unsigned row, col;
+	unsigned row = 0, col = 0;
 	bool positional = ofc_file_get_position(
 		file, ptr, &row, &col);
 
-	fprintf(stderr, "%s:", type);
+	va_list largs;
+	va_copy(largs, args);
+	int mlen = vsnprintf(NULL, 0, format, largs);
+	va_end(largs);
+	if (mlen < 0) mlen = 0;
 
-	if (file && file->path)
-		fprintf(stderr, "%s:", file->path);
-
-	if (positional)
-		fprintf(stderr, "%u,%u:", (row + 1), col);
-
-	fprintf(stderr, " ");
-	vfprintf(stderr, format, args);
-	fprintf(stderr, "\n");
+	char message[mlen + 1];
+	vsnprintf(message, (mlen + 1), format, args);
 
+	const char* s   = NULL;
+	unsigned    len = 0;
 	if (positional)
 	{
 		if (!sol)
 			sol = ptr;
 
-		const char* s = file->strz;
+		s = file->strz;
 		const char* p;
 		for (p = file->strz; p < sol; p++)
 		{
@@ -287,7 +401,7 @@ static void ofc_file__debug_va(
 				s = &p[1];
 		}
 
-		unsigned len = ((uintptr_t)ptr - (uintptr_t)s);
+		len = ((uintptr_t)ptr - (uintptr_t)s);
 		for (; !ofc_is_vspace(s[len]) && (s[len] != '\0'); len++);
 
 		/* Print line(s) above if line is empty. */
@@ -303,21 +417,21 @@ static void ofc_file__debug_va(
 			len += ((uintptr_t)s - (uintptr_t)ns);
 			s = ns;
 		}
+	}
 
-		fprintf(stderr, "%.*s\n", len, s);
+	char context[len + 1];
+	if (s) memcpy(context, s, len);
+	context[len] = '\0';
 
-		unsigned i;
-		for (i = 0; i < col; i++)
-			fprintf(stderr, " ");
-		fprintf(stderr, "^\n");
-	}
+	ofc_diag_add(ofc_diag_default(), severity,
+		(file ? file->path : NULL), positional,
+		row, col, (s ? context : NULL), message);
 }
 
-static bool ofc_file__error_count = 0;
-
 bool ofc_file_no_errors(void)
 {
-	return (ofc_file__error_count == 0);
+	return (ofc_diag_count(
+		ofc_diag_default(), OFC_DIAG_ERROR) == 0);
 }
 
 void ofc_file_error_va(
@@ -326,8 +440,7 @@ void ofc_file_error_va(
 	const char* format, va_list args)
 {
 	ofc_file__debug_va(
-		file, sol, ptr, "Error", format, args);
-	ofc_file__error_count++;
+		file, sol, ptr, OFC_DIAG_ERROR, format, args);
 }
 
 void ofc_file_warning_va(
@@ -335,10 +448,10 @@ void ofc_file_warning_va(
 	const char* sol, const char* ptr,
 	const char* format, va_list args)
 {
-	if (!global_opts.no_warn)
+	if (!ofc_context_current()->global_opts.no_warn)
 	{
 		ofc_file__debug_va(
-			file, sol, ptr, "Warning", format, args);
+			file, sol, ptr, OFC_DIAG_WARNING, format, args);
 	}
 }
 
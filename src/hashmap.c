@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ofc/alloc.h"
 #include "ofc/hashmap.h"
 
 typedef struct ofc_hashmap__entry_s ofc_hashmap__entry_t;
@@ -64,7 +65,7 @@ ofc_hashmap_t* ofc_hashmap_create(
 	ofc_hashmap_item_delete_f item_delete)
 {
 	ofc_hashmap_t* map
-		= (ofc_hashmap_t*)malloc(
+		= (ofc_hashmap_t*)ofc_alloc(OFC_ALLOC_HASHMAP,
 			sizeof(ofc_hashmap_t));
 	if (!map) return NULL;
 
@@ -95,7 +96,7 @@ static void ofc_hashmap__entry_delete(
 
 	if (item_delete)
 		item_delete(entry->item);
-	free(entry);
+	ofc_free(entry);
 }
 
 void ofc_hashmap_delete(ofc_hashmap_t* map)
@@ -107,7 +108,7 @@ void ofc_hashmap_delete(ofc_hashmap_t* map)
 	for (i = 0; i < 256; i++)
 		ofc_hashmap__entry_delete(
 			map->base[i], map->item_delete);
-	free(map);
+	ofc_free(map);
 }
 
 
@@ -125,7 +126,7 @@ bool ofc_hashmap_add(ofc_hashmap_t* map, void* item)
 	uint8_t hash = map->hash(key);
 
 	ofc_hashmap__entry_t* entry
-		= (ofc_hashmap__entry_t*)malloc(
+		= (ofc_hashmap__entry_t*)ofc_alloc(OFC_ALLOC_HASHMAP,
 			sizeof(ofc_hashmap__entry_t));
 	if (!entry) return false;
 
@@ -161,7 +162,7 @@ void ofc_hashmap_remove(
 	else
 		prev->next = node->next;
 
-	free(node);
+	ofc_free(node);
 }
 
 
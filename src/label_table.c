@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "ofc/alloc.h"
 #include "ofc/label_table.h"
 
 typedef struct label_s label_t;
@@ -37,7 +38,7 @@ struct ofc_label_table_s
 ofc_label_table_t* ofc_label_table_create(void)
 {
 	ofc_label_table_t* table
-		= (ofc_label_table_t*)malloc(
+		= (ofc_label_table_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_label_table_t));
 	if (!table) return NULL;
 
@@ -52,7 +53,7 @@ static void label__delete(label_t* label)
 	if (!label)
 		return;
 	label__delete(label->next);
-	free(label);
+	ofc_free(label);
 }
 
 void ofc_label_table_delete(ofc_label_table_t* table)
@@ -63,7 +64,7 @@ void ofc_label_table_delete(ofc_label_table_t* table)
 	unsigned i;
 	for (i = 0; i < 256; i++)
 		label__delete(table->base[i]);
-	free(table);
+	ofc_free(table);
 }
 
 
@@ -87,7 +88,7 @@ bool ofc_label_table_add(
 
 	uint8_t hash = ofc_label_table__offset_hash(offset);
 
-	label_t* label = (label_t*)malloc(sizeof(label_t));
+	label_t* label = (label_t*)ofc_alloc(OFC_ALLOC_PARSE, sizeof(label_t));
 	if (!label) return false;
 
 	label->offset = offset;
@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "ofc/file.h"
@@ -23,21 +24,305 @@
 #include "ofc/prep.h"
 #include "ofc/sema.h"
 #include "ofc/cliarg.h"
+#include "ofc/diag.h"
+#include "ofc/server.h"
+#include "ofc/reformat.h"
+#include "ofc/context.h"
 
-ofc_global_opts_t global_opts;
+
+static double ofc_main__time(void)
+{
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+		return 0.0;
+	return (ts.tv_sec + (ts.tv_nsec / 1000000000.0));
+}
+
+/* Machine readable, one line per phase, parsed by the benchmark suite. */
+static void ofc_main__time_phase(
+	const char* phase, double* start)
+{
+	double now = ofc_main__time();
+	if (ofc_context_current()->global_opts.time_phases)
+		fprintf(stderr, "Time:%s: %.6f\n", phase, (now - *start));
+	*start = now;
+}
+
+/* Adds the time since start to a phase which happens once per unit. */
+static void ofc_main__time_add(
+	double* total, double* start)
+{
+	double now = ofc_main__time();
+	*total += (now - *start);
+	*start = now;
+}
+
+typedef enum
+{
+	OFC_MAIN__STREAM_PREP = 0,
+	OFC_MAIN__STREAM_PARSE,
+	OFC_MAIN__STREAM_PARSE_PRINT,
+	OFC_MAIN__STREAM_SEMA,
+	OFC_MAIN__STREAM_SEMA_PRINT,
+	OFC_MAIN__STREAM_DELETE,
+
+	OFC_MAIN__STREAM_PHASE_COUNT
+} ofc_main__stream_phase_e;
+
+static const char* ofc_main__stream_phase[] =
+{
+	"prep",
+	"parse",
+	"parse-print",
+	"sema",
+	"sema-print",
+	"delete",
+};
+
+/* The semantic tree of a whole file is printed after its parse tree, with
+   procedures after the other program units. So streamed units whose tree
+   can't be printed yet are held in temporary files rather than memory. */
+typedef enum
+{
+	OFC_MAIN__STREAM_LATER_UNIT = 0,
+	OFC_MAIN__STREAM_LATER_PROCEDURE,
+
+	OFC_MAIN__STREAM_LATER_COUNT
+} ofc_main__stream_later_e;
+
+static int ofc_main__stream_later(
+	FILE* later[], ofc_main__stream_later_e type)
+{
+	if (!later[type])
+		later[type] = tmpfile();
+	return (later[type] ? fileno(later[type]) : -1);
+}
+
+static bool ofc_main__stream_later_print(
+	FILE* later[])
+{
+	bool success = true;
+	unsigned i;
+	for (i = 0; i < OFC_MAIN__STREAM_LATER_COUNT; i++)
+	{
+		if (!later[i])
+			continue;
+
+		int fd = fileno(later[i]);
+		if (lseek(fd, 0, SEEK_SET) != 0)
+			success = false;
+
+		char buff[4096];
+		ssize_t len;
+		while (success && ((len = read(fd, buff, sizeof(buff))) != 0))
+		{
+			if ((len < 0) || (write(STDOUT_FILENO, buff, len) != len))
+				success = false;
+		}
+
+		fclose(later[i]);
+		later[i] = NULL;
+	}
+	return success;
+}
+
+/* Each program unit is preprocessed, parsed, analysed and printed on its
+   own, then released along with the source it was read from before the
+   next one is read. So memory use is bounded by the largest unit rather
+   than the whole file, but calls between units aren't checked. */
+static bool ofc_main__stream_units(
+	ofc_file_t* file, const ofc_lang_opts_t* lang_opts,
+	FILE* later[])
+{
+	const ofc_global_opts_t* global_opts
+		= &ofc_context_current()->global_opts;
+
+	double time[OFC_MAIN__STREAM_PHASE_COUNT] = { 0.0 };
+	double time_phase = ofc_main__time();
+	unsigned hit = 0, miss = 0;
+
+	bool success = true;
+	unsigned offset = 0;
+	while (true)
+	{
+		ofc_sparse_t* condense;
+		if (!ofc_prep_unit(file, &offset, &condense))
+		{
+			if (ofc_file_no_errors())
+				ofc_file_error(file, NULL, "Failed to preprocess source file");
+			return false;
+		}
+		if (!condense) break;
+		ofc_main__time_add(&time[OFC_MAIN__STREAM_PREP], &time_phase);
+
+		ofc_parse_stmt_list_t* program
+			= ofc_parse_file(condense);
+		ofc_main__time_add(&time[OFC_MAIN__STREAM_PARSE], &time_phase);
+		if (!program)
+		{
+			if (ofc_file_no_errors())
+				ofc_file_error(file, NULL, "Failed to parse program");
+			success = false;
+		}
+
+		if (program && global_opts->parse_print)
+		{
+			ofc_colstr_t* cs = ofc_colstr_create(72, 0);
+			bool printed = ofc_parse_file_print_units(cs, program);
+			if (printed) ofc_colstr_fdprint(cs, STDOUT_FILENO);
+			ofc_colstr_delete(cs);
+
+			if (!printed)
+			{
+				ofc_file_error(file, NULL, "Failed to print parse tree");
+				ofc_parse_stmt_list_delete(program);
+				ofc_sparse_delete(condense);
+				return false;
+			}
+			ofc_main__time_add(&time[OFC_MAIN__STREAM_PARSE_PRINT], &time_phase);
+		}
+
+		ofc_sema_scope_t* sema = NULL;
+		if (program && !global_opts->parse_only)
+		{
+			sema = ofc_sema_scope_global(lang_opts, program);
+			ofc_main__time_add(&time[OFC_MAIN__STREAM_SEMA], &time_phase);
+			if (!sema)
+			{
+				if (ofc_file_no_errors())
+					ofc_file_error(file, NULL, "Program failed semantic analysis");
+				success = false;
+			}
+		}
+
+		if (sema && global_opts->sema_print)
+		{
+			/* A procedure is declared in the global scope,
+			   other program units are its children. */
+			int fd = STDOUT_FILENO;
+			if (!sema->child || (sema->child->count == 0))
+				fd = ofc_main__stream_later(
+					later, OFC_MAIN__STREAM_LATER_PROCEDURE);
+			else if (global_opts->parse_print)
+				fd = ofc_main__stream_later(
+					later, OFC_MAIN__STREAM_LATER_UNIT);
+
+			ofc_colstr_t* cs = ofc_colstr_create(72, 0);
+			bool printed = ((fd >= 0)
+				&& ofc_sema_scope_print(cs, 0, sema));
+			if (printed) ofc_colstr_fdprint(cs, fd);
+			ofc_colstr_delete(cs);
+
+			if (!printed)
+			{
+				ofc_file_error(file, NULL, "Failed to print semantic tree");
+				ofc_sema_scope_delete(sema);
+				ofc_parse_stmt_list_delete(program);
+				ofc_sparse_delete(condense);
+				return false;
+			}
+			ofc_main__time_add(&time[OFC_MAIN__STREAM_SEMA_PRINT], &time_phase);
+		}
+
+		if (sema)
+		{
+			unsigned h, m;
+			ofc_sema_scope_cache_stats(sema, &h, &m);
+			hit += h;
+			miss += m;
+		}
+
+		ofc_sema_scope_delete(sema);
+		ofc_parse_stmt_list_delete(program);
+		ofc_sparse_delete(condense);
+		ofc_file_release(file, &ofc_file_get_strz(file)[offset]);
+		ofc_diag_sync(ofc_diag_default());
+		ofc_main__time_add(&time[OFC_MAIN__STREAM_DELETE], &time_phase);
+	}
+
+	if (global_opts->time_phases)
+	{
+		unsigned p;
+		for (p = 0; p < OFC_MAIN__STREAM_PHASE_COUNT; p++)
+			fprintf(stderr, "Time:%s: %.6f\n", ofc_main__stream_phase[p], time[p]);
+		if (!global_opts->parse_only)
+			fprintf(stderr, "Cache:scope: %u hits, %u misses\n", hit, miss);
+	}
+
+	return success;
+}
+
+static bool ofc_main__stream(
+	ofc_file_t* file, const ofc_lang_opts_t* lang_opts)
+{
+	FILE* later[OFC_MAIN__STREAM_LATER_COUNT] = { NULL };
+	bool success = ofc_main__stream_units(
+		file, lang_opts, later);
+	return (ofc_main__stream_later_print(later) && success);
+}
+
+static void ofc_main__diag_flush(void)
+{
+	ofc_diag_flush(ofc_diag_default(), STDERR_FILENO);
+}
+
+static void ofc_main__mem_report(void)
+{
+	ofc_alloc_report(STDERR_FILENO);
+}
 
 int main(int argc, const char* argv[])
 {
-	global_opts = OFC_GLOBAL_OPTS_DEFAULT;
+	ofc_global_opts_t* global_opts
+		= &ofc_context_default()->global_opts;
 
 	ofc_lang_opts_t lang_opts = OFC_LANG_OPTS_DEFAULT;
 
 	ofc_file_t* file = NULL;
 
 	if (!ofc_cliarg_parse(argc, argv,
-		&file, &lang_opts, &global_opts))
+		&file, &lang_opts, global_opts))
 		return EXIT_FAILURE;
 
+	/* Diagnostics are buffered, text is written after each phase
+	   while structured formats are sorted and written as we exit. */
+	ofc_diag_t* diag = ofc_diag_default();
+	ofc_diag_set_format(diag, global_opts->diag_format);
+	ofc_diag_set_limit(diag, global_opts->diag_limit);
+
+	if (global_opts->mem_stats)
+		atexit(ofc_main__mem_report);
+
+	/* The server reports diagnostics in its responses. */
+	if (global_opts->server)
+	{
+		return (ofc_server(&lang_opts, STDIN_FILENO, STDOUT_FILENO)
+			? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	ofc_diag_set_output(diag, STDERR_FILENO);
+	atexit(ofc_main__diag_flush);
+
+	double time_start = ofc_main__time();
+	double time_phase = time_start;
+
+	if (global_opts->stream)
+	{
+		bool success = ofc_main__stream(file, &lang_opts);
+		ofc_file_delete(file);
+		ofc_main__time_phase("total", &time_start);
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	if (global_opts->emit_f90)
+	{
+		bool success = ofc_reformat_f90(global_opts->emit_f90,
+			global_opts->sources, global_opts->source_count, &lang_opts);
+		ofc_main__time_phase("emit-f90", &time_phase);
+		ofc_main__time_phase("total", &time_start);
+		return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
 	ofc_sparse_t* condense = ofc_prep(file);
 	if (!condense)
 	{
@@ -46,6 +331,8 @@ int main(int argc, const char* argv[])
 		return EXIT_FAILURE;
 	}
 	ofc_file_delete(file);
+	ofc_diag_sync(diag);
+	ofc_main__time_phase("prep", &time_phase);
 
 	ofc_parse_stmt_list_t* program
 		= ofc_parse_file(condense);
@@ -56,11 +343,13 @@ int main(int argc, const char* argv[])
 		ofc_sparse_delete(condense);
 		return EXIT_FAILURE;
 	}
+	ofc_diag_sync(diag);
+	ofc_main__time_phase("parse", &time_phase);
 
-	if (global_opts.parse_print)
+	if (global_opts->parse_print)
 	{
 		ofc_colstr_t* cs = ofc_colstr_create(72, 0);
-		if (!ofc_parse_stmt_list_print(cs, 0, program))
+		if (!ofc_parse_file_print_units(cs, program))
 		{
 			ofc_file_error(file, NULL, "Failed to print parse tree");
 			ofc_parse_stmt_list_delete(program);
@@ -69,24 +358,56 @@ int main(int argc, const char* argv[])
 		}
 		ofc_colstr_fdprint(cs, STDOUT_FILENO);
 		ofc_colstr_delete(cs);
+		ofc_main__time_phase("parse-print", &time_phase);
+	}
+
+	ofc_sema_incremental_t* incremental = NULL;
+	const ofc_parse_stmt_list_t* analyse = program;
+	if (!global_opts->parse_only && global_opts->incremental)
+	{
+		/* Reused units are only partly analysed, so we can only
+		   reuse them when diagnostics are all we produce. */
+		bool reuse = (!global_opts->sema_print
+			&& !global_opts->call_graph_dot
+			&& !global_opts->call_graph_bin
+			&& !global_opts->project);
+
+		incremental = ofc_sema_incremental_load(
+			global_opts->incremental);
+		analyse = ofc_sema_incremental_view(
+			incremental, file, program, reuse);
+		if (!analyse)
+		{
+			ofc_file_error(file, NULL,
+				"Failed to read incremental cache '%s'",
+				global_opts->incremental);
+			ofc_sema_incremental_delete(incremental);
+			ofc_parse_stmt_list_delete(program);
+			ofc_sparse_delete(condense);
+			return EXIT_FAILURE;
+		}
+		ofc_main__time_phase("incremental", &time_phase);
 	}
 
 	ofc_sema_scope_t* sema = NULL;
-	if (!global_opts.parse_only)
+	if (!global_opts->parse_only)
 	{
 		sema = ofc_sema_scope_global(
-			&lang_opts, program);
+			&lang_opts, analyse);
 		if (!sema)
 		{
 			if (ofc_file_no_errors())
 				ofc_file_error(file, NULL, "Program failed semantic analysis");
+			ofc_sema_incremental_delete(incremental);
 			ofc_parse_stmt_list_delete(program);
 			ofc_sparse_delete(condense);
 			return EXIT_FAILURE;
 		}
+		ofc_diag_sync(diag);
+		ofc_main__time_phase("sema", &time_phase);
 	}
 
-	if (global_opts.sema_print)
+	if (global_opts->sema_print)
 	{
 		ofc_colstr_t* cs = ofc_colstr_create(72, 0);
 		if (!ofc_sema_scope_print(cs, 0, sema))
@@ -94,16 +415,113 @@ int main(int argc, const char* argv[])
 			ofc_file_error(file, NULL, "Failed to print semantic tree");
 			ofc_colstr_delete(cs);
 			ofc_sema_scope_delete(sema);
+			ofc_sema_incremental_delete(incremental);
 			ofc_parse_stmt_list_delete(program);
 			ofc_sparse_delete(condense);
 			return EXIT_FAILURE;
 		}
 		ofc_colstr_fdprint(cs, STDOUT_FILENO);
 		ofc_colstr_delete(cs);
+		ofc_main__time_phase("sema-print", &time_phase);
+	}
+
+	if (sema && (global_opts->call_graph_dot
+		|| global_opts->call_graph_bin))
+	{
+		if ((global_opts->call_graph_dot
+				&& !ofc_sema_callgraph_print_dot(
+					sema->callgraph, STDOUT_FILENO))
+			|| (global_opts->call_graph_bin
+				&& !ofc_sema_callgraph_write(
+					sema->callgraph, STDOUT_FILENO)))
+		{
+			ofc_file_error(file, NULL, "Failed to write call graph");
+			ofc_sema_scope_delete(sema);
+			ofc_sema_incremental_delete(incremental);
+			ofc_parse_stmt_list_delete(program);
+			ofc_sparse_delete(condense);
+			return EXIT_FAILURE;
+		}
+		ofc_main__time_phase("call-graph", &time_phase);
+	}
+
+	if (sema && global_opts->project)
+	{
+		/* Files are identified by absolute path so that the index
+		   doesn't depend on the directory we're run from. */
+		const char* path = ofc_file_get_path(file);
+		char* source = realpath(path, NULL);
+		if (!source) source = strdup(path);
+
+		bool discarded;
+		ofc_sema_project_t* project
+			= ofc_sema_project_load(global_opts->project, &discarded);
+		if (discarded)
+		{
+			ofc_file_warning(file, NULL,
+				"Discarding invalid project index '%s'",
+				global_opts->project);
+		}
+
+		bool success = (source && project
+			&& ofc_sema_project_check(project, source, sema)
+			&& ofc_sema_project_update(project, source, sema,
+				global_opts->project));
+		ofc_sema_project_delete(project);
+		free(source);
+
+		if (!success)
+		{
+			ofc_file_error(file, NULL,
+				"Failed to update project index '%s'",
+				global_opts->project);
+			ofc_sema_scope_delete(sema);
+			ofc_sema_incremental_delete(incremental);
+			ofc_parse_stmt_list_delete(program);
+			ofc_sparse_delete(condense);
+			return EXIT_FAILURE;
+		}
+		ofc_main__time_phase("project", &time_phase);
+	}
+
+	if (incremental)
+	{
+		if (!ofc_sema_incremental_save(
+			incremental, global_opts->incremental))
+		{
+			ofc_file_error(file, NULL,
+				"Failed to write incremental cache '%s'",
+				global_opts->incremental);
+			ofc_sema_scope_delete(sema);
+			ofc_sema_incremental_delete(incremental);
+			ofc_parse_stmt_list_delete(program);
+			ofc_sparse_delete(condense);
+			return EXIT_FAILURE;
+		}
+		ofc_main__time_phase("incremental-save", &time_phase);
+	}
+
+	if (sema && global_opts->time_phases)
+	{
+		unsigned hit, miss;
+		ofc_sema_scope_cache_stats(sema, &hit, &miss);
+		fprintf(stderr, "Cache:scope: %u hits, %u misses\n", hit, miss);
+
+		if (incremental)
+		{
+			unsigned reused, total;
+			ofc_sema_incremental_stats(
+				incremental, &reused, &total);
+			fprintf(stderr, "Cache:incremental: %u of %u units reused\n",
+				reused, total);
+		}
 	}
 
 	ofc_sema_scope_delete(sema);
+	ofc_sema_incremental_delete(incremental);
 	ofc_parse_stmt_list_delete(program);
 	ofc_sparse_delete(condense);
+	ofc_main__time_phase("delete", &time_phase);
+	ofc_main__time_phase("total", &time_start);
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,609 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ofc/numfmt.h"
+
+
+unsigned ofc_numfmt_integer(char* buff, int64_t value)
+{
+	unsigned len = 0;
+
+	uint64_t u = (uint64_t)value;
+	if (value < 0)
+	{
+		buff[len++] = '-';
+		u = -u;
+	}
+
+	char digits[20];
+	unsigned count = 0;
+	do
+	{
+		digits[count++] = '0' + (u % 10);
+		u /= 10;
+	} while (u > 0);
+
+	while (count > 0)
+		buff[len++] = digits[--count];
+	return len;
+}
+
+
+/* Enough 32-bit words to hold every intermediate value when printing
+   the smallest or largest REAL, including binary128 subnormals. */
+#define OFC_NUMFMT__BIG_WORDS 544
+
+typedef struct
+{
+	unsigned size;
+	uint32_t word[OFC_NUMFMT__BIG_WORDS];
+} ofc_numfmt__big_t;
+
+static void ofc_numfmt__big_set(
+	ofc_numfmt__big_t* big, unsigned __int128 value)
+{
+	big->size = 0;
+	for (; value > 0; value >>= 32)
+		big->word[big->size++] = (uint32_t)value;
+}
+
+static void ofc_numfmt__big_shl(
+	ofc_numfmt__big_t* big, unsigned shift)
+{
+	if (big->size == 0)
+		return;
+
+	unsigned words = (shift / 32);
+	unsigned bits  = (shift % 32);
+
+	unsigned i;
+	if (bits > 0)
+	{
+		big->word[big->size + words] = 0;
+		for (i = big->size; i-- > 0;)
+		{
+			big->word[i + words + 1] |= (big->word[i] >> (32 - bits));
+			big->word[i + words] = (big->word[i] << bits);
+		}
+		big->size += words + 1;
+		if (big->word[big->size - 1] == 0)
+			big->size--;
+	}
+	else
+	{
+		for (i = big->size; i-- > 0;)
+			big->word[i + words] = big->word[i];
+		big->size += words;
+	}
+
+	for (i = 0; i < words; i++)
+		big->word[i] = 0;
+}
+
+static void ofc_numfmt__big_mul(
+	ofc_numfmt__big_t* big, uint32_t factor)
+{
+	uint64_t carry = 0;
+	unsigned i;
+	for (i = 0; i < big->size; i++)
+	{
+		carry += ((uint64_t)big->word[i] * factor);
+		big->word[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	if (carry > 0)
+		big->word[big->size++] = (uint32_t)carry;
+}
+
+static void ofc_numfmt__big_mul_pow10(
+	ofc_numfmt__big_t* big, unsigned exp)
+{
+	static const uint32_t pow10[] =
+	{
+		1, 10, 100, 1000, 10000, 100000,
+		1000000, 10000000, 100000000, 1000000000,
+	};
+
+	for (; exp >= 9; exp -= 9)
+		ofc_numfmt__big_mul(big, pow10[9]);
+	if (exp > 0)
+		ofc_numfmt__big_mul(big, pow10[exp]);
+}
+
+static int ofc_numfmt__big_cmp(
+	const ofc_numfmt__big_t* a,
+	const ofc_numfmt__big_t* b)
+{
+	if (a->size != b->size)
+		return (a->size < b->size ? -1 : 1);
+
+	unsigned i;
+	for (i = a->size; i-- > 0;)
+	{
+		if (a->word[i] != b->word[i])
+			return (a->word[i] < b->word[i] ? -1 : 1);
+	}
+	return 0;
+}
+
+static void ofc_numfmt__big_add(
+	ofc_numfmt__big_t* sum,
+	const ofc_numfmt__big_t* a,
+	const ofc_numfmt__big_t* b)
+{
+	if (a->size < b->size)
+	{
+		const ofc_numfmt__big_t* swap = a;
+		a = b;
+		b = swap;
+	}
+
+	uint64_t carry = 0;
+	unsigned i;
+	for (i = 0; i < a->size; i++)
+	{
+		carry += a->word[i];
+		if (i < b->size)
+			carry += b->word[i];
+		sum->word[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	sum->size = a->size;
+	if (carry > 0)
+		sum->word[sum->size++] = (uint32_t)carry;
+}
+
+/* a must be at least b. */
+static void ofc_numfmt__big_sub(
+	ofc_numfmt__big_t* a,
+	const ofc_numfmt__big_t* b)
+{
+	int64_t borrow = 0;
+	unsigned i;
+	for (i = 0; i < a->size; i++)
+	{
+		borrow += a->word[i];
+		if (i < b->size)
+			borrow -= b->word[i];
+		a->word[i] = (uint32_t)borrow;
+		borrow = (borrow < 0 ? -1 : 0);
+	}
+
+	while ((a->size > 0)
+		&& (a->word[a->size - 1] == 0))
+		a->size--;
+}
+
+
+/* The binary formats a REAL constant can be printed in. */
+typedef enum
+{
+	OFC_NUMFMT__FLOAT,
+	OFC_NUMFMT__DOUBLE,
+	OFC_NUMFMT__LONG_DOUBLE,
+	OFC_NUMFMT__WIDE,
+} ofc_numfmt__format_e;
+
+static ofc_numfmt__format_e ofc_numfmt__format(unsigned size)
+{
+	if (size == 0)
+		return OFC_NUMFMT__WIDE;
+	if (size <= 4)
+		return OFC_NUMFMT__FLOAT;
+	if (size <= 8)
+		return OFC_NUMFMT__DOUBLE;
+	if (size < sizeof(ofc_real_t))
+		return OFC_NUMFMT__LONG_DOUBLE;
+	return OFC_NUMFMT__WIDE;
+}
+
+/* Splits a finite positive value of the format so that value is m * 2^e. */
+static void ofc_numfmt__decompose(
+	ofc_real_t value, ofc_numfmt__format_e format,
+	unsigned __int128* m, int* e, bool* lower_close)
+{
+#ifdef OFC_REAL_BINARY128
+	if (format == OFC_NUMFMT__WIDE)
+	{
+		/* Split the encoding, since frexp may not handle binary128. */
+		unsigned __int128 bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		unsigned __int128 hidden
+			= ((unsigned __int128)1 << (OFC_REAL_MANT_DIG - 1));
+		int x = (int)((bits >> (OFC_REAL_MANT_DIG - 1)) & 0x7FFF);
+
+		*m = (bits & (hidden - 1));
+		*lower_close = ((*m == 0) && (x > 1));
+		if (x > 0)
+			*m |= hidden;
+		else
+			x = 1;
+		*e = (x - 16383 - (OFC_REAL_MANT_DIG - 1));
+		return;
+	}
+#endif
+
+	int mant_dig, min_exp;
+	switch (format)
+	{
+		case OFC_NUMFMT__FLOAT:
+			mant_dig = FLT_MANT_DIG;
+			min_exp  = FLT_MIN_EXP;
+			break;
+		case OFC_NUMFMT__DOUBLE:
+			mant_dig = DBL_MANT_DIG;
+			min_exp  = DBL_MIN_EXP;
+			break;
+		default:
+			mant_dig = LDBL_MANT_DIG;
+			min_exp  = LDBL_MIN_EXP;
+			break;
+	}
+
+	long double lvalue = (long double)value;
+
+	int x;
+	frexpl(lvalue, &x);
+
+	/* The gap below a power of two is half the gap above it,
+	   except in the lowest binade where subnormals continue it. */
+	*lower_close = (x > min_exp);
+	if (x < min_exp)
+		x = min_exp;
+
+	*e = (x - mant_dig);
+	*m = (uint64_t)ldexpl(lvalue, -*e);
+	*lower_close = (*lower_close
+		&& (*m == ((unsigned __int128)1 << (mant_dig - 1))));
+}
+
+/* Both versions of Burger and Dybvig's free-format algorithm below
+   write the fewest digits which lie closer to m * 2^e than to any
+   neighbouring value, so that value is 0.DIGITS * 10^k. They start
+   from an estimate of k which can only be one too small. */
+
+static unsigned ofc_numfmt__shortest_small(
+	unsigned __int128 m, int e, unsigned shift, bool even,
+	int est, char* digits, int* k)
+{
+	unsigned __int128 r = (m << shift);
+	unsigned __int128 s = (1U << shift);
+	unsigned __int128 mp = (1U << (shift - 1));
+	unsigned __int128 mm = 1;
+
+	if (e >= 0)
+	{
+		r  <<= e;
+		mp <<= e;
+		mm <<= e;
+	}
+	else
+	{
+		s <<= -e;
+	}
+
+	unsigned __int128 pow10 = 1;
+	int i;
+	for (i = (est < 0 ? -est : est); i > 0; i--)
+		pow10 *= 10;
+
+	if (est >= 0)
+	{
+		s *= pow10;
+	}
+	else
+	{
+		r  *= pow10;
+		mp *= pow10;
+		mm *= pow10;
+	}
+
+	if (even ? ((r + mp) >= s) : ((r + mp) > s))
+	{
+		s *= 10;
+		est++;
+	}
+	*k = est;
+
+	unsigned count = 0;
+	while (true)
+	{
+		r  *= 10;
+		mp *= 10;
+		mm *= 10;
+
+		/* A 128-bit division is a library call, so avoid it. */
+		unsigned d;
+		if (((r >> 64) == 0) && ((s >> 64) == 0))
+		{
+			uint64_t r64 = (uint64_t)r;
+			uint64_t s64 = (uint64_t)s;
+			d = (unsigned)(r64 / s64);
+			r = (r64 % s64);
+		}
+		else
+		{
+			d = (unsigned)(r / s);
+			r %= s;
+		}
+
+		bool tc_low  = (even ? (r <= mm) : (r < mm));
+		bool tc_high = (even ? ((r + mp) >= s) : ((r + mp) > s));
+
+		if (tc_low && tc_high)
+		{
+			if ((r << 1) >= s)
+				d++;
+		}
+		else if (tc_high)
+		{
+			d++;
+		}
+
+		digits[count++] = '0' + d;
+		if (tc_low || tc_high)
+			break;
+	}
+
+	return count;
+}
+
+static unsigned ofc_numfmt__shortest_big(
+	unsigned __int128 m, int e, unsigned shift, bool even,
+	int est, char* digits, int* k)
+{
+	ofc_numfmt__big_t r, s, mp, mm, t;
+
+	ofc_numfmt__big_set(&r, m);
+	ofc_numfmt__big_set(&s, 1);
+	ofc_numfmt__big_set(&mp, 1);
+	ofc_numfmt__big_set(&mm, 1);
+
+	ofc_numfmt__big_shl(&r, shift);
+	ofc_numfmt__big_shl(&s, shift);
+	ofc_numfmt__big_shl(&mp, (shift - 1));
+	if (e >= 0)
+	{
+		ofc_numfmt__big_shl(&r, e);
+		ofc_numfmt__big_shl(&mp, e);
+		ofc_numfmt__big_shl(&mm, e);
+	}
+	else
+	{
+		ofc_numfmt__big_shl(&s, -e);
+	}
+
+	if (est >= 0)
+	{
+		ofc_numfmt__big_mul_pow10(&s, est);
+	}
+	else
+	{
+		ofc_numfmt__big_mul_pow10(&r, -est);
+		ofc_numfmt__big_mul_pow10(&mp, -est);
+		ofc_numfmt__big_mul_pow10(&mm, -est);
+	}
+
+	ofc_numfmt__big_add(&t, &r, &mp);
+	int high = ofc_numfmt__big_cmp(&t, &s);
+	if (even ? (high >= 0) : (high > 0))
+	{
+		ofc_numfmt__big_mul(&s, 10);
+		est++;
+	}
+	*k = est;
+
+	unsigned count = 0;
+	while (true)
+	{
+		ofc_numfmt__big_mul(&r, 10);
+		ofc_numfmt__big_mul(&mp, 10);
+		ofc_numfmt__big_mul(&mm, 10);
+
+		unsigned d = 0;
+		while (ofc_numfmt__big_cmp(&r, &s) >= 0)
+		{
+			ofc_numfmt__big_sub(&r, &s);
+			d++;
+		}
+
+		int low = ofc_numfmt__big_cmp(&r, &mm);
+		bool tc_low = (even ? (low <= 0) : (low < 0));
+
+		ofc_numfmt__big_add(&t, &r, &mp);
+		high = ofc_numfmt__big_cmp(&t, &s);
+		bool tc_high = (even ? (high >= 0) : (high > 0));
+
+		if (tc_low && tc_high)
+		{
+			ofc_numfmt__big_shl(&r, 1);
+			if (ofc_numfmt__big_cmp(&r, &s) >= 0)
+				d++;
+		}
+		else if (tc_high)
+		{
+			d++;
+		}
+
+		digits[count++] = '0' + d;
+		if (tc_low || tc_high)
+			break;
+	}
+
+	return count;
+}
+
+/* Ties are read as round half even. */
+static unsigned ofc_numfmt__shortest(
+	unsigned __int128 m, int e, bool lower_close,
+	char* digits, int* k)
+{
+	unsigned shift = (lower_close ? 2 : 1);
+	bool even = ((m & 1) == 0);
+
+	uint64_t high = (uint64_t)(m >> 64);
+	int m_bits = (high != 0
+		? (128 - __builtin_clzll(high))
+		: (64 - __builtin_clzll((uint64_t)m)));
+
+	int log2v = e + m_bits - 1;
+	int est = (int)ceil((log2v * 0.30102999566398114) - 1e-10);
+
+	/* Most constants are near one, so they can be scaled without
+	   any value going over 2^122, leaving room to multiply by ten. */
+	int r_bits = m_bits + shift + (e > 0 ? e : 0)
+		+ (est < 0 ? (((-est * 10) / 3) + 1) : 0);
+	int s_bits = 1 + shift + (e < 0 ? -e : 0)
+		+ (est > 0 ? (((est * 10) / 3) + 1) : 0);
+	if ((r_bits <= 122) && (s_bits <= 122))
+	{
+		return ofc_numfmt__shortest_small(
+			m, e, shift, even, est, digits, k);
+	}
+
+	return ofc_numfmt__shortest_big(
+		m, e, shift, even, est, digits, k);
+}
+
+
+unsigned ofc_numfmt_real(
+	char* buff, ofc_real_t value,
+	unsigned size, unsigned precision, char exp)
+{
+	ofc_numfmt__format_e format
+		= ofc_numfmt__format(size);
+
+	/* A value too large for its kind is printed as written. */
+	ofc_real_t rounded;
+	switch (format)
+	{
+		case OFC_NUMFMT__FLOAT:
+			rounded = (float)value;
+			break;
+		case OFC_NUMFMT__DOUBLE:
+			rounded = (double)value;
+			break;
+		case OFC_NUMFMT__LONG_DOUBLE:
+			rounded = (long double)value;
+			break;
+		default:
+			rounded = value;
+			break;
+	}
+	if (isinf(rounded) && !isinf(value))
+		format = OFC_NUMFMT__WIDE;
+	else
+		value = rounded;
+
+	unsigned len = 0;
+	if (signbit(value))
+	{
+		buff[len++] = '-';
+		value = -value;
+	}
+
+	if (precision == 0)
+		precision = 1;
+
+	bool scientific = false;
+	if (isnan(value) || isinf(value))
+	{
+		memcpy(&buff[len], (isnan(value) ? "NAN" : "INF"), 3);
+		len += 3;
+	}
+	else if (value == 0.0)
+	{
+		buff[len++] = '0';
+	}
+	else
+	{
+		unsigned __int128 m;
+		int e;
+		bool lower_close;
+
+		ofc_numfmt__decompose(
+			value, format, &m, &e, &lower_close);
+
+		char digits[40];
+		int k;
+		unsigned count = ofc_numfmt__shortest(
+			m, e, lower_close, digits, &k);
+
+		int x = (k - 1);
+		scientific = ((x < -4) || (x >= (int)precision));
+		if (scientific)
+		{
+			buff[len++] = digits[0];
+			if (count > 1)
+			{
+				buff[len++] = '.';
+				memcpy(&buff[len], &digits[1], (count - 1));
+				len += (count - 1);
+			}
+
+			buff[len++] = exp;
+			buff[len++] = (x < 0 ? '-' : '+');
+			if (x < 0) x = -x;
+			if (x < 10)
+				buff[len++] = '0';
+			len += ofc_numfmt_integer(&buff[len], x);
+		}
+		else if (x < 0)
+		{
+			buff[len++] = '0';
+			buff[len++] = '.';
+			for (; x < -1; x++)
+				buff[len++] = '0';
+			memcpy(&buff[len], digits, count);
+			len += count;
+		}
+		else
+		{
+			unsigned whole = (x + 1);
+			unsigned i;
+			for (i = 0; i < whole; i++)
+				buff[len++] = (i < count ? digits[i] : '0');
+			if (count > whole)
+			{
+				buff[len++] = '.';
+				memcpy(&buff[len], &digits[whole], (count - whole));
+				len += (count - whole);
+			}
+		}
+	}
+
+	if (!scientific)
+	{
+		if (!memchr(buff, '.', len))
+		{
+			buff[len++] = '.';
+			buff[len++] = '0';
+		}
+
+		if (exp != 'E')
+		{
+			buff[len++] = exp;
+			buff[len++] = '0';
+		}
+	}
+
+	return len;
+}
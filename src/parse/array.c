@@ -73,7 +73,7 @@ static ofc_parse_array_range_t* ofc_parse_array__range(
 	}
 
 	ofc_parse_array_range_t* range
-		= (ofc_parse_array_range_t*)malloc(
+		= (ofc_parse_array_range_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_array_range_t));
 	if (!range)
 	{
@@ -104,7 +104,7 @@ static void ofc_parse_array__range_delete(
 	ofc_parse_expr_delete(range->first);
 	ofc_parse_expr_delete(range->last);
 	ofc_parse_expr_delete(range->stride);
-	free(range);
+	ofc_free(range);
 }
 
 static ofc_parse_array_range_t* ofc_parse_array__range_copy(
@@ -114,7 +114,7 @@ static ofc_parse_array_range_t* ofc_parse_array__range_copy(
 		return NULL;
 
 	ofc_parse_array_range_t* copy
-		= (ofc_parse_array_range_t*)malloc(
+		= (ofc_parse_array_range_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_array_range_t));
 	if (!copy) return NULL;
 
@@ -194,7 +194,7 @@ ofc_parse_array_index_t* ofc_parse_array_index(
 		return NULL;
 
 	ofc_parse_array_index_t* index
-		= (ofc_parse_array_index_t*)malloc(
+		= (ofc_parse_array_index_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_array_index_t));
 	if (!index) return NULL;
 
@@ -210,7 +210,7 @@ ofc_parse_array_index_t* ofc_parse_array_index(
 		(void*)ofc_parse_array__range_delete);
 	if (l == 0)
 	{
-		free(index);
+		ofc_free(index);
 		return NULL;
 	}
 	i += l;
@@ -236,7 +236,7 @@ ofc_parse_array_index_t* ofc_parse_array_index_copy(
 		return NULL;
 
 	ofc_parse_array_index_t* copy
-		= (ofc_parse_array_index_t*)malloc(
+		= (ofc_parse_array_index_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_array_index_t));
 	if (!copy) return NULL;
 
@@ -249,7 +249,7 @@ ofc_parse_array_index_t* ofc_parse_array_index_copy(
 		(void*)ofc_parse_array__range_copy,
 		(void*)ofc_parse_array__range_delete))
 	{
-		free(copy);
+		ofc_free(copy);
 		return NULL;
 	}
 
@@ -266,7 +266,7 @@ void ofc_parse_array_index_delete(
 	ofc_parse_list_delete(
 		index->count, (void**)index->range,
 		(void*)ofc_parse_array__range_delete);
-	free(index);
+	ofc_free(index);
 }
 
 bool ofc_parse_array_index_print(
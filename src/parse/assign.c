@@ -46,7 +46,7 @@ ofc_parse_assign_t* ofc_parse_assign(
 	}
 
 	ofc_parse_assign_t* assign
-		= (ofc_parse_assign_t*)malloc(
+		= (ofc_parse_assign_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_assign_t));
 	if (!assign)
 	{
@@ -95,7 +95,7 @@ ofc_parse_assign_t* ofc_parse_assign_copy(
 		return NULL;
 
 	ofc_parse_assign_t* copy
-		= (ofc_parse_assign_t*)malloc(
+		= (ofc_parse_assign_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_assign_t));
 	if (!copy) return NULL;
 
@@ -120,7 +120,7 @@ void ofc_parse_assign_delete(
 
 	ofc_parse_expr_delete(assign->init);
 	ofc_parse_lhs_delete(assign->name);
-	free(assign);
+	ofc_free(assign);
 }
 
 bool ofc_parse_assign_print(
@@ -151,7 +151,7 @@ ofc_parse_assign_list_t* ofc_parse_assign_list(
 	unsigned* len)
 {
 	ofc_parse_assign_list_t* list
-		= (ofc_parse_assign_list_t*)malloc(
+		= (ofc_parse_assign_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_assign_list_t));
 	if (!list) return NULL;
 
@@ -176,7 +176,7 @@ ofc_parse_assign_list_t* ofc_parse_assign_list_copy(
 		return NULL;
 
 	ofc_parse_assign_list_t* copy
-		= (ofc_parse_assign_list_t*)malloc(
+		= (ofc_parse_assign_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_assign_list_t));
 	if (!copy) return NULL;
 
@@ -189,7 +189,7 @@ ofc_parse_assign_list_t* ofc_parse_assign_list_copy(
 		(void*)ofc_parse_assign_copy,
 		(void*)ofc_parse_assign_delete))
 	{
-		free(copy);
+		ofc_free(copy);
 		return NULL;
 	}
 
@@ -206,7 +206,7 @@ void ofc_parse_assign_list_delete(
 		list->count, (void**)list->assign,
 		(void*)ofc_parse_assign_delete);
 
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_assign_list_print(
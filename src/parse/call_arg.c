@@ -22,7 +22,7 @@ static ofc_parse_call_arg_t* ofc_parse__call_arg(
 	bool named, bool force, unsigned* len)
 {
 	ofc_parse_call_arg_t* call_arg
-		= (ofc_parse_call_arg_t*)malloc(
+		= (ofc_parse_call_arg_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_call_arg_t));
 	if (!call_arg) return NULL;
 
@@ -42,7 +42,7 @@ static ofc_parse_call_arg_t* ofc_parse__call_arg(
 		}
 		else if (force)
 		{
-			free(call_arg);
+			ofc_free(call_arg);
 			ofc_parse_debug_rewind(debug, dpos);
 			return NULL;
 		}
@@ -68,7 +68,7 @@ static ofc_parse_call_arg_t* ofc_parse__call_arg(
 			src, &ptr[i], debug, &l);
 		if (!call_arg->expr)
 		{
-			free(call_arg);
+			ofc_free(call_arg);
 			ofc_parse_debug_rewind(debug, dpos);
 			return NULL;
 		}
@@ -119,7 +119,7 @@ void ofc_parse_call_arg_delete(
 		return;
 
 	ofc_parse_expr_delete(call_arg->expr);
-	free(call_arg);
+	ofc_free(call_arg);
 }
 
 bool ofc_parse_call_arg_print(
@@ -169,7 +169,7 @@ static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list(
 	bool named, bool force, unsigned* len)
 {
 	ofc_parse_call_arg_list_t* list
-		= (ofc_parse_call_arg_list_t*)malloc(
+		= (ofc_parse_call_arg_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_call_arg_list_t));
 	if (!list) return NULL;
 
@@ -184,7 +184,7 @@ static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list(
 		(void*)ofc_parse_call_arg_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -226,15 +226,15 @@ ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_wrap(
 		return NULL;
 
 	ofc_parse_call_arg_list_t* list
-		= (ofc_parse_call_arg_list_t*)malloc(
+		= (ofc_parse_call_arg_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_call_arg_list_t));
 	if (!list) return NULL;
 
-	list->call_arg = (ofc_parse_call_arg_t**)malloc(
+	list->call_arg = (ofc_parse_call_arg_t**)ofc_alloc(OFC_ALLOC_PARSE,
 		sizeof(ofc_parse_call_arg_t*));
 	if (!list->call_arg)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -253,7 +253,7 @@ void ofc_parse_call_arg_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->call_arg,
 		(void*)ofc_parse_call_arg_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_call_arg_list_print(
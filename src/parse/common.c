@@ -42,7 +42,7 @@ ofc_parse_common_group_t* ofc_parse_common_group(
 	}
 
 	ofc_parse_common_group_t* common
-		= (ofc_parse_common_group_t*)malloc(
+		= (ofc_parse_common_group_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_common_group_t));
 	if (!common)
 	{
@@ -56,7 +56,7 @@ ofc_parse_common_group_t* ofc_parse_common_group(
 			src, &ptr[i], debug, &l);
 	if (!common->names)
 	{
-		free(common);
+		ofc_free(common);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -75,7 +75,7 @@ void ofc_parse_common_group_delete(
 		return;
 
 	ofc_parse_lhs_list_delete(group->names);
-	free(group);
+	ofc_free(group);
 }
 
 bool ofc_parse_common_group_print(
@@ -105,7 +105,7 @@ ofc_parse_common_group_list_t* ofc_parse_common_group_list(
 	unsigned* len)
 {
 	ofc_parse_common_group_list_t* list
-		= (ofc_parse_common_group_list_t*)malloc(
+		= (ofc_parse_common_group_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_common_group_list_t));
 	if (!list) return NULL;
 
@@ -119,7 +119,7 @@ ofc_parse_common_group_list_t* ofc_parse_common_group_list(
 		(void*)ofc_parse_common_group_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -136,7 +136,7 @@ void ofc_parse_common_group_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->group,
 		(void*)ofc_parse_common_group_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_common_group_list_print(
@@ -24,7 +24,7 @@ static void ofc_parse_data_entry_delete(
 
 	ofc_parse_lhs_list_delete(entry->nlist);
 	ofc_parse_expr_list_delete(entry->clist);
-	free(entry);
+	ofc_free(entry);
 }
 
 static ofc_parse_data_entry_t* ofc_parse_data_entry(
@@ -33,7 +33,7 @@ static ofc_parse_data_entry_t* ofc_parse_data_entry(
 	unsigned* len)
 {
 	ofc_parse_data_entry_t* entry
-		= (ofc_parse_data_entry_t*)malloc(
+		= (ofc_parse_data_entry_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_data_entry_t));
 	if (!entry) return NULL;
 
@@ -44,7 +44,7 @@ static ofc_parse_data_entry_t* ofc_parse_data_entry(
 		src, ptr, debug, &i);
 	if (!entry->nlist)
 	{
-		free(entry);
+		ofc_free(entry);
 		return NULL;
 	}
 
@@ -54,7 +54,7 @@ static ofc_parse_data_entry_t* ofc_parse_data_entry(
 	if (!entry->clist)
 	{
 		ofc_parse_lhs_list_delete(entry->nlist);
-		free(entry);
+		ofc_free(entry);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -83,7 +83,7 @@ ofc_parse_data_list_t* ofc_parse_data_list(
 	unsigned* len)
 {
 	ofc_parse_data_list_t* list
-		= (ofc_parse_data_list_t*)malloc(
+		= (ofc_parse_data_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_data_list_t));
 	if (!list) return NULL;
 
@@ -98,7 +98,7 @@ ofc_parse_data_list_t* ofc_parse_data_list(
 	if (i == 0)
 	{
 		/* data_list may not be empty. */
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -115,7 +115,7 @@ void ofc_parse_data_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->entry,
 		(void*)ofc_parse_data_entry_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_data_list_print(
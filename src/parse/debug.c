@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "ofc/alloc.h"
 #include "ofc/parse/debug.h"
 
 typedef struct
@@ -35,7 +36,7 @@ struct ofc_parse_debug_s
 ofc_parse_debug_t* ofc_parse_debug_create(void)
 {
 	ofc_parse_debug_t* stack
-		= (ofc_parse_debug_t*)malloc(
+		= (ofc_parse_debug_t*)ofc_alloc(OFC_ALLOC_PARSE_DEBUG,
 			sizeof(ofc_parse_debug_t));
 	if (!stack) return NULL;
 
@@ -56,11 +57,11 @@ void ofc_parse_debug_delete(ofc_parse_debug_t* stack)
 	{
 		if (!stack->message[i])
 			continue;
-		free(stack->message[i]->message);
-		free(stack->message[i]);
+		ofc_free(stack->message[i]->message);
+		ofc_free(stack->message[i]);
 	}
-	free(stack->message);
-	free(stack);
+	ofc_free(stack->message);
+	ofc_free(stack);
 }
 
 
@@ -81,8 +82,8 @@ void ofc_parse_debug_rewind(
 		if (!stack->message[i])
 			continue;
 
-		free(stack->message[i]->message);
-		free(stack->message[i]);
+		ofc_free(stack->message[i]->message);
+		ofc_free(stack->message[i]);
 		stack->message[i] = NULL;
 	}
 
@@ -120,7 +121,7 @@ static void ofc_parse_debug_message(
 		abort();
 
 	ofc_parse_debug_msg_t* message
-		= (ofc_parse_debug_msg_t*)malloc(
+		= (ofc_parse_debug_msg_t*)ofc_alloc(OFC_ALLOC_PARSE_DEBUG,
 			sizeof(ofc_parse_debug_msg_t));
 	if (!message) abort();
 
@@ -133,7 +134,7 @@ static void ofc_parse_debug_message(
 
 	if (len <= 0) abort();
 
-	message->message = (char*)malloc(len + 1);
+	message->message = (char*)ofc_alloc(OFC_ALLOC_PARSE_DEBUG, len + 1);
 	if (!message->message) abort();
 	vsprintf(message->message, format, args);
 
@@ -142,7 +143,7 @@ static void ofc_parse_debug_message(
 		unsigned nmax = (stack->max << 1);
 		if (nmax == 0) nmax = 16;
 		ofc_parse_debug_msg_t** nstack
-			= (ofc_parse_debug_msg_t**)realloc(stack->message,
+			= (ofc_parse_debug_msg_t**)ofc_realloc(OFC_ALLOC_PARSE_DEBUG, stack->message,
 				sizeof(ofc_parse_debug_msg_t*) * nmax);
 		if (!nstack) abort();
 		stack->message = nstack;
@@ -23,7 +23,7 @@ static ofc_parse_decl_t* ofc_parse__decl(
 	unsigned* len)
 {
 	ofc_parse_decl_t* decl
-		= (ofc_parse_decl_t*)malloc(
+		= (ofc_parse_decl_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_decl_t));
 	if (!decl) return NULL;
 
@@ -34,7 +34,7 @@ static ofc_parse_decl_t* ofc_parse__decl(
 		src, ptr, debug, &i);
 	if (!decl->lhs)
 	{
-		free(decl);
+		ofc_free(decl);
 		return NULL;
 	}
 
@@ -84,7 +84,7 @@ ofc_parse_decl_t* ofc_parse_decl_record(
 	unsigned* len)
 {
 	ofc_parse_decl_t* decl
-		= (ofc_parse_decl_t*)malloc(
+		= (ofc_parse_decl_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_decl_t));
 	if (!decl) return NULL;
 
@@ -101,7 +101,7 @@ ofc_parse_decl_t* ofc_parse_decl_record(
 		if ((l == 0)
 			|| (ptr[i++] != '/'))
 		{
-			free(decl);
+			ofc_free(decl);
 			return NULL;
 		}
 	}
@@ -110,7 +110,7 @@ ofc_parse_decl_t* ofc_parse_decl_record(
 		src, &ptr[i], debug, &l);
 	if (!decl->lhs)
 	{
-		free(decl);
+		ofc_free(decl);
 		return NULL;
 	}
 	i += l;
@@ -133,7 +133,7 @@ void ofc_parse_decl_delete(
 	ofc_parse_expr_list_delete(decl->init_clist);
 
 	ofc_parse_lhs_delete(decl->lhs);
-	free(decl);
+	ofc_free(decl);
 }
 
 bool ofc_parse_decl_print(
@@ -180,7 +180,7 @@ ofc_parse_decl_list_t* ofc_parse_decl_list(
 	unsigned* len)
 {
 	ofc_parse_decl_list_t* list
-		= (ofc_parse_decl_list_t*)malloc(
+		= (ofc_parse_decl_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_decl_list_t));
 	if (!list) return NULL;
 
@@ -194,7 +194,7 @@ ofc_parse_decl_list_t* ofc_parse_decl_list(
 		(void*)ofc_parse_decl_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -208,7 +208,7 @@ ofc_parse_decl_list_t* ofc_parse_decl_list_record(
 	unsigned* len)
 {
 	ofc_parse_decl_list_t* list
-		= (ofc_parse_decl_list_t*)malloc(
+		= (ofc_parse_decl_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_decl_list_t));
 	if (!list) return NULL;
 
@@ -222,7 +222,7 @@ ofc_parse_decl_list_t* ofc_parse_decl_list_record(
 		(void*)ofc_parse_decl_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -246,7 +246,7 @@ void ofc_parse_decl_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->decl,
 		(void*)ofc_parse_decl_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_decl_list_print(
@@ -21,7 +21,7 @@ ofc_parse_define_file_arg_t* ofc_parse_define_file_arg(
 	ofc_parse_debug_t* debug, unsigned* len)
 {
 	ofc_parse_define_file_arg_t* define_file_arg
-		= (ofc_parse_define_file_arg_t*)malloc(
+		= (ofc_parse_define_file_arg_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_define_file_arg_t));
 	if (!define_file_arg) return NULL;
 
@@ -38,7 +38,7 @@ ofc_parse_define_file_arg_t* ofc_parse_define_file_arg(
 		src, &ptr[i], debug, &l);
 	if (!define_file_arg->unit)
 	{
-		free(define_file_arg);
+		ofc_free(define_file_arg);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -118,7 +118,7 @@ void ofc_parse_define_file_arg_delete(
 	ofc_parse_expr_delete(define_file_arg->rec);
 	ofc_parse_expr_delete(define_file_arg->len);
 	ofc_parse_lhs_delete(define_file_arg->ascv);
-	free(define_file_arg);
+	ofc_free(define_file_arg);
 }
 
 bool ofc_parse_define_file_arg_print(
@@ -143,7 +143,7 @@ ofc_parse_define_file_arg_list_t* ofc_parse_define_file_arg_list(
 	ofc_parse_debug_t* debug, unsigned* len)
 {
 	ofc_parse_define_file_arg_list_t* list
-		= (ofc_parse_define_file_arg_list_t*)malloc(
+		= (ofc_parse_define_file_arg_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_define_file_arg_list_t));
 	if (!list) return NULL;
 
@@ -156,7 +156,7 @@ ofc_parse_define_file_arg_list_t* ofc_parse_define_file_arg_list(
 		(void*)ofc_parse_define_file_arg_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -173,7 +173,7 @@ void ofc_parse_define_file_arg_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->define_file_arg,
 		(void*)ofc_parse_define_file_arg_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_define_file_arg_list_print(
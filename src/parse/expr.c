@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <stdint.h>
 #include "ofc/parse.h"
 
 
@@ -56,6 +57,7 @@ static bool ofc_parse_expr__clone(
 
 	ofc_parse_expr_t clone;
 	clone.type = src->type;
+	clone.src  = src->src;
 
 	switch (clone.type)
 	{
@@ -116,7 +118,7 @@ static ofc_parse_expr_t* ofc_parse_expr__alloc(
 	ofc_parse_expr_t expr)
 {
 	ofc_parse_expr_t* aexpr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_expr_t));
 	if (!aexpr) return NULL;
 	*aexpr = expr;
@@ -158,19 +160,133 @@ static bool ofc_parse_expr__term(const char* ptr)
 }
 
 
+/* Operand results are memoized by position and precedence level for the
+   duration of a single expression parse, the speculative descent through
+   each precedence level would otherwise lex the same operand many times. */
+typedef struct
+{
+	const char*      ptr;
+	unsigned         level;
+	unsigned         len;
+	ofc_parse_expr_t expr;
+} ofc_parse_expr__memo_entry_t;
+
+typedef struct
+{
+	unsigned                      count, size;
+	ofc_parse_expr__memo_entry_t* entry;
+} ofc_parse_expr__memo_t;
+
+static void ofc_parse_expr__memo_cleanup(
+	ofc_parse_expr__memo_t* memo)
+{
+	unsigned i;
+	for (i = 0; i < memo->size; i++)
+	{
+		if (memo->entry[i].ptr
+			&& (memo->entry[i].len > 0))
+			ofc_parse_expr__cleanup(memo->entry[i].expr);
+	}
+	ofc_free(memo->entry);
+}
+
+static unsigned ofc_parse_expr__memo_hash(
+	const char* ptr, unsigned level, unsigned size)
+{
+	uintptr_t h = (uintptr_t)ptr;
+	h = (h * 31) + level;
+	h ^= (h >> 16);
+	return (h & (size - 1));
+}
+
+static ofc_parse_expr__memo_entry_t* ofc_parse_expr__memo_find(
+	const ofc_parse_expr__memo_t* memo,
+	const char* ptr, unsigned level)
+{
+	if (memo->size == 0)
+		return NULL;
+
+	unsigned i = ofc_parse_expr__memo_hash(
+		ptr, level, memo->size);
+	while (memo->entry[i].ptr)
+	{
+		if ((memo->entry[i].ptr == ptr)
+			&& (memo->entry[i].level == level))
+			return &memo->entry[i];
+		i = ((i + 1) & (memo->size - 1));
+	}
+
+	return NULL;
+}
+
+static void ofc_parse_expr__memo_insert(
+	ofc_parse_expr__memo_t* memo,
+	ofc_parse_expr__memo_entry_t entry)
+{
+	unsigned i = ofc_parse_expr__memo_hash(
+		entry.ptr, entry.level, memo->size);
+	while (memo->entry[i].ptr)
+		i = ((i + 1) & (memo->size - 1));
+	memo->entry[i] = entry;
+	memo->count++;
+}
+
+static bool ofc_parse_expr__memo_add(
+	ofc_parse_expr__memo_t* memo,
+	const char* ptr, unsigned level,
+	unsigned len, const ofc_parse_expr_t* expr)
+{
+	if (((memo->count + 1) * 2) > memo->size)
+	{
+		unsigned size = (memo->size == 0 ? 64 : (memo->size << 1));
+		ofc_parse_expr__memo_entry_t* entry
+			= (ofc_parse_expr__memo_entry_t*)ofc_calloc(OFC_ALLOC_PARSE,
+				size, sizeof(ofc_parse_expr__memo_entry_t));
+		if (!entry) return false;
+
+		ofc_parse_expr__memo_t grow = { 0, size, entry };
+
+		unsigned i;
+		for (i = 0; i < memo->size; i++)
+		{
+			if (memo->entry[i].ptr)
+				ofc_parse_expr__memo_insert(
+					&grow, memo->entry[i]);
+		}
+
+		ofc_free(memo->entry);
+		*memo = grow;
+	}
+
+	ofc_parse_expr__memo_entry_t e;
+	e.ptr   = ptr;
+	e.level = level;
+	e.len   = len;
+
+	if ((len > 0)
+		&& !ofc_parse_expr__clone(&e.expr, expr))
+		return false;
+
+	ofc_parse_expr__memo_insert(memo, e);
+	return true;
+}
+
+
 
 static unsigned ofc_parse_expr__at_or_below(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr, unsigned level);
 
 static unsigned ofc_parse__expr(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr)
 {
 	return ofc_parse_expr__at_or_below(
-		src, ptr, debug, expr, OPERATOR_PRECEDENCE_MAX);
+		src, ptr, debug, memo, expr, OPERATOR_PRECEDENCE_MAX);
 }
 
 static unsigned ofc_parse_expr__literal(
@@ -178,10 +294,22 @@ static unsigned ofc_parse_expr__literal(
 	ofc_parse_debug_t* debug,
 	ofc_parse_expr_t* expr)
 {
+	unsigned dpos = ofc_parse_debug_position(debug);
+
 	unsigned len = ofc_parse_literal(
 		src, ptr, debug, &expr->literal);
 	if (len == 0) return 0;
 
+	/* A signed number is negated after exponentiation,
+	   so -2 ** 2 must be parsed as a unary expression. */
+	if (((ptr[0] == '-') || (ptr[0] == '+'))
+		&& (ptr[len] == '*') && (ptr[len + 1] == '*'))
+	{
+		ofc_parse_literal_cleanup(expr->literal);
+		ofc_parse_debug_rewind(debug, dpos);
+		return 0;
+	}
+
 	expr->type = OFC_PARSE_EXPR_CONSTANT;
 	expr->src  = ofc_sparse_ref(src, ptr, len);
 	return len;
@@ -222,6 +350,7 @@ static unsigned ofc_parse_expr__integer_variable(
 static unsigned ofc_parse_expr__primary(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr)
 {
 	unsigned len = ofc_parse_expr__literal(
@@ -242,7 +371,7 @@ static unsigned ofc_parse_expr__primary(
 		unsigned dpos = ofc_parse_debug_position(debug);
 		ofc_parse_expr_t expr_brackets;
 		len = ofc_parse__expr(
-			src, &ptr[1], debug, &expr_brackets);
+			src, &ptr[1], debug, memo, &expr_brackets);
 		if (len > 0)
 		{
 			if  (ptr[1 + len] != ')')
@@ -275,6 +404,7 @@ static unsigned ofc_parse_expr__primary(
 static unsigned ofc_parse_expr__unary(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr, unsigned level)
 {
 	/* TODO - Defined unary operators. */
@@ -300,7 +430,7 @@ static unsigned ofc_parse_expr__unary(
 
 	ofc_parse_expr_t a;
 	unsigned a_len = ofc_parse_expr__at_or_below(
-		src, &ptr[op_len], debug, &a, op_level);
+		src, &ptr[op_len], debug, memo, &a, op_level);
 	if (a_len == 0)
 	{
 		ofc_parse_debug_rewind(debug, dpos);
@@ -374,6 +504,7 @@ static void ofc_parse_expr__cull_right_ambig_point(
 static unsigned ofc_parse_expr__binary_at_or_below_b(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t a,
 	ofc_parse_expr_t* expr, unsigned level)
 {
@@ -390,9 +521,14 @@ static unsigned ofc_parse_expr__binary_at_or_below_b(
 		|| (ofc_parse_expr__level(a) > op_level))
 		return 0;
 
+	/* Exponentiation is right associative. */
+	unsigned b_level = (op_level - 1);
+	if (op == OFC_PARSE_OPERATOR_POWER)
+		b_level = op_level;
+
 	ofc_parse_expr_t b;
 	unsigned b_len = ofc_parse_expr__at_or_below(
-		src, &ptr[op_len], debug, &b, (op_level - 1));
+		src, &ptr[op_len], debug, memo, &b, b_level);
 	if (b_len == 0) return 0;
 
 	/* Handle case where we have something like:
@@ -434,13 +570,13 @@ static unsigned ofc_parse_expr__binary_at_or_below_b(
 	if (!c.binary.b)
 	{
 		/* Don't cleanup a here, we didn't create it. */
-		free(c.binary.a);
+		ofc_free(c.binary.a);
 		ofc_parse_expr__cleanup(b);
 		return 0;
 	}
 
 	unsigned c_len = ofc_parse_expr__binary_at_or_below_b(
-		src, &ptr[op_len + b_len], debug, c, expr, op_level);
+		src, &ptr[op_len + b_len], debug, memo, c, expr, op_level);
 	if (c_len > 0) return (op_len + b_len + c_len);
 
 	*expr = c;
@@ -450,13 +586,14 @@ static unsigned ofc_parse_expr__binary_at_or_below_b(
 static unsigned ofc_parse_expr__binary_at_or_below(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr, unsigned level)
 {
 	unsigned dpos = ofc_parse_debug_position(debug);
 
 	ofc_parse_expr_t a;
 	unsigned a_len = ofc_parse_expr__at_or_below(
-		src, ptr, debug, &a, (level - 1));
+		src, ptr, debug, memo, &a, (level - 1));
 	if (a_len == 0) return 0;
 
 	/* Optimize by returning a if we see end of statement or close bracket. */
@@ -483,7 +620,7 @@ static unsigned ofc_parse_expr__binary_at_or_below(
 	}
 
 	unsigned b_len = ofc_parse_expr__binary_at_or_below_b(
-		src, &ptr[a_len], debug, a, expr, level);
+		src, &ptr[a_len], debug, memo, a, expr, level);
 	if (b_len == 0)
 	{
 		ofc_parse_expr__cleanup(a);
@@ -497,13 +634,14 @@ static unsigned ofc_parse_expr__binary_at_or_below(
 static unsigned ofc_parse_expr__binary(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr, unsigned level)
 {
 	unsigned i;
 	for (i = level; i > 0; i--)
 	{
 		unsigned len = ofc_parse_expr__binary_at_or_below(
-			src, ptr, debug, expr, i);
+			src, ptr, debug, memo, expr, i);
 		if (len > 0) return len;
 	}
 	return 0;
@@ -512,18 +650,40 @@ static unsigned ofc_parse_expr__binary(
 static unsigned ofc_parse_expr__at_or_below(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
+	ofc_parse_expr__memo_t* memo,
 	ofc_parse_expr_t* expr, unsigned level)
 {
+	ofc_parse_expr__memo_entry_t* entry
+		= ofc_parse_expr__memo_find(memo, ptr, level);
+	if (entry)
+	{
+		if ((entry->len == 0)
+			|| !ofc_parse_expr__clone(expr, &entry->expr))
+			return 0;
+		return entry->len;
+	}
+
+	unsigned dpos = ofc_parse_debug_position(debug);
+
 	unsigned len = ofc_parse_expr__binary(
-		src, ptr, debug, expr, level);
-	if (len > 0) return len;
+		src, ptr, debug, memo, expr, level);
+	if (len == 0)
+	{
+		len = ofc_parse_expr__unary(
+			src, ptr, debug, memo, expr, level);
+	}
+	if (len == 0)
+	{
+		len = ofc_parse_expr__primary(
+			src, ptr, debug, memo, expr);
+	}
 
-	len = ofc_parse_expr__unary(
-		src, ptr, debug, expr, level);
-	if (len > 0) return len;
+	/* Results which left debug messages can't be replayed,
+	   so we only remember those which didn't. */
+	if (ofc_parse_debug_position(debug) == dpos)
+		ofc_parse_expr__memo_add(memo, ptr, level, len, expr);
 
-	return ofc_parse_expr__primary(
-		src, ptr, debug, expr);
+	return len;
 }
 
 
@@ -585,9 +745,12 @@ ofc_parse_expr_t* ofc_parse_expr(
 {
 	unsigned dpos = ofc_parse_debug_position(debug);
 
+	ofc_parse_expr__memo_t memo = { 0, 0, NULL };
+
 	ofc_parse_expr_t e;
 	unsigned i = ofc_parse__expr(
-		src, ptr, debug, &e);
+		src, ptr, debug, &memo, &e);
+	ofc_parse_expr__memo_cleanup(&memo);
 	if (i == 0) return NULL;
 
 	ofc_parse_expr_t* expr
@@ -610,7 +773,7 @@ void ofc_parse_expr_delete(
 		return;
 
 	ofc_parse_expr__cleanup(*expr);
-	free(expr);
+	ofc_free(expr);
 }
 
 bool ofc_parse_expr_print(
@@ -681,7 +844,7 @@ ofc_parse_expr_list_t* ofc_parse_expr_list(
 	unsigned* len)
 {
 	ofc_parse_expr_list_t* list
-		= (ofc_parse_expr_list_t*)malloc(
+		= (ofc_parse_expr_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_expr_list_t));
 	if (!list) return NULL;
 
@@ -695,7 +858,7 @@ ofc_parse_expr_list_t* ofc_parse_expr_list(
 		(void*)ofc_parse_expr_delete);
 	if (l == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -738,7 +901,7 @@ void ofc_parse_expr_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->expr,
 		(void*)ofc_parse_expr_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_expr_list_print(
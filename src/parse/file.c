@@ -13,7 +13,14 @@
  * limitations under the License.
  */
 
+#include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
 #include "ofc/parse.h"
+#include "ofc/context.h"
+#include "ofc/print.h"
 
 
 bool ofc_parse_file_include(
@@ -40,22 +47,336 @@ bool ofc_parse_file_include(
 	return true;
 }
 
+
+
+/* Program units are found by a quick scan of the condensed source and parsed
+   concurrently. A unit is only used if its parse ends exactly where the next
+   one starts, otherwise everything from that unit onwards is parsed serially,
+   so a wrong guess costs time but never changes the result. */
+
+typedef struct
+{
+	const char* ptr;
+	const char* end;
+
+	ofc_parse_stmt_list_t* list;
+	ofc_parse_debug_t*     debug;
+	ofc_diag_t*            diag;
+	bool                   complete;
+} ofc_parse_file__unit_t;
+
+typedef struct
+{
+	ofc_context_t*          context;
+	const ofc_sparse_t*     src;
+	pthread_mutex_t         lock;
+	unsigned                next;
+	unsigned                count;
+	ofc_parse_file__unit_t* unit;
+} ofc_parse_file__pool_t;
+
+static unsigned ofc_parse_file__match(
+	const char* ptr, const char* end, const char* keyword)
+{
+	unsigned i = 0, k;
+	for (k = 0; keyword[k] != '\0'; k++)
+	{
+		while ((&ptr[i] < end) && ofc_is_hspace(ptr[i]))
+			i++;
+		if ((&ptr[i] >= end)
+			|| (toupper(ptr[i]) != keyword[k]))
+			return 0;
+		i++;
+	}
+	return i;
+}
+
+static bool ofc_parse_file__unit_end(
+	const char* ptr, const char* end)
+{
+	unsigned i = ofc_parse_file__match(ptr, end, "END");
+	if (i == 0) return false;
+
+	while ((&ptr[i] < end) && ofc_is_hspace(ptr[i]))
+		i++;
+	if (&ptr[i] >= end)
+		return true;
+
+	return ((ofc_parse_file__match(&ptr[i], end, "PROGRAM") > 0)
+		|| (ofc_parse_file__match(&ptr[i], end, "SUBROUTINE") > 0)
+		|| (ofc_parse_file__match(&ptr[i], end, "FUNCTION") > 0)
+		|| (ofc_parse_file__match(&ptr[i], end, "BLOCKDATA") > 0));
+}
+
+static ofc_parse_file__unit_t* ofc_parse_file__scan(
+	const char* ptr, unsigned* count)
+{
+	unsigned max = 0;
+	ofc_parse_file__unit_t* unit = NULL;
+
+	unsigned c = 0;
+	const char* start = ptr;
+	while (*ptr != '\0')
+	{
+		const char* eol = ptr;
+		while ((*eol != '\0') && !ofc_is_vspace(*eol))
+			eol++;
+
+		bool split = ofc_parse_file__unit_end(ptr, eol);
+
+		ptr = eol;
+		if (*ptr != '\0') ptr++;
+
+		if (split || (*ptr == '\0'))
+		{
+			if (c >= max)
+			{
+				max = (max == 0 ? 16 : (max << 1));
+				ofc_parse_file__unit_t* nunit
+					= (ofc_parse_file__unit_t*)ofc_realloc(OFC_ALLOC_PARSE, unit,
+						(sizeof(ofc_parse_file__unit_t) * max));
+				if (!nunit)
+				{
+					ofc_free(unit);
+					return NULL;
+				}
+				unit = nunit;
+			}
+
+			unit[c].ptr      = start;
+			unit[c].end      = ptr;
+			unit[c].list     = NULL;
+			unit[c].debug    = NULL;
+			unit[c].diag     = NULL;
+			unit[c].complete = false;
+			c++;
+
+			start = ptr;
+		}
+	}
+
+	*count = c;
+	return unit;
+}
+
+static void ofc_parse_file__unit_parse(
+	const ofc_sparse_t* src,
+	ofc_parse_file__unit_t* unit)
+{
+	unit->list  = ofc_parse_stmt_list_create();
+	unit->debug = ofc_parse_debug_create();
+	unit->diag  = ofc_diag_create();
+	if (!unit->list || !unit->debug || !unit->diag)
+		return;
+
+	/* Errors are held back until we know the unit is used. */
+	ofc_diag_redirect(unit->diag);
+
+	unsigned len;
+	bool success = ofc_parse_stmt_sublist_until(
+		unit->list, src, unit->ptr, unit->end,
+		unit->debug, &len);
+
+	ofc_diag_redirect(NULL);
+
+	unit->complete = (success
+		&& (&unit->ptr[len] == unit->end)
+		&& ((unit->list->count == 0)
+			|| (unit->list->stmt[unit->list->count - 1]->type
+				!= OFC_PARSE_STMT_ERROR)));
+}
+
+static void* ofc_parse_file__worker(
+	ofc_parse_file__pool_t* pool)
+{
+	ofc_context_t* previous
+		= ofc_context_enter(pool->context);
+
+	while (true)
+	{
+		pthread_mutex_lock(&pool->lock);
+		unsigned i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (i >= pool->count)
+			break;
+
+		ofc_parse_file__unit_parse(
+			pool->src, &pool->unit[i]);
+	}
+
+	ofc_context_leave(previous);
+	return NULL;
+}
+
+static void ofc_parse_file__pool(
+	const ofc_sparse_t* src,
+	unsigned count, ofc_parse_file__unit_t* unit,
+	unsigned jobs)
+{
+	ofc_parse_file__pool_t pool;
+	pool.context = ofc_context_current();
+	pool.src     = src;
+	pool.next    = 0;
+	pool.count   = count;
+	pool.unit    = unit;
+
+	if (pthread_mutex_init(&pool.lock, NULL) != 0)
+		return;
+
+	if (jobs > count)
+		jobs = count;
+
+	/* The parser recurses deeply on long expressions and nested blocks. */
+	pthread_attr_t attr;
+	bool attr_valid = (pthread_attr_init(&attr) == 0);
+	if (attr_valid)
+		pthread_attr_setstacksize(&attr, (16 << 20));
+
+	pthread_t thread[jobs];
+	unsigned t;
+	for (t = 0; (t + 1) < jobs; t++)
+	{
+		if (pthread_create(&thread[t],
+			(attr_valid ? &attr : NULL),
+			(void*)ofc_parse_file__worker, &pool) != 0)
+			break;
+	}
+
+	ofc_parse_file__worker(&pool);
+
+	while (t > 0)
+		pthread_join(thread[--t], NULL);
+
+	if (attr_valid)
+		pthread_attr_destroy(&attr);
+	pthread_mutex_destroy(&pool.lock);
+}
+
+static bool ofc_parse_file__splice(
+	ofc_parse_stmt_list_t* list,
+	ofc_parse_stmt_list_t* tail)
+{
+	if ((list->count + tail->count) > list->size)
+	{
+		unsigned nsize = (list->count + tail->count);
+		ofc_parse_stmt_t** nstmt
+			= (ofc_parse_stmt_t**)ofc_realloc(OFC_ALLOC_PARSE, list->stmt,
+				(nsize * sizeof(ofc_parse_stmt_t*)));
+		if (!nstmt) return false;
+		list->stmt = nstmt;
+		list->size = nsize;
+	}
+
+	unsigned i;
+	for (i = 0; i < tail->count; i++)
+		list->stmt[list->count++] = tail->stmt[i];
+	tail->count = 0;
+	return true;
+}
+
+/* Parses as many whole units as possible concurrently and
+   returns the length of source which has been consumed. */
+static unsigned ofc_parse_file__parallel(
+	const ofc_sparse_t* src,
+	ofc_parse_stmt_list_t* list,
+	unsigned* count, ofc_parse_file__unit_t** unit)
+{
+	*count = 0;
+	*unit  = NULL;
+
+	unsigned jobs = ofc_context_jobs(ofc_context_current());
+	if (jobs <= 1) return 0;
+
+	const char* ptr = ofc_sparse_strz(src);
+
+	unsigned c;
+	ofc_parse_file__unit_t* u
+		= ofc_parse_file__scan(ptr, &c);
+	if (!u) return 0;
+
+	*count = c;
+	*unit  = u;
+
+	if (c < 2) return 0;
+
+	ofc_parse_file__pool(src, c, u, jobs);
+
+	const char* end = ptr;
+	unsigned i;
+	for (i = 0; (i < c) && u[i].complete; i++)
+	{
+		if (!ofc_parse_file__splice(list, u[i].list))
+			break;
+		ofc_diag_merge(ofc_diag_default(), u[i].diag);
+		end = u[i].end;
+	}
+
+	/* Units after the first incomplete one are dropped. */
+	for (; i < c; i++)
+	{
+		u[i].complete = false;
+		ofc_parse_debug_delete(u[i].debug);
+		u[i].debug = NULL;
+	}
+
+	return (end - ptr);
+}
+
+static void ofc_parse_file__unit_delete(
+	unsigned count, ofc_parse_file__unit_t* unit)
+{
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		ofc_parse_stmt_list_delete(unit[i].list);
+		ofc_parse_debug_delete(unit[i].debug);
+		ofc_diag_delete(unit[i].diag);
+	}
+	ofc_free(unit);
+}
+
 ofc_parse_stmt_list_t* ofc_parse_file(const ofc_sparse_t* src)
 {
+	const char* ptr = ofc_sparse_strz(src);
+	if (!ptr) return NULL;
+
 	ofc_parse_debug_t* debug
 		= ofc_parse_debug_create();
 	if (!debug) return NULL;
 
 	ofc_parse_stmt_list_t* list
 		= ofc_parse_stmt_list_create();
-	if (!list) return NULL;
+	if (!list)
+	{
+		ofc_parse_debug_delete(debug);
+		return NULL;
+	}
 
-	if (!ofc_parse_file_include(
-		src, list, debug))
+	unsigned count;
+	ofc_parse_file__unit_t* unit;
+	unsigned i = ofc_parse_file__parallel(
+		src, list, &count, &unit);
+
+	unsigned len;
+	if (!ofc_parse_stmt_sublist(
+		list, src, &ptr[i], debug, &len))
 	{
 		ofc_parse_stmt_list_delete(list);
 		list = NULL;
 	}
+	else if (ptr[i + len] != '\0')
+	{
+		ofc_sparse_error(src, ofc_str_ref(&ptr[i + len], 0),
+			"Expected end of input");
+		ofc_parse_stmt_list_delete(list);
+		list = NULL;
+	}
+
+	unsigned u;
+	for (u = 0; u < count; u++)
+		ofc_parse_debug_print(unit[u].debug);
+	ofc_parse_file__unit_delete(count, unit);
 
 	ofc_parse_debug_print(debug);
 	ofc_parse_debug_delete(debug);
@@ -63,10 +384,49 @@ ofc_parse_stmt_list_t* ofc_parse_file(const ofc_sparse_t* src)
 	return list;
 }
 
+typedef struct
+{
+	const ofc_parse_stmt_list_t* list;
+	unsigned                     parts;
+} ofc_parse_file__print_t;
+
+static bool ofc_parse_file__part_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const void* param, unsigned part)
+{
+	const ofc_parse_file__print_t* print = param;
+	unsigned count = print->list->count;
+
+	unsigned start = (unsigned)(((uint64_t)count * part) / print->parts);
+	unsigned end   = (unsigned)(((uint64_t)count * (part + 1)) / print->parts);
+	return ofc_parse_stmt_list_print_range(
+		cs, indent, print->list, start, end);
+}
+
+bool ofc_parse_file_print_units(
+	ofc_colstr_t* cs,
+	const ofc_parse_stmt_list_t* list)
+{
+	if (!list)
+		return false;
+
+	/* Statements are printed in runs, a few for each job to
+	   even out units of different sizes. */
+	ofc_parse_file__print_t print;
+	print.list  = list;
+	print.parts = ofc_context_jobs(ofc_context_current());
+	print.parts = (print.parts > 1 ? (print.parts * 4) : 1);
+	if (print.parts > list->count)
+		print.parts = list->count;
+
+	return ofc_print_parts(cs, 0, &print,
+		print.parts, ofc_parse_file__part_print);
+}
+
 bool ofc_parse_file_print(
 	ofc_colstr_t* cs,
 	const ofc_parse_stmt_list_t* list)
 {
-	return (ofc_parse_stmt_list_print(cs, 0, list)
+	return (ofc_parse_file_print_units(cs, list)
 		&& ofc_colstr_writef(cs, "\n"));
 }
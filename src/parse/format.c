@@ -105,7 +105,7 @@ ofc_parse_format_desc_t* ofc_parse_format_desc(
 	unsigned* len)
 {
 	ofc_parse_format_desc_t* desc
-		= (ofc_parse_format_desc_t*)malloc(
+		= (ofc_parse_format_desc_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_format_desc_t));
 	if (!desc) return NULL;
 
@@ -173,7 +173,7 @@ ofc_parse_format_desc_t* ofc_parse_format_desc(
 		{
 			ofc_parse_format_desc_list_delete(
 				desc->repeat);
-			free(desc);
+			ofc_free(desc);
 			ofc_parse_debug_rewind(debug, dpos);
 			return NULL;
 		}
@@ -194,7 +194,7 @@ ofc_parse_format_desc_t* ofc_parse_format_desc(
 		= ofc_parse_format_desc__map[m];
 	if (!map.name)
 	{
-		free(desc);
+		ofc_free(desc);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -268,7 +268,7 @@ void ofc_parse_format_desc_delete(
 		default:
 			break;
 	}
-	free(desc);
+	ofc_free(desc);
 }
 
 const char* ofc_parse_format_desc__name[] =
@@ -429,7 +429,7 @@ static ofc_parse_format_desc_t* ofc_parse_format_desc__alloc(
 	ofc_parse_format_desc_t desc)
 {
 	ofc_parse_format_desc_t* adesc
-		= (ofc_parse_format_desc_t*)malloc(
+		= (ofc_parse_format_desc_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_format_desc_t));
 	if (!adesc) return NULL;
 	*adesc = desc;
@@ -457,7 +457,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list_copy(
 		return NULL;
 
 	ofc_parse_format_desc_list_t* copy
-		= (ofc_parse_format_desc_list_t*)malloc(
+		= (ofc_parse_format_desc_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_format_desc_list_t));
 	if (!copy) return NULL;
 
@@ -470,7 +470,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list_copy(
 		(void*)ofc_parse_format_desc_copy,
 		(void*)ofc_parse_format_desc_delete))
 	{
-		free(copy);
+		ofc_free(copy);
 		return NULL;
 	}
 
@@ -483,7 +483,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list(
 	unsigned* len)
 {
 	ofc_parse_format_desc_list_t* list
-		= (ofc_parse_format_desc_list_t*)malloc(
+		= (ofc_parse_format_desc_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_format_desc_list_t));
 	if (!list) return NULL;
 
@@ -497,7 +497,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list(
 		(void*)ofc_parse_format_desc_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -514,7 +514,7 @@ void ofc_parse_format_desc_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->desc,
 		(void*)ofc_parse_format_desc_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_format_desc_list_print(
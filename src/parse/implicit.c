@@ -124,7 +124,7 @@ ofc_parse_implicit_t* ofc_parse_implicit(
 	i += l;
 
 	ofc_parse_implicit_t* aimplicit
-		= (ofc_parse_implicit_t*)malloc(
+		= (ofc_parse_implicit_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_implicit_t));
 	if (!aimplicit)
 	{
@@ -145,7 +145,7 @@ void ofc_parse_implicit_delete(
 		return;
 
 	ofc_parse_type_delete(implicit->type);
-	free(implicit);
+	ofc_free(implicit);
 }
 
 bool ofc_parse_implicit_print(
@@ -201,7 +201,7 @@ ofc_parse_implicit_list_t* ofc_parse_implicit_list(
 	unsigned* len)
 {
 	ofc_parse_implicit_list_t* list
-		= (ofc_parse_implicit_list_t*)malloc(
+		= (ofc_parse_implicit_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_implicit_list_t));
 	if (!list) return NULL;
 
@@ -214,7 +214,7 @@ ofc_parse_implicit_list_t* ofc_parse_implicit_list(
 		(void*)ofc_parse_implicit_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -231,7 +231,7 @@ void ofc_parse_implicit_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->rule,
 		(void*)ofc_parse_implicit_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_implicit_list_print(
@@ -27,7 +27,7 @@ ofc_parse_implicit_do_t* ofc_parse_implicit_do(
 		return 0;
 
 	ofc_parse_implicit_do_t* id
-		= (ofc_parse_implicit_do_t*)malloc(
+		= (ofc_parse_implicit_do_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_implicit_do_t));
 	if (!id) return 0;
 
@@ -43,7 +43,7 @@ ofc_parse_implicit_do_t* ofc_parse_implicit_do(
 		src, &ptr[i], debug, &l);
 	if (!id->dlist)
 	{
-		free(id);
+		ofc_free(id);
 		return 0;
 	}
 	i += l;
@@ -115,7 +115,7 @@ ofc_parse_implicit_do_t* ofc_parse_implicit_do_copy(
 		return NULL;
 
 	ofc_parse_implicit_do_t* copy
-		= (ofc_parse_implicit_do_t*)malloc(
+		= (ofc_parse_implicit_do_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_implicit_do_t));
 	if (!copy) return NULL;
 
@@ -145,7 +145,7 @@ void ofc_parse_implicit_do_delete(
 	ofc_parse_assign_delete(id->init);
 	ofc_parse_expr_delete(id->limit);
 	ofc_parse_expr_delete(id->step);
-	free(id);
+	ofc_free(id);
 }
 
 bool ofc_parse_implicit_do_print(
@@ -175,7 +175,7 @@ ofc_sparse_ref_t* ofc_parse_name_alloc(
 	if (i == 0) return NULL;
 
 	ofc_sparse_ref_t* aname
-		= (ofc_sparse_ref_t*)malloc(
+		= (ofc_sparse_ref_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_sparse_ref_t));
 	if (!aname) return NULL;
 	*aname = name;
@@ -51,7 +51,7 @@ static ofc_parse_lhs_t* ofc_parse_lhs__alloc(
 	ofc_parse_lhs_t lhs)
 {
 	ofc_parse_lhs_t* alhs
-		= (ofc_parse_lhs_t*)malloc(
+		= (ofc_parse_lhs_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_lhs_t));
 	if (!alhs) return NULL;
 
@@ -65,9 +65,8 @@ static bool ofc_parse_lhs__clone(
 	if (!src || !dst)
 		return NULL;
 
-	ofc_parse_lhs_t clone;
-	clone.type = src->type;
-	clone.src  = src->src;
+	/* Members which aren't copied below are shallow copies. */
+	ofc_parse_lhs_t clone = *src;
 
 	switch (src->type)
 	{
@@ -434,7 +433,7 @@ void ofc_parse_lhs_delete(
 		return;
 
 	ofc_parse_lhs__cleanup(*lhs);
-	free(lhs);
+	ofc_free(lhs);
 }
 
 bool ofc_parse_lhs_print(
@@ -565,7 +564,7 @@ ofc_parse_lhs_list_t* ofc_parse_lhs_list(
 	unsigned* len)
 {
 	ofc_parse_lhs_list_t* list
-		= (ofc_parse_lhs_list_t*)malloc(
+		= (ofc_parse_lhs_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_lhs_list_t));
 	if (!list) return NULL;
 
@@ -579,7 +578,7 @@ ofc_parse_lhs_list_t* ofc_parse_lhs_list(
 		(void*)ofc_parse_lhs_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -625,7 +624,7 @@ void ofc_parse_lhs_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->lhs,
 		(void*)ofc_parse_lhs_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_lhs_list_print(
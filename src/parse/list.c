@@ -54,7 +54,7 @@ static unsigned ofc_parse_list__seperator_optional(
 			max_count <<= 1;
 			if (max_count == 0)
 				max_count = 4;
-			void** nelem = realloc(*elem,
+			void** nelem = ofc_realloc(OFC_ALLOC_PARSE, *elem,
 				(max_count * sizeof(void*)));
 			if (!nelem)
 			{
@@ -67,7 +67,7 @@ static unsigned ofc_parse_list__seperator_optional(
 
 				if (orig_count == 0)
 				{
-					free(*elem);
+					ofc_free(*elem);
 					*elem = NULL;
 				}
 
@@ -117,7 +117,7 @@ bool ofc_parse_list_copy(
 	if (!elem_copy || !src || !dst || !dst_count)
 		return false;
 
-	void** copy = (void**)malloc(
+	void** copy = (void**)ofc_alloc(OFC_ALLOC_PARSE,
 		src_count * sizeof(void*));
 	if (!copy) return false;
 
@@ -133,7 +133,7 @@ bool ofc_parse_list_copy(
 				for (j = 0; j < i; j++)
 					elem_delete(copy[j]);
 			}
-			free(copy);
+			ofc_free(copy);
 			return false;
 		}
 	}
@@ -153,7 +153,7 @@ void ofc_parse_list_delete(
 	unsigned i;
 	for (i = 0; i < elem_count; i++)
 		elem_delete(elem[i]);
-	free(elem);
+	ofc_free(elem);
 }
 
 
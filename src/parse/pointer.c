@@ -26,7 +26,7 @@ static ofc_parse_pointer_t* ofc_parse_pointer(
 		return NULL;
 
 	ofc_parse_pointer_t* pointer
-		= (ofc_parse_pointer_t*)malloc(
+		= (ofc_parse_pointer_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_pointer_t));
 	if (!pointer) return NULL;
 
@@ -36,14 +36,14 @@ static ofc_parse_pointer_t* ofc_parse_pointer(
 		src, &ptr[i], debug, &pointer->name);
 	if (l == 0)
 	{
-		free(pointer);
+		ofc_free(pointer);
 		return NULL;
 	}
 	i += l;
 
 	if (ptr[i++] != ',')
 	{
-		free(pointer);
+		ofc_free(pointer);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -52,7 +52,7 @@ static ofc_parse_pointer_t* ofc_parse_pointer(
 		src, &ptr[i], debug, &pointer->target);
 	if (l == 0)
 	{
-		free(pointer);
+		ofc_free(pointer);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -60,7 +60,7 @@ static ofc_parse_pointer_t* ofc_parse_pointer(
 
 	if (ptr[i++] != ')')
 	{
-		free(pointer);
+		ofc_free(pointer);
 		ofc_parse_debug_rewind(debug, dpos);
 		return NULL;
 	}
@@ -89,7 +89,7 @@ ofc_parse_pointer_list_t* ofc_parse_pointer_list(
 	unsigned* len)
 {
 	ofc_parse_pointer_list_t* list
-		= (ofc_parse_pointer_list_t*)malloc(
+		= (ofc_parse_pointer_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_pointer_list_t));
 	if (!list) return NULL;
 
@@ -99,10 +99,10 @@ ofc_parse_pointer_list_t* ofc_parse_pointer_list(
 	unsigned i = ofc_parse_list(
 		src, ptr, debug, ',',
 		&list->count, (void***)&list->pointer,
-		(void*)ofc_parse_pointer, free);
+		(void*)ofc_parse_pointer, ofc_free);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -118,8 +118,8 @@ void ofc_parse_pointer_list_delete(
 
 	ofc_parse_list_delete(
 		list->count, (void**)list->pointer,
-		free);
-	free(list);
+		ofc_free);
+	ofc_free(list);
 }
 
 bool ofc_parse_pointer_list_print(
@@ -22,7 +22,7 @@ ofc_parse_save_t* ofc_parse_save(
 	unsigned* len)
 {
 	ofc_parse_save_t* save
-		= (ofc_parse_save_t*)malloc(
+		= (ofc_parse_save_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_save_t));
 	if (!save) return NULL;
 
@@ -36,14 +36,14 @@ ofc_parse_save_t* ofc_parse_save(
 			&save->common);
 		if (l == 0)
 		{
-			free(save);
+			ofc_free(save);
 			return NULL;
 		}
 		i += l;
 
 		if (ptr[i++] != '/')
 		{
-			free(save);
+			ofc_free(save);
 			return NULL;
 		}
 
@@ -55,7 +55,7 @@ ofc_parse_save_t* ofc_parse_save(
 			src, ptr, debug, &i);
 		if (!save->lhs)
 		{
-			free(save);
+			ofc_free(save);
 			return NULL;
 		}
 		save->is_common = false;
@@ -73,7 +73,7 @@ void ofc_parse_save_delete(
 
 	if (!save->is_common)
 		ofc_parse_lhs_delete(save->lhs);
-	free(save);
+	ofc_free(save);
 }
 
 bool ofc_parse_save_print(
@@ -98,7 +98,7 @@ ofc_parse_save_list_t* ofc_parse_save_list(
 	unsigned* len)
 {
 	ofc_parse_save_list_t* list
-		= (ofc_parse_save_list_t*)malloc(
+		= (ofc_parse_save_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_save_list_t));
 	if (!list) return NULL;
 
@@ -112,7 +112,7 @@ ofc_parse_save_list_t* ofc_parse_save_list(
 		(void*)ofc_parse_save_delete);
 	if (i == 0)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -129,7 +129,7 @@ void ofc_parse_save_list_delete(
 	ofc_parse_list_delete(
 		list->count, (void**)list->save,
 		(void*)ofc_parse_save_delete);
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_parse_save_list_print(
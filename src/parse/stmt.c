@@ -285,7 +285,7 @@ static void ofc_parse_stmt__cleanup(
 			ofc_parse_list_delete(
 				stmt.decl_attr.count,
 				(void**)stmt.decl_attr.name,
-				free);
+				ofc_free);
 			break;
 		case OFC_PARSE_STMT_POINTER:
 			ofc_parse_pointer_list_delete(
@@ -384,7 +384,7 @@ static ofc_parse_stmt_t* ofc_parse_stmt__alloc(
 	ofc_parse_stmt_t stmt)
 {
 	ofc_parse_stmt_t* astmt
-		= (ofc_parse_stmt_t*)malloc(
+		= (ofc_parse_stmt_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_stmt_t));
 	if (!astmt) return NULL;
 
@@ -601,7 +601,7 @@ void ofc_parse_stmt_delete(
 		return;
 
 	ofc_parse_stmt__cleanup(*stmt);
-	free(stmt);
+	ofc_free(stmt);
 }
 
 
@@ -818,9 +818,10 @@ bool ofc_parse_stmt_print(
 
 
 
-bool ofc_parse_stmt_sublist(
+bool ofc_parse_stmt_sublist_until(
 	ofc_parse_stmt_list_t* list,
 	const ofc_sparse_t* src, const char* ptr,
+	const char* end,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
@@ -828,7 +829,7 @@ bool ofc_parse_stmt_sublist(
 		return false;
 
 	unsigned i = 0;
-	while (true)
+	while (!end || (&ptr[i] < end))
 	{
 		unsigned slen;
 		ofc_parse_stmt_t* stmt = ofc_parse_stmt(
@@ -842,7 +843,7 @@ bool ofc_parse_stmt_sublist(
 			if (nsize == 0) nsize = 16;
 
 			ofc_parse_stmt_t** nstmt
-				= (ofc_parse_stmt_t**)realloc(list->stmt,
+				= (ofc_parse_stmt_t**)ofc_realloc(OFC_ALLOC_PARSE, list->stmt,
 					(nsize * sizeof(ofc_parse_stmt_t*)));
 			if (!nstmt)
 			{
@@ -863,6 +864,16 @@ bool ofc_parse_stmt_sublist(
 	return true;
 }
 
+bool ofc_parse_stmt_sublist(
+	ofc_parse_stmt_list_t* list,
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_stmt_sublist_until(
+		list, src, ptr, NULL, debug, len);
+}
+
 ofc_parse_stmt_list_t* ofc_parse_stmt_list(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
@@ -887,7 +898,7 @@ ofc_parse_stmt_list_t* ofc_parse_stmt_list(
 ofc_parse_stmt_list_t* ofc_parse_stmt_list_create(void)
 {
 	ofc_parse_stmt_list_t* list
-		= (ofc_parse_stmt_list_t*)malloc(
+		= (ofc_parse_stmt_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_stmt_list_t));
 	if (!list) return NULL;
 
@@ -906,8 +917,8 @@ void ofc_parse_stmt_list_delete(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_parse_stmt_delete(list->stmt[i]);
-	free(list->stmt);
-	free(list);
+	ofc_free(list->stmt);
+	ofc_free(list);
 }
 
 bool ofc_parse_stmt_list_foreach(
@@ -976,8 +987,20 @@ bool ofc_parse_stmt_list_print(
 	if (!list)
 		return false;
 
+	return ofc_parse_stmt_list_print_range(
+		cs, indent, list, 0, list->count);
+}
+
+bool ofc_parse_stmt_list_print_range(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_parse_stmt_list_t* list,
+	unsigned start, unsigned end)
+{
+	if (!list || (end > list->count))
+		return false;
+
 	unsigned i;
-	for (i = 0; i < list->count; i++)
+	for (i = start; i < end; i++)
 	{
 		if (!ofc_colstr_newline(cs, indent,
 			(list->stmt[i]->label > 0
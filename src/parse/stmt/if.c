@@ -122,7 +122,7 @@ static unsigned ofc_parse_stmt_if__then(
 			expect_end = false;
 
 			stmt->if_then.block_else
-				= (ofc_parse_stmt_list_t*)malloc(
+				= (ofc_parse_stmt_list_t*)ofc_alloc(OFC_ALLOC_PARSE,
 					sizeof(ofc_parse_stmt_list_t));
 			if (!stmt->if_then.block_else)
 			{
@@ -133,11 +133,11 @@ static unsigned ofc_parse_stmt_if__then(
 			}
 
 			stmt->if_then.block_else->stmt
-				= (ofc_parse_stmt_t**)malloc(
+				= (ofc_parse_stmt_t**)ofc_alloc(OFC_ALLOC_PARSE,
 					sizeof(ofc_parse_stmt_t*));
 			if (!stmt->if_then.block_else->stmt)
 			{
-				free(stmt->if_then.block_else);
+				ofc_free(stmt->if_then.block_else);
 				ofc_parse_stmt_delete(stmt_else);
 				ofc_parse_stmt_list_delete(stmt->if_then.block_then);
 				ofc_parse_debug_rewind(debug, dpos);
@@ -65,10 +65,10 @@ unsigned ofc_parse_stmt_include(
 	{
 		ofc_sparse_error(src, ofc_str_ref(ptr, i),
 			"Can't open include file '%s'", rpath);
-		free(rpath);
+		ofc_free(rpath);
 		return 0;
 	}
-	free(rpath);
+	ofc_free(rpath);
 
 	stmt->include.src = ofc_prep(stmt->include.file);
 
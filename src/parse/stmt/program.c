@@ -62,8 +62,9 @@ unsigned ofc_parse_stmt_program__body(
 	return i;
 }
 
-/* This is hacky, but it means we can suppress redeclarations of the same program. */
-static ofc_str_ref_t ofc_parse_stmt_program__current = OFC_STR_REF_EMPTY;
+/* This is hacky, but it means we can suppress redeclarations of the same program.
+   It's thread local so that units can be parsed concurrently. */
+static _Thread_local ofc_str_ref_t ofc_parse_stmt_program__current = OFC_STR_REF_EMPTY;
 
 unsigned ofc_parse_stmt_program(
 	const ofc_sparse_t* src, const char* ptr,
@@ -111,6 +112,7 @@ unsigned ofc_parse_stmt_program(
 	len = ofc_parse_stmt_program__body(
 		src, &ptr[i], debug,
 		OFC_PARSE_KEYWORD_PROGRAM, stmt);
+	ofc_parse_stmt_program__current = prev_program_name;
 	if (len == 0)
 	{
 		ofc_parse_debug_rewind(debug, dpos);
@@ -118,8 +120,6 @@ unsigned ofc_parse_stmt_program(
 	}
 	i += len;
 
-	ofc_parse_stmt_program__current = prev_program_name;
-
 	stmt->program.type = NULL;
 	stmt->program.args = NULL;
 
@@ -264,8 +264,9 @@ unsigned ofc_parse_stmt_function(
 }
 
 
-/* This is hacky, but it means we can suppress redeclarations of the same block_data. */
-static ofc_str_ref_t ofc_parse_stmt_block_data__current = OFC_STR_REF_EMPTY;
+/* This is hacky, but it means we can suppress redeclarations of the same block_data.
+   It's thread local so that units can be parsed concurrently. */
+static _Thread_local ofc_str_ref_t ofc_parse_stmt_block_data__current = OFC_STR_REF_EMPTY;
 
 unsigned ofc_parse_stmt_block_data(
 	const ofc_sparse_t* src, const char* ptr,
@@ -313,6 +314,7 @@ unsigned ofc_parse_stmt_block_data(
 	len = ofc_parse_stmt_program__body(
 		src, &ptr[i], debug,
 		OFC_PARSE_KEYWORD_BLOCK_DATA, stmt);
+	ofc_parse_stmt_block_data__current = prev_block_data_name;
 	if (len == 0)
 	{
 		ofc_parse_debug_rewind(debug, dpos);
@@ -320,8 +322,6 @@ unsigned ofc_parse_stmt_block_data(
 	}
 	i += len;
 
-	ofc_parse_stmt_block_data__current = prev_block_data_name;
-
 	stmt->program.type = NULL;
 	stmt->program.args = NULL;
 
@@ -115,7 +115,7 @@ static unsigned ofc_parse_decl_attr(
 static ofc_parse_type_t* ofc_parse_type__alloc(ofc_parse_type_t type)
 {
 	ofc_parse_type_t* atype
-		= (ofc_parse_type_t*)malloc(
+		= (ofc_parse_type_t*)ofc_alloc(OFC_ALLOC_PARSE,
 			sizeof(ofc_parse_type_t));
 	if (!atype) return NULL;
 
@@ -291,7 +291,7 @@ void ofc_parse_type_delete(ofc_parse_type_t* type)
 		return;
 
 	ofc_parse_type__cleanup(*type);
-	free(type);
+	ofc_free(type);
 }
 
 bool ofc_parse_type_print(
@@ -29,3 +29,31 @@ ofc_sparse_t* ofc_prep(ofc_file_t* file)
 	ofc_sparse_delete(unformat);
 	return condense;
 }
+
+bool ofc_prep_unit(
+	ofc_file_t* file, unsigned* offset,
+	ofc_sparse_t** condense)
+{
+	const char* src = ofc_file_get_strz(file);
+	if (!src || !offset || !condense)
+		return false;
+
+	*condense = NULL;
+	if (*offset >= file->size)
+		return true;
+
+	ofc_sparse_t* unformat
+		= ofc_prep_unformat_unit(file, offset);
+	if (!unformat) return false;
+
+	/* Comments after the last unit don't make another. */
+	if (ofc_sparse_len(unformat) == 0)
+	{
+		ofc_sparse_delete(unformat);
+		return true;
+	}
+
+	*condense = ofc_prep_condense(unformat);
+	ofc_sparse_delete(unformat);
+	return (*condense != NULL);
+}
@@ -186,6 +186,7 @@ static unsigned ofc_prep_unformat__free_form_label(
 				"Label number too large");
 			return 0;
 		}
+		label_value = nvalue;
 	}
 
 	if ((i > 0) && ofc_is_hspace(src[i]))
@@ -459,8 +460,60 @@ static unsigned ofc_prep_unformat__free_form_code(
 	return i;
 }
 
+static unsigned ofc_prep_unformat__match(
+	const char* src, unsigned len, const char* keyword)
+{
+	unsigned i = 0, k;
+	for (k = 0; keyword[k] != '\0'; k++)
+	{
+		while ((i < len) && ofc_is_hspace(src[i]))
+			i++;
+		if ((i >= len) || (toupper(src[i]) != keyword[k]))
+			return 0;
+		i++;
+	}
+	return i;
+}
+
+/* Only a lone END, or END with a unit keyword and name, is taken as the
+   end of a program unit. Anything else may be ENDIF, ENDFILE or an
+   assignment, and a unit is never split where we aren't sure. */
+static bool ofc_prep_unformat__unit_end(
+	const char* src, unsigned len)
+{
+	static const char* keyword[] =
+	{
+		"PROGRAM",
+		"SUBROUTINE",
+		"FUNCTION",
+		"BLOCKDATA",
+		NULL
+	};
+
+	unsigned i = ofc_prep_unformat__match(src, len, "END");
+	if (i == 0) return false;
+
+	unsigned k;
+	for (k = 0; keyword[k]; k++)
+	{
+		unsigned klen = ofc_prep_unformat__match(
+			&src[i], (len - i), keyword[k]);
+		if (klen > 0)
+		{
+			for (i += klen; (i < len) && (ofc_is_ident(src[i])
+				|| ofc_is_hspace(src[i])); i++);
+			break;
+		}
+	}
+
+	while ((i < len) && ofc_is_hspace(src[i]))
+		i++;
+	return (i >= len);
+}
+
 static bool ofc_prep_unformat__fixed_form(
-	const ofc_file_t* file, ofc_sparse_t* sparse)
+	const ofc_file_t* file, ofc_sparse_t* sparse,
+	unsigned* offset, bool unit)
 {
 	const char*     src   = ofc_file_get_strz(file);
 	ofc_lang_opts_t opts  = ofc_file_get_lang_opts(file);
@@ -477,8 +530,10 @@ static bool ofc_prep_unformat__fixed_form(
 	unsigned label_prev = 0;
 	unsigned label_pos = 0;
 
+	bool unit_end = false;
+
 	unsigned row, pos;
-	for (row = 0, pos = 0; src[pos] != '\0'; row++)
+	for (row = 0, pos = *offset; src[pos] != '\0'; row++)
 	{
 		unsigned len, col;
 
@@ -496,6 +551,10 @@ static bool ofc_prep_unformat__fixed_form(
 			&has_label, &label, &continuation, &col);
 		if (len == 0) return false;
 
+		if (unit && unit_end
+			&& !continuation && !had_label)
+			break;
+
 		if (first_code_line && continuation)
 		{
 			ofc_file_warning(file, &src[pos],
@@ -554,9 +613,12 @@ static bool ofc_prep_unformat__fixed_form(
 			/* Append non-empty line to output. */
 			len = ofc_prep_unformat__fixed_form_code(
 				&col, &state, file, &src[pos], opts, sparse);
-			pos += len;
 			if (len == 0) return false;
 
+			unit_end = (!continuation
+				&& ofc_prep_unformat__unit_end(&src[pos], len));
+			pos += len;
+
 			first_code_line = false;
 		}
 		else if (has_label)
@@ -577,11 +639,13 @@ static bool ofc_prep_unformat__fixed_form(
 		if (ofc_is_vspace(src[pos])) pos++;
 	}
 
+	*offset = pos;
 	return true;
 }
 
 static bool ofc_prep_unformat__free_form(
-	const ofc_file_t* file, ofc_sparse_t* sparse)
+	const ofc_file_t* file, ofc_sparse_t* sparse,
+	unsigned* offset, bool unit)
 {
 	const char*     src   = ofc_file_get_strz(file);
 	ofc_lang_opts_t opts  = ofc_file_get_lang_opts(file);
@@ -599,8 +663,10 @@ static bool ofc_prep_unformat__free_form(
 	unsigned label_prev = 0;
 	unsigned label_pos = 0;
 
+	bool unit_end = false;
+
 	unsigned row, pos;
-	for (row = 0, pos = 0; src[pos] != '\0'; row++)
+	for (row = 0, pos = *offset; src[pos] != '\0'; row++)
 	{
 		unsigned len, col;
 
@@ -611,6 +677,10 @@ static bool ofc_prep_unformat__free_form(
 			continue;
 		}
 
+		if (unit && unit_end
+			&& !continuation && !had_label)
+			break;
+
 		bool has_label;
 		unsigned label = 0;
 
@@ -653,6 +723,10 @@ static bool ofc_prep_unformat__free_form(
 
 		if (has_code)
 		{
+			if (!first_code_line && !continuation
+				&& !ofc_sparse_append_strn(sparse, newline, 1))
+				return false;
+
 			if (has_label)
 			{
 				/* Mark current position in unformat stream as label. */
@@ -660,16 +734,16 @@ static bool ofc_prep_unformat__free_form(
 					return false;
 			}
 
-			if (!first_code_line && !continuation
-				&& !ofc_sparse_append_strn(sparse, newline, 1))
-				return false;
-
+			bool first = !continuation;
 			len = ofc_prep_unformat__free_form_code(
 				&col, &state, file, &src[pos], opts,
 				sparse, &continuation);
-			pos += len;
 			if (len == 0) return false;
 
+			unit_end = (first && !continuation
+				&& ofc_prep_unformat__unit_end(&src[pos], len));
+			pos += len;
+
 			if (!continuation)
 				state = PRE_STATE_DEFAULT;
 
@@ -693,10 +767,13 @@ static bool ofc_prep_unformat__free_form(
 		if (ofc_is_vspace(src[pos])) pos++;
 
 	}
+
+	*offset = pos;
 	return true;
 }
 
-ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
+static ofc_sparse_t* ofc_prep_unformat__range(
+	ofc_file_t* file, unsigned* offset, bool unit)
 {
 	ofc_sparse_t* unformat
 		= ofc_sparse_create_file(file);
@@ -707,10 +784,12 @@ ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
 	{
 		case OFC_LANG_FORM_FIXED:
 		case OFC_LANG_FORM_TAB:
-			success = ofc_prep_unformat__fixed_form(file, unformat);
+			success = ofc_prep_unformat__fixed_form(
+				file, unformat, offset, unit);
 			break;
 		case OFC_LANG_FORM_FREE:
-			success = ofc_prep_unformat__free_form(file, unformat);
+			success = ofc_prep_unformat__free_form(
+				file, unformat, offset, unit);
 			break;
 		default:
 			break;
@@ -725,3 +804,20 @@ ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
 	ofc_sparse_lock(unformat);
 	return unformat;
 }
+
+ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
+{
+	unsigned offset = 0;
+	return ofc_prep_unformat__range(
+		file, &offset, false);
+}
+
+ofc_sparse_t* ofc_prep_unformat_unit(
+	ofc_file_t* file, unsigned* offset)
+{
+	if (!offset)
+		return NULL;
+
+	return ofc_prep_unformat__range(
+		file, offset, true);
+}
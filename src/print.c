@@ -0,0 +1,148 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+
+#include "ofc/alloc.h"
+#include "ofc/print.h"
+#include "ofc/context.h"
+
+
+typedef struct
+{
+	ofc_colstr_t* cs;
+	bool          success;
+} ofc_print__part_t;
+
+typedef struct
+{
+	ofc_context_t*     context;
+	pthread_mutex_t    lock;
+	unsigned           next;
+	unsigned           count;
+	ofc_print__part_t* part;
+
+	const ofc_colstr_t* like;
+	unsigned            indent;
+	const void*         param;
+	ofc_print_part_f    func;
+} ofc_print__pool_t;
+
+static void* ofc_print__worker(
+	ofc_print__pool_t* pool)
+{
+	ofc_context_t* previous
+		= ofc_context_enter(pool->context);
+
+	while (true)
+	{
+		pthread_mutex_lock(&pool->lock);
+		unsigned i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (i >= pool->count)
+			break;
+
+		ofc_print__part_t* part = &pool->part[i];
+		part->cs = ofc_colstr_create_like(pool->like);
+		part->success = (part->cs && pool->func(
+			part->cs, pool->indent, pool->param, i));
+	}
+
+	ofc_context_leave(previous);
+	return NULL;
+}
+
+static bool ofc_print__pool(
+	ofc_print__pool_t* pool, unsigned jobs)
+{
+	if (pthread_mutex_init(&pool->lock, NULL) != 0)
+		return false;
+
+	if (jobs > pool->count)
+		jobs = pool->count;
+
+	/* Printing recurses as deeply as parsing does. */
+	pthread_attr_t attr;
+	bool attr_valid = (pthread_attr_init(&attr) == 0);
+	if (attr_valid)
+		pthread_attr_setstacksize(&attr, (16 << 20));
+
+	pthread_t thread[jobs];
+	unsigned t;
+	for (t = 0; (t + 1) < jobs; t++)
+	{
+		if (pthread_create(&thread[t],
+			(attr_valid ? &attr : NULL),
+			(void*)ofc_print__worker, pool) != 0)
+			break;
+	}
+
+	ofc_print__worker(pool);
+
+	while (t > 0)
+		pthread_join(thread[--t], NULL);
+
+	if (attr_valid)
+		pthread_attr_destroy(&attr);
+	pthread_mutex_destroy(&pool->lock);
+	return true;
+}
+
+bool ofc_print_parts(
+	ofc_colstr_t* cs, unsigned indent,
+	const void* param, unsigned count,
+	ofc_print_part_f func)
+{
+	if (!cs || !func)
+		return false;
+
+	ofc_context_t* context = ofc_context_current();
+	unsigned jobs = ofc_context_jobs(context);
+
+	unsigned i;
+	if ((jobs <= 1) || (count < 2))
+	{
+		for (i = 0; i < count; i++)
+		{
+			if (!func(cs, indent, param, i))
+				return false;
+		}
+		return true;
+	}
+
+	ofc_print__pool_t pool;
+	pool.context = context;
+	pool.next    = 0;
+	pool.count   = count;
+	pool.like    = cs;
+	pool.indent  = indent;
+	pool.param   = param;
+	pool.func    = func;
+	pool.part    = (ofc_print__part_t*)ofc_calloc(
+		OFC_ALLOC_COLSTR, count, sizeof(ofc_print__part_t));
+	if (!pool.part) return false;
+
+	bool success = ofc_print__pool(&pool, jobs);
+	for (i = 0; i < count; i++)
+	{
+		success = (success && pool.part[i].success
+			&& ofc_colstr_append(cs, pool.part[i].cs));
+		ofc_colstr_delete(pool.part[i].cs);
+	}
+	ofc_free(pool.part);
+
+	return success;
+}
@@ -0,0 +1,349 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ofc/alloc.h"
+#include "ofc/context.h"
+#include "ofc/reformat.h"
+
+
+/* Printed units are buffered until there's this much to write. */
+#define OFC_REFORMAT__FLUSH_SIZE (64 << 10)
+
+typedef struct
+{
+	int  fd;
+	bool written;
+	bool last;
+} ofc_reformat__out_t;
+
+typedef struct
+{
+	const char*            dir;
+	const char* const*     path;
+	unsigned               count;
+	const ofc_lang_opts_t* lang_opts;
+	ofc_global_opts_t      global_opts;
+	ofc_diag_t*            diag;
+
+	pthread_mutex_t lock;
+	unsigned        next;
+	bool            success;
+} ofc_reformat__pool_t;
+
+
+static bool ofc_reformat__write(
+	int fd, const char* base, unsigned size)
+{
+	while (size > 0)
+	{
+		ssize_t w = write(fd, base, size);
+		if (w < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		base += w;
+		size -= w;
+	}
+
+	return true;
+}
+
+/* The first newline printed into an empty buffer isn't written,
+   so we write it ourselves before each buffer after the first. */
+static bool ofc_reformat__flush(
+	ofc_colstr_t* cs, ofc_reformat__out_t* out)
+{
+	unsigned size;
+	const char* base = ofc_colstr_get(cs, &size);
+	if ((size == 0) || (!out->last
+		&& (size < OFC_REFORMAT__FLUSH_SIZE)))
+		return true;
+
+	if ((out->written && !ofc_reformat__write(out->fd, "\n", 1))
+		|| !ofc_reformat__write(out->fd, base, size))
+		return false;
+
+	out->written = true;
+	ofc_colstr_reset(cs);
+	return true;
+}
+
+/* Relative paths are mirrored below dir so that a tree of sources can
+   be converted at once, others would escape it so only their name is
+   kept. The extension is replaced with .f90 */
+static char* ofc_reformat__path(
+	const char* dir, const char* path)
+{
+	bool keep = (path[0] != '/');
+
+	const char* c;
+	for (c = path; keep && *c != '\0'; c++)
+	{
+		if (((c == path) || (c[-1] == '/'))
+			&& (strncmp(c, "..", 2) == 0)
+			&& ((c[2] == '/') || (c[2] == '\0')))
+			keep = false;
+	}
+
+	const char* name = path;
+	if (!keep)
+	{
+		const char* slash = strrchr(path, '/');
+		if (slash) name = &slash[1];
+	}
+
+	while (strncmp(name, "./", 2) == 0)
+	{
+		for (name += 2; *name == '/'; name++);
+	}
+
+	const char* base = strrchr(name, '/');
+	base = (base ? &base[1] : name);
+	const char* ext = strrchr(base, '.');
+
+	unsigned len = ((ext && (ext != base))
+		? (unsigned)(ext - name) : strlen(name));
+	if (len == 0) return NULL;
+
+	unsigned size = strlen(dir) + len + 6;
+	char* out = (char*)ofc_alloc(OFC_ALLOC_FILE, size);
+	if (!out) return NULL;
+
+	snprintf(out, size, "%s/%.*s.f90", dir, len, name);
+	return out;
+}
+
+static bool ofc_reformat__mkdirs(char* path)
+{
+	char* c;
+	for (c = &path[1]; *c != '\0'; c++)
+	{
+		if ((*c != '/') || (c[-1] == '/'))
+			continue;
+
+		*c = '\0';
+		bool success = ((mkdir(path, 0777) == 0)
+			|| (errno == EEXIST));
+		*c = '/';
+
+		if (!success)
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_reformat__same_file(
+	const char* a, const char* b)
+{
+	struct stat sa, sb;
+	return ((stat(a, &sa) == 0)
+		&& (stat(b, &sb) == 0)
+		&& (sa.st_dev == sb.st_dev)
+		&& (sa.st_ino == sb.st_ino));
+}
+
+static bool ofc_reformat__emit(
+	ofc_context_t* context, const char* dir,
+	const char* path, const ofc_lang_opts_t* lang_opts)
+{
+	ofc_lang_opts_t opts = *lang_opts;
+	const char* ext = strrchr(path, '.');
+	if (ext && (strcasecmp(ext, ".f90") == 0))
+		opts = OFC_LANG_OPTS_F90;
+
+	const ofc_sema_scope_t* sema
+		= ofc_context_analyse(context, path, NULL, &opts);
+	if (!sema) return false;
+
+	ofc_context_t* previous
+		= ofc_context_enter(context);
+
+	char* out_path = ofc_reformat__path(dir, path);
+	if (!out_path)
+	{
+		ofc_file_error(context->file, NULL,
+			"Failed to name F90 output");
+		ofc_context_leave(previous);
+		return false;
+	}
+
+	if (ofc_reformat__same_file(path, out_path))
+	{
+		ofc_file_error(context->file, NULL,
+			"F90 output '%s' would overwrite its source", out_path);
+		ofc_free(out_path);
+		ofc_context_leave(previous);
+		return false;
+	}
+
+	ofc_reformat__out_t out;
+	out.fd      = -1;
+	out.written = false;
+	out.last    = false;
+
+	if (ofc_reformat__mkdirs(out_path))
+		out.fd = open(out_path, (O_WRONLY | O_CREAT | O_TRUNC), 0666);
+	if (out.fd < 0)
+	{
+		ofc_file_error(context->file, NULL,
+			"Failed to create '%s'", out_path);
+		ofc_free(out_path);
+		ofc_context_leave(previous);
+		return false;
+	}
+
+	ofc_colstr_t* cs = ofc_colstr_create_free(0);
+	bool success = (cs && ofc_sema_scope_print_units(
+		cs, 0, sema, &out, (void*)ofc_reformat__flush));
+	if (success)
+	{
+		out.last = true;
+		success = (ofc_reformat__flush(cs, &out)
+			&& (!out.written || ofc_reformat__write(out.fd, "\n", 1)));
+	}
+	ofc_colstr_delete(cs);
+
+	if ((close(out.fd) != 0) || !success)
+	{
+		ofc_file_error(context->file, NULL,
+			"Failed to write '%s'", out_path);
+		success = false;
+	}
+
+	ofc_free(out_path);
+	ofc_context_leave(previous);
+	return success;
+}
+
+static void* ofc_reformat__worker(
+	ofc_reformat__pool_t* pool)
+{
+	ofc_context_t* context
+		= ofc_context_create(&pool->global_opts);
+
+	while (true)
+	{
+		pthread_mutex_lock(&pool->lock);
+		unsigned i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (i >= pool->count)
+			break;
+
+		bool success = (context && ofc_reformat__emit(
+			context, pool->dir, pool->path[i], pool->lang_opts));
+		if (context)
+		{
+			ofc_diag_merge(pool->diag, ofc_context_diag(context));
+			ofc_diag_sync(pool->diag);
+		}
+
+		if (!success)
+		{
+			pthread_mutex_lock(&pool->lock);
+			pool->success = false;
+			pthread_mutex_unlock(&pool->lock);
+		}
+	}
+
+	ofc_context_delete(context);
+	return NULL;
+}
+
+bool ofc_reformat_f90(
+	const char* dir,
+	const char* const* path, unsigned count,
+	const ofc_lang_opts_t* lang_opts)
+{
+	if (!dir || !path || !lang_opts)
+		return false;
+	if (count == 0)
+		return true;
+
+	if ((mkdir(dir, 0777) != 0) && (errno != EEXIST))
+	{
+		ofc_file_error(NULL, NULL,
+			"Failed to create output directory '%s'", dir);
+		return false;
+	}
+
+	ofc_context_t* current = ofc_context_current();
+	unsigned jobs = ofc_context_jobs(current);
+
+	ofc_reformat__pool_t pool;
+	pool.dir         = dir;
+	pool.path        = path;
+	pool.count       = count;
+	pool.lang_opts   = lang_opts;
+	pool.global_opts = current->global_opts;
+	pool.diag        = ofc_diag_default();
+	pool.next        = 0;
+	pool.success     = true;
+
+	/* Threads left over once each file has one
+	   are shared out to parse within the files. */
+	if (jobs > count)
+	{
+		pool.global_opts.jobs = (jobs / count);
+		jobs = count;
+	}
+	else
+	{
+		pool.global_opts.jobs = 1;
+	}
+
+	if (pthread_mutex_init(&pool.lock, NULL) != 0)
+		return false;
+
+	/* Each worker parses, so needs as much stack as the main thread. */
+	pthread_attr_t attr;
+	bool attr_valid = (pthread_attr_init(&attr) == 0);
+	if (attr_valid)
+		pthread_attr_setstacksize(&attr, (16 << 20));
+
+	pthread_t thread[jobs];
+	unsigned t;
+	for (t = 0; (t + 1) < jobs; t++)
+	{
+		if (pthread_create(&thread[t],
+			(attr_valid ? &attr : NULL),
+			(void*)ofc_reformat__worker, &pool) != 0)
+			break;
+	}
+
+	ofc_reformat__worker(&pool);
+
+	while (t > 0)
+		pthread_join(thread[--t], NULL);
+
+	if (attr_valid)
+		pthread_attr_destroy(&attr);
+	pthread_mutex_destroy(&pool.lock);
+	return pool.success;
+}
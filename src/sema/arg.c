@@ -18,15 +18,15 @@
 static ofc_sema_arg_list_t* ofc_sema_arg_list__create(unsigned count)
 {
 	ofc_sema_arg_list_t* list
-		= (ofc_sema_arg_list_t*)malloc(
+		= (ofc_sema_arg_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_arg_list_t));
 	if (!list) return NULL;
 
-	list->arg = (ofc_sema_arg_t*)malloc(
+	list->arg = (ofc_sema_arg_t*)ofc_alloc(OFC_ALLOC_SEMA,
 		sizeof(ofc_sema_arg_t) * count);
 	if (!list->arg)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -195,6 +195,6 @@ void ofc_sema_arg_list_delete(
 	if (!list)
 		return;
 
-	free(list->arg);
-	free(list);
+	ofc_free(list->arg);
+	ofc_free(list);
 }
@@ -41,11 +41,12 @@ ofc_sema_array_t* ofc_sema_array(
 	}
 
 	ofc_sema_array_t* array
-		= (ofc_sema_array_t*)malloc(sizeof(ofc_sema_array_t)
+		= (ofc_sema_array_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_t)
 			+ (index->count * sizeof(ofc_sema_array_dims_t)));
 	if (!array) return NULL;
 
-	array->dimensions = index->count;
+	array->dimensions     = index->count;
+	array->shape_resolved = false;
 
 	for (i = 0; i < index->count; i++)
 	{
@@ -149,11 +150,12 @@ ofc_sema_array_t* ofc_sema_array_copy_replace(
 		return NULL;
 
 	ofc_sema_array_t* copy
-		= (ofc_sema_array_t*)malloc(sizeof(ofc_sema_array_t)
+		= (ofc_sema_array_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_t)
 			+ (sizeof(ofc_sema_array_dims_t) * array->dimensions));
 	if (!copy) return NULL;
 
-	copy->dimensions = array->dimensions;
+	copy->dimensions     = array->dimensions;
+	copy->shape_resolved = false;
 
 	bool fail = false;
 	unsigned i;
@@ -203,7 +205,7 @@ void ofc_sema_array_delete(
 		ofc_sema_expr_delete(array->segment[i].last);
 	}
 
-	free(array);
+	ofc_free(array);
 }
 
 
@@ -221,6 +223,18 @@ bool ofc_sema_array_compare(
 		return false;
 
 	unsigned i;
+	if (ofc_sema_array_shape_resolve(a)
+		&& ofc_sema_array_shape_resolve(b))
+	{
+		for (i = 0; i < a->dimensions; i++)
+		{
+			if ((a->segment[i].lower != b->segment[i].lower)
+				|| (a->segment[i].extent != b->segment[i].extent))
+				return false;
+		}
+		return true;
+	}
+
 	for (i = 0; i < a->dimensions; i++)
 	{
 		if (!ofc_sema_expr_compare(
@@ -266,38 +280,180 @@ bool ofc_sema_array_compare(
 	return true;
 }
 
-bool ofc_sema_array_total(
-	const ofc_sema_array_t* array,
-	unsigned* total)
+static bool ofc_sema_array__resolve_bound(
+	const ofc_sema_expr_t* expr, int64_t* value)
+{
+	const ofc_sema_typeval_t* tv
+		= ofc_sema_expr_constant(expr);
+	if (!tv) return false;
+	return ofc_sema_typeval_get_integer(tv, value);
+}
+
+bool ofc_sema_array_shape_resolve(
+	const ofc_sema_array_t* array)
 {
 	if (!array)
 		return false;
+	if (array->shape_resolved)
+		return true;
 
-	unsigned t = 1;
+	/* Failures aren't cached since bounds may name parameters
+	   which are only initialized later. */
+	int64_t  lower[array->dimensions];
+	uint64_t extent[array->dimensions];
+
+	uint64_t t = 1;
 	unsigned i;
 	for (i = 0; i < array->dimensions; i++)
 	{
-		ofc_sema_array_dims_t seg
-			= array->segment[i];
+		const ofc_sema_array_dims_t* seg
+			= &array->segment[i];
 
-		int first = 1, last;
-		if (seg.first && !ofc_sema_expr_resolve_int(
-			seg.first, &first))
+		int64_t first = 1, last;
+		if (seg->first && !ofc_sema_array__resolve_bound(
+			seg->first, &first))
 			return false;
-		if (!ofc_sema_expr_resolve_int(
-			seg.last, &last))
+		if (!seg->last || !ofc_sema_array__resolve_bound(
+			seg->last, &last))
 			return false;
 
 		if (last < first)
 			return false;
 
-		t *= ((last - first) + 1);
+		lower[i]  = first;
+		extent[i] = ((uint64_t)last - (uint64_t)first) + 1;
+		if ((extent[i] == 0)
+			|| (t > (UINT64_MAX / extent[i])))
+			return false;
+		t *= extent[i];
+	}
+
+	ofc_sema_array_t* a
+		= (ofc_sema_array_t*)array;
+
+	uint64_t s = 1;
+	for (i = 0; i < a->dimensions; i++)
+	{
+		a->segment[i].lower  = lower[i];
+		a->segment[i].extent = extent[i];
+		a->segment[i].stride = s;
+		s *= extent[i];
+	}
+	a->total = t;
+	a->shape_resolved = true;
+	return true;
+}
+
+bool ofc_sema_array_total64(
+	const ofc_sema_array_t* array,
+	uint64_t* total)
+{
+	if (!ofc_sema_array_shape_resolve(array))
+		return false;
+
+	if (total) *total = array->total;
+	return true;
+}
+
+bool ofc_sema_array_total(
+	const ofc_sema_array_t* array,
+	unsigned* total)
+{
+	uint64_t t;
+	if (!ofc_sema_array_total64(array, &t))
+		return false;
+
+	unsigned u = t;
+	if (u != t)
+		return false;
+
+	if (total) *total = u;
+	return true;
+}
+
+bool ofc_sema_array_subscript_offset(
+	const ofc_sema_array_t* array,
+	const int64_t* subscript,
+	uint64_t* offset)
+{
+	if (!subscript
+		|| !ofc_sema_array_shape_resolve(array))
+		return false;
+
+	uint64_t o = 0;
+	unsigned i;
+	for (i = 0; i < array->dimensions; i++)
+	{
+		const ofc_sema_array_dims_t* seg
+			= &array->segment[i];
+
+		if (subscript[i] < seg->lower)
+			return false;
+
+		uint64_t d = (uint64_t)subscript[i]
+			- (uint64_t)seg->lower;
+		if (d >= seg->extent)
+			return false;
+
+		o += (d * seg->stride);
 	}
 
-	if (total) *total = t;
+	if (offset) *offset = o;
 	return true;
 }
 
+bool ofc_sema_array_offset_subscript(
+	const ofc_sema_array_t* array,
+	uint64_t offset, int64_t* subscript)
+{
+	if (!subscript
+		|| !ofc_sema_array_shape_resolve(array)
+		|| (offset >= array->total))
+		return false;
+
+	unsigned i;
+	for (i = 0; i < array->dimensions; i++)
+	{
+		const ofc_sema_array_dims_t* seg
+			= &array->segment[i];
+
+		subscript[i] = (int64_t)((uint64_t)seg->lower
+			+ (offset % seg->extent));
+		offset /= seg->extent;
+	}
+
+	return true;
+}
+
+bool ofc_sema_array_subscript_print(
+	ofc_colstr_t* cs,
+	const ofc_sema_array_t* array,
+	const int64_t* subscript)
+{
+	if (!cs || !array || !subscript)
+		return false;
+
+	if (!ofc_colstr_atomic_writef(cs, "("))
+		return false;
+
+	unsigned i;
+	for (i = 0; i < array->dimensions; i++)
+	{
+		if (i > 0)
+		{
+			if (!ofc_colstr_atomic_writef(cs, ",")
+				|| !ofc_colstr_atomic_writef(cs, " "))
+				return false;
+		}
+
+		if (!ofc_colstr_atomic_writef(cs, "%lld",
+			(long long)subscript[i]))
+			return false;
+	}
+
+	return ofc_colstr_atomic_writef(cs, ")");
+}
+
 bool ofc_sema_array_print(
 	ofc_colstr_t* cs,
 	const ofc_sema_array_t* array)
@@ -409,7 +565,7 @@ ofc_sema_array_index_t* ofc_sema_array_index(
 	}
 
 	ofc_sema_array_index_t* ai
-		= (ofc_sema_array_index_t*)malloc(sizeof(ofc_sema_array_index_t)
+		= (ofc_sema_array_index_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_index_t)
 			+ (index->count * sizeof(ofc_sema_expr_t*)));
 	if (!ai) return NULL;
 
@@ -525,7 +681,7 @@ ofc_sema_array_index_t* ofc_sema_array_index_copy_replace(
 		return NULL;
 
 	ofc_sema_array_index_t* copy
-		= (ofc_sema_array_index_t*)malloc(
+		= (ofc_sema_array_index_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_array_index_t)
 			+ (index->dimensions * sizeof(ofc_sema_expr_t*)));
 	if (!copy) return NULL;
@@ -568,7 +724,7 @@ void ofc_sema_array_index_delete(
 	for (i = 0; i < index->dimensions; i++)
 		ofc_sema_expr_delete(index->index[i]);
 
-	free(index);
+	ofc_free(index);
 }
 
 
@@ -578,50 +734,28 @@ ofc_sema_array_index_t* ofc_sema_array_index_from_offset(
 	if (!ofc_sema_decl_is_array(decl))
 		return NULL;
 
-	ofc_sema_array_t* array
+	const ofc_sema_array_t* array
 		= decl->array;
 	if (!array) return NULL;
 
-	int      first[array->dimensions];
-	unsigned count[array->dimensions];
-
-	unsigned i;
-	for (i = 0; i < array->dimensions; i++)
-	{
-		first[i] = 1;
-		if (array->segment[i].first
-			&& !ofc_sema_expr_resolve_int(
-				array->segment[i].first, &first[i]))
-			return NULL;
-
-		int last;
-		if (!ofc_sema_expr_resolve_int(
-			array->segment[i].last, &last))
-			return NULL;
-
-		if (last < first[i])
-			return NULL;
-
-		count[i] = ((last + 1) - first[i]);
-	}
-
-	int idx[array->dimensions];
-	for (i = 0; i < array->dimensions; i++)
-	{
-		idx[i] = first[i] + (offset % count[i]);
-		offset /= count[i];
-	}
+	int64_t idx[array->dimensions];
+	if (!ofc_sema_array_offset_subscript(
+		array, offset, idx))
+		return NULL;
 
 	ofc_sema_array_index_t* index
-		= (ofc_sema_array_index_t*)malloc(sizeof(ofc_sema_array_index_t)
+		= (ofc_sema_array_index_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_index_t)
 				+ (array->dimensions * sizeof(ofc_sema_expr_t*)));
 	if (!index) return NULL;
 
 	bool success = true;
 	index->dimensions = array->dimensions;
+	unsigned i;
 	for (i = 0; i < array->dimensions; i++)
 	{
-		index->index[i] = ofc_sema_expr_integer(idx[i]);
+		int d = idx[i];
+		index->index[i] = (d == idx[i]
+			? ofc_sema_expr_integer(d) : NULL);
 
 		if (!index->index[i])
 			success = false;
@@ -665,57 +799,51 @@ bool ofc_sema_array_index_offset(
 		return false;
 	}
 
-	int64_t o = 0;
-	int64_t s = 1;
+	if (!ofc_sema_array_shape_resolve(array))
+		return false;
+
+	int64_t so[index->dimensions];
 
 	unsigned i;
 	for (i = 0; i < index->dimensions; i++)
 	{
-		const ofc_sema_array_dims_t dims
-			= array->segment[i];
+		const ofc_sema_array_dims_t* dims
+			= &array->segment[i];
 
 		const ofc_sema_expr_t* expr
 			= index->index[i];
 		if (!expr) return false;
 
-		int64_t so;
 		if (!ofc_sema_typeval_get_integer(
-			ofc_sema_expr_constant(expr), &so))
+			ofc_sema_expr_constant(expr), &so[i]))
 		{
 			ofc_sparse_ref_error(expr->src,
 				"Failed to resolve array index");
 			return false;
 		}
 
-		int first = 1;
-		if (dims.first && !ofc_sema_expr_resolve_int(
-			dims.first, &first))
-			return false;
-
-		int last;
-		if (!ofc_sema_expr_resolve_int(
-			dims.last, &last))
-			return false;
-
-		if (so < first)
+		if (so[i] < dims->lower)
 		{
 			ofc_sparse_ref_error(expr->src,
 				"Array index out-of-range, too low");
 			return false;
 		}
-		else if (so > last)
+		else if (((uint64_t)so[i] - (uint64_t)dims->lower)
+			>= dims->extent)
 		{
 			ofc_sparse_ref_error(expr->src,
 				"Array index out-of-range, too high");
 			return false;
 		}
-
-		o += ((so - first) * s);
-		s *= ((last - first) + 1);
 	}
 
+	uint64_t o;
+	if (!ofc_sema_array_subscript_offset(
+		array, so, &o))
+		return false;
+
 	unsigned uo = o;
-	if ((int64_t)uo != o)
+	if (uo != o)
 		return false;
 
 	if (offset) *offset = uo;
@@ -769,7 +897,7 @@ ofc_sema_array_slice_t* ofc_sema_array_slice(
 	}
 
 	ofc_sema_array_slice_t* slice
-		= (ofc_sema_array_slice_t*)malloc(sizeof(ofc_sema_array_slice_t)
+		= (ofc_sema_array_slice_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_slice_t)
 			+ (array->dimensions * sizeof(ofc_sema_array_segment_t)));
 	if (!slice) return NULL;
 
@@ -900,7 +1028,7 @@ ofc_sema_array_slice_t* ofc_sema_array_slice_copy_replace(
 		return NULL;
 
 	ofc_sema_array_slice_t* copy
-		= (ofc_sema_array_slice_t*)malloc(
+		= (ofc_sema_array_slice_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_array_slice_t)
 			+ (slice->dimensions * sizeof(ofc_sema_array_segment_t)));
 	if (!copy) return NULL;
@@ -978,7 +1106,7 @@ void ofc_sema_array_slice_delete(
 			slice->segment[i].stride);
 	}
 
-	free(slice);
+	ofc_free(slice);
 }
 
 bool ofc_sema_array_slice_compare(
@@ -1036,11 +1164,12 @@ ofc_sema_array_t* ofc_sema_array_slice_dims(
 		return NULL;
 
 	ofc_sema_array_t* dims
-		= (ofc_sema_array_t*)malloc(sizeof(ofc_sema_array_t)
+		= (ofc_sema_array_t*)ofc_alloc(OFC_ALLOC_SEMA, sizeof(ofc_sema_array_t)
 			+ (d * sizeof(ofc_sema_array_dims_t)));
 	if (!dims) return NULL;
 
-	dims->dimensions = d;
+	dims->dimensions     = d;
+	dims->shape_resolved = false;
 
 	bool fail = false;
 	unsigned j;
@@ -0,0 +1,818 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ofc/sema.h"
+
+
+static void ofc_sema_call__delete(
+	ofc_sema_call_t* call)
+{
+	if (!call)
+		return;
+
+	ofc_free(call->arg);
+	ofc_free(call);
+}
+
+static const ofc_str_ref_t* ofc_sema_callgraph__node_key(
+	const ofc_sema_callgraph_node_t* node)
+{
+	return (node ? &node->name : NULL);
+}
+
+ofc_sema_callgraph_t* ofc_sema_callgraph_create(
+	bool case_sensitive)
+{
+	ofc_sema_callgraph_t* graph
+		= (ofc_sema_callgraph_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_callgraph_t));
+	if (!graph) return NULL;
+
+	graph->case_sensitive = case_sensitive;
+
+	graph->count = 0;
+	graph->size  = 0;
+	graph->call  = NULL;
+
+	graph->linked     = false;
+	graph->node_count = 0;
+	graph->node       = NULL;
+	graph->node_map   = NULL;
+
+	return graph;
+}
+
+static void ofc_sema_callgraph__unlink(
+	ofc_sema_callgraph_t* graph)
+{
+	ofc_hashmap_delete(graph->node_map);
+	graph->node_map = NULL;
+
+	unsigned i;
+	for (i = 0; i < graph->node_count; i++)
+	{
+		ofc_sema_signature_delete(
+			graph->node[i]->signature);
+		ofc_free(graph->node[i]);
+	}
+	ofc_free(graph->node);
+	graph->node = NULL;
+	graph->node_count = 0;
+
+	graph->linked = false;
+}
+
+void ofc_sema_callgraph_delete(
+	ofc_sema_callgraph_t* graph)
+{
+	if (!graph)
+		return;
+
+	ofc_sema_callgraph__unlink(graph);
+
+	unsigned i;
+	for (i = 0; i < graph->count; i++)
+		ofc_sema_call__delete(graph->call[i]);
+	ofc_free(graph->call);
+
+	ofc_free(graph);
+}
+
+
+static ofc_sema_scope_t* ofc_sema_callgraph__global(
+	ofc_sema_scope_t* scope)
+{
+	while (scope && scope->parent)
+		scope = scope->parent;
+	return scope;
+}
+
+static bool ofc_sema_callgraph__is_dummy(
+	const ofc_sema_scope_t* unit,
+	ofc_str_ref_t name)
+{
+	if (!unit || !unit->args)
+		return false;
+
+	ofc_lang_opts_t opts
+		= ofc_sema_scope_get_lang_opts(unit);
+
+	unsigned i;
+	for (i = 0; i < unit->args->count; i++)
+	{
+		ofc_str_ref_t aname
+			= unit->args->arg[i].name.string;
+		if (opts.case_sensitive
+			? ofc_str_ref_equal(aname, name)
+			: ofc_str_ref_equal_ci(aname, name))
+			return true;
+	}
+
+	return false;
+}
+
+bool ofc_sema_callgraph_add(
+	ofc_sema_scope_t* scope,
+	bool is_function,
+	ofc_sparse_ref_t name,
+	ofc_sparse_ref_t src,
+	const ofc_sema_type_t* type,
+	const ofc_sema_expr_list_t* args)
+{
+	ofc_sema_scope_t* unit
+		= ofc_sema_scope_root(scope);
+	ofc_sema_scope_t* global
+		= ofc_sema_callgraph__global(scope);
+	if (!unit || !global)
+		return false;
+
+	/* Calls through dummy procedures can't be resolved statically. */
+	if (ofc_sema_callgraph__is_dummy(unit, name.string))
+		return true;
+
+	if (!global->callgraph)
+	{
+		ofc_lang_opts_t opts
+			= ofc_sema_scope_get_lang_opts(global);
+		global->callgraph = ofc_sema_callgraph_create(
+			opts.case_sensitive);
+		if (!global->callgraph)
+			return false;
+	}
+	ofc_sema_callgraph_t* graph
+		= global->callgraph;
+
+	ofc_sema_call_t* call
+		= (ofc_sema_call_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_call_t));
+	if (!call) return false;
+
+	call->is_function = is_function;
+	call->caller      = unit->name;
+	call->name        = name;
+	call->src         = src;
+	call->type        = type;
+	call->count       = (args ? args->count : 0);
+	call->arg         = NULL;
+	call->caller_node = 0;
+	call->callee_node = 0;
+	call->mismatch    = false;
+
+	if (call->count > 0)
+	{
+		call->arg = (ofc_sema_call_arg_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_call_arg_t) * call->count);
+		if (!call->arg)
+		{
+			ofc_free(call);
+			return false;
+		}
+
+		unsigned i;
+		for (i = 0; i < call->count; i++)
+		{
+			const ofc_sema_expr_t* expr
+				= args->expr[i];
+
+			ofc_sema_call_arg_t* arg
+				= &call->arg[i];
+			arg->name       = OFC_STR_REF_EMPTY;
+			arg->alt_return = (expr
+				&& (expr->type == OFC_SEMA_EXPR_ALT_RETURN));
+			arg->type = (arg->alt_return ? NULL
+				: ofc_sema_expr_type(expr));
+			arg->is_array = (!arg->alt_return
+				&& (ofc_sema_expr_array(expr) != NULL));
+		}
+	}
+
+	if (graph->count >= graph->size)
+	{
+		unsigned nsize = (graph->size > 0
+			? (graph->size << 1) : 64);
+		ofc_sema_call_t** ncall
+			= (ofc_sema_call_t**)ofc_realloc(OFC_ALLOC_SEMA, graph->call,
+				(sizeof(ofc_sema_call_t*) * nsize));
+		if (!ncall)
+		{
+			ofc_sema_call__delete(call);
+			return false;
+		}
+		graph->call = ncall;
+		graph->size = nsize;
+	}
+
+	graph->call[graph->count++] = call;
+	graph->linked = false;
+	return true;
+}
+
+
+static ofc_sema_callgraph_node_t* ofc_sema_callgraph__node(
+	ofc_sema_callgraph_t* graph,
+	ofc_str_ref_t name,
+	const ofc_sema_scope_t* scope)
+{
+	ofc_sema_callgraph_node_t* node
+		= ofc_hashmap_find_modify(
+			graph->node_map, &name);
+	if (node)
+	{
+		if (!node->scope)
+			node->scope = scope;
+		return node;
+	}
+
+	if ((graph->node_count & 63) == 0)
+	{
+		ofc_sema_callgraph_node_t** nnode
+			= (ofc_sema_callgraph_node_t**)ofc_realloc(OFC_ALLOC_SEMA, graph->node,
+				(sizeof(ofc_sema_callgraph_node_t*)
+					* (graph->node_count + 64)));
+		if (!nnode) return NULL;
+		graph->node = nnode;
+	}
+
+	node = (ofc_sema_callgraph_node_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_callgraph_node_t));
+	if (!node) return NULL;
+
+	node->name      = name;
+	node->index     = graph->node_count;
+	node->scope     = scope;
+	node->signature = NULL;
+
+	if (!ofc_hashmap_add(graph->node_map, node))
+	{
+		ofc_free(node);
+		return NULL;
+	}
+
+	graph->node[graph->node_count++] = node;
+	return node;
+}
+
+ofc_sema_signature_t* ofc_sema_signature_create(
+	bool is_function,
+	const ofc_sema_type_t* type,
+	unsigned count)
+{
+	ofc_sema_signature_t* signature
+		= (ofc_sema_signature_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_signature_t));
+	if (!signature) return NULL;
+
+	signature->is_function = is_function;
+	signature->type        = type;
+	signature->count       = count;
+	signature->arg         = NULL;
+
+	if (count > 0)
+	{
+		signature->arg = (ofc_sema_call_arg_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_call_arg_t) * count);
+		if (!signature->arg)
+		{
+			ofc_free(signature);
+			return NULL;
+		}
+
+		unsigned i;
+		for (i = 0; i < count; i++)
+		{
+			signature->arg[i].name       = OFC_STR_REF_EMPTY;
+			signature->arg[i].type       = NULL;
+			signature->arg[i].is_array   = false;
+			signature->arg[i].alt_return = false;
+		}
+	}
+
+	return signature;
+}
+
+ofc_sema_signature_t* ofc_sema_signature(
+	const ofc_sema_scope_t* scope,
+	const ofc_sema_decl_t*  decl)
+{
+	if (!scope)
+		return NULL;
+
+	bool is_function;
+	switch (scope->type)
+	{
+		case OFC_SEMA_SCOPE_SUBROUTINE:
+			is_function = false;
+			break;
+		case OFC_SEMA_SCOPE_FUNCTION:
+			is_function = true;
+			break;
+		default:
+			return NULL;
+	}
+
+	ofc_sema_signature_t* signature
+		= ofc_sema_signature_create(is_function,
+			(is_function ? ofc_sema_decl_base_type(decl) : NULL),
+			(scope->args ? scope->args->count : 0));
+	if (!signature) return NULL;
+
+	unsigned i;
+	for (i = 0; i < signature->count; i++)
+	{
+		const ofc_sema_arg_t* dummy
+			= &scope->args->arg[i];
+		ofc_sema_call_arg_t* arg
+			= &signature->arg[i];
+
+		arg->name       = dummy->name.string;
+		arg->alt_return = dummy->alt_return;
+		if (dummy->alt_return)
+			continue;
+
+		/* Dummy arguments which are never referenced have no decl. */
+		const ofc_sema_decl_t* ddecl
+			= ofc_sema_scope_decl_find(
+				scope, dummy->name.string, true);
+		if (ddecl)
+		{
+			arg->type     = ddecl->type;
+			arg->is_array = (ddecl->array != NULL);
+			continue;
+		}
+
+		const ofc_sema_spec_t* spec
+			= ofc_sema_scope_spec_find_final_cached(
+				scope, dummy->name);
+		if (spec)
+		{
+			arg->type     = ofc_sema_type_spec(spec);
+			arg->is_array = (spec->array != NULL);
+		}
+	}
+
+	return signature;
+}
+
+void ofc_sema_signature_delete(
+	ofc_sema_signature_t* signature)
+{
+	if (!signature)
+		return;
+
+	ofc_free(signature->arg);
+	ofc_free(signature);
+}
+
+
+static bool ofc_sema_callgraph__type_match(
+	const ofc_sema_type_t* actual,
+	const ofc_sema_type_t* dummy)
+{
+	/* Character lengths are passed along with the argument,
+	   and we don't check structure or procedure arguments. */
+	if (!actual || !dummy
+		|| ofc_sema_type_is_procedure(actual)
+		|| ofc_sema_type_is_procedure(dummy)
+		|| (actual->type == OFC_SEMA_TYPE_TYPE)
+		|| (actual->type == OFC_SEMA_TYPE_RECORD)
+		|| (dummy->type == OFC_SEMA_TYPE_TYPE)
+		|| (dummy->type == OFC_SEMA_TYPE_RECORD))
+		return true;
+
+	if (ofc_sema_type_is_character(actual)
+		|| ofc_sema_type_is_character(dummy))
+		return (actual->type == dummy->type);
+
+	return ofc_sema_type_compatible(actual, dummy);
+}
+
+bool ofc_sema_call_check(
+	ofc_sema_call_t* call,
+	const ofc_sema_signature_t* signature,
+	const char* origin)
+{
+	if (!call || !signature)
+		return false;
+
+	ofc_str_ref_t name = call->name.string;
+
+	char where[(origin ? strlen(origin) : 0) + 32];
+	if (origin)
+		snprintf(where, sizeof(where), " (defined in '%s')", origin);
+	else
+		where[0] = '\0';
+
+	if (call->is_function != signature->is_function)
+	{
+		ofc_sparse_ref_warning(call->src,
+			(call->is_function
+				? "SUBROUTINE '%.*s' referenced as a FUNCTION%s"
+				: "CALL to FUNCTION '%.*s'%s"),
+			name.size, name.base, where);
+		call->mismatch = true;
+		return false;
+	}
+
+	bool match = true;
+	if (call->is_function
+		&& !ofc_sema_callgraph__type_match(
+			call->type, signature->type))
+	{
+		ofc_sparse_ref_warning(call->src,
+			"Return type of '%.*s' is %s, but its definition returns %s%s",
+			name.size, name.base,
+			ofc_sema_type_str_rep(call->type),
+			ofc_sema_type_str_rep(signature->type), where);
+		match = false;
+	}
+
+	if (call->count != signature->count)
+	{
+		ofc_sparse_ref_warning(call->src,
+			"Call to '%.*s' passes %u arguments, but it takes %u%s",
+			name.size, name.base, call->count, signature->count, where);
+		call->mismatch = true;
+		return false;
+	}
+
+	unsigned i;
+	for (i = 0; i < signature->count; i++)
+	{
+		const ofc_sema_call_arg_t* dummy
+			= &signature->arg[i];
+		const ofc_sema_call_arg_t* actual
+			= &call->arg[i];
+
+		if (dummy->alt_return != actual->alt_return)
+		{
+			ofc_sparse_ref_warning(call->src,
+				(dummy->alt_return
+					? "Argument %u of '%.*s' must be an alternate return label%s"
+					: "Argument %u of '%.*s' can't be an alternate return label%s"),
+				(i + 1), name.size, name.base, where);
+			match = false;
+		}
+		else if (dummy->alt_return)
+		{
+			continue;
+		}
+		else if (!ofc_sema_callgraph__type_match(
+			actual->type, dummy->type))
+		{
+			ofc_sparse_ref_warning(call->src,
+				"Argument %u of '%.*s' is %s, but '%.*s' is %s%s",
+				(i + 1), name.size, name.base,
+				ofc_sema_type_str_rep(actual->type),
+				dummy->name.size, dummy->name.base,
+				ofc_sema_type_str_rep(dummy->type), where);
+			match = false;
+		}
+		else if (actual->is_array && !dummy->is_array
+			&& !ofc_sema_type_is_procedure(dummy->type))
+		{
+			ofc_sparse_ref_warning(call->src,
+				"Argument %u of '%.*s' is an array, but '%.*s' is scalar%s",
+				(i + 1), name.size, name.base,
+				dummy->name.size, dummy->name.base, where);
+			match = false;
+		}
+	}
+
+	if (!match)
+		call->mismatch = true;
+	return match;
+}
+
+bool ofc_sema_callgraph_link(
+	ofc_sema_callgraph_t* graph,
+	const ofc_sema_scope_t* root)
+{
+	if (!graph || !root)
+		return false;
+
+	ofc_sema_callgraph__unlink(graph);
+
+	graph->node_map = ofc_hashmap_create(
+		(void*)(graph->case_sensitive
+			? ofc_str_ref_ptr_hash
+			: ofc_str_ref_ptr_hash_ci),
+		(void*)(graph->case_sensitive
+			? ofc_str_ref_ptr_equal
+			: ofc_str_ref_ptr_equal_ci),
+		(void*)ofc_sema_callgraph__node_key, NULL);
+	if (!graph->node_map)
+		return false;
+
+	/* Program units first, so node order follows the source. */
+	unsigned i;
+	if (root->child)
+	{
+		for (i = 0; i < root->child->count; i++)
+		{
+			const ofc_sema_scope_t* child
+				= root->child->scope[i];
+			if (!ofc_sema_callgraph__node(
+				graph, child->name, child))
+				return false;
+		}
+	}
+
+	if (root->decl)
+	{
+		for (i = 0; i < root->decl->count; i++)
+		{
+			const ofc_sema_decl_t* decl
+				= root->decl->decl[i];
+			if (!decl->func
+				|| (decl->func->type == OFC_SEMA_SCOPE_STMT_FUNC))
+				continue;
+
+			if (!ofc_sema_callgraph__node(
+				graph, decl->name, decl->func))
+				return false;
+		}
+	}
+
+	for (i = 0; i < graph->count; i++)
+	{
+		ofc_sema_call_t* call = graph->call[i];
+
+		/* Statements outside of any program unit belong to root. */
+		const ofc_sema_callgraph_node_t* caller
+			= ofc_sema_callgraph__node(graph, call->caller,
+				(ofc_str_ref_empty(call->caller) ? root : NULL));
+		if (!caller) return false;
+
+		ofc_sema_callgraph_node_t* callee
+			= ofc_sema_callgraph__node(
+				graph, call->name.string, NULL);
+		if (!callee) return false;
+
+		call->caller_node = caller->index;
+		call->callee_node = callee->index;
+
+		call->mismatch = false;
+		if (!callee->scope)
+			continue;
+
+		if (!callee->signature)
+		{
+			const ofc_sema_decl_t* decl
+				= ofc_sema_scope_decl_find(
+					root, callee->name, true);
+			callee->signature = ofc_sema_signature(
+				callee->scope, decl);
+		}
+
+		if (callee->signature)
+		{
+			ofc_sema_call_check(
+				call, callee->signature, NULL);
+		}
+		else
+		{
+			ofc_sparse_ref_warning(call->src,
+				"Call to '%.*s' which isn't a procedure",
+				call->name.string.size, call->name.string.base);
+			call->mismatch = true;
+		}
+	}
+
+	graph->linked = true;
+	return true;
+}
+
+
+typedef struct
+{
+	unsigned caller, callee;
+	unsigned count;
+	bool     mismatch;
+} ofc_sema_callgraph__edge_t;
+
+static int ofc_sema_callgraph__edge_order(
+	const void* a, const void* b)
+{
+	const ofc_sema_callgraph__edge_t* ea = a;
+	const ofc_sema_callgraph__edge_t* eb = b;
+
+	if (ea->caller != eb->caller)
+		return (ea->caller < eb->caller ? -1 : 1);
+	if (ea->callee != eb->callee)
+		return (ea->callee < eb->callee ? -1 : 1);
+	return 0;
+}
+
+/* Collapses every call between the same pair of nodes into a single edge. */
+static ofc_sema_callgraph__edge_t* ofc_sema_callgraph__edges(
+	const ofc_sema_callgraph_t* graph, unsigned* count)
+{
+	*count = 0;
+	if (graph->count == 0)
+		return NULL;
+
+	ofc_sema_callgraph__edge_t* edge
+		= (ofc_sema_callgraph__edge_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_callgraph__edge_t) * graph->count);
+	if (!edge) return NULL;
+
+	unsigned i;
+	for (i = 0; i < graph->count; i++)
+	{
+		edge[i].caller   = graph->call[i]->caller_node;
+		edge[i].callee   = graph->call[i]->callee_node;
+		edge[i].count    = 1;
+		edge[i].mismatch = graph->call[i]->mismatch;
+	}
+
+	qsort(edge, graph->count,
+		sizeof(ofc_sema_callgraph__edge_t),
+		ofc_sema_callgraph__edge_order);
+
+	unsigned e;
+	for (i = 1, e = 0; i < graph->count; i++)
+	{
+		if (ofc_sema_callgraph__edge_order(
+			&edge[e], &edge[i]) == 0)
+		{
+			edge[e].count++;
+			edge[e].mismatch |= edge[i].mismatch;
+		}
+		else
+		{
+			edge[++e] = edge[i];
+		}
+	}
+
+	*count = (e + 1);
+	return edge;
+}
+
+static FILE* ofc_sema_callgraph__open(int fd)
+{
+	int dfd = dup(fd);
+	if (dfd < 0) return NULL;
+
+	FILE* stream = fdopen(dfd, "w");
+	if (!stream) close(dfd);
+	return stream;
+}
+
+static const char* ofc_sema_callgraph__node_shape(
+	const ofc_sema_callgraph_node_t* node)
+{
+	if (!node->scope)
+		return "box, style=dashed";
+
+	switch (node->scope->type)
+	{
+		case OFC_SEMA_SCOPE_SUBROUTINE:
+			return "box";
+		case OFC_SEMA_SCOPE_FUNCTION:
+			return "ellipse";
+		default:
+			break;
+	}
+
+	return "doubleoctagon";
+}
+
+bool ofc_sema_callgraph_print_dot(
+	const ofc_sema_callgraph_t* graph, int fd)
+{
+	if (!graph || !graph->linked)
+		return false;
+
+	unsigned edge_count;
+	ofc_sema_callgraph__edge_t* edge
+		= ofc_sema_callgraph__edges(graph, &edge_count);
+	if (!edge && (graph->count > 0))
+		return false;
+
+	FILE* stream = ofc_sema_callgraph__open(fd);
+	if (!stream)
+	{
+		ofc_free(edge);
+		return false;
+	}
+
+	fprintf(stream, "digraph callgraph {\n");
+
+	unsigned i;
+	for (i = 0; i < graph->node_count; i++)
+	{
+		const ofc_sema_callgraph_node_t* node
+			= graph->node[i];
+		if (ofc_str_ref_empty(node->name))
+			fprintf(stream, "\tn%u [label=\"(main)\", shape=%s];\n",
+				i, ofc_sema_callgraph__node_shape(node));
+		else
+			fprintf(stream, "\tn%u [label=\"%.*s\", shape=%s];\n",
+				i, node->name.size, node->name.base,
+				ofc_sema_callgraph__node_shape(node));
+	}
+
+	for (i = 0; i < edge_count; i++)
+	{
+		fprintf(stream, "\tn%u -> n%u", edge[i].caller, edge[i].callee);
+		if (edge[i].count > 1)
+			fprintf(stream, " [label=\"%u\"%s]", edge[i].count,
+				(edge[i].mismatch ? ", color=red" : ""));
+		else if (edge[i].mismatch)
+			fprintf(stream, " [color=red]");
+		fprintf(stream, ";\n");
+	}
+
+	fprintf(stream, "}\n");
+	ofc_free(edge);
+
+	bool success = !ferror(stream);
+	return ((fclose(stream) == 0) && success);
+}
+
+
+static void ofc_sema_callgraph__put(
+	FILE* stream, uint32_t value, unsigned size)
+{
+	unsigned i;
+	for (i = 0; i < size; i++)
+		fputc(((value >> (i * 8)) & 0xFF), stream);
+}
+
+static uint8_t ofc_sema_callgraph__node_kind(
+	const ofc_sema_callgraph_node_t* node)
+{
+	/* Zero is reserved for external procedures. */
+	return (node->scope ? (node->scope->type + 1) : 0);
+}
+
+bool ofc_sema_callgraph_write(
+	const ofc_sema_callgraph_t* graph, int fd)
+{
+	if (!graph || !graph->linked)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < graph->node_count; i++)
+	{
+		if (graph->node[i]->name.size > 0xFFFF)
+			return false;
+	}
+
+	unsigned edge_count;
+	ofc_sema_callgraph__edge_t* edge
+		= ofc_sema_callgraph__edges(graph, &edge_count);
+	if (!edge && (graph->count > 0))
+		return false;
+
+	FILE* stream = ofc_sema_callgraph__open(fd);
+	if (!stream)
+	{
+		ofc_free(edge);
+		return false;
+	}
+
+	fwrite("OFCG", 1, 4, stream);
+	ofc_sema_callgraph__put(stream, 1, 4);
+	ofc_sema_callgraph__put(stream, graph->node_count, 4);
+	ofc_sema_callgraph__put(stream, edge_count, 4);
+
+	for (i = 0; i < graph->node_count; i++)
+	{
+		const ofc_sema_callgraph_node_t* node
+			= graph->node[i];
+		ofc_sema_callgraph__put(stream,
+			ofc_sema_callgraph__node_kind(node), 1);
+		ofc_sema_callgraph__put(stream, node->name.size, 2);
+		fwrite(node->name.base, 1, node->name.size, stream);
+	}
+
+	for (i = 0; i < edge_count; i++)
+	{
+		ofc_sema_callgraph__put(stream, edge[i].caller, 4);
+		ofc_sema_callgraph__put(stream, edge[i].callee, 4);
+		ofc_sema_callgraph__put(stream, edge[i].count , 4);
+		ofc_sema_callgraph__put(stream, (edge[i].mismatch ? 1 : 0), 1);
+	}
+
+	ofc_free(edge);
+
+	bool success = !ferror(stream);
+	return ((fclose(stream) == 0) && success);
+}
@@ -20,7 +20,7 @@ ofc_sema_common_t* ofc_sema_common_create(
 	ofc_str_ref_t name)
 {
 	ofc_sema_common_t* common
-		= (ofc_sema_common_t*)malloc(
+		= (ofc_sema_common_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_common_t));
 	if (!common) return NULL;
 
@@ -39,9 +39,9 @@ void ofc_sema_common_delete(
 	if (!common)
 		return;
 
-	free(common->decl);
-	free(common->spec);
-	free(common);
+	ofc_free(common->decl);
+	ofc_free(common->spec);
+	ofc_free(common);
 }
 
 bool ofc_sema_common_add(
@@ -52,13 +52,13 @@ bool ofc_sema_common_add(
 		return false;
 
 	const ofc_sema_decl_t** ndecl
-		= (const ofc_sema_decl_t**)realloc(common->decl,
+		= (const ofc_sema_decl_t**)ofc_realloc(OFC_ALLOC_SEMA, common->decl,
 			sizeof(const ofc_sema_decl_t*) * (common->count + 1));
 	if (!ndecl) return false;
 	common->decl = ndecl;
 
 	ofc_sema_spec_t** nspec
-		= realloc(common->spec,
+		= ofc_realloc(OFC_ALLOC_SEMA, common->spec,
 			sizeof(const ofc_sema_spec_t*) * (common->count + 1));
 	if (!nspec) return false;
 	common->spec = nspec;
@@ -156,7 +156,7 @@ ofc_sema_common_map_t* ofc_sema_common_map_create(
 	bool case_sensitive)
 {
 	ofc_sema_common_map_t* map
-		= (ofc_sema_common_map_t*)malloc(
+		= (ofc_sema_common_map_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_common_map_t));
 	if (!map) return NULL;
 
@@ -171,7 +171,7 @@ ofc_sema_common_map_t* ofc_sema_common_map_create(
 
 	if (!map->map)
 	{
-		free(map);
+		ofc_free(map);
 		return NULL;
 	}
 
@@ -190,10 +190,10 @@ void ofc_sema_common_map_delete(
 	unsigned i;
 	for (i = 0; i < map->count; i++)
 		ofc_sema_common_delete(map->common[i]);
-	free(map->common);
+	ofc_free(map->common);
 
 	ofc_hashmap_delete(map->map);
-	free(map);
+	ofc_free(map);
 }
 
 ofc_sema_common_t* ofc_sema_common_map_find_modify(
@@ -217,7 +217,7 @@ bool ofc_sema_common_map_add(
 		return false;
 
 	ofc_sema_common_t** ncommon
-		= (ofc_sema_common_t**)realloc(map->common,
+		= (ofc_sema_common_t**)ofc_realloc(OFC_ALLOC_SEMA, map->common,
 			(sizeof(ofc_sema_common_t*) * (map->count + 1)));
 	if (!ncommon) return false;
 	map->common = ncommon;
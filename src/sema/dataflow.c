@@ -0,0 +1,1957 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ofc/sema.h"
+
+
+/* Only local scalars which can't be seen or aliased from outside the
+   program unit are tracked, they're numbered densely in order of their
+   decl's address so that they can be found with a binary search.
+
+   Each statement is a node holding the references it makes in the order
+   they happen, DO loops get an extra node for the increment. Nodes are
+   grouped into basic blocks and each block has packed bit vectors of the
+   variables it sets and uses, these are iterated to a fixed point in
+   reverse post-order, forwards for variables which may be unset and
+   backwards for live variables. The warnings come from a final pass over
+   the references in each reachable block. */
+
+typedef enum
+{
+	OFC_SEMA_DATAFLOW__USE = 0,
+	/* Passed by reference, so it may be used or set. */
+	OFC_SEMA_DATAFLOW__USE_ARG,
+	OFC_SEMA_DATAFLOW__SET,
+	/* Set by a DO loop, input or a specifier, never a dead store. */
+	OFC_SEMA_DATAFLOW__SET_QUIET,
+	/* Set in part or possibly set, it doesn't end the previous value. */
+	OFC_SEMA_DATAFLOW__SET_MAY,
+} ofc_sema_dataflow__ref_e;
+
+typedef struct
+{
+	unsigned                 var;
+	ofc_sema_dataflow__ref_e type;
+	const ofc_sparse_ref_t*  src;
+} ofc_sema_dataflow__ref_t;
+
+typedef struct
+{
+	const ofc_sema_stmt_t* stmt;
+
+	unsigned ref_first, ref_count;
+	unsigned succ_first, succ_count;
+	unsigned pred_count;
+
+	/* Where the END IF of an IF block goes. */
+	unsigned join;
+
+	unsigned block;
+} ofc_sema_dataflow__node_t;
+
+typedef struct
+{
+	unsigned node_first, node_count;
+	unsigned succ_first, succ_count;
+	unsigned pred_first, pred_count;
+	bool     reachable;
+} ofc_sema_dataflow__block_t;
+
+typedef struct
+{
+	const void* key;
+	unsigned    value;
+} ofc_sema_dataflow__pair_t;
+
+typedef struct
+{
+	const ofc_sema_scope_t* scope;
+
+	unsigned                var_count;
+	const ofc_sema_decl_t** var;
+	unsigned*               var_reads;
+	bool*                   var_result;
+
+	unsigned                   node_count, node_max;
+	ofc_sema_dataflow__node_t* node;
+
+	unsigned                  ref_count, ref_max;
+	ofc_sema_dataflow__ref_t* ref;
+
+	/* Edges are pairs until they're sorted into succ. */
+	unsigned                   edge_count, edge_max;
+	ofc_sema_dataflow__pair_t* edge;
+	unsigned*                  succ;
+
+	/* Label edges are resolved once every IF block has a join. */
+	unsigned                   label_edge_count, label_edge_max;
+	ofc_sema_dataflow__pair_t* label_edge;
+
+	unsigned                   stmt_count, stmt_max;
+	ofc_sema_dataflow__pair_t* stmt;
+
+	unsigned  assign_count, assign_max;
+	unsigned* assign;
+
+	unsigned  entry_count, entry_max;
+	unsigned* entry;
+
+	/* Set while walking a statement function body, so that
+	   references are reported where the function's called. */
+	const ofc_sparse_ref_t* src_call;
+
+	unsigned                    block_count;
+	ofc_sema_dataflow__block_t* block;
+	unsigned*                   block_node;
+	unsigned*                   block_succ;
+	unsigned*                   block_pred;
+	unsigned*                   order;
+	unsigned                    order_count;
+
+	unsigned  words;
+	uint64_t* set_any;
+	uint64_t* unset_out;
+	uint64_t* live_use;
+	uint64_t* live_set;
+	uint64_t* live_in;
+} ofc_sema_dataflow__t;
+
+#define OFC_SEMA_DATAFLOW__ENTRY 0
+#define OFC_SEMA_DATAFLOW__EXIT  1
+
+
+static bool ofc_sema_dataflow__grow(
+	void** base, unsigned* max,
+	unsigned count, size_t size)
+{
+	if (count < *max)
+		return true;
+
+	unsigned nmax = (*max == 0 ? 16 : (*max << 1));
+	void* nbase = ofc_realloc(OFC_ALLOC_SEMA,
+		*base, (nmax * size));
+	if (!nbase) return false;
+
+	*base = nbase;
+	*max  = nmax;
+	return true;
+}
+
+static bool ofc_sema_dataflow__pair_add(
+	ofc_sema_dataflow__pair_t** pair,
+	unsigned* count, unsigned* max,
+	const void* key, unsigned value)
+{
+	if (!ofc_sema_dataflow__grow((void**)pair,
+		max, *count, sizeof(ofc_sema_dataflow__pair_t)))
+		return false;
+
+	(*pair)[*count].key   = key;
+	(*pair)[*count].value = value;
+	(*count)++;
+	return true;
+}
+
+static bool ofc_sema_dataflow__uint_add(
+	unsigned** list, unsigned* count, unsigned* max,
+	unsigned value)
+{
+	if (!ofc_sema_dataflow__grow((void**)list,
+		max, *count, sizeof(unsigned)))
+		return false;
+
+	(*list)[(*count)++] = value;
+	return true;
+}
+
+static int ofc_sema_dataflow__pair_order(
+	const void* a, const void* b)
+{
+	uintptr_t ka = (uintptr_t)((const ofc_sema_dataflow__pair_t*)a)->key;
+	uintptr_t kb = (uintptr_t)((const ofc_sema_dataflow__pair_t*)b)->key;
+	if (ka != kb)
+		return (ka < kb ? -1 : 1);
+
+	unsigned va = ((const ofc_sema_dataflow__pair_t*)a)->value;
+	unsigned vb = ((const ofc_sema_dataflow__pair_t*)b)->value;
+	return (va < vb ? -1 : (va > vb));
+}
+
+static int ofc_sema_dataflow__ptr_order(
+	const void* a, const void* b)
+{
+	uintptr_t pa = (uintptr_t)*(const void* const*)a;
+	uintptr_t pb = (uintptr_t)*(const void* const*)b;
+	return (pa < pb ? -1 : (pa > pb));
+}
+
+static unsigned ofc_sema_dataflow__var_find(
+	const ofc_sema_dataflow__t* df,
+	const ofc_sema_decl_t* decl)
+{
+	unsigned lo = 0, hi = df->var_count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) >> 1);
+		if (df->var[mid] == decl)
+			return mid;
+		if ((uintptr_t)df->var[mid] < (uintptr_t)decl)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return df->var_count;
+}
+
+static unsigned ofc_sema_dataflow__stmt_node(
+	const ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_t* stmt)
+{
+	unsigned lo = 0, hi = df->stmt_count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) >> 1);
+		if (df->stmt[mid].key == stmt)
+			return df->stmt[mid].value;
+		if ((uintptr_t)df->stmt[mid].key < (uintptr_t)stmt)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return OFC_SEMA_DATAFLOW__EXIT;
+}
+
+
+static bool ofc_sema_dataflow__is_local(
+	const ofc_sema_decl_t* decl)
+{
+	if (!decl || !decl->type
+		|| (decl->type->type > OFC_SEMA_TYPE_CHARACTER))
+		return false;
+
+	return (!decl->func && !decl->is_parameter
+		&& !decl->is_static && !decl->is_volatile
+		&& !decl->is_intrinsic && !decl->is_external
+		&& !decl->is_target && !decl->equiv
+		&& !ofc_sema_decl_is_composite(decl)
+		&& !ofc_sema_decl_is_procedure(decl)
+		&& !ofc_sema_decl_has_initializer(decl, NULL));
+}
+
+static bool ofc_sema_dataflow__exclude_name(
+	const ofc_sema_dataflow__t* df, bool* exclude,
+	const ofc_sema_arg_list_t* args)
+{
+	if (!args)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < args->count; i++)
+	{
+		if (args->arg[i].alt_return)
+			continue;
+
+		const ofc_sema_decl_t* decl = ofc_sema_decl_list_find(
+			df->scope->decl, args->arg[i].name.string);
+		unsigned v = ofc_sema_dataflow__var_find(df, decl);
+		if (v < df->var_count) exclude[v] = true;
+	}
+	return true;
+}
+
+static void ofc_sema_dataflow__exclude_entry(
+	const ofc_sema_dataflow__t* df, bool* exclude,
+	const ofc_sema_stmt_list_t* list)
+{
+	if (!list)
+		return;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		const ofc_sema_stmt_t* stmt = list->stmt[i];
+		switch (stmt->type)
+		{
+			case OFC_SEMA_STMT_ENTRY:
+				ofc_sema_dataflow__exclude_name(
+					df, exclude, stmt->entry.args);
+				break;
+			case OFC_SEMA_STMT_IF_THEN:
+				ofc_sema_dataflow__exclude_entry(
+					df, exclude, stmt->if_then.block_then);
+				ofc_sema_dataflow__exclude_entry(
+					df, exclude, stmt->if_then.block_else);
+				break;
+			case OFC_SEMA_STMT_DO_BLOCK:
+				ofc_sema_dataflow__exclude_entry(
+					df, exclude, stmt->do_block.block);
+				break;
+			case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+				ofc_sema_dataflow__exclude_entry(
+					df, exclude, stmt->do_while_block.block);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/* Numbers the local scalars of the scope. */
+static bool ofc_sema_dataflow__vars(
+	ofc_sema_dataflow__t* df)
+{
+	const ofc_sema_decl_list_t* decl = df->scope->decl;
+	if (!decl || (decl->count == 0))
+		return true;
+
+	df->var = (const ofc_sema_decl_t**)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(const ofc_sema_decl_t*) * decl->count);
+	if (!df->var) return false;
+
+	unsigned i;
+	for (i = 0; i < decl->count; i++)
+	{
+		if (ofc_sema_dataflow__is_local(decl->decl[i]))
+			df->var[df->var_count++] = decl->decl[i];
+	}
+	if (df->var_count == 0)
+		return true;
+
+	qsort(df->var, df->var_count,
+		sizeof(const ofc_sema_decl_t*),
+		ofc_sema_dataflow__ptr_order);
+
+	/* Arguments and COMMON can be seen by other program units,
+	   EQUIVALENCE lets other names read and write the storage. */
+	bool exclude[df->var_count];
+	memset(exclude, 0x00, sizeof(exclude));
+
+	ofc_sema_dataflow__exclude_name(
+		df, exclude, df->scope->args);
+	ofc_sema_dataflow__exclude_entry(
+		df, exclude, df->scope->stmt);
+
+	const ofc_sema_common_map_t* common = df->scope->common;
+	if (common)
+	{
+		for (i = 0; i < common->count; i++)
+		{
+			const ofc_sema_common_t* block = common->common[i];
+			if (!block) continue;
+
+			unsigned j;
+			for (j = 0; j < block->count; j++)
+			{
+				unsigned v = ofc_sema_dataflow__var_find(
+					df, block->decl[j]);
+				if (v < df->var_count) exclude[v] = true;
+			}
+		}
+	}
+
+	const ofc_sema_equiv_list_t* equiv = df->scope->equiv;
+	if (equiv)
+	{
+		for (i = 0; i < equiv->count; i++)
+		{
+			const ofc_sema_equiv_t* e = equiv->equiv[i];
+			if (!e) continue;
+
+			unsigned j;
+			for (j = 0; j < e->count; j++)
+			{
+				unsigned v = ofc_sema_dataflow__var_find(
+					df, ofc_sema_lhs_decl(e->lhs[j]));
+				if (v < df->var_count) exclude[v] = true;
+			}
+		}
+	}
+
+	unsigned count = 0;
+	for (i = 0; i < df->var_count; i++)
+	{
+		if (!exclude[i])
+			df->var[count++] = df->var[i];
+	}
+	df->var_count = count;
+	if (count == 0)
+		return true;
+
+	df->var_reads = (unsigned*)ofc_calloc(
+		OFC_ALLOC_SEMA, count, sizeof(unsigned));
+	df->var_result = (bool*)ofc_calloc(
+		OFC_ALLOC_SEMA, count, sizeof(bool));
+	if (!df->var_reads || !df->var_result)
+		return false;
+
+	/* A FUNCTION's result is used by the caller once we return. */
+	for (i = 0; i < count; i++)
+		df->var_result[i] = df->var[i]->is_return;
+
+	return true;
+}
+
+
+static unsigned ofc_sema_dataflow__node_add(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_t* stmt)
+{
+	if (!ofc_sema_dataflow__grow((void**)&df->node,
+		&df->node_max, df->node_count,
+		sizeof(ofc_sema_dataflow__node_t)))
+		return 0;
+
+	ofc_sema_dataflow__node_t* node
+		= &df->node[df->node_count];
+	node->stmt       = stmt;
+	node->ref_first  = df->ref_count;
+	node->ref_count  = 0;
+	node->succ_first = 0;
+	node->succ_count = 0;
+	node->pred_count = 0;
+	node->join       = OFC_SEMA_DATAFLOW__EXIT;
+	node->block      = 0;
+
+	if (stmt && !ofc_sema_dataflow__pair_add(
+		&df->stmt, &df->stmt_count, &df->stmt_max,
+		stmt, df->node_count))
+		return 0;
+
+	return df->node_count++;
+}
+
+static bool ofc_sema_dataflow__ref(
+	ofc_sema_dataflow__t* df,
+	ofc_sema_dataflow__ref_e type,
+	const ofc_sema_decl_t* decl,
+	const ofc_sparse_ref_t* src)
+{
+	unsigned var = ofc_sema_dataflow__var_find(df, decl);
+	if (var >= df->var_count)
+		return true;
+
+	if (!ofc_sema_dataflow__grow((void**)&df->ref,
+		&df->ref_max, df->ref_count,
+		sizeof(ofc_sema_dataflow__ref_t)))
+		return false;
+
+	ofc_sema_dataflow__ref_t* ref
+		= &df->ref[df->ref_count++];
+	ref->var  = var;
+	ref->type = type;
+	ref->src  = (df->src_call ? df->src_call : src);
+
+	df->node[df->node_count - 1].ref_count++;
+
+	if ((type == OFC_SEMA_DATAFLOW__USE)
+		|| (type == OFC_SEMA_DATAFLOW__USE_ARG))
+		df->var_reads[var]++;
+	return true;
+}
+
+
+static bool ofc_sema_dataflow__expr(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_t* expr);
+
+static bool ofc_sema_dataflow__expr_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_dataflow__expr(
+			df, list->expr[i]))
+			return false;
+	}
+	return true;
+}
+
+/* Uses the expressions inside an lhs, but not the lhs itself. */
+static bool ofc_sema_dataflow__lhs_index(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_lhs_t* lhs)
+{
+	unsigned i;
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+			if (lhs->index)
+			{
+				for (i = 0; i < lhs->index->dimensions; i++)
+				{
+					if (!ofc_sema_dataflow__expr(
+						df, lhs->index->index[i]))
+						return false;
+				}
+			}
+			break;
+
+		case OFC_SEMA_LHS_ARRAY_SLICE:
+			if (lhs->slice.slice)
+			{
+				for (i = 0; i < lhs->slice.slice->dimensions; i++)
+				{
+					const ofc_sema_array_segment_t* segment
+						= &lhs->slice.slice->segment[i];
+					if (!ofc_sema_dataflow__expr(df, segment->first)
+						|| !ofc_sema_dataflow__expr(df, segment->last)
+						|| !ofc_sema_dataflow__expr(df, segment->stride))
+						return false;
+				}
+			}
+			break;
+
+		case OFC_SEMA_LHS_SUBSTRING:
+			return (ofc_sema_dataflow__expr(df, lhs->substring.first)
+				&& ofc_sema_dataflow__expr(df, lhs->substring.last));
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_dataflow__lhs_set(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_lhs_t* lhs,
+	ofc_sema_dataflow__ref_e type);
+
+static bool ofc_sema_dataflow__lhs_use(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_lhs_t* lhs,
+	ofc_sema_dataflow__ref_e type)
+{
+	if (!lhs)
+		return true;
+
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			return ofc_sema_dataflow__ref(
+				df, type, lhs->decl, &lhs->src);
+
+		case OFC_SEMA_LHS_IMPLICIT_DO:
+			return ofc_sema_dataflow__lhs_set(
+				df, lhs, OFC_SEMA_DATAFLOW__SET_QUIET);
+
+		default:
+			break;
+	}
+
+	return (ofc_sema_dataflow__lhs_index(df, lhs)
+		&& ofc_sema_dataflow__lhs_use(df, lhs->parent, type));
+}
+
+static bool ofc_sema_dataflow__lhs_set(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_lhs_t* lhs,
+	ofc_sema_dataflow__ref_e type)
+{
+	if (!lhs)
+		return true;
+
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			return ofc_sema_dataflow__ref(
+				df, type, lhs->decl, &lhs->src);
+
+		case OFC_SEMA_LHS_IMPLICIT_DO:
+			return (ofc_sema_dataflow__expr(df, lhs->implicit_do.init)
+				&& ofc_sema_dataflow__expr(df, lhs->implicit_do.last)
+				&& ofc_sema_dataflow__expr(df, lhs->implicit_do.step)
+				&& ofc_sema_dataflow__ref(df, OFC_SEMA_DATAFLOW__SET_QUIET,
+					lhs->implicit_do.iter, &lhs->src)
+				&& ofc_sema_dataflow__lhs_set(df, lhs->implicit_do.lhs, type));
+
+		default:
+			break;
+	}
+
+	/* Setting an element, substring or member leaves the rest. */
+	return (ofc_sema_dataflow__lhs_index(df, lhs)
+		&& ofc_sema_dataflow__lhs_set(df, lhs->parent,
+			OFC_SEMA_DATAFLOW__SET_MAY));
+}
+
+/* Arguments are passed by reference, so a variable argument may be used
+   and set by the callee, anything else is only used. */
+static bool ofc_sema_dataflow__arg_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_list_t* args)
+{
+	if (!args)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < args->count; i++)
+	{
+		const ofc_sema_expr_t* arg = args->expr[i];
+		if (!arg) continue;
+
+		if (arg->type == OFC_SEMA_EXPR_ALT_RETURN)
+			continue;
+
+		if (arg->type != OFC_SEMA_EXPR_LHS)
+		{
+			if (!ofc_sema_dataflow__expr(df, arg))
+				return false;
+			continue;
+		}
+
+		const ofc_sema_lhs_t* root = arg->lhs;
+		while (root && (root->type != OFC_SEMA_LHS_DECL)
+			&& (root->type != OFC_SEMA_LHS_IMPLICIT_DO))
+			root = root->parent;
+
+		if (!ofc_sema_dataflow__lhs_use(df, arg->lhs,
+				OFC_SEMA_DATAFLOW__USE_ARG)
+			|| (root && (root->type == OFC_SEMA_LHS_DECL)
+				&& !ofc_sema_dataflow__ref(df, OFC_SEMA_DATAFLOW__SET_MAY,
+					root->decl, &root->src)))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_dataflow__expr(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_t* expr)
+{
+	if (!expr)
+		return true;
+
+	switch (expr->type)
+	{
+		case OFC_SEMA_EXPR_CONSTANT:
+		case OFC_SEMA_EXPR_ALT_RETURN:
+		case OFC_SEMA_EXPR_COUNT:
+			break;
+
+		case OFC_SEMA_EXPR_LHS:
+			return ofc_sema_dataflow__lhs_use(
+				df, expr->lhs, OFC_SEMA_DATAFLOW__USE);
+
+		case OFC_SEMA_EXPR_CAST:
+			return ofc_sema_dataflow__expr(
+				df, expr->cast.expr);
+
+		case OFC_SEMA_EXPR_INTRINSIC:
+			return ofc_sema_dataflow__expr_list(
+				df, expr->args);
+
+		case OFC_SEMA_EXPR_FUNCTION:
+			if (!ofc_sema_dataflow__arg_list(df, expr->args))
+				return false;
+
+			/* A statement function uses whatever its body uses. */
+			if (expr->function && expr->function->func
+				&& (expr->function->func->type == OFC_SEMA_SCOPE_STMT_FUNC)
+				&& !df->src_call)
+			{
+				df->src_call = &expr->src;
+				bool success = ofc_sema_dataflow__expr(
+					df, expr->function->func->expr);
+				df->src_call = NULL;
+				return success;
+			}
+			break;
+
+		case OFC_SEMA_EXPR_IMPLICIT_DO:
+			return (ofc_sema_dataflow__expr(df, expr->implicit_do.init)
+				&& ofc_sema_dataflow__expr(df, expr->implicit_do.last)
+				&& ofc_sema_dataflow__expr(df, expr->implicit_do.step)
+				&& ofc_sema_dataflow__ref(df, OFC_SEMA_DATAFLOW__SET_QUIET,
+					expr->implicit_do.iter, &expr->src)
+				&& ofc_sema_dataflow__expr(df, expr->implicit_do.expr));
+
+		case OFC_SEMA_EXPR_NEGATE:
+		case OFC_SEMA_EXPR_NOT:
+			return ofc_sema_dataflow__expr(df, expr->a);
+
+		default:
+			return (ofc_sema_dataflow__expr(df, expr->a)
+				&& ofc_sema_dataflow__expr(df, expr->b));
+	}
+
+	return true;
+}
+
+/* Specifiers like IOSTAT= are set by the statement. */
+static bool ofc_sema_dataflow__expr_set(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_t* expr)
+{
+	if (!expr)
+		return true;
+
+	if (expr->type != OFC_SEMA_EXPR_LHS)
+		return ofc_sema_dataflow__expr(df, expr);
+
+	return ofc_sema_dataflow__lhs_set(
+		df, expr->lhs, OFC_SEMA_DATAFLOW__SET_QUIET);
+}
+
+/* Writing to an internal file sets it, otherwise the unit is used. */
+static bool ofc_sema_dataflow__unit(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_expr_t* unit, bool write)
+{
+	if (!unit)
+		return true;
+
+	const ofc_sema_type_t* type
+		= ofc_sema_expr_type(unit);
+	if (write && type
+		&& (type->type == OFC_SEMA_TYPE_CHARACTER))
+		return ofc_sema_dataflow__expr_set(df, unit);
+
+	return ofc_sema_dataflow__expr(df, unit);
+}
+
+static bool ofc_sema_dataflow__lhs_list_set(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_lhs_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_dataflow__lhs_set(df, list->lhs[i],
+			OFC_SEMA_DATAFLOW__SET_QUIET))
+			return false;
+	}
+	return true;
+}
+
+static bool ofc_sema_dataflow__stmt_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_list_t* list);
+
+/* Creates the nodes for a statement and records their references. */
+static bool ofc_sema_dataflow__stmt(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_t* stmt)
+{
+	unsigned node = ofc_sema_dataflow__node_add(df, stmt);
+	if (node == 0) return false;
+
+	switch (stmt->type)
+	{
+		case OFC_SEMA_STMT_ASSIGNMENT:
+			return (ofc_sema_dataflow__expr(df, stmt->assignment.expr)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->assignment.dest,
+					OFC_SEMA_DATAFLOW__SET));
+
+		case OFC_SEMA_STMT_ASSIGN:
+			return (ofc_sema_dataflow__uint_add(&df->assign,
+					&df->assign_count, &df->assign_max, stmt->assign.label)
+				&& ofc_sema_dataflow__ref(df, OFC_SEMA_DATAFLOW__SET,
+					stmt->assign.dest, &stmt->src));
+
+		case OFC_SEMA_STMT_IO_WRITE:
+			return (ofc_sema_dataflow__expr(df, stmt->io_write.format_expr)
+				&& ofc_sema_dataflow__expr(df, stmt->io_write.rec)
+				&& ofc_sema_dataflow__expr(df, stmt->io_write.advance)
+				&& ofc_sema_dataflow__expr_list(df, stmt->io_write.iolist)
+				&& ofc_sema_dataflow__unit(df, stmt->io_write.unit, true)
+				&& ofc_sema_dataflow__expr_set(df, stmt->io_write.iostat));
+
+		case OFC_SEMA_STMT_IO_READ:
+			return (ofc_sema_dataflow__unit(df, stmt->io_read.unit, false)
+				&& ofc_sema_dataflow__expr(df, stmt->io_read.format_expr)
+				&& ofc_sema_dataflow__expr(df, stmt->io_read.rec)
+				&& ofc_sema_dataflow__expr(df, stmt->io_read.advance)
+				&& ofc_sema_dataflow__lhs_list_set(df, stmt->io_read.iolist)
+				&& ofc_sema_dataflow__expr_set(df, stmt->io_read.iostat)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->io_read.size,
+					OFC_SEMA_DATAFLOW__SET_QUIET));
+
+		case OFC_SEMA_STMT_IO_PRINT:
+			return (ofc_sema_dataflow__expr(df, stmt->io_print.format_expr)
+				&& ofc_sema_dataflow__expr_list(df, stmt->io_print.iolist));
+
+		case OFC_SEMA_STMT_IO_REWIND:
+		case OFC_SEMA_STMT_IO_END_FILE:
+		case OFC_SEMA_STMT_IO_BACKSPACE:
+			return (ofc_sema_dataflow__expr(df, stmt->io_position.unit)
+				&& ofc_sema_dataflow__expr_set(df, stmt->io_position.iostat));
+
+		case OFC_SEMA_STMT_IO_OPEN:
+			return (ofc_sema_dataflow__expr(df, stmt->io_open.unit)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.recl)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.access)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.action)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.blank)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.delim)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.file)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.form)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.pad)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.position)
+				&& ofc_sema_dataflow__expr(df, stmt->io_open.status)
+				&& ofc_sema_dataflow__expr_set(df, stmt->io_open.iostat));
+
+		case OFC_SEMA_STMT_IO_CLOSE:
+			return (ofc_sema_dataflow__expr(df, stmt->io_close.unit)
+				&& ofc_sema_dataflow__expr(df, stmt->io_close.status)
+				&& ofc_sema_dataflow__expr_set(df, stmt->io_close.iostat));
+
+		case OFC_SEMA_STMT_IO_INQUIRE:
+			if (!ofc_sema_dataflow__expr(df, stmt->io_inquire.unit)
+				|| !ofc_sema_dataflow__expr(df, stmt->io_inquire.file))
+				return false;
+			{
+				const ofc_sema_lhs_t* spec[] =
+				{
+					stmt->io_inquire.access,
+					stmt->io_inquire.action,
+					stmt->io_inquire.blank,
+					stmt->io_inquire.delim,
+					stmt->io_inquire.direct,
+					stmt->io_inquire.exist,
+					stmt->io_inquire.form,
+					stmt->io_inquire.formatted,
+					stmt->io_inquire.iostat,
+					stmt->io_inquire.name,
+					stmt->io_inquire.named,
+					stmt->io_inquire.nextrec,
+					stmt->io_inquire.number,
+					stmt->io_inquire.opened,
+					stmt->io_inquire.pad,
+					stmt->io_inquire.position,
+					stmt->io_inquire.read,
+					stmt->io_inquire.readwrite,
+					stmt->io_inquire.recl,
+					stmt->io_inquire.sequential,
+					stmt->io_inquire.unformatted,
+					stmt->io_inquire.write,
+				};
+				unsigned i;
+				for (i = 0; i < (sizeof(spec) / sizeof(spec[0])); i++)
+				{
+					if (!ofc_sema_dataflow__lhs_set(df, spec[i],
+						OFC_SEMA_DATAFLOW__SET_QUIET))
+						return false;
+				}
+			}
+			break;
+
+		case OFC_SEMA_STMT_IF_COMPUTED:
+			return ofc_sema_dataflow__expr(
+				df, stmt->if_comp.cond);
+
+		case OFC_SEMA_STMT_IF_STATEMENT:
+			return (ofc_sema_dataflow__expr(df, stmt->if_stmt.cond)
+				&& (!stmt->if_stmt.stmt || ofc_sema_dataflow__stmt(
+					df, stmt->if_stmt.stmt)));
+
+		case OFC_SEMA_STMT_IF_THEN:
+			return (ofc_sema_dataflow__expr(df, stmt->if_then.cond)
+				&& ofc_sema_dataflow__stmt_list(df, stmt->if_then.block_then)
+				&& ofc_sema_dataflow__stmt_list(df, stmt->if_then.block_else));
+
+		case OFC_SEMA_STMT_STOP:
+		case OFC_SEMA_STMT_PAUSE:
+			return ofc_sema_dataflow__expr(
+				df, stmt->stop_pause.str);
+
+		case OFC_SEMA_STMT_GO_TO:
+			return ofc_sema_dataflow__expr(
+				df, stmt->go_to.label);
+
+		case OFC_SEMA_STMT_GO_TO_COMPUTED:
+			return ofc_sema_dataflow__expr(
+				df, stmt->go_to_comp.cond);
+
+		/* The node after a DO is where the variable is incremented. */
+		case OFC_SEMA_STMT_DO_LABEL:
+			return (ofc_sema_dataflow__expr(df, stmt->do_label.init)
+				&& ofc_sema_dataflow__expr(df, stmt->do_label.last)
+				&& ofc_sema_dataflow__expr(df, stmt->do_label.step)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->do_label.iter,
+					OFC_SEMA_DATAFLOW__SET_QUIET)
+				&& (ofc_sema_dataflow__node_add(df, NULL) != 0)
+				&& ofc_sema_dataflow__lhs_use(df, stmt->do_label.iter,
+					OFC_SEMA_DATAFLOW__USE_ARG)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->do_label.iter,
+					OFC_SEMA_DATAFLOW__SET_QUIET));
+
+		case OFC_SEMA_STMT_DO_BLOCK:
+			return (ofc_sema_dataflow__expr(df, stmt->do_block.init)
+				&& ofc_sema_dataflow__expr(df, stmt->do_block.last)
+				&& ofc_sema_dataflow__expr(df, stmt->do_block.step)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->do_block.iter,
+					OFC_SEMA_DATAFLOW__SET_QUIET)
+				&& (ofc_sema_dataflow__node_add(df, NULL) != 0)
+				&& ofc_sema_dataflow__lhs_use(df, stmt->do_block.iter,
+					OFC_SEMA_DATAFLOW__USE_ARG)
+				&& ofc_sema_dataflow__lhs_set(df, stmt->do_block.iter,
+					OFC_SEMA_DATAFLOW__SET_QUIET)
+				&& ofc_sema_dataflow__stmt_list(df, stmt->do_block.block));
+
+		case OFC_SEMA_STMT_DO_WHILE:
+			return ofc_sema_dataflow__expr(
+				df, stmt->do_while.cond);
+
+		case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+			return (ofc_sema_dataflow__expr(df, stmt->do_while_block.cond)
+				&& ofc_sema_dataflow__stmt_list(df, stmt->do_while_block.block));
+
+		case OFC_SEMA_STMT_CALL:
+			return ofc_sema_dataflow__arg_list(
+				df, stmt->call.args);
+
+		case OFC_SEMA_STMT_RETURN:
+			return ofc_sema_dataflow__expr(
+				df, stmt->alt_return);
+
+		case OFC_SEMA_STMT_ENTRY:
+			return ofc_sema_dataflow__uint_add(&df->entry,
+				&df->entry_count, &df->entry_max, node);
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_dataflow__stmt_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_dataflow__stmt(
+			df, list->stmt[i]))
+			return false;
+	}
+	return true;
+}
+
+
+static bool ofc_sema_dataflow__edge(
+	ofc_sema_dataflow__t* df,
+	unsigned from, unsigned to)
+{
+	return ofc_sema_dataflow__pair_add(
+		&df->edge, &df->edge_count, &df->edge_max,
+		(const void*)(uintptr_t)from, to);
+}
+
+static bool ofc_sema_dataflow__edge_label(
+	ofc_sema_dataflow__t* df,
+	unsigned from, const ofc_sema_expr_t* label)
+{
+	unsigned number;
+	if (!label || !ofc_sema_expr_resolve_uint(label, &number))
+		return ofc_sema_dataflow__edge(df, from, OFC_SEMA_DATAFLOW__EXIT);
+
+	return ofc_sema_dataflow__pair_add(
+		&df->label_edge, &df->label_edge_count, &df->label_edge_max,
+		(const void*)(uintptr_t)from, number);
+}
+
+static bool ofc_sema_dataflow__edge_label_list(
+	ofc_sema_dataflow__t* df,
+	unsigned from, const ofc_sema_expr_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_dataflow__edge_label(
+			df, from, list->expr[i]))
+			return false;
+	}
+	return true;
+}
+
+static unsigned ofc_sema_dataflow__first(
+	const ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_list_t* list, unsigned follow)
+{
+	if (!list || (list->count == 0))
+		return follow;
+	return ofc_sema_dataflow__stmt_node(
+		df, list->stmt[0]);
+}
+
+static bool ofc_sema_dataflow__edges_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_list_t* list,
+	unsigned follow);
+
+/* Adds the edges out of a statement's nodes, next is where control goes
+   when the statement completes normally. */
+static bool ofc_sema_dataflow__edges_stmt(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_t* stmt, unsigned next)
+{
+	unsigned node = ofc_sema_dataflow__stmt_node(df, stmt);
+
+	unsigned i, first;
+	switch (stmt->type)
+	{
+		case OFC_SEMA_STMT_IO_WRITE:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_write.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_write.err)));
+
+		case OFC_SEMA_STMT_IO_READ:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_read.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_read.err))
+				&& (!stmt->io_read.end || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_read.end))
+				&& (!stmt->io_read.eor || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_read.eor)));
+
+		case OFC_SEMA_STMT_IO_REWIND:
+		case OFC_SEMA_STMT_IO_END_FILE:
+		case OFC_SEMA_STMT_IO_BACKSPACE:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_position.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_position.err)));
+
+		case OFC_SEMA_STMT_IO_OPEN:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_open.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_open.err)));
+
+		case OFC_SEMA_STMT_IO_CLOSE:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_close.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_close.err)));
+
+		case OFC_SEMA_STMT_IO_INQUIRE:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& (!stmt->io_inquire.err || ofc_sema_dataflow__edge_label(
+					df, node, stmt->io_inquire.err)));
+
+		case OFC_SEMA_STMT_IF_COMPUTED:
+			return ofc_sema_dataflow__edge_label_list(
+				df, node, stmt->if_comp.label);
+
+		case OFC_SEMA_STMT_IF_STATEMENT:
+			if (!stmt->if_stmt.stmt)
+				return ofc_sema_dataflow__edge(df, node, next);
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& ofc_sema_dataflow__edge(df, node,
+					ofc_sema_dataflow__stmt_node(df, stmt->if_stmt.stmt))
+				&& ofc_sema_dataflow__edges_stmt(df, stmt->if_stmt.stmt, next));
+
+		case OFC_SEMA_STMT_IF_THEN:
+			df->node[node].join = next;
+			return (ofc_sema_dataflow__edge(df, node,
+					ofc_sema_dataflow__first(df, stmt->if_then.block_then, next))
+				&& ofc_sema_dataflow__edge(df, node,
+					ofc_sema_dataflow__first(df, stmt->if_then.block_else, next))
+				&& ofc_sema_dataflow__edges_list(df, stmt->if_then.block_then, next)
+				&& ofc_sema_dataflow__edges_list(df, stmt->if_then.block_else, next));
+
+		case OFC_SEMA_STMT_STOP:
+		case OFC_SEMA_STMT_RETURN:
+			return ofc_sema_dataflow__edge(
+				df, node, OFC_SEMA_DATAFLOW__EXIT);
+
+		case OFC_SEMA_STMT_GO_TO:
+			if (ofc_sema_expr_is_constant(stmt->go_to.label))
+				return ofc_sema_dataflow__edge_label(df, node, stmt->go_to.label);
+
+			/* An assigned GO TO can go to any label it's allowed
+			   or which is ASSIGNed. */
+			if (stmt->go_to.allow && (stmt->go_to.allow->count > 0))
+				return ofc_sema_dataflow__edge_label_list(df, node, stmt->go_to.allow);
+			for (i = 0; i < df->assign_count; i++)
+			{
+				if (!ofc_sema_dataflow__pair_add(&df->label_edge,
+					&df->label_edge_count, &df->label_edge_max,
+					(const void*)(uintptr_t)node, df->assign[i]))
+					return false;
+			}
+			return true;
+
+		case OFC_SEMA_STMT_GO_TO_COMPUTED:
+			return (ofc_sema_dataflow__edge(df, node, next)
+				&& ofc_sema_dataflow__edge_label_list(
+					df, node, stmt->go_to_comp.label));
+
+		case OFC_SEMA_STMT_CALL:
+			if (!ofc_sema_dataflow__edge(df, node, next))
+				return false;
+			if (stmt->call.args)
+			{
+				for (i = 0; i < stmt->call.args->count; i++)
+				{
+					const ofc_sema_expr_t* arg
+						= stmt->call.args->expr[i];
+					if (arg && (arg->type == OFC_SEMA_EXPR_ALT_RETURN)
+						&& !ofc_sema_dataflow__edge_label(
+							df, node, arg->alt_return.expr))
+						return false;
+				}
+			}
+			return true;
+
+		/* The increment node loops back to the body or leaves. */
+		case OFC_SEMA_STMT_DO_BLOCK:
+			first = ofc_sema_dataflow__first(
+				df, stmt->do_block.block, (node + 1));
+			return (ofc_sema_dataflow__edge(df, node, first)
+				&& ofc_sema_dataflow__edge(df, node, next)
+				&& ofc_sema_dataflow__edge(df, (node + 1), first)
+				&& ofc_sema_dataflow__edge(df, (node + 1), next)
+				&& ofc_sema_dataflow__edges_list(
+					df, stmt->do_block.block, (node + 1)));
+
+		case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+			first = ofc_sema_dataflow__first(
+				df, stmt->do_while_block.block, node);
+			return (ofc_sema_dataflow__edge(df, node, first)
+				&& ofc_sema_dataflow__edge(df, node, next)
+				&& ofc_sema_dataflow__edges_list(
+					df, stmt->do_while_block.block, node));
+
+		/* Labelled loops are handled by the list they're in. */
+		case OFC_SEMA_STMT_DO_LABEL:
+		case OFC_SEMA_STMT_DO_WHILE:
+			return ofc_sema_dataflow__edge(df, node, next);
+
+		default:
+			break;
+	}
+
+	return ofc_sema_dataflow__edge(df, node, next);
+}
+
+typedef struct
+{
+	unsigned label;
+	unsigned header;
+	unsigned latch;
+	unsigned body;
+} ofc_sema_dataflow__loop_t;
+
+/* A labelled DO loop's body is the statements up to and including its
+   terminal statement, which may close several loops at once. After the
+   terminal statement comes the innermost loop's increment, which leaves
+   to the next loop's increment until the outermost leaves to next. */
+static bool ofc_sema_dataflow__edges_list(
+	ofc_sema_dataflow__t* df,
+	const ofc_sema_stmt_list_t* list,
+	unsigned follow)
+{
+	if (!list || (list->count == 0))
+		return true;
+
+	ofc_sema_dataflow__loop_t* loop = NULL;
+	unsigned depth = 0, max = 0;
+
+	bool success = true;
+	unsigned i;
+	for (i = 0; success && (i < list->count); i++)
+	{
+		const ofc_sema_stmt_t* stmt = list->stmt[i];
+		unsigned node = ofc_sema_dataflow__stmt_node(df, stmt);
+		unsigned next = ((i + 1) < list->count
+			? ofc_sema_dataflow__stmt_node(df, list->stmt[i + 1])
+			: follow);
+
+		const ofc_sema_label_t* label
+			= ofc_sema_label_map_find_stmt(df->scope->label, stmt);
+		unsigned number = (label ? label->number : 0);
+
+		bool terminal = (label && (depth > 0)
+			&& (loop[depth - 1].label == number));
+
+		const ofc_sema_expr_t* end_label = NULL;
+		if (stmt->type == OFC_SEMA_STMT_DO_LABEL)
+			end_label = stmt->do_label.end_label;
+		else if (stmt->type == OFC_SEMA_STMT_DO_WHILE)
+			end_label = stmt->do_while.end_label;
+
+		unsigned end;
+		if (end_label && !terminal
+			&& ofc_sema_expr_resolve_uint(end_label, &end))
+		{
+			if (!ofc_sema_dataflow__grow((void**)&loop, &max,
+				depth, sizeof(ofc_sema_dataflow__loop_t)))
+			{
+				success = false;
+				break;
+			}
+
+			loop[depth].label  = end;
+			loop[depth].header = node;
+			loop[depth].latch  = (stmt->type == OFC_SEMA_STMT_DO_LABEL
+				? (node + 1) : node);
+			loop[depth].body   = next;
+			depth++;
+
+			success = ofc_sema_dataflow__edge(df, node, next);
+			continue;
+		}
+
+		success = ofc_sema_dataflow__edges_stmt(df, stmt,
+			(terminal ? loop[depth - 1].latch : next));
+
+		while (success && terminal && (depth > 0)
+			&& (loop[depth - 1].label == number))
+		{
+			ofc_sema_dataflow__loop_t* l = &loop[--depth];
+
+			unsigned exit = ((depth > 0) && (loop[depth - 1].label == number)
+				? loop[depth - 1].latch : next);
+
+			success = (ofc_sema_dataflow__edge(df, l->header, exit)
+				&& ((l->latch == l->header)
+					|| (ofc_sema_dataflow__edge(df, l->latch, l->body)
+						&& ofc_sema_dataflow__edge(df, l->latch, exit))));
+		}
+	}
+
+	/* Loops which never found their terminal statement just end. */
+	while (success && (depth > 0))
+	{
+		ofc_sema_dataflow__loop_t* l = &loop[--depth];
+		success = (ofc_sema_dataflow__edge(df, l->header, follow)
+			&& ((l->latch == l->header)
+				|| (ofc_sema_dataflow__edge(df, l->latch, l->body)
+					&& ofc_sema_dataflow__edge(df, l->latch, follow))));
+	}
+
+	ofc_free(loop);
+	return success;
+}
+
+static unsigned ofc_sema_dataflow__label_node(
+	const ofc_sema_dataflow__t* df, unsigned number)
+{
+	const ofc_sema_label_t* label
+		= ofc_sema_label_map_find(df->scope->label, number);
+	if (!label || !label->stmt)
+		return OFC_SEMA_DATAFLOW__EXIT;
+
+	unsigned node = ofc_sema_dataflow__stmt_node(df, label->stmt);
+	if (node == OFC_SEMA_DATAFLOW__EXIT)
+		return node;
+
+	switch (label->type)
+	{
+		case OFC_SEMA_LABEL_STMT:
+			return node;
+
+		/* Labels on END DO and END IF. */
+		case OFC_SEMA_LABEL_END_BLOCK:
+			switch (label->stmt->type)
+			{
+				case OFC_SEMA_STMT_DO_BLOCK:
+					return (node + 1);
+				case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+					return node;
+				case OFC_SEMA_STMT_IF_THEN:
+					return df->node[node].join;
+				default:
+					break;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	return OFC_SEMA_DATAFLOW__EXIT;
+}
+
+/* Builds the control flow graph, then sorts the edges into successor
+   lists and drops duplicates. */
+static bool ofc_sema_dataflow__graph(
+	ofc_sema_dataflow__t* df)
+{
+	if ((ofc_sema_dataflow__node_add(df, NULL) != OFC_SEMA_DATAFLOW__ENTRY)
+		|| (ofc_sema_dataflow__node_add(df, NULL) != OFC_SEMA_DATAFLOW__EXIT))
+		return false;
+
+	if (!ofc_sema_dataflow__stmt_list(df, df->scope->stmt))
+		return false;
+
+	qsort(df->stmt, df->stmt_count,
+		sizeof(ofc_sema_dataflow__pair_t),
+		ofc_sema_dataflow__pair_order);
+
+	if (!ofc_sema_dataflow__edge(df, OFC_SEMA_DATAFLOW__ENTRY,
+		ofc_sema_dataflow__first(df, df->scope->stmt, OFC_SEMA_DATAFLOW__EXIT)))
+		return false;
+
+	unsigned i;
+	for (i = 0; i < df->entry_count; i++)
+	{
+		if (!ofc_sema_dataflow__edge(df,
+			OFC_SEMA_DATAFLOW__ENTRY, df->entry[i]))
+			return false;
+	}
+
+	if (!ofc_sema_dataflow__edges_list(
+		df, df->scope->stmt, OFC_SEMA_DATAFLOW__EXIT))
+		return false;
+
+	for (i = 0; i < df->label_edge_count; i++)
+	{
+		if (!ofc_sema_dataflow__edge(df,
+			(unsigned)(uintptr_t)df->label_edge[i].key,
+			ofc_sema_dataflow__label_node(df, df->label_edge[i].value)))
+			return false;
+	}
+
+	qsort(df->edge, df->edge_count,
+		sizeof(ofc_sema_dataflow__pair_t),
+		ofc_sema_dataflow__pair_order);
+
+	df->succ = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		(sizeof(unsigned) * (df->edge_count + 1)));
+	if (!df->succ) return false;
+
+	unsigned count = 0;
+	for (i = 0; i < df->edge_count; i++)
+	{
+		unsigned from = (unsigned)(uintptr_t)df->edge[i].key;
+		unsigned to   = df->edge[i].value;
+
+		if ((i > 0) && (df->edge[i - 1].key == df->edge[i].key)
+			&& (df->edge[i - 1].value == to))
+			continue;
+
+		ofc_sema_dataflow__node_t* node = &df->node[from];
+		if (node->succ_count == 0)
+			node->succ_first = count;
+		node->succ_count++;
+		df->succ[count++] = to;
+		df->node[to].pred_count++;
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_dataflow__is_leader(
+	const ofc_sema_dataflow__t* df, unsigned n,
+	const unsigned* pred)
+{
+	const ofc_sema_dataflow__node_t* node = &df->node[n];
+	if ((n == OFC_SEMA_DATAFLOW__ENTRY)
+		|| (node->pred_count != 1))
+		return true;
+
+	unsigned p = pred[n];
+	return ((p == n) || (df->node[p].succ_count != 1));
+}
+
+/* Groups the nodes into basic blocks and orders the
+   reachable ones in reverse post-order. */
+static bool ofc_sema_dataflow__blocks(
+	ofc_sema_dataflow__t* df)
+{
+	unsigned count = df->node_count;
+
+	/* Only the predecessor of nodes with a single one matters. */
+	unsigned* pred = (unsigned*)ofc_alloc(
+		OFC_ALLOC_SEMA, (sizeof(unsigned) * count));
+	if (!pred) return false;
+
+	unsigned n, i;
+	for (n = 0; n < count; n++)
+	{
+		const ofc_sema_dataflow__node_t* node = &df->node[n];
+		for (i = 0; i < node->succ_count; i++)
+			pred[df->succ[node->succ_first + i]] = n;
+		df->node[n].block = count;
+	}
+
+	df->block = (ofc_sema_dataflow__block_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_dataflow__block_t) * count);
+	df->block_node = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * count);
+	if (!df->block || !df->block_node)
+	{
+		ofc_free(pred);
+		return false;
+	}
+
+	/* Leaders first, then any cycle without one. */
+	unsigned placed = 0;
+	unsigned pass;
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (n = 0; n < count; n++)
+		{
+			if ((df->node[n].block != count)
+				|| ((pass == 0) && !ofc_sema_dataflow__is_leader(df, n, pred)))
+				continue;
+
+			unsigned b = df->block_count++;
+			ofc_sema_dataflow__block_t* block = &df->block[b];
+			block->node_first = placed;
+			block->node_count = 0;
+			block->reachable  = false;
+
+			unsigned cur = n;
+			while (true)
+			{
+				df->node[cur].block = b;
+				df->block_node[placed++] = cur;
+				block->node_count++;
+
+				const ofc_sema_dataflow__node_t* node = &df->node[cur];
+				if (node->succ_count != 1)
+					break;
+				unsigned s = df->succ[node->succ_first];
+				if ((df->node[s].block != count)
+					|| ofc_sema_dataflow__is_leader(df, s, pred))
+					break;
+				cur = s;
+			}
+		}
+	}
+
+	ofc_free(pred);
+
+	/* Block edges come from the last node of each block. */
+	unsigned edges = 0;
+	unsigned b;
+	for (b = 0; b < df->block_count; b++)
+	{
+		ofc_sema_dataflow__block_t* block = &df->block[b];
+		const ofc_sema_dataflow__node_t* last = &df->node[
+			df->block_node[block->node_first + block->node_count - 1]];
+		block->succ_count = last->succ_count;
+		block->pred_count = 0;
+		edges += last->succ_count;
+	}
+
+	df->block_succ = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * (edges + 1));
+	df->block_pred = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * (edges + 1));
+	if (!df->block_succ || !df->block_pred)
+		return false;
+
+	unsigned first = 0;
+	for (b = 0; b < df->block_count; b++)
+	{
+		ofc_sema_dataflow__block_t* block = &df->block[b];
+		const ofc_sema_dataflow__node_t* last = &df->node[
+			df->block_node[block->node_first + block->node_count - 1]];
+
+		block->succ_first = first;
+		for (i = 0; i < last->succ_count; i++)
+		{
+			unsigned s = df->node[df->succ[last->succ_first + i]].block;
+			df->block_succ[first + i] = s;
+			df->block[s].pred_count++;
+		}
+		first += last->succ_count;
+	}
+
+	first = 0;
+	for (b = 0; b < df->block_count; b++)
+	{
+		df->block[b].pred_first = first;
+		first += df->block[b].pred_count;
+		df->block[b].pred_count = 0;
+	}
+	for (b = 0; b < df->block_count; b++)
+	{
+		const ofc_sema_dataflow__block_t* block = &df->block[b];
+		for (i = 0; i < block->succ_count; i++)
+		{
+			ofc_sema_dataflow__block_t* s
+				= &df->block[df->block_succ[block->succ_first + i]];
+			df->block_pred[s->pred_first + s->pred_count++] = b;
+		}
+	}
+
+	/* Iterative depth first search for the post-order. */
+	df->order = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * df->block_count);
+	unsigned* stack = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * df->block_count * 2);
+	if (!df->order || !stack)
+	{
+		ofc_free(stack);
+		return false;
+	}
+
+	unsigned depth = 0;
+	unsigned entry = df->node[OFC_SEMA_DATAFLOW__ENTRY].block;
+	df->block[entry].reachable = true;
+	stack[depth * 2] = entry;
+	stack[(depth * 2) + 1] = 0;
+	depth++;
+
+	while (depth > 0)
+	{
+		unsigned  top  = stack[(depth - 1) * 2];
+		unsigned* next = &stack[((depth - 1) * 2) + 1];
+		const ofc_sema_dataflow__block_t* block = &df->block[top];
+
+		if (*next < block->succ_count)
+		{
+			unsigned s = df->block_succ[block->succ_first + (*next)++];
+			if (!df->block[s].reachable)
+			{
+				df->block[s].reachable = true;
+				stack[depth * 2] = s;
+				stack[(depth * 2) + 1] = 0;
+				depth++;
+			}
+			continue;
+		}
+
+		df->order[df->order_count++] = top;
+		depth--;
+	}
+	ofc_free(stack);
+
+	/* Reverse the post-order. */
+	for (i = 0; i < (df->order_count / 2); i++)
+	{
+		unsigned t = df->order[i];
+		df->order[i] = df->order[df->order_count - 1 - i];
+		df->order[df->order_count - 1 - i] = t;
+	}
+
+	return true;
+}
+
+
+#define OFC_SEMA_DATAFLOW__BIT_SET(v, i) \
+	((v)[(i) >> 6] |= (1ULL << ((i) & 63)))
+#define OFC_SEMA_DATAFLOW__BIT_CLEAR(v, i) \
+	((v)[(i) >> 6] &= ~(1ULL << ((i) & 63)))
+#define OFC_SEMA_DATAFLOW__BIT_TEST(v, i) \
+	(((v)[(i) >> 6] >> ((i) & 63)) & 1)
+
+static uint64_t* ofc_sema_dataflow__vec(
+	const ofc_sema_dataflow__t* df,
+	uint64_t* set, unsigned block)
+{
+	return &set[(size_t)block * df->words];
+}
+
+static bool ofc_sema_dataflow__is_set(
+	ofc_sema_dataflow__ref_e type)
+{
+	return ((type == OFC_SEMA_DATAFLOW__SET)
+		|| (type == OFC_SEMA_DATAFLOW__SET_QUIET)
+		|| (type == OFC_SEMA_DATAFLOW__SET_MAY));
+}
+
+static bool ofc_sema_dataflow__is_use(
+	ofc_sema_dataflow__ref_e type)
+{
+	return ((type == OFC_SEMA_DATAFLOW__USE)
+		|| (type == OFC_SEMA_DATAFLOW__USE_ARG));
+}
+
+/* Whether a set ends the variable's previous value. */
+static bool ofc_sema_dataflow__is_kill(
+	ofc_sema_dataflow__ref_e type)
+{
+	return ((type == OFC_SEMA_DATAFLOW__SET)
+		|| (type == OFC_SEMA_DATAFLOW__SET_QUIET));
+}
+
+static bool ofc_sema_dataflow__solve(
+	ofc_sema_dataflow__t* df)
+{
+	df->words = ((df->var_count + 63) >> 6);
+	size_t size = ((size_t)df->block_count * df->words);
+
+	df->set_any   = (uint64_t*)ofc_calloc(OFC_ALLOC_SEMA, size, sizeof(uint64_t));
+	df->unset_out = (uint64_t*)ofc_calloc(OFC_ALLOC_SEMA, size, sizeof(uint64_t));
+	df->live_use  = (uint64_t*)ofc_calloc(OFC_ALLOC_SEMA, size, sizeof(uint64_t));
+	df->live_set  = (uint64_t*)ofc_calloc(OFC_ALLOC_SEMA, size, sizeof(uint64_t));
+	df->live_in   = (uint64_t*)ofc_calloc(OFC_ALLOC_SEMA, size, sizeof(uint64_t));
+	if (!df->set_any || !df->unset_out || !df->live_use
+		|| !df->live_set || !df->live_in)
+		return false;
+
+	unsigned words = df->words;
+	unsigned b, i, w;
+	for (b = 0; b < df->block_count; b++)
+	{
+		const ofc_sema_dataflow__block_t* block = &df->block[b];
+		uint64_t* set_any  = ofc_sema_dataflow__vec(df, df->set_any , b);
+		uint64_t* live_use = ofc_sema_dataflow__vec(df, df->live_use, b);
+		uint64_t* live_set = ofc_sema_dataflow__vec(df, df->live_set, b);
+
+		for (i = 0; i < block->node_count; i++)
+		{
+			const ofc_sema_dataflow__node_t* node
+				= &df->node[df->block_node[block->node_first + i]];
+
+			unsigned r;
+			for (r = 0; r < node->ref_count; r++)
+			{
+				const ofc_sema_dataflow__ref_t* ref
+					= &df->ref[node->ref_first + r];
+
+				if (ofc_sema_dataflow__is_use(ref->type))
+				{
+					if (!OFC_SEMA_DATAFLOW__BIT_TEST(live_set, ref->var))
+						OFC_SEMA_DATAFLOW__BIT_SET(live_use, ref->var);
+				}
+				else
+				{
+					OFC_SEMA_DATAFLOW__BIT_SET(set_any, ref->var);
+					if (ofc_sema_dataflow__is_kill(ref->type))
+						OFC_SEMA_DATAFLOW__BIT_SET(live_set, ref->var);
+				}
+			}
+		}
+	}
+
+	uint64_t vec[words];
+
+	/* Forwards, everything may be unset on entry and
+	   is no longer unset once it might have been set. */
+	unsigned entry = df->node[OFC_SEMA_DATAFLOW__ENTRY].block;
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		unsigned o;
+		for (o = 0; o < df->order_count; o++)
+		{
+			b = df->order[o];
+			const ofc_sema_dataflow__block_t* block = &df->block[b];
+
+			memset(vec, (b == entry ? 0xFF : 0x00), sizeof(vec));
+			for (i = 0; i < block->pred_count; i++)
+			{
+				const uint64_t* out = ofc_sema_dataflow__vec(df,
+					df->unset_out, df->block_pred[block->pred_first + i]);
+				for (w = 0; w < words; w++)
+					vec[w] |= out[w];
+			}
+
+			const uint64_t* set_any = ofc_sema_dataflow__vec(df, df->set_any, b);
+			uint64_t* out = ofc_sema_dataflow__vec(df, df->unset_out, b);
+			for (w = 0; w < words; w++)
+			{
+				uint64_t v = (vec[w] & ~set_any[w]);
+				if (v != out[w])
+				{
+					out[w] = v;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	/* Backwards in post-order, a FUNCTION's result is live on exit. */
+	unsigned exit = df->node[OFC_SEMA_DATAFLOW__EXIT].block;
+	uint64_t result[words];
+	memset(result, 0x00, sizeof(result));
+	for (i = 0; i < df->var_count; i++)
+	{
+		if (df->var_result[i])
+			OFC_SEMA_DATAFLOW__BIT_SET(result, i);
+	}
+
+	changed = true;
+	while (changed)
+	{
+		changed = false;
+		unsigned o;
+		for (o = df->order_count; o-- > 0;)
+		{
+			b = df->order[o];
+			const ofc_sema_dataflow__block_t* block = &df->block[b];
+
+			if (b == exit)
+				memcpy(vec, result, sizeof(vec));
+			else
+				memset(vec, 0x00, sizeof(vec));
+			for (i = 0; i < block->succ_count; i++)
+			{
+				const uint64_t* in = ofc_sema_dataflow__vec(df,
+					df->live_in, df->block_succ[block->succ_first + i]);
+				for (w = 0; w < words; w++)
+					vec[w] |= in[w];
+			}
+
+			const uint64_t* live_use = ofc_sema_dataflow__vec(df, df->live_use, b);
+			const uint64_t* live_set = ofc_sema_dataflow__vec(df, df->live_set, b);
+			uint64_t* in = ofc_sema_dataflow__vec(df, df->live_in, b);
+			for (w = 0; w < words; w++)
+			{
+				uint64_t v = (live_use[w] | (vec[w] & ~live_set[w]));
+				if (v != in[w])
+				{
+					in[w] = v;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+static void ofc_sema_dataflow__warn(
+	const ofc_sema_dataflow__t* df,
+	const ofc_sparse_ref_t* src, unsigned var,
+	const char* format)
+{
+	const ofc_sema_decl_t* decl = df->var[var];
+	ofc_sparse_ref_warning(*src, format,
+		decl->name.size, decl->name.base);
+}
+
+static bool ofc_sema_dataflow__report(
+	ofc_sema_dataflow__t* df)
+{
+	unsigned words = df->words;
+	uint64_t vec[words];
+
+	bool warned[df->var_count];
+	memset(warned, 0x00, sizeof(warned));
+
+	unsigned o, i, r, w;
+
+	/* Semantic analysis already warns when a variable's first statement
+	   only reads it, so those variables aren't reported again here. */
+	unsigned first[df->var_count];
+	bool first_set[df->var_count];
+	for (i = 0; i < df->var_count; i++)
+	{
+		first[i] = df->node_count;
+		first_set[i] = false;
+	}
+	for (i = 0; i < df->node_count; i++)
+	{
+		const ofc_sema_dataflow__node_t* node = &df->node[i];
+		for (r = 0; r < node->ref_count; r++)
+		{
+			const ofc_sema_dataflow__ref_t* ref
+				= &df->ref[node->ref_first + r];
+			if (first[ref->var] == df->node_count)
+				first[ref->var] = i;
+			if ((first[ref->var] == i)
+				&& ofc_sema_dataflow__is_set(ref->type))
+				first_set[ref->var] = true;
+		}
+	}
+	for (i = 0; i < df->var_count; i++)
+	{
+		if ((first[i] < df->node_count) && !first_set[i])
+			warned[i] = true;
+	}
+
+	unsigned entry = df->node[OFC_SEMA_DATAFLOW__ENTRY].block;
+	unsigned exit  = df->node[OFC_SEMA_DATAFLOW__EXIT].block;
+
+	for (o = 0; o < df->order_count; o++)
+	{
+		unsigned b = df->order[o];
+		const ofc_sema_dataflow__block_t* block = &df->block[b];
+
+		memset(vec, (b == entry ? 0xFF : 0x00), sizeof(vec));
+		for (i = 0; i < block->pred_count; i++)
+		{
+			const uint64_t* out = ofc_sema_dataflow__vec(df,
+				df->unset_out, df->block_pred[block->pred_first + i]);
+			for (w = 0; w < words; w++)
+				vec[w] |= out[w];
+		}
+
+		for (i = 0; i < block->node_count; i++)
+		{
+			const ofc_sema_dataflow__node_t* node
+				= &df->node[df->block_node[block->node_first + i]];
+			for (r = 0; r < node->ref_count; r++)
+			{
+				const ofc_sema_dataflow__ref_t* ref
+					= &df->ref[node->ref_first + r];
+
+				if (ofc_sema_dataflow__is_set(ref->type))
+				{
+					OFC_SEMA_DATAFLOW__BIT_CLEAR(vec, ref->var);
+				}
+				else if ((ref->type == OFC_SEMA_DATAFLOW__USE)
+					&& OFC_SEMA_DATAFLOW__BIT_TEST(vec, ref->var)
+					&& !warned[ref->var])
+				{
+					/* Only the first use of each is worth reporting. */
+					ofc_sema_dataflow__warn(df, ref->src, ref->var,
+						"Variable '%.*s' may be used before it's set");
+					warned[ref->var] = true;
+				}
+			}
+		}
+	}
+
+	for (o = 0; o < df->order_count; o++)
+	{
+		unsigned b = df->order[o];
+		const ofc_sema_dataflow__block_t* block = &df->block[b];
+
+		memset(vec, 0x00, sizeof(vec));
+		if (b == exit)
+		{
+			for (i = 0; i < df->var_count; i++)
+			{
+				if (df->var_result[i])
+					OFC_SEMA_DATAFLOW__BIT_SET(vec, i);
+			}
+		}
+		for (i = 0; i < block->succ_count; i++)
+		{
+			const uint64_t* in = ofc_sema_dataflow__vec(df,
+				df->live_in, df->block_succ[block->succ_first + i]);
+			for (w = 0; w < words; w++)
+				vec[w] |= in[w];
+		}
+
+		for (i = block->node_count; i-- > 0;)
+		{
+			const ofc_sema_dataflow__node_t* node
+				= &df->node[df->block_node[block->node_first + i]];
+			for (r = node->ref_count; r-- > 0;)
+			{
+				const ofc_sema_dataflow__ref_t* ref
+					= &df->ref[node->ref_first + r];
+
+				if (ofc_sema_dataflow__is_use(ref->type))
+				{
+					OFC_SEMA_DATAFLOW__BIT_SET(vec, ref->var);
+					continue;
+				}
+
+				if ((ref->type == OFC_SEMA_DATAFLOW__SET)
+					&& (df->var_reads[ref->var] > 0)
+					&& !OFC_SEMA_DATAFLOW__BIT_TEST(vec, ref->var))
+				{
+					ofc_sema_dataflow__warn(df, ref->src, ref->var,
+						"Value assigned to '%.*s' is never used");
+				}
+
+				if (ofc_sema_dataflow__is_kill(ref->type))
+					OFC_SEMA_DATAFLOW__BIT_CLEAR(vec, ref->var);
+			}
+		}
+	}
+
+	/* Variables which are set but never used at all
+	   are reported once, where they're first set. */
+	memset(warned, 0x00, sizeof(warned));
+	for (r = 0; r < df->ref_count; r++)
+	{
+		const ofc_sema_dataflow__ref_t* ref = &df->ref[r];
+		if ((df->var_reads[ref->var] > 0)
+			|| df->var_result[ref->var]
+			|| warned[ref->var])
+			continue;
+
+		ofc_sema_dataflow__warn(df, ref->src, ref->var,
+			"Variable '%.*s' is set but never used");
+		warned[ref->var] = true;
+	}
+
+	return true;
+}
+
+static void ofc_sema_dataflow__cleanup(
+	ofc_sema_dataflow__t* df)
+{
+	ofc_free(df->var);
+	ofc_free(df->var_reads);
+	ofc_free(df->var_result);
+	ofc_free(df->node);
+	ofc_free(df->ref);
+	ofc_free(df->edge);
+	ofc_free(df->succ);
+	ofc_free(df->label_edge);
+	ofc_free(df->stmt);
+	ofc_free(df->assign);
+	ofc_free(df->entry);
+	ofc_free(df->block);
+	ofc_free(df->block_node);
+	ofc_free(df->block_succ);
+	ofc_free(df->block_pred);
+	ofc_free(df->order);
+	ofc_free(df->set_any);
+	ofc_free(df->unset_out);
+	ofc_free(df->live_use);
+	ofc_free(df->live_set);
+	ofc_free(df->live_in);
+}
+
+bool ofc_sema_dataflow(const ofc_sema_scope_t* scope)
+{
+	if (!scope)
+		return false;
+
+	switch (scope->type)
+	{
+		case OFC_SEMA_SCOPE_PROGRAM:
+		case OFC_SEMA_SCOPE_SUBROUTINE:
+		case OFC_SEMA_SCOPE_FUNCTION:
+			break;
+		default:
+			return true;
+	}
+
+	if (!scope->stmt || (scope->stmt->count == 0))
+		return true;
+
+	ofc_sema_dataflow__t df;
+	memset(&df, 0x00, sizeof(df));
+	df.scope = scope;
+
+	bool success = ofc_sema_dataflow__vars(&df);
+	if (success && (df.var_count > 0))
+	{
+		success = (ofc_sema_dataflow__graph(&df)
+			&& ofc_sema_dataflow__blocks(&df)
+			&& ofc_sema_dataflow__solve(&df)
+			&& ofc_sema_dataflow__report(&df));
+	}
+
+	ofc_sema_dataflow__cleanup(&df);
+	return success;
+}
@@ -14,17 +14,15 @@
  */
 
 #include "ofc/sema.h"
-#include "ofc/global_opts.h"
-
-extern ofc_global_opts_t global_opts;
+#include "ofc/context.h"
 
 static void ofc_sema_decl_init__delete(
 	ofc_sema_decl_init_t init)
 {
 	if (init.is_substring)
 	{
-		free(init.substring.string);
-		free(init.substring.mask);
+		ofc_free(init.substring.string);
+		ofc_free(init.substring.mask);
 	}
 	else
 	{
@@ -38,7 +36,7 @@ ofc_sema_decl_t* ofc_sema_decl_create(
 	const ofc_sema_type_t* type,
 	ofc_sparse_ref_t name)
 {
-	if ((!global_opts.no_warn_name_keyword)
+	if ((!ofc_context_current()->global_opts.no_warn_name_keyword)
 		&& ofc_str_ref_begins_with_keyword(name.string))
 	{
 		ofc_sparse_ref_warning(name,
@@ -46,7 +44,7 @@ ofc_sema_decl_t* ofc_sema_decl_create(
 	}
 
 	ofc_sema_decl_t* decl
-		= (ofc_sema_decl_t*)malloc(
+		= (ofc_sema_decl_t*)ofc_alloc(OFC_ALLOC_SEMA_DECL,
 			sizeof(ofc_sema_decl_t));
 	if (!decl) return NULL;
 
@@ -558,15 +556,25 @@ static bool ofc_sema_decl__decl(
 					return false;
 				}
 
+				unsigned kind = ofc_sema_type_kind_star(
+					spec.type, star_len);
+				if (kind == 0)
+				{
+					ofc_sparse_ref_error(lhs->src,
+						"COMPLEX size must be even");
+					ofc_sema_array_delete(array);
+					return false;
+				}
+
 				if ((spec.kind != 0)
-					&& ((star_len * 3) != spec.kind))
+					&& (kind != spec.kind))
 				{
 					ofc_sparse_ref_warning(lhs->src,
 						"Overriding specified KIND in %s list",
 						(is_decl ? "decl" : "specifier"));
 				}
 
-				spec.kind = (star_len * 3);
+				spec.kind = kind;
 			}
 		}
 
@@ -887,7 +895,7 @@ void ofc_sema_decl_delete(
 			for (i = 0; i < count; i++)
 				ofc_sema_decl_init__delete(decl->init_array[i]);
 
-			free(decl->init_array);
+			ofc_free(decl->init_array);
 		}
 	}
 	else
@@ -899,7 +907,7 @@ void ofc_sema_decl_delete(
 	ofc_sema_structure_delete(decl->structure);
 	ofc_sema_scope_delete(decl->func);
 	ofc_sema_equiv_delete(decl->equiv);
-	free(decl);
+	ofc_free(decl);
 }
 
 
@@ -1065,7 +1073,7 @@ bool ofc_sema_decl_init_offset(
 
 	if (!decl->init_array)
 	{
-		decl->init_array = (ofc_sema_decl_init_t*)malloc(
+		decl->init_array = (ofc_sema_decl_init_t*)ofc_alloc(OFC_ALLOC_SEMA_DECL,
 			sizeof(ofc_sema_decl_init_t) * elem_count);
 		if (!decl->init_array) return false;
 
@@ -1206,7 +1214,7 @@ bool ofc_sema_decl_init_array(
 
 	if (!decl->init_array)
 	{
-		decl->init_array = (ofc_sema_decl_init_t*)malloc(
+		decl->init_array = (ofc_sema_decl_init_t*)ofc_alloc(OFC_ALLOC_SEMA_DECL,
 			sizeof(ofc_sema_decl_init_t) * elem_count);
 		if (!decl->init_array) return false;
 
@@ -1462,18 +1470,18 @@ bool ofc_sema_decl_init_substring(
 
 	if (!decl->init.is_substring)
 	{
-		char* string = (char*)malloc(tsize);
+		char* string = (char*)ofc_alloc(OFC_ALLOC_SEMA_DECL, tsize);
 		if (!string)
 		{
 			ofc_sema_typeval_delete(ctv);
 			return false;
 		}
 
-		bool* mask = (bool*)malloc(
+		bool* mask = (bool*)ofc_alloc(OFC_ALLOC_SEMA_DECL,
 			sizeof(bool) * type->len);
 		if (!mask)
 		{
-			free(string);
+			ofc_free(string);
 			ofc_sema_typeval_delete(ctv);
 			return false;
 		}
@@ -1487,6 +1495,13 @@ bool ofc_sema_decl_init_substring(
 		decl->init.substring.mask   = mask;
 	}
 
+	const char* cstring;
+	if (!ofc_sema_typeval_get_character(ctv, &cstring))
+	{
+		ofc_sema_typeval_delete(ctv);
+		return false;
+	}
+
 	unsigned tcsize = tsize;
 	if (type->len > 0) tcsize /= type->len;
 
@@ -1497,7 +1512,7 @@ bool ofc_sema_decl_init_substring(
 		if (decl->init.substring.mask[i])
 		{
 			if (memcmp(&decl->init.substring.string[i * tcsize],
-				&ctv->character[j * tcsize], tcsize) != 0)
+				&cstring[j * tcsize], tcsize) != 0)
 			{
 				ofc_sparse_ref_error(init->src,
 					"Re-initialization of substring,"
@@ -1511,7 +1526,7 @@ bool ofc_sema_decl_init_substring(
 		else
 		{
 			memcpy(&decl->init.substring.string[i * tcsize],
-				&ctv->character[j * tcsize], tcsize);
+				&cstring[j * tcsize], tcsize);
 			decl->init.substring.mask[i] = true;
 		}
 	}
@@ -1540,7 +1555,13 @@ bool ofc_sema_decl_size(
 		return false;
 
 	unsigned esize;
-	if (!ofc_sema_type_size(
+	if (decl->structure)
+	{
+		if (!ofc_sema_structure_size(
+			decl->structure, &esize))
+			return false;
+	}
+	else if (!ofc_sema_type_size(
 		decl->type, &esize))
 		return false;
 
@@ -1741,7 +1762,7 @@ static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
 	bool case_sensitive, bool is_ref)
 {
 	ofc_sema_decl_list_t* list
-		= (ofc_sema_decl_list_t*)malloc(
+		= (ofc_sema_decl_list_t*)ofc_alloc(OFC_ALLOC_SEMA_DECL,
 			sizeof(ofc_sema_decl_list_t));
 	if (!list) return NULL;
 
@@ -1761,7 +1782,7 @@ static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
 		(void*)ofc_sema_decl__key, NULL);
 	if (!list->map)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -1797,9 +1818,9 @@ void ofc_sema_decl_list_delete(
 			ofc_sema_decl_delete(list->decl[i]);
 	}
 
-	free(list->decl);
+	ofc_free(list->decl);
 
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_sema_decl_list_add(
@@ -1816,7 +1837,7 @@ bool ofc_sema_decl_list_add(
 		return false;
 
 	ofc_sema_decl_t** ndecl
-		= (ofc_sema_decl_t**)realloc(list->decl,
+		= (ofc_sema_decl_t**)ofc_realloc(OFC_ALLOC_SEMA_DECL, list->decl,
 			(sizeof(ofc_sema_decl_t*) * (list->count + 1)));
 	if (!ndecl) return false;
 	list->decl = ndecl;
@@ -1844,7 +1865,7 @@ bool ofc_sema_decl_list_add_ref(
 		return false;
 
 	const ofc_sema_decl_t** ndecl
-		= (const ofc_sema_decl_t**)realloc(list->decl_ref,
+		= (const ofc_sema_decl_t**)ofc_realloc(OFC_ALLOC_SEMA_DECL, list->decl_ref,
 			(sizeof(const ofc_sema_decl_t*) * (list->count + 1)));
 	if (!ndecl) return false;
 	list->decl_ref = ndecl;
@@ -2250,14 +2271,15 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 			}
 			first = false;
 
-			ofc_sema_array_index_t* index
-				= ofc_sema_array_index_from_offset(decl, i);
-			if (!index) return false;
+			int64_t subscript[decl->array->dimensions];
+			if (!ofc_sema_array_offset_subscript(
+				decl->array, i, subscript))
+				return false;
 
-			bool success = (ofc_sema_decl_print_name(cs, decl)
-				&& ofc_sema_array_index_print(cs, index));
-			ofc_sema_array_index_delete(index);
-			if (!success) return false;
+			if (!ofc_sema_decl_print_name(cs, decl)
+				|| !ofc_sema_array_subscript_print(
+					cs, decl->array, subscript))
+				return false;
 		}
 
 		if (!ofc_colstr_atomic_writef(cs, "/"))
@@ -2500,6 +2522,49 @@ bool ofc_sema_decl_list_stmt_func_print(
 	return true;
 }
 
+/* Free form output keeps the comments above each procedure. */
+static bool ofc_sema_decl__comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_decl_t* decl)
+{
+	if (!ofc_colstr_is_free(cs))
+		return true;
+
+	return ofc_sparse_comments_print(cs, indent,
+		ofc_context_current()->condense, decl->name.base);
+}
+
+bool ofc_sema_decl_procedure_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_decl_t* decl)
+{
+	if (!cs || !decl)
+		return false;
+
+	if (!decl->func)
+		return true;
+
+	if (decl->func->type == OFC_SEMA_SCOPE_SUBROUTINE)
+	{
+		if (!ofc_colstr_newline(cs, indent, NULL)
+			|| !ofc_sema_decl__comments_print(cs, indent, decl)
+			|| !ofc_sema_scope_print(cs, indent, decl->func))
+			return false;
+	}
+	else if (decl->func->type == OFC_SEMA_SCOPE_FUNCTION)
+	{
+		if (!ofc_colstr_newline(cs, indent, NULL)
+			|| !ofc_sema_decl__comments_print(cs, indent, decl)
+			|| !ofc_colstr_newline(cs, indent, NULL)
+			|| !ofc_sema_type_print(cs, decl->type->subtype)
+			|| !ofc_colstr_atomic_writef(cs, " ")
+			|| !ofc_sema_scope_print(cs, indent, decl->func))
+			return false;
+	}
+
+	return true;
+}
+
 bool ofc_sema_decl_list_procedure_print(
 	ofc_colstr_t* cs, unsigned indent,
 	const ofc_sema_decl_list_t* decl_list)
@@ -2510,25 +2575,9 @@ bool ofc_sema_decl_list_procedure_print(
 	unsigned i;
 	for (i = 0; i < decl_list->count; i++)
 	{
-		ofc_sema_decl_t* decl = decl_list->decl[i];
-		if (decl->func)
-		{
-			if (decl->func->type == OFC_SEMA_SCOPE_SUBROUTINE)
-			{
-				if (!ofc_colstr_newline(cs, indent, NULL)
-					|| !ofc_sema_scope_print(cs, indent, decl->func))
-					return false;
-			}
-			else if (decl->func->type == OFC_SEMA_SCOPE_FUNCTION)
-			{
-				if (!ofc_colstr_newline(cs, indent, NULL)
-					|| !ofc_colstr_newline(cs, indent, NULL)
-					|| !ofc_sema_type_print(cs, decl->type->subtype)
-					|| !ofc_colstr_atomic_writef(cs, " ")
-					|| !ofc_sema_scope_print(cs, indent, decl->func))
-					return false;
-			}
-		}
+		if (!ofc_sema_decl_procedure_print(
+			cs, indent, decl_list->decl[i]))
+			return false;
 	}
 
 	return true;
@@ -19,7 +19,7 @@
 ofc_sema_equiv_t* ofc_sema_equiv_create(void)
 {
 	ofc_sema_equiv_t* equiv
-		= (ofc_sema_equiv_t*)malloc(
+		= (ofc_sema_equiv_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_equiv_t));
 	if (!equiv) return NULL;
 
@@ -37,8 +37,8 @@ void ofc_sema_equiv_delete(
 	unsigned i;
 	for (i = 0; i < equiv->count; i++)
 		ofc_sema_lhs_delete(equiv->lhs[i]);
-	free(equiv->lhs);
-	free(equiv);
+	ofc_free(equiv->lhs);
+	ofc_free(equiv);
 }
 
 
@@ -49,7 +49,7 @@ bool ofc_sema_equiv_add(
 		return false;
 
 	ofc_sema_lhs_t** nlhs
-		= (ofc_sema_lhs_t**)realloc(equiv->lhs,
+		= (ofc_sema_lhs_t**)ofc_realloc(OFC_ALLOC_SEMA, equiv->lhs,
 			(sizeof(ofc_sema_lhs_t*) * (equiv->count + 1)));
 	if (!nlhs) return false;
 	equiv->lhs = nlhs;
@@ -93,7 +93,7 @@ bool ofc_sema_equiv_print(
 ofc_sema_equiv_list_t* ofc_sema_equiv_list_create(void)
 {
 	ofc_sema_equiv_list_t* list
-		= (ofc_sema_equiv_list_t*)malloc(
+		= (ofc_sema_equiv_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_equiv_list_t));
 	if (!list) return NULL;
 
@@ -111,8 +111,8 @@ void ofc_sema_equiv_list_delete(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_sema_equiv_delete(list->equiv[i]);
-	free(list->equiv);
-	free(list);
+	ofc_free(list->equiv);
+	ofc_free(list);
 }
 
 
@@ -124,7 +124,7 @@ bool ofc_sema_equiv_list_add(
 		return false;
 
 	ofc_sema_equiv_t** nequiv
-		= (ofc_sema_equiv_t**)realloc(list->equiv,
+		= (ofc_sema_equiv_t**)ofc_realloc(OFC_ALLOC_SEMA, list->equiv,
 			(sizeof(ofc_sema_equiv_t*) * (list->count + 1)));
 	if (!nequiv) return false;
 	list->equiv = nequiv;
@@ -183,7 +183,7 @@ static ofc_sema_expr_t* ofc_sema_expr__create(
 		return NULL;
 
 	ofc_sema_expr_t* expr
-		= (ofc_sema_expr_t*)malloc(
+		= (ofc_sema_expr_t*)ofc_alloc(OFC_ALLOC_SEMA_EXPR,
 			sizeof(ofc_sema_expr_t));
 	if (!expr) return NULL;
 
@@ -954,6 +954,14 @@ static ofc_sema_expr_t* ofc_sema_expr__function(
 	ofc_sparse_ref_bridge(
 		name->parent->src, name->src, &expr->src);
 
+	if ((!fscope || (fscope->type != OFC_SEMA_SCOPE_STMT_FUNC))
+		&& !ofc_sema_callgraph_add(scope, true, name->parent->variable,
+			expr->src, ofc_sema_decl_base_type(decl), args))
+	{
+		ofc_sema_expr_delete(expr);
+		return NULL;
+	}
+
 	return expr;
 }
 
@@ -1496,7 +1504,7 @@ void ofc_sema_expr_delete(
 			break;
 	}
 
-	free(expr);
+	ofc_free(expr);
 }
 
 
@@ -2020,7 +2028,7 @@ ofc_sema_expr_list_t* ofc_sema_expr_list_dummy_arg(
 ofc_sema_expr_list_t* ofc_sema_expr_list_create(void)
 {
 	ofc_sema_expr_list_t* list
-		= (ofc_sema_expr_list_t*)malloc(
+		= (ofc_sema_expr_list_t*)ofc_alloc(OFC_ALLOC_SEMA_EXPR,
 			sizeof(ofc_sema_expr_list_t));
 	if (!list) return NULL;
 
@@ -2038,9 +2046,9 @@ void ofc_sema_expr_list_delete(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_sema_expr_delete(list->expr[i]);
-	free(list->expr);
+	ofc_free(list->expr);
 
-	free(list);
+	ofc_free(list);
 }
 
 ofc_sema_expr_list_t* ofc_sema_expr_list_copy_replace(
@@ -2051,7 +2059,7 @@ ofc_sema_expr_list_t* ofc_sema_expr_list_copy_replace(
 	if (!list) return NULL;
 
 	ofc_sema_expr_list_t* copy
-		= (ofc_sema_expr_list_t*)malloc(
+		= (ofc_sema_expr_list_t*)ofc_alloc(OFC_ALLOC_SEMA_EXPR,
 			sizeof(ofc_sema_expr_list_t)
 			+ (sizeof(ofc_sema_expr_t) * list->count));
 	if (!copy) return NULL;
@@ -2083,7 +2091,7 @@ bool ofc_sema_expr_list_add(
 		return false;
 
 	ofc_sema_expr_t** nexpr
-		= (ofc_sema_expr_t**)realloc(list->expr,
+		= (ofc_sema_expr_t**)ofc_realloc(OFC_ALLOC_SEMA_EXPR, list->expr,
 			(sizeof(ofc_sema_expr_t*) * (list->count + 1)));
 	if (!nexpr) return NULL;
 
@@ -0,0 +1,315 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Declares the binary128 functions of the C library. */
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "ofc/sema.h"
+
+
+/* Each operation on a value the host's float or double can hold exactly
+   is rounded correctly by doing it in that type, unless the compiler
+   evaluates float and double in a wider type. */
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+#define OFC_SEMA_FOLD__NATIVE
+#endif
+
+static bool ofc_sema_fold__integer_fits(
+	unsigned size, __int128 value)
+{
+	if ((size == 0) || (size > sizeof(int64_t)))
+		size = sizeof(int64_t);
+
+	__int128 limit = ((__int128)1 << ((size * 8) - 1));
+	return ((value >= -limit) && (value < limit));
+}
+
+static bool ofc_sema_fold__integer_result(
+	unsigned size, __int128 value, int64_t* result)
+{
+	if (!ofc_sema_fold__integer_fits(size, value))
+		return false;
+
+	if (result) *result = (int64_t)value;
+	return true;
+}
+
+bool ofc_sema_fold_integer_fits(unsigned size, int64_t value)
+{
+	return ofc_sema_fold__integer_fits(size, value);
+}
+
+bool ofc_sema_fold_integer_add(
+	unsigned size, int64_t a, int64_t b, int64_t* result)
+{
+	return ofc_sema_fold__integer_result(
+		size, ((__int128)a + b), result);
+}
+
+bool ofc_sema_fold_integer_subtract(
+	unsigned size, int64_t a, int64_t b, int64_t* result)
+{
+	return ofc_sema_fold__integer_result(
+		size, ((__int128)a - b), result);
+}
+
+bool ofc_sema_fold_integer_multiply(
+	unsigned size, int64_t a, int64_t b, int64_t* result)
+{
+	return ofc_sema_fold__integer_result(
+		size, ((__int128)a * b), result);
+}
+
+bool ofc_sema_fold_integer_divide(
+	unsigned size, int64_t a, int64_t b, int64_t* result)
+{
+	if (b == 0)
+		return false;
+
+	/* Only the most negative value divided by minus one overflows. */
+	return ofc_sema_fold__integer_result(
+		size, ((__int128)a / b), result);
+}
+
+bool ofc_sema_fold_integer_negate(
+	unsigned size, int64_t a, int64_t* result)
+{
+	return ofc_sema_fold__integer_result(
+		size, -(__int128)a, result);
+}
+
+bool ofc_sema_fold_integer_power(
+	unsigned size, int64_t a, int64_t b, int64_t* result)
+{
+	/* The reciprocal is truncated toward zero,
+	   so a negative power of anything above one is zero. */
+	if (b < 0)
+	{
+		switch (a)
+		{
+			case 0:
+				return false;
+			case 1:
+				return ofc_sema_fold__integer_result(
+					size, 1, result);
+			case -1:
+				return ofc_sema_fold__integer_result(
+					size, ((b & 1) ? -1 : 1), result);
+			default:
+				return ofc_sema_fold__integer_result(
+					size, 0, result);
+		}
+	}
+
+	if ((a == 0) || (a == 1) || (b == 0))
+	{
+		return ofc_sema_fold__integer_result(
+			size, (b == 0 ? 1 : a), result);
+	}
+
+	/* Square and multiply, any base past the range while there are
+	   bits left means the result is past it too, since |a| > 1. */
+	__int128 r    = 1;
+	__int128 base = a;
+	uint64_t e    = (uint64_t)b;
+	while (true)
+	{
+		if (e & 1)
+		{
+			r *= base;
+			if (!ofc_sema_fold__integer_fits(size, r))
+				return false;
+		}
+
+		e >>= 1;
+		if (e == 0)
+			break;
+
+		base *= base;
+		if (!ofc_sema_fold__integer_fits(size, base))
+			return false;
+	}
+
+	return ofc_sema_fold__integer_result(size, r, result);
+}
+
+bool ofc_sema_fold_integer_from_real(
+	unsigned size, ofc_real_t value, int64_t* result)
+{
+	/* Only values which truncate into the range of int64_t convert. */
+	ofc_real_t limit = 9223372036854775808.0L;
+	if (isnan(value)
+		|| (value >= limit)
+		|| (value <= (-limit - 1)))
+		return false;
+
+	return ofc_sema_fold__integer_result(
+		size, (int64_t)value, result);
+}
+
+
+ofc_real_t ofc_sema_fold_real_round(unsigned size, ofc_real_t value)
+{
+	if (size <= sizeof(float))
+		return (float)value;
+	if (size <= sizeof(double))
+		return (double)value;
+	if (size < sizeof(ofc_real_t))
+		return (long double)value;
+	return value;
+}
+
+typedef enum
+{
+	OFC_SEMA_FOLD__ADD,
+	OFC_SEMA_FOLD__SUBTRACT,
+	OFC_SEMA_FOLD__MULTIPLY,
+	OFC_SEMA_FOLD__DIVIDE,
+} ofc_sema_fold__op_e;
+
+#ifdef OFC_SEMA_FOLD__NATIVE
+#define OFC_SEMA_FOLD__APPLY(type, op, a, b) \
+	do { \
+		type x = (type)(a); \
+		type y = (type)(b); \
+		switch (op) \
+		{ \
+			case OFC_SEMA_FOLD__ADD:      return (x + y); \
+			case OFC_SEMA_FOLD__SUBTRACT: return (x - y); \
+			case OFC_SEMA_FOLD__MULTIPLY: return (x * y); \
+			default:                      return (x / y); \
+		} \
+	} while (0)
+#endif
+
+static ofc_real_t ofc_sema_fold__real(
+	unsigned size, ofc_sema_fold__op_e op,
+	ofc_real_t a, ofc_real_t b)
+{
+#ifdef OFC_SEMA_FOLD__NATIVE
+	if (size <= sizeof(float))
+		OFC_SEMA_FOLD__APPLY(float, op, a, b);
+	if (size <= sizeof(double))
+		OFC_SEMA_FOLD__APPLY(double, op, a, b);
+#endif
+
+	ofc_real_t r;
+	switch (op)
+	{
+		case OFC_SEMA_FOLD__ADD:
+			r = a + b;
+			break;
+		case OFC_SEMA_FOLD__SUBTRACT:
+			r = a - b;
+			break;
+		case OFC_SEMA_FOLD__MULTIPLY:
+			r = a * b;
+			break;
+		default:
+			r = a / b;
+			break;
+	}
+
+	return ofc_sema_fold_real_round(size, r);
+}
+
+ofc_real_t ofc_sema_fold_real_add(
+	unsigned size, ofc_real_t a, ofc_real_t b)
+{
+	return ofc_sema_fold__real(
+		size, OFC_SEMA_FOLD__ADD, a, b);
+}
+
+ofc_real_t ofc_sema_fold_real_subtract(
+	unsigned size, ofc_real_t a, ofc_real_t b)
+{
+	return ofc_sema_fold__real(
+		size, OFC_SEMA_FOLD__SUBTRACT, a, b);
+}
+
+ofc_real_t ofc_sema_fold_real_multiply(
+	unsigned size, ofc_real_t a, ofc_real_t b)
+{
+	return ofc_sema_fold__real(
+		size, OFC_SEMA_FOLD__MULTIPLY, a, b);
+}
+
+ofc_real_t ofc_sema_fold_real_divide(
+	unsigned size, ofc_real_t a, ofc_real_t b)
+{
+	return ofc_sema_fold__real(
+		size, OFC_SEMA_FOLD__DIVIDE, a, b);
+}
+
+ofc_real_t ofc_sema_fold_real_power(
+	unsigned size, ofc_real_t a, ofc_real_t b)
+{
+#ifdef OFC_REAL_BINARY128
+	if (size >= sizeof(ofc_real_t))
+		return powf128(a, b);
+#endif
+	return ofc_sema_fold_real_round(size,
+		powl((long double)a, (long double)b));
+}
+
+
+bool ofc_sema_fold_real_parse(
+	unsigned size, const char* str, unsigned len,
+	ofc_real_t* value)
+{
+	if (!str || (len == 0))
+		return false;
+
+	/* The C library only knows E as an exponent letter. */
+	char buff[len + 1];
+	unsigned i;
+	for (i = 0; i < len; i++)
+	{
+		switch (str[i])
+		{
+			case 'D': case 'd':
+			case 'Q': case 'q':
+				buff[i] = 'E';
+				break;
+			default:
+				buff[i] = str[i];
+				break;
+		}
+	}
+	buff[len] = '\0';
+
+	char* end;
+	ofc_real_t v;
+	if (size <= sizeof(float))
+		v = strtof(buff, &end);
+	else if (size <= sizeof(double))
+		v = strtod(buff, &end);
+#ifdef OFC_REAL_BINARY128
+	else if (size >= sizeof(ofc_real_t))
+		v = strtof128(buff, &end);
+#endif
+	else
+		v = ofc_sema_fold_real_round(size, strtold(buff, &end));
+
+	if (end != &buff[len])
+		return false;
+
+	if (value) *value = v;
+	return true;
+}
@@ -267,7 +267,7 @@ static ofc_sema_format_t* ofc_sema_format__create(
 	const ofc_parse_format_desc_list_t* src)
 {
 	ofc_sema_format_t* format
-		= (ofc_sema_format_t*)malloc(
+		= (ofc_sema_format_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_format_t));
 	if (!format) return NULL;
 
@@ -345,7 +345,7 @@ void ofc_sema_format_delete(
 
 	ofc_parse_format_desc_list_delete(
 		format->format);
-	free(format);
+	ofc_free(format);
 }
 
 const ofc_sema_type_t* ofc_sema_format_desc_type(
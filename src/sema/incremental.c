@@ -0,0 +1,901 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ofc/sema.h"
+#include "ofc/diag.h"
+#include "ofc/context.h"
+
+
+/* Every value in a cache is a 32-bit little-endian word:
+ *   header: "OFCC", version, key[2], unit count
+ *   unit:   hash[2], diagnostic count, diagnostics
+ *   diag:   severity, row, col, message, context
+ * Strings are a length followed by the NUL terminated text padded
+ * to a word, a NULL context has a length of UINT32_MAX. Rows are
+ * relative to the first line of the unit. */
+
+#define OFC_SEMA_INCREMENTAL__VERSION 1
+#define OFC_SEMA_INCREMENTAL__NULL    UINT32_MAX
+
+typedef struct
+{
+	ofc_diag_severity_e severity;
+	unsigned            row, col;
+	const char*         message;
+	const char*         context;
+} ofc_sema_incremental__diag_t;
+
+typedef struct
+{
+	uint64_t                      hash;
+	unsigned                      count;
+	ofc_sema_incremental__diag_t* diag;
+} ofc_sema_incremental__entry_t;
+
+typedef struct
+{
+	const ofc_parse_stmt_t* stmt;
+	uint64_t                hash;
+	unsigned                first_row, last_row;
+
+	/* Units which come from or contain an INCLUDE, or which have
+	   ENTRY points, are always analysed in full. */
+	bool cacheable;
+	bool reused;
+
+	/* A copy of the unit statement with only its specification
+	   statements, used in place of stmt when reused. */
+	ofc_parse_stmt_t      spec;
+	ofc_parse_stmt_list_t spec_body;
+} ofc_sema_incremental__unit_t;
+
+struct ofc_sema_incremental_s
+{
+	/* What was loaded, strings point into the file's data. */
+	uint8_t*                       data;
+	bool                           loaded;
+	uint64_t                       key;
+	unsigned                       entry_count;
+	ofc_sema_incremental__entry_t* entry;
+
+	/* The source file being analysed. */
+	const char* path;
+	uint64_t    view_key;
+
+	unsigned                      unit_count;
+	ofc_sema_incremental__unit_t* unit;
+	ofc_parse_stmt_list_t         view;
+};
+
+
+static const uint64_t OFC_SEMA_INCREMENTAL__HASH_INIT
+	= 14695981039346656037ULL;
+
+static uint64_t ofc_sema_incremental__hash(
+	uint64_t hash, const void* base, size_t size)
+{
+	const uint8_t* p = (const uint8_t*)base;
+	size_t i;
+	for (i = 0; i < size; i++)
+	{
+		hash ^= p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static uint64_t ofc_sema_incremental__hash_word(
+	uint64_t hash, uint32_t value)
+{
+	return ofc_sema_incremental__hash(
+		hash, &value, sizeof(value));
+}
+
+static uint64_t ofc_sema_incremental__hash_ref(
+	uint64_t hash, ofc_sparse_ref_t ref)
+{
+	hash = ofc_sema_incremental__hash_word(
+		hash, ref.string.size);
+	return ofc_sema_incremental__hash(
+		hash, ref.string.base, ref.string.size);
+}
+
+
+static int ofc_sema_incremental__entry_compare(
+	const void* a, const void* b)
+{
+	const ofc_sema_incremental__entry_t* ea = a;
+	const ofc_sema_incremental__entry_t* eb = b;
+	if (ea->hash != eb->hash)
+		return (ea->hash < eb->hash ? -1 : 1);
+	return 0;
+}
+
+static uint32_t ofc_sema_incremental__get(
+	const uint8_t* data, size_t size, size_t* offset, bool* fail)
+{
+	if (*fail || ((size - *offset) < 4))
+	{
+		*fail = true;
+		return 0;
+	}
+
+	const uint8_t* p = &data[*offset];
+	*offset += 4;
+	return (p[0] | (p[1] << 8) | (p[2] << 16)
+		| ((uint32_t)p[3] << 24));
+}
+
+static const char* ofc_sema_incremental__get_str(
+	const uint8_t* data, size_t size, size_t* offset, bool* fail)
+{
+	uint32_t len = ofc_sema_incremental__get(
+		data, size, offset, fail);
+	if (*fail || (len == OFC_SEMA_INCREMENTAL__NULL))
+		return NULL;
+
+	size_t padded = ((len + 4) & ~3);
+	if ((size - *offset) < padded)
+	{
+		*fail = true;
+		return NULL;
+	}
+
+	const char* str = (const char*)&data[*offset];
+	if (str[len] != '\0')
+	{
+		*fail = true;
+		return NULL;
+	}
+
+	*offset += padded;
+	return str;
+}
+
+static bool ofc_sema_incremental__parse(
+	ofc_sema_incremental_t* incremental, size_t size)
+{
+	const uint8_t* data = incremental->data;
+	size_t offset = 0;
+	bool   fail   = false;
+
+	if ((size < 4) || (memcmp(data, "OFCC", 4) != 0))
+		return false;
+	offset += 4;
+
+	if (ofc_sema_incremental__get(data, size, &offset, &fail)
+		!= OFC_SEMA_INCREMENTAL__VERSION)
+		return false;
+
+	uint64_t key = ofc_sema_incremental__get(data, size, &offset, &fail);
+	key |= ((uint64_t)ofc_sema_incremental__get(
+		data, size, &offset, &fail) << 32);
+	uint32_t count = ofc_sema_incremental__get(
+		data, size, &offset, &fail);
+	if (fail || (count > (size / 12)))
+		return false;
+
+	incremental->entry = (ofc_sema_incremental__entry_t*)ofc_calloc(OFC_ALLOC_SEMA,
+		count, sizeof(ofc_sema_incremental__entry_t));
+	if ((count > 0) && !incremental->entry)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		ofc_sema_incremental__entry_t* entry
+			= &incremental->entry[i];
+		incremental->entry_count = (i + 1);
+
+		entry->hash = ofc_sema_incremental__get(
+			data, size, &offset, &fail);
+		entry->hash |= ((uint64_t)ofc_sema_incremental__get(
+			data, size, &offset, &fail) << 32);
+		uint32_t dcount = ofc_sema_incremental__get(
+			data, size, &offset, &fail);
+		if (fail || (dcount > (size / 20)))
+			return false;
+
+		if (dcount == 0)
+			continue;
+
+		entry->diag = (ofc_sema_incremental__diag_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_incremental__diag_t) * dcount);
+		if (!entry->diag) return false;
+		entry->count = dcount;
+
+		unsigned j;
+		for (j = 0; j < dcount; j++)
+		{
+			ofc_sema_incremental__diag_t* diag
+				= &entry->diag[j];
+			diag->severity = ofc_sema_incremental__get(
+				data, size, &offset, &fail);
+			diag->row = ofc_sema_incremental__get(
+				data, size, &offset, &fail);
+			diag->col = ofc_sema_incremental__get(
+				data, size, &offset, &fail);
+			diag->message = ofc_sema_incremental__get_str(
+				data, size, &offset, &fail);
+			diag->context = ofc_sema_incremental__get_str(
+				data, size, &offset, &fail);
+
+			if (fail || !diag->message
+				|| (diag->severity >= OFC_DIAG_SEVERITY_COUNT))
+				return false;
+		}
+	}
+
+	if (offset != size)
+		return false;
+
+	qsort(incremental->entry, incremental->entry_count,
+		sizeof(ofc_sema_incremental__entry_t),
+		ofc_sema_incremental__entry_compare);
+
+	incremental->key    = key;
+	incremental->loaded = true;
+	return true;
+}
+
+static void ofc_sema_incremental__clear(
+	ofc_sema_incremental_t* incremental)
+{
+	unsigned i;
+	for (i = 0; i < incremental->entry_count; i++)
+		ofc_free(incremental->entry[i].diag);
+	ofc_free(incremental->entry);
+	ofc_free(incremental->data);
+
+	incremental->entry       = NULL;
+	incremental->entry_count = 0;
+	incremental->data        = NULL;
+	incremental->loaded      = false;
+}
+
+static void ofc_sema_incremental__view_clear(
+	ofc_sema_incremental_t* incremental)
+{
+	unsigned i;
+	for (i = 0; i < incremental->unit_count; i++)
+		ofc_free(incremental->unit[i].spec_body.stmt);
+	ofc_free(incremental->unit);
+	ofc_free(incremental->view.stmt);
+
+	incremental->path       = NULL;
+	incremental->view_key   = 0;
+	incremental->unit_count = 0;
+	incremental->unit       = NULL;
+	incremental->view.count = 0;
+	incremental->view.size  = 0;
+	incremental->view.stmt  = NULL;
+}
+
+ofc_sema_incremental_t* ofc_sema_incremental_create(void)
+{
+	ofc_sema_incremental_t* incremental
+		= (ofc_sema_incremental_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_incremental_t));
+	if (!incremental) return NULL;
+
+	incremental->data        = NULL;
+	incremental->loaded      = false;
+	incremental->key         = 0;
+	incremental->entry_count = 0;
+	incremental->entry       = NULL;
+
+	incremental->unit_count = 0;
+	incremental->unit       = NULL;
+	incremental->view.stmt  = NULL;
+	ofc_sema_incremental__view_clear(incremental);
+	return incremental;
+}
+
+ofc_sema_incremental_t* ofc_sema_incremental_load(const char* path)
+{
+	if (!path)
+		return NULL;
+
+	ofc_sema_incremental_t* incremental
+		= ofc_sema_incremental_create();
+	if (!incremental) return NULL;
+
+	FILE* fp = fopen(path, "rb");
+	if (!fp) return incremental;
+
+	struct stat st;
+	if ((fstat(fileno(fp), &st) == 0)
+		&& (st.st_size > 0))
+	{
+		size_t size = st.st_size;
+		incremental->data = (uint8_t*)ofc_alloc(OFC_ALLOC_SEMA, size);
+		if (incremental->data
+			&& ((fread(incremental->data, 1, size, fp) != size)
+				|| !ofc_sema_incremental__parse(incremental, size)))
+			ofc_sema_incremental__clear(incremental);
+	}
+	fclose(fp);
+
+	return incremental;
+}
+
+void ofc_sema_incremental_delete(
+	ofc_sema_incremental_t* incremental)
+{
+	if (!incremental)
+		return;
+
+	ofc_sema_incremental__clear(incremental);
+	ofc_sema_incremental__view_clear(incremental);
+	ofc_free(incremental);
+}
+
+
+static bool ofc_sema_incremental__is_unit(
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!stmt) return false;
+
+	switch (stmt->type)
+	{
+		case OFC_PARSE_STMT_PROGRAM:
+		case OFC_PARSE_STMT_SUBROUTINE:
+		case OFC_PARSE_STMT_FUNCTION:
+		case OFC_PARSE_STMT_BLOCK_DATA:
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+/* Statements which can affect how other program units are analysed. */
+static bool ofc_sema_incremental__is_spec(
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!stmt) return false;
+
+	switch (stmt->type)
+	{
+		case OFC_PARSE_STMT_IMPLICIT_NONE:
+		case OFC_PARSE_STMT_IMPLICIT:
+		case OFC_PARSE_STMT_DECL:
+		case OFC_PARSE_STMT_DIMENSION:
+		case OFC_PARSE_STMT_EQUIVALENCE:
+		case OFC_PARSE_STMT_COMMON:
+		case OFC_PARSE_STMT_DECL_ATTR_EXTERNAL:
+		case OFC_PARSE_STMT_DECL_ATTR_INTRINSIC:
+		case OFC_PARSE_STMT_DECL_ATTR_AUTOMATIC:
+		case OFC_PARSE_STMT_DECL_ATTR_STATIC:
+		case OFC_PARSE_STMT_DECL_ATTR_VOLATILE:
+		case OFC_PARSE_STMT_TYPE:
+		case OFC_PARSE_STMT_STRUCTURE:
+		case OFC_PARSE_STMT_UNION:
+		case OFC_PARSE_STMT_MAP:
+		case OFC_PARSE_STMT_SAVE:
+		case OFC_PARSE_STMT_PARAMETER:
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+static bool ofc_sema_incremental__not_include_or_entry(
+	const ofc_parse_stmt_t* stmt, void* param)
+{
+	(void)param;
+	return (stmt && (stmt->type != OFC_PARSE_STMT_INCLUDE)
+		&& (stmt->type != OFC_PARSE_STMT_ENTRY));
+}
+
+typedef struct
+{
+	const char* strz;
+	const char* ptr;
+	unsigned    row;
+} ofc_sema_incremental__cursor_t;
+
+/* Counts lines the way ofc_file_get_position does, units are
+   almost always in order so we rarely have to restart. */
+static unsigned ofc_sema_incremental__row(
+	ofc_sema_incremental__cursor_t* cursor, const char* ptr)
+{
+	if (ptr < cursor->ptr)
+	{
+		cursor->ptr = cursor->strz;
+		cursor->row = 0;
+	}
+
+	for (; cursor->ptr < ptr; cursor->ptr++)
+	{
+		if ((*cursor->ptr == '\r')
+			|| (*cursor->ptr == '\n'))
+			cursor->row++;
+	}
+
+	return cursor->row;
+}
+
+/* Hashes the unit's text and returns a hash of its interface. */
+static uint64_t ofc_sema_incremental__unit(
+	ofc_sema_incremental__unit_t* unit,
+	const ofc_file_t* file,
+	ofc_sema_incremental__cursor_t* cursor)
+{
+	const ofc_parse_stmt_t* stmt = unit->stmt;
+	const ofc_parse_stmt_list_t* body = stmt->program.body;
+
+	uint64_t iface = ofc_sema_incremental__hash_word(
+		OFC_SEMA_INCREMENTAL__HASH_INIT, stmt->type);
+
+	/* Hash the header, or everything when we can't find its end. */
+	ofc_sparse_ref_t header = stmt->src;
+	if (body && (body->count > 0) && body->stmt[0]
+		&& (body->stmt[0]->src.sparse == stmt->src.sparse)
+		&& (body->stmt[0]->src.string.base >= header.string.base)
+		&& (body->stmt[0]->src.string.base
+			<= &header.string.base[header.string.size]))
+	{
+		header.string.size = (body->stmt[0]->src.string.base
+			- header.string.base);
+	}
+	iface = ofc_sema_incremental__hash_ref(iface, header);
+
+	unit->spec_body.count = 0;
+	unit->spec_body.size  = 0;
+	unit->spec_body.stmt  = NULL;
+	if (body && (body->count > 0))
+	{
+		unit->spec_body.stmt = (ofc_parse_stmt_t**)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_parse_stmt_t*) * body->count);
+		if (unit->spec_body.stmt)
+			unit->spec_body.size = body->count;
+
+		unsigned i;
+		for (i = 0; i < body->count; i++)
+		{
+			ofc_parse_stmt_t* s = body->stmt[i];
+			if (!ofc_sema_incremental__is_spec(s))
+				continue;
+
+			iface = ofc_sema_incremental__hash_ref(iface, s->src);
+			if (unit->spec_body.stmt)
+				unit->spec_body.stmt[unit->spec_body.count++] = s;
+		}
+	}
+
+	unit->spec = *stmt;
+	unit->spec.program.body = &unit->spec_body;
+
+	/* Position and line breaks matter as diagnostics are replayed
+	   relative to the unit, so hash the raw text as well. */
+	const ofc_file_t* ufile = NULL;
+	const char* first = ofc_sparse_file_pointer(
+		stmt->src.sparse, stmt->src.string.base, &ufile);
+	const char* last = (stmt->src.string.size > 0
+		? ofc_sparse_file_pointer(stmt->src.sparse,
+			&stmt->src.string.base[stmt->src.string.size - 1], NULL)
+		: first);
+
+	unit->cacheable = (unit->spec_body.stmt || !body || (body->count == 0))
+		&& (ufile == file) && first && last && (last >= first)
+		&& (!body || ofc_parse_stmt_list_foreach(body, NULL,
+			(void*)ofc_sema_incremental__not_include_or_entry));
+	unit->reused = false;
+
+	unit->hash = ofc_sema_incremental__hash_ref(
+		OFC_SEMA_INCREMENTAL__HASH_INIT, stmt->src);
+	if (unit->cacheable)
+	{
+		unit->hash = ofc_sema_incremental__hash(
+			unit->hash, first, ((last - first) + 1));
+		unit->first_row = ofc_sema_incremental__row(cursor, first);
+		unit->last_row  = ofc_sema_incremental__row(cursor, last);
+	}
+
+	return iface;
+}
+
+static const ofc_sema_incremental__entry_t* ofc_sema_incremental__find(
+	const ofc_sema_incremental_t* incremental, uint64_t hash)
+{
+	ofc_sema_incremental__entry_t key = { .hash = hash };
+	return bsearch(&key, incremental->entry,
+		incremental->entry_count,
+		sizeof(ofc_sema_incremental__entry_t),
+		ofc_sema_incremental__entry_compare);
+}
+
+const ofc_parse_stmt_list_t* ofc_sema_incremental_view(
+	ofc_sema_incremental_t* incremental,
+	const ofc_file_t* file,
+	const ofc_parse_stmt_list_t* list,
+	bool reuse)
+{
+	if (!incremental || !file || !list)
+		return NULL;
+
+	ofc_sema_incremental__view_clear(incremental);
+
+	incremental->path = ofc_file_get_path(file);
+
+	incremental->view.stmt = (ofc_parse_stmt_t**)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_parse_stmt_t*) * (list->count + 1));
+	incremental->unit = (ofc_sema_incremental__unit_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_incremental__unit_t) * (list->count + 1));
+	if (!incremental->view.stmt || !incremental->unit)
+		return NULL;
+	incremental->view.size = list->count;
+
+	/* Anything which changes the diagnostics of an unchanged unit
+	   belongs in the key, including every unit's interface. */
+	ofc_lang_opts_t opts = ofc_file_get_lang_opts(file);
+	uint64_t key = OFC_SEMA_INCREMENTAL__HASH_INIT;
+	key = ofc_sema_incremental__hash(key,
+		incremental->path, strlen(incremental->path));
+	key = ofc_sema_incremental__hash_word(key, opts.form);
+	key = ofc_sema_incremental__hash_word(key, opts.tab_width);
+	key = ofc_sema_incremental__hash_word(key, opts.debug);
+	key = ofc_sema_incremental__hash_word(key, opts.columns);
+	key = ofc_sema_incremental__hash_word(key, opts.case_sensitive);
+	const ofc_global_opts_t* global_opts
+		= &ofc_context_current()->global_opts;
+	key = ofc_sema_incremental__hash_word(key, global_opts->no_warn);
+	key = ofc_sema_incremental__hash_word(key, global_opts->no_warn_equiv_type);
+	key = ofc_sema_incremental__hash_word(key, global_opts->no_warn_name_keyword);
+	key = ofc_sema_incremental__hash_word(key, global_opts->diag_limit);
+	key = ofc_sema_incremental__hash_word(key, global_opts->dataflow);
+
+	ofc_sema_incremental__cursor_t cursor =
+	{
+		.strz = ofc_file_get_strz(file),
+		.ptr  = ofc_file_get_strz(file),
+		.row  = 0,
+	};
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		ofc_parse_stmt_t* stmt = list->stmt[i];
+		incremental->view.stmt[i] = stmt;
+
+		if (!ofc_sema_incremental__is_unit(stmt))
+		{
+			if (stmt) key = ofc_sema_incremental__hash_ref(key, stmt->src);
+			continue;
+		}
+
+		ofc_sema_incremental__unit_t* unit
+			= &incremental->unit[incremental->unit_count++];
+		unit->stmt = stmt;
+
+		uint64_t iface = ofc_sema_incremental__unit(
+			unit, file, &cursor);
+		key = ofc_sema_incremental__hash(
+			key, &iface, sizeof(iface));
+	}
+	incremental->view.count = list->count;
+	incremental->view_key   = key;
+
+	if (!reuse || !incremental->loaded
+		|| (incremental->key != key))
+		return &incremental->view;
+
+	ofc_diag_t* diag = ofc_diag_default();
+
+	unsigned u;
+	for (i = 0, u = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_incremental__is_unit(list->stmt[i]))
+			continue;
+
+		ofc_sema_incremental__unit_t* unit
+			= &incremental->unit[u++];
+		if (!unit->cacheable)
+			continue;
+
+		const ofc_sema_incremental__entry_t* entry
+			= ofc_sema_incremental__find(incremental, unit->hash);
+		if (!entry) continue;
+
+		unit->reused = true;
+		incremental->view.stmt[i] = &unit->spec;
+
+		unsigned j;
+		for (j = 0; j < entry->count; j++)
+		{
+			const ofc_sema_incremental__diag_t* d
+				= &entry->diag[j];
+			ofc_diag_add(diag, d->severity, incremental->path,
+				true, (unit->first_row + d->row), d->col,
+				d->context, d->message);
+		}
+	}
+
+	return &incremental->view;
+}
+
+
+typedef struct
+{
+	const char* path;
+
+	/* Cacheable units sorted by their first row. */
+	unsigned                       count;
+	ofc_sema_incremental__unit_t** unit;
+	ofc_sema_incremental__entry_t* entry;
+} ofc_sema_incremental__collect_t;
+
+static int ofc_sema_incremental__unit_compare(
+	const void* a, const void* b)
+{
+	const ofc_sema_incremental__unit_t* ua
+		= *((ofc_sema_incremental__unit_t* const*)a);
+	const ofc_sema_incremental__unit_t* ub
+		= *((ofc_sema_incremental__unit_t* const*)b);
+	if (ua->first_row != ub->first_row)
+		return (ua->first_row < ub->first_row ? -1 : 1);
+	return 0;
+}
+
+static bool ofc_sema_incremental__collect(
+	const ofc_diag_info_t* info,
+	ofc_sema_incremental__collect_t* collect)
+{
+	if (!info->positional || !info->path
+		|| (strcmp(info->path, collect->path) != 0))
+		return true;
+
+	unsigned lo = 0, hi = collect->count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (collect->unit[mid]->first_row <= info->row)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == 0)
+		return true;
+
+	const ofc_sema_incremental__unit_t* unit
+		= collect->unit[lo - 1];
+	if (info->row > unit->last_row)
+		return true;
+
+	ofc_sema_incremental__entry_t* entry
+		= &collect->entry[lo - 1];
+	ofc_sema_incremental__diag_t* ndiag
+		= (ofc_sema_incremental__diag_t*)ofc_realloc(OFC_ALLOC_SEMA, entry->diag,
+			(sizeof(ofc_sema_incremental__diag_t) * (entry->count + 1)));
+	if (!ndiag) return false;
+	entry->diag = ndiag;
+
+	ofc_sema_incremental__diag_t* d
+		= &entry->diag[entry->count++];
+	d->severity = info->severity;
+	d->row      = (info->row - unit->first_row);
+	d->col      = info->col;
+	d->message  = info->message;
+	d->context  = info->context;
+	return true;
+}
+
+static void ofc_sema_incremental__put(
+	FILE* fp, uint32_t value)
+{
+	uint8_t word[4] =
+	{
+		(value & 0xFF), ((value >> 8) & 0xFF),
+		((value >> 16) & 0xFF), ((value >> 24) & 0xFF),
+	};
+	fwrite(word, 1, 4, fp);
+}
+
+static void ofc_sema_incremental__put_str(
+	FILE* fp, const char* str)
+{
+	if (!str)
+	{
+		ofc_sema_incremental__put(
+			fp, OFC_SEMA_INCREMENTAL__NULL);
+		return;
+	}
+
+	size_t len = strlen(str);
+	ofc_sema_incremental__put(fp, len);
+	fwrite(str, 1, len, fp);
+
+	static const uint8_t pad[4] = { 0, 0, 0, 0 };
+	fwrite(pad, 1, (((len + 4) & ~3) - len), fp);
+}
+
+/* Writes the diagnostics of each cacheable unit in the view. */
+static bool ofc_sema_incremental__write(
+	const ofc_sema_incremental_t* incremental, FILE* fp)
+{
+	/* Sized by the source, so too large for the stack. */
+	unsigned count = 0;
+	ofc_sema_incremental__unit_t** unit
+		= (ofc_sema_incremental__unit_t**)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_incremental__unit_t*) * (incremental->unit_count + 1));
+	if (!unit) return false;
+
+	unsigned i;
+	for (i = 0; i < incremental->unit_count; i++)
+	{
+		if (incremental->unit[i].cacheable)
+			unit[count++] = &incremental->unit[i];
+	}
+	qsort(unit, count, sizeof(ofc_sema_incremental__unit_t*),
+		ofc_sema_incremental__unit_compare);
+
+	ofc_sema_incremental__entry_t* entry
+		= (ofc_sema_incremental__entry_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_incremental__entry_t) * (count + 1));
+	if (!entry)
+	{
+		ofc_free(unit);
+		return false;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		entry[i].hash  = unit[i]->hash;
+		entry[i].count = 0;
+		entry[i].diag  = NULL;
+	}
+
+	/* The strings are borrowed from the sink,
+	   which can't change until we're done. */
+	ofc_sema_incremental__collect_t collect =
+		{ incremental->path, count, unit, entry };
+	bool success = ofc_diag_foreach(
+		ofc_diag_default(), &collect,
+		(void*)ofc_sema_incremental__collect);
+
+	if (success)
+	{
+		fwrite("OFCC", 1, 4, fp);
+		ofc_sema_incremental__put(fp, OFC_SEMA_INCREMENTAL__VERSION);
+		ofc_sema_incremental__put(fp, (incremental->view_key & 0xFFFFFFFF));
+		ofc_sema_incremental__put(fp, (incremental->view_key >> 32));
+		ofc_sema_incremental__put(fp, count);
+
+		for (i = 0; i < count; i++)
+		{
+			ofc_sema_incremental__put(fp, (entry[i].hash & 0xFFFFFFFF));
+			ofc_sema_incremental__put(fp, (entry[i].hash >> 32));
+			ofc_sema_incremental__put(fp, entry[i].count);
+
+			unsigned j;
+			for (j = 0; j < entry[i].count; j++)
+			{
+				const ofc_sema_incremental__diag_t* d
+					= &entry[i].diag[j];
+				ofc_sema_incremental__put(fp, d->severity);
+				ofc_sema_incremental__put(fp, d->row);
+				ofc_sema_incremental__put(fp, d->col);
+				ofc_sema_incremental__put_str(fp, d->message);
+				ofc_sema_incremental__put_str(fp, d->context);
+			}
+		}
+
+		success = !ferror(fp);
+	}
+
+	for (i = 0; i < count; i++)
+		ofc_free(entry[i].diag);
+	ofc_free(entry);
+	ofc_free(unit);
+	return success;
+}
+
+bool ofc_sema_incremental_save(
+	const ofc_sema_incremental_t* incremental,
+	const char* path)
+{
+	if (!incremental || !path
+		|| !incremental->view.stmt)
+		return false;
+
+	/* Write a temporary then rename it, so that a reader never sees
+	   a partially written cache. */
+	char temp[strlen(path) + 8];
+	snprintf(temp, sizeof(temp), "%s.XXXXXX", path);
+
+	int fd = mkstemp(temp);
+	if (fd < 0) return false;
+
+	mode_t mask = umask(0);
+	umask(mask);
+	fchmod(fd, (0666 & ~mask));
+
+	FILE* fp = fdopen(fd, "wb");
+	if (!fp)
+	{
+		close(fd);
+		unlink(temp);
+		return false;
+	}
+
+	bool success = ofc_sema_incremental__write(incremental, fp);
+	success = ((fclose(fp) == 0) && success);
+	if (success)
+		success = (rename(temp, path) == 0);
+	if (!success)
+		unlink(temp);
+	return success;
+}
+
+bool ofc_sema_incremental_record(
+	ofc_sema_incremental_t* incremental)
+{
+	if (!incremental || !incremental->view.stmt)
+		return false;
+
+	/* Round trip through the file format, so that a recorded
+	   cache is indistinguishable from a loaded one. */
+	char*  base = NULL;
+	size_t size = 0;
+	FILE* fp = open_memstream(&base, &size);
+	if (!fp) return false;
+
+	bool success = ofc_sema_incremental__write(incremental, fp);
+	success = ((fclose(fp) == 0) && success);
+
+	/* The stream's buffer comes from the C library, so it's copied
+	   to be accounted for and freed like a loaded cache. */
+	uint8_t* data = (success
+		? (uint8_t*)ofc_alloc(OFC_ALLOC_SEMA, size) : NULL);
+	if (data) memcpy(data, base, size);
+	free(base);
+	if (!data) return false;
+
+	ofc_sema_incremental__clear(incremental);
+	incremental->data = data;
+	if (!ofc_sema_incremental__parse(incremental, size))
+	{
+		ofc_sema_incremental__clear(incremental);
+		return false;
+	}
+
+	return true;
+}
+
+void ofc_sema_incremental_stats(
+	const ofc_sema_incremental_t* incremental,
+	unsigned* reused, unsigned* total)
+{
+	unsigned r = 0;
+	unsigned i;
+	for (i = 0; incremental && (i < incremental->unit_count); i++)
+	{
+		if (incremental->unit[i].reused)
+			r++;
+	}
+
+	if (reused) *reused = r;
+	if (total ) *total  = (incremental ? incremental->unit_count : 0);
+}
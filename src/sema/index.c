@@ -0,0 +1,868 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ofc/sema.h"
+
+
+/* Nodes either nest or don't overlap, so the innermost node of each
+ * kind only changes where a node starts or ends. Each kind keeps the
+ * positions where that happens in order along with the node which is
+ * innermost from there, so a query is a binary search. */
+
+typedef struct
+{
+	uintptr_t pos;
+	unsigned  node;
+} ofc_sema_index__seg_t;
+
+#define OFC_SEMA_INDEX__NONE UINT32_MAX
+
+struct ofc_sema_index_s
+{
+	unsigned               count, max;
+	ofc_sema_index_node_t* node;
+
+	unsigned               type_count[OFC_SEMA_INDEX_COUNT];
+	unsigned               seg_count[OFC_SEMA_INDEX_COUNT];
+	ofc_sema_index__seg_t* seg[OFC_SEMA_INDEX_COUNT];
+};
+
+
+static bool ofc_sema_index__add(
+	ofc_sema_index_t* index,
+	ofc_sema_index_e type, ofc_sparse_ref_t src,
+	const void* ptr)
+{
+	if (ofc_sparse_ref_empty(src) || !ptr)
+		return true;
+
+	if (index->count >= index->max)
+	{
+		unsigned nmax = (index->max << 1);
+		if (nmax == 0) nmax = 256;
+
+		ofc_sema_index_node_t* nnode
+			= (ofc_sema_index_node_t*)ofc_realloc(OFC_ALLOC_SEMA, index->node,
+				(sizeof(ofc_sema_index_node_t) * nmax));
+		if (!nnode) return false;
+		index->node = nnode;
+		index->max  = nmax;
+	}
+
+	ofc_sema_index_node_t* node = &index->node[index->count++];
+	node->type = type;
+	node->src  = src;
+
+	switch (type)
+	{
+		case OFC_SEMA_INDEX_PARSE_STMT:
+			node->parse_stmt = ptr;
+			break;
+		case OFC_SEMA_INDEX_SCOPE:
+			node->scope = ptr;
+			break;
+		case OFC_SEMA_INDEX_STMT:
+			node->stmt = ptr;
+			break;
+		case OFC_SEMA_INDEX_EXPR:
+			node->expr = ptr;
+			break;
+		case OFC_SEMA_INDEX_LHS:
+			node->lhs = ptr;
+			break;
+		case OFC_SEMA_INDEX_DECL:
+			node->decl = ptr;
+			break;
+		default:
+			index->count--;
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_index__parse_stmt_list(
+	ofc_sema_index_t* index,
+	const ofc_parse_stmt_list_t* list);
+
+static bool ofc_sema_index__parse_stmt(
+	ofc_sema_index_t* index,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!stmt)
+		return true;
+
+	if (!ofc_sema_index__add(index,
+		OFC_SEMA_INDEX_PARSE_STMT, stmt->src, stmt))
+		return false;
+
+	switch (stmt->type)
+	{
+		case OFC_PARSE_STMT_PROGRAM:
+		case OFC_PARSE_STMT_SUBROUTINE:
+		case OFC_PARSE_STMT_FUNCTION:
+		case OFC_PARSE_STMT_BLOCK_DATA:
+			return ofc_sema_index__parse_stmt_list(
+				index, stmt->program.body);
+
+		case OFC_PARSE_STMT_IF_STATEMENT:
+			return ofc_sema_index__parse_stmt(
+				index, stmt->if_stmt.stmt);
+
+		case OFC_PARSE_STMT_IF_THEN:
+			return (ofc_sema_index__parse_stmt_list(
+					index, stmt->if_then.block_then)
+				&& ofc_sema_index__parse_stmt_list(
+					index, stmt->if_then.block_else));
+
+		case OFC_PARSE_STMT_DO_BLOCK:
+			return ofc_sema_index__parse_stmt_list(
+				index, stmt->do_block.block);
+
+		case OFC_PARSE_STMT_DO_WHILE_BLOCK:
+			return ofc_sema_index__parse_stmt_list(
+				index, stmt->do_while_block.block);
+
+		case OFC_PARSE_STMT_TYPE:
+		case OFC_PARSE_STMT_STRUCTURE:
+		case OFC_PARSE_STMT_UNION:
+		case OFC_PARSE_STMT_MAP:
+			return ofc_sema_index__parse_stmt_list(
+				index, stmt->structure.block);
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__parse_stmt_list(
+	ofc_sema_index_t* index,
+	const ofc_parse_stmt_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_index__parse_stmt(
+			index, list->stmt[i]))
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_index__lhs(
+	ofc_sema_index_t* index,
+	const ofc_sema_lhs_t* lhs);
+
+static bool ofc_sema_index__expr(
+	ofc_sema_index_t* index,
+	const ofc_sema_expr_t* expr);
+
+static bool ofc_sema_index__expr_list(
+	ofc_sema_index_t* index,
+	const ofc_sema_expr_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_index__expr(
+			index, list->expr[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__lhs_list(
+	ofc_sema_index_t* index,
+	const ofc_sema_lhs_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_index__lhs(
+			index, list->lhs[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__expr(
+	ofc_sema_index_t* index,
+	const ofc_sema_expr_t* expr)
+{
+	if (!expr)
+		return true;
+
+	if (!ofc_sema_index__add(index,
+		OFC_SEMA_INDEX_EXPR, expr->src, expr))
+		return false;
+
+	switch (expr->type)
+	{
+		case OFC_SEMA_EXPR_CONSTANT:
+		case OFC_SEMA_EXPR_COUNT:
+			break;
+
+		case OFC_SEMA_EXPR_LHS:
+			return ofc_sema_index__lhs(index, expr->lhs);
+
+		case OFC_SEMA_EXPR_CAST:
+			return ofc_sema_index__expr(
+				index, expr->cast.expr);
+
+		case OFC_SEMA_EXPR_INTRINSIC:
+			return ofc_sema_index__expr_list(
+				index, expr->args);
+
+		case OFC_SEMA_EXPR_FUNCTION:
+			/* The arguments are nested inside, so they take
+			   precedence over the function itself. */
+			return (ofc_sema_index__add(index,
+					OFC_SEMA_INDEX_DECL, expr->src, expr->function)
+				&& ofc_sema_index__expr_list(index, expr->args));
+
+		case OFC_SEMA_EXPR_ALT_RETURN:
+			return ofc_sema_index__expr(
+				index, expr->alt_return.expr);
+
+		case OFC_SEMA_EXPR_IMPLICIT_DO:
+			return (ofc_sema_index__expr(index, expr->implicit_do.expr)
+				&& ofc_sema_index__expr(index, expr->implicit_do.init)
+				&& ofc_sema_index__expr(index, expr->implicit_do.last)
+				&& ofc_sema_index__expr(index, expr->implicit_do.step));
+
+		case OFC_SEMA_EXPR_NEGATE:
+		case OFC_SEMA_EXPR_NOT:
+			return ofc_sema_index__expr(index, expr->a);
+
+		default:
+			return (ofc_sema_index__expr(index, expr->a)
+				&& ofc_sema_index__expr(index, expr->b));
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__lhs(
+	ofc_sema_index_t* index,
+	const ofc_sema_lhs_t* lhs)
+{
+	if (!lhs)
+		return true;
+
+	if (!ofc_sema_index__add(index,
+		OFC_SEMA_INDEX_LHS, lhs->src, lhs))
+		return false;
+
+	unsigned i;
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			return ofc_sema_index__add(index,
+				OFC_SEMA_INDEX_DECL, lhs->src, lhs->decl);
+
+		case OFC_SEMA_LHS_IMPLICIT_DO:
+			return (ofc_sema_index__lhs(index, lhs->implicit_do.lhs)
+				&& ofc_sema_index__expr(index, lhs->implicit_do.init)
+				&& ofc_sema_index__expr(index, lhs->implicit_do.last)
+				&& ofc_sema_index__expr(index, lhs->implicit_do.step));
+
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+			if (!ofc_sema_index__lhs(index, lhs->parent))
+				return false;
+			if (lhs->index)
+			{
+				for (i = 0; i < lhs->index->dimensions; i++)
+				{
+					if (!ofc_sema_index__expr(
+						index, lhs->index->index[i]))
+						return false;
+				}
+			}
+			break;
+
+		case OFC_SEMA_LHS_ARRAY_SLICE:
+			if (!ofc_sema_index__lhs(index, lhs->parent))
+				return false;
+			if (lhs->slice.slice)
+			{
+				for (i = 0; i < lhs->slice.slice->dimensions; i++)
+				{
+					const ofc_sema_array_segment_t* segment
+						= &lhs->slice.slice->segment[i];
+					if (!ofc_sema_index__expr(index, segment->first)
+						|| !ofc_sema_index__expr(index, segment->last)
+						|| !ofc_sema_index__expr(index, segment->stride))
+						return false;
+				}
+			}
+			break;
+
+		case OFC_SEMA_LHS_SUBSTRING:
+			return (ofc_sema_index__lhs(index, lhs->parent)
+				&& ofc_sema_index__expr(index, lhs->substring.first)
+				&& ofc_sema_index__expr(index, lhs->substring.last));
+
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+			return ofc_sema_index__lhs(index, lhs->parent);
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__stmt_list(
+	ofc_sema_index_t* index,
+	const ofc_sema_stmt_list_t* list);
+
+static bool ofc_sema_index__stmt(
+	ofc_sema_index_t* index,
+	const ofc_sema_stmt_t* stmt)
+{
+	if (!stmt)
+		return true;
+
+	if (!ofc_sema_index__add(index,
+		OFC_SEMA_INDEX_STMT, stmt->src, stmt))
+		return false;
+
+	switch (stmt->type)
+	{
+		case OFC_SEMA_STMT_ASSIGNMENT:
+			return (ofc_sema_index__lhs(index, stmt->assignment.dest)
+				&& ofc_sema_index__expr(index, stmt->assignment.expr));
+
+		case OFC_SEMA_STMT_IO_WRITE:
+			return (ofc_sema_index__expr(index, stmt->io_write.unit)
+				&& ofc_sema_index__expr(index, stmt->io_write.format_expr)
+				&& ofc_sema_index__expr(index, stmt->io_write.iostat)
+				&& ofc_sema_index__expr(index, stmt->io_write.rec)
+				&& ofc_sema_index__expr(index, stmt->io_write.err)
+				&& ofc_sema_index__expr(index, stmt->io_write.advance)
+				&& ofc_sema_index__expr_list(index, stmt->io_write.iolist));
+
+		case OFC_SEMA_STMT_IO_READ:
+			return (ofc_sema_index__expr(index, stmt->io_read.unit)
+				&& ofc_sema_index__expr(index, stmt->io_read.format_expr)
+				&& ofc_sema_index__expr(index, stmt->io_read.iostat)
+				&& ofc_sema_index__expr(index, stmt->io_read.rec)
+				&& ofc_sema_index__expr(index, stmt->io_read.err)
+				&& ofc_sema_index__expr(index, stmt->io_read.advance)
+				&& ofc_sema_index__expr(index, stmt->io_read.end)
+				&& ofc_sema_index__expr(index, stmt->io_read.eor)
+				&& ofc_sema_index__lhs(index, stmt->io_read.size)
+				&& ofc_sema_index__lhs_list(index, stmt->io_read.iolist));
+
+		case OFC_SEMA_STMT_IO_PRINT:
+			return (ofc_sema_index__expr(index, stmt->io_print.format_expr)
+				&& ofc_sema_index__expr_list(index, stmt->io_print.iolist));
+
+		case OFC_SEMA_STMT_IO_REWIND:
+		case OFC_SEMA_STMT_IO_END_FILE:
+		case OFC_SEMA_STMT_IO_BACKSPACE:
+			return (ofc_sema_index__expr(index, stmt->io_position.unit)
+				&& ofc_sema_index__expr(index, stmt->io_position.iostat)
+				&& ofc_sema_index__expr(index, stmt->io_position.err));
+
+		case OFC_SEMA_STMT_IO_OPEN:
+			return (ofc_sema_index__expr(index, stmt->io_open.unit)
+				&& ofc_sema_index__expr(index, stmt->io_open.iostat)
+				&& ofc_sema_index__expr(index, stmt->io_open.err)
+				&& ofc_sema_index__expr(index, stmt->io_open.recl)
+				&& ofc_sema_index__expr(index, stmt->io_open.access)
+				&& ofc_sema_index__expr(index, stmt->io_open.action)
+				&& ofc_sema_index__expr(index, stmt->io_open.blank)
+				&& ofc_sema_index__expr(index, stmt->io_open.delim)
+				&& ofc_sema_index__expr(index, stmt->io_open.file)
+				&& ofc_sema_index__expr(index, stmt->io_open.form)
+				&& ofc_sema_index__expr(index, stmt->io_open.pad)
+				&& ofc_sema_index__expr(index, stmt->io_open.position)
+				&& ofc_sema_index__expr(index, stmt->io_open.status));
+
+		case OFC_SEMA_STMT_IO_CLOSE:
+			return (ofc_sema_index__expr(index, stmt->io_close.unit)
+				&& ofc_sema_index__expr(index, stmt->io_close.iostat)
+				&& ofc_sema_index__expr(index, stmt->io_close.err)
+				&& ofc_sema_index__expr(index, stmt->io_close.status));
+
+		case OFC_SEMA_STMT_IO_INQUIRE:
+			return (ofc_sema_index__expr(index, stmt->io_inquire.unit)
+				&& ofc_sema_index__expr(index, stmt->io_inquire.file)
+				&& ofc_sema_index__expr(index, stmt->io_inquire.err)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.access)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.action)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.blank)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.delim)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.direct)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.exist)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.form)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.formatted)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.iostat)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.name)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.named)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.nextrec)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.number)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.opened)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.pad)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.position)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.read)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.readwrite)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.recl)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.sequential)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.unformatted)
+				&& ofc_sema_index__lhs(index, stmt->io_inquire.write));
+
+		case OFC_SEMA_STMT_IF_COMPUTED:
+			return (ofc_sema_index__expr(index, stmt->if_comp.cond)
+				&& ofc_sema_index__expr_list(index, stmt->if_comp.label));
+
+		case OFC_SEMA_STMT_IF_STATEMENT:
+			return (ofc_sema_index__expr(index, stmt->if_stmt.cond)
+				&& ofc_sema_index__stmt(index, stmt->if_stmt.stmt));
+
+		case OFC_SEMA_STMT_IF_THEN:
+			return (ofc_sema_index__expr(index, stmt->if_then.cond)
+				&& ofc_sema_index__stmt_list(index, stmt->if_then.block_then)
+				&& ofc_sema_index__stmt_list(index, stmt->if_then.block_else));
+
+		case OFC_SEMA_STMT_STOP:
+		case OFC_SEMA_STMT_PAUSE:
+			return ofc_sema_index__expr(
+				index, stmt->stop_pause.str);
+
+		case OFC_SEMA_STMT_GO_TO:
+			return (ofc_sema_index__expr(index, stmt->go_to.label)
+				&& ofc_sema_index__expr_list(index, stmt->go_to.allow));
+
+		case OFC_SEMA_STMT_GO_TO_COMPUTED:
+			return (ofc_sema_index__expr(index, stmt->go_to_comp.cond)
+				&& ofc_sema_index__expr_list(index, stmt->go_to_comp.label));
+
+		case OFC_SEMA_STMT_DO_LABEL:
+			return (ofc_sema_index__expr(index, stmt->do_label.end_label)
+				&& ofc_sema_index__lhs(index, stmt->do_label.iter)
+				&& ofc_sema_index__expr(index, stmt->do_label.init)
+				&& ofc_sema_index__expr(index, stmt->do_label.last)
+				&& ofc_sema_index__expr(index, stmt->do_label.step));
+
+		case OFC_SEMA_STMT_DO_BLOCK:
+			return (ofc_sema_index__lhs(index, stmt->do_block.iter)
+				&& ofc_sema_index__expr(index, stmt->do_block.init)
+				&& ofc_sema_index__expr(index, stmt->do_block.last)
+				&& ofc_sema_index__expr(index, stmt->do_block.step)
+				&& ofc_sema_index__stmt_list(index, stmt->do_block.block));
+
+		case OFC_SEMA_STMT_DO_WHILE:
+			return (ofc_sema_index__expr(index, stmt->do_while.end_label)
+				&& ofc_sema_index__expr(index, stmt->do_while.cond));
+
+		case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+			return (ofc_sema_index__expr(index, stmt->do_while_block.cond)
+				&& ofc_sema_index__stmt_list(index, stmt->do_while_block.block));
+
+		case OFC_SEMA_STMT_CALL:
+			return (ofc_sema_index__add(index, OFC_SEMA_INDEX_DECL,
+					stmt->src, stmt->call.subroutine)
+				&& ofc_sema_index__expr_list(index, stmt->call.args));
+
+		case OFC_SEMA_STMT_RETURN:
+			return ofc_sema_index__expr(
+				index, stmt->alt_return);
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__stmt_list(
+	ofc_sema_index_t* index,
+	const ofc_sema_stmt_list_t* list)
+{
+	if (!list)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_index__stmt(
+			index, list->stmt[i]))
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_index__scope(
+	ofc_sema_index_t* index,
+	const ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt);
+
+static bool ofc_sema_index__scope_body(
+	ofc_sema_index_t* index,
+	const ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_list_t* list)
+{
+	/* Declarations are indexed where they're specified, since
+	   that's what a position in a declaration statement means. */
+	unsigned i;
+	if (scope->spec && scope->spec->list)
+	{
+		for (i = 0; i < scope->spec->list->count; i++)
+		{
+			const ofc_sema_spec_t* spec
+				= scope->spec->list->spec[i];
+			if (!spec || ofc_sparse_ref_empty(spec->name))
+				continue;
+
+			const ofc_sema_decl_t* decl
+				= ofc_sema_scope_decl_find(
+					scope, spec->name.string, true);
+			if (!ofc_sema_index__add(index,
+				OFC_SEMA_INDEX_DECL, spec->name, decl))
+				return false;
+		}
+	}
+
+	if (scope->type == OFC_SEMA_SCOPE_STMT_FUNC)
+	{
+		if (!ofc_sema_index__expr(index, scope->expr))
+			return false;
+	}
+	else if (!ofc_sema_index__stmt_list(index, scope->stmt))
+	{
+		return false;
+	}
+
+	/* Unit scopes keep the name from their statement,
+	   so that's how we find which statement they span. */
+	if (scope->child)
+	{
+		for (i = 0; i < scope->child->count; i++)
+		{
+			const ofc_sema_scope_t* child
+				= scope->child->scope[i];
+			const ofc_parse_stmt_t* cstmt = NULL;
+
+			unsigned j;
+			for (j = 0; list && !cstmt && (j < list->count); j++)
+			{
+				const ofc_parse_stmt_t* s = list->stmt[j];
+				if (s && (s->type == OFC_PARSE_STMT_PROGRAM
+					|| s->type == OFC_PARSE_STMT_BLOCK_DATA)
+					&& child->name.base
+					&& (s->program.name.string.base == child->name.base))
+					cstmt = s;
+			}
+
+			if (!ofc_sema_index__scope(index, child, cstmt))
+				return false;
+		}
+	}
+
+	if (scope->decl)
+	{
+		for (i = 0; i < scope->decl->count; i++)
+		{
+			const ofc_sema_decl_t* decl = scope->decl->decl[i];
+			if (!decl->func || (decl->func->parent != scope))
+				continue;
+
+			const ofc_parse_stmt_t* cstmt = NULL;
+
+			unsigned j;
+			for (j = 0; list && !cstmt && (j < list->count); j++)
+			{
+				const ofc_parse_stmt_t* s = list->stmt[j];
+				if (s && (s->type == OFC_PARSE_STMT_SUBROUTINE
+					|| s->type == OFC_PARSE_STMT_FUNCTION)
+					&& (s->program.name.string.base == decl->func->name.base))
+					cstmt = s;
+			}
+
+			if (!ofc_sema_index__scope(index, decl->func, cstmt)
+				|| (cstmt && !ofc_sema_index__add(index,
+					OFC_SEMA_INDEX_DECL, cstmt->program.name, decl)))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static bool ofc_sema_index__scope(
+	ofc_sema_index_t* index,
+	const ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!scope)
+		return true;
+
+	if (stmt && !ofc_sema_index__add(index,
+		OFC_SEMA_INDEX_SCOPE, stmt->src, scope))
+		return false;
+
+	return ofc_sema_index__scope_body(index, scope,
+		(stmt ? stmt->program.body : NULL));
+}
+
+
+typedef struct
+{
+	uintptr_t start;
+	unsigned  size;
+	unsigned  node;
+} ofc_sema_index__order_t;
+
+static int ofc_sema_index__order(
+	const ofc_sema_index__order_t* a,
+	const ofc_sema_index__order_t* b)
+{
+	if (a->start != b->start)
+		return (a->start < b->start ? -1 : 1);
+
+	/* Outer nodes first, then in the order they were added,
+	   so a child which shares its parent's source wins. */
+	if (a->size != b->size)
+		return (a->size > b->size ? -1 : 1);
+	return (a->node < b->node ? -1 : (a->node > b->node ? 1 : 0));
+}
+
+static void ofc_sema_index__seg_add(
+	ofc_sema_index_t* index, ofc_sema_index_e type,
+	uintptr_t pos, unsigned node)
+{
+	unsigned* count = &index->seg_count[type];
+	ofc_sema_index__seg_t* seg = index->seg[type];
+
+	/* A later change at the same position replaces the earlier. */
+	if ((*count > 0) && (seg[*count - 1].pos == pos))
+	{
+		seg[*count - 1].node = node;
+		return;
+	}
+
+	seg[(*count)++] = (ofc_sema_index__seg_t){ pos, node };
+}
+
+static bool ofc_sema_index__build(
+	ofc_sema_index_t* index, ofc_sema_index_e type)
+{
+	unsigned count = 0;
+	unsigned i;
+	for (i = 0; i < index->count; i++)
+	{
+		if (index->node[i].type == type)
+			count++;
+	}
+
+	index->type_count[type] = count;
+	index->seg_count[type]  = 0;
+	index->seg[type] = NULL;
+	if (count == 0)
+		return true;
+
+	ofc_sema_index__order_t* order
+		= (ofc_sema_index__order_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_index__order_t) * count);
+	unsigned* stack = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * count);
+	uintptr_t* end = (uintptr_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(uintptr_t) * count);
+
+	/* Each node adds at most a start and an end. */
+	index->seg[type] = (ofc_sema_index__seg_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_index__seg_t) * ((count * 2) + 1));
+
+	if (!order || !stack || !end || !index->seg[type])
+	{
+		ofc_free(order);
+		ofc_free(stack);
+		ofc_free(end);
+		return false;
+	}
+
+	unsigned j;
+	for (i = 0, j = 0; i < index->count; i++)
+	{
+		const ofc_sema_index_node_t* n = &index->node[i];
+		if (n->type != type)
+			continue;
+
+		order[j].start = (uintptr_t)n->src.string.base;
+		order[j].size  = n->src.string.size;
+		order[j].node  = i;
+		j++;
+	}
+	qsort(order, count, sizeof(ofc_sema_index__order_t),
+		(void*)ofc_sema_index__order);
+
+	unsigned depth = 0;
+	for (i = 0; i < count; i++)
+	{
+		uintptr_t s = order[i].start;
+		uintptr_t e = s + order[i].size;
+
+		while ((depth > 0) && (end[depth - 1] <= s))
+		{
+			depth--;
+			ofc_sema_index__seg_add(index, type, end[depth],
+				(depth > 0 ? stack[depth - 1] : OFC_SEMA_INDEX__NONE));
+		}
+
+		/* A node which overlaps the end of its parent is cut short,
+		   so that every node nests. */
+		if ((depth > 0) && (e > end[depth - 1]))
+			e = end[depth - 1];
+
+		stack[depth] = order[i].node;
+		end[depth]   = e;
+		depth++;
+		ofc_sema_index__seg_add(index, type, s, order[i].node);
+	}
+
+	while (depth > 0)
+	{
+		depth--;
+		ofc_sema_index__seg_add(index, type, end[depth],
+			(depth > 0 ? stack[depth - 1] : OFC_SEMA_INDEX__NONE));
+	}
+
+	ofc_free(order);
+	ofc_free(stack);
+	ofc_free(end);
+	return true;
+}
+
+
+ofc_sema_index_t* ofc_sema_index_create(
+	const ofc_parse_stmt_list_t* program,
+	const ofc_sema_scope_t* scope)
+{
+	ofc_sema_index_t* index
+		= (ofc_sema_index_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_index_t));
+	if (!index) return NULL;
+
+	index->count = 0;
+	index->max   = 0;
+	index->node  = NULL;
+
+	unsigned i;
+	for (i = 0; i < OFC_SEMA_INDEX_COUNT; i++)
+	{
+		index->type_count[i] = 0;
+		index->seg_count[i]  = 0;
+		index->seg[i]        = NULL;
+	}
+
+	bool success = ofc_sema_index__parse_stmt_list(index, program);
+	if (success && scope)
+		success = ofc_sema_index__scope_body(index, scope, program);
+
+	for (i = 0; success && (i < OFC_SEMA_INDEX_COUNT); i++)
+		success = ofc_sema_index__build(index, i);
+
+	if (!success)
+	{
+		ofc_sema_index_delete(index);
+		return NULL;
+	}
+
+	return index;
+}
+
+void ofc_sema_index_delete(
+	ofc_sema_index_t* index)
+{
+	if (!index)
+		return;
+
+	unsigned i;
+	for (i = 0; i < OFC_SEMA_INDEX_COUNT; i++)
+		ofc_free(index->seg[i]);
+	ofc_free(index->node);
+	ofc_free(index);
+}
+
+
+unsigned ofc_sema_index_count(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type)
+{
+	if (!index || (type >= OFC_SEMA_INDEX_COUNT))
+		return 0;
+
+	return index->type_count[type];
+}
+
+const ofc_sema_index_node_t* ofc_sema_index_find(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type, const char* ptr)
+{
+	if (!index || !ptr
+		|| (type >= OFC_SEMA_INDEX_COUNT))
+		return NULL;
+
+	const ofc_sema_index__seg_t* seg = index->seg[type];
+	unsigned count = index->seg_count[type];
+	uintptr_t p = (uintptr_t)ptr;
+
+	/* Find the last change at or before ptr. */
+	unsigned lo = 0, hi = count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (seg[mid].pos <= p)
+			lo = (mid + 1);
+		else
+			hi = mid;
+	}
+
+	if ((lo == 0) || (seg[lo - 1].node == OFC_SEMA_INDEX__NONE))
+		return NULL;
+	return &index->node[seg[lo - 1].node];
+}
+
+const ofc_sema_index_node_t* ofc_sema_index_find_file(
+	const ofc_sema_index_t* index,
+	ofc_sema_index_e type,
+	const ofc_sparse_t* sparse, const char* fptr)
+{
+	return ofc_sema_index_find(index, type,
+		ofc_sparse_from_file_pointer(sparse, fptr));
+}
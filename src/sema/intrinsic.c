@@ -92,314 +92,7 @@ bool ofc_sema_intrinsic_name_reserved(char* name)
 	return false;
 }
 
-typedef enum
-{
-	OFC_SEMA_INTRINSIC_OP,
-	OFC_SEMA_INTRINSIC_FUNC,
-	OFC_SEMA_INTRINSIC_SUBR,
-
-	OFC_SEMA_INTRINSIC_INVALID
-} ofc_sema_intrinsic_e;
-
-typedef enum
-{
-	IT_ANY,     /* Any type */
-	IT_SAME,    /* Same as argument */
-	IT_SCALAR,  /* Any scalar type */
-	IT_LOGICAL,
-	IT_INTEGER,
-	IT_REAL,
-	IT_COMPLEX,
-	IT_CHARACTER,
-
-	IT_CHARACTER_1,
-
-	IT_DEF_LOGICAL,
-	IT_DEF_INTEGER,
-	IT_DEF_REAL,
-	IT_DEF_COMPLEX,
-
-	IT_DEF_DOUBLE,
-	IT_DEF_DOUBLE_COMPLEX,
-
-	IT_DEF_HALF_INTEGER,
-
-	IT_INTEGER_KIND,
-	/* Represents an INTEGER initialization expression
-	   indicating the kind parameter of the result.*/
-
-	IT_INTEGER_1,
-	IT_INTEGER_2,
-	IT_INTEGER_4,
-
-	IT_COUNT
-} ofc_sema_intrinsic_type_e;
-
-typedef struct
-{
-	const char*               name;
-	unsigned                  arg_min, arg_max;
-	ofc_sema_intrinsic_type_e return_type;
-	ofc_sema_intrinsic_type_e arg_type;
-} ofc_sema_intrinsic_op_t;
-
-static const ofc_sema_intrinsic_op_t ofc_sema_intrinsic__op_list[] =
-{
-	/* Casts */
-	{ "INT"   , 1, 1, IT_DEF_INTEGER        , IT_ANY                },
-	{ "IFIX"  , 1, 1, IT_DEF_INTEGER        , IT_DEF_REAL           },
-	{ "IDINT" , 1, 1, IT_DEF_INTEGER        , IT_DEF_DOUBLE         },
-	{ "HFIX"  , 1, 1, IT_DEF_HALF_INTEGER   , IT_ANY                },
-	{ "INT1"  , 1, 1, IT_INTEGER_1          , IT_ANY                },
-	{ "INT2"  , 1, 1, IT_INTEGER_2          , IT_ANY                },
-	{ "INT4"  , 1, 1, IT_INTEGER_4          , IT_ANY                },
-	{ "INTC"  , 1, 1, IT_INTEGER_2          , IT_ANY                },
-	{ "JFIX"  , 1, 1, IT_INTEGER_4          , IT_ANY                },
-	{ "REAL"  , 1, 1, IT_DEF_REAL           , IT_ANY                },
-	{ "FLOAT" , 1, 1, IT_DEF_REAL           , IT_DEF_INTEGER        },
-	{ "SNGL"  , 1, 1, IT_DEF_REAL           , IT_DEF_DOUBLE         },
-	{ "DREAL" , 1, 1, IT_DEF_DOUBLE         , IT_DEF_DOUBLE_COMPLEX },
-	{ "DBLE"  , 1, 1, IT_DEF_DOUBLE         , IT_ANY                },
-	{ "DFLOAT", 1, 1, IT_DEF_DOUBLE         , IT_ANY                },
-	{ "CMPLX" , 1, 2, IT_DEF_COMPLEX        , IT_ANY                },
-	{ "DCMPLX", 1, 2, IT_DEF_DOUBLE_COMPLEX , IT_ANY                },
-	/* TODO - CHAR, ICHAR */
-
-	/* Truncation */
-	{ "AINT", 1, 1, IT_SAME, IT_REAL       },
-	{ "DINT", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	/* Rounding */
-	{ "ANINT" , 1, 1, IT_SAME       , IT_REAL       },
-	{ "DNINT" , 1, 1, IT_SAME       , IT_DEF_DOUBLE },
-	{ "NINT"  , 1, 1, IT_DEF_INTEGER, IT_REAL       },
-	{ "IDNINT", 1, 1, IT_DEF_INTEGER, IT_DEF_DOUBLE },
-
-	{ "ABS" , 1, 1, IT_SCALAR  , IT_ANY         },
-	{ "IABS", 1, 1, IT_SAME    , IT_DEF_INTEGER },
-	{ "DABS", 1, 1, IT_SAME    , IT_DEF_DOUBLE  },
-	{ "CABS", 1, 1, IT_DEF_REAL, IT_DEF_COMPLEX },
-
-	{ "MOD"   , 2, 2, IT_SAME, IT_SCALAR     },
-	{ "AMOD"  , 2, 2, IT_SAME, IT_DEF_REAL   },
-	{ "DMOD"  , 2, 2, IT_SAME, IT_DEF_DOUBLE },
-	{ "MODULO", 2, 2, IT_SAME, IT_SCALAR     },
-
-	{ "FLOOR"  , 1, 1, IT_SAME, IT_REAL },
-	{ "CEILING", 1, 1, IT_SAME, IT_REAL },
-
-	/* Transfer of sign */
-	{ "SIGN" , 2, 2, IT_SAME, IT_SCALAR      },
-	{ "ISIGN", 2, 2, IT_SAME, IT_DEF_INTEGER },
-	{ "DSIGN", 2, 2, IT_SAME, IT_DEF_DOUBLE  },
-
-	/* Positive difference */
-	{ "DIM" , 2, 2, IT_SAME, IT_SCALAR      },
-	{ "IDIM", 2, 2, IT_SAME, IT_DEF_INTEGER },
-	{ "DDIM", 2, 2, IT_SAME, IT_DEF_DOUBLE  },
-
-	/* Inner product */
-	{ "DRPOD", 2, 2, IT_DEF_DOUBLE, IT_DEF_REAL },
-
-	{ "MAX"  , 2, 0, IT_SAME       , IT_SCALAR      },
-	{ "MAX0" , 2, 0, IT_SAME       , IT_DEF_INTEGER },
-	{ "AMAX1", 2, 0, IT_SAME       , IT_DEF_REAL    },
-	{ "DMAX1", 2, 0, IT_SAME       , IT_DEF_DOUBLE  },
-	{ "AMAX0", 2, 0, IT_DEF_REAL   , IT_DEF_INTEGER },
-	{ "MAX1" , 2, 0, IT_DEF_INTEGER, IT_DEF_REAL    },
-	{ "MIN"  , 2, 0, IT_SAME       , IT_SCALAR      },
-	{ "MIN0" , 2, 0, IT_SAME       , IT_DEF_INTEGER },
-	{ "AMIN1", 2, 0, IT_SAME       , IT_DEF_REAL    },
-	{ "DMIN1", 2, 0, IT_SAME       , IT_DEF_DOUBLE  },
-	{ "AMIN0", 2, 0, IT_DEF_REAL   , IT_DEF_INTEGER },
-	{ "MIN1" , 2, 0, IT_DEF_INTEGER, IT_DEF_REAL    },
-
-	{ "AIMG" , 1, 1, IT_SCALAR, IT_COMPLEX },
-	{ "CONJG", 1, 1, IT_SCALAR, IT_COMPLEX },
-
-	{ "SQRT" , 1, 1, IT_SAME, IT_ANY         },
-	{ "DSQRT", 1, 1, IT_SAME, IT_DEF_DOUBLE  },
-	{ "CSQRT", 1, 1, IT_SAME, IT_DEF_COMPLEX },
-
-	{ "EXP" , 1, 1, IT_SAME, IT_ANY },
-	{ "DEXP", 1, 1, IT_SAME, IT_ANY },
-	{ "CEXP", 1, 1, IT_SAME, IT_ANY },
-
-	{ "LOG" , 1, 1, IT_SAME, IT_ANY         },
-	{ "ALOG", 1, 1, IT_SAME, IT_DEF_REAL    },
-	{ "DLOG", 1, 1, IT_SAME, IT_DEF_DOUBLE  },
-	{ "CLOG", 1, 1, IT_SAME, IT_DEF_COMPLEX },
-
-	{ "LOG10" , 1, 1, IT_SAME, IT_ANY        },
-	{ "ALOG10", 1, 1, IT_SAME, IT_DEF_REAL   },
-	{ "DLOG10", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "SIN" , 1, 1, IT_SAME, IT_ANY         },
-	{ "DSIN", 1, 1, IT_SAME, IT_DEF_DOUBLE  },
-	{ "CSIN", 1, 1, IT_SAME, IT_DEF_COMPLEX },
-
-	{ "COS" , 1, 1, IT_SAME, IT_ANY         },
-	{ "DCOS", 1, 1, IT_SAME, IT_DEF_DOUBLE  },
-	{ "CCOS", 1, 1, IT_SAME, IT_DEF_COMPLEX },
-
-	{ "TAN" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DTAN", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ASIN" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DASIN", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ACOS" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DACOS", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ATAN"  , 1, 2, IT_SAME, IT_ANY        },
-	{ "DATAN" , 1, 2, IT_SAME, IT_DEF_DOUBLE },
-	{ "ATAN2" , 2, 2, IT_SAME, IT_ANY        },
-	{ "DATAN2", 2, 2, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "SINH" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DSINH", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "COSH" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DCOSH", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "TANH"  , 1, 1, IT_SAME, IT_ANY        },
-	{ "DTANH" , 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ASINH" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DASINH", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ACOSH" , 1, 1, IT_SAME, IT_ANY        },
-	{ "DACOSH", 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "ATANH"  , 1, 1, IT_SAME, IT_ANY        },
-	{ "DATANH" , 1, 1, IT_SAME, IT_DEF_DOUBLE },
-
-	{ "IAND", 2, 2, IT_SAME, IT_INTEGER },
-	{ "IEOR", 2, 2, IT_SAME, IT_INTEGER },
-	{ "IOR" , 2, 2, IT_SAME, IT_INTEGER },
-	{ "NOT" , 1, 1, IT_SAME, IT_INTEGER },
-
-	{ NULL, 0, 0, 0, 0 }
-};
-
-typedef enum
-{
-	IN = 0,
-	OUT,
-
-	NS
-} ofc_sema_intrinsic_arg_intent_e;
-
-typedef struct
-{
-	ofc_sema_intrinsic_type_e       type;
-	int                             length;
-	ofc_sema_intrinsic_arg_intent_e intent;
-} ofc_sema_intrinsic_arg_t;
-
-
-typedef struct
-{
-	const char*               name;
-	unsigned                  arg_min, arg_max;
-	ofc_sema_intrinsic_type_e return_type;
-	ofc_sema_intrinsic_arg_t  arg_type[3];
-} ofc_sema_intrinsic_func_t;
-
-static const ofc_sema_intrinsic_func_t ofc_sema_intrinsic__func_list[] =
-{
-	{ "MClock",  0, 0, IT_INTEGER_1, {{ 0 }} },
-	{ "MClock8", 0, 0, IT_INTEGER_2, {{ 0 }} },
-	{ "FDate",   0, 0, IT_CHARACTER, {{ 0 }} },
-	{ "Second",  0, 0, IT_DEF_REAL,  {{ 0 }} },
-
-	{ "Loc",      1, 1, IT_DEF_INTEGER, {{ IT_ANY,         0, IN  }} },
-	{ "IRand",    0, 1, IT_DEF_INTEGER, {{ IT_INTEGER,     0, IN  }} },
-	{ "LnBlnk",   1, 1, IT_DEF_INTEGER, {{ IT_CHARACTER,   0, IN  }} },
-	{ "IsaTty",   1, 1, IT_LOGICAL,     {{ IT_INTEGER,     0, IN  }} },
-	{ "Len",      1, 1, IT_INTEGER_1,   {{ IT_CHARACTER,   0, IN  }} },
-	{ "AImag",    1, 1, IT_REAL,        {{ IT_DEF_COMPLEX, 0, IN  }} },
-	{ "Len_Trim", 1, 1, IT_DEF_INTEGER, {{ IT_CHARACTER,   0, IN  }} },
-	{ "AChar",    1, 1, IT_CHARACTER,   {{ IT_INTEGER,     0, IN  }} },
-	{ "IChar",    1, 1, IT_DEF_INTEGER, {{ IT_CHARACTER_1, 0, IN  }} },
-	{ "BesJ0",    1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "BesJ1",    1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "BesJN",    1, 1, IT_DEF_INTEGER, {{ IT_REAL,        0, IN  }} },
-	{ "BesY0",    1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "BesY1",    1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "CTime",    1, 1, IT_CHARACTER,   {{ IT_INTEGER,     0, IN  }} },
-	{ "DErF",     1, 1, IT_DEF_DOUBLE,  {{ IT_DEF_DOUBLE,  0, IN  }} },
-	{ "DErFC",    1, 1, IT_DEF_DOUBLE,  {{ IT_DEF_DOUBLE,  0, IN  }} },
-	{ "ErF",      1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "ErFC",     1, 1, IT_REAL,        {{ IT_REAL,        0, IN  }} },
-	{ "ETime",    1, 1, IT_DEF_REAL,    {{ IT_DEF_REAL,    2, IN  }} },
-	{ "FTell",    1, 1, IT_DEF_INTEGER, {{ IT_INTEGER,     0, IN  }} },
-	{ "GetCWD",   1, 1, IT_DEF_INTEGER, {{ IT_CHARACTER,   0, OUT }} },
-	{ "HostNm",   1, 1, IT_DEF_INTEGER, {{ IT_CHARACTER,   0, OUT }} },
-	{ "TtyNam",   1, 1, IT_CHARACTER,   {{ IT_INTEGER,     0, IN  }} },
-
-	{ "Stat",   2, 2, IT_DEF_INTEGER, {{ IT_CHARACTER, 0, IN }, { IT_INTEGER,      13, OUT }} },
-	{ "LStat",  2, 2, IT_DEF_INTEGER, {{ IT_CHARACTER, 0, IN }, { IT_INTEGER,      13, OUT }} },
-	{ "FStat",  2, 2, IT_DEF_INTEGER, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,      13, OUT }} },
-	{ "Access", 2, 2, IT_DEF_INTEGER, {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER,    0,  IN  }} },
-	{ "LGe",    2, 2, IT_LOGICAL,     {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER,    0,  IN  }} },
-	{ "LGt",    2, 2, IT_LOGICAL,     {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER,    0,  IN  }} },
-	{ "LLe",    2, 2, IT_LOGICAL,     {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER,    0,  IN  }} },
-	{ "LLt",    2, 2, IT_LOGICAL,     {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER,    0,  IN  }} },
-	{ "LShift", 2, 2, IT_DEF_INTEGER, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,      0,  IN  }} },
-	{ "IShft",  2, 2, IT_DEF_INTEGER, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,      0,  IN  }} },
-	{ "BesYN",  2, 2, IT_REAL,        {{ IT_INTEGER,   0, IN }, { IT_REAL,         0,  IN  }} },
-	{ "Char",   1, 2, IT_CHARACTER,   {{ IT_INTEGER,   0, IN }, { IT_INTEGER_KIND, 0,  IN  }} },
-	/* TODO - Return char must have the same kind as optional integer argument */
-
-	{ "IShftC", 3, 3, IT_INTEGER, {{ IT_INTEGER, 0, IN }, { IT_INTEGER, 0, IN }, { IT_INTEGER, 0, IN }} },
-
-	{ NULL, 0, 0, 0, {{0}} }
-};
-
-
-typedef struct
-{
-	const char*               name;
-	unsigned                  arg_min, arg_max;
-	ofc_sema_intrinsic_arg_t  arg_type[3];
-} ofc_sema_intrinsic_subr_t;
-
-static const ofc_sema_intrinsic_subr_t ofc_sema_intrinsic__subr_list[] =
-{
-	{ "ITime",  1, 1, {{ IT_INTEGER,   3, OUT }} },
-	{ "FDate",  1, 1, {{ IT_CHARACTER, 0, OUT }} },
-	{ "Second", 1, 1, {{ IT_REAL,      0, OUT }} },
-
-	{ "ChDir",  1, 2, {{ IT_CHARACTER, 0, IN  }, { IT_INTEGER,   0, OUT }} },
-	{ "LTime",  2, 2, {{ IT_INTEGER,   0, IN  }, { IT_CHARACTER, 0, OUT }} },
-	{ "CTime",  2, 2, {{ IT_INTEGER,   0, IN  }, { IT_CHARACTER, 0, OUT }} },
-	{ "DTime",  2, 2, {{ IT_REAL,      2, OUT }, { IT_REAL,      0, OUT }} },
-	{ "ETime",  2, 2, {{ IT_REAL,      2, OUT }, { IT_REAL,      0, OUT }} },
-	{ "FGet",   1, 2, {{ IT_CHARACTER, 0, OUT }, { IT_INTEGER,   0, OUT }} },
-	{ "FPut",   1, 2, {{ IT_CHARACTER, 0, IN  }, { IT_INTEGER,   0, OUT }} },
-	{ "FTell",  2, 2, {{ IT_INTEGER,   0, IN  }, { IT_INTEGER,   0, OUT }} },
-	{ "GetCWD", 1, 2, {{ IT_CHARACTER, 0, OUT }, { IT_INTEGER,   0, OUT }} },
-	{ "HostNm", 1, 2, {{ IT_CHARACTER, 0, OUT }, { IT_INTEGER,   0, OUT }} },
-	{ "System", 1, 2, {{ IT_CHARACTER, 0, IN  }, { IT_INTEGER,   0, OUT }} },
-	{ "TtyNam", 2, 2, {{ IT_INTEGER,   0, IN  }, { IT_CHARACTER, 0, OUT }} },
-	{ "UMask",  1, 2, {{ IT_INTEGER,   0, IN  }, { IT_INTEGER,   0, OUT }} },
-	{ "Unlink", 1, 2, {{ IT_CHARACTER, 0, IN  }, { IT_INTEGER,   0, OUT }} },
-
-	{ "ChMod",  2, 3, {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER, 0,  IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "SymLnk", 2, 3, {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER, 0,  IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "Kill",   2, 3, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,   0,  IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "Stat",   2, 3, {{ IT_CHARACTER, 0, IN }, { IT_INTEGER,   13, OUT }, { IT_INTEGER, 0, OUT }} },
-	{ "FStat",  2, 3, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,   13, OUT }, { IT_INTEGER, 0, OUT }} },
-	{ "LStat",  2, 3, {{ IT_CHARACTER, 0, IN }, { IT_INTEGER,   13, OUT }, { IT_INTEGER, 0, OUT }} },
-	{ "Alarm",  2, 3, {{ IT_INTEGER,   0, IN }, { IT_INTEGER,   13, IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "FGetC",  2, 3, {{ IT_INTEGER,   0, IN }, { IT_CHARACTER, 0,  OUT }, { IT_INTEGER, 0, OUT }} },
-	{ "FPutC",  2, 3, {{ IT_INTEGER,   0, IN }, { IT_CHARACTER, 0,  IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "Link",   2, 3, {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER, 0,  IN  }, { IT_INTEGER, 0, OUT }} },
-	{ "Rename", 2, 3, {{ IT_CHARACTER, 0, IN }, { IT_CHARACTER, 0,  IN  }, { IT_INTEGER, 0, OUT }} },
-
-	{ NULL, 0, 0, {{0}} }
-};
+#include "intrinsic_list.h"
 
 
 struct ofc_sema_intrinsic_s
@@ -416,243 +109,54 @@ struct ofc_sema_intrinsic_s
 	};
 };
 
-static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_op(
-	const ofc_sema_intrinsic_op_t* op)
-{
-	if (!op)
-		return NULL;
-
-	ofc_sema_intrinsic_t* intrinsic
-		= (ofc_sema_intrinsic_t*)malloc(
-			sizeof(ofc_sema_intrinsic_t));
-	if (!intrinsic) return NULL;
-
-	intrinsic->name = ofc_str_ref_from_strz(op->name);
-	intrinsic->type = OFC_SEMA_INTRINSIC_OP;
-	intrinsic->op = op;
+/* Generated from intrinsic_list.h at build time. */
+#include "intrinsic_hash.h"
 
-	return intrinsic;
-}
-
-static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_func(
-	const ofc_sema_intrinsic_func_t* func)
-{
-	if (!func)
-		return NULL;
-
-	ofc_sema_intrinsic_t* intrinsic
-		= (ofc_sema_intrinsic_t*)malloc(
-			sizeof(ofc_sema_intrinsic_t));
-	if (!intrinsic) return NULL;
-
-	intrinsic->name = ofc_str_ref_from_strz(func->name);
-	intrinsic->type = OFC_SEMA_INTRINSIC_FUNC;
-	intrinsic->func = func;
-
-	return intrinsic;
-}
-
-static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_subr(
-	const ofc_sema_intrinsic_subr_t* subr)
-{
-	if (!subr)
-		return NULL;
-
-	ofc_sema_intrinsic_t* intrinsic
-		= (ofc_sema_intrinsic_t*)malloc(
-			sizeof(ofc_sema_intrinsic_t));
-	if (!intrinsic) return NULL;
-
-	intrinsic->name = ofc_str_ref_from_strz(subr->name);
-	intrinsic->type = OFC_SEMA_INTRINSIC_SUBR;
-	intrinsic->subr = subr;
-
-	return intrinsic;
-}
-
-static void ofc_sema_intrinsic__delete(
-	ofc_sema_intrinsic_t* intrinsic)
-{
-	if (!intrinsic)
-		return;
-
-	free(intrinsic);
-}
-
-static const ofc_str_ref_t* ofc_sema_intrinsic__key(
-	const ofc_sema_intrinsic_t* intrinsic)
+static const ofc_sema_intrinsic_t* ofc_sema_intrinsic__find(
+	const ofc_sema_intrinsic_t* table, unsigned slots,
+	const uint32_t* disp, unsigned buckets,
+	ofc_str_ref_t name)
 {
-	if (!intrinsic)
+	if (!name.base || (name.size == 0))
 		return NULL;
-	return &intrinsic->name;
-}
-
-static ofc_hashmap_t* ofc_sema_intrinsic__op_map   = NULL;
-static ofc_hashmap_t* ofc_sema_intrinsic__func_map = NULL;
-static ofc_hashmap_t* ofc_sema_intrinsic__subr_map = NULL;
-
-static void ofc_sema_intrinsic__term(void)
-{
-	ofc_hashmap_delete(ofc_sema_intrinsic__op_map);
-	ofc_hashmap_delete(ofc_sema_intrinsic__func_map);
-	ofc_hashmap_delete(ofc_sema_intrinsic__subr_map);
-}
-
-static bool ofc_sema_intrinisc__op_map_init(void)
-{
-	ofc_sema_intrinsic__op_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
-		(void*)ofc_sema_intrinsic__key,
-		(void*)ofc_sema_intrinsic__delete);
-	if (!ofc_sema_intrinsic__op_map)
-		return false;
-
-	unsigned i;
-	for (i = 0; ofc_sema_intrinsic__op_list[i].name; i++)
-	{
-		ofc_sema_intrinsic_t* intrinsic
-			= ofc_sema_intrinsic__create_op(
-				&ofc_sema_intrinsic__op_list[i]);
-		if (!intrinsic)
-		{
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__op_map);
-			ofc_sema_intrinsic__op_map = NULL;
-			return false;
-		}
-
-		if (!ofc_hashmap_add(
-			ofc_sema_intrinsic__op_map,
-			intrinsic))
-		{
-			ofc_sema_intrinsic__delete(intrinsic);
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__op_map);
-			ofc_sema_intrinsic__op_map = NULL;
-			return false;
-		}
-	}
-
-	return true;
-}
-
-static bool ofc_sema_intrinsic__func_map_init(void)
-{
-	ofc_sema_intrinsic__func_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
-		(void*)ofc_sema_intrinsic__key,
-		(void*)ofc_sema_intrinsic__delete);
-	if (!ofc_sema_intrinsic__func_map)
-		return false;
-
-	unsigned i;
-	for (i = 0; ofc_sema_intrinsic__func_list[i].name; i++)
-	{
-		ofc_sema_intrinsic_t* intrinsic
-			= ofc_sema_intrinsic__create_func(
-				&ofc_sema_intrinsic__func_list[i]);
-		if (!intrinsic)
-		{
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__func_map);
-			ofc_sema_intrinsic__func_map = NULL;
-			return false;
-		}
-
-		if (!ofc_hashmap_add(
-			ofc_sema_intrinsic__func_map,
-			intrinsic))
-		{
-			ofc_sema_intrinsic__delete(intrinsic);
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__func_map);
-			ofc_sema_intrinsic__func_map = NULL;
-			return false;
-		}
-	}
-
-	return true;
-}
-
-static bool ofc_sema_intrinsic__subr_map_init(void)
-{
-	ofc_sema_intrinsic__subr_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
-		(void*)ofc_sema_intrinsic__key,
-		(void*)ofc_sema_intrinsic__delete);
-	if (!ofc_sema_intrinsic__subr_map)
-		return false;
 
-	unsigned i;
-	for (i = 0; ofc_sema_intrinsic__subr_list[i].name; i++)
-	{
-		ofc_sema_intrinsic_t* intrinsic
-			= ofc_sema_intrinsic__create_subr(
-				&ofc_sema_intrinsic__subr_list[i]);
-		if (!intrinsic)
-		{
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__subr_map);
-			ofc_sema_intrinsic__subr_map = NULL;
-			return false;
-		}
-
-		if (!ofc_hashmap_add(
-			ofc_sema_intrinsic__subr_map,
-			intrinsic))
-		{
-			ofc_sema_intrinsic__delete(intrinsic);
-			ofc_hashmap_delete(
-				ofc_sema_intrinsic__subr_map);
-			ofc_sema_intrinsic__subr_map = NULL;
-			return false;
-		}
-	}
+	uint32_t seed = disp[ofc_sema_intrinsic__hash(
+		name.base, name.size, 0) & (buckets - 1)];
+	const ofc_sema_intrinsic_t* intrinsic = &table[
+		ofc_sema_intrinsic__hash(name.base, name.size, seed) & (slots - 1)];
 
-	return true;
+	/* Empty slots have an empty name, so never match. */
+	return (ofc_str_ref_equal_ci(intrinsic->name, name)
+		? intrinsic : NULL);
 }
 
-static bool ofc_sema_intrinsic__init(void)
+const ofc_sema_intrinsic_t* ofc_sema_intrinsic(
+	const ofc_sema_scope_t* scope,
+	ofc_str_ref_t name)
 {
-	if (ofc_sema_intrinsic__op_map
-		&& ofc_sema_intrinsic__func_map
-		&& ofc_sema_intrinsic__subr_map)
-		return true;
-
 	/* TODO - Set case sensitivity based on lang_opts? */
-	if (!ofc_sema_intrinisc__op_map_init()
-		|| !ofc_sema_intrinsic__func_map_init()
-		|| !ofc_sema_intrinsic__subr_map_init())
-		return false;
+	(void)scope;
 
-	atexit(ofc_sema_intrinsic__term);
-	return true;
+	return ofc_sema_intrinsic__find(
+		ofc_sema_intrinsic__func_table,
+		OFC_SEMA_INTRINSIC__FUNC_SLOTS,
+		ofc_sema_intrinsic__func_disp,
+		OFC_SEMA_INTRINSIC__FUNC_BUCKETS,
+		name);
 }
 
-
-const ofc_sema_intrinsic_t* ofc_sema_intrinsic(
+const ofc_sema_intrinsic_t* ofc_sema_intrinsic_subroutine(
 	const ofc_sema_scope_t* scope,
 	ofc_str_ref_t name)
 {
-	if (!ofc_sema_intrinsic__init())
-		return NULL;
-
 	(void)scope;
 
-	const ofc_sema_intrinsic_t* op = ofc_hashmap_find(
-		ofc_sema_intrinsic__op_map, &name);
-	if (op)
-		return op;
-
-	const ofc_sema_intrinsic_t* func = ofc_hashmap_find(
-		ofc_sema_intrinsic__func_map, &name);
-	if (func)
-		return func;
-
-	return NULL;
+	return ofc_sema_intrinsic__find(
+		ofc_sema_intrinsic__subr_table,
+		OFC_SEMA_INTRINSIC__SUBR_SLOTS,
+		ofc_sema_intrinsic__subr_disp,
+		OFC_SEMA_INTRINSIC__SUBR_BUCKETS,
+		name);
 }
 
 static ofc_sema_expr_list_t* ofc_sema_intrinsic_cast__op(
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <ctype.h>
+
 #include "ofc/sema.h"
 
 /* Compare type to descriptor type at
@@ -223,7 +225,7 @@ static bool ofc_sema_io__data_format_helper_body(
 			size_t nsize = (sizeof(ofc_parse_format_desc_t*)
 				* (format_list->count + 1));
 			ofc_parse_format_desc_t** ndesc
-				= (ofc_parse_format_desc_t**)realloc(
+				= (ofc_parse_format_desc_t**)ofc_realloc(OFC_ALLOC_SEMA,
 					format_list->desc, nsize);
 			if (!ndesc) return false;
 
@@ -327,7 +329,7 @@ ofc_parse_format_desc_list_t* ofc_sema_io_data_format(
 	if (!format) return NULL;
 
 	ofc_parse_format_desc_list_t* format_list
-		= (ofc_parse_format_desc_list_t*)malloc(
+		= (ofc_parse_format_desc_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_parse_format_desc_list_t));
 	if (!format_list) return NULL;
 
@@ -497,3 +499,429 @@ bool ofc_sema_io_check_label(
 	if (label_dst) *label_dst = label_ret;
 	return true;
 }
+
+
+static const char* ofc_sema_io__spec_name[] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT       ] = "UNIT",
+	[OFC_SEMA_IO_SPEC_FMT        ] = "FMT",
+	[OFC_SEMA_IO_SPEC_IOSTAT     ] = "IOSTAT",
+	[OFC_SEMA_IO_SPEC_REC        ] = "REC",
+	[OFC_SEMA_IO_SPEC_ERR        ] = "ERR",
+	[OFC_SEMA_IO_SPEC_END        ] = "END",
+	[OFC_SEMA_IO_SPEC_EOR        ] = "EOR",
+	[OFC_SEMA_IO_SPEC_ADVANCE    ] = "ADVANCE",
+	[OFC_SEMA_IO_SPEC_SIZE       ] = "SIZE",
+	[OFC_SEMA_IO_SPEC_ACCESS     ] = "ACCESS",
+	[OFC_SEMA_IO_SPEC_ACTION     ] = "ACTION",
+	[OFC_SEMA_IO_SPEC_BLANK      ] = "BLANK",
+	[OFC_SEMA_IO_SPEC_DELIM      ] = "DELIM",
+	[OFC_SEMA_IO_SPEC_FILE       ] = "FILE",
+	[OFC_SEMA_IO_SPEC_FORM       ] = "FORM",
+	[OFC_SEMA_IO_SPEC_PAD        ] = "PAD",
+	[OFC_SEMA_IO_SPEC_POSITION   ] = "POSITION",
+	[OFC_SEMA_IO_SPEC_RECL       ] = "RECL",
+	[OFC_SEMA_IO_SPEC_STATUS     ] = "STATUS",
+	[OFC_SEMA_IO_SPEC_DIRECT     ] = "DIRECT",
+	[OFC_SEMA_IO_SPEC_EXIST      ] = "EXIST",
+	[OFC_SEMA_IO_SPEC_FORMATTED  ] = "FORMATTED",
+	[OFC_SEMA_IO_SPEC_NAME       ] = "NAME",
+	[OFC_SEMA_IO_SPEC_NAMED      ] = "NAMED",
+	[OFC_SEMA_IO_SPEC_NEXTREC    ] = "NEXTREC",
+	[OFC_SEMA_IO_SPEC_NUMBER     ] = "NUMBER",
+	[OFC_SEMA_IO_SPEC_OPENED     ] = "OPENED",
+	[OFC_SEMA_IO_SPEC_READ       ] = "READ",
+	[OFC_SEMA_IO_SPEC_READWRITE  ] = "READWRITE",
+	[OFC_SEMA_IO_SPEC_SEQUENTIAL ] = "SEQUENTIAL",
+	[OFC_SEMA_IO_SPEC_UNFORMATTED] = "UNFORMATTED",
+	[OFC_SEMA_IO_SPEC_WRITE      ] = "WRITE",
+};
+
+/* Specifier names hash to distinct slots using the length and the
+   associated values of their first, second and last letters, a new
+   name may need some of these values changing to keep that true. */
+static const unsigned char ofc_sema_io__spec_asso[26] =
+{
+	60, 39, 19,  5, 15, 15, 36,  4, 39, 24, 48, 58, 31,
+	48, 61, 26, 13, 37, 59, 55, 45, 18,  9, 33, 58, 37,
+};
+
+static const ofc_sema_io_spec_e ofc_sema_io__spec_slot[64] =
+{
+	[ 2] = OFC_SEMA_IO_SPEC_WRITE,
+	[ 5] = OFC_SEMA_IO_SPEC_ACTION,
+	[ 7] = OFC_SEMA_IO_SPEC_END,
+	[ 8] = OFC_SEMA_IO_SPEC_NUMBER,
+	[ 9] = OFC_SEMA_IO_SPEC_FILE,
+	[10] = OFC_SEMA_IO_SPEC_REC,
+	[12] = OFC_SEMA_IO_SPEC_READWRITE,
+	[14] = OFC_SEMA_IO_SPEC_SEQUENTIAL,
+	[15] = OFC_SEMA_IO_SPEC_POSITION,
+	[16] = OFC_SEMA_IO_SPEC_ACCESS,
+	[22] = OFC_SEMA_IO_SPEC_BLANK,
+	[23] = OFC_SEMA_IO_SPEC_ADVANCE,
+	[24] = OFC_SEMA_IO_SPEC_UNIT,
+	[25] = OFC_SEMA_IO_SPEC_NEXTREC,
+	[26] = OFC_SEMA_IO_SPEC_FORMATTED,
+	[28] = OFC_SEMA_IO_SPEC_ERR,
+	[30] = OFC_SEMA_IO_SPEC_PAD,
+	[33] = OFC_SEMA_IO_SPEC_IOSTAT,
+	[34] = OFC_SEMA_IO_SPEC_OPENED,
+	[40] = OFC_SEMA_IO_SPEC_FMT,
+	[41] = OFC_SEMA_IO_SPEC_DIRECT,
+	[44] = OFC_SEMA_IO_SPEC_EXIST,
+	[45] = OFC_SEMA_IO_SPEC_UNFORMATTED,
+	[47] = OFC_SEMA_IO_SPEC_FORM,
+	[50] = OFC_SEMA_IO_SPEC_RECL,
+	[51] = OFC_SEMA_IO_SPEC_STATUS,
+	[52] = OFC_SEMA_IO_SPEC_EOR,
+	[53] = OFC_SEMA_IO_SPEC_SIZE,
+	[54] = OFC_SEMA_IO_SPEC_NAMED,
+	[56] = OFC_SEMA_IO_SPEC_DELIM,
+	[61] = OFC_SEMA_IO_SPEC_READ,
+	[63] = OFC_SEMA_IO_SPEC_NAME,
+
+	/* Empty slots hold UNIT too, the name check rejects them. */
+};
+
+static bool ofc_sema_io__spec_asso_get(
+	char c, unsigned* asso)
+{
+	c = toupper((unsigned char)c);
+	if ((c < 'A') || (c > 'Z'))
+		return false;
+	*asso = ofc_sema_io__spec_asso[c - 'A'];
+	return true;
+}
+
+static bool ofc_sema_io__spec_lookup(
+	ofc_str_ref_t name, ofc_sema_io_spec_e* spec)
+{
+	if (!name.base || (name.size < 3)
+		|| (name.size > 11))
+		return false;
+
+	unsigned a, b, c;
+	if (!ofc_sema_io__spec_asso_get(name.base[0], &a)
+		|| !ofc_sema_io__spec_asso_get(name.base[1], &b)
+		|| !ofc_sema_io__spec_asso_get(name.base[name.size - 1], &c))
+		return false;
+
+	ofc_sema_io_spec_e s = ofc_sema_io__spec_slot[
+		(name.size + a + b + c) & 63];
+	if (!ofc_str_ref_equal_strz_ci(
+		name, ofc_sema_io__spec_name[s]))
+		return false;
+
+	*spec = s;
+	return true;
+}
+
+bool ofc_sema_io_params(
+	const ofc_parse_call_arg_list_t* list,
+	const ofc_sema_io_spec_t* table, const char* name,
+	ofc_sema_io_params_t* params)
+{
+	if (!list || !table || !name || !params)
+		return false;
+
+	params->name  = name;
+	params->table = table;
+	params->given = 0;
+
+	unsigned s;
+	for (s = 0; s < OFC_SEMA_IO_SPEC_COUNT; s++)
+		params->arg[s] = NULL;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		const ofc_parse_call_arg_t* param
+			= list->call_arg[i];
+		if (!param) continue;
+
+		ofc_sema_io_spec_e spec;
+		if (ofc_sparse_ref_empty(param->name))
+		{
+			for (spec = 0; spec < OFC_SEMA_IO_SPEC_COUNT; spec++)
+			{
+				if ((table[spec].type != OFC_SEMA_IO_SPEC_TYPE_NONE)
+					&& (table[spec].position == (i + 1)))
+					break;
+			}
+
+			if (spec >= OFC_SEMA_IO_SPEC_COUNT)
+			{
+				ofc_sparse_ref_error(param->src,
+					"Un-named parameter %u has no meaning in %s.", i, name);
+				return false;
+			}
+
+			/* Un-named parameters must follow the one before them. */
+			if (i > 0)
+			{
+				ofc_sema_io_spec_e prev;
+				for (prev = 0; prev < OFC_SEMA_IO_SPEC_COUNT; prev++)
+				{
+					if ((table[prev].type != OFC_SEMA_IO_SPEC_TYPE_NONE)
+						&& (table[prev].position == i))
+						break;
+				}
+
+				if ((prev < OFC_SEMA_IO_SPEC_COUNT)
+					&& !params->arg[prev])
+				{
+					ofc_sparse_ref_error(param->src,
+						"Un-named %s parameter only valid after %s in %s.",
+						ofc_sema_io__spec_name[spec],
+						ofc_sema_io__spec_name[prev], name);
+					return false;
+				}
+			}
+		}
+		else
+		{
+			if (!ofc_sema_io__spec_lookup(param->name.string, &spec)
+				|| (table[spec].type == OFC_SEMA_IO_SPEC_TYPE_NONE))
+			{
+				ofc_sparse_ref_error(param->src,
+					"Unrecognized paramater %u name '%.*s' in %s.",
+					i, param->name.string.size, param->name.string.base, name);
+				return false;
+			}
+
+			if (params->given & (1ULL << spec))
+			{
+				ofc_sparse_ref_error(param->src,
+					"Re-definition of %s in %s.",
+					ofc_sema_io__spec_name[spec], name);
+				return false;
+			}
+		}
+
+		params->given |= (1ULL << spec);
+		params->arg[spec] = param;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_io__spec_value(
+	const ofc_sema_io_spec_t* row,
+	const ofc_sema_typeval_t* constant)
+{
+	if (!row->values || !constant)
+		return true;
+
+	unsigned i;
+	for (i = 0; row->values[i]; i++)
+	{
+		if (ofc_typeval_character_equal_strz_ci(
+			constant, row->values[i]))
+			return true;
+	}
+	return false;
+}
+
+static bool ofc_sema_io__spec_check_expr(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_io_params_t* params,
+	ofc_sema_io_spec_e spec,
+	ofc_sema_expr_t* expr)
+{
+	const ofc_sema_io_spec_t* row = &params->table[spec];
+	const char* sname = ofc_sema_io__spec_name[spec];
+
+	if (row->type == OFC_SEMA_IO_SPEC_TYPE_LABEL)
+		return ofc_sema_io_check_label(
+			scope, stmt, false, expr, NULL);
+
+	if ((row->type == OFC_SEMA_IO_SPEC_TYPE_VARIABLE)
+		&& (expr->type != OFC_SEMA_EXPR_LHS))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"%s must be a variable in %s", sname, params->name);
+		return false;
+	}
+
+	const ofc_sema_type_t* etype
+		= ofc_sema_expr_type(expr);
+	if (!etype) return false;
+
+	const ofc_sema_typeval_t* constant
+		= ofc_sema_expr_constant(expr);
+
+	switch (row->type)
+	{
+		case OFC_SEMA_IO_SPEC_TYPE_CHARACTER:
+			if (!ofc_sema_type_is_character(etype))
+			{
+				ofc_sparse_ref_error(stmt->src,
+					"%s must be a CHARACTER expression in %s",
+					sname, params->name);
+				return false;
+			}
+
+			if (!ofc_sema_io__spec_value(row, constant))
+			{
+				ofc_sparse_ref_error(stmt->src,
+					"%s must be %s in %s",
+					sname, row->desc, params->name);
+				return false;
+			}
+			break;
+
+		case OFC_SEMA_IO_SPEC_TYPE_UNIT:
+		case OFC_SEMA_IO_SPEC_TYPE_INTEGER:
+		case OFC_SEMA_IO_SPEC_TYPE_VARIABLE:
+			if (!ofc_sema_type_is_integer(etype))
+			{
+				ofc_sparse_ref_error(stmt->src,
+					"%s must be of type INTEGER in %s",
+					sname, params->name);
+				return false;
+			}
+
+			if (row->type == OFC_SEMA_IO_SPEC_TYPE_UNIT)
+			{
+				if (!ofc_sema_expr_validate_uint(expr))
+				{
+					ofc_sparse_ref_error(stmt->src,
+						"%s must be a positive INTEGER in %s",
+						sname, params->name);
+					return false;
+				}
+			}
+			else if (row->type == OFC_SEMA_IO_SPEC_TYPE_INTEGER)
+			{
+				int64_t value;
+				if (constant
+					&& ofc_sema_typeval_get_integer(constant, &value)
+					&& (value < 0))
+				{
+					ofc_sparse_ref_error(stmt->src,
+						"%s must be a positive INTEGER in %s",
+						sname, params->name);
+					return false;
+				}
+			}
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool ofc_sema_io_spec_expr(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_io_params_t* params,
+	ofc_sema_io_spec_e spec,
+	ofc_sema_expr_t** expr)
+{
+	if (!stmt || !params || !expr
+		|| (spec >= OFC_SEMA_IO_SPEC_COUNT))
+		return false;
+
+	*expr = NULL;
+
+	const ofc_parse_call_arg_t* arg = params->arg[spec];
+	if (!arg) return true;
+
+	if ((params->table[spec].type == OFC_SEMA_IO_SPEC_TYPE_UNIT)
+		&& (arg->type != OFC_PARSE_CALL_ARG_EXPR))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"%s must be an INTEGER expression in %s",
+			ofc_sema_io__spec_name[spec], params->name);
+		return false;
+	}
+
+	ofc_sema_expr_t* e = ofc_sema_expr(
+		scope, arg->expr);
+	if (!e) return false;
+
+	if (!ofc_sema_io__spec_check_expr(
+		scope, stmt, params, spec, e))
+	{
+		ofc_sema_expr_delete(e);
+		return false;
+	}
+
+	*expr = e;
+	return true;
+}
+
+bool ofc_sema_io_spec_lhs(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_io_params_t* params,
+	ofc_sema_io_spec_e spec,
+	ofc_sema_lhs_t** lhs)
+{
+	if (!stmt || !params || !lhs
+		|| (spec >= OFC_SEMA_IO_SPEC_COUNT))
+		return false;
+
+	*lhs = NULL;
+
+	const ofc_parse_call_arg_t* arg = params->arg[spec];
+	if (!arg) return true;
+
+	if ((arg->type != OFC_PARSE_CALL_ARG_EXPR) || !arg->expr
+		|| (arg->expr->type != OFC_PARSE_EXPR_VARIABLE))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"%s must be a variable in %s",
+			ofc_sema_io__spec_name[spec], params->name);
+		return false;
+	}
+
+	ofc_sema_lhs_t* l = ofc_sema_lhs_from_expr(
+		scope, arg->expr);
+	if (!l) return false;
+
+	const ofc_sema_type_t* etype
+		= ofc_sema_lhs_type(l);
+	if (!etype)
+	{
+		ofc_sema_lhs_delete(l);
+		return false;
+	}
+
+	bool valid;
+	const char* desc;
+	switch (params->table[spec].type)
+	{
+		case OFC_SEMA_IO_SPEC_TYPE_OUT_INTEGER:
+			valid = ofc_sema_type_is_integer(etype);
+			desc = "an INTEGER";
+			break;
+		case OFC_SEMA_IO_SPEC_TYPE_OUT_LOGICAL:
+			valid = ofc_sema_type_is_logical(etype);
+			desc = "a LOGICAL";
+			break;
+		case OFC_SEMA_IO_SPEC_TYPE_OUT_CHARACTER:
+			valid = ofc_sema_type_is_character(etype);
+			desc = "a CHARACTER";
+			break;
+		default:
+			ofc_sema_lhs_delete(l);
+			return false;
+	}
+
+	if (!valid)
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"%s must be %s variable in %s",
+			ofc_sema_io__spec_name[spec], desc, params->name);
+		ofc_sema_lhs_delete(l);
+		return false;
+	}
+
+	*lhs = l;
+	return true;
+}
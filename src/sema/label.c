@@ -24,14 +24,14 @@ static void ofc_sema_label__delete(
 	if (label->type == OFC_SEMA_LABEL_FORMAT)
 		ofc_sema_format_delete(label->format);
 
-	free(label);
+	ofc_free(label);
 }
 
 static ofc_sema_label_t* ofc_sema_label__stmt(
 	unsigned number, const ofc_sema_stmt_t* stmt)
 {
 	ofc_sema_label_t* label
-		= (ofc_sema_label_t*)malloc(
+		= (ofc_sema_label_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_label_t));
 	if (!label) return NULL;
 
@@ -49,7 +49,7 @@ static ofc_sema_label_t* ofc_sema_label__format(
 		return NULL;
 
 	ofc_sema_label_t* label
-		= (ofc_sema_label_t*)malloc(
+		= (ofc_sema_label_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_label_t));
 	if (!label) return NULL;
 
@@ -116,7 +116,7 @@ static uint8_t ofc_sema_label__stmt_hash(
 ofc_sema_label_map_t* ofc_sema_label_map_create(void)
 {
 	ofc_sema_label_map_t* map
-		= (ofc_sema_label_map_t*)malloc(
+		= (ofc_sema_label_map_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_label_map_t));
 	if (!map) return NULL;
 
@@ -162,7 +162,7 @@ void ofc_sema_label_map_delete(
 	ofc_hashmap_delete(map->stmt);
 	ofc_hashmap_delete(map->label);
 
-	free(map);
+	ofc_free(map);
 }
 
 bool ofc_sema_label_map_add_stmt(
@@ -284,7 +284,7 @@ bool ofc_sema_label_map_add_format(
 		map->format, l))
 	{
 		/* Don't delete because we don't yet own format. */
-		free(l);
+		ofc_free(l);
 		return false;
 	}
 
@@ -330,7 +330,7 @@ ofc_sema_format_label_list_t*
 	ofc_sema_format_label_list_create(void)
 {
 	ofc_sema_format_label_list_t* list
-		= (ofc_sema_format_label_list_t*)malloc(
+		= (ofc_sema_format_label_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_format_label_list_t));
 	if (!list) return NULL;
 
@@ -350,10 +350,10 @@ void ofc_sema_format_label_list_delete(
 		unsigned i;
 		for (i = 0; i < list->count; i++)
 			ofc_sema_label__delete(list->format[i]);
-		free(list->format);
+		ofc_free(list->format);
 	}
 
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_sema_format_label_list_add(
@@ -363,7 +363,7 @@ bool ofc_sema_format_label_list_add(
 	if (!list || !format) return false;
 
 	ofc_sema_label_t** nformat
-		= (ofc_sema_label_t**)realloc(list->format,
+		= (ofc_sema_label_t**)ofc_realloc(OFC_ALLOC_SEMA, list->format,
 			(sizeof(ofc_sema_label_t*) * (list->count + 1)));
 	if (!nformat) return false;
 	list->format = nformat;
@@ -28,7 +28,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_index(
 		return NULL;
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -69,7 +69,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_slice(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -236,7 +236,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_substring(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -280,7 +280,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_member(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -524,13 +524,13 @@ static ofc_sema_lhs_t* ofc_sema__lhs(
 	}
 
 	ofc_sema_lhs_t* slhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!slhs) return NULL;
 
 	if (!ofc_sema_decl_reference(decl))
 	{
-		free(slhs);
+		ofc_free(slhs);
 		return NULL;
 	}
 
@@ -603,7 +603,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs__implicit_do(
 		return NULL;
 
 	ofc_sema_lhs_t* lhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!lhs) return NULL;
 
@@ -1010,7 +1010,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 		return NULL;
 
 	ofc_sema_lhs_t* copy
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_t));
 	if (!copy) return NULL;
 
@@ -1020,7 +1020,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 	{
 		if (!ofc_sema_decl_reference(lhs->decl))
 		{
-			free(copy);
+			ofc_free(copy);
 			return NULL;
 		}
 	}
@@ -1061,7 +1061,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 					lhs->index, replace, with);
 				if (!copy->index)
 				{
-					free(copy);
+					ofc_free(copy);
 					return NULL;
 				}
 				break;
@@ -1079,7 +1079,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 				{
 					ofc_sema_array_slice_delete(copy->slice.slice);
 					ofc_sema_array_delete(copy->slice.dims);
-					free(copy);
+					ofc_free(copy);
 					return NULL;
 				}
 				break;
@@ -1092,7 +1092,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 							lhs->substring.first, replace, with);
 					if (!copy->substring.first)
 					{
-						free(copy);
+						ofc_free(copy);
 						return NULL;
 					}
 				}
@@ -1106,7 +1106,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 					{
 						ofc_sema_expr_delete(
 							copy->substring.first);
-						free(copy);
+						ofc_free(copy);
 						return NULL;
 					}
 				}
@@ -1116,7 +1116,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 				break;
 
 			default:
-				free(copy);
+				ofc_free(copy);
 				return NULL;
 		}
 
@@ -1214,7 +1214,7 @@ void ofc_sema_lhs_delete(
 			break;
 	}
 
-	free(lhs);
+	ofc_free(lhs);
 }
 
 
@@ -1728,16 +1728,16 @@ static ofc_sema_lhs_list_t* ofc_sema_lhs__list(
 		return NULL;
 
 	ofc_sema_lhs_list_t* list
-		= (ofc_sema_lhs_list_t*)malloc(
+		= (ofc_sema_lhs_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_list_t));
 	if (!list) return NULL;
 
 	list->count = 0;
-	list->lhs = (ofc_sema_lhs_t**)malloc(
+	list->lhs = (ofc_sema_lhs_t**)ofc_alloc(OFC_ALLOC_SEMA,
 		plist->count * sizeof(ofc_sema_lhs_t*));
 	if (!list->lhs)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -1794,7 +1794,7 @@ ofc_sema_lhs_list_t* ofc_sema_lhs_list_id(
 ofc_sema_lhs_list_t* ofc_sema_lhs_list_create(void)
 {
 	ofc_sema_lhs_list_t* list
-		= (ofc_sema_lhs_list_t*)malloc(
+		= (ofc_sema_lhs_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_lhs_list_t));
 	if (!list) return NULL;
 
@@ -1811,9 +1811,9 @@ void ofc_sema_lhs_list_delete(ofc_sema_lhs_list_t* list)
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_sema_lhs_delete(list->lhs[i]);
-	free(list->lhs);
+	ofc_free(list->lhs);
 
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_sema_lhs_list_add(
@@ -1824,7 +1824,7 @@ bool ofc_sema_lhs_list_add(
 		return false;
 
 	ofc_sema_lhs_t** nlhs
-		= (ofc_sema_lhs_t**)realloc(list->lhs,
+		= (ofc_sema_lhs_t**)ofc_realloc(OFC_ALLOC_SEMA, list->lhs,
 			((list->count + 1) * sizeof(ofc_sema_lhs_t*)));
 	if (!nlhs) return false;
 	list->lhs = nlhs;
@@ -1908,16 +1908,18 @@ bool ofc_sema_lhs_list_init(
 		bool success = ofc_sema_lhs_init(
 			lhs_elem, init_elem);
 
-		ofc_sema_lhs_delete(lhs_elem);
-		ofc_sema_expr_delete(init_elem);
-
 		if (!success)
 		{
 			/* TODO - Fail atomically? */
 			ofc_sparse_ref_error(init_elem->src,
 				"Invalid initializer");
-			return false;
 		}
+
+		ofc_sema_lhs_delete(lhs_elem);
+		ofc_sema_expr_delete(init_elem);
+
+		if (!success)
+			return false;
 	}
 
 	return true;
@@ -0,0 +1,1270 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ofc/sema.h"
+
+
+/* Every value in an index is a 32-bit little-endian word:
+ *   header: "OFCI", version, file count, symbol count, data size
+ *   file:   path offset, path length
+ *   symbol: kind, file, name offset, name length, record offset
+ *   record: head[4], field count, fields
+ *   field:  flags, type[3], name offset, name length
+ * Offsets are relative to the data which follows the symbol table,
+ * and symbols are sorted by kind then case insensitive name.
+ *
+ * A procedure's head is whether it's a function then its return
+ * type, its fields are its dummy arguments. A COMMON block's head
+ * is its size and whether BLOCK DATA initializes it, the flags of
+ * its fields are the member's element count. */
+
+#define OFC_SEMA_PROJECT__VERSION 1
+
+#define OFC_SEMA_PROJECT__HEADER 5
+#define OFC_SEMA_PROJECT__FILE   2
+#define OFC_SEMA_PROJECT__SYMBOL 5
+#define OFC_SEMA_PROJECT__RECORD 5
+#define OFC_SEMA_PROJECT__FIELD  6
+
+#define OFC_SEMA_PROJECT__ALT_RETURN 1
+#define OFC_SEMA_PROJECT__ARRAY      2
+
+#define OFC_SEMA_PROJECT__UNKNOWN UINT32_MAX
+
+typedef enum
+{
+	OFC_SEMA_PROJECT__PROCEDURE = 0,
+	OFC_SEMA_PROJECT__COMMON,
+} ofc_sema_project__kind_e;
+
+typedef struct
+{
+	uint32_t      flags;
+	uint32_t      type[3];
+	ofc_str_ref_t name;
+} ofc_sema_project__field_t;
+
+typedef struct
+{
+	uint32_t      kind;
+	unsigned      file;
+	ofc_str_ref_t name;
+	uint32_t      head[4];
+
+	unsigned                   count;
+	ofc_sema_project__field_t* field;
+
+	/* Only set for COMMON blocks in the analysed source. */
+	const ofc_sema_common_t* common;
+	unsigned                 seq;
+} ofc_sema_project__symbol_t;
+
+struct ofc_sema_project_s
+{
+	int lock;
+
+	void*  map;
+	size_t size;
+
+	unsigned file_count;
+	unsigned symbol_count;
+
+	const uint8_t* file;
+	const uint8_t* symbol;
+	const uint8_t* data;
+	uint32_t       data_size;
+};
+
+
+static uint32_t ofc_sema_project__get(
+	const uint8_t* base, size_t word)
+{
+	const uint8_t* p = &base[word * 4];
+	return (p[0] | (p[1] << 8) | (p[2] << 16)
+		| ((uint32_t)p[3] << 24));
+}
+
+static bool ofc_sema_project__str(
+	const ofc_sema_project_t* project,
+	uint32_t offset, uint32_t size,
+	ofc_str_ref_t* str)
+{
+	if ((offset > project->data_size)
+		|| (size > (project->data_size - offset)))
+		return false;
+
+	*str = ofc_str_ref(
+		(const char*)&project->data[offset], size);
+	return true;
+}
+
+static int ofc_sema_project__name_compare(
+	ofc_str_ref_t a, ofc_str_ref_t b)
+{
+	unsigned size = (a.size < b.size ? a.size : b.size);
+
+	unsigned i;
+	for (i = 0; i < size; i++)
+	{
+		int ca = toupper((unsigned char)a.base[i]);
+		int cb = toupper((unsigned char)b.base[i]);
+		if (ca != cb)
+			return (ca < cb ? -1 : 1);
+	}
+
+	if (a.size != b.size)
+		return (a.size < b.size ? -1 : 1);
+	return 0;
+}
+
+
+/* Runs updating the same index are serialized on a lock file beside
+   it, since the index itself is replaced rather than modified. */
+static int ofc_sema_project__lock(const char* path)
+{
+	char lock_path[strlen(path) + 6];
+	snprintf(lock_path, sizeof(lock_path), "%s.lock", path);
+
+	int fd = open(lock_path, (O_RDWR | O_CREAT), 0666);
+	if (fd < 0) return -1;
+
+	while (flock(fd, LOCK_EX) != 0)
+	{
+		if (errno != EINTR)
+		{
+			close(fd);
+			return -1;
+		}
+	}
+
+	return fd;
+}
+
+static void ofc_sema_project__unmap(ofc_sema_project_t* project)
+{
+	if (project->map)
+		munmap(project->map, project->size);
+
+	project->map          = NULL;
+	project->size         = 0;
+	project->file_count   = 0;
+	project->symbol_count = 0;
+	project->file         = NULL;
+	project->symbol       = NULL;
+	project->data         = NULL;
+	project->data_size    = 0;
+}
+
+ofc_sema_project_t* ofc_sema_project_load(
+	const char* path, bool* discarded)
+{
+	if (discarded)
+		*discarded = false;
+
+	if (!path)
+		return NULL;
+
+	ofc_sema_project_t* project
+		= (ofc_sema_project_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_project_t));
+	if (!project) return NULL;
+
+	project->map = NULL;
+	ofc_sema_project__unmap(project);
+
+	project->lock = ofc_sema_project__lock(path);
+	if (project->lock < 0)
+	{
+		ofc_free(project);
+		return NULL;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		if (errno == ENOENT)
+			return project;
+		ofc_sema_project_delete(project);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		ofc_sema_project_delete(project);
+		return NULL;
+	}
+
+	if (st.st_size == 0)
+	{
+		close(fd);
+		return project;
+	}
+
+	void* map = mmap(NULL, st.st_size,
+		PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		ofc_sema_project_delete(project);
+		return NULL;
+	}
+
+	project->map  = map;
+	project->size = st.st_size;
+
+	/* An index we can't read is only a cache of summaries,
+	   so it's discarded and rebuilt rather than failing. */
+	const uint8_t* base = (const uint8_t*)map;
+	size_t words = (project->size / 4);
+	if ((words < OFC_SEMA_PROJECT__HEADER)
+		|| (memcmp(base, "OFCI", 4) != 0)
+		|| (ofc_sema_project__get(base, 1)
+			!= OFC_SEMA_PROJECT__VERSION))
+	{
+		ofc_sema_project__unmap(project);
+		if (discarded) *discarded = true;
+		return project;
+	}
+
+	project->file_count   = ofc_sema_project__get(base, 2);
+	project->symbol_count = ofc_sema_project__get(base, 3);
+	project->data_size    = ofc_sema_project__get(base, 4);
+
+	size_t table = OFC_SEMA_PROJECT__HEADER
+		+ ((size_t)project->file_count * OFC_SEMA_PROJECT__FILE)
+		+ ((size_t)project->symbol_count * OFC_SEMA_PROJECT__SYMBOL);
+	if ((table > words)
+		|| (project->data_size != (project->size - (table * 4))))
+	{
+		ofc_sema_project__unmap(project);
+		if (discarded) *discarded = true;
+		return project;
+	}
+
+	project->file = &base[OFC_SEMA_PROJECT__HEADER * 4];
+	project->symbol = &project->file[
+		project->file_count * OFC_SEMA_PROJECT__FILE * 4];
+	project->data = &base[table * 4];
+	return project;
+}
+
+void ofc_sema_project_delete(ofc_sema_project_t* project)
+{
+	if (!project)
+		return;
+
+	ofc_sema_project__unmap(project);
+	if (project->lock >= 0)
+		close(project->lock);
+	ofc_free(project);
+}
+
+
+static bool ofc_sema_project__file(
+	const ofc_sema_project_t* project,
+	unsigned file, ofc_str_ref_t* path)
+{
+	if (file >= project->file_count)
+		return false;
+
+	size_t w = (file * OFC_SEMA_PROJECT__FILE);
+	return ofc_sema_project__str(project,
+		ofc_sema_project__get(project->file, w),
+		ofc_sema_project__get(project->file, (w + 1)),
+		path);
+}
+
+static bool ofc_sema_project__symbol_key(
+	const ofc_sema_project_t* project, unsigned i,
+	uint32_t* kind, unsigned* file, ofc_str_ref_t* name)
+{
+	size_t w = ((size_t)i * OFC_SEMA_PROJECT__SYMBOL);
+	*kind = ofc_sema_project__get(project->symbol, w);
+	*file = ofc_sema_project__get(project->symbol, (w + 1));
+	return ofc_sema_project__str(project,
+		ofc_sema_project__get(project->symbol, (w + 2)),
+		ofc_sema_project__get(project->symbol, (w + 3)),
+		name);
+}
+
+static void ofc_sema_project__symbol_cleanup(
+	ofc_sema_project__symbol_t* symbol)
+{
+	ofc_free(symbol->field);
+	symbol->field = NULL;
+	symbol->count = 0;
+}
+
+static bool ofc_sema_project__symbol(
+	const ofc_sema_project_t* project, unsigned i,
+	ofc_sema_project__symbol_t* symbol)
+{
+	if (i >= project->symbol_count)
+		return false;
+
+	symbol->field  = NULL;
+	symbol->count  = 0;
+	symbol->common = NULL;
+	symbol->seq    = i;
+
+	if (!ofc_sema_project__symbol_key(project, i,
+		&symbol->kind, &symbol->file, &symbol->name))
+		return false;
+
+	uint32_t offset = ofc_sema_project__get(project->symbol,
+		(((size_t)i * OFC_SEMA_PROJECT__SYMBOL) + 4));
+	if ((offset & 3) || (offset > project->data_size)
+		|| (((project->data_size - offset) / 4)
+			< OFC_SEMA_PROJECT__RECORD))
+		return false;
+
+	const uint8_t* record = &project->data[offset];
+	size_t words = ((project->data_size - offset) / 4);
+
+	unsigned j;
+	for (j = 0; j < 4; j++)
+		symbol->head[j] = ofc_sema_project__get(record, j);
+
+	uint32_t count = ofc_sema_project__get(record, 4);
+	if (count > ((words - OFC_SEMA_PROJECT__RECORD)
+		/ OFC_SEMA_PROJECT__FIELD))
+		return false;
+
+	if (count == 0)
+		return true;
+
+	symbol->field = (ofc_sema_project__field_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_project__field_t) * count);
+	if (!symbol->field) return false;
+	symbol->count = count;
+
+	for (j = 0; j < count; j++)
+	{
+		size_t w = OFC_SEMA_PROJECT__RECORD
+			+ (j * OFC_SEMA_PROJECT__FIELD);
+
+		ofc_sema_project__field_t* field
+			= &symbol->field[j];
+		field->flags   = ofc_sema_project__get(record, w);
+		field->type[0] = ofc_sema_project__get(record, (w + 1));
+		field->type[1] = ofc_sema_project__get(record, (w + 2));
+		field->type[2] = ofc_sema_project__get(record, (w + 3));
+
+		if (!ofc_sema_project__str(project,
+			ofc_sema_project__get(record, (w + 4)),
+			ofc_sema_project__get(record, (w + 5)),
+			&field->name))
+		{
+			ofc_sema_project__symbol_cleanup(symbol);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Finds the first symbol of kind named name which isn't
+   from source, returns the symbol count if there's none. */
+static unsigned ofc_sema_project__find(
+	const ofc_sema_project_t* project,
+	uint32_t kind, ofc_str_ref_t name,
+	const char* source)
+{
+	unsigned lo = 0, hi = project->symbol_count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+
+		uint32_t      mkind;
+		unsigned      mfile;
+		ofc_str_ref_t mname;
+		if (!ofc_sema_project__symbol_key(
+			project, mid, &mkind, &mfile, &mname))
+			return project->symbol_count;
+
+		int order = (mkind != kind
+			? (mkind < kind ? -1 : 1)
+			: ofc_sema_project__name_compare(mname, name));
+		if (order < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	unsigned i;
+	for (i = lo; i < project->symbol_count; i++)
+	{
+		uint32_t      ikind;
+		unsigned      ifile;
+		ofc_str_ref_t iname;
+		if (!ofc_sema_project__symbol_key(
+			project, i, &ikind, &ifile, &iname)
+			|| (ikind != kind)
+			|| (ofc_sema_project__name_compare(iname, name) != 0))
+			break;
+
+		ofc_str_ref_t path;
+		if (ofc_sema_project__file(project, ifile, &path)
+			&& !ofc_str_ref_equal_strz(path, source))
+			return i;
+	}
+
+	return project->symbol_count;
+}
+
+
+static void ofc_sema_project__type_encode(
+	const ofc_sema_type_t* type, uint32_t* word)
+{
+	word[0] = OFC_SEMA_TYPE_COUNT;
+	word[1] = 0;
+	word[2] = 0;
+
+	if (!type)
+		return;
+
+	word[0] = type->type;
+	switch (type->type)
+	{
+		case OFC_SEMA_TYPE_CHARACTER:
+			word[2] = (type->len_var
+				? OFC_SEMA_PROJECT__UNKNOWN : type->len);
+			/* Fall through. */
+		case OFC_SEMA_TYPE_LOGICAL:
+		case OFC_SEMA_TYPE_INTEGER:
+		case OFC_SEMA_TYPE_REAL:
+		case OFC_SEMA_TYPE_COMPLEX:
+		case OFC_SEMA_TYPE_BYTE:
+			word[1] = type->kind;
+			break;
+
+		default:
+			break;
+	}
+}
+
+static const ofc_sema_type_t* ofc_sema_project__type_decode(
+	const uint32_t* word)
+{
+	switch (word[0])
+	{
+		case OFC_SEMA_TYPE_LOGICAL:
+		case OFC_SEMA_TYPE_INTEGER:
+		case OFC_SEMA_TYPE_REAL:
+		case OFC_SEMA_TYPE_COMPLEX:
+		case OFC_SEMA_TYPE_BYTE:
+			return ofc_sema_type_create_primitive(
+				word[0], word[1]);
+
+		case OFC_SEMA_TYPE_CHARACTER:
+			return ofc_sema_type_create_character(word[1],
+				(word[2] == OFC_SEMA_PROJECT__UNKNOWN ? 0 : word[2]),
+				(word[2] == OFC_SEMA_PROJECT__UNKNOWN));
+
+		/* Only whether an argument is a procedure is checked. */
+		case OFC_SEMA_TYPE_FUNCTION:
+		case OFC_SEMA_TYPE_SUBROUTINE:
+			return ofc_sema_type_subroutine();
+
+		default:
+			break;
+	}
+
+	return NULL;
+}
+
+static ofc_sema_signature_t* ofc_sema_project__signature(
+	const ofc_sema_project__symbol_t* symbol)
+{
+	bool is_function = (symbol->head[0] != 0);
+
+	ofc_sema_signature_t* signature
+		= ofc_sema_signature_create(is_function,
+			(is_function ? ofc_sema_project__type_decode(
+				&symbol->head[1]) : NULL),
+			symbol->count);
+	if (!signature) return NULL;
+
+	unsigned i;
+	for (i = 0; i < symbol->count; i++)
+	{
+		const ofc_sema_project__field_t* field
+			= &symbol->field[i];
+		ofc_sema_call_arg_t* arg
+			= &signature->arg[i];
+
+		arg->name       = field->name;
+		arg->type       = ofc_sema_project__type_decode(field->type);
+		arg->is_array   = ((field->flags & OFC_SEMA_PROJECT__ARRAY) != 0);
+		arg->alt_return = ((field->flags & OFC_SEMA_PROJECT__ALT_RETURN) != 0);
+	}
+
+	return signature;
+}
+
+
+typedef struct
+{
+	unsigned                    count, size;
+	ofc_sema_project__symbol_t* symbol;
+} ofc_sema_project__list_t;
+
+static void ofc_sema_project__list_cleanup(
+	ofc_sema_project__list_t* list)
+{
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+		ofc_sema_project__symbol_cleanup(&list->symbol[i]);
+	ofc_free(list->symbol);
+
+	list->symbol = NULL;
+	list->count  = 0;
+	list->size   = 0;
+}
+
+static ofc_sema_project__symbol_t* ofc_sema_project__list_add(
+	ofc_sema_project__list_t* list, uint32_t kind,
+	unsigned file, ofc_str_ref_t name, unsigned count)
+{
+	if (list->count >= list->size)
+	{
+		unsigned nsize = (list->size > 0
+			? (list->size << 1) : 64);
+		ofc_sema_project__symbol_t* nsymbol
+			= (ofc_sema_project__symbol_t*)ofc_realloc(OFC_ALLOC_SEMA, list->symbol,
+				(sizeof(ofc_sema_project__symbol_t) * nsize));
+		if (!nsymbol) return NULL;
+		list->symbol = nsymbol;
+		list->size   = nsize;
+	}
+
+	ofc_sema_project__symbol_t* symbol
+		= &list->symbol[list->count];
+
+	symbol->kind   = kind;
+	symbol->file   = file;
+	symbol->name   = name;
+	symbol->count  = 0;
+	symbol->field  = NULL;
+	symbol->common = NULL;
+	symbol->seq    = list->count;
+
+	unsigned i;
+	for (i = 0; i < 4; i++)
+		symbol->head[i] = 0;
+
+	if (count > 0)
+	{
+		symbol->field = (ofc_sema_project__field_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_project__field_t) * count);
+		if (!symbol->field) return NULL;
+		symbol->count = count;
+	}
+
+	list->count++;
+	return symbol;
+}
+
+static int ofc_sema_project__symbol_order(
+	const void* a, const void* b)
+{
+	const ofc_sema_project__symbol_t* sa = a;
+	const ofc_sema_project__symbol_t* sb = b;
+
+	if (sa->kind != sb->kind)
+		return (sa->kind < sb->kind ? -1 : 1);
+
+	int order = ofc_sema_project__name_compare(
+		sa->name, sb->name);
+	if (order != 0)
+		return order;
+
+	if (sa->seq != sb->seq)
+		return (sa->seq < sb->seq ? -1 : 1);
+	return 0;
+}
+
+static bool ofc_sema_project__procedure(
+	ofc_sema_project__list_t* list, unsigned file,
+	const ofc_sema_decl_t* decl)
+{
+	ofc_sema_signature_t* signature
+		= ofc_sema_signature(decl->func, decl);
+	if (!signature) return true;
+
+	ofc_sema_project__symbol_t* symbol
+		= ofc_sema_project__list_add(list,
+			OFC_SEMA_PROJECT__PROCEDURE, file,
+			decl->name, signature->count);
+	if (!symbol)
+	{
+		ofc_sema_signature_delete(signature);
+		return false;
+	}
+
+	symbol->head[0] = signature->is_function;
+	ofc_sema_project__type_encode(
+		signature->type, &symbol->head[1]);
+
+	unsigned i;
+	for (i = 0; i < signature->count; i++)
+	{
+		const ofc_sema_call_arg_t* arg
+			= &signature->arg[i];
+		ofc_sema_project__field_t* field
+			= &symbol->field[i];
+
+		field->flags = 0;
+		if (arg->alt_return)
+			field->flags |= OFC_SEMA_PROJECT__ALT_RETURN;
+		if (arg->is_array)
+			field->flags |= OFC_SEMA_PROJECT__ARRAY;
+		ofc_sema_project__type_encode(
+			arg->type, field->type);
+		field->name = arg->name;
+	}
+
+	ofc_sema_signature_delete(signature);
+	return true;
+}
+
+static bool ofc_sema_project__unit_commons(
+	ofc_sema_project__list_t* list, unsigned file,
+	const ofc_sema_scope_t* unit)
+{
+	if (!unit->common)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < unit->common->count; i++)
+	{
+		const ofc_sema_common_t* common
+			= unit->common->common[i];
+
+		ofc_sema_project__symbol_t* symbol
+			= ofc_sema_project__list_add(list,
+				OFC_SEMA_PROJECT__COMMON, file,
+				common->name, common->count);
+		if (!symbol) return false;
+
+		symbol->common  = common;
+		symbol->head[1] = (unit->type == OFC_SEMA_SCOPE_BLOCK_DATA);
+
+		uint64_t size = 0;
+		bool     size_known = true;
+
+		unsigned j;
+		for (j = 0; j < common->count; j++)
+		{
+			ofc_sema_project__field_t* field
+				= &symbol->field[j];
+
+			const ofc_sema_type_t*  type  = NULL;
+			const ofc_sema_array_t* array = NULL;
+
+			const ofc_sema_decl_t* decl = common->decl[j];
+			field->name = common->spec[j]->name.string;
+			if (decl)
+			{
+				type  = decl->type;
+				array = decl->array;
+			}
+			else
+			{
+				const ofc_sema_spec_t* spec
+					= ofc_sema_scope_spec_find_final_cached(
+						unit, common->spec[j]->name);
+				if (spec)
+				{
+					type  = ofc_sema_type_spec(spec);
+					array = spec->array;
+				}
+			}
+
+			uint64_t elems = 1;
+			if (array && (!ofc_sema_array_total64(array, &elems)
+				|| (elems >= OFC_SEMA_PROJECT__UNKNOWN)))
+				elems = 0;
+
+			unsigned tsize;
+			if ((elems == 0) || !ofc_sema_type_size(type, &tsize))
+				size_known = false;
+			else
+				size += (tsize * elems);
+
+			field->flags = elems;
+			ofc_sema_project__type_encode(type, field->type);
+		}
+
+		symbol->head[0] = ((size_known && (size < OFC_SEMA_PROJECT__UNKNOWN))
+			? size : OFC_SEMA_PROJECT__UNKNOWN);
+	}
+
+	return true;
+}
+
+/* Summarizes root, with a single entry for each COMMON block. */
+static bool ofc_sema_project__summary(
+	ofc_sema_project__list_t* list, unsigned file,
+	const ofc_sema_scope_t* root)
+{
+	unsigned first = list->count;
+
+	if (!ofc_sema_project__unit_commons(list, file, root))
+		return false;
+
+	unsigned i;
+	if (root->child)
+	{
+		for (i = 0; i < root->child->count; i++)
+		{
+			if (!ofc_sema_project__unit_commons(
+				list, file, root->child->scope[i]))
+				return false;
+		}
+	}
+
+	if (root->decl)
+	{
+		for (i = 0; i < root->decl->count; i++)
+		{
+			const ofc_sema_decl_t* decl
+				= root->decl->decl[i];
+			if (!decl->func
+				|| (decl->func->type == OFC_SEMA_SCOPE_STMT_FUNC))
+				continue;
+
+			if (!ofc_sema_project__procedure(list, file, decl)
+				|| !ofc_sema_project__unit_commons(
+					list, file, decl->func))
+				return false;
+		}
+	}
+
+	qsort(&list->symbol[first], (list->count - first),
+		sizeof(ofc_sema_project__symbol_t),
+		ofc_sema_project__symbol_order);
+
+	/* Keep the first declaration of each COMMON block,
+	   but remember whether any BLOCK DATA initializes it. */
+	unsigned j;
+	for (i = first, j = first; i < list->count; i++)
+	{
+		if ((j > first)
+			&& (list->symbol[i].kind == OFC_SEMA_PROJECT__COMMON)
+			&& (list->symbol[j - 1].kind == OFC_SEMA_PROJECT__COMMON)
+			&& (ofc_sema_project__name_compare(
+				list->symbol[j - 1].name, list->symbol[i].name) == 0))
+		{
+			list->symbol[j - 1].head[1] |= list->symbol[i].head[1];
+			ofc_sema_project__symbol_cleanup(&list->symbol[i]);
+			continue;
+		}
+
+		list->symbol[j++] = list->symbol[i];
+	}
+	list->count = j;
+
+	return true;
+}
+
+
+static void ofc_sema_project__common_check(
+	const ofc_sema_project_t* project,
+	const char* source,
+	const ofc_sema_project__symbol_t* symbol)
+{
+	const ofc_sema_common_t* common = symbol->common;
+	if (!common || (common->count == 0))
+		return;
+
+	ofc_sparse_ref_t src = common->spec[0]->name;
+
+	unsigned i = ofc_sema_project__find(project,
+		OFC_SEMA_PROJECT__COMMON, symbol->name, source);
+	if (i >= project->symbol_count)
+		return;
+
+	ofc_sema_project__symbol_t other;
+	if (!ofc_sema_project__symbol(project, i, &other))
+		return;
+
+	ofc_str_ref_t path;
+	if (!ofc_sema_project__file(project, other.file, &path))
+	{
+		ofc_sema_project__symbol_cleanup(&other);
+		return;
+	}
+
+	/* Blank COMMON may be a different size in each program unit. */
+	if (!ofc_str_ref_empty(symbol->name)
+		&& (symbol->head[0] != OFC_SEMA_PROJECT__UNKNOWN)
+		&& (other.head[0] != OFC_SEMA_PROJECT__UNKNOWN)
+		&& (symbol->head[0] != other.head[0]))
+	{
+		ofc_sparse_ref_warning(src,
+			"COMMON block /%.*s/ is %u bytes, but %u bytes in '%.*s'",
+			symbol->name.size, symbol->name.base,
+			symbol->head[0], other.head[0],
+			path.size, path.base);
+	}
+	else if (symbol->count == other.count)
+	{
+		unsigned j;
+		for (j = 0; j < symbol->count; j++)
+		{
+			const ofc_sema_type_t* a
+				= ofc_sema_project__type_decode(symbol->field[j].type);
+			const ofc_sema_type_t* b
+				= ofc_sema_project__type_decode(other.field[j].type);
+			if (a && b && !ofc_sema_type_compatible(a, b))
+			{
+				ofc_sparse_ref_warning(src,
+					"Member %u of COMMON block /%.*s/ is %s, but %s in '%.*s'",
+					(j + 1), symbol->name.size, symbol->name.base,
+					ofc_sema_type_str_rep(a), ofc_sema_type_str_rep(b),
+					path.size, path.base);
+				break;
+			}
+		}
+	}
+	ofc_sema_project__symbol_cleanup(&other);
+
+	if (!symbol->head[1])
+		return;
+
+	/* Look for any other file whose BLOCK DATA initializes it too. */
+	for (; i < project->symbol_count; i++)
+	{
+		uint32_t      kind;
+		unsigned      file;
+		ofc_str_ref_t name;
+		if (!ofc_sema_project__symbol_key(
+			project, i, &kind, &file, &name)
+			|| (kind != OFC_SEMA_PROJECT__COMMON)
+			|| (ofc_sema_project__name_compare(name, symbol->name) != 0))
+			break;
+
+		if (!ofc_sema_project__file(project, file, &path)
+			|| ofc_str_ref_equal_strz(path, source)
+			|| !ofc_sema_project__symbol(project, i, &other))
+			continue;
+
+		bool init = (other.head[1] != 0);
+		ofc_sema_project__symbol_cleanup(&other);
+
+		if (init)
+		{
+			ofc_sparse_ref_warning(src,
+				"COMMON block /%.*s/ is also initialized by BLOCK DATA in '%.*s'",
+				symbol->name.size, symbol->name.base,
+				path.size, path.base);
+			break;
+		}
+	}
+}
+
+bool ofc_sema_project_check(
+	const ofc_sema_project_t* project,
+	const char* source, ofc_sema_scope_t* root)
+{
+	if (!project || !source || !root)
+		return false;
+
+	if (project->symbol_count == 0)
+		return true;
+
+	ofc_sema_callgraph_t* graph = root->callgraph;
+	if (graph && graph->linked && (graph->node_count > 0))
+	{
+		unsigned* origin = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(unsigned) * graph->node_count);
+		if (!origin) return false;
+
+		unsigned i;
+		for (i = 0; i < graph->node_count; i++)
+		{
+			ofc_sema_callgraph_node_t* node
+				= graph->node[i];
+			origin[i] = project->file_count;
+			if (node->scope) continue;
+
+			unsigned s = ofc_sema_project__find(project,
+				OFC_SEMA_PROJECT__PROCEDURE, node->name, source);
+			if (s >= project->symbol_count)
+				continue;
+
+			ofc_sema_project__symbol_t symbol;
+			if (!ofc_sema_project__symbol(project, s, &symbol))
+				continue;
+
+			ofc_sema_signature_delete(node->signature);
+			node->signature = ofc_sema_project__signature(&symbol);
+			if (node->signature)
+				origin[i] = symbol.file;
+			ofc_sema_project__symbol_cleanup(&symbol);
+		}
+
+		for (i = 0; i < graph->count; i++)
+		{
+			ofc_sema_call_t* call = graph->call[i];
+			unsigned file = origin[call->callee_node];
+
+			ofc_str_ref_t path;
+			if ((file >= project->file_count)
+				|| !ofc_sema_project__file(project, file, &path))
+				continue;
+
+			char* where = (char*)ofc_alloc(OFC_ALLOC_SEMA, (path.size + 1));
+			if (!where)
+			{
+				ofc_free(origin);
+				return false;
+			}
+			memcpy(where, path.base, path.size);
+			where[path.size] = '\0';
+
+			ofc_sema_call_check(call,
+				graph->node[call->callee_node]->signature,
+				where);
+			ofc_free(where);
+		}
+
+		ofc_free(origin);
+	}
+
+	ofc_sema_project__list_t list = { 0, 0, NULL };
+	if (!ofc_sema_project__summary(&list, 0, root))
+	{
+		ofc_sema_project__list_cleanup(&list);
+		return false;
+	}
+
+	unsigned i;
+	for (i = 0; i < list.count; i++)
+		ofc_sema_project__common_check(
+			project, source, &list.symbol[i]);
+
+	ofc_sema_project__list_cleanup(&list);
+	return true;
+}
+
+
+typedef struct
+{
+	uint8_t* base;
+	size_t   size, max;
+	bool     fail;
+} ofc_sema_project__buff_t;
+
+static void ofc_sema_project__write(
+	ofc_sema_project__buff_t* buff,
+	const void* base, size_t size)
+{
+	if (buff->fail || (size == 0))
+		return;
+
+	if ((buff->size + size) > buff->max)
+	{
+		size_t nmax = (buff->max << 1);
+		if (nmax < (buff->size + size))
+			nmax = (buff->size + size);
+		if (nmax < 4096)
+			nmax = 4096;
+
+		uint8_t* nbase = (uint8_t*)ofc_realloc(OFC_ALLOC_SEMA, buff->base, nmax);
+		if (!nbase)
+		{
+			buff->fail = true;
+			return;
+		}
+		buff->base = nbase;
+		buff->max  = nmax;
+	}
+
+	memcpy(&buff->base[buff->size], base, size);
+	buff->size += size;
+}
+
+static void ofc_sema_project__put(
+	ofc_sema_project__buff_t* buff, uint32_t value)
+{
+	uint8_t word[4] =
+	{
+		(value & 0xFF), ((value >> 8) & 0xFF),
+		((value >> 16) & 0xFF), ((value >> 24) & 0xFF),
+	};
+	ofc_sema_project__write(buff, word, 4);
+}
+
+/* Strings are padded so records stay word aligned. */
+static uint32_t ofc_sema_project__put_str(
+	ofc_sema_project__buff_t* buff, ofc_str_ref_t str)
+{
+	uint32_t offset = buff->size;
+	ofc_sema_project__write(buff, str.base, str.size);
+
+	static const uint8_t pad[4] = { 0, 0, 0, 0 };
+	ofc_sema_project__write(buff, pad, ((4 - (str.size & 3)) & 3));
+	return offset;
+}
+
+static bool ofc_sema_project__save(
+	const ofc_sema_project_t* project, const char* path,
+	unsigned file_count, const ofc_str_ref_t* file,
+	const ofc_sema_project__list_t* list)
+{
+	ofc_sema_project__buff_t table = { NULL, 0, 0, false };
+	ofc_sema_project__buff_t data  = { NULL, 0, 0, false };
+
+	ofc_sema_project__write(&table, "OFCI", 4);
+	ofc_sema_project__put(&table, OFC_SEMA_PROJECT__VERSION);
+	ofc_sema_project__put(&table, file_count);
+	ofc_sema_project__put(&table, list->count);
+	/* Data size is patched in once it's known. */
+	ofc_sema_project__put(&table, 0);
+
+	unsigned i;
+	for (i = 0; i < file_count; i++)
+	{
+		ofc_sema_project__put(&table,
+			ofc_sema_project__put_str(&data, file[i]));
+		ofc_sema_project__put(&table, file[i].size);
+	}
+
+	for (i = 0; i < list->count; i++)
+	{
+		const ofc_sema_project__symbol_t* symbol
+			= &list->symbol[i];
+
+		uint32_t name = ofc_sema_project__put_str(
+			&data, symbol->name);
+
+		/* Field counts come from the old index, so they
+		   could be too large for the stack. */
+		uint32_t* field_name = NULL;
+		if (symbol->count > 0)
+		{
+			field_name = (uint32_t*)ofc_alloc(OFC_ALLOC_SEMA,
+				sizeof(uint32_t) * symbol->count);
+			if (!field_name)
+			{
+				data.fail = true;
+				break;
+			}
+		}
+
+		unsigned j;
+		for (j = 0; j < symbol->count; j++)
+		{
+			field_name[j] = ofc_sema_project__put_str(
+				&data, symbol->field[j].name);
+		}
+
+		uint32_t record = data.size;
+		for (j = 0; j < 4; j++)
+			ofc_sema_project__put(&data, symbol->head[j]);
+		ofc_sema_project__put(&data, symbol->count);
+
+		for (j = 0; j < symbol->count; j++)
+		{
+			const ofc_sema_project__field_t* field
+				= &symbol->field[j];
+			ofc_sema_project__put(&data, field->flags);
+			ofc_sema_project__put(&data, field->type[0]);
+			ofc_sema_project__put(&data, field->type[1]);
+			ofc_sema_project__put(&data, field->type[2]);
+			ofc_sema_project__put(&data, field_name[j]);
+			ofc_sema_project__put(&data, field->name.size);
+		}
+		ofc_free(field_name);
+
+		ofc_sema_project__put(&table, symbol->kind);
+		ofc_sema_project__put(&table, symbol->file);
+		ofc_sema_project__put(&table, name);
+		ofc_sema_project__put(&table, symbol->name.size);
+		ofc_sema_project__put(&table, record);
+	}
+
+	bool success = (!table.fail && !data.fail
+		&& (data.size < UINT32_MAX));
+	if (success)
+	{
+		uint32_t size = data.size;
+		table.base[16] = (size & 0xFF);
+		table.base[17] = ((size >> 8) & 0xFF);
+		table.base[18] = ((size >> 16) & 0xFF);
+		table.base[19] = ((size >> 24) & 0xFF);
+	}
+
+	/* Rebuilding a project mostly reanalyses files which haven't
+	   changed, so don't rewrite an index which would be identical. */
+	if (success && project->map
+		&& (project->size == (table.size + data.size))
+		&& (memcmp(project->map, table.base, table.size) == 0)
+		&& (memcmp(&((const uint8_t*)project->map)[table.size],
+			data.base, data.size) == 0))
+	{
+		ofc_free(table.base);
+		ofc_free(data.base);
+		return true;
+	}
+
+	/* Write a temporary then rename it, so readers never see
+	   a partially written index. */
+	char temp[strlen(path) + 8];
+	snprintf(temp, sizeof(temp), "%s.XXXXXX", path);
+
+	int fd = (success ? mkstemp(temp) : -1);
+	FILE* stream = NULL;
+	if (fd >= 0)
+	{
+		/* mkstemp creates the file private to us. */
+		mode_t mask = umask(0);
+		umask(mask);
+		fchmod(fd, (0666 & ~mask));
+
+		stream = fdopen(fd, "w");
+		if (!stream) close(fd);
+	}
+
+	if (stream)
+	{
+		fwrite(table.base, 1, table.size, stream);
+		fwrite(data.base , 1, data.size , stream);
+		success = !ferror(stream);
+		success = ((fclose(stream) == 0) && success);
+		if (success)
+			success = (rename(temp, path) == 0);
+		if (!success)
+			unlink(temp);
+	}
+	else
+	{
+		success = false;
+	}
+
+	ofc_free(table.base);
+	ofc_free(data.base);
+	return success;
+}
+
+bool ofc_sema_project_update(
+	const ofc_sema_project_t* project,
+	const char* source, const ofc_sema_scope_t* root,
+	const char* path)
+{
+	if (!project || !source || !root || !path)
+		return false;
+
+	/* Every file in the old index, source keeps its place so that an
+	   unchanged summary gives an identical index, or is appended. */
+	ofc_str_ref_t* file = (ofc_str_ref_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_str_ref_t) * (project->file_count + 1));
+	unsigned* remap = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(unsigned) * (project->file_count + 1));
+	if (!file || !remap)
+	{
+		ofc_free(file);
+		ofc_free(remap);
+		return false;
+	}
+
+	unsigned file_count = 0;
+	unsigned self = project->file_count;
+
+	unsigned i;
+	for (i = 0; i < project->file_count; i++)
+	{
+		remap[i] = project->file_count;
+
+		ofc_str_ref_t fpath;
+		if (!ofc_sema_project__file(project, i, &fpath))
+			continue;
+
+		/* The old symbols of source are dropped. */
+		if (ofc_str_ref_equal_strz(fpath, source))
+		{
+			if (self >= project->file_count)
+				self = file_count++;
+			continue;
+		}
+
+		remap[i] = file_count;
+		file[file_count++] = fpath;
+	}
+	if (self >= project->file_count)
+		self = file_count++;
+	file[self] = ofc_str_ref_from_strz(source);
+
+	ofc_sema_project__list_t list = { 0, 0, NULL };
+	for (i = 0; i < project->symbol_count; i++)
+	{
+		uint32_t      kind;
+		unsigned      sfile;
+		ofc_str_ref_t name;
+		if (!ofc_sema_project__symbol_key(
+			project, i, &kind, &sfile, &name)
+			|| (sfile >= project->file_count)
+			|| (remap[sfile] >= project->file_count))
+			continue;
+
+		ofc_sema_project__symbol_t* symbol
+			= ofc_sema_project__list_add(&list, kind, 0, name, 0);
+		if (!symbol)
+		{
+			ofc_sema_project__list_cleanup(&list);
+			ofc_free(file);
+			ofc_free(remap);
+			return false;
+		}
+
+		if (!ofc_sema_project__symbol(project, i, symbol))
+		{
+			list.count--;
+			continue;
+		}
+		symbol->file = remap[sfile];
+		symbol->seq  = list.count - 1;
+	}
+
+	bool success = ofc_sema_project__summary(&list, self, root);
+	if (success)
+	{
+		qsort(list.symbol, list.count,
+			sizeof(ofc_sema_project__symbol_t),
+			ofc_sema_project__symbol_order);
+
+		success = ofc_sema_project__save(
+			project, path, file_count, file, &list);
+	}
+
+	ofc_sema_project__list_cleanup(&list);
+	ofc_free(file);
+	ofc_free(remap);
+	return success;
+}
@@ -14,6 +14,8 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/print.h"
+#include "ofc/context.h"
 
 
 void ofc_sema_scope_delete(
@@ -40,6 +42,9 @@ void ofc_sema_scope_delete(
 	ofc_sema_structure_list_delete(scope->structure);
 	ofc_sema_structure_list_delete(scope->derived_type);
 
+	ofc_hashmap_delete(scope->cache);
+	ofc_sema_callgraph_delete(scope->callgraph);
+
 	switch (scope->type)
 	{
 		case OFC_SEMA_SCOPE_STMT_FUNC:
@@ -52,7 +57,7 @@ void ofc_sema_scope_delete(
 			break;
 	}
 
-	free(scope);
+	ofc_free(scope);
 }
 
 static bool ofc_sema_scope__add_child(
@@ -82,7 +87,7 @@ static ofc_sema_scope_t* ofc_sema_scope__create(
 	ofc_sema_scope_e       type)
 {
 	ofc_sema_scope_t* scope
-		= (ofc_sema_scope_t*)malloc(
+		= (ofc_sema_scope_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_scope_t));
 	if (!scope) return NULL;
 
@@ -98,6 +103,7 @@ static ofc_sema_scope_t* ofc_sema_scope__create(
 	scope->type        = type;
 	scope->name        = OFC_STR_REF_EMPTY;
 	scope->args        = NULL;
+	scope->src         = OFC_SPARSE_REF_EMPTY;
 
 	scope->implicit = (parent
 		? ofc_sema_implicit_copy(parent->implicit) : NULL);
@@ -138,6 +144,14 @@ static ofc_sema_scope_t* ofc_sema_scope__create(
 	scope->external = false;
 	scope->intrinsic = false;
 
+	scope->cache            = NULL;
+	scope->cache_decl_epoch = 1;
+	scope->cache_spec_epoch = 1;
+	scope->cache_hit        = 0;
+	scope->cache_miss       = 0;
+
+	scope->callgraph = NULL;
+
 	switch (scope->type)
 	{
 		case OFC_SEMA_SCOPE_STMT_FUNC:
@@ -239,6 +253,10 @@ static bool ofc_sema_scope__body(
 		(void*)ofc_sema_scope__body_scan_equivalence))
 		return false;
 
+	if (ofc_context_current()->global_opts.dataflow
+		&& !ofc_sema_dataflow(scope))
+		return false;
+
 	/* TODO - Check for unused specifiers. */
 
 	/* TODO - Check declarations exist and are used for FUNCTION arguments. */
@@ -294,6 +312,7 @@ bool ofc_sema_scope_subroutine(
 			OFC_SEMA_SCOPE_SUBROUTINE);
 	if (!sub_scope) return false;
 	sub_scope->name = name.string;
+	sub_scope->src  = stmt->src;
 
 	if (stmt->program.args)
 	{
@@ -340,6 +359,7 @@ bool ofc_sema_scope_function(
 			OFC_SEMA_SCOPE_FUNCTION);
 	if (!func_scope) return false;
 	func_scope->name = name.string;
+	func_scope->src  = stmt->src;
 
 	if (stmt->program.args)
 	{
@@ -382,6 +402,7 @@ bool ofc_sema_scope_function(
 			ofc_sema_scope_delete(func_scope);
 			return false;
 		}
+		ofc_sema_scope_cache_invalidate(func_scope);
 	}
 
 	if (!ofc_sema_scope__body(
@@ -487,6 +508,16 @@ ofc_sema_scope_t* ofc_sema_scope_global(
 		return NULL;
 	}
 
+	/* Calls can only be checked once every program unit is known. */
+	if (!scope->callgraph)
+		scope->callgraph = ofc_sema_callgraph_create(
+			ofc_sema_scope_get_lang_opts(scope).case_sensitive);
+	if (!ofc_sema_callgraph_link(scope->callgraph, scope))
+	{
+		ofc_sema_scope_delete(scope);
+		return NULL;
+	}
+
 	return scope;
 }
 
@@ -504,6 +535,7 @@ ofc_sema_scope_t* ofc_sema_scope_program(
 	if (!program) return NULL;
 
 	program->name = stmt->program.name.string;
+	program->src  = stmt->src;
 
 	if (!ofc_sema_scope__body(
 		program, stmt->program.body))
@@ -625,6 +657,7 @@ ofc_sema_scope_t* ofc_sema_scope_block_data(
 	if (!block_data) return NULL;
 
 	block_data->name = stmt->program.name.string;
+	block_data->src  = stmt->src;
 
 	if (!ofc_sema_scope__body(
 		block_data, stmt->program.body))
@@ -724,6 +757,142 @@ const ofc_sema_label_t* ofc_sema_scope_label_find(
 }
 
 
+typedef struct
+{
+	ofc_str_ref_t          name;
+	unsigned               decl_epoch;
+	ofc_sema_decl_t*       decl;
+	unsigned               spec_epoch;
+	ofc_sema_spec_t*       spec;
+	const ofc_sema_spec_t* spec_base;
+} ofc_sema_scope__cache_t;
+
+static const ofc_str_ref_t* ofc_sema_scope__cache_key(
+	const ofc_sema_scope__cache_t* entry)
+{
+	return (entry ? &entry->name : NULL);
+}
+
+static void ofc_sema_scope__cache_delete(
+	ofc_sema_scope__cache_t* entry)
+{
+	if (!entry)
+		return;
+
+	ofc_sema_spec_delete(entry->spec);
+	ofc_free((char*)entry->name.base);
+	ofc_free(entry);
+}
+
+static ofc_sema_scope_t* ofc_sema_scope__cache_top(
+	const ofc_sema_scope_t* scope)
+{
+	while (scope->parent)
+		scope = scope->parent;
+	return (ofc_sema_scope_t*)scope;
+}
+
+/* Names are copied since they may not outlive the scope. */
+static ofc_sema_scope__cache_t* ofc_sema_scope__cache(
+	const ofc_sema_scope_t* scope, ofc_str_ref_t name)
+{
+	if (!scope || ofc_str_ref_empty(name))
+		return NULL;
+
+	ofc_sema_scope_t* mscope = (ofc_sema_scope_t*)scope;
+	if (!mscope->cache)
+	{
+		ofc_lang_opts_t opts
+			= ofc_sema_scope_get_lang_opts(scope);
+		mscope->cache = ofc_hashmap_create(
+			(void*)(opts.case_sensitive
+				? ofc_str_ref_ptr_hash
+				: ofc_str_ref_ptr_hash_ci),
+			(void*)(opts.case_sensitive
+				? ofc_str_ref_ptr_equal
+				: ofc_str_ref_ptr_equal_ci),
+			(void*)ofc_sema_scope__cache_key,
+			(void*)ofc_sema_scope__cache_delete);
+		if (!mscope->cache) return NULL;
+	}
+
+	ofc_sema_scope__cache_t* entry
+		= ofc_hashmap_find_modify(
+			mscope->cache, &name);
+	if (entry) return entry;
+
+	entry = (ofc_sema_scope__cache_t*)ofc_alloc(OFC_ALLOC_SEMA,
+		sizeof(ofc_sema_scope__cache_t));
+	if (!entry) return NULL;
+
+	char* base = (char*)ofc_alloc(OFC_ALLOC_SEMA, name.size);
+	if (!base)
+	{
+		ofc_free(entry);
+		return NULL;
+	}
+	memcpy(base, name.base, name.size);
+
+	entry->name       = ofc_str_ref(base, name.size);
+	entry->decl_epoch = 0;
+	entry->decl       = NULL;
+	entry->spec_epoch = 0;
+	entry->spec       = NULL;
+	entry->spec_base  = NULL;
+
+	if (!ofc_hashmap_add(mscope->cache, entry))
+	{
+		ofc_sema_scope__cache_delete(entry);
+		return NULL;
+	}
+
+	return entry;
+}
+
+/* An entry is valid while the sum of the epochs of its scope and
+   every parent is unchanged, so changes in one program unit don't
+   invalidate the entries of another. Zero is reserved for entries
+   which were never resolved. */
+static unsigned ofc_sema_scope__cache_decl_epoch(
+	const ofc_sema_scope_t* scope)
+{
+	unsigned epoch;
+	for (epoch = 0; scope; scope = scope->parent)
+		epoch += scope->cache_decl_epoch;
+	return (epoch == 0 ? 1 : epoch);
+}
+
+static unsigned ofc_sema_scope__cache_spec_epoch(
+	const ofc_sema_scope_t* scope)
+{
+	unsigned epoch;
+	for (epoch = 0; scope; scope = scope->parent)
+		epoch += scope->cache_spec_epoch;
+	return (epoch == 0 ? 1 : epoch);
+}
+
+void ofc_sema_scope_cache_invalidate(
+	const ofc_sema_scope_t* scope)
+{
+	if (!scope)
+		return;
+
+	ofc_sema_scope_t* mscope = (ofc_sema_scope_t*)scope;
+	mscope->cache_decl_epoch++;
+	mscope->cache_spec_epoch++;
+}
+
+void ofc_sema_scope_cache_stats(
+	const ofc_sema_scope_t* scope,
+	unsigned* hit, unsigned* miss)
+{
+	const ofc_sema_scope_t* top = (scope
+		? ofc_sema_scope__cache_top(scope) : NULL);
+	if (hit ) *hit  = (top ? top->cache_hit  : 0);
+	if (miss) *miss = (top ? top->cache_miss : 0);
+}
+
+
 static ofc_sema_spec_t* ofc_sema_scope_spec__find(
 	const ofc_sema_scope_t* scope, ofc_str_ref_t name)
 {
@@ -752,6 +921,9 @@ ofc_sema_spec_t* ofc_sema_scope_spec_modify(
 		return ofc_sema_scope_spec_modify(
 			scope->parent, name);
 
+	/* The caller may modify the specifier we return. */
+	scope->cache_spec_epoch++;
+
 	ofc_sema_spec_t* spec
 		= ofc_hashmap_find_modify(
 			scope->spec->map, &name.string);
@@ -780,9 +952,63 @@ ofc_sema_spec_t* ofc_sema_scope_spec_modify(
 	return spec;
 }
 
+const ofc_sema_spec_t* ofc_sema_scope_spec_find_final_cached(
+	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name)
+{
+	if (!scope)
+		return NULL;
+
+	ofc_sema_scope__cache_t* entry
+		= ofc_sema_scope__cache(scope, name.string);
+	if (!entry) return NULL;
+
+	ofc_sema_scope_t* top
+		= ofc_sema_scope__cache_top(scope);
+	unsigned epoch
+		= ofc_sema_scope__cache_spec_epoch(scope);
+	if (entry->spec_epoch == epoch)
+	{
+		/* Marking a specifier used doesn't change the epoch. */
+		if (entry->spec && entry->spec_base)
+			entry->spec->used = entry->spec_base->used;
+		top->cache_hit++;
+		return entry->spec;
+	}
+	top->cache_miss++;
+
+	ofc_sema_spec_delete(entry->spec);
+	entry->spec_base = ofc_sema_scope_spec__find(
+		scope, name.string);
+	entry->spec = ofc_sema_implicit_apply(
+		scope->implicit, name, entry->spec_base);
+	entry->spec_epoch = epoch;
+	return entry->spec;
+}
+
 ofc_sema_spec_t* ofc_sema_scope_spec_find_final(
 	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name)
 {
+	if (!scope)
+		return NULL;
+
+	if (ofc_sema_scope__cache(scope, name.string))
+	{
+		const ofc_sema_spec_t* spec
+			= ofc_sema_scope_spec_find_final_cached(
+				scope, name);
+		return (spec ? ofc_sema_spec_copy(spec) : NULL);
+	}
+
+	return ofc_sema_scope_spec_find_final_uncached(
+		scope, name);
+}
+
+ofc_sema_spec_t* ofc_sema_scope_spec_find_final_uncached(
+	const ofc_sema_scope_t* scope, ofc_sparse_ref_t name)
+{
+	if (!scope)
+		return NULL;
+
 	ofc_sema_spec_t* spec
 		= ofc_sema_scope_spec__find(
 			scope, name.string);
@@ -819,44 +1045,70 @@ bool ofc_sema_scope_decl_add(
 		return ofc_sema_scope_decl_add(
 			scope->parent, decl);
 
+	scope->cache_decl_epoch++;
 	return ofc_sema_decl_list_add(
 		scope->decl, decl);
 }
 
-const ofc_sema_decl_t* ofc_sema_scope_decl_find(
+static ofc_sema_decl_t* ofc_sema_scope__decl_find(
 	const ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
 {
 	if (!scope)
 		return NULL;
 
-	const ofc_sema_decl_t* decl
-		= ofc_sema_decl_list_find(
+	ofc_sema_decl_t* decl
+		= ofc_sema_decl_list_find_modify(
 			scope->decl, name);
 	if (decl) return decl;
 
 	if (local)
 		return NULL;
 
-	return ofc_sema_scope_decl_find(
+	return ofc_sema_scope__decl_find(
 		scope->parent, name, false);
 }
 
-ofc_sema_decl_t* ofc_sema_scope_decl_find_modify(
-	ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+/* Only lookups which walk the parent chain are worth caching. */
+static ofc_sema_decl_t* ofc_sema_scope__decl_find_cached(
+	const ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
 {
-	if (!scope)
-		return NULL;
+	if (!scope || local || !scope->parent)
+		return ofc_sema_scope__decl_find(scope, name, local);
+
+	ofc_sema_scope__cache_t* entry
+		= ofc_sema_scope__cache(scope, name);
+	if (!entry)
+		return ofc_sema_scope__decl_find(scope, name, local);
+
+	ofc_sema_scope_t* top
+		= ofc_sema_scope__cache_top(scope);
+	unsigned epoch
+		= ofc_sema_scope__cache_decl_epoch(scope);
+	if (entry->decl_epoch == epoch)
+	{
+		top->cache_hit++;
+		return entry->decl;
+	}
+	top->cache_miss++;
 
-	ofc_sema_decl_t* decl
-		= ofc_sema_decl_list_find_modify(
-			scope->decl, name);
-	if (decl) return decl;
+	entry->decl = ofc_sema_scope__decl_find(
+		scope, name, false);
+	entry->decl_epoch = epoch;
+	return entry->decl;
+}
 
-	if (local)
-		return NULL;
+const ofc_sema_decl_t* ofc_sema_scope_decl_find(
+	const ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+{
+	return ofc_sema_scope__decl_find_cached(
+		scope, name, local);
+}
 
-	return ofc_sema_scope_decl_find_modify(
-		scope->parent, name, false);
+ofc_sema_decl_t* ofc_sema_scope_decl_find_modify(
+	ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+{
+	return ofc_sema_scope__decl_find_cached(
+		scope, name, local);
 }
 
 
@@ -1069,6 +1321,167 @@ static bool ofc_sema_scope_body__print(
 	return true;
 }
 
+/* Each part is a program unit, the programs and block data
+   are children and the procedures are in the global decls. */
+static bool ofc_sema_scope_unit__print(
+	ofc_colstr_t* cs, unsigned indent,
+	const void* param, unsigned part)
+{
+	const ofc_sema_scope_t* scope = param;
+
+	unsigned children = (scope->child ? scope->child->count : 0);
+
+	if (part < children)
+	{
+		/* Free form output keeps the comments above each unit. */
+		const ofc_sema_scope_t* child = scope->child->scope[part];
+		if (ofc_colstr_is_free(cs)
+			&& !ofc_sparse_comments_print(cs, indent,
+				ofc_context_current()->condense, child->name.base))
+			return false;
+
+		return ofc_sema_scope_print(cs, indent, child);
+	}
+
+	if (!ofc_sema_decl_procedure_print(
+		cs, indent, scope->decl->decl[part - children]))
+	{
+		ofc_file_error(NULL, NULL,
+			"Failed to print procedure list");
+		return false;
+	}
+	return true;
+}
+
+static bool ofc_sema_scope_global__print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_scope_t* scope)
+{
+	if (!ofc_sema_scope_body__print(
+		cs, (indent + 1), scope))
+		return false;
+
+	if (!scope->decl)
+	{
+		ofc_file_error(NULL, NULL,
+			"Failed to print procedure list");
+		return false;
+	}
+
+	unsigned count = scope->decl->count;
+	if (scope->child) count += scope->child->count;
+
+	return ofc_print_parts(cs, indent, scope,
+		count, ofc_sema_scope_unit__print);
+}
+
+bool ofc_sema_scope_print_units(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_scope_t* scope, void* param,
+	bool (*func)(ofc_colstr_t* cs, void* param))
+{
+	if (!scope || !func)
+		return false;
+
+	if (scope->type != OFC_SEMA_SCOPE_GLOBAL)
+	{
+		return (ofc_sema_scope_print(cs, indent, scope)
+			&& func(cs, param));
+	}
+
+	if (!ofc_sema_scope_body__print(
+		cs, (indent + 1), scope)
+		|| !func(cs, param))
+		return false;
+
+	if (!scope->decl)
+	{
+		ofc_file_error(NULL, NULL,
+			"Failed to print procedure list");
+		return false;
+	}
+
+	unsigned count = scope->decl->count;
+	if (scope->child) count += scope->child->count;
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		if (!ofc_sema_scope_unit__print(cs, indent, scope, i)
+			|| !func(cs, param))
+			return false;
+	}
+
+	/* Free form output keeps the comments after the last unit. */
+	if (ofc_colstr_is_free(cs)
+		&& (!ofc_sparse_comments_end_print(cs, indent,
+				ofc_context_current()->condense)
+			|| !func(cs, param)))
+		return false;
+
+	return true;
+}
+
+/* The start of a program unit's END statement. */
+static const char* ofc_sema_scope__end(
+	const ofc_sema_scope_t* scope)
+{
+	const char* end = ofc_sparse_ref_last(scope->src);
+	if (!end) return NULL;
+
+	while ((end > scope->src.string.base)
+		&& !ofc_is_vspace(end[-1]) && (end[-1] != ';'))
+		end--;
+	return end;
+}
+
+/* Free form output keeps the comments after a unit's header, and those
+   in its declarations ahead of its first statement. */
+static bool ofc_sema_scope__head_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_scope_t* scope)
+{
+	if (!ofc_colstr_is_free(cs)
+		|| ofc_sparse_ref_empty(scope->src))
+		return true;
+
+	const char* head = scope->src.string.base;
+	const char* next = ((scope->stmt && (scope->stmt->count > 0))
+		? scope->stmt->stmt[0]->src.string.base
+		: ofc_sema_scope__end(scope));
+
+	return (ofc_sparse_comments_within_print(cs, indent, scope->src.sparse,
+			head, ofc_sparse_ref_head_last(scope->src), true)
+		&& ofc_sparse_comments_between_print(cs, (indent + 1),
+			scope->src.sparse, head, next));
+}
+
+/* And those after its last statement, up to and after its END. */
+static bool ofc_sema_scope__end_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_scope_t* scope, bool after)
+{
+	if (!ofc_colstr_is_free(cs)
+		|| ofc_sparse_ref_empty(scope->src))
+		return true;
+
+	const char* end = ofc_sema_scope__end(scope);
+	if (after)
+	{
+		return ofc_sparse_comments_within_print(cs, indent,
+			scope->src.sparse, end, ofc_sparse_ref_last(scope->src), true);
+	}
+
+	unsigned count = (scope->stmt ? scope->stmt->count : 0);
+	if ((count > 0) && !ofc_sparse_comments_between_print(
+		cs, (indent + 1), scope->src.sparse,
+		ofc_sparse_ref_last(scope->stmt->stmt[count - 1]->src), end))
+		return false;
+
+	return ofc_sparse_comments_print(
+		cs, (indent + 1), scope->src.sparse, end);
+}
+
 bool ofc_sema_scope_print(
 	ofc_colstr_t* cs, unsigned indent,
 	const ofc_sema_scope_t* scope)
@@ -1076,6 +1489,11 @@ bool ofc_sema_scope_print(
 	if (!scope)
 		return false;
 
+	/* Program units don't depend on each other, so they can be printed
+	   at once, this is most of the work when reprinting a large file. */
+	if (scope->type == OFC_SEMA_SCOPE_GLOBAL)
+		return ofc_sema_scope_global__print(cs, indent, scope);
+
 	const char* kwstr = NULL;
 	switch (scope->type)
 	{
@@ -1137,8 +1555,9 @@ bool ofc_sema_scope_print(
 		}
 	}
 
-	if (!ofc_sema_scope_body__print(
-		cs, (indent + 1), scope))
+	if (!ofc_sema_scope__head_comments_print(cs, indent, scope)
+		|| !ofc_sema_scope_body__print(cs, (indent + 1), scope)
+		|| !ofc_sema_scope__end_comments_print(cs, indent, scope, false))
 		return false;
 
 	if (kwstr)
@@ -1155,6 +1574,9 @@ bool ofc_sema_scope_print(
 		}
 	}
 
+	if (!ofc_sema_scope__end_comments_print(cs, indent, scope, true))
+		return false;
+
 	if (scope->child
 		&& !ofc_sema_scope_child__print(cs, indent, scope->child))
 		return false;
@@ -1172,7 +1594,7 @@ bool ofc_sema_scope_print(
 ofc_sema_scope_list_t* ofc_sema_scope_list_create(void)
 {
 	ofc_sema_scope_list_t* list
-		= (ofc_sema_scope_list_t*)malloc(
+		= (ofc_sema_scope_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_scope_list_t));
 	if (!list) return NULL;
 
@@ -1189,7 +1611,7 @@ bool ofc_sema_scope_list_add(
 	if (!list || !scope) return false;
 
 	ofc_sema_scope_t** nscope
-		= (ofc_sema_scope_t**)realloc(list->scope,
+		= (ofc_sema_scope_t**)ofc_realloc(OFC_ALLOC_SEMA, list->scope,
 			(sizeof(ofc_sema_scope_t*) * (list->count + 1)));
 	if (!nscope) return false;
 	list->scope = nscope;
@@ -1225,6 +1647,6 @@ void ofc_sema_scope_list_delete(
 	for (i = 0; i < list->count; i++)
 		ofc_sema_scope_delete(list->scope[i]);
 
-	free(list->scope);
-	free(list);
+	ofc_free(list->scope);
+	ofc_free(list);
 }
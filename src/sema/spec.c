@@ -41,7 +41,7 @@ bool ofc_sema_spec_is_dynamic_array(
 	const ofc_sema_spec_t* spec)
 {
 	return (spec && spec->array
-		&& !ofc_sema_array_total(spec->array, NULL));
+		&& !ofc_sema_array_shape_resolve(spec->array));
 }
 
 bool ofc_sema_spec_is_argument(
@@ -81,7 +81,7 @@ ofc_sema_spec_t* ofc_sema_spec_create(
 	ofc_sparse_ref_t name)
 {
 	ofc_sema_spec_t* spec
-		= (ofc_sema_spec_t*)malloc(
+		= (ofc_sema_spec_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_spec_t));
 	if (!spec) return NULL;
 
@@ -206,7 +206,18 @@ ofc_sema_spec_t* ofc_sema_spec(
 			s.kind = 2;
 			break;
 		default:
-			s.kind = (ptype->size > 0 ? (3 * ptype->size) : 1);
+			s.kind = 1;
+			if (ptype->size > 0)
+			{
+				s.kind = ofc_sema_type_kind_star(
+					s.type, ptype->size);
+				if (s.kind == 0)
+				{
+					ofc_sparse_ref_error(ptype->src,
+						"COMPLEX size must be even");
+					return NULL;
+				}
+			}
 			break;
 	}
 
@@ -348,7 +359,7 @@ ofc_sema_spec_t* ofc_sema_spec(
 	s.is_volatile  = ptype->attr.is_volatile;
 
 	ofc_sema_spec_t* spec
-		= (ofc_sema_spec_t*)malloc(
+		= (ofc_sema_spec_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_spec_t));
 	if (!spec) return NULL;
 
@@ -357,7 +368,7 @@ ofc_sema_spec_t* ofc_sema_spec(
 	if (spec->structure
 		&& !ofc_sema_structure_reference(spec->structure))
 	{
-		free(spec);
+		ofc_free(spec);
 		return NULL;
 	}
 
@@ -441,9 +452,8 @@ bool ofc_sema_spec_print(
 	if (spec->type_implicit)
 	{
 		ofc_sema_spec_t* final
-			= ofc_sema_scope_spec_find_final(
+			= ofc_sema_scope_spec_find_final_uncached(
 				scope, spec->name);
-
 		bool success = ofc_sema_spec_print(
 			cs, indent, scope, final);
 		ofc_sema_spec_delete(final);
@@ -560,7 +570,7 @@ void ofc_sema_spec_delete(
 
 	ofc_sema_array_delete(spec->array);
 	ofc_sema_structure_delete(spec->structure);
-	free(spec);
+	ofc_free(spec);
 }
 
 
@@ -573,7 +583,7 @@ static const ofc_str_ref_t* ofc_sema_spec__name(
 static ofc_sema_spec_list_t* ofc_sema_spec_list_create()
 {
 	ofc_sema_spec_list_t* list
-		= (ofc_sema_spec_list_t*)malloc(
+		= (ofc_sema_spec_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_spec_list_t));
 	if (!list) return NULL;
 
@@ -613,17 +623,17 @@ static void ofc_sema_spec_list_delete(
 		unsigned i;
 		for (i = 0; i < list->count; i++)
 			ofc_sema_spec_delete(list->spec[i]);
-		free(list->spec);
+		ofc_free(list->spec);
 	}
 
-	free(list);
+	ofc_free(list);
 }
 
 ofc_sema_spec_map_t* ofc_sema_spec_map_create(
 	bool case_sensitive)
 {
 	ofc_sema_spec_map_t* map
-		= (ofc_sema_spec_map_t*)malloc(
+		= (ofc_sema_spec_map_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_spec_map_t));
 	if (!map) return NULL;
 
@@ -656,7 +666,7 @@ bool ofc_sema_spec_map_add(
 		return false;
 
 	ofc_sema_spec_t** nspec
-		= (ofc_sema_spec_t**)realloc(map->list->spec,
+		= (ofc_sema_spec_t**)ofc_realloc(OFC_ALLOC_SEMA, map->list->spec,
 			(sizeof(ofc_sema_spec_t*) * (map->list->count + 1)));
 	if (!nspec) return false;
 	map->list->spec = nspec;
@@ -678,5 +688,5 @@ void ofc_sema_spec_map_delete(
 	ofc_sema_spec_list_delete(map->list);
 	ofc_hashmap_delete(map->map);
 
-	free(map);
+	ofc_free(map);
 }
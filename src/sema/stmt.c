@@ -84,7 +84,7 @@ static ofc_sema_stmt_t* ofc_sema_stmt_simple(
 	}
 
 	ofc_sema_stmt_t* stmt
-		= (ofc_sema_stmt_t*)malloc(
+		= (ofc_sema_stmt_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_stmt_t));
 	if (!stmt) return NULL;
 
@@ -241,7 +241,7 @@ void ofc_sema_stmt_delete(
 				stmt->io_read.end);
 			ofc_sema_expr_delete(
 				stmt->io_read.eor);
-			ofc_sema_expr_delete(
+			ofc_sema_lhs_delete(
 				stmt->io_read.size);
 			ofc_sema_lhs_list_delete(
 				stmt->io_read.iolist);
@@ -441,7 +441,7 @@ void ofc_sema_stmt_delete(
 			break;
 	}
 
-	free(stmt);
+	ofc_free(stmt);
 }
 
 
@@ -449,7 +449,7 @@ void ofc_sema_stmt_delete(
 ofc_sema_stmt_list_t* ofc_sema_stmt_list_create(void)
 {
 	ofc_sema_stmt_list_t* list
-		= (ofc_sema_stmt_list_t*)malloc(
+		= (ofc_sema_stmt_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_stmt_list_t));
 	if (!list) return NULL;
 
@@ -632,7 +632,7 @@ ofc_sema_stmt_t* ofc_sema_stmt_alloc(
 	ofc_sema_stmt_t stmt)
 {
 	ofc_sema_stmt_t* astmt
-		= (ofc_sema_stmt_t*)malloc(
+		= (ofc_sema_stmt_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_stmt_t));
 	if (!astmt) return NULL;
 
@@ -649,9 +649,9 @@ void ofc_sema_stmt_list_delete(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 		ofc_sema_stmt_delete(list->stmt[i]);
-	free(list->stmt);
+	ofc_free(list->stmt);
 
-	free(list);
+	ofc_free(list);
 }
 
 bool ofc_sema_stmt_list_add(
@@ -662,7 +662,7 @@ bool ofc_sema_stmt_list_add(
 		return false;
 
 	ofc_sema_stmt_t** nstmt
-		= (ofc_sema_stmt_t**)realloc(list->stmt,
+		= (ofc_sema_stmt_t**)ofc_realloc(OFC_ALLOC_SEMA, list->stmt,
 			(sizeof(ofc_sema_stmt_t*) * (list->count + 1)));
 	if (!nstmt) return NULL;
 
@@ -807,6 +807,34 @@ static const char* ofc_sema_stmt__str_rep(
 	return ofc_sema_stmt__name[stmt->type];
 }
 
+bool ofc_sema_stmt_block_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sema_stmt_t* block,
+	const ofc_sema_stmt_list_t* list)
+{
+	if (!ofc_colstr_is_free(cs))
+		return true;
+
+	/* A block ended by a labelled statement has no end of its own. */
+	const char* head = ofc_sparse_ref_head_last(block->src);
+	const char* end = ofc_sparse_ref_last(block->src);
+	if (!head || !end || (end <= head))
+		return true;
+	while ((end > head) && !ofc_is_vspace(end[-1]) && (end[-1] != ';'))
+		end--;
+
+	const char* prev = head;
+	if (list && (list->count > 0))
+		prev = ofc_sparse_ref_last(list->stmt[list->count - 1]->src);
+	if (!prev || (end <= prev))
+		return true;
+
+	return (ofc_sparse_comments_between_print(
+			cs, (indent + 1), block->src.sparse, prev, end)
+		&& ofc_sparse_comments_print(
+			cs, (indent + 1), block->src.sparse, end));
+}
+
 bool ofc_sema_stmt_list_print(
 	ofc_colstr_t* cs, unsigned indent,
 	ofc_sema_label_map_t* label_map,
@@ -815,9 +843,30 @@ bool ofc_sema_stmt_list_print(
 	if (!cs || !stmt_list)
 		return false;
 
+	bool free = ofc_colstr_is_free(cs);
+
 	unsigned i;
 	for (i = 0; i < stmt_list->count; i++)
 	{
+		const ofc_sema_stmt_t* stmt = stmt_list->stmt[i];
+
+		/* Free form output keeps the comments from the source, those
+		   after the previous statement, above this one and within it.
+		   Those after a block's first line follow it, so they go above. */
+		bool block = ((stmt->type == OFC_SEMA_STMT_IF_THEN)
+			|| (stmt->type == OFC_SEMA_STMT_DO_BLOCK)
+			|| (stmt->type == OFC_SEMA_STMT_DO_WHILE_BLOCK));
+		if (free && (((i > 0) && !ofc_sparse_comments_between_print(
+				cs, indent, stmt->src.sparse,
+				ofc_sparse_ref_last(stmt_list->stmt[i - 1]->src),
+				stmt->src.string.base))
+			|| !ofc_sparse_comments_print(cs, indent,
+				stmt->src.sparse, stmt->src.string.base)
+			|| (block && !ofc_sparse_comments_within_print(
+				cs, indent, stmt->src.sparse, stmt->src.string.base,
+				ofc_sparse_ref_head_last(stmt->src), false))))
+			return false;
+
 		const ofc_sema_label_t* label
 			= ofc_sema_label_map_find_stmt(
 				label_map, stmt_list->stmt[i]);
@@ -841,6 +890,12 @@ bool ofc_sema_stmt_list_print(
 				ofc_sema_stmt__str_rep(stmt_list->stmt[i]));
 			return false;
 		}
+
+		if (free && !block
+			&& !ofc_sparse_comments_within_print(
+				cs, indent, stmt->src.sparse, stmt->src.string.base,
+				ofc_sparse_ref_last(stmt->src), true))
+			return false;
 	}
 	return true;
 }
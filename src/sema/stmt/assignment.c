@@ -40,15 +40,11 @@ bool ofc_sema_stmt_is_stmt_func(
 		*(stmt->assignment->name), &base_name))
 		return NULL;
 
-	ofc_sema_spec_t* spec
-		= ofc_sema_scope_spec_find_final(
+	const ofc_sema_spec_t* spec
+		= ofc_sema_scope_spec_find_final_cached(
 			scope, base_name);
-	if (spec)
-	{
-		bool is_array = (spec->array != NULL);
-		ofc_sema_spec_delete(spec);
-		if (is_array) return false;
-	}
+	if (spec && spec->array)
+		return false;
 
 	const ofc_sema_decl_t* decl
 		= ofc_sema_scope_decl_find(
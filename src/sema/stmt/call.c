@@ -124,6 +124,13 @@ ofc_sema_stmt_t* ofc_sema_stmt_call(
 		}
 	}
 
+	if (!ofc_sema_callgraph_add(scope, false,
+		stmt->call_entry.name, stmt->src, NULL, s.call.args))
+	{
+		ofc_sema_expr_list_delete(s.call.args);
+		return NULL;
+	}
+
 	ofc_sema_stmt_t* as
 		= ofc_sema_stmt_alloc(s);
 	if (!as)
@@ -24,6 +24,18 @@ void ofc_sema_stmt_io_close__cleanup(
 	ofc_sema_expr_delete(s.io_close.status);
 }
 
+static const char* const ofc_sema_stmt_io_close__status[]
+	= { "DELETE", "KEEP", NULL };
+
+static const ofc_sema_io_spec_t ofc_sema_stmt_io_close__spec[OFC_SEMA_IO_SPEC_COUNT] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT  ] = { 1, OFC_SEMA_IO_SPEC_TYPE_UNIT     , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_IOSTAT] = { 0, OFC_SEMA_IO_SPEC_TYPE_VARIABLE , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ERR   ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL    , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_STATUS] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_close__status, "'DELETE' or 'KEEP'" },
+};
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_close(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -40,230 +52,51 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_close(
 	s.io_close.err    = NULL;
 	s.io_close.status = NULL;
 
-	ofc_parse_call_arg_t* ca_unit   = NULL;
-	ofc_parse_call_arg_t* ca_iostat = NULL;
-	ofc_parse_call_arg_t* ca_err    = NULL;
-	ofc_parse_call_arg_t* ca_status = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in CLOSE.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in CLOSE.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in CLOSE.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in CLOSE.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "STATUS"))
-		{
-			if (ca_status)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of STATUS in CLOSE.");
-				return NULL;
-			}
-
-			ca_status = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in CLOSE.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_sema_io_params_t params;
+	if (!ofc_sema_io_params(stmt->io.params,
+		ofc_sema_stmt_io_close__spec, "CLOSE", &params))
+		return NULL;
 
-	if (!ca_unit)
+	if (!params.arg[OFC_SEMA_IO_SPEC_UNIT])
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"No UNIT defined in CLOSE.");
 		return NULL;
 	}
 
-	if (ca_unit->type == OFC_PARSE_CALL_ARG_EXPR)
-	{
-		s.io_close.unit = ofc_sema_expr(
-			scope, ca_unit->expr);
-		if (!s.io_close.unit) return NULL;
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_close.unit);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"UNIT must be of type INTEGER in CLOSE");
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_expr_validate_uint(s.io_close.unit))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"UNIT must be a positive INTEGER in CLOSE");
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-	}
-	else
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_UNIT, &s.io_close.unit)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_IOSTAT, &s.io_close.iostat)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ERR, &s.io_close.err)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_STATUS, &s.io_close.status))
 	{
-		ofc_sparse_ref_error(stmt->src,
-			"UNIT must be an INTEGER expression in CLOSE");
+		ofc_sema_stmt_io_close__cleanup(s);
 		return NULL;
 	}
 
-	if (ca_iostat)
+	if (s.io_close.status)
 	{
-		s.io_close.iostat = ofc_sema_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_close.iostat)
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		if (s.io_close.iostat->type != OFC_SEMA_EXPR_LHS)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of a variable in CLOSE");
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_close.iostat);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
+		const ofc_sema_typeval_t* constant
+			= ofc_sema_expr_constant(s.io_close.status);
 
-		if (!ofc_sema_type_is_integer(etype))
+		if (ofc_typeval_character_equal_strz_ci(constant, "DELETE"))
 		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in CLOSE");
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
+			s.io_close.status_type = OFC_SEMA_CALL_ARG_DELETE;
 		}
-
-	}
-
-	if (ca_err)
-	{
-		s.io_close.err = ofc_sema_expr(
-			scope, ca_err->expr);
-		if (!s.io_close.err)
+		else if (ofc_typeval_character_equal_strz_ci(constant, "KEEP"))
 		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
+			s.io_close.status_type = OFC_SEMA_CALL_ARG_KEEP;
 		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_close.err, NULL))
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_status)
-	{
-		s.io_close.status = ofc_sema_expr(
-			scope, ca_status->expr);
-		if (!s.io_close.status)
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_close.status);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_close__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
+		else
 		{
 			ofc_sparse_ref_error(stmt->src,
-				"STATUS must be a CHARACTER expression in CLOSE");
+				"STATUS must be 'DELETE' or 'KEEP' in CLOSE");
 			ofc_sema_stmt_io_close__cleanup(s);
 			return NULL;
 		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_close.status);
-
-			if (ofc_typeval_character_equal_strz_ci(constant, "DELETE"))
-			{
-				s.io_close.status_type = OFC_SEMA_CALL_ARG_DELETE;
-			}
-			else if (ofc_typeval_character_equal_strz_ci(constant, "KEEP"))
-			{
-				s.io_close.status_type = OFC_SEMA_CALL_ARG_KEEP;
-			}
-			else
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"STATUS must be 'DELETE' or 'KEEP' in CLOSE");
-				ofc_sema_stmt_io_close__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	ofc_sema_stmt_t* as
@@ -448,7 +448,9 @@ bool ofc_sema_stmt_do_block_print(
 	}
 	if (!ofc_sema_stmt_list_print(
 		cs, (indent + 1), label_map,
-		stmt->do_block.block))
+		stmt->do_block.block)
+		|| !ofc_sema_stmt_block_comments_print(
+			cs, indent, stmt, stmt->do_block.block))
 		return false;
 
 	const ofc_sema_label_t* label
@@ -494,7 +496,9 @@ bool ofc_sema_stmt_do_while_block_print(
 		|| !ofc_colstr_atomic_writef(cs, ")")
 		|| !ofc_sema_stmt_list_print(
 			cs, (indent + 1), label_map,
-			stmt->do_while_block.block))
+			stmt->do_while_block.block)
+		|| !ofc_sema_stmt_block_comments_print(
+			cs, indent, stmt, stmt->do_while_block.block))
 		return false;
 
 	const ofc_sema_label_t* label
@@ -14,9 +14,7 @@
  */
 
 #include "ofc/sema.h"
-#include "ofc/global_opts.h"
-
-extern ofc_global_opts_t global_opts;
+#include "ofc/context.h"
 
 
 bool ofc_sema_stmt_equivalence(
@@ -90,7 +88,7 @@ bool ofc_sema_stmt_equivalence(
 				ofc_sema_lhs_type(base),
 				ofc_sema_lhs_type(elhs)))
 			{
-				if (!global_opts.no_warn_equiv_type)
+				if (!ofc_context_current()->global_opts.no_warn_equiv_type)
 				{
 					ofc_sparse_ref_warning(elhs->src,
 						"EQUIVALENCE types don't match.");
@@ -312,6 +312,17 @@ bool ofc_sema_stmt_if_then_print(
 
 	if (stmt->if_then.block_else)
 	{
+		/* Comments before the ELSE go above it. */
+		const ofc_sema_stmt_list_t* then = stmt->if_then.block_then;
+		const ofc_sema_stmt_list_t* belse = stmt->if_then.block_else;
+		if (ofc_colstr_is_free(cs)
+			&& then && (then->count > 0) && (belse->count > 0)
+			&& !ofc_sparse_comments_between_print(
+				cs, (indent + 1), stmt->src.sparse,
+				ofc_sparse_ref_last(then->stmt[then->count - 1]->src),
+				belse->stmt[0]->src.string.base))
+			return false;
+
 		/* TODO - ELSE IF could print on the same line for neatness
 			but this works for now. */
 		if (!ofc_colstr_newline(cs, indent, NULL)
@@ -321,6 +332,12 @@ bool ofc_sema_stmt_if_then_print(
 					return false;
 	}
 
+	const ofc_sema_stmt_list_t* last = stmt->if_then.block_else;
+	if (!last || (last->count == 0))
+		last = stmt->if_then.block_then;
+	if (!ofc_sema_stmt_block_comments_print(cs, indent, stmt, last))
+		return false;
+
 	const ofc_sema_label_t* label
 		= ofc_sema_label_map_find_end_block(
 			label_map, stmt);
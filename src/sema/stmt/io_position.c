@@ -15,6 +15,13 @@
 
 #include "ofc/sema.h"
 
+static const ofc_sema_io_spec_t ofc_sema_stmt_io_position__spec[OFC_SEMA_IO_SPEC_COUNT] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT  ] = { 1, OFC_SEMA_IO_SPEC_TYPE_UNIT    , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_IOSTAT] = { 0, OFC_SEMA_IO_SPEC_TYPE_VARIABLE, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ERR   ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL   , NULL, NULL },
+};
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_position(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -48,176 +55,27 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_position(
 	s.io_position.iostat      = NULL;
 	s.io_position.err         = NULL;
 
-	ofc_parse_call_arg_t* ca_unit   = NULL;
-	ofc_parse_call_arg_t* ca_iostat = NULL;
-	ofc_parse_call_arg_t* ca_err    = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in %s.", i, name);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in %s.", name);
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in %s.", name);
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in %s.", name);
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in %s.",
-				i, param->name.string.size, param->name.string.base, name);
-			return NULL;
-		}
-	}
-
-	if (!ca_unit)
-	{
-		ofc_sparse_ref_error(stmt->src,
-			"No UNIT defined in %s.", name);
+	ofc_sema_io_params_t params;
+	if (!ofc_sema_io_params(stmt->io.params,
+		ofc_sema_stmt_io_position__spec, name, &params))
 		return NULL;
-	}
-
-	if (ca_unit->type == OFC_PARSE_CALL_ARG_EXPR)
-	{
-		s.io_position.unit = ofc_sema_expr(
-			scope, ca_unit->expr);
-		if (!s.io_position.unit) return NULL;
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_position.unit);
-		if (!etype) return NULL;
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"UNIT must be of type INTEGER in %s", name);
-			ofc_sema_expr_delete(s.io_position.unit);
-			return NULL;
-		}
 
-		if (!ofc_sema_expr_validate_uint(s.io_position.unit))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				   "UNIT must be a positive INTEGER in %s", name);
-			ofc_sema_expr_delete(s.io_position.unit);
-			return NULL;
-		}
-	}
-	else
+	if (!params.arg[OFC_SEMA_IO_SPEC_UNIT])
 	{
 		ofc_sparse_ref_error(stmt->src,
-			"UNIT must be an INTEGER expression in %s", name);
+			"No UNIT defined in %s.", name);
 		return NULL;
 	}
 
-	if (ca_iostat)
-	{
-		s.io_position.iostat = ofc_sema_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_position.iostat)
-		{
-			ofc_sema_expr_delete(s.io_position.unit);
-			return NULL;
-		}
-
-		if (s.io_position.iostat->type != OFC_SEMA_EXPR_LHS)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of a variable in %s", name);
-			ofc_sema_expr_delete(s.io_position.unit);
-			ofc_sema_expr_delete(s.io_position.iostat);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_position.iostat);
-		if (!etype)
-		{
-			ofc_sema_expr_delete(s.io_position.unit);
-			ofc_sema_expr_delete(s.io_position.iostat);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in %s", name);
-			ofc_sema_expr_delete(s.io_position.unit);
-			ofc_sema_expr_delete(s.io_position.iostat);
-			return NULL;
-		}
-
-	}
-
-	if (ca_err)
-	{
-		s.io_position.err = ofc_sema_expr(
-			scope, ca_err->expr);
-		if (!s.io_position.err)
-		{
-			ofc_sema_expr_delete(s.io_position.unit);
-			ofc_sema_expr_delete(s.io_position.iostat);
-			return NULL;
-		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_position.err, NULL))
-		{
-			ofc_sema_expr_delete(s.io_position.unit);
-			ofc_sema_expr_delete(s.io_position.iostat);
-			ofc_sema_expr_delete(s.io_position.err);
-			return NULL;
-		}
-	}
+	ofc_sema_stmt_t* as = NULL;
+	if (ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_UNIT, &s.io_position.unit)
+		&& ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_IOSTAT, &s.io_position.iostat)
+		&& ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ERR, &s.io_position.err))
+		as = ofc_sema_stmt_alloc(s);
 
-	ofc_sema_stmt_t* as
-		= ofc_sema_stmt_alloc(s);
 	if (!as)
 	{
 		ofc_sema_expr_delete(s.io_position.unit);
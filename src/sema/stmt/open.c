@@ -33,6 +33,48 @@ static void ofc_sema_stmt_io_open__cleanup(
 	ofc_sema_expr_delete(s.io_open.status);
 }
 
+static const char* const ofc_sema_stmt_io_open__access[]
+	= { "SEQUENTIAL", "DIRECT", NULL };
+static const char* const ofc_sema_stmt_io_open__action[]
+	= { "READ", "WRITE", "READWRITE", NULL };
+static const char* const ofc_sema_stmt_io_open__form[]
+	= { "FORMATTED", "UNFORMATTED", NULL };
+static const char* const ofc_sema_stmt_io_open__blank[]
+	= { "NULL", "ZERO", NULL };
+static const char* const ofc_sema_stmt_io_open__delim[]
+	= { "APOSTROPHE", "QUOTE", "NONE", NULL };
+static const char* const ofc_sema_stmt_io_open__status[]
+	= { "UNKNOWN", "REPLACE", "OLD", "NEW", "SCRATCH", NULL };
+static const char* const ofc_sema_stmt_io_open__pad[]
+	= { "YES", "NO", NULL };
+static const char* const ofc_sema_stmt_io_open__position[]
+	= { "REWIND", "APPEND", "ASIS", NULL };
+
+static const ofc_sema_io_spec_t ofc_sema_stmt_io_open__spec[OFC_SEMA_IO_SPEC_COUNT] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT    ] = { 1, OFC_SEMA_IO_SPEC_TYPE_UNIT, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ACCESS  ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__access, "SEQUENTIAL/DIRECT" },
+	[OFC_SEMA_IO_SPEC_ACTION  ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__action, "'READ', 'WRITE' or 'READWRITE'" },
+	[OFC_SEMA_IO_SPEC_FORM    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__form, "FORMATTED/UNFORMATTED" },
+	[OFC_SEMA_IO_SPEC_BLANK   ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__blank, "NULL/ZERO" },
+	[OFC_SEMA_IO_SPEC_DELIM   ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__delim, "APOSTROPHE/QUOTE/NONE" },
+	[OFC_SEMA_IO_SPEC_ERR     ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_STATUS  ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__status, "UNKNOWN/REPLACE/OLD/NEW/SCRATCH" },
+	[OFC_SEMA_IO_SPEC_FILE    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_IOSTAT  ] = { 0, OFC_SEMA_IO_SPEC_TYPE_VARIABLE, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_PAD     ] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__pad, "YES/NO" },
+	[OFC_SEMA_IO_SPEC_POSITION] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_open__position, "REWIND/APPEND/ASIS" },
+	[OFC_SEMA_IO_SPEC_RECL    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_INTEGER, NULL, NULL },
+};
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -58,756 +100,138 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	s.io_open.recl          = NULL;
 	s.io_open.status        = NULL;
 
-	ofc_parse_call_arg_t* ca_unit     = NULL;
-	ofc_parse_call_arg_t* ca_access   = NULL;
-	ofc_parse_call_arg_t* ca_action   = NULL;
-	ofc_parse_call_arg_t* ca_blank    = NULL;
-	ofc_parse_call_arg_t* ca_delim    = NULL;
-	ofc_parse_call_arg_t* ca_err      = NULL;
-	ofc_parse_call_arg_t* ca_file     = NULL;
-	ofc_parse_call_arg_t* ca_form     = NULL;
-	ofc_parse_call_arg_t* ca_iostat   = NULL;
-	ofc_parse_call_arg_t* ca_pad      = NULL;
-	ofc_parse_call_arg_t* ca_position = NULL;
-	ofc_parse_call_arg_t* ca_recl     = NULL;
-	ofc_parse_call_arg_t* ca_status   = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in OPEN.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in OPEN.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACCESS"))
-		{
-			if (ca_access)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACCESS in OPEN.");
-				return NULL;
-			}
-
-			ca_access = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACTION"))
-		{
-			if (ca_action)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACTION in OPEN.");
-				return NULL;
-			}
-
-			ca_action = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "BLANK"))
-		{
-			if (ca_blank)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of BLANK in OPEN.");
-				return NULL;
-			}
-
-			ca_blank = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "DELIM"))
-		{
-			if (ca_delim)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of DELIM in OPEN.");
-				return NULL;
-			}
-
-			ca_delim = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in OPEN.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FILE"))
-		{
-			if (ca_file)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FILE in OPEN.");
-				return NULL;
-			}
-
-			ca_file = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FORM"))
-		{
-			if (ca_form)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FORM in OPEN.");
-				return NULL;
-			}
-
-			ca_form = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in OPEN.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "PAD"))
-		{
-			if (ca_pad)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of PAD in OPEN.");
-				return NULL;
-			}
-
-			ca_pad = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "POSITION"))
-		{
-			if (ca_position)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of POSITION in OPEN.");
-				return NULL;
-			}
-
-			ca_position = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "RECL"))
-		{
-			if (ca_recl)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of RECL in OPEN.");
-				return NULL;
-			}
-
-			ca_recl = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "STATUS"))
-		{
-			if (ca_status)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of STATUS in OPEN.");
-				return NULL;
-			}
-
-			ca_status = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in OPEN.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_sema_io_params_t params;
+	if (!ofc_sema_io_params(stmt->io.params,
+		ofc_sema_stmt_io_open__spec, "OPEN", &params))
+		return NULL;
 
-	if (!ca_unit)
+	if (!params.arg[OFC_SEMA_IO_SPEC_UNIT])
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"No UNIT defined in OPEN.");
 		return NULL;
 	}
 
-	if (ca_unit->type == OFC_PARSE_CALL_ARG_EXPR)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_UNIT, &s.io_open.unit)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ACCESS, &s.io_open.access))
 	{
-		s.io_open.unit = ofc_sema_expr(
-			scope, ca_unit->expr);
-		if (!s.io_open.unit) return NULL;
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.unit);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"UNIT must be of type INTEGER in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_expr_validate_uint(s.io_open.unit))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				   "UNIT must be a positive INTEGER in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-	}
-	else
-	{
-		ofc_sparse_ref_error(stmt->src,
-			"UNIT must be an INTEGER expression in OPEN");
+		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
 
-	bool access_type_direct = false;
-	bool format_type_unformatted  = false;
-	if (ca_access)
+	bool access_type_direct = ofc_typeval_character_equal_strz_ci(
+		ofc_sema_expr_constant(s.io_open.access), "DIRECT");
+	bool format_type_unformatted = false;
+	if (access_type_direct)
 	{
-		s.io_open.access = ofc_sema_expr(
-			scope, ca_access->expr);
-		if (!s.io_open.access)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.access);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
+		/* Change default format */
+		format_type_unformatted = true;
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
+		if (!params.arg[OFC_SEMA_IO_SPEC_RECL])
 		{
 			ofc_sparse_ref_error(stmt->src,
-				"ACCESS must be a CHARACTER expression in OPEN");
+				"Direct ACCESS must have a RECL specifier in OPEN");
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.access);
-
-			access_type_direct = (constant
-				&& ofc_typeval_character_equal_strz_ci(constant, "DIRECT"));
-			if (constant && !access_type_direct
-				&& !ofc_typeval_character_equal_strz_ci(constant, "SEQUENTIAL"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"ACCESS must be SEQUENTIAL/DIRECT in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-			else if (access_type_direct)
-			{
-				/* Change default format */
-				format_type_unformatted = true;
-
-				if (!ca_recl)
-				{
-					ofc_sparse_ref_error(stmt->src,
-						"Direct ACCESS must have a RECL specifier in OPEN");
-					ofc_sema_stmt_io_open__cleanup(s);
-					return NULL;
-				}
-			}
-		}
 	}
 
-	if (ca_action)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ACTION, &s.io_open.action)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_FORM, &s.io_open.form))
 	{
-		s.io_open.action = ofc_sema_expr(
-			scope, ca_action->expr);
-		if (!s.io_open.action)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.action);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ACTION must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.action);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "READWRITE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "WRITE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "READ"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"ACTION must be 'READ', 'WRITE' or 'READWRITE' in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+		ofc_sema_stmt_io_open__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_form)
+	if (s.io_open.form)
 	{
-		s.io_open.form = ofc_sema_expr(
-			scope, ca_form->expr);
-		if (!s.io_open.form)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.form);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FORM must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.form);
-
-			format_type_unformatted = (constant
-				&& ofc_typeval_character_equal_strz_ci(constant, "UNFORMATTED"));
-			if (constant && !format_type_unformatted
-				&& !ofc_typeval_character_equal_strz_ci(constant, "FORMATTED"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"FORM must be FORMATTED/UNFORMATTED in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+		format_type_unformatted = ofc_typeval_character_equal_strz_ci(
+			ofc_sema_expr_constant(s.io_open.form), "UNFORMATTED");
 	}
 
-	if (ca_blank && format_type_unformatted)
+	if (params.arg[OFC_SEMA_IO_SPEC_BLANK] && format_type_unformatted)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"BLANK can only be specified for formatted I/O in OPEN");
 		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
-	else if (ca_blank)
-	{
-		s.io_open.blank = ofc_sema_expr(
-			scope, ca_blank->expr);
-		if (!s.io_open.blank)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.blank);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"BLANK must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.blank);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "ZERO")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NULL"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"BLANK must be NULL/ZERO in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
-	}
-
-	if (ca_delim && format_type_unformatted)
+	if (params.arg[OFC_SEMA_IO_SPEC_DELIM] && format_type_unformatted)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"DELIM can only be specified for formatted I/O in OPEN");
 		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
-	else if (ca_delim)
-	{
-		s.io_open.delim = ofc_sema_expr(
-			scope, ca_delim->expr);
-		if (!s.io_open.delim)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.delim);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"DELIM must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.delim);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "APOSTROPHE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "QUOTE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NONE"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"DELIM must be APOSTROPHE/QUOTE/NONE in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
-	}
-
-	if (ca_err)
-	{
-		s.io_open.err = ofc_sema_expr(
-			scope, ca_err->expr);
-		if (!s.io_open.err)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_open.err, NULL))
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-	}
 
-	bool is_scratch = false;
-	if (ca_status)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_BLANK, &s.io_open.blank)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_DELIM, &s.io_open.delim)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ERR, &s.io_open.err)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_STATUS, &s.io_open.status))
 	{
-		s.io_open.status = ofc_sema_expr(
-			scope, ca_status->expr);
-		if (!s.io_open.status)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.status);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"STATUS must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.status);
-			is_scratch = (constant &&
-				ofc_typeval_character_equal_strz_ci(constant, "SCRATCH"));
-			if (constant && !is_scratch
-				&& !ofc_typeval_character_equal_strz_ci(constant, "UNKNOWN")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "REPLACE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "OLD")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NEW"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"STATUS must be UNKNOWN/REPLACE/OLD/NEW/SCRATCH in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+		ofc_sema_stmt_io_open__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_file && is_scratch)
+	bool is_scratch = ofc_typeval_character_equal_strz_ci(
+		ofc_sema_expr_constant(s.io_open.status), "SCRATCH");
+	if (params.arg[OFC_SEMA_IO_SPEC_FILE] && is_scratch)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"FILE can only be specified for non scratch files in OPEN");
 		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
-	else if (ca_file)
-	{
-		s.io_open.file = ofc_sema_expr(
-			scope, ca_file->expr);
-		if (!s.io_open.file)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.file);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FILE must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_iostat)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_FILE, &s.io_open.file)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_IOSTAT, &s.io_open.iostat))
 	{
-		s.io_open.iostat = ofc_sema_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_open.iostat)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (s.io_open.iostat->type != OFC_SEMA_EXPR_LHS)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be a variable in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.iostat);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
+		ofc_sema_stmt_io_open__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_pad && format_type_unformatted)
+	if (params.arg[OFC_SEMA_IO_SPEC_PAD] && format_type_unformatted)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"PAD can only be specified for formatted I/O in OPEN");
 		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
-	else if (ca_pad)
-	{
-		s.io_open.pad = ofc_sema_expr(
-			scope, ca_pad->expr);
-		if (!s.io_open.pad)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.pad);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"PAD must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.pad);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NO")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "YES"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"PAD must be YES/NO in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_PAD, &s.io_open.pad))
+	{
+		ofc_sema_stmt_io_open__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_position && access_type_direct)
+	if (params.arg[OFC_SEMA_IO_SPEC_POSITION] && access_type_direct)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"POSITION can only be specified for files with sequential access in OPEN");
 		ofc_sema_stmt_io_open__cleanup(s);
 		return NULL;
 	}
-	else if (ca_position)
-	{
-		s.io_open.position = ofc_sema_expr(
-			scope, ca_position->expr);
-		if (!s.io_open.position)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.position);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"POSITION must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.position);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "REWIND")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "APPEND")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "ASIS"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"POSITION must be REWIND/APPEND/ASIS in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
-	}
-
-	if (ca_recl)
+	/* TODO - Clamp RECL to range? */
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_POSITION, &s.io_open.position)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_RECL, &s.io_open.recl))
 	{
-		s.io_open.recl = ofc_sema_expr(
-			scope, ca_recl->expr);
-		if (!s.io_open.recl) return NULL;
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.recl);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"RECL must be of type INTEGER in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_typeval_t* evalue
-			= ofc_sema_expr_constant(s.io_open.recl);
-		if (evalue)
-		{
-			int64_t evalue64;
-			bool success = ofc_sema_typeval_get_integer(
-				evalue, &evalue64);
-
-			if (success)
-			{
-				if (evalue64 < 0)
-				{
-					ofc_sparse_ref_error(stmt->src,
-						"RECL must be a positive INTEGER in OPEN");
-					ofc_sema_stmt_io_open__cleanup(s);
-					return NULL;
-				}
-
-				/* TODO - Clamp to range? */
-			}
-        }
+		ofc_sema_stmt_io_open__cleanup(s);
+		return NULL;
 	}
 
 	ofc_sema_stmt_t* as
@@ -28,9 +28,26 @@ void ofc_sema_stmt_io_read__cleanup(
 	ofc_sema_expr_delete(s.io_read.err);
 	ofc_sema_expr_delete(s.io_read.iostat);
 	ofc_sema_expr_delete(s.io_read.rec);
-	ofc_sema_expr_delete(s.io_read.size);
+	ofc_sema_lhs_delete(s.io_read.size);
 }
 
+static const char* const ofc_sema_stmt_io_read__advance[]
+	= { "YES", "NO", NULL };
+
+static const ofc_sema_io_spec_t ofc_sema_stmt_io_read__spec[OFC_SEMA_IO_SPEC_COUNT] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT   ] = { 1, OFC_SEMA_IO_SPEC_TYPE_CUSTOM  , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_FMT    ] = { 2, OFC_SEMA_IO_SPEC_TYPE_CUSTOM  , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ADVANCE] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_read__advance, "'YES' or 'NO'" },
+	[OFC_SEMA_IO_SPEC_END    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL   , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_EOR    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL   , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ERR    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL   , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_IOSTAT ] = { 0, OFC_SEMA_IO_SPEC_TYPE_VARIABLE, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_REC    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_INTEGER , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_SIZE   ] = { 0, OFC_SEMA_IO_SPEC_TYPE_OUT_INTEGER, NULL, NULL },
+};
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -58,146 +75,18 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 	s.io_read.eor          = NULL;
 	s.io_read.size         = NULL;
 
-	ofc_parse_call_arg_t* ca_unit    = NULL;
-	ofc_parse_call_arg_t* ca_format  = NULL;
-	ofc_parse_call_arg_t* ca_iostat  = NULL;
-	ofc_parse_call_arg_t* ca_rec     = NULL;
-	ofc_parse_call_arg_t* ca_err     = NULL;
-	ofc_parse_call_arg_t* ca_advance = NULL;
-	ofc_parse_call_arg_t* ca_end     = NULL;
-	ofc_parse_call_arg_t* ca_eor     = NULL;
-	ofc_parse_call_arg_t* ca_size    = NULL;
+	const ofc_parse_call_arg_t* ca_unit   = NULL;
+	const ofc_parse_call_arg_t* ca_format = NULL;
 
+	ofc_sema_io_params_t params;
 	if (stmt->io_read.has_brakets)
 	{
-		unsigned i;
-		for (i = 0; i < stmt->io_read.params->count; i++)
-		{
-			ofc_parse_call_arg_t* param
-				= stmt->io_read.params->call_arg[i];
-			if (!param) continue;
+		if (!ofc_sema_io_params(stmt->io_read.params,
+			ofc_sema_stmt_io_read__spec, "READ", &params))
+			return NULL;
 
-			if (ofc_sparse_ref_empty(param->name))
-			{
-				if (i >= 2)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Un-named parameter %u has no meaning in READ.", i);
-					return NULL;
-				}
-
-				if (i == 0)
-				{
-					ca_unit = param;
-				}
-				else
-				{
-					if (!ca_unit)
-					{
-						ofc_sparse_ref_error(param->src,
-							"Un-named format parameter only valid after UNIT in READ.");
-						return NULL;
-					}
-
-					ca_format = param;
-				}
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-			{
-				if (ca_unit)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of UNIT in READ.");
-					return NULL;
-				}
-
-				ca_unit = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "FMT"))
-			{
-				if (ca_format)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of FMT in READ.");
-					return NULL;
-				}
-
-				ca_format = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-			{
-				if (ca_iostat)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of IOSTAT in READ.");
-					return NULL;
-				}
-
-				ca_iostat = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "REC"))
-			{
-				if (ca_rec)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of REC in READ.");
-					return NULL;
-				}
-
-				ca_rec = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-			{
-				if (ca_err)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of ERR in READ.");
-					return NULL;
-				}
-
-				ca_err = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "ADVANCE"))
-			{
-				if (ca_advance)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of ADVANCE in READ.");
-					return NULL;
-				}
-
-				ca_advance = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "END"))
-			{
-				if (ca_end)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of END in READ.");
-					return NULL;
-				}
-
-				ca_end = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "SIZE"))
-			{
-				if (ca_size)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of SIZE in READ.");
-					return NULL;
-				}
-
-				ca_size = param;
-			}
-			else
-			{
-				ofc_sparse_ref_error(param->src,
-					"Unrecognized paramater %u name '%.*s' in READ.",
-					i, param->name.string.size, param->name.string.base);
-				return NULL;
-			}
-		}
+		ca_unit   = params.arg[OFC_SEMA_IO_SPEC_UNIT];
+		ca_format = params.arg[OFC_SEMA_IO_SPEC_FMT];
 
 		if (!ca_unit)
 		{
@@ -208,6 +97,11 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 	}
 	else
 	{
+		ofc_parse_call_arg_list_t none = { 0, NULL };
+		if (!ofc_sema_io_params(&none,
+			ofc_sema_stmt_io_read__spec, "READ", &params))
+			return NULL;
+
 		ca_format = stmt->io_read.params->call_arg[0];
 	}
 
@@ -320,164 +214,60 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 		return NULL;
 	}
 
-	if (ca_advance && s.io_read.stdin)
+	if (params.arg[OFC_SEMA_IO_SPEC_ADVANCE] && s.io_read.stdin)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"ADVANCE specifier can only be used with an external UNIT in READ");
 		ofc_sema_stmt_io_read__cleanup(s);
 		return NULL;
 	}
-	else if (ca_advance && (!ca_format || s.io_read.format_ldio))
+	else if (params.arg[OFC_SEMA_IO_SPEC_ADVANCE]
+		&& (!ca_format || s.io_read.format_ldio))
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"ADVANCE specifier can only be used with a formatted input in READ");
 		ofc_sema_stmt_io_read__cleanup(s);
 		return NULL;
 	}
-	else if (ca_advance)
-	{
-		s.io_read.advance = ofc_sema_expr(
-			scope, ca_advance->expr);
-		if (!s.io_read.advance)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_read.advance);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ADVANCE must be a CHARACTER expression in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_read.advance);
-
-			const char* advance_str;
-			if (!ofc_sema_typeval_get_character(constant, &advance_str))
-			{
-				ofc_sema_stmt_io_read__cleanup(s);
-				return NULL;
-			}
-
-			if (strcasecmp(advance_str, "NO") == 0)
-			{
-				s.io_read.is_advancing = false;
-			}
-			else if (strcasecmp(advance_str, "YES") != 0)
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"ADVANCE must be 'YES' or 'NO' in READ");
-				ofc_sema_stmt_io_read__cleanup(s);
-				return NULL;
-			}
-		}
-	}
-
-	if (ca_end)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_ADVANCE, &s.io_read.advance))
 	{
-		s.io_read.end = ofc_sema_expr(
-			scope, ca_end->expr);
-		if (!s.io_read.end)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_read.end, NULL))
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
+		ofc_sema_stmt_io_read__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_eor)
+	if (s.io_read.advance)
 	{
-		s.io_read.eor = ofc_sema_expr(
-			scope, ca_eor->expr);
-		if (!s.io_read.eor)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_read.eor, NULL))
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-	}
+		const ofc_sema_typeval_t* constant
+			= ofc_sema_expr_constant(s.io_read.advance);
 
-	if (ca_err)
-	{
-		s.io_read.err = ofc_sema_expr(
-			scope, ca_err->expr);
-		if (!s.io_read.err)
+		const char* advance_str;
+		if (!ofc_sema_typeval_get_character(constant, &advance_str))
 		{
 			ofc_sema_stmt_io_read__cleanup(s);
 			return NULL;
 		}
 
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_read.err, NULL))
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
+		s.io_read.is_advancing
+			= (strcasecmp(advance_str, "NO") != 0);
 	}
 
-	if (ca_iostat)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_END, &s.io_read.end)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_EOR, &s.io_read.eor)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ERR, &s.io_read.err)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_IOSTAT, &s.io_read.iostat))
 	{
-		s.io_read.iostat = ofc_sema_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_read.iostat)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		if (s.io_read.iostat->type != OFC_SEMA_EXPR_LHS)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be a variable in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_read.iostat);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
+		ofc_sema_stmt_io_read__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_rec && (s.io_read.format_ldio || ca_end))
+	if (params.arg[OFC_SEMA_IO_SPEC_REC]
+		&& (s.io_read.format_ldio || params.arg[OFC_SEMA_IO_SPEC_END]))
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"REC specifier not compatible with END,"
@@ -485,34 +275,15 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 		ofc_sema_stmt_io_read__cleanup(s);
 		return NULL;
 	}
-	else if (ca_rec)
-	{
-		s.io_read.rec = ofc_sema_expr(
-			scope, ca_rec->expr);
-		if (!s.io_read.rec)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_read.rec);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"REC must be of type INTEGER in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_REC, &s.io_read.rec))
+	{
+		ofc_sema_stmt_io_read__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_size && s.io_read.is_advancing)
+	if (params.arg[OFC_SEMA_IO_SPEC_SIZE] && s.io_read.is_advancing)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"SIZE not compatible with advancing formatted "
@@ -520,35 +291,17 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 		ofc_sema_stmt_io_read__cleanup(s);
 		return NULL;
 	}
-	else if (ca_size)
-	{
-		if (s.io_read.size->type != OFC_SEMA_EXPR_LHS)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"SIZE must be a variable in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
-		/* TODO - The variable specified in SIZE must
-				  not be the same as or associated with any
-				  entity in the input/output item list or in
-				  the namelist group or with the variable
-				  specified in the IOSTAT= specifier */
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_read.size);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
 
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"SIZE must be of type INTEGER in READ");
-			ofc_sema_stmt_io_read__cleanup(s);
-			return NULL;
-		}
+	/* TODO - The variable specified in SIZE must
+			  not be the same as or associated with any
+			  entity in the input/output item list or in
+			  the namelist group or with the variable
+			  specified in the IOSTAT= specifier */
+	if (!ofc_sema_io_spec_lhs(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_SIZE, &s.io_read.size))
+	{
+		ofc_sema_stmt_io_read__cleanup(s);
+		return NULL;
 	}
 
 	/* Check iolist */
@@ -696,6 +449,13 @@ bool ofc_sema_stmt_read_print(ofc_colstr_t* cs,
 			return false;
 	}
 
+	if (stmt->io_read.advance)
+	{
+		if (!ofc_sema_stmt_read__print_optional(
+			cs, "ADVANCE", stmt->io_read.advance))
+			return false;
+	}
+
 	if (stmt->io_read.iostat)
 	{
 		if (!ofc_sema_stmt_read__print_optional(
@@ -728,8 +488,11 @@ bool ofc_sema_stmt_read_print(ofc_colstr_t* cs,
 	}
 	if (stmt->io_read.size)
 	{
-		if (!ofc_sema_stmt_read__print_optional(
-			cs,	"SIZE", stmt->io_read.size))
+		if (!ofc_colstr_atomic_writef(cs, ",")
+			|| !ofc_colstr_atomic_writef(cs, " ")
+			|| !ofc_colstr_atomic_writef(cs, "SIZE")
+			|| !ofc_colstr_atomic_writef(cs, "= ")
+			|| !ofc_sema_lhs_print(cs, stmt->io_read.size))
 			return false;
 	}
 
@@ -29,6 +29,20 @@ static void ofc_sema_stmt_io_write__cleanup(
 	ofc_sema_expr_list_delete(s.io_write.iolist);
 }
 
+static const char* const ofc_sema_stmt_io_write__advance[]
+	= { "YES", "NO", NULL };
+
+static const ofc_sema_io_spec_t ofc_sema_stmt_io_write__spec[OFC_SEMA_IO_SPEC_COUNT] =
+{
+	[OFC_SEMA_IO_SPEC_UNIT   ] = { 1, OFC_SEMA_IO_SPEC_TYPE_CUSTOM  , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_FMT    ] = { 2, OFC_SEMA_IO_SPEC_TYPE_CUSTOM  , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ADVANCE] = { 0, OFC_SEMA_IO_SPEC_TYPE_CHARACTER,
+		ofc_sema_stmt_io_write__advance, "'YES' or 'NO'" },
+	[OFC_SEMA_IO_SPEC_IOSTAT ] = { 0, OFC_SEMA_IO_SPEC_TYPE_VARIABLE, NULL, NULL },
+	[OFC_SEMA_IO_SPEC_REC    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_INTEGER , NULL, NULL },
+	[OFC_SEMA_IO_SPEC_ERR    ] = { 0, OFC_SEMA_IO_SPEC_TYPE_LABEL   , NULL, NULL },
+};
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_write(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -53,119 +67,15 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_write(
 	s.io_write.rec          = NULL;
 	s.io_write.iolist       = NULL;
 
-	ofc_parse_call_arg_t* ca_unit    = NULL;
-	ofc_parse_call_arg_t* ca_format  = NULL;
-	ofc_parse_call_arg_t* ca_iostat  = NULL;
-	ofc_parse_call_arg_t* ca_rec     = NULL;
-	ofc_parse_call_arg_t* ca_err     = NULL;
-	ofc_parse_call_arg_t* ca_advance = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 2)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in WRITE.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-			else
-			{
-				if (!ca_unit)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Un-named format parameter only valid after UNIT in WRITE.");
-					return NULL;
-				}
-
-				ca_format = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in WRITE.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FMT"))
-		{
-			if (ca_format)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FMT in WRITE.");
-				return NULL;
-			}
-
-			ca_format = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in WRITE.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "REC"))
-		{
-			if (ca_rec)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of REC in WRITE.");
-				return NULL;
-			}
-
-			ca_rec = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in WRITE.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ADVANCE"))
-		{
-			if (ca_advance)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ADVANCE in WRITE.");
-				return NULL;
-			}
+	ofc_sema_io_params_t params;
+	if (!ofc_sema_io_params(stmt->io.params,
+		ofc_sema_stmt_io_write__spec, "WRITE", &params))
+		return NULL;
 
-			ca_advance = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in WRITE.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	const ofc_parse_call_arg_t* ca_unit
+		= params.arg[OFC_SEMA_IO_SPEC_UNIT];
+	const ofc_parse_call_arg_t* ca_format
+		= params.arg[OFC_SEMA_IO_SPEC_FMT];
 
 	if (!ca_unit)
 	{
@@ -279,107 +189,53 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_write(
 		return NULL;
 	}
 
-	if (ca_advance && s.io_write.stdout)
+	if (params.arg[OFC_SEMA_IO_SPEC_ADVANCE] && s.io_write.stdout)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"ADVANCE specifier can only be used with an external UNIT in WRITE");
 		ofc_sema_stmt_io_write__cleanup(s);
 		return NULL;
 	}
-	else if (ca_advance && (!ca_format || s.io_write.format_ldio))
+	else if (params.arg[OFC_SEMA_IO_SPEC_ADVANCE]
+		&& (!ca_format || s.io_write.format_ldio))
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"ADVANCE specifier can only be used with a formatted input in WRITE");
 		ofc_sema_stmt_io_write__cleanup(s);
 		return NULL;
 	}
-	else if (ca_advance)
-	{
-		s.io_write.advance = ofc_sema_expr(
-			scope, ca_advance->expr);
-		if (!s.io_write.advance)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_write.advance);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ADVANCE must be a CHARACTER expression in WRITE");
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_write.advance);
-
-			const char* advance_str;
-			if (!ofc_sema_typeval_get_character(constant, &advance_str))
-			{
-				ofc_sema_stmt_io_write__cleanup(s);
-				return NULL;
-			}
-
-			if (strcasecmp(advance_str, "NO") == 0)
-			{
-				s.io_write.is_advancing = false;
-			}
-			else if (strcasecmp(advance_str, "YES") != 0)
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"ADVANCE must be 'YES' or 'NO' in WRITE");
-				ofc_sema_stmt_io_write__cleanup(s);
-				return NULL;
-			}
-		}
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_ADVANCE, &s.io_write.advance))
+	{
+		ofc_sema_stmt_io_write__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_iostat)
+	if (s.io_write.advance)
 	{
-		s.io_write.iostat = ofc_sema_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_write.iostat)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
+		const ofc_sema_typeval_t* constant
+			= ofc_sema_expr_constant(s.io_write.advance);
 
-		if (s.io_write.iostat->type != OFC_SEMA_EXPR_LHS)
+		const char* advance_str;
+		if (!ofc_sema_typeval_get_character(constant, &advance_str))
 		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be a variable in WRITE");
 			ofc_sema_stmt_io_write__cleanup(s);
 			return NULL;
 		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_write.iostat);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
+		s.io_write.is_advancing
+			= (strcasecmp(advance_str, "NO") != 0);
+	}
 
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in WRITE");
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+		OFC_SEMA_IO_SPEC_IOSTAT, &s.io_write.iostat))
+	{
+		ofc_sema_stmt_io_write__cleanup(s);
+		return NULL;
 	}
 
-	if (ca_rec && s.io_write.format_ldio)
+	if (params.arg[OFC_SEMA_IO_SPEC_REC] && s.io_write.format_ldio)
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"REC specifier not compatible with namelist"
@@ -387,50 +243,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_write(
 		ofc_sema_stmt_io_write__cleanup(s);
 		return NULL;
 	}
-	else if (ca_rec)
-	{
-		s.io_write.rec = ofc_sema_expr(
-			scope, ca_rec->expr);
-		if (!s.io_write.rec)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_write.rec);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"REC must be of type INTEGER in WRITE");
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_err)
+	if (!ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_REC, &s.io_write.rec)
+		|| !ofc_sema_io_spec_expr(scope, stmt, &params,
+			OFC_SEMA_IO_SPEC_ERR, &s.io_write.err))
 	{
-		s.io_write.err = ofc_sema_expr(
-			scope, ca_err->expr);
-		if (!s.io_write.err)
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_io_check_label(
-			scope, stmt, false,
-			s.io_write.err, NULL))
-		{
-			ofc_sema_stmt_io_write__cleanup(s);
-			return NULL;
-		}
+		ofc_sema_stmt_io_write__cleanup(s);
+		return NULL;
 	}
 
 	/* Check iolist */
@@ -27,6 +27,11 @@ static const ofc_str_ref_t* ofc_structure__member_name(
 }
 
 
+static void ofc_sema_structure__layout_delete(
+	ofc_sema_structure_layout_t* layout);
+static const ofc_sema_structure_layout_t* ofc_sema_structure__layout(
+	const ofc_sema_structure_t* structure);
+
 static ofc_sema_structure_t* ofc_sema__structure(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -45,6 +50,10 @@ static ofc_sema_structure_t* ofc_sema__structure(
 			type = OFC_SEMA_STRUCTURE_VAX_UNION;
 			break;
 
+		case OFC_PARSE_STMT_MAP:
+			type = OFC_SEMA_STRUCTURE_VAX_MAP;
+			break;
+
 		case OFC_PARSE_STMT_TYPE:
 			type = OFC_SEMA_STRUCTURE_F90_TYPE;
 			break;
@@ -54,7 +63,7 @@ static ofc_sema_structure_t* ofc_sema__structure(
 	}
 
 	ofc_sema_structure_t* structure
-		= (ofc_sema_structure_t*)malloc(
+		= (ofc_sema_structure_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_structure_t));
 	if (!structure) return NULL;
 
@@ -71,16 +80,20 @@ static ofc_sema_structure_t* ofc_sema__structure(
 		NULL);
 	if (!structure->map)
 	{
-		free(structure);
+		ofc_free(structure);
 		return NULL;
 	}
 
+	structure->case_sensitive = opts.case_sensitive;
+
 	structure->name = stmt->structure.name;
 	structure->type = type;
 
 	structure->count  = 0;
 	structure->member = NULL;
 
+	structure->layout = NULL;
+
 	structure->refcnt = 0;
 
 	if (stmt->structure.block)
@@ -111,6 +124,9 @@ static ofc_sema_structure_t* ofc_sema__structure(
 		}
 	}
 
+	/* The structure is complete, so freeze its layout now. */
+	ofc_sema_structure__layout(structure);
+
 	return structure;
 }
 
@@ -171,7 +187,7 @@ static void ofc_sema_structure__member_delete(
 	else
 		ofc_sema_decl_delete(member->decl);
 
-	free(member);
+	ofc_free(member);
 }
 
 void ofc_sema_structure_delete(
@@ -186,6 +202,7 @@ void ofc_sema_structure_delete(
 		return;
 	}
 
+	ofc_sema_structure__layout_delete(structure->layout);
 	ofc_hashmap_delete(structure->map);
 
 	unsigned i;
@@ -194,9 +211,9 @@ void ofc_sema_structure_delete(
 		ofc_sema_structure__member_delete(
 			structure->member[i]);
 	}
-	free(structure->member);
+	ofc_free(structure->member);
 
-	free(structure);
+	ofc_free(structure);
 }
 
 
@@ -209,6 +226,287 @@ static bool ofc_sema_structure__member_anon(
 		member->structure->name);
 }
 
+typedef struct
+{
+	const ofc_sema_decl_t* decl;
+	unsigned               offset;
+} ofc_sema_structure__offset_t;
+
+struct ofc_sema_structure_layout_s
+{
+	/* Members are flattened through anonymous members,
+	   named nested structures have a NULL decl. */
+	unsigned                      member_count;
+	ofc_sema_decl_t**             member;
+	ofc_sema_structure__offset_t* offset;
+	ofc_hashmap_t*                offset_map;
+
+	/* Maps names to ofc_sema_structure_member_t,
+	   including those of anonymous members. */
+	ofc_hashmap_t* name_map;
+
+	/* Element count of each direct member. */
+	unsigned* elem_count_member;
+
+	bool     size_valid;
+	unsigned size;
+	bool     elem_count_valid;
+	unsigned elem_count;
+};
+
+static void ofc_sema_structure__layout_delete(
+	ofc_sema_structure_layout_t* layout)
+{
+	if (!layout)
+		return;
+
+	ofc_hashmap_delete(layout->name_map);
+	ofc_hashmap_delete(layout->offset_map);
+	ofc_free(layout->elem_count_member);
+	ofc_free(layout->offset);
+	ofc_free(layout->member);
+	ofc_free(layout);
+}
+
+static uint8_t ofc_sema_structure__decl_hash(
+	const ofc_sema_decl_t* const* decl)
+{
+	uintptr_t p = (uintptr_t)*decl;
+	return (uint8_t)((p >> 4) ^ (p >> 12));
+}
+
+static bool ofc_sema_structure__decl_equal(
+	const ofc_sema_decl_t* const* a,
+	const ofc_sema_decl_t* const* b)
+{
+	return (*a == *b);
+}
+
+static const ofc_sema_decl_t* const* ofc_sema_structure__offset_key(
+	const ofc_sema_structure__offset_t* offset)
+{
+	return (offset ? &offset->decl : NULL);
+}
+
+static bool ofc_sema_structure__layout_flatten(
+	ofc_sema_structure_layout_t* layout,
+	const ofc_sema_structure_t* structure)
+{
+	unsigned i;
+	for (i = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+
+		if (ofc_sema_structure__member_anon(member))
+		{
+			if (!ofc_sema_structure__layout_flatten(
+				layout, member->structure))
+				return false;
+			continue;
+		}
+
+		ofc_sema_decl_t** nmember
+			= (ofc_sema_decl_t**)ofc_realloc(OFC_ALLOC_SEMA, layout->member,
+				(sizeof(ofc_sema_decl_t*) * (layout->member_count + 1)));
+		if (!nmember) return false;
+		layout->member = nmember;
+
+		layout->member[layout->member_count++]
+			= (member->is_structure ? NULL : member->decl);
+	}
+
+	return true;
+}
+
+static bool ofc_sema_structure__layout_names(
+	ofc_sema_structure_layout_t* layout,
+	const ofc_sema_structure_t* structure)
+{
+	unsigned i;
+	for (i = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+		if (ofc_sema_structure__member_anon(member))
+			continue;
+
+		/* Direct members hide those of anonymous members. */
+		if (ofc_hashmap_find(layout->name_map,
+			ofc_structure__member_name(member)))
+			continue;
+
+		if (!ofc_hashmap_add(
+			layout->name_map, member))
+			return false;
+	}
+
+	for (i = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+		if (ofc_sema_structure__member_anon(member)
+			&& !ofc_sema_structure__layout_names(
+				layout, member->structure))
+			return false;
+	}
+
+	return true;
+}
+
+static ofc_sema_structure_layout_t* ofc_sema_structure__layout_create(
+	const ofc_sema_structure_t* structure)
+{
+	ofc_sema_structure_layout_t* layout
+		= (ofc_sema_structure_layout_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_structure_layout_t));
+	if (!layout) return NULL;
+
+	layout->member_count      = 0;
+	layout->member            = NULL;
+	layout->offset            = NULL;
+	layout->elem_count_member = NULL;
+
+	layout->offset_map = ofc_hashmap_create(
+		(void*)ofc_sema_structure__decl_hash,
+		(void*)ofc_sema_structure__decl_equal,
+		(void*)ofc_sema_structure__offset_key,
+		NULL);
+	layout->name_map = ofc_hashmap_create(
+		(void*)(structure->case_sensitive
+			? ofc_str_ref_ptr_hash
+			: ofc_str_ref_ptr_hash_ci),
+		(void*)(structure->case_sensitive
+			? ofc_str_ref_ptr_equal
+			: ofc_str_ref_ptr_equal_ci),
+		(void*)ofc_structure__member_name,
+		NULL);
+	if (!layout->offset_map || !layout->name_map
+		|| !ofc_sema_structure__layout_flatten(layout, structure)
+		|| !ofc_sema_structure__layout_names(layout, structure))
+	{
+		ofc_sema_structure__layout_delete(layout);
+		return NULL;
+	}
+
+	if (layout->member_count > 0)
+	{
+		layout->offset = (ofc_sema_structure__offset_t*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(ofc_sema_structure__offset_t) * layout->member_count);
+		if (!layout->offset)
+		{
+			ofc_sema_structure__layout_delete(layout);
+			return NULL;
+		}
+	}
+
+	unsigned i;
+	for (i = 0; i < layout->member_count; i++)
+	{
+		layout->offset[i].decl   = layout->member[i];
+		layout->offset[i].offset = i;
+
+		if (!layout->member[i]
+			|| ofc_hashmap_find(layout->offset_map,
+				&layout->offset[i].decl))
+			continue;
+
+		if (!ofc_hashmap_add(layout->offset_map,
+			&layout->offset[i]))
+		{
+			ofc_sema_structure__layout_delete(layout);
+			return NULL;
+		}
+	}
+
+	if (structure->count > 0)
+	{
+		layout->elem_count_member = (unsigned*)ofc_alloc(OFC_ALLOC_SEMA,
+			sizeof(unsigned) * structure->count);
+		if (!layout->elem_count_member)
+		{
+			ofc_sema_structure__layout_delete(layout);
+			return NULL;
+		}
+	}
+
+	bool is_union = ofc_sema_structure_is_union(structure);
+
+	layout->size_valid       = true;
+	layout->size             = 0;
+	layout->elem_count_valid = true;
+	layout->elem_count       = 0;
+
+	for (i = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+
+		unsigned msize, mcount;
+		bool size_valid, elem_count_valid;
+		if (member->is_structure)
+		{
+			const ofc_sema_structure_layout_t* mlayout
+				= ofc_sema_structure__layout(member->structure);
+			if (!mlayout)
+			{
+				ofc_sema_structure__layout_delete(layout);
+				return NULL;
+			}
+
+			size_valid       = mlayout->size_valid;
+			msize            = mlayout->size;
+			elem_count_valid = mlayout->elem_count_valid;
+			mcount           = mlayout->elem_count;
+		}
+		else
+		{
+			size_valid = ofc_sema_decl_size(
+				member->decl, &msize);
+			elem_count_valid = ofc_sema_decl_elem_count(
+				member->decl, &mcount);
+		}
+
+		/* Named members are a single element when indexing. */
+		layout->elem_count_member[i] = (member->is_structure
+			? (elem_count_valid ? mcount : 0) : 1);
+
+		if (!size_valid)
+			layout->size_valid = false;
+		else if (!is_union)
+			layout->size += msize;
+		else if (msize > layout->size)
+			layout->size = msize;
+
+		if (!elem_count_valid)
+			layout->elem_count_valid = false;
+		else if (!is_union)
+			layout->elem_count += mcount;
+		else if (mcount > layout->elem_count)
+			layout->elem_count = mcount;
+	}
+
+	return layout;
+}
+
+static const ofc_sema_structure_layout_t* ofc_sema_structure__layout(
+	const ofc_sema_structure_t* structure)
+{
+	if (!structure)
+		return NULL;
+
+	if (!structure->layout)
+	{
+		ofc_sema_structure_t* mstructure
+			= (ofc_sema_structure_t*)structure;
+		mstructure->layout
+			= ofc_sema_structure__layout_create(structure);
+	}
+
+	return structure->layout;
+}
+
+
 static bool ofc_sema_structure__member_add(
 	ofc_sema_structure_t*        structure,
 	ofc_sema_structure_member_t* member)
@@ -230,7 +528,7 @@ static bool ofc_sema_structure__member_add(
 	}
 
 	ofc_sema_structure_member_t** nmember
-		= (ofc_sema_structure_member_t**)realloc(structure->member,
+		= (ofc_sema_structure_member_t**)ofc_realloc(OFC_ALLOC_SEMA, structure->member,
 			(sizeof(ofc_sema_structure_member_t*) * (structure->count + 1)));
 	if (!nmember) return false;
 	structure->member = nmember;
@@ -239,6 +537,9 @@ static bool ofc_sema_structure__member_add(
 		structure->map, member))
 		return false;
 
+	ofc_sema_structure__layout_delete(structure->layout);
+	structure->layout = NULL;
+
 	structure->member[structure->count++] = member;
 	return true;
 }
@@ -251,7 +552,7 @@ bool ofc_sema_structure_member_add_decl(
 		return false;
 
 	ofc_sema_structure_member_t* m
-		= (ofc_sema_structure_member_t*)malloc(
+		= (ofc_sema_structure_member_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_structure_member_t));
 	if (!m) return false;
 
@@ -261,7 +562,7 @@ bool ofc_sema_structure_member_add_decl(
 	if (!ofc_sema_structure__member_add(
 		structure, m))
 	{
-		free(m);
+		ofc_free(m);
 		return false;
 	}
 
@@ -276,7 +577,7 @@ bool ofc_sema_structure_member_add_structure(
 		return false;
 
 	ofc_sema_structure_member_t* m
-		= (ofc_sema_structure_member_t*)malloc(
+		= (ofc_sema_structure_member_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_structure_member_t));
 	if (!m) return false;
 
@@ -286,7 +587,7 @@ bool ofc_sema_structure_member_add_structure(
 	if (!ofc_sema_structure__member_add(
 		structure, m))
 	{
-		free(m);
+		ofc_free(m);
 		return false;
 	}
 
@@ -298,24 +599,12 @@ bool ofc_sema_structure_member_count(
 	const ofc_sema_structure_t* structure,
 	unsigned* count)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout)
 		return false;
 
-	unsigned i, c;
-	for (i = 0, c = 0; i < structure->count; i++)
-	{
-		unsigned rc = 1;
-		if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &rc))
-				return false;
-		}
-		c += rc;
-	}
-
-	if (count) *count = c;
+	if (count) *count = layout->member_count;
 	return true;
 }
 
@@ -323,75 +612,30 @@ ofc_sema_decl_t* ofc_sema_structure_member_get_decl_offset(
 	ofc_sema_structure_t* structure,
 	unsigned offset)
 {
-	if (!structure
-		|| !structure->member)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout || (offset >= layout->member_count))
 		return NULL;
 
-	unsigned i, o;
-	for (i = 0, o = offset; i < structure->count; i++)
-	{
-		if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			unsigned count;
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &count))
-				return NULL;
-
-			if (o < count)
-				return ofc_sema_structure_member_get_decl_offset(
-					structure, o);
-			o -= count;
-		}
-		else
-		{
-			if (o == 0)
-			{
-				if (structure->member[i]->is_structure)
-					return NULL;
-				return structure->member[i]->decl;
-			}
-			o -= 1;
-		}
-	}
-
-	return NULL;
+	return layout->member[offset];
 }
 
 ofc_sema_decl_t* ofc_sema_structure_member_get_decl_name(
 	ofc_sema_structure_t* structure,
 	ofc_str_ref_t name)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout)
 		return NULL;
 
-	ofc_sema_structure_member_t* member
-		= ofc_hashmap_find_modify(
-			structure->map, &name);
-	if (member)
-	{
-		if (member->is_structure)
-			return NULL;
-		return member->decl;
-	}
-
-	if (!member)
-	{
-		unsigned i;
-		for (i = 0; i < structure->count; i++)
-		{
-			if (!ofc_sema_structure__member_anon(
-				structure->member[i]))
-				continue;
-
-			ofc_sema_decl_t* decl
-				= ofc_sema_structure_member_get_decl_name(
-					member->structure, name);
-			if (decl) return decl;
-		}
-	}
+	const ofc_sema_structure_member_t* member
+		= ofc_hashmap_find(
+			layout->name_map, &name);
+	if (!member || member->is_structure)
+		return NULL;
 
-	return NULL;
+	return member->decl;
 }
 
 bool ofc_sema_structure_member_offset(
@@ -399,45 +643,22 @@ bool ofc_sema_structure_member_offset(
 	const ofc_sema_decl_t* member,
 	unsigned* offset)
 {
-	if (!structure || !member)
+	if (!member)
 		return false;
 
-	unsigned i, o;
-	for (i = 0, o = 0; i < structure->count; i++)
-	{
-		if (!structure->member[i]->is_structure)
-		{
-            if (structure->member[i]->decl == member)
-			{
-				if (offset) *offset = o;
-				return true;
-			}
-			o++;
-		}
-		else if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			unsigned ao;
-			if (ofc_sema_structure_member_offset(
-				structure->member[i]->structure, member, &ao))
-			{
-				if (offset) *offset = (o + ao);
-				return true;
-			}
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout)
+		return false;
 
-			unsigned ac;
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &ac))
-				return false;
-			o += ac;
-		}
-		else
-		{
-			o++;
-		}
-	}
+	const ofc_sema_structure__offset_t* entry
+		= ofc_hashmap_find(
+			layout->offset_map, &member);
+	if (!entry)
+		return false;
 
-	return false;
+	if (offset) *offset = entry->offset;
+	return true;
 }
 
 
@@ -480,41 +701,12 @@ bool ofc_sema_structure_size(
 	const ofc_sema_structure_t* structure,
 	unsigned* size)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout || !layout->size_valid)
 		return false;
 
-	unsigned usize = 0;
-	unsigned ssize = 0;
-	unsigned i;
-	for (i = 0; i < structure->count; i++)
-	{
-		unsigned msize;
-		if (structure->member[i]->is_structure)
-		{
-			if (!ofc_sema_structure_size(
-				structure->member[i]->structure, &msize))
-				return false;
-		}
-		else
-		{
-			if (!ofc_sema_decl_size(
-				structure->member[i]->decl, &msize))
-				return false;
-		}
-
-		if (msize > usize)
-			usize = msize;
-		ssize += msize;
-	}
-
-	if (size)
-	{
-		if (ofc_sema_structure_is_union(structure))
-			*size = usize;
-		else
-			*size = ssize;
-	}
-
+	if (size) *size = layout->size;
 	return true;
 }
 
@@ -522,41 +714,12 @@ bool ofc_sema_structure_elem_count(
 	const ofc_sema_structure_t* structure,
 	unsigned* count)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout || !layout->elem_count_valid)
 		return false;
 
-	unsigned ucount = 0;
-	unsigned scount = 0;
-	unsigned i;
-	for (i = 0; i < structure->count; i++)
-	{
-		unsigned mcount;
-		if (structure->member[i]->is_structure)
-		{
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &mcount))
-				return false;
-		}
-		else
-		{
-			if (!ofc_sema_decl_elem_count(
-				structure->member[i]->decl, &mcount))
-				return false;
-		}
-
-		if (mcount > ucount)
-			ucount = mcount;
-		scount += mcount;
-	}
-
-	if (count)
-	{
-		if (ofc_sema_structure_is_union(structure))
-			*count = ucount;
-		else
-			*count = scount;
-	}
-
+	if (count) *count = layout->elem_count;
 	return true;
 }
 
@@ -564,31 +727,23 @@ ofc_sema_decl_t* ofc_sema_structure_elem_get(
 	ofc_sema_structure_t* structure,
 	unsigned offset)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout)
 		return NULL;
 
 	unsigned i, o;
 	for (i = 0, o = 0; i < structure->count; i++)
 	{
-		if (structure->member[i]->is_structure)
+		unsigned sc = layout->elem_count_member[i];
+		if ((offset - o) < sc)
 		{
-			unsigned sc;
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &sc))
-				return NULL;
-
-			if ((offset - o) < sc)
+			if (structure->member[i]->is_structure)
 				return ofc_sema_structure_elem_get(
 					structure->member[i]->structure, (offset - o));
-
-			o += sc;
-		}
-		else
-		{
-			if (o == offset)
-				return structure->member[i]->decl;
-			o++;
+			return structure->member[i]->decl;
 		}
+		o += sc;
 	}
 
 	return NULL;
@@ -599,7 +754,9 @@ bool ofc_sema_structure_elem_print(
 	const ofc_sema_structure_t* structure,
 	unsigned offset)
 {
-	if (!structure)
+	const ofc_sema_structure_layout_t* layout
+		= ofc_sema_structure__layout(structure);
+	if (!layout)
 		return false;
 
 	char msym = '%';
@@ -615,10 +772,7 @@ bool ofc_sema_structure_elem_print(
 	{
 		if (structure->member[i]->is_structure)
 		{
-			unsigned sc;
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &sc))
-				return NULL;
+			unsigned sc = layout->elem_count_member[i];
 
 			if ((offset - o) < sc)
 			{
@@ -680,6 +834,10 @@ bool ofc_sema_structure_print(
 			kwstr = "UNION";
 			break;
 
+		case OFC_SEMA_STRUCTURE_VAX_MAP:
+			kwstr = "MAP";
+			break;
+
 		default:
 			return false;
 	}
@@ -687,11 +845,16 @@ bool ofc_sema_structure_print(
 	if (!ofc_colstr_atomic_writef(cs, "%s", kwstr))
 		return false;
 
+	/* VAX structure names are delimited and not repeated at the end. */
+	bool is_vax = (structure->type
+		!= OFC_SEMA_STRUCTURE_F90_TYPE);
+
 	bool has_name = !ofc_sparse_ref_empty(structure->name);
 	if (has_name)
 	{
-		if (!ofc_colstr_atomic_writef(cs, " ")
-			|| !ofc_sparse_ref_print(cs, structure->name))
+		if (!ofc_colstr_atomic_writef(cs, (is_vax ? " /" : " "))
+			|| !ofc_sparse_ref_print(cs, structure->name)
+			|| (is_vax && !ofc_colstr_atomic_writef(cs, "/")))
 			return false;
 	}
 
@@ -718,7 +881,7 @@ bool ofc_sema_structure_print(
 		|| !ofc_colstr_atomic_writef(cs, "%s", kwstr))
 		return false;
 
-	if (has_name)
+	if (has_name && !is_vax)
 	{
 		if (!ofc_colstr_atomic_writef(cs, " ")
 			|| !ofc_sparse_ref_print(cs, structure->name))
@@ -742,7 +905,7 @@ ofc_sema_structure_list_t* ofc_sema_structure_list_create(
 	bool case_sensitive)
 {
 	ofc_sema_structure_list_t* list
-		= (ofc_sema_structure_list_t*)malloc(
+		= (ofc_sema_structure_list_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_structure_list_t));
 	if (!list) return NULL;
 
@@ -757,7 +920,7 @@ ofc_sema_structure_list_t* ofc_sema_structure_list_create(
 		NULL);
 	if (!list->map)
 	{
-		free(list);
+		ofc_free(list);
 		return NULL;
 	}
 
@@ -781,9 +944,9 @@ void ofc_sema_structure_list_delete(
 		ofc_sema_structure_delete(
 			list->structure[i]);
 	}
-	free(list->structure);
+	ofc_free(list->structure);
 
-	free(list);
+	ofc_free(list);
 }
 
 
@@ -799,7 +962,7 @@ bool ofc_sema_structure_list_add(
 		return false;
 
 	ofc_sema_structure_t** nstructure
-		= (ofc_sema_structure_t**)realloc(list->structure,
+		= (ofc_sema_structure_t**)ofc_realloc(OFC_ALLOC_SEMA, list->structure,
 			(sizeof(ofc_sema_structure_t*) * (list->count + 1)));
 	if (!nstructure) return false;
 	list->structure = nstructure;
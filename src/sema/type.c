@@ -17,6 +17,7 @@
 
 #include "ofc/sema.h"
 #include "ofc/target.h"
+#include "ofc/context.h"
 
 
 static bool ofc_sema_type__kind_valid(
@@ -40,7 +41,7 @@ static bool ofc_sema_type__kind_valid(
 	return false;
 }
 
-static bool ofc_sema_type__kind_absolute(
+bool ofc_sema_type_kind_absolute(
 	unsigned kind)
 {
 	return ((kind > 0) && ((kind % 3) == 0));
@@ -49,7 +50,7 @@ static bool ofc_sema_type__kind_absolute(
 bool ofc_sema_type_kind_size(
 	unsigned def, unsigned kind, unsigned* size)
 {
-	if (ofc_sema_type__kind_absolute(kind))
+	if (ofc_sema_type_kind_absolute(kind))
 	{
 		if (size) *size = (kind / 3);
 		return true;
@@ -84,8 +85,18 @@ bool ofc_sema_type_kind_size(
 }
 
 
+unsigned ofc_sema_type_kind_star(
+	ofc_sema_type_e type, unsigned size)
+{
+	if (type == OFC_SEMA_TYPE_COMPLEX)
+	{
+		if ((size % 2) != 0)
+			return 0;
+		size /= 2;
+	}
 
-static ofc_hashmap_t* ofc_sema_type__map = NULL;
+	return (3 * size);
+}
 
 static const char* ofc_sema_type__name[] =
 {
@@ -162,7 +173,7 @@ static void ofc_sema_type__delete(ofc_sema_type_t* type)
 	if (!type)
 		return;
 
-	free(type);
+	ofc_free(type);
 }
 
 uint8_t ofc_sema_type_hash(
@@ -203,11 +214,54 @@ static const ofc_sema_type_t* ofc_sema_type__key(
 	return type;
 }
 
-static void ofc_sema_type__map_cleanup(void)
+void ofc_sema_type_map_cleanup(void)
 {
-	ofc_hashmap_delete(ofc_sema_type__map);
+	ofc_context_t* context = ofc_context_current();
+	ofc_hashmap_delete(context->sema_type_map);
+	context->sema_type_map = NULL;
+
+	memset(&context->sema_type_default, 0x00,
+		sizeof(context->sema_type_default));
 }
 
+
+/* Primitive types with small kinds are laid out statically and indexed
+   directly, so they never need to be hashed or interned. */
+#define OFC_SEMA_TYPE__PRIMITIVE_KIND_MAX 64
+
+#define OFC_SEMA_TYPE__PRIMITIVE(t, k) \
+	{ .type = t, .kind = k, .len = 0, .len_var = false }
+#define OFC_SEMA_TYPE__PRIMITIVE_8(t, k) \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 0), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 1), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 2), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 3), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 4), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 5), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 6), \
+	OFC_SEMA_TYPE__PRIMITIVE(t, (k) + 7)
+#define OFC_SEMA_TYPE__PRIMITIVE_ROW(t) \
+	{ \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t,  0), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t,  8), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 16), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 24), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 32), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 40), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 48), \
+		OFC_SEMA_TYPE__PRIMITIVE_8(t, 56), \
+	}
+
+static const ofc_sema_type_t ofc_sema_type__primitive
+	[OFC_SEMA_TYPE_CHARACTER][OFC_SEMA_TYPE__PRIMITIVE_KIND_MAX] =
+{
+	OFC_SEMA_TYPE__PRIMITIVE_ROW(OFC_SEMA_TYPE_LOGICAL),
+	OFC_SEMA_TYPE__PRIMITIVE_ROW(OFC_SEMA_TYPE_INTEGER),
+	OFC_SEMA_TYPE__PRIMITIVE_ROW(OFC_SEMA_TYPE_REAL),
+	OFC_SEMA_TYPE__PRIMITIVE_ROW(OFC_SEMA_TYPE_COMPLEX),
+	OFC_SEMA_TYPE__PRIMITIVE_ROW(OFC_SEMA_TYPE_BYTE),
+};
+
 static const ofc_sema_type_t* ofc_sema_type__create(
 	ofc_sema_type_e type,
 	unsigned kind, unsigned len, bool len_var,
@@ -241,17 +295,33 @@ static const ofc_sema_type_t* ofc_sema_type__create(
 			break;
 	}
 
-	if (!ofc_sema_type__map)
+	if ((type < OFC_SEMA_TYPE_CHARACTER)
+		&& (kind < OFC_SEMA_TYPE__PRIMITIVE_KIND_MAX))
+	{
+		/* A LOGICAL*1 is a synonym of BYTE. */
+		unsigned bsize;
+		if ((type == OFC_SEMA_TYPE_LOGICAL)
+			&& ofc_sema_type_kind_size(
+				ofc_target_logical_size_get(), kind, &bsize)
+			&& (bsize == 1))
+		{
+			type = OFC_SEMA_TYPE_BYTE;
+			kind = 1;
+		}
+
+		return &ofc_sema_type__primitive[type][kind];
+	}
+
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_map)
 	{
-		ofc_sema_type__map = ofc_hashmap_create(
+		context->sema_type_map = ofc_hashmap_create(
 			(void*)ofc_sema_type_hash,
 			(void*)ofc_sema_type_compare,
 			(void*)ofc_sema_type__key,
 			(void*)ofc_sema_type__delete);
-		if (!ofc_sema_type__map)
+		if (!context->sema_type_map)
 			return NULL;
-
-		atexit(ofc_sema_type__map_cleanup);
 	}
 
 	ofc_sema_type_t stype =
@@ -287,17 +357,17 @@ static const ofc_sema_type_t* ofc_sema_type__create(
 
 	const ofc_sema_type_t* gtype
 		= ofc_hashmap_find(
-			ofc_sema_type__map, &stype);
+			context->sema_type_map, &stype);
 	if (gtype) return gtype;
 
 	ofc_sema_type_t* ntype
-		= (ofc_sema_type_t*)malloc(
+		= (ofc_sema_type_t*)ofc_alloc(OFC_ALLOC_SEMA,
 			sizeof(ofc_sema_type_t));
 	if (!ntype) return NULL;
 	*ntype = stype;
 
 	if (!ofc_hashmap_add(
-		ofc_sema_type__map, ntype))
+		context->sema_type_map, ntype))
 	{
 		ofc_sema_type__delete(ntype);
 		return NULL;
@@ -356,140 +426,140 @@ const ofc_sema_type_t* ofc_sema_type_create_function(
 
 const ofc_sema_type_t* ofc_sema_type_logical_default(void)
 {
-	static const ofc_sema_type_t* logical = NULL;
-
-	if (!logical)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.logical)
 	{
-		logical = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_LOGICAL, 1);
+		context->sema_type_default.logical
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_LOGICAL, 1);
 	}
 
-	return logical;
+	return context->sema_type_default.logical;
 }
 
 const ofc_sema_type_t* ofc_sema_type_integer_default(void)
 {
-	static const ofc_sema_type_t* integer = NULL;
-
-	if (!integer)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.integer)
 	{
-		integer = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_INTEGER, 1);
+		context->sema_type_default.integer
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_INTEGER, 1);
 	}
 
-	return integer;
+	return context->sema_type_default.integer;
 }
 
 const ofc_sema_type_t* ofc_sema_type_real_default(void)
 {
-	static const ofc_sema_type_t* real = NULL;
-
-	if (!real)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.real)
 	{
-		real = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_REAL, 1);
+		context->sema_type_default.real
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_REAL, 1);
 	}
 
-	return real;
+	return context->sema_type_default.real;
 }
 
 const ofc_sema_type_t* ofc_sema_type_double_default(void)
 {
-	static const ofc_sema_type_t* dbl = NULL;
-
-	if (!dbl)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.dbl)
 	{
 		const ofc_sema_type_t* real
 			= ofc_sema_type_real_default();
 		if (!real) return NULL;
 
-		dbl = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_REAL, 2);
+		context->sema_type_default.dbl
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_REAL, 2);
 	}
 
-	return dbl;
+	return context->sema_type_default.dbl;
 }
 
 const ofc_sema_type_t* ofc_sema_type_complex_default(void)
 {
-	static const ofc_sema_type_t* complex = NULL;
-
-	if (!complex)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.complex)
 	{
-		complex = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_COMPLEX, 1);
+		context->sema_type_default.complex
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_COMPLEX, 1);
 	}
 
-	return complex;
+	return context->sema_type_default.complex;
 }
 
 const ofc_sema_type_t* ofc_sema_type_double_complex_default(void)
 {
-	static const ofc_sema_type_t* dbl_complex = NULL;
-
-	if (!dbl_complex)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.dbl_complex)
 	{
 		const ofc_sema_type_t* real
 			= ofc_sema_type_real_default();
 		if (!real) return NULL;
 
-		dbl_complex = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_COMPLEX, 2);
+		context->sema_type_default.dbl_complex
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_COMPLEX, 2);
 	}
 
-	return dbl_complex;
+	return context->sema_type_default.dbl_complex;
 }
 
 const ofc_sema_type_t* ofc_sema_type_byte_default(void)
 {
-	static const ofc_sema_type_t* byte = NULL;
-
-	if (!byte)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.byte)
 	{
-		byte = ofc_sema_type_create_primitive(
-			OFC_SEMA_TYPE_BYTE, 1);
+		context->sema_type_default.byte
+			= ofc_sema_type_create_primitive(
+				OFC_SEMA_TYPE_BYTE, 1);
 	}
 
-	return byte;
+	return context->sema_type_default.byte;
 }
 
 const ofc_sema_type_t* ofc_sema_type_subroutine(void)
 {
-	static const ofc_sema_type_t* subroutine = NULL;
-
-	if (!subroutine)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.subroutine)
 	{
-		subroutine = ofc_sema_type__create(
-			OFC_SEMA_TYPE_SUBROUTINE, 0, 0, false, NULL);
+		context->sema_type_default.subroutine
+			= ofc_sema_type__create(
+				OFC_SEMA_TYPE_SUBROUTINE, 0, 0, false, NULL);
 	}
 
-	return subroutine;
+	return context->sema_type_default.subroutine;
 }
 
 const ofc_sema_type_t* ofc_sema_type_type(void)
 {
-	static const ofc_sema_type_t* type = NULL;
-
-	if (!type)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.type)
 	{
-		type = ofc_sema_type__create(
-			OFC_SEMA_TYPE_TYPE, 0, 0, false, NULL);
+		context->sema_type_default.type
+			= ofc_sema_type__create(
+				OFC_SEMA_TYPE_TYPE, 0, 0, false, NULL);
 	}
 
-	return type;
+	return context->sema_type_default.type;
 }
 
 const ofc_sema_type_t* ofc_sema_type_record(void)
 {
-	static const ofc_sema_type_t* record = NULL;
-
-	if (!record)
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_type_default.record)
 	{
-		record = ofc_sema_type__create(
-			OFC_SEMA_TYPE_RECORD, 0, 0, false, NULL);
+		context->sema_type_default.record
+			= ofc_sema_type__create(
+				OFC_SEMA_TYPE_RECORD, 0, 0, false, NULL);
 	}
 
-	return record;
+	return context->sema_type_default.record;
 }
 
 
@@ -1113,12 +1183,15 @@ bool ofc_sema_type_print(
 			ofc_sema_type__name[type->type]))
 			return false;
 
-		kind_abs = ofc_sema_type__kind_absolute(type->kind);
+		kind_abs = ofc_sema_type_kind_absolute(type->kind);
 		if (kind_abs)
 		{
+			unsigned star = (type->kind / 3);
+			if (type->type == OFC_SEMA_TYPE_COMPLEX)
+				star *= 2;
+
 			if (!ofc_colstr_atomic_writef(cs, "*")
-				|| !ofc_colstr_atomic_writef(
-					cs, "%u", (type->kind / 3)))
+				|| !ofc_colstr_atomic_writef(cs, "%u", star))
 				return false;
 		}
 	}
@@ -20,26 +20,147 @@
 #undef complex
 #endif
 
-#include "ofc/noopt.h"
 #include "ofc/sema.h"
 #include "ofc/target.h"
+#include "ofc/context.h"
+#include "ofc/numfmt.h"
 
 
-/* TODO - Remove NO_OPT, once we find a better workaround
-          for the compiler error. */
-static ofc_sema_typeval_t* NO_OPT ofc_sema_typeval__alloc(
-	const ofc_sema_typeval_t typeval)
+/* Constant folding creates and destroys many short lived typevals,
+   so they're recycled through a free list rather than malloc'd. */
+#define OFC_SEMA_TYPEVAL__POOL_BLOCK 256
+
+union ofc_sema_typeval__pool_u
 {
-	ofc_sema_typeval_t* alloc_typeval =
-		(ofc_sema_typeval_t*)malloc(sizeof(ofc_sema_typeval_t));
+	ofc_sema_typeval__pool_t* next;
+	ofc_sema_typeval_t        typeval;
+};
 
-	if (!alloc_typeval) return NULL;
+struct ofc_sema_typeval__block_s
+{
+	ofc_sema_typeval__block_t* next;
+	ofc_sema_typeval__pool_t   entry[OFC_SEMA_TYPEVAL__POOL_BLOCK];
+};
 
-	*alloc_typeval = typeval;
+void ofc_sema_typeval_pool_cleanup(void)
+{
+	ofc_context_t* context = ofc_context_current();
+	while (context->sema_typeval_block)
+	{
+		ofc_sema_typeval__block_t* next
+			= context->sema_typeval_block->next;
+		ofc_free(context->sema_typeval_block);
+		context->sema_typeval_block = next;
+	}
+	context->sema_typeval_pool = NULL;
+}
+
+static ofc_sema_typeval_t* ofc_sema_typeval__pool_get(void)
+{
+	ofc_context_t* context = ofc_context_current();
+	if (!context->sema_typeval_pool)
+	{
+		ofc_sema_typeval__block_t* block
+			= (ofc_sema_typeval__block_t*)ofc_alloc(OFC_ALLOC_TYPEVAL,
+				sizeof(ofc_sema_typeval__block_t));
+		if (!block) return NULL;
+
+		block->next = context->sema_typeval_block;
+		context->sema_typeval_block = block;
+
+		unsigned i;
+		for (i = 0; i < OFC_SEMA_TYPEVAL__POOL_BLOCK; i++)
+		{
+			block->entry[i].next = context->sema_typeval_pool;
+			context->sema_typeval_pool = &block->entry[i];
+		}
+	}
+
+	ofc_sema_typeval__pool_t* entry
+		= context->sema_typeval_pool;
+	context->sema_typeval_pool = entry->next;
+	return &entry->typeval;
+}
 
+static void ofc_sema_typeval__pool_put(
+	ofc_sema_typeval_t* typeval)
+{
+	if (!typeval)
+		return;
+
+	ofc_context_t* context = ofc_context_current();
+	ofc_sema_typeval__pool_t* entry
+		= (ofc_sema_typeval__pool_t*)typeval;
+	entry->next = context->sema_typeval_pool;
+	context->sema_typeval_pool = entry;
+}
+
+static ofc_sema_typeval_t* ofc_sema_typeval__alloc(
+	const ofc_sema_typeval_t* typeval)
+{
+	ofc_sema_typeval_t* alloc_typeval
+		= ofc_sema_typeval__pool_get();
+	if (!alloc_typeval) return NULL;
+
+	memcpy(alloc_typeval, typeval,
+		sizeof(ofc_sema_typeval_t));
 	return alloc_typeval;
 }
 
+
+static bool ofc_sema_typeval__character_is_inline(
+	const ofc_sema_typeval_t* typeval)
+{
+	unsigned size;
+	return (typeval->type
+		&& (typeval->type->type == OFC_SEMA_TYPE_CHARACTER)
+		&& ofc_sema_type_size(typeval->type, &size)
+		&& (size <= sizeof(typeval->character_inline)));
+}
+
+static const char* ofc_sema_typeval__character(
+	const ofc_sema_typeval_t* typeval)
+{
+	return (ofc_sema_typeval__character_is_inline(typeval)
+		? typeval->character_inline : typeval->character);
+}
+
+/* The type must be set before allocating character storage. */
+static char* ofc_sema_typeval__character_alloc(
+	ofc_sema_typeval_t* typeval, unsigned size)
+{
+	if (ofc_sema_typeval__character_is_inline(typeval))
+		return typeval->character_inline;
+
+	typeval->character = (char*)ofc_alloc(OFC_ALLOC_TYPEVAL, sizeof(char) * size);
+	return typeval->character;
+}
+
+static void ofc_sema_typeval__character_free(
+	ofc_sema_typeval_t* typeval)
+{
+	if (typeval->type
+		&& (typeval->type->type == OFC_SEMA_TYPE_CHARACTER)
+		&& !ofc_sema_typeval__character_is_inline(typeval))
+		ofc_free(typeval->character);
+}
+
+/* The size of each number in a value, so both parts of a COMPLEX
+   have half the size of the whole. */
+static bool ofc_sema_typeval__part_size(
+	const ofc_sema_type_t* type, unsigned* size)
+{
+	unsigned s;
+	if (!ofc_sema_type_base_size(type, &s))
+		return false;
+
+	if (type->type == OFC_SEMA_TYPE_COMPLEX)
+		s /= 2;
+
+	if (size) *size = s;
+	return true;
+}
+
 static bool ofc_sema_typeval__in_range(
 	const ofc_sema_typeval_t* typeval)
 {
@@ -59,16 +180,12 @@ static bool ofc_sema_typeval__in_range(
 		typeval->type, &size))
 		return false;
 
-	if (size >= sizeof(typeval->integer))
-		return true;
-
-	int64_t imax = 1LL << ((size * 8) - 1);
-	int64_t imin = -imax;
-
-	return ((typeval->integer < imax)
-		&& (typeval->integer >= imin));
+	return ofc_sema_fold_integer_fits(
+		size, typeval->integer);
 }
 
+/* BOZ literals give the bit pattern of the value, so anything which fits
+   in the size is sign extended from its top bit. */
 static bool ofc_sema_typeval__clamp_range(
 	ofc_sema_typeval_t* typeval)
 {
@@ -88,19 +205,18 @@ static bool ofc_sema_typeval__clamp_range(
 		typeval->type, &size))
 		return false;
 
-	if (size >= sizeof(typeval->integer))
-		return true;
-
-	int64_t imax = 1LL << (size * 8);
-	int64_t imin = -(imax >> 1);
-
-	if ((typeval->integer >= imax)
-		|| (typeval->integer < imin))
-		return false;
+	uint64_t bits = (uint64_t)typeval->integer;
+	if (size < sizeof(bits))
+	{
+		unsigned width = (size * 8);
+		if ((bits >> width) != 0)
+			return false;
 
-	if (typeval->integer > (imax >> 1))
-		typeval->integer |= (0xFFFFFFFFFFFFFFFFULL << (64 - (size * 8)));
+		uint64_t sign = (UINT64_C(1) << (width - 1));
+		bits = ((bits ^ sign) - sign);
+	}
 
+	typeval->integer = (int64_t)bits;
 	return true;
 }
 
@@ -196,19 +312,20 @@ static ofc_sema_typeval_t* ofc_sema_typeval__integer_literal(
 
 	}
 
-	uint64_t smax = (1LL << ((sizeof(typeval.integer) * 8) - 1));
+	/* A BOZ literal is a bit pattern, so it may use the sign bit. */
+	uint64_t smax = (UINT64_C(1) << ((sizeof(typeval.integer) * 8) - 1));
 
 	if (negate)
 	{
 		if (uvalue > smax)
 			out_of_range = true;
-		typeval.integer = -uvalue;
+		typeval.integer = (int64_t)(0 - uvalue);
 	}
 	else
 	{
-		if (uvalue >= smax)
+		if (!mask_valid && (uvalue >= smax))
 			out_of_range = true;
-		typeval.integer = uvalue;
+		typeval.integer = (int64_t)uvalue;
 	}
 
 	if (out_of_range)
@@ -251,7 +368,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__integer_literal(
 			return NULL;
 		}
 
-		if (type->kind != kind)
+		if (type && (type->kind != kind))
 		{
 			ofc_sparse_ref_error(literal->src,
 				"Expected kind doesn't match literal kind");
@@ -289,7 +406,8 @@ static ofc_sema_typeval_t* ofc_sema_typeval__integer_literal(
 		}
 	}
 
-	if (!ofc_sema_typeval__in_range(&typeval))
+	bool sign_set = (mask_valid && !negate && (uvalue >= smax));
+	if (sign_set || !ofc_sema_typeval__in_range(&typeval))
 	{
 		if (mask_valid
 			&& ofc_sema_typeval__clamp_range(&typeval))
@@ -310,14 +428,14 @@ static ofc_sema_typeval_t* ofc_sema_typeval__integer_literal(
 
 	typeval.src = literal->src;
 
-	return ofc_sema_typeval__alloc(typeval);
+	return ofc_sema_typeval__alloc(&typeval);
 }
 
 
 static bool ofc_sema_typeval__real(
 	const ofc_parse_literal_t* literal,
 	ofc_str_ref_t number, unsigned  ikind,
-	long double*  value , unsigned* okind)
+	ofc_real_t*   value , unsigned* okind)
 {
 	if (!value)
 		return false;
@@ -329,36 +447,22 @@ static bool ofc_sema_typeval__real(
 		return false;
 
 	unsigned i = 0;
-	bool negate = (ptr[i] == '-');
-	if (negate || (ptr[i] == '+'))
+	if ((ptr[i] == '-') || (ptr[i] == '+'))
 		i += 1;
 
-	*value = 0.0;
-	for (; (i < size) && isdigit(ptr[i]); i++)
-	{
-		unsigned digit = (ptr[i] - '0');
-		*value *= 10.0;
-		*value += digit;
-	}
+	for (; (i < size) && isdigit(ptr[i]); i++);
 
 	if ((i < size) && (ptr[i] == '.'))
 	{
-		i++;
-
-		long double fdivisor = 1.0;
-		long double fvalue   = 0.0;
-		for (; (i < size) && isdigit(ptr[i]); i++, fdivisor *= 10.0)
-		{
-			unsigned digit = (ptr[i] - '0');
-			fvalue *= 10;
-			fvalue += digit;
-		}
-
-		*value += (fvalue / fdivisor);
+		for (i++; (i < size) && isdigit(ptr[i]); i++);
 	}
 
-	if (negate)
-		*value = -*value;
+	unsigned mantissa_end = i;
+
+	/* Fractional exponents are an extension, they're applied
+	   to the mantissa rather than read by the C library. */
+	bool        exp_frac = false;
+	long double e        = 0.0;
 
 	unsigned kind = 0;
 	if ((i < size) && isalpha(ptr[i]))
@@ -378,11 +482,10 @@ static bool ofc_sema_typeval__real(
 				return false;
 		}
 
-		negate = ((i < size) && (ptr[i] == '-'));
+		bool negate = ((i < size) && (ptr[i] == '-'));
 		if (negate || ((i < size) && (ptr[i] == '+')))
 			i += 1;
 
-		long double e = 0.0;
 		for (; (i < size) && isdigit(ptr[i]); i++)
 		{
 			unsigned digit = (ptr[i] - '0');
@@ -393,6 +496,7 @@ static bool ofc_sema_typeval__real(
 		if ((i < size) && (ptr[i] == '.'))
 		{
 			i++;
+			exp_frac = true;
 
 			long double f;
 			for (f = 0.1; (i < size) && isdigit(ptr[i]); i++, f /= 10.0)
@@ -404,10 +508,10 @@ static bool ofc_sema_typeval__real(
 
 		if (negate)
 			e = -e;
-
-		*value *= powl(10.0, e);
 	}
 
+	unsigned number_end = i;
+
 	if ((i < size) && (ptr[i] == '_'))
 	{
 		i++;
@@ -476,6 +580,20 @@ static bool ofc_sema_typeval__real(
 		return false;
 	}
 
+	if (exp_frac)
+	{
+		if (!ofc_sema_fold_real_parse(
+			ksize, ptr, mantissa_end, value))
+			return false;
+		*value = ofc_sema_fold_real_round(ksize,
+			(ofc_real_t)((long double)*value * powl(10.0, e)));
+	}
+	else if (!ofc_sema_fold_real_parse(
+		ksize, ptr, number_end, value))
+	{
+		return false;
+	}
+
 	if (okind) *okind = kind;
 	return true;
 }
@@ -519,7 +637,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__real_literal(
 
 	typeval.src = literal->src;
 
-	return ofc_sema_typeval__alloc(typeval);
+	return ofc_sema_typeval__alloc(&typeval);
 }
 
 static ofc_sema_typeval_t* ofc_sema_typeval__complex_literal(
@@ -574,7 +692,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__complex_literal(
 
 	typeval.src = literal->src;
 
-	return ofc_sema_typeval__alloc(typeval);
+	return ofc_sema_typeval__alloc(&typeval);
 }
 
 static ofc_sema_typeval_t* ofc_sema_typeval__character_literal(
@@ -654,20 +772,17 @@ static ofc_sema_typeval_t* ofc_sema_typeval__character_literal(
 
 		typeval.integer = literal->string->base[0];
 	}
-	else if (size == 0)
-	{
-		typeval.character = NULL;
-	}
 	else
 	{
-		typeval.character = (char*)malloc(sizeof(char) * size);
-		if (!typeval.character)
+		char* character
+			= ofc_sema_typeval__character_alloc(&typeval, size);
+		if (!character)
 			return NULL;
 
 		if (literal->string->size > size)
 		{
 			memcpy(
-				typeval.character,
+				character,
 				literal->string->base, size);
 			ofc_sparse_ref_warning(literal->src,
 				"String truncated");
@@ -675,7 +790,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__character_literal(
 		else
 		{
 			memcpy(
-				typeval.character,
+				character,
 				literal->string->base,
 				literal->string->size);
 
@@ -683,7 +798,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__character_literal(
 			{
 				unsigned offset = literal->string->size;
 				unsigned ssize = (size - offset);
-				memset(&typeval.character[offset], ' ', ssize);
+				memset(&character[offset], ' ', ssize);
 
 				ofc_sparse_ref_warning(literal->src,
 					"String padded");
@@ -694,8 +809,9 @@ static ofc_sema_typeval_t* ofc_sema_typeval__character_literal(
 	typeval.src = literal->src;
 
 	ofc_sema_typeval_t* atv
-		= ofc_sema_typeval__alloc(typeval);
-	if (!atv && !is_byte) free(typeval.character);
+		= ofc_sema_typeval__alloc(&typeval);
+	if (!atv && !is_byte)
+		ofc_sema_typeval__character_free(&typeval);
 	return atv;
 }
 
@@ -746,7 +862,7 @@ static ofc_sema_typeval_t* ofc_sema_typeval__logical_literal(
 
 	typeval.src = literal->src;
 
-	return ofc_sema_typeval__alloc(typeval);
+	return ofc_sema_typeval__alloc(&typeval);
 }
 
 static ofc_sema_typeval_t* ofc_sema_typeval__byte_literal(
@@ -795,8 +911,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_unsigned(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
-			sizeof(ofc_sema_typeval_t));
+		= ofc_sema_typeval__pool_get();
 	if (!typeval) return NULL;
 
 	typeval->type = type;
@@ -816,8 +931,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_integer(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
-			sizeof(ofc_sema_typeval_t));
+		= ofc_sema_typeval__pool_get();
 	if (!typeval) return NULL;
 
 	typeval->type = type;
@@ -837,8 +951,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_real(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
-			sizeof(ofc_sema_typeval_t));
+		= ofc_sema_typeval__pool_get();
 	if (!typeval) return NULL;
 
 	typeval->type = type;
@@ -899,11 +1012,8 @@ void ofc_sema_typeval_delete(
 	if (!typeval)
 		return;
 
-	if (typeval->type
-		&& (typeval->type->type == OFC_SEMA_TYPE_CHARACTER))
-		free(typeval->character);
-
-	free(typeval);
+	ofc_sema_typeval__character_free(typeval);
+	ofc_sema_typeval__pool_put(typeval);
 }
 
 
@@ -940,8 +1050,10 @@ bool ofc_sema_typeval_compare(
 				if (!ofc_sema_type_size(
 					a->type, &size))
 					return false;
-				return (memcmp(a->character,
-					b->character, size) == 0);
+				return (memcmp(
+					ofc_sema_typeval__character(a),
+					ofc_sema_typeval__character(b),
+					size) == 0);
 			}
 		default:
 			break;
@@ -994,23 +1106,20 @@ ofc_sema_typeval_t* ofc_sema_typeval_copy(
 		return NULL;
 
 	ofc_sema_typeval_t* copy
-		= (ofc_sema_typeval_t*)malloc(
-			sizeof(ofc_sema_typeval_t));
+		= ofc_sema_typeval__alloc(typeval);
 	if (!copy) return NULL;
 
-	memcpy(copy, typeval,
-		sizeof(ofc_sema_typeval_t));
-
-	if (copy->type->type == OFC_SEMA_TYPE_CHARACTER)
+	if ((copy->type->type == OFC_SEMA_TYPE_CHARACTER)
+		&& !ofc_sema_typeval__character_is_inline(copy))
 	{
 		unsigned size = ofc_sema_typeval_size(typeval);
 		copy->character = NULL;
 		if (size > 0)
 		{
-			copy->character = malloc(size);
+			copy->character = ofc_alloc(OFC_ALLOC_TYPEVAL, size);
 			if (!copy->character)
 			{
-				free(copy);
+				ofc_sema_typeval__pool_put(copy);
 				return NULL;
 			}
 
@@ -1077,8 +1186,9 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 			"Casting CHARACTER to INTEGER");
 
 		tv.integer = 0;
-		memcpy(&tv.integer, typeval->character, csize);
-		return ofc_sema_typeval__alloc(tv);
+		memcpy(&tv.integer,
+			ofc_sema_typeval__character(typeval), csize);
+		return ofc_sema_typeval__alloc(&tv);
 	}
 
 	if ((type->type == OFC_SEMA_TYPE_CHARACTER)
@@ -1098,6 +1208,9 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 		unsigned len_tval = typeval->type->len;
 		unsigned len_type = type->len;
 
+		const char* tval_character
+			= ofc_sema_typeval__character(typeval);
+
 		if (tsize > csize)
 		{
 			ofc_sparse_ref_error(typeval->src,
@@ -1106,16 +1219,18 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 		}
 		else if (tsize < csize)
 		{
-			tv.character = (char*)malloc(len_type * csize);
+			char* character = ofc_sema_typeval__character_alloc(
+				&tv, (len_type * csize));
+			if (!character) return NULL;
 
 			unsigned wchar;
 			for (wchar = 0; wchar < len_type; wchar += csize)
 			{
-				memcpy(&tv.character[wchar], typeval->character, tsize);
+				memcpy(&character[wchar], tval_character, tsize);
 
 				unsigned wchar_pad;
 				for (wchar_pad = 1; wchar_pad < csize; wchar_pad++)
-					tv.character[wchar + wchar_pad] = '\0';
+					character[wchar + wchar_pad] = '\0';
 			}
 
 			if (len_tval < len_type)
@@ -1124,42 +1239,47 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 				for (pad_char = len_tval; pad_char < len_type;
 					pad_char += csize)
 				{
-					tv.character[pad_char] = ' ';
+					character[pad_char] = ' ';
 					for(pad_byte = 1; pad_byte < csize; pad_byte++)
 					{
-						tv.character[pad_char + pad_byte] = '\0';
+						character[pad_char + pad_byte] = '\0';
 					}
 				}
 			}
 		}
 		else
 		{
-			tv.character = (char*)malloc(len_type * csize);
+			char* character = ofc_sema_typeval__character_alloc(
+				&tv, (len_type * csize));
+			if (!character) return NULL;
 
 			if (len_tval < len_type)
 			{
-				memcpy(tv.character, typeval->character,
+				memcpy(character, tval_character,
 					(len_tval * csize));
 
 				unsigned pad_char, pad_byte;
 				for (pad_char = (len_tval * csize); pad_char < (len_type * csize);
 					pad_char += csize)
 				{
-					tv.character[pad_char] = ' ';
+					character[pad_char] = ' ';
 					for(pad_byte = 1; pad_byte < csize; pad_byte++)
 					{
-						tv.character[pad_char + pad_byte] = '\0';
+						character[pad_char + pad_byte] = '\0';
 					}
 				}
 			}
 			else
 			{
-				memcpy(tv.character, typeval->character,
+				memcpy(character, tval_character,
 					(len_type * csize));
 			}
 		}
 
-		return ofc_sema_typeval__alloc(tv);
+		ofc_sema_typeval_t* ctv
+			= ofc_sema_typeval__alloc(&tv);
+		if (!ctv) ofc_sema_typeval__character_free(&tv);
+		return ctv;
 	}
 
 	bool invalid_cast = false;
@@ -1172,11 +1292,17 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 		case OFC_SEMA_TYPE_BYTE:
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
-			large_literal = (csize > 8);
+			/* An integer was range checked against its own kind,
+			   so it's held exactly by any larger one. */
+			large_literal = ((csize > sizeof(tv.integer))
+				&& !ofc_sema_type_is_integer(typeval->type)
+				&& !ofc_sema_type_is_logical(typeval->type));
 			break;
 		case OFC_SEMA_TYPE_REAL:
+			large_literal = (csize > sizeof(tv.real));
+			break;
 		case OFC_SEMA_TYPE_COMPLEX:
-			large_literal = (csize > 10);
+			large_literal = (csize > sizeof(tv.complex));
 			break;
 		default:
 			invalid_cast = true;
@@ -1190,14 +1316,19 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 		return NULL;
 	}
 
-	if (type->type == typeval->type->type)
-		return ofc_sema_typeval_copy(typeval);
+	/* Both parts of a COMPLEX have half of its size. */
+	unsigned psize = csize;
+	if (type->type == OFC_SEMA_TYPE_COMPLEX)
+		psize /= 2;
 
 	switch (type->type)
 	{
 		case OFC_SEMA_TYPE_LOGICAL:
 			switch (typeval->type->type)
 			{
+				case OFC_SEMA_TYPE_LOGICAL:
+					tv.logical = typeval->logical;
+					break;
 				case OFC_SEMA_TYPE_INTEGER:
 				case OFC_SEMA_TYPE_BYTE:
 					tv.logical = (typeval->integer != 0);
@@ -1209,22 +1340,32 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 			break;
 
 		case OFC_SEMA_TYPE_INTEGER:
+		case OFC_SEMA_TYPE_BYTE:
 			switch (typeval->type->type)
 			{
 				case OFC_SEMA_TYPE_LOGICAL:
 					tv.integer = (typeval->logical ? 1 : 0);
 					break;
 				case OFC_SEMA_TYPE_REAL:
-					tv.integer = (int64_t)typeval->real;
-					if ((long double)tv.integer != typeval->real)
-						lossy_cast = true;
-					break;
 				case OFC_SEMA_TYPE_COMPLEX:
-					tv.integer = (int64_t)typeval->complex.real;
-					if (((long double)tv.integer != typeval->complex.real)
-						|| (typeval->complex.imaginary != 0.0))
-						lossy_cast = true;
+					{
+						ofc_real_t real = (typeval->type->type == OFC_SEMA_TYPE_REAL
+							? typeval->real : typeval->complex.real);
+						if (!ofc_sema_fold_integer_from_real(
+							sizeof(tv.integer), real, &tv.integer))
+						{
+							lossy_cast = true;
+							tv.integer = (real < 0 ? INT64_MIN : INT64_MAX);
+						}
+						else if (((ofc_real_t)tv.integer != real)
+							|| ((typeval->type->type == OFC_SEMA_TYPE_COMPLEX)
+								&& (typeval->complex.imaginary != 0.0)))
+						{
+							lossy_cast = true;
+						}
+					}
 					break;
+				case OFC_SEMA_TYPE_INTEGER:
 				case OFC_SEMA_TYPE_BYTE:
 					tv.integer = typeval->integer;
 					break;
@@ -1233,21 +1374,15 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 					break;
 			}
 
-			if (csize < 8)
+			/* Values which don't fit keep their low bits. */
+			if (!invalid_cast && (csize < sizeof(tv.integer))
+				&& !ofc_sema_fold_integer_fits(csize, tv.integer))
 			{
-				int64_t imax = 1LL << ((csize * 8) - 1);
-				if ((tv.integer < -imax)
-					|| (tv.integer >= imax))
-				{
-					lossy_cast = true;
-
-					int64_t sign_mask = -1LL;
-					sign_mask ^= (imax - 1);
+				lossy_cast = true;
 
-					tv.integer = (tv.integer < 0
-						? (tv.integer | sign_mask)
-						: (tv.integer & (imax - 1)));
-				}
+				uint64_t sign = (UINT64_C(1) << ((csize * 8) - 1));
+				uint64_t bits = ((uint64_t)tv.integer & ((sign << 1) - 1));
+				tv.integer = (int64_t)((bits ^ sign) - sign);
 			}
 			break;
 
@@ -1256,7 +1391,10 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 			{
 				case OFC_SEMA_TYPE_INTEGER:
 				case OFC_SEMA_TYPE_BYTE:
-					tv.real = (long double)typeval->integer;
+					tv.real = (ofc_real_t)typeval->integer;
+					break;
+				case OFC_SEMA_TYPE_REAL:
+					tv.real = typeval->real;
 					break;
 				case OFC_SEMA_TYPE_COMPLEX:
 					tv.real = typeval->complex.real;
@@ -1267,58 +1405,32 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 					invalid_cast = true;
 					break;
 			}
+			tv.real = ofc_sema_fold_real_round(psize, tv.real);
 			break;
 
 		case OFC_SEMA_TYPE_COMPLEX:
+			tv.complex.imaginary = 0.0;
 			switch (typeval->type->type)
 			{
 				case OFC_SEMA_TYPE_INTEGER:
 				case OFC_SEMA_TYPE_BYTE:
-					tv.complex.real = (long double)typeval->integer;
+					tv.complex.real = (ofc_real_t)typeval->integer;
 					break;
 				case OFC_SEMA_TYPE_REAL:
 					tv.complex.real = typeval->real;
 					break;
-				default:
-					invalid_cast = true;
-					break;
-			}
-			tv.complex.imaginary = 0.0;
-			break;
-
-		case OFC_SEMA_TYPE_BYTE:
-			switch (typeval->type->type)
-			{
-				case OFC_SEMA_TYPE_LOGICAL:
-					tv.integer = (typeval->logical ? 1 : 0);
-					break;
-				case OFC_SEMA_TYPE_REAL:
-					tv.integer = (int64_t)typeval->real;
-					if ((long double)tv.integer != typeval->real)
-						lossy_cast = true;
-					break;
 				case OFC_SEMA_TYPE_COMPLEX:
-					tv.integer = (int64_t)typeval->complex.real;
-					if (((long double)tv.integer != typeval->complex.real)
-						|| (typeval->complex.imaginary != 0.0))
-						lossy_cast = true;
-					break;
-				case OFC_SEMA_TYPE_INTEGER:
-				case OFC_SEMA_TYPE_BYTE:
-					tv.integer = typeval->integer;
+					tv.complex.real = typeval->complex.real;
+					tv.complex.imaginary = typeval->complex.imaginary;
 					break;
 				default:
 					invalid_cast = true;
 					break;
 			}
-			if ((tv.integer < -128)
-				|| (tv.integer >= 128))
-			{
-				lossy_cast = true;
-				tv.integer = (tv.integer < 0
-					? (tv.integer | 0xFFFFFFFFFFFFFF00LL)
-					: (tv.integer & 0xFF));
-			}
+			tv.complex.real = ofc_sema_fold_real_round(
+				psize, tv.complex.real);
+			tv.complex.imaginary = ofc_sema_fold_real_round(
+				psize, tv.complex.imaginary);
 			break;
 
 		default:
@@ -1343,7 +1455,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_cast(
 			ofc_sema_type_str_rep(type));
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 
@@ -1443,7 +1555,7 @@ bool ofc_sema_typeval_get_complex(
 	if (real)
 		*real = typeval->complex.real;
 	if (imaginary)
-		*real = typeval->complex.imaginary;
+		*imaginary = typeval->complex.imaginary;
 	return true;
 }
 
@@ -1469,7 +1581,7 @@ bool ofc_sema_typeval_get_character(
 		return false;
 
 	if (character)
-		*character = typeval->character;
+		*character = ofc_sema_typeval__character(typeval);
 	return true;
 }
 
@@ -1494,9 +1606,11 @@ static bool ofc_typeval_character_equal__strz(
 	if (tlen != slen)
 		return false;
 
+	const char* character
+		= ofc_sema_typeval__character(tv);
 	return ((case_sensitive
-		? strncmp(tv->character, strz, slen)
-		: strncasecmp(tv->character, strz, slen)) == 0);
+		? strncmp(character, strz, slen)
+		: strncasecmp(character, strz, slen)) == 0);
 }
 
 bool ofc_typeval_character_equal_strz(
@@ -1513,6 +1627,52 @@ bool ofc_typeval_character_equal_strz_ci(
 
 
 
+/* Integer overflow is an error rather than a value we can't fold,
+   since the program would compute the wrong value at runtime. */
+static void ofc_sema_typeval__overflow(
+	const ofc_sema_typeval_t* tv, const char* op)
+{
+	ofc_sparse_ref_error(tv->src,
+		"Overflow in constant %s", op);
+}
+
+/* Fortran has no constants for infinity or NaN, so a REAL or COMPLEX
+   result which isn't finite has overflowed its kind. */
+static bool ofc_sema_typeval__finite(
+	const ofc_sema_typeval_t* tv)
+{
+	switch (tv->type->type)
+	{
+		case OFC_SEMA_TYPE_REAL:
+			return isfinite(tv->real);
+		case OFC_SEMA_TYPE_COMPLEX:
+			return (isfinite(tv->complex.real)
+				&& isfinite(tv->complex.imaginary));
+		default:
+			break;
+	}
+	return true;
+}
+
+static bool ofc_sema_typeval__is_zero(
+	const ofc_sema_typeval_t* tv)
+{
+	switch (tv->type->type)
+	{
+		case OFC_SEMA_TYPE_INTEGER:
+		case OFC_SEMA_TYPE_BYTE:
+			return (tv->integer == 0);
+		case OFC_SEMA_TYPE_REAL:
+			return (tv->real == 0);
+		case OFC_SEMA_TYPE_COMPLEX:
+			return ((tv->complex.real == 0)
+				&& (tv->complex.imaginary == 0));
+		default:
+			break;
+	}
+	return false;
+}
+
 ofc_sema_typeval_t* ofc_sema_typeval_power(
 	const ofc_sema_typeval_t* a,
 	const ofc_sema_typeval_t* b)
@@ -1530,47 +1690,66 @@ ofc_sema_typeval_t* ofc_sema_typeval_power(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
-			tv.real = powl(a->real, b->real);
+			tv.real = ofc_sema_fold_real_power(
+				size, a->real, b->real);
 			break;
 		case OFC_SEMA_TYPE_COMPLEX:
 			{
-				long double abs = hypotl(a->complex.real, a->complex.imaginary);
+				long double ar = a->complex.real;
+				long double ai = a->complex.imaginary;
+				long double br = b->complex.real;
+				long double bi = b->complex.imaginary;
+
+				long double abs = hypotl(ar, ai);
 				if (abs == 0.0)
 				{
 					tv.complex.real      = 0.0;
 					tv.complex.imaginary = 0.0;
 					break;
 				}
-				long double arg = atan2l(a->complex.imaginary, a->complex.real);
-				long double radio = powl(abs, b->complex.real);
-				long double ang = arg * b->complex.real;
-				if (b->complex.imaginary)
+				long double arg = atan2l(ai, ar);
+				long double radio = powl(abs, br);
+				long double ang = arg * br;
+				if (bi)
 				{
-					radio = radio * exp(-b->complex.imaginary * arg);
-					ang = ang + (b->complex.imaginary * log(abs));
+					radio = radio * exp(-bi * arg);
+					ang = ang + (bi * log(abs));
 				}
-				tv.complex.real = radio * cos(ang);
-				tv.complex.imaginary = radio * sin(ang);
+				tv.complex.real = ofc_sema_fold_real_round(
+					size, radio * cos(ang));
+				tv.complex.imaginary = ofc_sema_fold_real_round(
+					size, radio * sin(ang));
 			}
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
+			if (!ofc_sema_fold_integer_power(size,
+				a->integer, b->integer, &tv.integer))
 			{
-				long double r = powl(
-					a->integer, b->integer);
-				tv.integer = (int64_t)r;
-				if ((long double)tv.integer != r)
-					return NULL;
+				/* Zero to a negative power is left to runtime. */
+				if (a->integer != 0)
+					ofc_sema_typeval__overflow(&tv, "power");
+				return NULL;
 			}
 			break;
 		default:
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	if (!ofc_sema_typeval__finite(&tv))
+	{
+		ofc_sema_typeval__overflow(&tv, "power");
+		return NULL;
+	}
+
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_multiply(
@@ -1590,29 +1769,48 @@ ofc_sema_typeval_t* ofc_sema_typeval_multiply(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
-			tv.real = a->real * b->real;
+			tv.real = ofc_sema_fold_real_multiply(
+				size, a->real, b->real);
 			break;
 		case OFC_SEMA_TYPE_COMPLEX:
-			tv.complex.real = (a->complex.real * b->complex.real)
-				- (a->complex.imaginary * b->complex.imaginary);
-			tv.complex.imaginary = (a->complex.real * b->complex.imaginary)
-				+ (b->complex.real * a->complex.imaginary);
+			tv.complex.real = ofc_sema_fold_real_subtract(size,
+				ofc_sema_fold_real_multiply(size,
+					a->complex.real, b->complex.real),
+				ofc_sema_fold_real_multiply(size,
+					a->complex.imaginary, b->complex.imaginary));
+			tv.complex.imaginary = ofc_sema_fold_real_add(size,
+				ofc_sema_fold_real_multiply(size,
+					a->complex.real, b->complex.imaginary),
+				ofc_sema_fold_real_multiply(size,
+					b->complex.real, a->complex.imaginary));
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
-			tv.integer = a->integer * b->integer;
-			if ((b->integer != 0)
-				&& ((tv.integer / b->integer) != a->integer))
+			if (!ofc_sema_fold_integer_multiply(size,
+				a->integer, b->integer, &tv.integer))
+			{
+				ofc_sema_typeval__overflow(&tv, "multiply");
 				return NULL;
+			}
 			break;
 		default:
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	if (!ofc_sema_typeval__finite(&tv))
+	{
+		ofc_sema_typeval__overflow(&tv, "multiply");
+		return NULL;
+	}
+
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_concat(
@@ -1652,15 +1850,16 @@ ofc_sema_typeval_t* ofc_sema_typeval_concat(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
-	tv.character = (char*)malloc(sizeof(char) * len);
-	if (!tv.character) return NULL;
+	char* character
+		= ofc_sema_typeval__character_alloc(&tv, len);
+	if (!character) return NULL;
 
-	memcpy(tv.character, a->character, len_a);
-	memcpy(&tv.character[len_a], b->character, len_b);
+	memcpy(character, ofc_sema_typeval__character(a), len_a);
+	memcpy(&character[len_a], ofc_sema_typeval__character(b), len_b);
 
 	ofc_sema_typeval_t* ret
-		= ofc_sema_typeval__alloc(tv);
-	if (!ret) free(tv.character);
+		= ofc_sema_typeval__alloc(&tv);
+	if (!ret) ofc_sema_typeval__character_free(&tv);
 	return ret;
 }
 
@@ -1681,38 +1880,66 @@ ofc_sema_typeval_t* ofc_sema_typeval_divide(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
+	if (ofc_sema_typeval__is_zero(b))
+	{
+		ofc_sparse_ref_error(a->src,
+			"Divide by zero");
+		return NULL;
+	}
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
-			tv.real = a->real / b->real;
+			tv.real = ofc_sema_fold_real_divide(
+				size, a->real, b->real);
 			break;
 		case OFC_SEMA_TYPE_COMPLEX:
 			{
-				long double div = powl(b->complex.real, 2.0)
-					+ powl(b->complex.imaginary, 2.0);
-				tv.complex.real
-					= ((a->complex.real * b->complex.real)
-						+ (a->complex.imaginary * b->complex.imaginary)) / div;
-				tv.complex.imaginary
-					= ((a->complex.imaginary * b->complex.real)
-						- (a->complex.real * b->complex.imaginary)) / div;
+				ofc_real_t div = ofc_sema_fold_real_add(size,
+					ofc_sema_fold_real_multiply(size,
+						b->complex.real, b->complex.real),
+					ofc_sema_fold_real_multiply(size,
+						b->complex.imaginary, b->complex.imaginary));
+				tv.complex.real = ofc_sema_fold_real_divide(size,
+					ofc_sema_fold_real_add(size,
+						ofc_sema_fold_real_multiply(size,
+							a->complex.real, b->complex.real),
+						ofc_sema_fold_real_multiply(size,
+							a->complex.imaginary, b->complex.imaginary)),
+					div);
+				tv.complex.imaginary = ofc_sema_fold_real_divide(size,
+					ofc_sema_fold_real_subtract(size,
+						ofc_sema_fold_real_multiply(size,
+							a->complex.imaginary, b->complex.real),
+						ofc_sema_fold_real_multiply(size,
+							a->complex.real, b->complex.imaginary)),
+					div);
 			}
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
-			if (b->integer == 0)
+			if (!ofc_sema_fold_integer_divide(size,
+				a->integer, b->integer, &tv.integer))
 			{
-				ofc_sparse_ref_error(a->src,
-					"Divide by zero");
+				ofc_sema_typeval__overflow(&tv, "divide");
 				return NULL;
 			}
-			tv.integer = a->integer / b->integer;
 			break;
 		default:
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	if (!ofc_sema_typeval__finite(&tv))
+	{
+		ofc_sema_typeval__overflow(&tv, "divide");
+		return NULL;
+	}
+
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_add(
@@ -1732,26 +1959,42 @@ ofc_sema_typeval_t* ofc_sema_typeval_add(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
-			tv.real = a->real + b->real;
+			tv.real = ofc_sema_fold_real_add(
+				size, a->real, b->real);
 			break;
 		case OFC_SEMA_TYPE_COMPLEX:
-			tv.complex.real = a->complex.real + b->complex.real;
-			tv.complex.imaginary
-				= a->complex.imaginary + b->complex.imaginary;
-				break;
+			tv.complex.real = ofc_sema_fold_real_add(
+				size, a->complex.real, b->complex.real);
+			tv.complex.imaginary = ofc_sema_fold_real_add(
+				size, a->complex.imaginary, b->complex.imaginary);
+			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
-			/* TODO - Detect overflow. */
-			tv.integer = a->integer + b->integer;
+			if (!ofc_sema_fold_integer_add(size,
+				a->integer, b->integer, &tv.integer))
+			{
+				ofc_sema_typeval__overflow(&tv, "add");
+				return NULL;
+			}
 			break;
 		default:
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	if (!ofc_sema_typeval__finite(&tv))
+	{
+		ofc_sema_typeval__overflow(&tv, "add");
+		return NULL;
+	}
+
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_subtract(
@@ -1771,26 +2014,42 @@ ofc_sema_typeval_t* ofc_sema_typeval_subtract(
 	ofc_sparse_ref_bridge(
 		a->src, b->src, &tv.src);
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
-			tv.real = a->real - b->real;
+			tv.real = ofc_sema_fold_real_subtract(
+				size, a->real, b->real);
 			break;
 		case OFC_SEMA_TYPE_COMPLEX:
-			tv.complex.real = a->complex.real - b->complex.real;
-			tv.complex.imaginary
-				= a->complex.imaginary - b->complex.imaginary;
+			tv.complex.real = ofc_sema_fold_real_subtract(
+				size, a->complex.real, b->complex.real);
+			tv.complex.imaginary = ofc_sema_fold_real_subtract(
+				size, a->complex.imaginary, b->complex.imaginary);
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
-			/* TODO - Detect overflow. */
-			tv.integer = a->integer - b->integer;
+			if (!ofc_sema_fold_integer_subtract(size,
+				a->integer, b->integer, &tv.integer))
+			{
+				ofc_sema_typeval__overflow(&tv, "subtract");
+				return NULL;
+			}
 			break;
 		default:
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	if (!ofc_sema_typeval__finite(&tv))
+	{
+		ofc_sema_typeval__overflow(&tv, "subtract");
+		return NULL;
+	}
+
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_negate(
@@ -1803,6 +2062,10 @@ ofc_sema_typeval_t* ofc_sema_typeval_negate(
 	tv.type = a->type;
 	tv.src  = a->src;
 
+	unsigned size;
+	if (!ofc_sema_typeval__part_size(a->type, &size))
+		return NULL;
+
 	switch (a->type->type)
 	{
 		case OFC_SEMA_TYPE_REAL:
@@ -1814,11 +2077,10 @@ ofc_sema_typeval_t* ofc_sema_typeval_negate(
 			break;
 		case OFC_SEMA_TYPE_INTEGER:
 		case OFC_SEMA_TYPE_BYTE:
-			tv.integer = -a->integer;
-			if (-tv.integer != a->integer)
+			if (!ofc_sema_fold_integer_negate(
+				size, a->integer, &tv.integer))
 			{
-				ofc_sparse_ref_error(a->src,
-					"Overflow in constant negate");
+				ofc_sema_typeval__overflow(&tv, "negate");
 				return NULL;
 			}
 			break;
@@ -1826,7 +2088,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_negate(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_eq(
@@ -1862,7 +2124,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_eq(
 			|| (asize != bsize))
 			return NULL;
 
-		tv.logical = (memcmp(a->character, b->character,
+		tv.logical = (memcmp(ofc_sema_typeval__character(a),
+			ofc_sema_typeval__character(b),
 			(a->type->len * asize)) == 0);
 	}
 	else
@@ -1885,7 +2148,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_eq(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_ne(
@@ -1921,7 +2184,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_ne(
 			|| (asize != bsize))
 			return NULL;
 
-		tv.logical = (memcmp(a->character, b->character,
+		tv.logical = (memcmp(ofc_sema_typeval__character(a),
+			ofc_sema_typeval__character(b),
 			(a->type->len * asize)) != 0);
 	}
 	else
@@ -1944,7 +2208,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_ne(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_lt(
@@ -1989,8 +2253,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_lt(
 		for (i = 0, j = 0; i < a->type->len; i++, j += asize)
 		{
 			uint64_t ac = 0, bc = 0;
-			memcpy(&ac, &a->character[j], asize);
-			memcpy(&bc, &b->character[j], asize);
+			memcpy(&ac, &ofc_sema_typeval__character(a)[j], asize);
+			memcpy(&bc, &ofc_sema_typeval__character(b)[j], asize);
 
 			if (ac == bc)
 				continue;
@@ -2015,7 +2279,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_lt(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_le(
@@ -2060,8 +2324,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_le(
 		for (i = 0, j = 0; i < a->type->len; i++, j += asize)
 		{
 			uint64_t ac = 0, bc = 0;
-			memcpy(&ac, &a->character[j], asize);
-			memcpy(&bc, &b->character[j], asize);
+			memcpy(&ac, &ofc_sema_typeval__character(a)[j], asize);
+			memcpy(&bc, &ofc_sema_typeval__character(b)[j], asize);
 
 			if (ac == bc)
 				continue;
@@ -2086,7 +2350,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_le(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_gt(
@@ -2131,8 +2395,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_gt(
 		for (i = 0, j = 0; i < a->type->len; i++, j += asize)
 		{
 			uint64_t ac = 0, bc = 0;
-			memcpy(&ac, &a->character[j], asize);
-			memcpy(&bc, &b->character[j], asize);
+			memcpy(&ac, &ofc_sema_typeval__character(a)[j], asize);
+			memcpy(&bc, &ofc_sema_typeval__character(b)[j], asize);
 
 			if (ac == bc)
 				continue;
@@ -2157,7 +2421,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_gt(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_ge(
@@ -2202,8 +2466,8 @@ ofc_sema_typeval_t* ofc_sema_typeval_ge(
 		for (i = 0, j = 0; i < a->type->len; i++, j += asize)
 		{
 			uint64_t ac = 0, bc = 0;
-			memcpy(&ac, &a->character[j], asize);
-			memcpy(&bc, &b->character[j], asize);
+			memcpy(&ac, &ofc_sema_typeval__character(a)[j], asize);
+			memcpy(&bc, &ofc_sema_typeval__character(b)[j], asize);
 
 			if (ac == bc)
 				continue;
@@ -2228,7 +2492,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_ge(
 		}
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_not(
@@ -2253,7 +2517,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_not(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_and(
@@ -2286,7 +2550,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_and(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_or(
@@ -2319,7 +2583,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_or(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_eqv(
@@ -2352,7 +2616,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_eqv(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 ofc_sema_typeval_t* ofc_sema_typeval_neqv(
@@ -2385,12 +2649,64 @@ ofc_sema_typeval_t* ofc_sema_typeval_neqv(
 			return NULL;
 	}
 
-	return ofc_sema_typeval__alloc(tv);
+	return ofc_sema_typeval__alloc(&tv);
 }
 
 
 #include <float.h>
 
+/* A number and its kind suffix. */
+#define OFC_SEMA_TYPEVAL__PRINT_MAX (OFC_NUMFMT_MAX + 16)
+
+/* Kinds without an exponent letter and INTEGER kinds other than the
+   default are suffixed like types are printed, absolute kinds by their
+   size in bytes and others by their kind. Returns the suffix length. */
+static unsigned ofc_sema_typeval__kind_suffix(
+	char* buff, unsigned kind, unsigned size, unsigned def)
+{
+	if ((kind == 1) || (size == def))
+		return 0;
+	return sprintf(buff, "_%u", (ofc_sema_type_kind_absolute(kind)
+		? size : kind));
+}
+
+/* Reals are printed with the fewest digits that read back as the
+   same value of their kind, each part of a complex is a real.
+   Returns zero when the type has no size. */
+static unsigned ofc_sema_typeval__format_real(
+	char* buff, const ofc_sema_type_t* type,
+	ofc_real_t value)
+{
+	unsigned size;
+	if (!ofc_sema_type_size(type, &size))
+		return 0;
+	if (type->type == OFC_SEMA_TYPE_COMPLEX)
+		size /= 2;
+
+	unsigned def = ofc_target_real_size_get();
+
+	char exp = 'E';
+	if (size == (def * 2))
+		exp = 'D';
+	else if (size == (def * 4))
+		exp = 'Q';
+
+	unsigned dig = OFC_REAL_DIG;
+	if (size < 4)
+		dig = FLT_DIG;
+	else if (size < 8)
+		dig = DBL_DIG;
+	else if (size < sizeof(ofc_real_t))
+		dig = LDBL_DIG;
+
+	unsigned len = ofc_numfmt_real(
+		buff, value, size, dig, exp);
+	if (exp == 'E')
+		len += ofc_sema_typeval__kind_suffix(
+			&buff[len], type->kind, size, def);
+	return len;
+}
+
 bool ofc_sema_typeval_print(ofc_colstr_t*cs,
 	const ofc_sema_typeval_t* typeval)
 {
@@ -2407,95 +2723,55 @@ bool ofc_sema_typeval_print(ofc_colstr_t*cs,
 
 		case OFC_SEMA_TYPE_BYTE:
 		case OFC_SEMA_TYPE_INTEGER:
-			return ofc_colstr_atomic_writef(cs, "%d",
-				typeval->integer);
-
-		case OFC_SEMA_TYPE_REAL:
 			{
-				unsigned dig = LDBL_DIG;
-				unsigned size;
-				if (ofc_sema_type_size(
-					typeval->type, &size))
-				{
-					if (size < 4)
-						dig = FLT_DIG;
-					else if (size < 8)
-						dig = DBL_DIG;
-				}
+				char buff[OFC_SEMA_TYPEVAL__PRINT_MAX];
+				unsigned len = ofc_numfmt_integer(
+					buff, typeval->integer);
 
-				char fmt[32];
-				sprintf(fmt, "%%.%uLG", dig);
-
-				char buff[64];
-				sprintf(buff, fmt, typeval->real);
-
-				unsigned i;
-				for (i = 0; buff[i] != '\0'; i++)
-				{
-					if ((buff[i] == '.')
-						|| (toupper(buff[i]) == 'E'))
-						break;
-				}
-				if (buff[i] == '\0')
-					strcat(buff, ".0");
-
-				char* kind_postfix = NULL;
-				char kind_exp = '\0';
-				switch (typeval->type->kind)
-				{
-					case 1:
-						break;
-					case 2:
-						kind_exp = 'D';
-						break;
-					case 4:
-						kind_exp = 'Q';
-						break;
-					default:
-						/* TODO - Support other kinds. */
-						return false;
-				}
-
-				if (kind_exp)
-				{
-					for (i = 0; buff[i] != '\0'; i++)
-					{
-						if (toupper(buff[i]) == 'E')
-						{
-							buff[i] = kind_exp;
-							break;
-						}
-					}
-					if (buff[i] == '\0')
-					{
-						buff[i] = kind_exp;
-						buff[i + 1] = '0';
-						buff[i + 2] = '\0';
-					}
-				}
-				else if (kind_postfix)
-				{
-					strcat(buff, kind_postfix);
-				}
+				unsigned size;
+				if ((typeval->type->type == OFC_SEMA_TYPE_INTEGER)
+					&& ofc_sema_type_size(typeval->type, &size))
+					len += ofc_sema_typeval__kind_suffix(
+						&buff[len], typeval->type->kind,
+						size, ofc_target_integer_size_get());
+				return ofc_colstr_atomic_write(cs, buff, len);
+			}
 
-				return ofc_colstr_atomic_writef(cs, "%s", buff);
+		case OFC_SEMA_TYPE_REAL:
+			{
+				char buff[OFC_SEMA_TYPEVAL__PRINT_MAX];
+				unsigned len = ofc_sema_typeval__format_real(
+					buff, typeval->type, typeval->real);
+				return ((len > 0)
+					&& ofc_colstr_atomic_write(cs, buff, len));
 			}
 
 		case OFC_SEMA_TYPE_COMPLEX:
-			if (!ofc_colstr_atomic_writef(cs, "(")
-				|| !ofc_colstr_atomic_writef(cs, "%Lg",
-					typeval->complex.real)
-				|| !ofc_colstr_atomic_writef(cs, ",")
-				|| !ofc_colstr_atomic_writef(cs, " ")
-				|| !ofc_colstr_atomic_writef(cs, "%Lg",
-					typeval->complex.imaginary)
-				|| !ofc_colstr_atomic_writef(cs, ")"))
-				return false;
-			return true;
+			{
+				/* Format both parts first, so we write nothing on failure. */
+				char rbuff[OFC_SEMA_TYPEVAL__PRINT_MAX];
+				char ibuff[OFC_SEMA_TYPEVAL__PRINT_MAX];
+				unsigned rlen = ofc_sema_typeval__format_real(
+					rbuff, typeval->type, typeval->complex.real);
+				unsigned ilen = ofc_sema_typeval__format_real(
+					ibuff, typeval->type, typeval->complex.imaginary);
+				if ((rlen == 0) || (ilen == 0))
+					return false;
+
+				if (!ofc_colstr_atomic_writef(cs, "(")
+					|| !ofc_colstr_atomic_write(cs, rbuff, rlen)
+					|| !ofc_colstr_atomic_writef(cs, ",")
+					|| !ofc_colstr_atomic_writef(cs, " ")
+					|| !ofc_colstr_atomic_write(cs, ibuff, ilen)
+					|| !ofc_colstr_atomic_writef(cs, ")"))
+					return false;
+				return true;
+			}
 
 		case OFC_SEMA_TYPE_CHARACTER:
 			return ofc_colstr_writef(cs, "\"%.*s\"",
-				typeval->type->len, typeval->character);
+				typeval->type->len,
+				ofc_sema_typeval__character(typeval));
 
 		default:
 			break;
@@ -0,0 +1,1358 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "ofc/server.h"
+#include "ofc/diag.h"
+#include "ofc/file.h"
+#include "ofc/prep.h"
+#include "ofc/parse/file.h"
+#include "ofc/sema.h"
+
+
+/* Each request is a JSON object on a single line, with an "id" which
+ * is echoed back verbatim and a "method", which is one of:
+ *
+ *   open, update  {path, text}        Analyse text as path, or read path
+ *                                     when there's no text.
+ *   diagnostics   {path}              Diagnostics from the last analysis.
+ *   sema          {path, start, end}  Semantic tree of the program units
+ *                                     covering lines start to end.
+ *   definition    {path, line, column}
+ *                                     Where the name at line and column
+ *                                     is declared, and its type.
+ *   close         {path}              Forget about path.
+ *   shutdown      {}                  Stop reading requests.
+ *
+ * Responses are a single line, either {"id": ..., "result": ...} or
+ * {"id": ..., "error": "..."}. Lines and columns count from one, like
+ * the JSON diagnostic format. */
+
+
+typedef enum
+{
+	OFC_SERVER__JSON_NULL = 0,
+	OFC_SERVER__JSON_BOOL,
+	OFC_SERVER__JSON_NUMBER,
+	OFC_SERVER__JSON_STRING,
+	OFC_SERVER__JSON_COMPOUND,
+} ofc_server__json_e;
+
+typedef struct
+{
+	char*              key;
+	ofc_server__json_e type;
+	bool               boolean;
+	double             number;
+	char*              string;
+
+	/* The value as written, so an id can be echoed back as it was. */
+	const char* raw;
+	unsigned    raw_size;
+} ofc_server__member_t;
+
+typedef struct
+{
+	unsigned              count;
+	ofc_server__member_t* member;
+} ofc_server__request_t;
+
+
+static void ofc_server__json_space(const char* s, unsigned* i)
+{
+	while ((s[*i] == ' ') || (s[*i] == '\t')
+		|| (s[*i] == '\r') || (s[*i] == '\n'))
+		(*i)++;
+}
+
+static bool ofc_server__json_hex(
+	const char* s, unsigned* i, unsigned* value)
+{
+	unsigned v = 0;
+	unsigned j;
+	for (j = 0; j < 4; j++)
+	{
+		char c = s[*i + j];
+		v <<= 4;
+		if ((c >= '0') && (c <= '9'))
+			v |= (c - '0');
+		else if ((c >= 'a') && (c <= 'f'))
+			v |= (c - 'a' + 10);
+		else if ((c >= 'A') && (c <= 'F'))
+			v |= (c - 'A' + 10);
+		else
+			return false;
+	}
+
+	*i += 4;
+	*value = v;
+	return true;
+}
+
+/* Decodes a string into a new buffer, or skips it when str is NULL. */
+static bool ofc_server__json_string(
+	const char* s, unsigned* i, char** str)
+{
+	if (s[*i] != '"')
+		return false;
+	(*i)++;
+
+	/* Decoding never makes a string longer. */
+	unsigned start = *i;
+	unsigned len;
+	for (len = 0; (s[start + len] != '"') && (s[start + len] != '\0'); len++)
+	{
+		if ((s[start + len] == '\\')
+			&& (s[start + len + 1] != '\0'))
+			len++;
+	}
+
+	char* out = NULL;
+	if (str)
+	{
+		out = (char*)ofc_alloc(OFC_ALLOC_MISC, len + 1);
+		if (!out) return false;
+	}
+
+	unsigned o = 0;
+	while (s[*i] != '"')
+	{
+		char c = s[(*i)++];
+		if (c == '\0')
+		{
+			ofc_free(out);
+			return false;
+		}
+
+		if (c == '\\')
+		{
+			c = s[(*i)++];
+			switch (c)
+			{
+				case '"' : case '\\': case '/': break;
+				case 'b': c = '\b'; break;
+				case 'f': c = '\f'; break;
+				case 'n': c = '\n'; break;
+				case 'r': c = '\r'; break;
+				case 't': c = '\t'; break;
+
+				case 'u':
+				{
+					unsigned cp;
+					if (!ofc_server__json_hex(s, i, &cp))
+					{
+						ofc_free(out);
+						return false;
+					}
+
+					if ((cp >= 0xD800) && (cp < 0xDC00)
+						&& (s[*i] == '\\') && (s[*i + 1] == 'u'))
+					{
+						unsigned lo, j = (*i + 2);
+						if (ofc_server__json_hex(s, &j, &lo)
+							&& (lo >= 0xDC00) && (lo < 0xE000))
+						{
+							cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+							*i = j;
+						}
+					}
+
+					if (out)
+					{
+						if (cp < 0x80)
+						{
+							out[o++] = cp;
+						}
+						else if (cp < 0x800)
+						{
+							out[o++] = 0xC0 | (cp >> 6);
+							out[o++] = 0x80 | (cp & 0x3F);
+						}
+						else if (cp < 0x10000)
+						{
+							out[o++] = 0xE0 | (cp >> 12);
+							out[o++] = 0x80 | ((cp >> 6) & 0x3F);
+							out[o++] = 0x80 | (cp & 0x3F);
+						}
+						else
+						{
+							out[o++] = 0xF0 | (cp >> 18);
+							out[o++] = 0x80 | ((cp >> 12) & 0x3F);
+							out[o++] = 0x80 | ((cp >> 6) & 0x3F);
+							out[o++] = 0x80 | (cp & 0x3F);
+						}
+					}
+					continue;
+				}
+
+				default:
+					ofc_free(out);
+					return false;
+			}
+		}
+
+		if (out) out[o++] = c;
+	}
+	(*i)++;
+
+	if (out)
+	{
+		out[o] = '\0';
+		*str = out;
+	}
+	return true;
+}
+
+static bool ofc_server__json_skip(
+	const char* s, unsigned* i, unsigned depth)
+{
+	if (depth > 64)
+		return false;
+
+	ofc_server__json_space(s, i);
+	char c = s[*i];
+
+	if (c == '"')
+		return ofc_server__json_string(s, i, NULL);
+
+	if ((c == '{') || (c == '['))
+	{
+		char close = (c == '{' ? '}' : ']');
+		(*i)++;
+		ofc_server__json_space(s, i);
+		if (s[*i] == close)
+		{
+			(*i)++;
+			return true;
+		}
+
+		while (true)
+		{
+			if (c == '{')
+			{
+				if (!ofc_server__json_string(s, i, NULL))
+					return false;
+				ofc_server__json_space(s, i);
+				if (s[(*i)++] != ':')
+					return false;
+			}
+
+			if (!ofc_server__json_skip(s, i, (depth + 1)))
+				return false;
+
+			ofc_server__json_space(s, i);
+			if (s[*i] == close)
+			{
+				(*i)++;
+				return true;
+			}
+			if (s[(*i)++] != ',')
+				return false;
+			ofc_server__json_space(s, i);
+		}
+	}
+
+	/* Numbers and literals. */
+	unsigned start = *i;
+	while ((s[*i] != '\0') && (strchr(",}] \t\r\n", s[*i]) == NULL))
+		(*i)++;
+	return (*i > start);
+}
+
+static bool ofc_server__json_value(
+	const char* s, unsigned* i,
+	ofc_server__member_t* member)
+{
+	ofc_server__json_space(s, i);
+	unsigned start = *i;
+	char c = s[*i];
+
+	member->type   = OFC_SERVER__JSON_COMPOUND;
+	member->string = NULL;
+
+	if (c == '"')
+	{
+		member->type = OFC_SERVER__JSON_STRING;
+		if (!ofc_server__json_string(s, i, &member->string))
+			return false;
+	}
+	else if (!ofc_server__json_skip(s, i, 0))
+	{
+		return false;
+	}
+	else if ((c == '-') || ((c >= '0') && (c <= '9')))
+	{
+		char* end;
+		member->type   = OFC_SERVER__JSON_NUMBER;
+		member->number = strtod(&s[start], &end);
+		if (end != &s[*i])
+			return false;
+	}
+	else if ((c != '{') && (c != '['))
+	{
+		unsigned len = (*i - start);
+		if ((len == 4) && (strncmp(&s[start], "true", 4) == 0))
+		{
+			member->type    = OFC_SERVER__JSON_BOOL;
+			member->boolean = true;
+		}
+		else if ((len == 5) && (strncmp(&s[start], "false", 5) == 0))
+		{
+			member->type    = OFC_SERVER__JSON_BOOL;
+			member->boolean = false;
+		}
+		else if ((len == 4) && (strncmp(&s[start], "null", 4) == 0))
+		{
+			member->type = OFC_SERVER__JSON_NULL;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	member->raw      = &s[start];
+	member->raw_size = (*i - start);
+	return true;
+}
+
+static void ofc_server__request_cleanup(
+	ofc_server__request_t* request)
+{
+	unsigned i;
+	for (i = 0; i < request->count; i++)
+	{
+		ofc_free(request->member[i].key);
+		ofc_free(request->member[i].string);
+	}
+	ofc_free(request->member);
+
+	request->count  = 0;
+	request->member = NULL;
+}
+
+static bool ofc_server__request_parse(
+	const char* s, ofc_server__request_t* request)
+{
+	request->count  = 0;
+	request->member = NULL;
+
+	unsigned i = 0;
+	ofc_server__json_space(s, &i);
+	if (s[i++] != '{')
+		return false;
+
+	ofc_server__json_space(s, &i);
+	if (s[i] == '}')
+		return true;
+
+	while (true)
+	{
+		ofc_server__member_t* nmember
+			= (ofc_server__member_t*)ofc_realloc(OFC_ALLOC_MISC, request->member,
+				(sizeof(ofc_server__member_t) * (request->count + 1)));
+		if (!nmember) return false;
+		request->member = nmember;
+
+		ofc_server__member_t* member
+			= &request->member[request->count];
+		member->key    = NULL;
+		member->string = NULL;
+
+		ofc_server__json_space(s, &i);
+		if (!ofc_server__json_string(s, &i, &member->key))
+			return false;
+		request->count++;
+
+		ofc_server__json_space(s, &i);
+		if ((s[i++] != ':')
+			|| !ofc_server__json_value(s, &i, member))
+			return false;
+
+		ofc_server__json_space(s, &i);
+		if (s[i] == '}')
+			break;
+		if (s[i++] != ',')
+			return false;
+	}
+
+	i++;
+	ofc_server__json_space(s, &i);
+	return (s[i] == '\0');
+}
+
+static const ofc_server__member_t* ofc_server__request_member(
+	const ofc_server__request_t* request, const char* key)
+{
+	unsigned i;
+	for (i = 0; i < request->count; i++)
+	{
+		if (strcmp(request->member[i].key, key) == 0)
+			return &request->member[i];
+	}
+	return NULL;
+}
+
+static const char* ofc_server__request_string(
+	const ofc_server__request_t* request, const char* key)
+{
+	const ofc_server__member_t* member
+		= ofc_server__request_member(request, key);
+	return ((member && (member->type == OFC_SERVER__JSON_STRING))
+		? member->string : NULL);
+}
+
+static bool ofc_server__request_line(
+	const ofc_server__request_t* request, const char* key,
+	unsigned* value)
+{
+	const ofc_server__member_t* member
+		= ofc_server__request_member(request, key);
+	if (!member || (member->type != OFC_SERVER__JSON_NUMBER)
+		|| (member->number < 1) || (member->number > UINT32_MAX))
+		return false;
+
+	*value = member->number;
+	return true;
+}
+
+
+typedef struct
+{
+	char*    base;
+	unsigned size, max;
+	bool     fail;
+} ofc_server__buff_t;
+
+static void ofc_server__write(
+	ofc_server__buff_t* buff, const char* base, unsigned size)
+{
+	if (buff->fail || (size == 0))
+		return;
+
+	if ((buff->size + size) > buff->max)
+	{
+		unsigned nmax = (buff->max << 1);
+		if (nmax < (buff->size + size))
+			nmax = (buff->size + size);
+		if (nmax < 256)
+			nmax = 256;
+
+		char* nbase = (char*)ofc_realloc(OFC_ALLOC_MISC, buff->base, nmax);
+		if (!nbase)
+		{
+			buff->fail = true;
+			return;
+		}
+		buff->base = nbase;
+		buff->max  = nmax;
+	}
+
+	memcpy(&buff->base[buff->size], base, size);
+	buff->size += size;
+}
+
+static void ofc_server__write_strz(
+	ofc_server__buff_t* buff, const char* strz)
+{
+	ofc_server__write(buff, strz, strlen(strz));
+}
+
+static void ofc_server__writef(
+	ofc_server__buff_t* buff, const char* format, ...)
+	__attribute__ ((format (printf, 2, 3)));
+
+static void ofc_server__writef(
+	ofc_server__buff_t* buff, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int len = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+
+	if (len <= 0)
+		return;
+
+	char str[len + 1];
+	va_start(args, format);
+	vsnprintf(str, (len + 1), format, args);
+	va_end(args);
+
+	ofc_server__write(buff, str, len);
+}
+
+static void ofc_server__write_json(
+	ofc_server__buff_t* buff, const char* base, unsigned size)
+{
+	ofc_server__write_strz(buff, "\"");
+
+	unsigned i, s;
+	for (i = 0, s = 0; i < size; i++)
+	{
+		unsigned char c = base[i];
+		if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			continue;
+
+		ofc_server__write(buff, &base[s], (i - s));
+		s = (i + 1);
+
+		switch (c)
+		{
+			case '"' : ofc_server__write_strz(buff, "\\\""); break;
+			case '\\': ofc_server__write_strz(buff, "\\\\"); break;
+			case '\n': ofc_server__write(buff, "\\n" , 2); break;
+			case '\r': ofc_server__write(buff, "\\r" , 2); break;
+			case '\t': ofc_server__write(buff, "\\t" , 2); break;
+			default:
+				ofc_server__writef(buff, "\\u%04x", c);
+				break;
+		}
+	}
+	ofc_server__write(buff, &base[s], (i - s));
+
+	ofc_server__write_strz(buff, "\"");
+}
+
+static void ofc_server__write_json_strz(
+	ofc_server__buff_t* buff, const char* strz)
+{
+	if (!strz)
+		ofc_server__write_strz(buff, "null");
+	else
+		ofc_server__write_json(buff, strz, strlen(strz));
+}
+
+
+typedef struct
+{
+	ofc_diag_severity_e severity;
+	char*               path;
+	bool                positional;
+	unsigned            row, col;
+	char*               context;
+	char*               message;
+} ofc_server__diag_t;
+
+typedef struct
+{
+	char*           path;
+	ofc_lang_opts_t lang_opts;
+	unsigned        version;
+	uint64_t        hash;
+	bool            analysed;
+
+	ofc_file_t*            file;
+	ofc_sparse_t*          condense;
+	ofc_parse_stmt_list_t* program;
+
+	/* Unchanged units are reused from the previous analysis, so
+	   sema only covers them fully once sema_full is set. */
+	ofc_sema_incremental_t* incremental;
+	ofc_sema_scope_t*       sema;
+	bool                    sema_full;
+	ofc_sema_index_t*       index;
+
+	unsigned            diag_count;
+	ofc_server__diag_t* diag;
+} ofc_server__doc_t;
+
+static const char* ofc_server__doc_key(
+	const ofc_server__doc_t* doc)
+{
+	return (doc ? doc->path : NULL);
+}
+
+static void ofc_server__doc_diag_clear(
+	ofc_server__doc_t* doc)
+{
+	unsigned i;
+	for (i = 0; i < doc->diag_count; i++)
+	{
+		ofc_free(doc->diag[i].path);
+		ofc_free(doc->diag[i].context);
+		ofc_free(doc->diag[i].message);
+	}
+	ofc_free(doc->diag);
+
+	doc->diag_count = 0;
+	doc->diag       = NULL;
+}
+
+static void ofc_server__doc_unload(
+	ofc_server__doc_t* doc)
+{
+	ofc_sema_index_delete(doc->index);
+	ofc_sema_scope_delete(doc->sema);
+	ofc_parse_stmt_list_delete(doc->program);
+	ofc_sparse_delete(doc->condense);
+	ofc_file_delete(doc->file);
+
+	doc->index     = NULL;
+	doc->sema      = NULL;
+	doc->sema_full = false;
+	doc->program   = NULL;
+	doc->condense  = NULL;
+	doc->file      = NULL;
+}
+
+static void ofc_server__doc_delete(
+	ofc_server__doc_t* doc)
+{
+	if (!doc)
+		return;
+
+	ofc_server__doc_unload(doc);
+	ofc_server__doc_diag_clear(doc);
+	ofc_sema_incremental_delete(doc->incremental);
+	ofc_free(doc->path);
+	ofc_free(doc);
+}
+
+static ofc_server__doc_t* ofc_server__doc_create(
+	const char* path, const ofc_lang_opts_t* lang_opts)
+{
+	ofc_server__doc_t* doc
+		= (ofc_server__doc_t*)ofc_alloc(OFC_ALLOC_MISC,
+			sizeof(ofc_server__doc_t));
+	if (!doc) return NULL;
+
+	doc->path        = ofc_strdup(OFC_ALLOC_MISC, path);
+	doc->lang_opts   = *lang_opts;
+	doc->version     = 0;
+	doc->hash        = 0;
+	doc->analysed    = false;
+	doc->file        = NULL;
+	doc->condense    = NULL;
+	doc->program     = NULL;
+	doc->incremental = ofc_sema_incremental_create();
+	doc->sema        = NULL;
+	doc->sema_full   = false;
+	doc->index       = NULL;
+	doc->diag_count  = 0;
+	doc->diag        = NULL;
+
+	const char* ext = strrchr(path, '.');
+	if (ext && (strcasecmp(ext, ".f90") == 0))
+		doc->lang_opts = OFC_LANG_OPTS_F90;
+
+	if (!doc->path || !doc->incremental)
+	{
+		ofc_server__doc_delete(doc);
+		return NULL;
+	}
+
+	return doc;
+}
+
+static bool ofc_server__doc_diag_add(
+	const ofc_diag_info_t* info, ofc_server__doc_t* doc)
+{
+	ofc_server__diag_t* ndiag
+		= (ofc_server__diag_t*)ofc_realloc(OFC_ALLOC_MISC, doc->diag,
+			(sizeof(ofc_server__diag_t) * (doc->diag_count + 1)));
+	if (!ndiag) return false;
+	doc->diag = ndiag;
+
+	ofc_server__diag_t* diag = &doc->diag[doc->diag_count];
+	diag->severity   = info->severity;
+	diag->positional = info->positional;
+	diag->row        = info->row;
+	diag->col        = info->col;
+	diag->path       = ofc_strdup(OFC_ALLOC_MISC, info->path ? info->path : "");
+	diag->message    = ofc_strdup(OFC_ALLOC_MISC, info->message);
+	diag->context    = (info->context ? ofc_strdup(OFC_ALLOC_MISC, info->context) : NULL);
+	if (!diag->path || !diag->message
+		|| (info->context && !diag->context))
+	{
+		ofc_free(diag->path);
+		ofc_free(diag->message);
+		ofc_free(diag->context);
+		return false;
+	}
+
+	doc->diag_count++;
+	return true;
+}
+
+static uint64_t ofc_server__hash(const char* strz)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (; *strz != '\0'; strz++)
+	{
+		hash ^= (uint8_t)*strz;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* Analyses text as the document's contents, or reads the document's
+   path when text is NULL. Returns false only on internal failure,
+   errors in the source are reported as diagnostics. */
+static bool ofc_server__doc_analyse(
+	ofc_server__doc_t* doc, const char* text, bool* changed)
+{
+	ofc_file_t* file = (text
+		? ofc_file_create_strz(doc->path, doc->lang_opts, text)
+		: ofc_file_create(doc->path, doc->lang_opts));
+	if (!file) return false;
+
+	uint64_t hash = ofc_server__hash(ofc_file_get_strz(file));
+	if (doc->analysed && (hash == doc->hash))
+	{
+		ofc_file_delete(file);
+		*changed = false;
+		return true;
+	}
+
+	*changed = true;
+	ofc_server__doc_unload(doc);
+	ofc_server__doc_diag_clear(doc);
+
+	doc->file     = file;
+	doc->hash     = hash;
+	doc->analysed = true;
+	doc->version++;
+
+	ofc_diag_t* diag = ofc_diag_default();
+	ofc_diag_reset(diag);
+
+	doc->condense = ofc_prep(doc->file);
+	if (doc->condense)
+		doc->program = ofc_parse_file(doc->condense);
+
+	bool success = true;
+	if (doc->program)
+	{
+		const ofc_parse_stmt_list_t* view
+			= ofc_sema_incremental_view(
+				doc->incremental, doc->file, doc->program, true);
+		doc->sema = ofc_sema_scope_global(
+			&doc->lang_opts, (view ? view : doc->program));
+
+		unsigned reused = 0;
+		ofc_sema_incremental_stats(
+			doc->incremental, &reused, NULL);
+		doc->sema_full = (!view || (reused == 0));
+
+		/* Units are only worth remembering if they analysed cleanly. */
+		if (doc->sema && view)
+			ofc_sema_incremental_record(doc->incremental);
+	}
+
+	if (!doc->sema && ofc_file_no_errors())
+	{
+		ofc_file_error(doc->file, NULL, (!doc->condense
+			? "Failed to preprocess source file"
+			: (!doc->program ? "Failed to parse program"
+				: "Program failed semantic analysis")));
+	}
+
+	if (!ofc_diag_foreach(diag, doc,
+		(void*)ofc_server__doc_diag_add))
+		success = false;
+	ofc_diag_reset(diag);
+	return success;
+}
+
+/* Reanalyses every unit in full and indexes the result,
+   for requests which look inside units. */
+static bool ofc_server__doc_sema_full(
+	ofc_server__doc_t* doc)
+{
+	if (!doc->program)
+		return false;
+
+	if (!doc->sema_full)
+	{
+		ofc_sema_scope_delete(doc->sema);
+		doc->sema = ofc_sema_scope_global(
+			&doc->lang_opts, doc->program);
+		doc->sema_full = true;
+
+		/* The diagnostics match those we already have. */
+		ofc_diag_reset(ofc_diag_default());
+	}
+
+	if (doc->sema && !doc->index)
+	{
+		doc->index = ofc_sema_index_create(
+			doc->program, doc->sema);
+	}
+
+	return (doc->index != NULL);
+}
+
+
+typedef struct
+{
+	const ofc_lang_opts_t* lang_opts;
+	ofc_hashmap_t*         doc;
+	bool                   shutdown;
+} ofc_server__t;
+
+static void ofc_server__write_diags(
+	ofc_server__buff_t* buff, const ofc_server__doc_t* doc)
+{
+	ofc_server__writef(buff,
+		"{\"version\":%u,\"diagnostics\":[", doc->version);
+
+	unsigned i;
+	for (i = 0; i < doc->diag_count; i++)
+	{
+		const ofc_server__diag_t* diag = &doc->diag[i];
+
+		ofc_server__writef(buff, "%s{\"severity\":\"%s\",\"file\":",
+			(i > 0 ? "," : ""),
+			(diag->severity == OFC_DIAG_ERROR ? "error" : "warning"));
+		ofc_server__write_json_strz(buff, diag->path);
+
+		if (diag->positional)
+		{
+			ofc_server__writef(buff,
+				",\"line\":%u,\"column\":%u",
+				(diag->row + 1), (diag->col + 1));
+		}
+
+		ofc_server__write_strz(buff, ",\"message\":");
+		ofc_server__write_json_strz(buff, diag->message);
+
+		if (diag->positional && diag->context)
+		{
+			ofc_server__write_strz(buff, ",\"source\":");
+			ofc_server__write_json_strz(buff, diag->context);
+		}
+
+		ofc_server__write_strz(buff, "}");
+	}
+
+	ofc_server__write_strz(buff, "]}");
+}
+
+/* Finds the source lines a top level statement spans, which is
+   only possible for statements which came from the document. */
+static bool ofc_server__stmt_rows(
+	const ofc_server__doc_t* doc,
+	const ofc_parse_stmt_t* stmt,
+	unsigned* first, unsigned* last)
+{
+	if (!stmt || (stmt->src.string.size == 0))
+		return false;
+
+	const ofc_file_t* file = NULL;
+	const char* fptr = ofc_sparse_file_pointer(
+		stmt->src.sparse, stmt->src.string.base, &file);
+	const char* lptr = ofc_sparse_file_pointer(
+		stmt->src.sparse,
+		&stmt->src.string.base[stmt->src.string.size - 1], NULL);
+
+	return ((file == doc->file) && fptr && lptr
+		&& ofc_file_get_position(file, fptr, first, NULL)
+		&& ofc_file_get_position(file, lptr, last, NULL));
+}
+
+static bool ofc_server__is_unit(
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!stmt) return false;
+
+	switch (stmt->type)
+	{
+		case OFC_PARSE_STMT_PROGRAM:
+		case OFC_PARSE_STMT_SUBROUTINE:
+		case OFC_PARSE_STMT_FUNCTION:
+		case OFC_PARSE_STMT_BLOCK_DATA:
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+/* Unit scopes keep the name from their statement, so match on that. */
+static const ofc_sema_scope_t* ofc_server__unit_scope(
+	const ofc_sema_scope_t* root,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_sema_decl_t** decl)
+{
+	const char* name = stmt->program.name.string.base;
+	if (!name) return NULL;
+
+	unsigned i;
+	if (root->child)
+	{
+		for (i = 0; i < root->child->count; i++)
+		{
+			const ofc_sema_scope_t* scope
+				= root->child->scope[i];
+			if (scope->name.base == name)
+				return scope;
+		}
+	}
+
+	if (root->decl)
+	{
+		for (i = 0; i < root->decl->count; i++)
+		{
+			const ofc_sema_decl_t* d = root->decl->decl[i];
+			if (d->func && (d->func->name.base == name))
+			{
+				if (decl) *decl = d;
+				return d->func;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static bool ofc_server__sema(
+	ofc_server__doc_t* doc,
+	const ofc_server__request_t* request,
+	ofc_server__buff_t* buff)
+{
+	unsigned start = 1, end = UINT32_MAX;
+	if (ofc_server__request_member(request, "start")
+		&& !ofc_server__request_line(request, "start", &start))
+		return false;
+	if (ofc_server__request_member(request, "end")
+		&& !ofc_server__request_line(request, "end", &end))
+		return false;
+
+	if (!ofc_server__doc_sema_full(doc))
+		return false;
+
+	ofc_colstr_t* cs = ofc_colstr_create(72, 0);
+	if (!cs) return false;
+
+	bool success = true;
+	unsigned i;
+	for (i = 0; success && (i < doc->program->count); i++)
+	{
+		const ofc_parse_stmt_t* stmt = doc->program->stmt[i];
+		if (!ofc_server__is_unit(stmt))
+			continue;
+
+		unsigned first, last;
+		if (!ofc_server__stmt_rows(doc, stmt, &first, &last)
+			|| ((last + 1) < start) || ((first + 1) > end))
+			continue;
+
+		const ofc_sema_decl_t* decl = NULL;
+		const ofc_sema_scope_t* scope
+			= ofc_server__unit_scope(doc->sema, stmt, &decl);
+		if (!scope) continue;
+
+		/* A function's return type is printed by its declaration. */
+		if (scope->type == OFC_SEMA_SCOPE_FUNCTION)
+		{
+			success = (decl && decl->type
+				&& ofc_colstr_newline(cs, 0, NULL)
+				&& ofc_sema_type_print(cs, decl->type->subtype)
+				&& ofc_colstr_atomic_writef(cs, " "));
+		}
+
+		success = success
+			&& ofc_sema_scope_print(cs, 0, scope);
+	}
+
+	if (success)
+	{
+		unsigned size;
+		const char* text = ofc_colstr_get(cs, &size);
+
+		ofc_server__write_strz(buff, "{\"text\":");
+		ofc_server__write_json(buff, (text ? text : ""), (text ? size : 0));
+		ofc_server__write_strz(buff, "}");
+	}
+
+	ofc_colstr_delete(cs);
+	return success;
+}
+
+/* Writes a type as it's declared, so with its kind or size. */
+static bool ofc_server__write_type(
+	ofc_server__buff_t* buff, const ofc_sema_type_t* type)
+{
+	ofc_colstr_t* cs = ofc_colstr_create(72, 0);
+	if (!cs) return false;
+
+	/* Procedures are named, along with what a function returns. */
+	bool success;
+	if (ofc_sema_type_is_procedure(type))
+	{
+		success = ((!type->subtype
+			|| (ofc_sema_type_print(cs, type->subtype)
+				&& ofc_colstr_atomic_writef(cs, " ")))
+			&& ofc_colstr_atomic_writef(cs, "%s",
+				ofc_sema_type_str_rep(type)));
+	}
+	else
+	{
+		success = ofc_sema_type_print(cs, type);
+	}
+
+	unsigned size;
+	const char* text = ofc_colstr_get(cs, &size);
+	if (success && text)
+		ofc_server__write_json(buff, text, size);
+
+	ofc_colstr_delete(cs);
+	return (success && text);
+}
+
+static bool ofc_server__is_ident(char c, bool first)
+{
+	if (((c >= 'A') && (c <= 'Z'))
+		|| ((c >= 'a') && (c <= 'z')))
+		return true;
+	return (!first && (((c >= '0') && (c <= '9'))
+		|| (c == '_') || (c == '$')));
+}
+
+static bool ofc_server__definition(
+	ofc_server__doc_t* doc,
+	const ofc_server__request_t* request,
+	ofc_server__buff_t* buff)
+{
+	unsigned line, column;
+	if (!ofc_server__request_line(request, "line", &line)
+		|| !ofc_server__request_line(request, "column", &column))
+		return false;
+
+	if (!doc->file || !ofc_server__doc_sema_full(doc))
+		return false;
+
+	/* Rows are counted like ofc_file_get_position counts them. */
+	const char* strz = ofc_file_get_strz(doc->file);
+	const char* p = strz;
+	unsigned row;
+	for (row = 1; (row < line) && (*p != '\0'); p++)
+	{
+		if ((*p == '\r') || (*p == '\n'))
+			row++;
+	}
+
+	unsigned col;
+	for (col = 1; (col < column) && (*p != '\0')
+		&& (*p != '\r') && (*p != '\n'); col++, p++);
+
+	const char* s = p;
+	while ((s > strz) && ofc_server__is_ident(s[-1], false))
+		s--;
+	while ((s < p) && !ofc_server__is_ident(*s, true))
+		s++;
+	const char* e = p;
+	while (ofc_server__is_ident(*e, false))
+		e++;
+
+	if ((e <= s) || !ofc_server__is_ident(*s, true))
+	{
+		ofc_server__write_strz(buff, "null");
+		return true;
+	}
+	ofc_str_ref_t name = ofc_str_ref(s, (e - s));
+
+	/* Look the name up from the unit it's used in. */
+	const ofc_sema_scope_t* scope = doc->sema;
+	const ofc_sema_index_node_t* unit
+		= ofc_sema_index_find_file(doc->index,
+			OFC_SEMA_INDEX_SCOPE, doc->condense, s);
+	if (unit) scope = unit->scope;
+
+	/* Decls are made on first use, so prefer where the procedure
+	   is defined or where the name was explicitly specified. */
+	const ofc_sema_decl_t* decl
+		= ofc_sema_scope_decl_find(scope, name, false);
+	if (!decl || !decl->func)
+	{
+		const ofc_sema_decl_t* proc
+			= ofc_sema_scope_decl_find(doc->sema, name, true);
+		if (proc && proc->func) decl = proc;
+	}
+
+	const ofc_sema_spec_t* spec = NULL;
+	const ofc_sema_scope_t* sscope;
+	for (sscope = scope; sscope && !spec; sscope = sscope->parent)
+	{
+		spec = (sscope->spec
+			? ofc_hashmap_find(sscope->spec->map, &name) : NULL);
+		if (spec && ofc_sparse_ref_empty(spec->name))
+			spec = NULL;
+	}
+
+	if (!decl && !spec)
+	{
+		ofc_server__write_strz(buff, "null");
+		return true;
+	}
+
+	ofc_server__write_strz(buff, "{\"name\":");
+	ofc_server__write_json(buff, name.base, name.size);
+	ofc_server__write_strz(buff, ",\"type\":");
+	const ofc_sema_type_t* type
+		= (decl ? decl->type : ofc_sema_type_spec(spec));
+	if (!type || !ofc_server__write_type(buff, type))
+		ofc_server__write_json_strz(buff,
+			ofc_sema_type_enum_str_rep(spec->type));
+
+	const ofc_sparse_t* dsparse = doc->condense;
+	const char* dname = NULL;
+	if (decl && decl->func)
+	{
+		dname = decl->func->name.base;
+	}
+	else if (spec)
+	{
+		dsparse = spec->name.sparse;
+		dname   = spec->name.string.base;
+	}
+	else
+	{
+		dname = decl->name.base;
+	}
+
+	const ofc_file_t* dfile = NULL;
+	const char* dptr = ofc_sparse_file_pointer(
+		dsparse, dname, &dfile);
+	unsigned drow, dcol;
+	if (dptr && ofc_file_get_position(dfile, dptr, &drow, &dcol))
+	{
+		ofc_server__write_strz(buff, ",\"file\":");
+		ofc_server__write_json_strz(buff, ofc_file_get_path(dfile));
+		ofc_server__writef(buff, ",\"line\":%u,\"column\":%u",
+			(drow + 1), (dcol + 1));
+	}
+
+	ofc_server__write_strz(buff, "}");
+	return true;
+}
+
+/* Every method other than shutdown works on the document at a path. */
+static const char* ofc_server__document_method[] =
+{
+	"open", "update", "close",
+	"diagnostics", "sema", "definition",
+	NULL
+};
+
+/* Writes the result of request into buff, or returns an error. */
+static const char* ofc_server__dispatch(
+	ofc_server__t* server,
+	const ofc_server__request_t* request,
+	ofc_server__buff_t* buff)
+{
+	const char* method
+		= ofc_server__request_string(request, "method");
+	if (!method)
+		return "Request has no method";
+
+	if (strcmp(method, "shutdown") == 0)
+	{
+		server->shutdown = true;
+		ofc_server__write_strz(buff, "true");
+		return NULL;
+	}
+
+	unsigned m;
+	for (m = 0; ofc_server__document_method[m]
+		&& (strcmp(method, ofc_server__document_method[m]) != 0); m++);
+	if (!ofc_server__document_method[m])
+		return "Unknown method";
+
+	const char* path
+		= ofc_server__request_string(request, "path");
+	if (!path)
+		return "Request has no path";
+
+	ofc_server__doc_t* doc
+		= ofc_hashmap_find_modify(server->doc, path);
+
+	if ((strcmp(method, "open") == 0)
+		|| (strcmp(method, "update") == 0))
+	{
+		if (!doc)
+		{
+			doc = ofc_server__doc_create(
+				path, server->lang_opts);
+			if (!doc) return "Failed to create document";
+
+			if (!ofc_hashmap_add(server->doc, doc))
+			{
+				ofc_server__doc_delete(doc);
+				return "Failed to create document";
+			}
+		}
+
+		const ofc_server__member_t* text
+			= ofc_server__request_member(request, "text");
+		if (text && (text->type != OFC_SERVER__JSON_STRING))
+			return "Document text must be a string";
+
+		bool changed;
+		if (!ofc_server__doc_analyse(doc,
+			(text ? text->string : NULL), &changed))
+		{
+			ofc_hashmap_remove(server->doc, doc);
+			ofc_server__doc_delete(doc);
+			return "Failed to read document";
+		}
+
+		ofc_server__write_diags(buff, doc);
+		return NULL;
+	}
+
+	if (!doc)
+		return "Document isn't open";
+
+	if (strcmp(method, "close") == 0)
+	{
+		ofc_hashmap_remove(server->doc, doc);
+		ofc_server__doc_delete(doc);
+		ofc_server__write_strz(buff, "true");
+		return NULL;
+	}
+
+	if (strcmp(method, "diagnostics") == 0)
+	{
+		ofc_server__write_diags(buff, doc);
+		return NULL;
+	}
+
+	if (strcmp(method, "sema") == 0)
+	{
+		return (ofc_server__sema(doc, request, buff)
+			? NULL : "Failed to print semantic tree");
+	}
+
+	if (strcmp(method, "definition") == 0)
+	{
+		return (ofc_server__definition(doc, request, buff)
+			? NULL : "Failed to find definition");
+	}
+
+	return "Unknown method";
+}
+
+static bool ofc_server__respond(
+	ofc_server__t* server, const char* line, int out_fd)
+{
+	ofc_server__buff_t result   = { NULL, 0, 0, false };
+	ofc_server__buff_t response = { NULL, 0, 0, false };
+
+	ofc_server__request_t request;
+	bool parsed = ofc_server__request_parse(line, &request);
+
+	const char* error = (parsed
+		? ofc_server__dispatch(server, &request, &result)
+		: "Failed to parse request");
+	if (!error && result.fail)
+		error = "Out of memory";
+
+	const ofc_server__member_t* id = (parsed
+		? ofc_server__request_member(&request, "id") : NULL);
+
+	ofc_server__write_strz(&response, "{\"id\":");
+	if (id && (id->type != OFC_SERVER__JSON_COMPOUND))
+		ofc_server__write(&response, id->raw, id->raw_size);
+	else
+		ofc_server__write_strz(&response, "null");
+
+	if (error)
+	{
+		ofc_server__write_strz(&response, ",\"error\":");
+		ofc_server__write_json_strz(&response, error);
+	}
+	else
+	{
+		ofc_server__write_strz(&response, ",\"result\":");
+		ofc_server__write(&response, result.base, result.size);
+	}
+	ofc_server__write_strz(&response, "}\n");
+
+	ofc_server__request_cleanup(&request);
+	ofc_free(result.base);
+
+	bool success = !response.fail;
+	unsigned offset;
+	for (offset = 0; success && (offset < response.size); )
+	{
+		ssize_t w = write(out_fd,
+			&response.base[offset], (response.size - offset));
+		if (w <= 0)
+			success = false;
+		else
+			offset += w;
+	}
+
+	ofc_free(response.base);
+	return success;
+}
+
+bool ofc_server(
+	const ofc_lang_opts_t* lang_opts,
+	int in_fd, int out_fd)
+{
+	if (!lang_opts)
+		return false;
+
+	ofc_server__t server =
+	{
+		.lang_opts = lang_opts,
+		.shutdown  = false,
+		.doc       = ofc_hashmap_create(
+			NULL, NULL,
+			(void*)ofc_server__doc_key,
+			(void*)ofc_server__doc_delete),
+	};
+	if (!server.doc) return false;
+
+	int fd = dup(in_fd);
+	FILE* in = (fd >= 0 ? fdopen(fd, "r") : NULL);
+	if (!in)
+	{
+		if (fd >= 0) close(fd);
+		ofc_hashmap_delete(server.doc);
+		return false;
+	}
+
+	bool success = true;
+	char*  line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	while (success && !server.shutdown
+		&& ((len = getline(&line, &size, in)) >= 0))
+	{
+		while ((len > 0) && ((line[len - 1] == '\n')
+			|| (line[len - 1] == '\r')))
+			line[--len] = '\0';
+		if (len == 0) continue;
+
+		success = ofc_server__respond(&server, line, out_fd);
+	}
+
+	/* The line buffer comes from getline. */
+	free(line);
+	fclose(in);
+	ofc_hashmap_delete(server.doc);
+	return success;
+}
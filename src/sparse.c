@@ -13,10 +13,12 @@
  * limitations under the License.
  */
 
+#include <ctype.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "ofc/alloc.h"
 #include "ofc/fctype.h"
 #include "ofc/sparse.h"
 
@@ -38,6 +40,12 @@ struct ofc_sparse_s
 
 	char* strz;
 
+	/* One bit per character of strz, set where an entry starts. */
+	uint64_t* boundary;
+
+	/* Set when entries appear in the same order in the parent. */
+	bool ordered;
+
 	ofc_label_table_t* labels;
 
 	unsigned ref;
@@ -49,7 +57,7 @@ static ofc_sparse_t* ofc_sparse__create(
 	ofc_file_t* file, ofc_sparse_t* parent)
 {
 	ofc_sparse_t* sparse
-		= (ofc_sparse_t*)malloc(
+		= (ofc_sparse_t*)ofc_alloc(OFC_ALLOC_SPARSE,
 			sizeof(ofc_sparse_t));
 	if (!sparse) return NULL;
 
@@ -57,7 +65,7 @@ static ofc_sparse_t* ofc_sparse__create(
 		= ofc_label_table_create();
 	if (!sparse->labels)
 	{
-		free(sparse);
+		ofc_free(sparse);
 		return NULL;
 	}
 
@@ -69,7 +77,9 @@ static ofc_sparse_t* ofc_sparse__create(
 	sparse->max_count = 0;
 	sparse->entry     = NULL;
 
-	sparse->strz = NULL;
+	sparse->strz     = NULL;
+	sparse->boundary = NULL;
+	sparse->ordered  = false;
 
 	sparse->ref = 0;
 
@@ -133,9 +143,10 @@ void ofc_sparse_delete(ofc_sparse_t* sparse)
 
 	ofc_label_table_delete(sparse->labels);
 
-	free(sparse->strz);
-	free(sparse->entry);
-	free(sparse);
+	ofc_free(sparse->boundary);
+	ofc_free(sparse->strz);
+	ofc_free(sparse->entry);
+	ofc_free(sparse);
 }
 
 
@@ -167,7 +178,7 @@ bool ofc_sparse_append_strn(
 		unsigned ncount = (sparse->max_count << 1);
 		if (ncount == 0) ncount = 16;
 
-		ofc_sparse_entry_t* nentry = (ofc_sparse_entry_t*)realloc(sparse->entry,
+		ofc_sparse_entry_t* nentry = (ofc_sparse_entry_t*)ofc_realloc(OFC_ALLOC_SPARSE, sparse->entry,
 				(sizeof(ofc_sparse_entry_t) * ncount));
 		if (!nentry) return false;
 		sparse->entry = nentry;
@@ -188,13 +199,33 @@ void ofc_sparse_lock(ofc_sparse_t* sparse)
 	if (!sparse || sparse->strz)
 		return;
 
-	sparse->strz = (char*)malloc(sparse->len + 1);
+	sparse->strz = (char*)ofc_alloc(OFC_ALLOC_SPARSE, sparse->len + 1);
 	if (!sparse->strz) return;
 
 	unsigned i, j;
 	for (i = 0, j = 0; i < sparse->count; j += sparse->entry[i++].len)
 		memcpy(&sparse->strz[j], sparse->entry[i].ptr, sparse->entry[i].len);
 	sparse->strz[j] = '\0';
+
+	/* If this fails we fall back to searching the entries. */
+	sparse->boundary = (uint64_t*)ofc_calloc(OFC_ALLOC_SPARSE,
+		((sparse->len / 64) + 1), sizeof(uint64_t));
+	if (sparse->boundary)
+	{
+		for (i = 0; i < sparse->count; i++)
+		{
+			unsigned off = sparse->entry[i].off;
+			sparse->boundary[off / 64] |= (1ULL << (off % 64));
+		}
+	}
+
+	sparse->ordered = true;
+	for (i = 1; sparse->ordered && (i < sparse->count); i++)
+	{
+		const ofc_sparse_entry_t* prev = &sparse->entry[i - 1];
+		sparse->ordered = ((uintptr_t)&prev->ptr[prev->len]
+			<= (uintptr_t)sparse->entry[i].ptr);
+	}
 }
 
 const char* ofc_sparse_strz(const ofc_sparse_t* sparse)
@@ -304,19 +335,62 @@ bool ofc_sparse_label_find(
 }
 
 
+/* Checks whether any entry starts within [first, last]. */
+static bool ofc_sparse__boundary(
+	const ofc_sparse_t* sparse, unsigned first, unsigned last)
+{
+	if (first > last)
+		return false;
+
+	unsigned fw = (first / 64);
+	unsigned lw = (last  / 64);
+
+	uint64_t fmask = (~0ULL << (first % 64));
+	uint64_t lmask = (~0ULL >> (63 - (last % 64)));
+
+	if (fw == lw)
+		return ((sparse->boundary[fw] & fmask & lmask) != 0);
+
+	if (sparse->boundary[fw] & fmask)
+		return true;
+
+	unsigned w;
+	for (w = (fw + 1); w < lw; w++)
+	{
+		if (sparse->boundary[w])
+			return true;
+	}
+
+	return ((sparse->boundary[lw] & lmask) != 0);
+}
+
 bool ofc_sparse_sequential(
 	const ofc_sparse_t* sparse, const char* ptr, unsigned size)
 {
 	if (!sparse || !ptr)
 		return false;
 
+	if (sparse->boundary)
+	{
+		uintptr_t off = ((uintptr_t)ptr - (uintptr_t)sparse->strz);
+		if ((off > sparse->len)
+			|| ((off + size) > sparse->len))
+			return false;
+
+		if (size <= 1)
+			return true;
+
+		return !ofc_sparse__boundary(
+			sparse, (off + 1), (off + size - 1));
+	}
+
 	ofc_sparse_entry_t entry;
 	unsigned offset;
 
 	if (!ofc_sparse__ptr(
 		sparse, ptr,
 		&entry, &offset, NULL))
-		return NULL;
+		return false;
 
 	return ((offset + size) <= entry.len);
 }
@@ -338,6 +412,82 @@ const char* ofc_sparse_parent_pointer(
 	return &entry.ptr[offset];
 }
 
+static const char* ofc_sparse__child_pointer(
+	const ofc_sparse_t* sparse, const char* pptr)
+{
+	if (!sparse || !sparse->strz || !pptr
+		|| (sparse->count == 0))
+		return NULL;
+
+	uintptr_t p = (uintptr_t)pptr;
+
+	/* Find the first entry which ends after pptr. */
+	unsigned lo = 0, hi = sparse->count;
+	if (sparse->ordered)
+	{
+		while (lo < hi)
+		{
+			unsigned mid = lo + ((hi - lo) / 2);
+			const ofc_sparse_entry_t* e = &sparse->entry[mid];
+			if ((uintptr_t)&e->ptr[e->len] <= p)
+				lo = (mid + 1);
+			else
+				hi = mid;
+		}
+	}
+	else
+	{
+		/* Find the entry holding pptr, or failing that the one
+		   which starts soonest after it. */
+		unsigned next = sparse->count;
+		for (; lo < sparse->count; lo++)
+		{
+			const ofc_sparse_entry_t* e = &sparse->entry[lo];
+			if ((uintptr_t)e->ptr > p)
+			{
+				if ((next >= sparse->count)
+					|| (e->ptr < sparse->entry[next].ptr))
+					next = lo;
+			}
+			else if ((uintptr_t)&e->ptr[e->len] > p)
+			{
+				break;
+			}
+		}
+
+		if (lo >= sparse->count)
+			lo = next;
+	}
+
+	if (lo >= sparse->count)
+		return NULL;
+
+	const ofc_sparse_entry_t* e = &sparse->entry[lo];
+	if ((uintptr_t)e->ptr > p)
+		return &sparse->strz[e->off];
+	return &sparse->strz[e->off + (p - (uintptr_t)e->ptr)];
+}
+
+const char* ofc_sparse_from_file_pointer(
+	const ofc_sparse_t* sparse, const char* fptr)
+{
+	if (!sparse || !fptr)
+		return NULL;
+
+	const char* pptr = fptr;
+	if (sparse->parent)
+	{
+		pptr = ofc_sparse_from_file_pointer(
+			sparse->parent, fptr);
+	}
+	else if (!sparse->file)
+	{
+		return NULL;
+	}
+
+	return ofc_sparse__child_pointer(sparse, pptr);
+}
+
 
 ofc_lang_opts_t ofc_sparse_lang_opts(const ofc_sparse_t* sparse)
 {
@@ -360,7 +510,7 @@ char* ofc_sparse_include_path(
 	const ofc_sparse_t* sparse, const char* path)
 {
 	if (!sparse)
-		return strdup(path);
+		return ofc_strdup(OFC_ALLOC_SPARSE, path);
 
 	return ofc_file_include_path(
 		ofc_sparse__file(sparse), path);
@@ -414,13 +564,10 @@ static const char* ofc_sparse__file_pointer(
 
 	if (sol)
 	{
-		const char* s = sparse->strz;
-		const char* p;
-		for (p = sparse->strz; p < ptr; p++)
-		{
-			if (ofc_is_vspace(*p))
-				s = &p[1];
-		}
+		/* Scan back to the start of the line, not forward from
+		   the start of the file, so each diagnostic stays cheap. */
+		const char* s;
+		for (s = ptr; (s > sparse->strz) && !ofc_is_vspace(s[-1]); s--);
 
 		ofc_sparse_entry_t sol_entry;
 		if (ofc_sparse__ptr(
@@ -432,6 +579,382 @@ static const char* ofc_sparse__file_pointer(
 	return pptr;
 }
 
+const char* ofc_sparse_file_pointer(
+	const ofc_sparse_t* sparse, const char* ptr,
+	const ofc_file_t** file)
+{
+	if (!sparse || !ptr)
+		return NULL;
+
+	if (file) *file = ofc_sparse__file(sparse);
+	return ofc_sparse__file_pointer(sparse, ptr, NULL);
+}
+
+/* Returns false for a line of code, comment is set to the text of
+   a comment line and is NULL for a blank line. */
+static bool ofc_sparse__line_comment(
+	const char* sol, const char* eol,
+	ofc_lang_opts_t opts, const char** comment)
+{
+	*comment = NULL;
+	if (sol >= eol)
+		return true;
+
+	bool fixed = ((opts.form == OFC_LANG_FORM_FIXED)
+		|| (opts.form == OFC_LANG_FORM_TAB));
+	if ((fixed && ((toupper(sol[0]) == 'C') || (sol[0] == '*')
+			|| (opts.debug && (toupper(sol[0]) == 'D'))))
+		|| (sol[0] == '!'))
+	{
+		*comment = &sol[1];
+		return true;
+	}
+
+	unsigned i, t;
+	for (i = 0, t = 0; (&sol[i] < eol) && ofc_is_hspace(sol[i]); i++)
+	{
+		if (sol[i] == '\t')
+			t += 1;
+	}
+
+	if ((&sol[i] >= eol) || (i >= opts.columns))
+		return true;
+
+	if (sol[i] != '!')
+		return false;
+
+	switch (opts.form)
+	{
+		case OFC_LANG_FORM_FIXED:
+			if (i == 5) return false;
+			break;
+		case OFC_LANG_FORM_TAB:
+			if (t != 1) return false;
+			break;
+		default:
+			break;
+	}
+
+	*comment = &sol[i + 1];
+	return true;
+}
+
+/* Returns the text of a comment which follows code on a line,
+   a '!' in a character constant doesn't start one. */
+static const char* ofc_sparse__line_trailing(
+	const char* sol, const char* eol, ofc_lang_opts_t opts)
+{
+	unsigned len = (eol - sol);
+	unsigned i = 0;
+	switch (opts.form)
+	{
+		case OFC_LANG_FORM_FIXED:
+			/* Skip the label and continuation columns. */
+			i = 6;
+			if (len > opts.columns)
+				len = opts.columns;
+			break;
+		case OFC_LANG_FORM_TAB:
+			for (; (i < len) && (sol[i] != '\t'); i++);
+			if ((++i < len) && isdigit(sol[i]))
+				i++;
+			break;
+		default:
+			break;
+	}
+
+	char quote = '\0';
+	for (; i < len; i++)
+	{
+		if (quote != '\0')
+		{
+			if (sol[i] == quote)
+				quote = '\0';
+		}
+		else if ((sol[i] == '\'') || (sol[i] == '"'))
+		{
+			quote = sol[i];
+		}
+		else if (sol[i] == '!')
+		{
+			return &sol[i + 1];
+		}
+	}
+
+	return NULL;
+}
+
+/* Calls func with the comments on each line from sol up to end,
+   both those on lines of their own and those following code. */
+static bool ofc_sparse__comments_lines(
+	const char* sol, const char* end, ofc_lang_opts_t opts, void* param,
+	bool (*func)(const char* base, unsigned size, void* param))
+{
+	while (sol < end)
+	{
+		const char* eol;
+		for (eol = sol; (eol < end) && !ofc_is_vspace(*eol); eol++);
+
+		const char* comment;
+		if (!ofc_sparse__line_comment(sol, eol, opts, &comment))
+			comment = ofc_sparse__line_trailing(sol, eol, opts);
+
+		if (comment)
+		{
+			const char* cend;
+			for (cend = eol; (cend > comment) && ofc_is_hspace(cend[-1]); cend--);
+			if (!func(comment, (cend - comment), param))
+				return false;
+		}
+
+		sol = (eol < end ? &eol[1] : eol);
+	}
+
+	return true;
+}
+
+/* Finds the first of the comment and blank lines directly above fsol. */
+static const char* ofc_sparse__comments_above(
+	const char* strz, const char* fsol, ofc_lang_opts_t opts)
+{
+	const char* first = fsol;
+	while (first > strz)
+	{
+		const char* eol = &first[-1];
+		const char* sol;
+		for (sol = eol; (sol > strz) && !ofc_is_vspace(sol[-1]); sol--);
+
+		const char* comment;
+		if (!ofc_sparse__line_comment(sol, eol, opts, &comment))
+			break;
+		first = sol;
+	}
+
+	return first;
+}
+
+static const char* ofc_sparse__sol(
+	const char* strz, const char* fptr)
+{
+	const char* fsol;
+	for (fsol = fptr; (fsol > strz) && !ofc_is_vspace(fsol[-1]); fsol--);
+	return fsol;
+}
+
+static const char* ofc_sparse__eol(const char* fptr)
+{
+	const char* feol;
+	for (feol = fptr; (*feol != '\0') && !ofc_is_vspace(*feol); feol++);
+	return feol;
+}
+
+bool ofc_sparse_comments(
+	const ofc_sparse_t* sparse, const char* ptr, void* param,
+	bool (*func)(const char* base, unsigned size, void* param))
+{
+	if (!func)
+		return false;
+
+	const ofc_file_t* file = ofc_sparse__file(sparse);
+	const char* strz = ofc_file_get_strz(file);
+	const char* fptr = (sparse && ptr
+		? ofc_sparse__file_pointer(sparse, ptr, NULL) : NULL);
+	if (!strz || !fptr)
+		return true;
+
+	const char* fsol;
+	for (fsol = fptr; (fsol > strz) && !ofc_is_vspace(fsol[-1]); fsol--)
+	{
+		/* Only the first statement on a line has comments above it. */
+		if (fsol[-1] == ';')
+			return true;
+	}
+
+	ofc_lang_opts_t opts = ofc_file_get_lang_opts(file);
+	return ofc_sparse__comments_lines(
+		ofc_sparse__comments_above(strz, fsol, opts),
+		fsol, opts, param, func);
+}
+
+bool ofc_sparse_comments_within(
+	const ofc_sparse_t* sparse, const char* ptr, const char* last,
+	void* param, bool (*func)(const char* base, unsigned size, void* param))
+{
+	if (!func)
+		return false;
+
+	const ofc_file_t* file = ofc_sparse__file(sparse);
+	const char* strz = ofc_file_get_strz(file);
+	const char* fptr = (sparse && ptr
+		? ofc_sparse__file_pointer(sparse, ptr, NULL) : NULL);
+	const char* flast = (fptr && last
+		? ofc_sparse__file_pointer(sparse, last, NULL) : NULL);
+	if (!strz || !flast || (flast < fptr))
+		return true;
+
+	ofc_lang_opts_t opts = ofc_file_get_lang_opts(file);
+
+	const char* lsol = ofc_sparse__sol(strz, flast);
+	if (!ofc_sparse__comments_lines(
+		ofc_sparse__sol(strz, fptr), lsol, opts, param, func))
+		return false;
+
+	/* The last line's comment belongs to any code after last. */
+	const char* leol = ofc_sparse__eol(flast);
+	const char* comment = ofc_sparse__line_trailing(lsol, leol, opts);
+	if (!comment)
+		return true;
+
+	const char* c;
+	for (c = &flast[1]; c < &comment[-1]; c++)
+	{
+		if (!ofc_is_hspace(*c) && (*c != ';'))
+			return true;
+	}
+
+	const char* cend;
+	for (cend = leol; (cend > comment) && ofc_is_hspace(cend[-1]); cend--);
+	return func(comment, (cend - comment), param);
+}
+
+bool ofc_sparse_comments_between(
+	const ofc_sparse_t* sparse, const char* ptr, const char* next,
+	void* param, bool (*func)(const char* base, unsigned size, void* param))
+{
+	if (!func)
+		return false;
+
+	const ofc_file_t* file = ofc_sparse__file(sparse);
+	const char* strz = ofc_file_get_strz(file);
+	const char* fptr = (sparse && ptr
+		? ofc_sparse__file_pointer(sparse, ptr, NULL) : NULL);
+	const char* fnext = (fptr && next
+		? ofc_sparse__file_pointer(sparse, next, NULL) : NULL);
+	if (!strz || !fnext || (fnext <= fptr))
+		return true;
+
+	ofc_lang_opts_t opts = ofc_file_get_lang_opts(file);
+
+	const char* sol = ofc_sparse__eol(fptr);
+	if (*sol != '\0') sol++;
+
+	const char* end = ofc_sparse__comments_above(
+		strz, ofc_sparse__sol(strz, fnext), opts);
+	return ofc_sparse__comments_lines(
+		sol, end, opts, param, func);
+}
+
+bool ofc_sparse_comments_end(
+	const ofc_sparse_t* sparse, void* param,
+	bool (*func)(const char* base, unsigned size, void* param))
+{
+	if (!func)
+		return false;
+
+	const ofc_file_t* file = ofc_sparse__file(sparse);
+	const char* strz = ofc_file_get_strz(file);
+	if (!strz)
+		return true;
+
+	ofc_lang_opts_t opts = ofc_file_get_lang_opts(file);
+
+	const char* end = &strz[strlen(strz)];
+	return ofc_sparse__comments_lines(
+		ofc_sparse__comments_above(strz, end, opts),
+		end, opts, param, func);
+}
+
+/* Skips back over the newline or semicolon ending a statement. */
+static const char* ofc_sparse__ref_last(
+	ofc_sparse_ref_t ref, unsigned size)
+{
+	while ((size > 0)
+		&& (ofc_is_vspace(ref.string.base[size - 1])
+			|| ofc_is_hspace(ref.string.base[size - 1])
+			|| (ref.string.base[size - 1] == ';')))
+		size--;
+
+	return (size > 0 ? &ref.string.base[size - 1] : NULL);
+}
+
+const char* ofc_sparse_ref_last(ofc_sparse_ref_t ref)
+{
+	return ofc_sparse__ref_last(ref, ref.string.size);
+}
+
+const char* ofc_sparse_ref_head_last(ofc_sparse_ref_t ref)
+{
+	unsigned size;
+	for (size = 0; (size < ref.string.size)
+		&& !ofc_is_vspace(ref.string.base[size])
+		&& (ref.string.base[size] != ';'); size++);
+	return ofc_sparse__ref_last(ref, size);
+}
+
+typedef struct
+{
+	ofc_colstr_t* cs;
+	unsigned      indent;
+	bool          trailing;
+} ofc_sparse__comments_print_t;
+
+static bool ofc_sparse__comments_print(
+	const char* base, unsigned size, void* param)
+{
+	ofc_sparse__comments_print_t* print = param;
+	if (print->trailing)
+	{
+		/* Only the first comment can follow the printed code. */
+		print->trailing = false;
+		return ofc_colstr_comment_trailing(
+			print->cs, print->indent, base, size);
+	}
+
+	return ofc_colstr_comment(
+		print->cs, print->indent, base, size);
+}
+
+bool ofc_sparse_comments_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr)
+{
+	ofc_sparse__comments_print_t print =
+		{ .cs = cs, .indent = indent, .trailing = false };
+	return ofc_sparse_comments(sparse, ptr,
+		&print, ofc_sparse__comments_print);
+}
+
+bool ofc_sparse_comments_within_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr, const char* last,
+	bool trailing)
+{
+	ofc_sparse__comments_print_t print =
+		{ .cs = cs, .indent = indent, .trailing = trailing };
+	return ofc_sparse_comments_within(sparse, ptr, last,
+		&print, ofc_sparse__comments_print);
+}
+
+bool ofc_sparse_comments_between_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse, const char* ptr, const char* next)
+{
+	ofc_sparse__comments_print_t print =
+		{ .cs = cs, .indent = indent, .trailing = false };
+	return ofc_sparse_comments_between(sparse, ptr, next,
+		&print, ofc_sparse__comments_print);
+}
+
+bool ofc_sparse_comments_end_print(
+	ofc_colstr_t* cs, unsigned indent,
+	const ofc_sparse_t* sparse)
+{
+	ofc_sparse__comments_print_t print =
+		{ .cs = cs, .indent = indent, .trailing = false };
+	return ofc_sparse_comments_end(sparse,
+		&print, ofc_sparse__comments_print);
+}
+
 void ofc_sparse_error_va(
 	const ofc_sparse_t* sparse, ofc_str_ref_t ref,
 	const char* format, va_list args)
@@ -19,17 +19,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ofc/alloc.h"
 #include "ofc/string.h"
 
 ofc_string_t* ofc_string_create(const char* base, unsigned size)
 {
 	ofc_string_t* string
-		= (ofc_string_t*)malloc(
+		= (ofc_string_t*)ofc_alloc(OFC_ALLOC_MISC,
 			sizeof(ofc_string_t));
 	if (!string)
 		return NULL;
 
-	string->base = (size == 0 ? NULL : (char*)malloc(size + 1));
+	string->base = (size == 0 ? NULL : (char*)ofc_alloc(OFC_ALLOC_MISC, size + 1));
 	string->size = (string->base ? size : 0);
 	if (string->base)
 	{
@@ -58,8 +59,8 @@ void ofc_string_delete(ofc_string_t* string)
 	if (!string)
 		return;
 
-	free(string->base);
-	free(string);
+	ofc_free(string->base);
+	ofc_free(string);
 }
 
 
@@ -14,23 +14,19 @@
  */
 
 #include "ofc/target.h"
-
-static unsigned ofc_target__logical_size = 4;
-static unsigned ofc_target__integer_size = 4;
-static unsigned ofc_target__real_size    = 4;
-static unsigned ofc_target__pointer_size = sizeof(void*);
+#include "ofc/context.h"
 
 bool ofc_target_logical_size_set(unsigned size)
 {
 	if (size == 0)
 		return false;
-	ofc_target__logical_size = size;
+	ofc_context_current()->target_logical_size = size;
 	return true;
 }
 
 unsigned ofc_target_logical_size_get(void)
 {
-	return ofc_target__logical_size;
+	return ofc_context_current()->target_logical_size;
 }
 
 
@@ -38,13 +34,13 @@ bool ofc_target_integer_size_set(unsigned size)
 {
 	if (size == 0)
 		return false;
-	ofc_target__integer_size = size;
+	ofc_context_current()->target_integer_size = size;
 	return true;
 }
 
 unsigned ofc_target_integer_size_get(void)
 {
-	return ofc_target__integer_size;
+	return ofc_context_current()->target_integer_size;
 }
 
 
@@ -52,24 +48,24 @@ bool ofc_target_real_size_set(unsigned size)
 {
 	if (size == 0)
 		return false;
-	ofc_target__real_size = size;
+	ofc_context_current()->target_real_size = size;
 	return true;
 }
 
 unsigned ofc_target_real_size_get(void)
 {
-	return ofc_target__real_size;
+	return ofc_context_current()->target_real_size;
 }
 
 bool ofc_target_pointer_size_set(unsigned size)
 {
 	if (size == 0)
 		return false;
-	ofc_target__pointer_size = size;
+	ofc_context_current()->target_pointer_size = size;
 	return true;
 }
 
 unsigned ofc_target_pointer_size_get(void)
 {
-	return ofc_target__pointer_size;
+	return ofc_context_current()->target_pointer_size;
 }
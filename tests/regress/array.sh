@@ -0,0 +1,141 @@
+# Array shapes are resolved once with 64-bit extents, check totals,
+# strides and subscript conversion against the declared bounds, that
+# arrays too big for 32 bits aren't mistaken for dynamic ones and that
+# assumed and adjustable shapes don't resolve.
+
+fail() { echo "$*"; exit 1; }
+
+cat > arr.f <<'END'
+      PROGRAM A
+      INTEGER N
+      PARAMETER (N = 4)
+      REAL R(-2:3, 0:4)
+      INTEGER C(N, 2 * N)
+      LOGICAL*1 BIG(100000, 100000)
+      REAL V(3)
+      DATA R(-2, 0), R(3, 4) /1.0, 2.0/
+      DATA V /3 * 0.5/
+      DATA ((C(I, J), I = 1, N), J = 1, 2) /8 * 7/
+      BIG(1, 1) = .TRUE.
+      PRINT *, R, C, V, BIG(100000, 100000)
+      END
+
+      SUBROUTINE S(X, M, Y)
+      INTEGER M
+      REAL X(*), Y(M)
+      X(1) = Y(M)
+      END
+END
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <ofc/context.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+static const ofc_sema_array_t* array(
+	const ofc_sema_scope_t* scope, const char* name)
+{
+	const ofc_sema_decl_t* decl = ofc_sema_scope_decl_find(
+		scope, ofc_str_ref_from_strz(name), true);
+	return (decl ? decl->array : NULL);
+}
+
+int main(void)
+{
+	static char text[4096];
+	FILE* fp = fopen("arr.f", "r");
+	if (!fp) return 1;
+	text[fread(text, 1, (sizeof(text) - 1), fp)] = '\0';
+	fclose(fp);
+
+	ofc_context_t* context = ofc_context_create(NULL);
+	if (!context) return 1;
+	ofc_context_t* previous = ofc_context_enter(context);
+
+	ofc_lang_opts_t opts = OFC_LANG_OPTS_F77;
+	const ofc_sema_scope_t* root
+		= ofc_context_analyse(context, "arr.f", text, &opts);
+	CHECK(root && root->child && (root->child->count == 1));
+	CHECK(ofc_diag_count(ofc_context_diag(context), OFC_DIAG_ERROR) == 0);
+	if (failed) return 1;
+
+	const ofc_sema_scope_t* program = root->child->scope[0];
+	const ofc_sema_decl_t*  decl    = ofc_sema_scope_decl_find(
+		root, ofc_str_ref_from_strz("S"), true);
+	const ofc_sema_scope_t* sub     = (decl ? decl->func : NULL);
+	CHECK(sub);
+	if (failed) return 1;
+
+	const ofc_sema_array_t* r = array(program, "R");
+	unsigned total;
+	uint64_t total64;
+	CHECK(r && ofc_sema_array_shape_resolve(r));
+	CHECK(ofc_sema_array_total(r, &total) && (total == 30));
+	CHECK(r->segment[0].lower == -2);
+	CHECK((r->segment[0].extent == 6) && (r->segment[0].stride == 1));
+	CHECK((r->segment[1].extent == 5) && (r->segment[1].stride == 6));
+
+	/* Every subscript maps to its column-major offset and back. */
+	int64_t i, j;
+	for (j = 0; j <= 4; j++)
+	{
+		for (i = -2; i <= 3; i++)
+		{
+			int64_t subscript[2] = { i, j };
+			int64_t back[2];
+			uint64_t offset;
+			CHECK(ofc_sema_array_subscript_offset(r, subscript, &offset)
+				&& (offset == (uint64_t)((i + 2) + (j * 6))));
+			CHECK(ofc_sema_array_offset_subscript(r, offset, back)
+				&& (back[0] == i) && (back[1] == j));
+		}
+	}
+
+	int64_t outside[2] = { 4, 0 };
+	CHECK(!ofc_sema_array_subscript_offset(r, outside, NULL));
+	CHECK(!ofc_sema_array_offset_subscript(r, 30, outside));
+
+	const ofc_sema_array_t* c = array(program, "C");
+	CHECK(c && ofc_sema_array_total(c, &total) && (total == 32));
+
+	/* Too big for 32 bits, but still a fixed shape. */
+	const ofc_sema_array_t* big = array(program, "BIG");
+	CHECK(big && ofc_sema_array_shape_resolve(big));
+	CHECK(ofc_sema_array_total64(big, &total64)
+		&& (total64 == 10000000000ULL));
+	CHECK(!ofc_sema_array_total(big, &total));
+	int64_t last[2] = { 100000, 100000 };
+	uint64_t offset;
+	CHECK(ofc_sema_array_subscript_offset(big, last, &offset)
+		&& (offset == 9999999999ULL));
+
+	const ofc_sema_array_t* x = array(sub, "X");
+	const ofc_sema_array_t* y = array(sub, "Y");
+	CHECK(x && !ofc_sema_array_shape_resolve(x));
+	CHECK(y && !ofc_sema_array_shape_resolve(y));
+	CHECK(!ofc_sema_array_total64(y, &total64));
+
+	ofc_context_leave(previous);
+	ofc_context_delete(context);
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Array shapes were wrong"
+
+"$OFC" --sema-tree arr.f > out.f 2> err.txt \
+	|| fail "Failed to analyse arr.f: $(cat err.txt)"
+for line in "DATA R(-2, 0), R(3, 4)/1.0, 2.0/" \
+	"DIMENSION(100000, 100000) :: BIG" \
+	"C(4, 1), C(1, 2)"
+do
+	grep -qF "$line" out.f || fail "Expected '$line' in: $(cat out.f)"
+done
+
+exit 0
@@ -0,0 +1,46 @@
+# Name resolution is cached per scope: each unit resolves a name under its
+# own IMPLICIT rules, and declarations made after a name was first looked
+# up are seen by later lookups.
+
+fail() { echo "$*"; exit 1; }
+
+cat > cache.f <<'END'
+      SUBROUTINE A
+      IMPLICIT INTEGER (X)
+      X = 1
+      Y = X
+      END
+      SUBROUTINE B
+      X = 1
+      Y = X
+      END
+      SUBROUTINE C
+      IMPLICIT DOUBLE PRECISION (D)
+      DIMENSION D(3)
+      D(1) = 1
+      E = D(1)
+      F(Q) = Q + E
+      G = F(E)
+      END
+END
+
+"$OFC" --sema-tree --time-phases cache.f > out.f 2> err.txt \
+	|| fail "Failed to analyse cache.f: $(cat err.txt)"
+
+# Pulls the declarations of one unit out of the printed tree.
+unit() {
+	sed -n "/SUBROUTINE $1()/,/END SUBROUTINE $1/p" out.f
+}
+
+unit A | grep -q "INTEGER :: X" || fail "X isn't INTEGER in A: $(unit A)"
+unit B | grep -q "REAL :: X" || fail "X isn't REAL in B: $(unit B)"
+unit C | grep -q "DOUBLE PRECISION, DIMENSION(3) :: D" \
+	|| fail "D lost its type or shape in C: $(unit C)"
+unit C | grep -q "D(1) = 1.0D0" || fail "D(1) isn't DOUBLE PRECISION: $(unit C)"
+unit C | grep -q "REAL :: F" || fail "Statement function F isn't REAL: $(unit C)"
+
+hits=$(sed -n 's/^Cache:scope: \([0-9]*\) hits.*/\1/p' err.txt)
+[ -n "$hits" ] && [ "$hits" -gt 0 ] \
+	|| fail "Repeated lookups didn't hit the cache: $(grep Cache err.txt)"
+
+exit 0
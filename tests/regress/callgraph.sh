@@ -0,0 +1,164 @@
+# Calls are recorded in a call graph and checked against the callee's
+# definition, check the warnings for each kind of mismatch and that
+# the graph is printed and written with the right edges.
+
+fail() { echo "$*"; exit 1; }
+
+cat > cg.f <<'END'
+      PROGRAM MAIN
+      REAL X(10), Y
+      INTEGER K
+      CALL A(1.0, 2)
+      CALL A(1.0, 2)
+      CALL A(1.0)
+      CALL A(1, 2)
+      CALL B(X)
+      CALL B(Y)
+      CALL EXT(Y)
+      Y = G(2)
+      CALL F(1)
+      CALL R(*10, K)
+      CALL R(K, K)
+   10 CONTINUE
+      END
+
+      SUBROUTINE A(P, Q)
+      REAL P
+      INTEGER Q
+      CALL B(P)
+      END
+
+      SUBROUTINE B(S)
+      REAL S
+      END
+
+      INTEGER FUNCTION F(N)
+      INTEGER N
+      F = N
+      END
+
+      INTEGER FUNCTION G(N)
+      INTEGER N
+      G = N
+      END
+
+      SUBROUTINE R(*, M)
+      INTEGER M
+      RETURN 1
+      END
+END
+
+"$OFC" --call-graph-dot cg.f > dot.txt 2> err.txt \
+	|| fail "Failed to analyse cg.f: $(cat err.txt)"
+
+for warning in \
+	"cg.f:6,6: Call to 'A' passes 1 arguments, but it takes 2" \
+	"cg.f:7,6: Argument 1 of 'A' is INTEGER, but 'P' is REAL" \
+	"cg.f:8,6: Argument 1 of 'B' is an array, but 'S' is scalar" \
+	"cg.f:11,10: Return type of 'G' is REAL, but its definition returns INTEGER" \
+	"cg.f:12,6: CALL to FUNCTION 'F'" \
+	"cg.f:14,6: Argument 1 of 'R' must be an alternate return label"
+do
+	grep -qF "Warning:$warning" err.txt \
+		|| fail "Expected '$warning' in: $(cat err.txt)"
+done
+[ "$(grep -c "^Warning" err.txt)" -eq 7 ] \
+	|| fail "Expected 7 warnings in: $(cat err.txt)"
+
+cat > expect.txt <<'END'
+digraph callgraph {
+	n0 [label="MAIN", shape=doubleoctagon];
+	n1 [label="A", shape=box];
+	n2 [label="B", shape=box];
+	n3 [label="F", shape=ellipse];
+	n4 [label="G", shape=ellipse];
+	n5 [label="R", shape=box];
+	n6 [label="EXT", shape=box, style=dashed];
+	n0 -> n1 [label="4", color=red];
+	n0 -> n2 [label="2", color=red];
+	n0 -> n3 [color=red];
+	n0 -> n4 [color=red];
+	n0 -> n5 [label="2", color=red];
+	n0 -> n6;
+	n1 -> n2;
+}
+END
+cmp -s expect.txt dot.txt \
+	|| fail "Wrong DOT call graph: $(diff expect.txt dot.txt)"
+
+cat > read.c <<'END'
+#include <stdio.h>
+#include <string.h>
+
+static unsigned get(FILE* fp, unsigned size)
+{
+	unsigned value = 0, i;
+	for (i = 0; i < size; i++)
+		value |= ((unsigned)fgetc(fp) << (i * 8));
+	return value;
+}
+
+int main(void)
+{
+	char magic[4];
+	if ((fread(magic, 1, 4, stdin) != 4)
+		|| (memcmp(magic, "OFCG", 4) != 0)
+		|| (get(stdin, 4) != 1))
+		return 1;
+
+	unsigned nodes = get(stdin, 4);
+	unsigned edges = get(stdin, 4);
+	char name[64][64];
+	unsigned i;
+	if (nodes > 64) return 1;
+	for (i = 0; i < nodes; i++)
+	{
+		unsigned kind = get(stdin, 1);
+		unsigned len  = get(stdin, 2);
+		if ((len >= 64) || (fread(name[i], 1, len, stdin) != len))
+			return 1;
+		name[i][len] = '\0';
+		printf("%s %u\n", name[i], kind);
+	}
+
+	for (i = 0; i < edges; i++)
+	{
+		unsigned caller = get(stdin, 4);
+		unsigned callee = get(stdin, 4);
+		unsigned count  = get(stdin, 4);
+		unsigned flags  = get(stdin, 1);
+		if ((caller >= nodes) || (callee >= nodes))
+			return 1;
+		printf("%s -> %s %u %u\n",
+			name[caller], name[callee], count, flags);
+	}
+
+	return ((fgetc(stdin) == EOF) ? 0 : 1);
+}
+END
+
+${CC:-cc} -o read read.c || fail "Failed to build read"
+"$OFC" --call-graph-bin cg.f > graph.bin 2> /dev/null \
+	|| fail "Failed to write the binary call graph"
+./read < graph.bin > bin.txt || fail "Malformed binary call graph"
+
+cat > expect.txt <<'END'
+MAIN 2
+A 4
+B 4
+F 5
+G 5
+R 4
+EXT 0
+MAIN -> A 4 1
+MAIN -> B 2 1
+MAIN -> F 1 1
+MAIN -> G 1 1
+MAIN -> R 2 1
+MAIN -> EXT 1 0
+A -> B 1 0
+END
+cmp -s expect.txt bin.txt \
+	|| fail "Wrong binary call graph: $(diff expect.txt bin.txt)"
+
+exit 0
@@ -0,0 +1,105 @@
+# The --dataflow pass follows IF blocks, GO TO and DO loops to find
+# reads which may come before a write and writes which are never read,
+# check what it reports and that names other units can see are skipped.
+
+fail() { echo "$*"; exit 1; }
+
+cat > df.f <<'END'
+      SUBROUTINE S(N, R)
+      INTEGER N, I, J, K, L, M
+      REAL R, A, B, C
+      IF (N .GT. 0) THEN
+        A = 1.0
+      END IF
+      R = A
+      B = 2.0
+      B = 3.0
+      R = R + B
+      DO 10 I = 1, N
+        IF (I .EQ. 1) J = I
+        R = R + J
+   10 CONTINUE
+      K = 1
+      IF (N .LT. 0) GO TO 20
+      K = 2
+   20 R = R + K
+      L = 5
+      M = 1
+   30 M = M + 1
+      IF (M .LT. N) GO TO 30
+      R = R + M
+      C = 1.0
+      C = C + 1.0
+      R = R + C
+      END
+
+      PROGRAM P
+      REAL X, Y
+      INTEGER Z
+      X = 1.0
+      IF (X .GT. 0.0) THEN
+        Y = 1.0
+      ELSE
+        Y = 2.0
+      END IF
+      Z = INT(Y)
+      Z = 3
+      PRINT *, Y, Z
+      END
+END
+
+"$OFC" df.f > /dev/null 2> err.txt \
+	|| fail "Failed to analyse df.f: $(cat err.txt)"
+grep -q -E "before it's set|never used" err.txt \
+	&& fail "Dataflow warnings without --dataflow: $(cat err.txt)"
+
+"$OFC" --dataflow df.f > /dev/null 2> err.txt \
+	|| fail "Failed to analyse df.f with --dataflow: $(cat err.txt)"
+grep -E "before it's set|never used" err.txt > got.txt
+cat > expect.txt <<'END'
+Warning:df.f:7,10: Variable 'A' may be used before it's set
+Warning:df.f:13,16: Variable 'J' may be used before it's set
+Warning:df.f:8,6: Value assigned to 'B' is never used
+Warning:df.f:19,6: Variable 'L' is set but never used
+Warning:df.f:38,6: Value assigned to 'Z' is never used
+END
+diff expect.txt got.txt > /dev/null \
+	|| fail "Unexpected dataflow warnings: $(cat err.txt)"
+
+# Dummy arguments, COMMON, SAVE, DATA, EQUIVALENCE and function
+# results are used outside the unit, a read which sema already reports
+# as uninitialized isn't reported again.
+cat > ex.f <<'END'
+      SUBROUTINE T(D)
+      REAL D, E, F, G, H, Q
+      COMMON /BLK/ E
+      SAVE F
+      DATA G /1.0/
+      EQUIVALENCE (H, Q)
+      D = 1.0
+      E = 2.0
+      F = 3.0
+      G = 4.0
+      H = 5.0
+      END
+
+      REAL FUNCTION W()
+      W = 1.0
+      END
+
+      SUBROUTINE U(R)
+      REAL R, V
+      R = V
+      R = R + V
+      END
+END
+
+"$OFC" --dataflow ex.f > /dev/null 2> err.txt \
+	|| fail "Failed to analyse ex.f: $(cat err.txt)"
+grep -q -E "before it's set|never used" err.txt \
+	&& fail "Unexpected dataflow warnings: $(cat err.txt)"
+[ "$(grep -c "^Warning" err.txt)" -eq 1 ] \
+	&& grep -q "ex.f:20,10: Referencing uninitialized variable 'V'" err.txt \
+	|| fail "Expected one uninitialized read of 'V' in: $(cat err.txt)"
+
+exit 0
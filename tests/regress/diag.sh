@@ -0,0 +1,60 @@
+# Diagnostics are collected in a sink which drops duplicates, limits how
+# often a warning repeats, and sorts by position for JSON and SARIF output
+# written to stderr.
+
+fail() { echo "$*"; exit 1; }
+
+cat > diag.f <<'END'
+      PROGRAM P
+      INTEGER I, J, K
+      CALL S(1, 2)
+      I = 1.5
+      J = 2.5
+      K = 3.5
+      END
+      SUBROUTINE S(A)
+      INTEGER A
+      PRINT *, A
+      END
+END
+
+# The call is checked once the whole file is analysed, so it's raised
+# last but sorted first.
+"$OFC" --diag-json diag.f > /dev/null 2> out.json \
+	|| fail "Failed to analyse diag.f: $(cat out.json)"
+lines=$(sed -n 's/.*"line": \([0-9]*\),.*/\1/p' out.json | tr '\n' ' ')
+[ "$lines" = "3 4 5 6 " ] || fail "JSON diagnostics aren't sorted: $(cat out.json)"
+grep -q '"message": "Call to '"'"'S'"'"' passes 2 arguments, but it takes 1"' out.json \
+	|| fail "Call wasn't checked: $(cat out.json)"
+grep -q '"suppressed": 0' out.json || fail "Unexpected suppression: $(cat out.json)"
+
+"$OFC" --diag-json --diag-limit 1 diag.f > /dev/null 2> out.json \
+	|| fail "Failed to analyse diag.f with a limit: $(cat out.json)"
+[ "$(grep -c '"severity"' out.json)" -eq 2 ] \
+	|| fail "Repeated warnings weren't limited: $(cat out.json)"
+grep -q '"suppressed": 2' out.json || fail "Suppressed count is wrong: $(cat out.json)"
+
+"$OFC" --diag-sarif diag.f > /dev/null 2> out.sarif \
+	|| fail "Failed to analyse diag.f as SARIF: $(cat out.sarif)"
+grep -q '"version": "2.1.0"' out.sarif || fail "Not SARIF 2.1.0: $(cat out.sarif)"
+lines=$(sed -n 's/.*"startLine": \([0-9]*\),.*/\1/p' out.sarif | tr '\n' ' ')
+[ "$lines" = "3 4 5 6 " ] || fail "SARIF results aren't sorted: $(cat out.sarif)"
+
+"$OFC" diag.f > /dev/null 2> err.txt || fail "Failed to analyse diag.f as text"
+[ "$(grep -c '^Warning:diag.f:' err.txt)" -eq 4 ] \
+	|| fail "Expected four text warnings: $(cat err.txt)"
+
+cat > error.f <<'END'
+      PROGRAM P
+      INTEGER I
+      CHARACTER C
+      I = C + 1
+      END
+END
+
+"$OFC" --diag-json error.f > /dev/null 2> out.json \
+	&& fail "An error didn't fail the run"
+grep -q '"severity": "error", "file": "error.f", "line": 4' out.json \
+	|| fail "Error wasn't reported: $(cat out.json)"
+
+exit 0
@@ -0,0 +1,59 @@
+# --emit-f90 keeps comments before declarations, trailing comments, those
+# just before END and those after the last END, each exactly once.
+
+fail() { echo "$*"; exit 1; }
+
+cat > emit.f <<'END'
+C Before the program
+      PROGRAM P ! After PROGRAM
+C Before declarations
+      INTEGER I, J ! After a declaration
+      J = 0
+      DO 10 I = 1, 3 ! After DO
+C Inside the loop
+        J = J + I ! After an assignment
+   10 CONTINUE
+      IF (J .GT. 0) THEN
+        J = 1
+C Before ELSE
+      ELSE
+        J = 2
+C Before END IF
+      END IF
+      CALL S(J)
+C Before END
+      END ! After END
+      SUBROUTINE S(K)
+      INTEGER K
+      PRINT *, K
+      END
+C After the last END
+END
+
+"$OFC" --emit-f90 out emit.f 2> err.txt \
+	|| fail "Failed to convert emit.f: $(cat err.txt)"
+[ -s err.txt ] && fail "Unexpected diagnostics: $(cat err.txt)"
+
+for c in "Before the program" "After PROGRAM" "Before declarations" \
+	"After a declaration" "After DO" "Inside the loop" \
+	"After an assignment" "Before ELSE" "Before END IF" "Before END" \
+	"After END" "After the last END"
+do
+	n=$(grep -c "! $c\$" out/emit.f90)
+	[ "$n" = 1 ] || fail "Comment '$c' printed $n times"
+done
+
+grep -q "^PROGRAM P ! After PROGRAM\$" out/emit.f90 \
+	|| fail "Comment after PROGRAM isn't on its line"
+grep -q "J = J + I ! After an assignment\$" out/emit.f90 \
+	|| fail "Comment after an assignment isn't on its line"
+grep -B1 "^END PROGRAM P ! After END\$" out/emit.f90 | grep -q "! Before END\$" \
+	|| fail "Comment before END isn't just before it"
+[ "$(tail -n 1 out/emit.f90)" = "! After the last END" ] \
+	|| fail "Comment after the last END isn't at the end of the file"
+
+"$OFC" out/emit.f90 > /dev/null 2> err.txt \
+	|| fail "Failed to analyse the converted source: $(cat err.txt)"
+[ -s err.txt ] && fail "Converted source has diagnostics: $(cat err.txt)"
+
+exit 0
@@ -0,0 +1,149 @@
+# Expression operands are memoized while parsing, check that precedence
+# and associativity come out right by folding constants, that deep
+# nesting parses, and that parse warnings are neither lost nor repeated.
+
+fail() { echo "$*"; exit 1; }
+
+ones=$(i=1; s="1"; while [ $i -lt 100 ]; do s="$s + 1"; i=$((i + 1)); done; echo "$s")
+open=$(i=0; while [ $i -lt 40 ]; do printf "("; i=$((i + 1)); done)
+close=$(i=0; while [ $i -lt 40 ]; do printf ")"; i=$((i + 1)); done)
+
+{
+	echo "      PROGRAM E"
+	echo "      INTEGER I1, I2, I3, I4, I5, I6, I7, I8"
+	echo "      LOGICAL L1, L2, L3, L4"
+	echo "      PARAMETER (I1 = 2 ** 3 ** 2)"
+	echo "      PARAMETER (I2 = 10 - 4 - 3)"
+	echo "      PARAMETER (I3 = 2 + 3 * 4 - 6 / 2)"
+	echo "      PARAMETER (I4 = -2 ** 2)"
+	echo "      PARAMETER (I5 = 100 / 10 / 5)"
+	echo "      PARAMETER (I6 = -(3 - 5) * 2)"
+	echo "      PARAMETER (L1 = .NOT. .TRUE. .AND. .FALSE.)"
+	echo "      PARAMETER (L2 = .TRUE. .OR. .FALSE. .AND. .FALSE.)"
+	echo "      PARAMETER (L3 = 1 + 2 .EQ. 3 .AND. 2 * 3 .GT. 5)"
+	echo "      PARAMETER (L4 = .TRUE. .EQV. .FALSE. .NEQV. .TRUE.)"
+	echo "      PARAMETER (I7 ="
+	echo "$ones" | fold -w 60 | sed 's/^/     \&/'
+	echo "     &)"
+	echo "      PARAMETER (I8 ="
+	echo "     &$open"
+	echo "     &7"
+	echo "     &$close)"
+	echo "      LOGICAL L"
+	echo "      REAL X, Y"
+	echo "      X = 1.0"
+	echo "      Y = 2.0"
+	echo "      L = X . LT. Y"
+	echo "      L = X . LT. Y .OR. X .GT. Y"
+	echo "      PRINT *, I1, I2, I3, I4, I5, I6, I7, I8, L1, L2, L3, L4, L"
+	echo "      END"
+} > expr.f
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <string.h>
+#include <ofc/context.h>
+
+static unsigned failed = 0;
+
+static const ofc_sema_typeval_t* value(
+	const ofc_sema_scope_t* scope, const char* name)
+{
+	const ofc_sema_decl_t* decl = ofc_sema_scope_decl_find(
+		scope, ofc_str_ref_from_strz(name), true);
+	if (!decl || !decl->is_parameter
+		|| decl->init.is_substring)
+		return NULL;
+	return ofc_sema_expr_constant(decl->init.expr);
+}
+
+static void integer(
+	const ofc_sema_scope_t* scope, const char* name, int64_t expect)
+{
+	int64_t i;
+	if (!ofc_sema_typeval_get_integer(value(scope, name), &i))
+	{
+		printf("%s isn't constant\n", name);
+		failed++;
+	}
+	else if (i != expect)
+	{
+		printf("%s is %lld, expected %lld\n",
+			name, (long long)i, (long long)expect);
+		failed++;
+	}
+}
+
+static void logical(
+	const ofc_sema_scope_t* scope, const char* name, bool expect)
+{
+	bool l;
+	if (!ofc_sema_typeval_get_logical(value(scope, name), &l))
+	{
+		printf("%s isn't constant\n", name);
+		failed++;
+	}
+	else if (l != expect)
+	{
+		printf("%s is %d, expected %d\n", name, l, expect);
+		failed++;
+	}
+}
+
+int main(void)
+{
+	static char text[16384];
+	FILE* fp = fopen("expr.f", "r");
+	if (!fp) return 1;
+	text[fread(text, 1, (sizeof(text) - 1), fp)] = '\0';
+	fclose(fp);
+
+	ofc_context_t* context = ofc_context_create(NULL);
+	if (!context) return 1;
+	ofc_context_t* previous = ofc_context_enter(context);
+
+	ofc_lang_opts_t opts = OFC_LANG_OPTS_F77;
+	const ofc_sema_scope_t* root
+		= ofc_context_analyse(context, "expr.f", text, &opts);
+	if (!root || !root->child || (root->child->count != 1)
+		|| (ofc_diag_count(ofc_context_diag(context), OFC_DIAG_ERROR) != 0))
+	{
+		printf("Failed to analyse expr.f\n");
+		return 1;
+	}
+
+	const ofc_sema_scope_t* program = root->child->scope[0];
+	integer(program, "I1", 512);
+	integer(program, "I2", 3);
+	integer(program, "I3", 11);
+	integer(program, "I4", -4);
+	integer(program, "I5", 2);
+	integer(program, "I6", 4);
+	integer(program, "I7", 100);
+	integer(program, "I8", 7);
+	logical(program, "L1", false);
+	logical(program, "L2", true);
+	logical(program, "L3", true);
+	logical(program, "L4", true);
+
+	ofc_context_leave(previous);
+	ofc_context_delete(context);
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Expressions were parsed wrongly"
+
+"$OFC" --parse-tree expr.f > out.f 2> err.txt \
+	|| fail "Failed to parse expr.f: $(cat err.txt)"
+[ "$(grep -c "Operators shouldn't contain whitespace" err.txt)" -eq 2 ] \
+	&& grep -q "expr.f:31,12:" err.txt && grep -q "expr.f:32,12:" err.txt \
+	|| fail "Expected one operator warning per line in: $(cat err.txt)"
+
+"$OFC" --parse-tree out.f > again.f 2> err.txt \
+	|| fail "Failed to parse the printed source: $(cat err.txt)"
+cmp -s out.f again.f || fail "Printed source doesn't round trip"
+
+exit 0
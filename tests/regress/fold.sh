@@ -0,0 +1,96 @@
+# Constant folding: the integer and real kernels are exact at the boundary
+# of each kind, and literals of different kinds fold in either order.
+
+fail() { echo "$*"; exit 1; }
+
+# Folds a PARAMETER expression into an INTEGER*8, prints the diagnostics.
+fold() {
+	cat > fold.f <<END
+      PROGRAM P
+      INTEGER*8 A
+      PARAMETER (A = $1)
+      PRINT *, A
+      END
+END
+	"$OFC" fold.f 2>&1
+}
+
+for expr in \
+	"4611686018427387903_8 * 2" "2 * 4611686018427387903_8" \
+	"9223372036854775806_8 + 1" "1 + 9223372036854775806_8" \
+	"-9223372036854775807_8 - 1" "3037000499_8 * 3037000499_8"
+do
+	out=$(fold "$expr")
+	[ -z "$out" ] || fail "Folding $expr failed: $out"
+done
+
+for case in \
+	"multiply:4611686018427387904_8 * 2" \
+	"multiply:2 * 4611686018427387904_8" \
+	"multiply:2_8 * 4611686018427387904_8" \
+	"add:9223372036854775807_8 + 1" \
+	"add:1 + 9223372036854775807_8" \
+	"subtract:-9223372036854775807_8 - 2"
+do
+	op=${case%%:*}
+	expr=${case#*:}
+	fold "$expr" | grep -q "Overflow in constant $op" \
+		|| fail "Folding $expr didn't overflow: $(fold "$expr")"
+done
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <stdint.h>
+#include <ofc/sema.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+int main(void)
+{
+	int64_t r;
+	CHECK(ofc_sema_fold_integer_multiply(8,
+		INT64_C(4611686018427387903), 2, &r)
+		&& (r == INT64_C(9223372036854775806)));
+	CHECK(!ofc_sema_fold_integer_multiply(8,
+		INT64_C(4611686018427387904), 2, &r));
+	CHECK(ofc_sema_fold_integer_add(8, (INT64_MAX - 1), 1, &r)
+		&& (r == INT64_MAX));
+	CHECK(!ofc_sema_fold_integer_add(8, INT64_MAX, 1, &r));
+	CHECK(ofc_sema_fold_integer_subtract(8, -INT64_MAX, 1, &r)
+		&& (r == INT64_MIN));
+	CHECK(!ofc_sema_fold_integer_subtract(8, INT64_MIN, 1, &r));
+	CHECK(!ofc_sema_fold_integer_negate(8, INT64_MIN, &r));
+	CHECK(!ofc_sema_fold_integer_divide(8, INT64_MIN, -1, &r));
+	CHECK(ofc_sema_fold_integer_power(8, 2, 62, &r)
+		&& (r == (INT64_C(1) << 62)));
+	CHECK(!ofc_sema_fold_integer_power(8, 2, 63, &r));
+
+	CHECK(ofc_sema_fold_integer_add(4, INT32_MAX, 0, &r));
+	CHECK(!ofc_sema_fold_integer_add(4, INT32_MAX, 1, &r));
+	CHECK(ofc_sema_fold_integer_add(2, -32767, -1, &r)
+		&& (r == -32768));
+	CHECK(!ofc_sema_fold_integer_multiply(2, 256, 128, &r));
+
+	ofc_real_t a, b;
+	CHECK(ofc_sema_fold_real_parse(8, "0.1", 3, &a)
+		&& ofc_sema_fold_real_parse(8, "0.2", 3, &b)
+		&& (ofc_sema_fold_real_add(8, a, b) == (ofc_real_t)(0.1 + 0.2)));
+	CHECK(ofc_sema_fold_real_divide(4, 1, 3)
+		== (ofc_real_t)(1.0f / 3.0f));
+	CHECK(ofc_sema_fold_real_divide(8, 1, 3)
+		== (ofc_real_t)(1.0 / 3.0));
+	CHECK(ofc_sema_fold_real_divide(16, 1, 3)
+		== ((ofc_real_t)1 / (ofc_real_t)3));
+
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Fold kernels gave the wrong results"
+
+exit 0
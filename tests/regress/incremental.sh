@@ -0,0 +1,71 @@
+# Unchanged program units reuse the diagnostics cached by --incremental,
+# check they're reused when they should be, and that the diagnostics
+# always match a run without the cache, even after edits.
+
+fail() { echo "$*"; exit 1; }
+
+cat > inc.f <<'END'
+      PROGRAM P
+      REAL X
+      X = H(1.0)
+      CALL A(X)
+      END
+
+      SUBROUTINE A(Y)
+      REAL Y
+      Y = Q(Y)
+      CALL B(1.0)
+      END
+
+      SUBROUTINE B(N)
+      INTEGER N
+      N = N + 1
+      END
+END
+
+# Checks the diagnostics match a run without the cache and that the
+# expected number of units were reused. Text diagnostics are written as
+# they're added, which puts cached ones first, so compare sorted JSON.
+check()
+{
+	"$OFC" --diag-json inc.f > /dev/null 2> expect.txt
+	"$OFC" --diag-json --incremental cache --time-phases inc.f \
+		> /dev/null 2> err.txt \
+		|| fail "Failed to analyse inc.f: $(cat err.txt)"
+	grep -v "^Time:\|^Cache:" err.txt > diag.txt
+	cmp -s expect.txt diag.txt \
+		|| fail "Diagnostics differ from a full run: $(diff expect.txt diag.txt)"
+	grep -q "^Cache:incremental: $1 of $2 units reused$" err.txt \
+		|| fail "Expected $1 of $2 units reused in: $(cat err.txt)"
+}
+
+check 0 3
+[ "$(grep -c '"severity": "warning"' diag.txt)" -eq 3 ] \
+	|| fail "Expected 3 warnings in: $(cat diag.txt)"
+grep -q "Argument 1 of 'B' is REAL" diag.txt \
+	|| fail "Expected a call warning in: $(cat diag.txt)"
+
+check 3 3
+
+# An edit above a unit moves its diagnostics without invalidating it.
+sed 's/^      X = H(1.0)$/      X = 2.0\n      X = H(X)/' inc.f > edit.f
+mv edit.f inc.f
+check 2 3
+grep -q '"line": 11,' diag.txt \
+	|| fail "Cached diagnostics weren't moved: $(cat diag.txt)"
+check 3 3
+
+# A change to a unit's declarations invalidates every unit.
+sed 's/^      INTEGER N$/      REAL N/' inc.f > edit.f
+mv edit.f inc.f
+check 0 3
+grep -q "Argument 1 of 'B'" diag.txt \
+	&& fail "Stale call warning in: $(cat diag.txt)"
+check 3 3
+
+# A cache which can't be read is rebuilt.
+echo "garbage" > cache
+check 0 3
+check 3 3
+
+exit 0
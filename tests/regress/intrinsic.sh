@@ -0,0 +1,129 @@
+# Intrinsics are found through generated perfect hash tables, check
+# that every descriptor is found by its own name in any case, and that
+# names which aren't intrinsics never are.
+
+fail() { echo "$*"; exit 1; }
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <ofc/sema.h>
+#include "intrinsic_list.h"
+
+static unsigned failed = 0;
+
+#define CHECK(cond, name) \
+	do { if (!(cond)) { printf("Failed: %s for '%s'\n", #cond, name); failed++; } } while (0)
+
+/* Brute force search of the descriptor lists. */
+static bool listed(const char* name, bool subr)
+{
+	unsigned i;
+	if (subr)
+	{
+		for (i = 0; ofc_sema_intrinsic__subr_list[i].name; i++)
+			if (strcasecmp(ofc_sema_intrinsic__subr_list[i].name, name) == 0)
+				return true;
+		return false;
+	}
+
+	for (i = 0; ofc_sema_intrinsic__op_list[i].name; i++)
+		if (strcasecmp(ofc_sema_intrinsic__op_list[i].name, name) == 0)
+			return true;
+	for (i = 0; ofc_sema_intrinsic__func_list[i].name; i++)
+		if (strcasecmp(ofc_sema_intrinsic__func_list[i].name, name) == 0)
+			return true;
+	return false;
+}
+
+static const ofc_sema_intrinsic_t* find(const char* name, bool subr)
+{
+	ofc_str_ref_t ref = ofc_str_ref_from_strz(name);
+	return (subr ? ofc_sema_intrinsic_subroutine(NULL, ref)
+		: ofc_sema_intrinsic(NULL, ref));
+}
+
+static void check(const char* name, bool subr)
+{
+	const ofc_sema_intrinsic_t* intrinsic = find(name, subr);
+	CHECK(intrinsic, name);
+
+	ofc_colstr_t* cs = ofc_colstr_create(72, 0);
+	unsigned size = 0;
+	const char* printed = NULL;
+	if (cs && ofc_sema_intrinsic_print(cs, intrinsic))
+		printed = ofc_colstr_get(cs, &size);
+	CHECK(printed && (size == strlen(name))
+		&& (strncasecmp(printed, name, size) == 0), name);
+	ofc_colstr_delete(cs);
+
+	char other[64];
+	unsigned len = strlen(name), i;
+	if (len + 2 > sizeof(other)) return;
+
+	for (i = 0; i <= len; i++)
+		other[i] = tolower((unsigned char)name[i]);
+	CHECK(find(other, subr) == intrinsic, name);
+
+	/* Near misses are only found when they're intrinsics too. */
+	other[len] = 'Q'; other[len + 1] = '\0';
+	CHECK(!find(other, subr) == !listed(other, subr), other);
+	other[len - 1] = '\0';
+	CHECK(!find(other, subr) == !listed(other, subr), other);
+	strcpy(other, name);
+	other[0] = ((other[0] == 'Z') ? 'Y' : 'Z');
+	CHECK(!find(other, subr) == !listed(other, subr), other);
+}
+
+int main(void)
+{
+	unsigned i, count = 0;
+	for (i = 0; ofc_sema_intrinsic__op_list[i].name; i++, count++)
+		check(ofc_sema_intrinsic__op_list[i].name, false);
+	for (i = 0; ofc_sema_intrinsic__func_list[i].name; i++, count++)
+		check(ofc_sema_intrinsic__func_list[i].name, false);
+	for (i = 0; ofc_sema_intrinsic__subr_list[i].name; i++, count++)
+		check(ofc_sema_intrinsic__subr_list[i].name, true);
+
+	if (count < 100)
+		printf("Only %u intrinsics listed\n", count);
+
+	/* Only FDate and Second are both. */
+	CHECK(find("FDATE", false) && find("FDATE", true)
+		&& (find("FDATE", false) != find("FDATE", true)), "FDATE");
+	CHECK(!find("ITIME", false) && find("ITIME", true), "ITIME");
+	CHECK(find("SIN", false) && !find("SIN", true), "SIN");
+
+	CHECK(!find("", false) && !find("", true), "");
+	CHECK(!find("NOTANINTRINSIC", false), "NOTANINTRINSIC");
+
+	return ((failed || (count < 100)) ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -I "$OFC_ROOT/src/sema" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Intrinsic lookup was wrong"
+
+cat > intr.f <<'END'
+      PROGRAM I
+      REAL X, Y
+      INTEGER K
+      CHARACTER*24 D
+      X = sqrt(2.0) + Sin(1.0) + ABS(-1.0)
+      K = iand(6, 3) + Len('ABC')
+      Y = RNOSQR(X)
+      CALL FDate(D)
+      PRINT *, X, Y, K, D
+      END
+END
+
+"$OFC" --sema-tree intr.f > out.f 2> err.txt \
+	|| fail "Failed to analyse intr.f: $(cat err.txt)"
+[ "$(grep -c "^Warning" err.txt)" -eq 1 ] \
+	&& grep -q "intr.f:7,16: Implicit function declaration" err.txt \
+	|| fail "Expected only RNOSQR to be implicit in: $(cat err.txt)"
+
+exit 0
@@ -0,0 +1,85 @@
+# Program units are parsed concurrently, check that output, diagnostics
+# and exit status don't depend on the number of threads, including when
+# the scan for unit boundaries guesses wrong or a unit fails to parse.
+
+fail() { echo "$*"; exit 1; }
+
+# Compares every output mode with one thread and with several.
+compare()
+{
+	for mode in "" --parse-tree --sema-tree; do
+		"$OFC" --jobs 1 $mode "$1" > out1.txt 2> err1.txt
+		status1=$?
+		for jobs in 2 4 16; do
+			"$OFC" --jobs $jobs $mode "$1" > out.txt 2> err.txt
+			status=$?
+			[ $status -eq $status1 ] \
+				|| fail "Status of $1 $mode differs with --jobs $jobs"
+			cmp -s out1.txt out.txt \
+				|| fail "Output of $1 $mode differs with --jobs $jobs: $(diff out1.txt out.txt)"
+			cmp -s err1.txt err.txt \
+				|| fail "Diagnostics of $1 $mode differ with --jobs $jobs: $(diff err1.txt err.txt)"
+		done
+	done
+}
+
+unit()
+{
+	echo "      SUBROUTINE S$1(X)"
+	echo "      REAL X, Y"
+	echo "      INTEGER END"
+	echo "      END = $1"
+	echo "      IF (X . GT. 0.0) THEN"
+	echo "        Y = X * END"
+	echo "      END IF"
+	echo "      DO 10 I = 1, END"
+	echo "        Y = Y + I"
+	echo "   10 CONTINUE"
+	echo "      X = Y"
+	echo "      END SUBROUTINE"
+	echo
+	echo "      INTEGER FUNCTION F$1(N)"
+	echo "      INTEGER N"
+	echo "      F$1 = N + $1"
+	echo "      END"
+	echo
+}
+
+{
+	echo "      PROGRAM P"
+	echo "      REAL X"
+	echo "      X = 1.0"
+	i=0
+	while [ $i -lt 30 ]; do
+		echo "      CALL S$i(X)"
+		i=$((i + 1))
+	done
+	echo "      END PROGRAM P"
+	echo
+	i=0
+	while [ $i -lt 30 ]; do
+		unit $i
+		i=$((i + 1))
+	done
+	echo "      BLOCK DATA B"
+	echo "      COMMON /C/ K"
+	echo "      DATA K /1/"
+	echo "      END BLOCK DATA"
+} > units.f
+
+compare units.f
+[ $status1 -eq 0 ] || fail "Failed to analyse units.f: $(cat err1.txt)"
+[ "$(grep -c "Operators shouldn't contain whitespace" err1.txt)" -eq 30 ] \
+	|| fail "Expected a warning from every unit in: $(cat err1.txt)"
+
+# A unit which can't be parsed makes the rest of the file serial.
+sed 's/^      F12 = N + 12$/      F12 = N + + (/' units.f > broken.f
+compare broken.f
+[ $status1 -ne 0 ] || fail "Expected broken.f to fail"
+
+# An END which isn't the end of a unit.
+sed 's/^      END = 7$/      END\n     1 = 7/' units.f > split.f
+compare split.f
+[ $status1 -eq 0 ] || fail "Failed to analyse split.f: $(cat err1.txt)"
+
+exit 0
@@ -0,0 +1,179 @@
+# Allocations are accounted per subsystem, check the counts kept by
+# ofc_alloc and backend routing, and that the --mem-stats report is
+# consistent with itself.
+
+fail() { echo "$*"; exit 1; }
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ofc/alloc.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+static unsigned calls[3];
+
+static void* count_alloc(void* param, size_t size)
+	{ (void)param; calls[0]++; return malloc(size); }
+static void* count_realloc(void* param, void* ptr, size_t size)
+	{ (void)param; calls[1]++; return realloc(ptr, size); }
+static void count_free(void* param, void* ptr)
+	{ (void)param; calls[2]++; free(ptr); }
+
+int main(void)
+{
+	const ofc_alloc_tag_e tag = OFC_ALLOC_COLSTR;
+	ofc_alloc_stats_t base, stats;
+	ofc_alloc_stats(tag, &base);
+
+	char* a = ofc_alloc(tag, 100);
+	CHECK(a);
+	ofc_alloc_stats(tag, &stats);
+	CHECK(stats.live == (base.live + 100));
+	CHECK(stats.allocs == (base.allocs + 1));
+	CHECK(stats.histogram[3] == (base.histogram[3] + 1));
+
+	/* A block keeps its tag when it's reallocated. */
+	a = ofc_realloc(OFC_ALLOC_MISC, a, 5000);
+	CHECK(a);
+	ofc_alloc_stats(tag, &stats);
+	CHECK(stats.live == (base.live + 5000));
+	CHECK(stats.reallocs == (base.reallocs + 1));
+	CHECK(stats.peak >= stats.live);
+
+	ofc_free(a);
+	ofc_alloc_stats(tag, &stats);
+	CHECK(stats.live == base.live);
+	CHECK(stats.frees == (base.frees + 1));
+	CHECK(stats.peak >= (base.live + 5000));
+
+	/* Peaks reached between reports still count. */
+	a = ofc_alloc(tag, 30000);
+	ofc_free(a);
+	ofc_alloc_stats(tag, &stats);
+	CHECK(stats.peak >= (base.live + 30000));
+	ofc_alloc_stats(OFC_ALLOC_TAG_COUNT, &stats);
+	CHECK(stats.peak >= 30000);
+
+	unsigned* z = ofc_calloc(tag, 64, sizeof(unsigned));
+	unsigned i, sum = 0;
+	for (i = 0; z && (i < 64); i++)
+		sum += z[i];
+	CHECK(z && (sum == 0));
+	char* s = ofc_strdup(tag, "strdup");
+	CHECK(s && (strcmp(s, "strdup") == 0));
+	char* r = ofc_realloc(tag, NULL, 20000);
+	CHECK(r);
+	ofc_alloc_stats(tag, &stats);
+	CHECK(stats.live == (base.live + (64 * sizeof(unsigned)) + 7 + 20000));
+	CHECK(stats.histogram[OFC_ALLOC_HISTOGRAM_SIZE - 1]
+		== base.histogram[OFC_ALLOC_HISTOGRAM_SIZE - 1]);
+
+	/* A backend can't be swapped under live allocations. */
+	ofc_alloc_backend_t backend =
+		{ count_alloc, count_realloc, count_free, NULL };
+	CHECK(!ofc_alloc_backend_set(tag, &backend));
+	ofc_free(z);
+	ofc_free(s);
+	ofc_free(r);
+
+	ofc_alloc_stats(tag, &stats);
+	if (stats.live == 0)
+	{
+		CHECK(ofc_alloc_backend_set(tag, &backend));
+		a = ofc_alloc(tag, 10);
+		a = ofc_realloc(tag, a, 1000);
+		ofc_free(a);
+		CHECK((calls[0] == 1) && (calls[1] == 1) && (calls[2] == 1));
+		CHECK(ofc_alloc_backend_set(tag, NULL));
+		ofc_free(ofc_alloc(tag, 10));
+		CHECK(calls[0] == 1);
+	}
+	else
+	{
+		printf("Tag has %zu bytes live\n", stats.live);
+		failed++;
+	}
+
+	/* The totals are the sum over every tag. */
+	ofc_alloc_stats_t total, sum_stats;
+	memset(&sum_stats, 0, sizeof(sum_stats));
+	ofc_alloc_tag_e t;
+	for (t = 0; t < OFC_ALLOC_TAG_COUNT; t++)
+	{
+		CHECK(ofc_alloc_tag_name(t) != NULL);
+		ofc_alloc_stats(t, &stats);
+		sum_stats.live   += stats.live;
+		sum_stats.allocs += stats.allocs;
+		sum_stats.frees  += stats.frees;
+	}
+	ofc_alloc_stats(OFC_ALLOC_TAG_COUNT, &total);
+	CHECK(total.live == sum_stats.live);
+	CHECK(total.allocs == sum_stats.allocs);
+	CHECK(total.frees == sum_stats.frees);
+
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Allocation accounting was wrong"
+
+cat > mem.f <<'END'
+      PROGRAM M
+      REAL X(100)
+      CHARACTER*40 S
+      DATA X /100 * 1.5/
+      S = 'MEMORY'
+      CALL SUB(X, S)
+      END
+
+      SUBROUTINE SUB(Y, T)
+      REAL Y(100)
+      CHARACTER*(*) T
+      PRINT *, Y(1), T
+      END
+END
+
+for jobs in 1 4; do
+	"$OFC" --jobs $jobs --mem-stats --sema-tree mem.f > /dev/null 2> err.txt \
+		|| fail "Failed to analyse mem.f: $(cat err.txt)"
+	grep "^Mem:" err.txt > mem.txt
+	awk '
+		/^Mem:[a-z-]*:sizes:/ {
+			split($1, f, ":"); n = 0
+			for (i = 2; i <= NF; i++) { split($i, b, ":"); n += b[2] }
+			sizes[f[2]] = n; next
+		}
+		/^Mem:/ {
+			split($1, f, ":"); tag = f[2]
+			live[tag] = $2; peak[tag] = $4
+			allocs[tag] = $6; reallocs[tag] = $8; frees[tag] = $10
+			next
+		}
+		{ print "Malformed line: " $0; bad = 1 }
+		END {
+			if (!("total" in live) || !("parse" in live) || !("sema" in live))
+				{ print "Missing tags"; bad = 1 }
+			for (tag in live) {
+				if (peak[tag] < live[tag]) { print tag ": peak below live"; bad = 1 }
+				if (allocs[tag] < frees[tag]) { print tag ": more frees than allocs"; bad = 1 }
+				if (sizes[tag] != (allocs[tag] + reallocs[tag])) { print tag ": histogram doesn'\''t match requests"; bad = 1 }
+				if (tag != "total") { l += live[tag]; a += allocs[tag]; p += peak[tag] }
+			}
+			if (l != live["total"]) { print "Live bytes don'\''t add up"; bad = 1 }
+			if (a != allocs["total"]) { print "Allocs don'\''t add up"; bad = 1 }
+			if (peak["total"] > p) { print "Total peak above the sum of peaks"; bad = 1 }
+			if (peak["parse"] == 0) { print "Nothing allocated to parse"; bad = 1 }
+			if (jobs == 1) for (tag in peak) if (peak[tag] > peak["total"])
+				{ print tag ": peak above the total peak"; bad = 1 }
+			exit bad
+		}' jobs=$jobs mem.txt || fail "Inconsistent --mem-stats with --jobs $jobs: $(cat mem.txt)"
+done
+
+exit 0
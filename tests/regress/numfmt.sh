@@ -0,0 +1,52 @@
+# Constants are printed with the fewest digits that read back as the same
+# value of their kind, with an exponent letter or kind suffix for kinds
+# other than the default, and the printed source reads back the same.
+
+fail() { echo "$*"; exit 1; }
+
+cat > numfmt.f <<'END'
+      PROGRAM P
+      REAL R
+      DOUBLE PRECISION D
+      COMPLEX C
+      COMPLEX*8 Y
+      COMPLEX*16 Z
+      INTEGER*2 H
+      INTEGER*8 K
+      DATA Y/(1.5,2.5)/
+      R = 0.1
+      R = 0.1D0
+      R = 1.0E-10
+      D = 0.1
+      D = 1
+      C = (1.0, 2.0) * 2
+      Z = (1.5D0,-2.5D0)
+      H = 32767
+      K = 9223372036854775807_8
+      K = 7
+      END
+END
+
+"$OFC" --sema-tree numfmt.f > out.f 2> err.txt \
+	|| fail "Failed to analyse numfmt.f: $(cat err.txt)"
+
+expect() {
+	grep -qF -- "$1" out.f || fail "Expected '$1' in: $(cat out.f)"
+}
+
+expect "COMPLEX*8 :: Y = (1.5, 2.5)"
+expect "R = 0.1"
+expect "R = 1E-10"
+expect "D = 0.10000000149011612D0"
+expect "D = 1.0D0"
+expect "C = (1.0, 2.0) * (2.0, 0.0)"
+expect "Z = (1.5D0, -2.5D0)"
+expect "H = 32767_2"
+expect "K = 9223372036854775807_8"
+expect "K = 7_8"
+
+"$OFC" --sema-tree out.f > again.f 2> err.txt \
+	|| fail "Failed to analyse the printed source: $(cat err.txt)"
+cmp -s out.f again.f || fail "Printed source doesn't round trip"
+
+exit 0
@@ -0,0 +1,27 @@
+# Printing program units on several threads gives the same text as one,
+# including statement function arguments, whose types are looked up
+# while printing.
+
+fail() { echo "$*"; exit 1; }
+
+i=0
+while [ $i -lt 32 ]; do
+	cat <<END
+      SUBROUTINE S$i(X)
+      F(A) = A + 1.0
+      CHARACTER*$((i + 1)) C
+      EXTERNAL G
+      CALL G(C)
+      X = F(X)
+      END
+END
+	i=$((i + 1))
+done > units.f
+
+"$OFC" --sema-tree --jobs 1 units.f > serial.f || fail "Failed to print"
+"$OFC" --sema-tree --jobs 4 units.f > parallel.f \
+	|| fail "Failed to print on 4 threads"
+cmp -s serial.f parallel.f || fail "Output differs between 1 and 4 threads"
+grep -q "REAL :: A" serial.f || fail "Statement function argument wasn't printed"
+
+exit 0
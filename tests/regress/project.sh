@@ -0,0 +1,69 @@
+# Project index: cross-file checks, recovery from an invalid index,
+# and concurrent updates of the same index.
+
+fail() { echo "$*"; exit 1; }
+
+cat > sub.f <<'END'
+      SUBROUTINE SUB(N)
+      INTEGER N
+      N = 1
+      END
+END
+
+cat > main.f <<'END'
+      PROGRAM MAIN
+      REAL X
+      X = 1.0
+      CALL SUB(X)
+      END
+END
+
+"$OFC" --project index sub.f || fail "Failed to index sub.f"
+"$OFC" --project index main.f 2> out.txt || fail "Failed to check main.f"
+grep -q "Argument 1 of 'SUB' is REAL, but 'N' is INTEGER" out.txt \
+	|| fail "Call wasn't checked against the index"
+
+# An unchanged summary leaves the index file alone.
+before=$(ls -i index)
+"$OFC" --project index sub.f || fail "Failed to reindex sub.f"
+[ "$(ls -i index)" = "$before" ] || fail "Unchanged index was rewritten"
+
+# Corrupt and stale indexes are discarded with a warning and rebuilt.
+for bad in "garbage" "OFCI????"; do
+	printf '%s' "$bad" > index
+	"$OFC" --project index sub.f 2> out.txt \
+		|| fail "Invalid index '$bad' wasn't discarded"
+	grep -q "Discarding invalid project index 'index'" out.txt \
+		|| fail "No warning for invalid index '$bad'"
+	"$OFC" --project index main.f 2> out.txt \
+		|| fail "Failed to check main.f against rebuilt index"
+	grep -q "Argument 1 of 'SUB'" out.txt \
+		|| fail "Index wasn't rebuilt after '$bad'"
+done
+
+# Concurrent runs mustn't drop each other's summaries.
+rm -f index
+count=16
+{
+	printf '      PROGRAM MAIN\n      REAL X\n      X = 1.0\n'
+	i=1
+	while [ $i -le $count ]; do
+		printf '      SUBROUTINE S%d(N)\n      INTEGER N\n      N = 1\n      END\n' \
+			$i > s$i.f
+		printf '      CALL S%d(X)\n' $i
+		i=$((i + 1))
+	done
+	printf '      END\n'
+} > calls.f
+
+i=1
+while [ $i -le $count ]; do
+	"$OFC" --project index s$i.f &
+	i=$((i + 1))
+done
+wait
+
+"$OFC" --project index calls.f 2> out.txt
+found=$(grep -c "Argument 1 of 'S[0-9]*' is REAL" out.txt)
+[ "$found" -eq $count ] || fail "Only $found of $count summaries survived"
+exit 0
@@ -0,0 +1,50 @@
+# READ control specifiers: ADVANCE and SIZE survive a round trip through
+# --sema-tree, and SIZE is checked and treated as a variable READ sets.
+
+fail() { echo "$*"; exit 1; }
+
+cat > read.f <<'END'
+      PROGRAM P
+      INTEGER I, J
+      READ(10, 200, ADVANCE='NO', SIZE=J) I
+200   FORMAT(I5)
+      WRITE(*,*) I, J
+      END
+END
+
+"$OFC" --sema-tree --dataflow read.f > out.f 2> err.txt \
+	|| fail "Failed to analyse read.f"
+[ -s err.txt ] && fail "Unexpected diagnostics: $(cat err.txt)"
+grep -q "ADVANCE= \"NO\", SIZE= J" out.f \
+	|| fail "ADVANCE and SIZE weren't printed: $(grep READ out.f)"
+
+"$OFC" --sema-tree out.f > again.f 2> err.txt \
+	|| fail "Failed to analyse the printed source: $(cat err.txt)"
+cmp -s out.f again.f || fail "Printed source doesn't round trip"
+
+cat > constant.f <<'END'
+      PROGRAM P
+      INTEGER I
+      READ(10, 200, ADVANCE='NO', SIZE=3) I
+200   FORMAT(I5)
+      END
+END
+
+"$OFC" constant.f 2> err.txt && fail "Constant SIZE was accepted"
+grep -q "SIZE must be a variable in READ" err.txt \
+	|| fail "Wrong error for constant SIZE: $(cat err.txt)"
+
+cat > real.f <<'END'
+      PROGRAM P
+      INTEGER I
+      REAL X
+      READ(10, 200, ADVANCE='NO', SIZE=X) I
+200   FORMAT(I5)
+      END
+END
+
+"$OFC" real.f 2> err.txt && fail "REAL SIZE was accepted"
+grep -q "SIZE must be an INTEGER variable in READ" err.txt \
+	|| fail "Wrong error for REAL SIZE: $(cat err.txt)"
+
+exit 0
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Runs every regression test in this directory against a frontend.
+#
+# Usage: run.sh FRONTEND
+#
+# Each test is a shell script run from an empty scratch directory with
+# OFC set to the frontend, it passes when it exits with status zero.
+# Tests of the library API can build against the tree from OFC_ROOT.
+
+FRONTEND=$1
+
+if [ -z "$FRONTEND" ]; then
+	echo "Usage: $0 FRONTEND" >&2
+	exit 1
+fi
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+OFC_ROOT=$(cd "$DIR/../.." && pwd)
+export OFC_ROOT
+SCRATCH=$(mktemp -d) || exit 1
+trap 'rm -rf "$SCRATCH"' EXIT
+
+passed=0
+failed=0
+for test in "$DIR"/*.sh; do
+	name=$(basename "$test" .sh)
+	[ "$name" = "run" ] && continue
+
+	mkdir "$SCRATCH/$name" || exit 1
+	if (cd "$SCRATCH/$name" && OFC="$FRONTEND" sh "$test") \
+		> "$SCRATCH/$name.log" 2>&1; then
+		passed=$((passed + 1))
+	else
+		failed=$((failed + 1))
+		echo "FAIL: $name"
+		sed 's/^/    /' "$SCRATCH/$name.log"
+	fi
+done
+
+echo "$passed passed, $failed failed"
+[ $failed -eq 0 ]
@@ -0,0 +1,76 @@
+# --server answers one JSON response line per request line: documents are
+# opened, updated, queried and closed, definitions report the declared
+# type with its kind, and bad requests get an error naming the problem.
+
+fail() { echo "$*"; exit 1; }
+
+cat > doc.f <<'END'
+      PROGRAM P
+      REAL*8 R
+      INTEGER*8 K
+      DOUBLE PRECISION D
+      CHARACTER*10 C
+      INTEGER F
+      R = 1.0
+      K = F(2)
+      D = R
+      C = 'A'
+      CALL S(K)
+      END
+      INTEGER FUNCTION F(I)
+      INTEGER I
+      F = I
+      END
+      SUBROUTINE S(J)
+      INTEGER*8 J
+      END
+END
+
+cat > requests.txt <<'END'
+{"id":1,"method":"open","path":"doc.f"}
+{"id":2,"method":"definition","path":"doc.f","line":7,"column":7}
+{"id":3,"method":"definition","path":"doc.f","line":8,"column":7}
+{"id":4,"method":"definition","path":"doc.f","line":9,"column":7}
+{"id":5,"method":"definition","path":"doc.f","line":10,"column":7}
+{"id":6,"method":"definition","path":"doc.f","line":8,"column":11}
+{"id":7,"method":"definition","path":"doc.f","line":11,"column":12}
+{"id":8,"method":"sema","path":"doc.f","start":13,"end":13}
+{"id":9,"method":"update","path":"doc.f","text":"      PROGRAM P\n      X = Y\n      END\n"}
+{"id":10,"method":"diagnostics","path":"doc.f"}
+{"id":11,"method":"close","path":"doc.f"}
+{"id":12,"method":"diagnostics","path":"doc.f"}
+{"id":13,"method":"bogus"}
+{"id":14,"method":"sema"}
+{"id":15}
+{"id":16,"method":"shutdown"}
+{"id":17,"method":"diagnostics","path":"doc.f"}
+END
+
+"$OFC" --server < requests.txt > responses.txt 2> err.txt \
+	|| fail "Server failed: $(cat err.txt)"
+
+[ "$(wc -l < responses.txt)" -eq 16 ] \
+	|| fail "Expected one response per request up to shutdown: $(cat responses.txt)"
+
+expect() {
+	grep -qF -- "$1" responses.txt || fail "Expected '$1' in: $(cat responses.txt)"
+}
+
+expect '{"id":1,"result":{"version":1,"diagnostics":[{"severity":"warning","file":"doc.f","line":8,"column":12,"message":"Implicit function declaration"'
+expect '{"id":2,"result":{"name":"R","type":"REAL*8","file":"doc.f","line":2,"column":14}}'
+expect '{"id":3,"result":{"name":"K","type":"INTEGER*8","file":"doc.f","line":3,"column":17}}'
+expect '{"id":4,"result":{"name":"D","type":"DOUBLE PRECISION","file":"doc.f","line":4,"column":24}}'
+expect '{"id":5,"result":{"name":"C","type":"CHARACTER(10)","file":"doc.f","line":5,"column":20}}'
+expect '{"id":6,"result":{"name":"F","type":"INTEGER FUNCTION","file":"doc.f","line":13,"column":24}}'
+expect '{"id":7,"result":{"name":"S","type":"SUBROUTINE","file":"doc.f","line":17,"column":18}}'
+expect '{"id":8,"result":{"text":"      INTEGER FUNCTION F(I)\n        INTEGER :: I\n        F = I\n      END FUNCTION F"}}'
+expect '{"id":9,"result":{"version":2,"diagnostics":[{"severity":"warning","file":"doc.f","line":2,"column":11,'
+expect '{"id":10,"result":{"version":2,'
+expect '{"id":11,"result":true}'
+expect '{"id":12,"error":"Document isn'"'"'t open"}'
+expect '{"id":13,"error":"Unknown method"}'
+expect '{"id":14,"error":"Request has no path"}'
+expect '{"id":15,"error":"Request has no method"}'
+expect '{"id":16,"result":true}'
+
+exit 0
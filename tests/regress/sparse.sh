@@ -0,0 +1,109 @@
+# ofc_sparse_sequential answers whether text in a sparse came from one
+# contiguous run of the source, check it against the entries appended
+# and that the parser warns about whitespace within tokens.
+
+fail() { echo "$*"; exit 1; }
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <string.h>
+#include <ofc/sparse.h>
+
+#define LEN 1000
+
+int main(void)
+{
+	static char text[LEN + 1];
+	static bool start[LEN + 1];
+	unsigned failed = 0;
+	unsigned i;
+
+	for (i = 0; i < LEN; i++)
+		text[i] = 'A' + (i % 26);
+
+	ofc_file_t* file = ofc_file_create_strz(
+		"sparse.f", OFC_LANG_OPTS_F77, text);
+	ofc_sparse_t* sparse = ofc_sparse_create_file(file);
+	if (!sparse) return 1;
+
+	/* Entries of awkward lengths either side of word boundaries,
+	   skipping a character between each as condense would. */
+	const char* src = ofc_file_get_strz(file);
+	unsigned off = 0, len = 1, total = 0;
+	while ((off + len) <= LEN)
+	{
+		start[total] = true;
+		if (!ofc_sparse_append_strn(sparse, &src[off], len))
+			return 1;
+		off   += len + 1;
+		total += len;
+		len = ((len * 7) + 3) % 70 + 1;
+	}
+
+	ofc_sparse_lock(sparse);
+	const char* strz = ofc_sparse_strz(sparse);
+	if (!strz) return 1;
+
+	unsigned size;
+	for (off = 0; off < total; off++)
+	{
+		for (size = 0; (off + size) <= total; size++)
+		{
+			bool expect = true;
+			for (i = (off + 1); i < (off + size); i++)
+			{
+				if (start[i])
+					expect = false;
+			}
+
+			if (ofc_sparse_sequential(sparse, &strz[off], size) != expect)
+			{
+				if (failed++ < 10)
+					printf("Wrong at %u size %u\n", off, size);
+			}
+		}
+
+		if (ofc_sparse_sequential(sparse, &strz[off], (total + 1 - off)))
+		{
+			if (failed++ < 10)
+				printf("Past the end at %u\n", off);
+		}
+	}
+
+	ofc_sparse_delete(sparse);
+	ofc_file_delete(file);
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "ofc_sparse_sequential disagrees with the entries"
+
+cat > ws.f <<'END'
+      PROGRAM WS
+      INT EGER ALPHA, BETA
+      LOGICAL L
+      ALPHA = 1
+      BE TA = 2
+      L = ALPHA . EQ. BETA
+      BETA = ALPHA
+     1  + 3
+      PRINT *, L, BETA
+      END
+END
+
+"$OFC" --sema-tree ws.f > out.f 2> err.txt \
+	|| fail "Failed to analyse ws.f: $(cat err.txt)"
+grep -q "ws.f:2,6: Unexpected space in INTEGER keyword" err.txt \
+	|| fail "Expected a keyword warning in: $(cat err.txt)"
+grep -q "ws.f:5,6: Unexpected whitespace within identifier 'BETA'" err.txt \
+	|| fail "Expected an identifier warning in: $(cat err.txt)"
+grep -q "ws.f:6,16: Operators shouldn't contain whitespace" err.txt \
+	|| fail "Expected an operator warning in: $(cat err.txt)"
+[ "$(grep -c "^Warning" err.txt)" -eq 3 ] \
+	|| fail "Expected exactly 3 warnings in: $(cat err.txt)"
+grep -q "BETA = ALPHA + 3" out.f \
+	|| fail "Continuation wasn't joined: $(cat out.f)"
+
+exit 0
@@ -0,0 +1,41 @@
+# --stream prints the same trees and diagnostics as whole-file mode, even
+# though procedures come before the main program in the source.
+
+fail() { echo "$*"; exit 1; }
+
+cat > stream.f <<'END'
+      SUBROUTINE S1(X)
+      REAL X
+      X = 1.0
+      END
+      PROGRAM P
+      REAL Y
+      INTEGER J
+      CALL S1(Y)
+      PRINT *, Y, J
+      END
+      INTEGER FUNCTION F(I)
+      INTEGER I
+      F = I + 1
+      END
+      BLOCK DATA B
+      COMMON /C/ Z
+      DATA Z /1.0/
+      END
+      SUBROUTINE S2
+      END
+END
+
+for mode in --sema-tree --parse-tree "--parse-tree --sema-tree"; do
+	"$OFC" $mode stream.f > whole.out 2> whole.err \
+		|| fail "Failed to analyse stream.f with $mode: $(cat whole.err)"
+	"$OFC" --stream $mode stream.f > stream.out 2> stream.err \
+		|| fail "Failed to stream stream.f with $mode: $(cat stream.err)"
+	[ -s whole.out ] || fail "Nothing printed with $mode"
+	diff whole.out stream.out > diff.txt \
+		|| fail "Streamed $mode output differs: $(cat diff.txt)"
+	diff whole.err stream.err > diff.txt \
+		|| fail "Streamed $mode diagnostics differ: $(cat diff.txt)"
+done
+
+exit 0
@@ -0,0 +1,128 @@
+# STRUCTURE layouts are frozen once complete, check that sizes, member
+# order and lookup by name through anonymous UNION and MAP members are
+# right, and that such structures survive printing.
+
+fail() { echo "$*"; exit 1; }
+
+cat > shape.f <<'END'
+      PROGRAM S
+      STRUCTURE /POINT/
+        REAL X, Y
+      END STRUCTURE
+      STRUCTURE /SHAPE/
+        INTEGER*2 TAG
+        RECORD /POINT/ ORIGIN
+        UNION
+          MAP
+            REAL RADIUS
+          END MAP
+          MAP
+            RECORD /POINT/ CORNER
+            INTEGER*4 SIDES
+          END MAP
+        END UNION
+      END STRUCTURE
+      RECORD /SHAPE/ A
+      A.TAG = 1
+      A.ORIGIN.X = 1.0
+      A.RADIUS = 2.0
+      A.CORNER.Y = 3.0
+      A.SIDES = 4
+      PRINT *, A.TAG, A.ORIGIN.X, A.RADIUS, A.CORNER.Y, A.SIDES
+      END
+END
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <string.h>
+#include <ofc/context.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+static bool is_named(const ofc_sema_decl_t* decl, const char* name)
+{
+	return decl && (decl->name.size == strlen(name))
+		&& (strncmp(decl->name.base, name, decl->name.size) == 0);
+}
+
+int main(void)
+{
+	static char text[4096];
+	FILE* fp = fopen("shape.f", "r");
+	if (!fp) return 1;
+	text[fread(text, 1, (sizeof(text) - 1), fp)] = '\0';
+	fclose(fp);
+
+	ofc_context_t* context = ofc_context_create(NULL);
+	if (!context) return 1;
+	ofc_context_t* previous = ofc_context_enter(context);
+
+	ofc_lang_opts_t opts = OFC_LANG_OPTS_F77;
+	const ofc_sema_scope_t* root
+		= ofc_context_analyse(context, "shape.f", text, &opts);
+	CHECK(root && root->child && (root->child->count == 1));
+	CHECK(ofc_diag_count(ofc_context_diag(context), OFC_DIAG_ERROR) == 0);
+	if (failed) return 1;
+
+	ofc_sema_scope_t* program = root->child->scope[0];
+	ofc_sema_structure_t* point = ofc_sema_scope_structure_find(
+		program, ofc_str_ref_from_strz("POINT"));
+	ofc_sema_structure_t* shape = ofc_sema_scope_structure_find(
+		program, ofc_str_ref_from_strz("SHAPE"));
+	CHECK(point && shape);
+	if (failed) return 1;
+
+	unsigned size = 0, count = 0;
+	CHECK(ofc_sema_structure_size(point, &size) && (size == 8));
+	CHECK(ofc_sema_structure_member_count(point, &count) && (count == 2));
+
+	/* The union is as big as its largest MAP. */
+	CHECK(ofc_sema_structure_size(shape, &size) && (size == 22));
+	CHECK(ofc_sema_structure_member_count(shape, &count) && (count == 5));
+	CHECK(ofc_sema_structure_is_nested(shape));
+	CHECK(!ofc_sema_structure_is_union(shape));
+
+	static const char* member[] =
+		{ "TAG", "ORIGIN", "RADIUS", "CORNER", "SIDES" };
+	unsigned i;
+	for (i = 0; i < 5; i++)
+	{
+		ofc_sema_decl_t* decl
+			= ofc_sema_structure_member_get_decl_name(
+				shape, ofc_str_ref_from_strz(member[i]));
+		unsigned offset;
+		CHECK(is_named(decl, member[i]));
+		CHECK(decl == ofc_sema_structure_member_get_decl_offset(shape, i));
+		CHECK(ofc_sema_structure_member_offset(shape, decl, &offset)
+			&& (offset == i));
+		CHECK(is_named(ofc_sema_structure_elem_get(shape, i), member[i]));
+	}
+
+	/* Members of named records aren't members of the parent. */
+	CHECK(!ofc_sema_structure_member_get_decl_name(
+		shape, ofc_str_ref_from_strz("X")));
+	CHECK(!ofc_sema_structure_member_get_decl_offset(shape, 5));
+
+	ofc_context_leave(previous);
+	ofc_context_delete(context);
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Structure layout was wrong"
+
+"$OFC" --sema-tree shape.f > out.f 2> err.txt \
+	|| fail "Failed to analyse shape.f: $(cat err.txt)"
+grep -q "UNION" out.f && grep -q "RECORD /POINT/ CORNER" out.f \
+	|| fail "Structure wasn't printed: $(cat out.f)"
+
+"$OFC" --sema-tree out.f > again.f 2> err.txt \
+	|| fail "Failed to analyse the printed source: $(cat err.txt)"
+cmp -s out.f again.f || fail "Printed source doesn't round trip"
+
+exit 0
@@ -0,0 +1,101 @@
+# Primitive types are shared: small kinds come from a static table and
+# larger ones are interned, so equal types are always the same pointer,
+# and declarations of every kind read back as they were written.
+
+fail() { echo "$*"; exit 1; }
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <ofc/sema.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+int main(void)
+{
+	ofc_sema_type_e t;
+	for (t = OFC_SEMA_TYPE_LOGICAL; t <= OFC_SEMA_TYPE_BYTE; t++)
+	{
+		unsigned k;
+		for (k = 1; k < 100; k++)
+		{
+			const ofc_sema_type_t* a
+				= ofc_sema_type_create_primitive(t, k);
+			const ofc_sema_type_t* b
+				= ofc_sema_type_create_primitive(t, k);
+			if (!a) continue;
+
+			CHECK(a == b);
+			if ((t == OFC_SEMA_TYPE_LOGICAL) && (a->type == OFC_SEMA_TYPE_BYTE))
+				continue;
+			CHECK((a->type == t) && (a->kind == k));
+
+			const ofc_sema_type_t* c
+				= ofc_sema_type_create_primitive(t, (k + 1));
+			CHECK(!c || (c != a));
+		}
+	}
+
+	/* A LOGICAL*1 is a BYTE. */
+	CHECK(ofc_sema_type_create_primitive(OFC_SEMA_TYPE_LOGICAL, 3)
+		== ofc_sema_type_byte_default());
+
+	CHECK(ofc_sema_type_integer_default()
+		== ofc_sema_type_create_primitive(OFC_SEMA_TYPE_INTEGER, 1));
+	CHECK(ofc_sema_type_double_default()
+		== ofc_sema_type_create_primitive(OFC_SEMA_TYPE_REAL, 2));
+	CHECK(ofc_sema_type_double_complex_default()
+		== ofc_sema_type_create_primitive(OFC_SEMA_TYPE_COMPLEX, 2));
+
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "Primitive types weren't shared"
+
+cat > type.f <<'END'
+      PROGRAM P
+      LOGICAL*1 L1
+      LOGICAL*4 L4
+      INTEGER*2 I2
+      INTEGER*8 I8
+      INTEGER(KIND=2) K2
+      REAL*4 R4
+      REAL*16 R16
+      DOUBLE PRECISION D
+      COMPLEX*16 Z16
+      DOUBLE COMPLEX DZ
+      BYTE B
+      L1 = .TRUE.
+      L4 = L1
+      I2 = 1
+      I8 = I2
+      K2 = I8
+      R4 = K2
+      R16 = R4
+      D = R16
+      Z16 = D
+      DZ = Z16
+      B = 1
+      END
+END
+
+"$OFC" --sema-tree type.f > out.f 2> err.txt \
+	|| fail "Failed to analyse type.f: $(cat err.txt)"
+for decl in "BYTE :: L1" "LOGICAL*4 :: L4" "INTEGER*2 :: I2" \
+	"INTEGER*8 :: I8" "INTEGER(KIND=2) :: K2" "REAL*4 :: R4" \
+	"REAL*16 :: R16" "DOUBLE PRECISION :: D" "COMPLEX*16 :: Z16" \
+	"DOUBLE COMPLEX :: DZ" "BYTE :: B"
+do
+	grep -qF "$decl" out.f || fail "Expected '$decl' in: $(cat out.f)"
+done
+
+"$OFC" --sema-tree out.f > again.f 2> err.txt \
+	|| fail "Failed to analyse the printed source: $(cat err.txt)"
+cmp -s out.f again.f || fail "Printed source doesn't round trip"
+
+exit 0
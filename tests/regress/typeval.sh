@@ -0,0 +1,156 @@
+# CHARACTER constants short enough are stored inline in the typeval,
+# longer ones on the heap, values must survive either way through
+# copies, casts, concatenation, comparison and the typeval pool.
+
+fail() { echo "$*"; exit 1; }
+
+cat > check.c <<'END'
+#include <stdio.h>
+#include <string.h>
+#include <ofc/sema.h>
+
+static unsigned failed = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf("Failed: %s\n", #cond); failed++; } } while (0)
+
+static const unsigned lens[] = { 0, 1, 15, 16, 31, 32, 33, 64, 100 };
+#define LENS (sizeof(lens) / sizeof(lens[0]))
+
+static char text[256];
+
+static ofc_sema_typeval_t* create(unsigned len, char first)
+{
+	unsigned i;
+	for (i = 0; i < len; i++)
+		text[i] = first + (i % 26);
+
+	ofc_parse_literal_t literal =
+	{
+		.type   = OFC_PARSE_LITERAL_CHARACTER,
+		.kind   = 0,
+		.src    = OFC_SPARSE_REF_EMPTY,
+		.string = ofc_string_create(text, len),
+	};
+	if (!literal.string) return NULL;
+
+	ofc_sema_typeval_t* tv
+		= ofc_sema_typeval_literal(&literal, NULL);
+	ofc_string_delete(literal.string);
+	return tv;
+}
+
+static bool equal(const ofc_sema_typeval_t* tv, const char* s, unsigned len)
+{
+	const char* c;
+	return tv && ofc_sema_typeval_get_character(tv, &c)
+		&& (ofc_sema_typeval_size(tv) == len)
+		&& (memcmp(c, s, len) == 0);
+}
+
+int main(void)
+{
+	ofc_sema_typeval_t* tv[LENS];
+	char expect[LENS][256];
+	unsigned i, j;
+
+	for (i = 0; i < LENS; i++)
+	{
+		tv[i] = create(lens[i], 'A');
+		memcpy(expect[i], text, lens[i]);
+		CHECK(equal(tv[i], expect[i], lens[i]));
+	}
+
+	/* Recycled typevals mustn't disturb the ones still alive. */
+	for (i = 0; i < LENS; i++)
+	{
+		ofc_sema_typeval_t* other = create(lens[LENS - 1 - i], 'a');
+		ofc_sema_typeval_t* copy  = ofc_sema_typeval_copy(tv[i]);
+		CHECK(equal(copy, expect[i], lens[i]));
+		CHECK(ofc_sema_typeval_compare(copy, tv[i]));
+		CHECK((lens[i] == 0) || !ofc_sema_typeval_compare(copy, other));
+		ofc_sema_typeval_delete(other);
+		ofc_sema_typeval_delete(copy);
+		CHECK(equal(tv[i], expect[i], lens[i]));
+	}
+
+	for (i = 0; i < LENS; i++)
+	{
+		for (j = 0; j < LENS; j++)
+		{
+			char cat[512];
+			memcpy(cat, expect[i], lens[i]);
+			memcpy(&cat[lens[i]], expect[j], lens[j]);
+
+			ofc_sema_typeval_t* c
+				= ofc_sema_typeval_concat(tv[i], tv[j]);
+			CHECK(equal(c, cat, (lens[i] + lens[j])));
+			ofc_sema_typeval_delete(c);
+
+			/* Casting truncates or pads with blanks. */
+			const ofc_sema_type_t* type
+				= ofc_sema_type_create_character(1, lens[j], false);
+			char pad[256];
+			memset(pad, ' ', sizeof(pad));
+			memcpy(pad, expect[i],
+				(lens[i] < lens[j] ? lens[i] : lens[j]));
+			c = ofc_sema_typeval_cast(tv[i], type);
+			CHECK((lens[j] == 0) || equal(c, pad, lens[j]));
+			ofc_sema_typeval_delete(c);
+
+			ofc_sema_typeval_t* eq = ofc_sema_typeval_eq(tv[i], tv[j]);
+			bool logical;
+			if (lens[i] == lens[j])
+			{
+				CHECK(eq && ofc_sema_typeval_get_logical(eq, &logical)
+					&& (logical == (i == j)));
+			}
+			ofc_sema_typeval_delete(eq);
+		}
+	}
+
+	for (i = 0; i < LENS; i++)
+	{
+		CHECK(equal(tv[i], expect[i], lens[i]));
+		ofc_sema_typeval_delete(tv[i]);
+	}
+
+	ofc_sema_typeval_pool_cleanup();
+	return (failed ? 1 : 0);
+}
+END
+
+${CC:-cc} -I "$OFC_ROOT/include" -o check check.c \
+	"$OFC_ROOT/libofc.a" -lm -lpthread || fail "Failed to build check"
+./check || fail "CHARACTER typevals were corrupted"
+
+cat > char.f <<'END'
+      PROGRAM C
+      CHARACTER*4 S
+      CHARACTER*36 L
+      CHARACTER*64 M
+      LOGICAL E
+      PARAMETER (S = 'AB' // 'CD')
+      PARAMETER (L = 'ABCDEFGHIJKLMNOP' // 'QRSTUVWXYZ0123456789')
+      PARAMETER (M = L // S // L)
+      PARAMETER (E = S .EQ. 'ABCD')
+      CHARACTER*31 A
+      CHARACTER*32 B
+      CHARACTER*33 D
+      DATA A /'1234567890123456789012345678901'/
+      DATA B /'12345678901234567890123456789012'/
+      DATA D /'123456789012345678901234567890123'/
+      PRINT *, S, L, M, E, A, B, D
+      END
+END
+
+"$OFC" --sema-tree char.f > out.f 2> err.txt \
+	|| fail "Failed to analyse char.f: $(cat err.txt)"
+for decl in 'A = "1234567890123456789012345678901"' \
+	'B = "12345678901234567890123456789012"' \
+	'D = "123456789012345678901234567890123"'
+do
+	grep -qF "$decl" out.f || fail "Expected '$decl' in: $(cat out.f)"
+done
+
+exit 0
@@ -0,0 +1,289 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Generates the perfect hash tables used to look up intrinsics by
+   name, so the compiler needs no setup or allocation to find them. */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "intrinsic_list.h"
+
+
+typedef struct
+{
+	const char* name;
+	const char* type;
+	const char* list;
+	unsigned    index;
+} gen_key_t;
+
+typedef struct
+{
+	unsigned  slots, buckets;
+	uint32_t* disp;
+	int*      slot;
+} gen_table_t;
+
+
+static uint32_t gen_hash(const gen_key_t* key, uint32_t seed)
+{
+	return ofc_sema_intrinsic__hash(
+		key->name, strlen(key->name), seed);
+}
+
+static bool gen_name_valid(const char* name)
+{
+	for (; *name != '\0'; name++)
+	{
+		if (!isalnum((unsigned char)*name) && (*name != '_'))
+			return false;
+	}
+	return true;
+}
+
+/* Hash and displace, larger buckets are placed first while
+   there's the most room, each bucket searches for a seed
+   which puts all of its keys into free slots. */
+static bool gen_place(
+	const gen_key_t* key, unsigned count,
+	gen_table_t* table)
+{
+	unsigned* bucket_size = calloc(table->buckets, sizeof(unsigned));
+	unsigned* order       = malloc(table->buckets * sizeof(unsigned));
+	unsigned* slot        = malloc((count + 1) * sizeof(unsigned));
+	if (!bucket_size || !order || !slot)
+	{
+		free(bucket_size);
+		free(order);
+		free(slot);
+		return false;
+	}
+
+	unsigned i, j;
+	for (i = 0; i < count; i++)
+		bucket_size[gen_hash(&key[i], 0) & (table->buckets - 1)]++;
+
+	for (i = 0; i < table->buckets; i++)
+	{
+		for (j = i; (j > 0) && (bucket_size[order[j - 1]] < bucket_size[i]); j--)
+			order[j] = order[j - 1];
+		order[j] = i;
+	}
+
+	for (i = 0; i < table->slots; i++)
+		table->slot[i] = -1;
+
+	bool success = true;
+	for (i = 0; success && (i < table->buckets); i++)
+	{
+		unsigned b = order[i];
+		table->disp[b] = 0;
+		if (bucket_size[b] == 0)
+			continue;
+
+		uint32_t seed;
+		for (seed = 1; seed < 0x10000; seed++)
+		{
+			unsigned n = 0;
+			for (j = 0; j < count; j++)
+			{
+				if ((gen_hash(&key[j], 0) & (table->buckets - 1)) != b)
+					continue;
+
+				unsigned s = (gen_hash(&key[j], seed) & (table->slots - 1));
+				if (table->slot[s] >= 0)
+					break;
+
+				unsigned k;
+				for (k = 0; (k < n) && (slot[k] != s); k++);
+				if (k < n) break;
+
+				slot[n++] = s;
+			}
+			if (j < count)
+				continue;
+
+			for (j = 0, n = 0; j < count; j++)
+			{
+				if ((gen_hash(&key[j], 0) & (table->buckets - 1)) == b)
+					table->slot[slot[n++]] = j;
+			}
+			table->disp[b] = seed;
+			break;
+		}
+
+		success = (seed < 0x10000);
+	}
+
+	free(bucket_size);
+	free(order);
+	free(slot);
+	return success;
+}
+
+static bool gen_table(
+	FILE* fp, const char* prefix, const char* macro,
+	const gen_key_t* key, unsigned count)
+{
+	gen_table_t table = { 0, 0, NULL, NULL };
+
+	/* Start with the smallest table which fits and grow it
+	   until every bucket finds a seed. */
+	bool placed = false;
+	for (table.slots = 2; table.slots < count; table.slots <<= 1);
+	for (; !placed && (table.slots <= (1U << 16)); table.slots <<= 1)
+	{
+		table.buckets = (table.slots >= 16 ? (table.slots / 4) : 4);
+
+		free(table.disp);
+		free(table.slot);
+		table.disp = malloc(table.buckets * sizeof(uint32_t));
+		table.slot = malloc(table.slots * sizeof(int));
+		if (!table.disp || !table.slot)
+			break;
+
+		placed = gen_place(key, count, &table);
+		if (placed) break;
+	}
+
+	if (!placed)
+	{
+		free(table.disp);
+		free(table.slot);
+		return false;
+	}
+
+	fprintf(fp, "#define OFC_SEMA_INTRINSIC__%s_SLOTS   %u\n", macro, table.slots);
+	fprintf(fp, "#define OFC_SEMA_INTRINSIC__%s_BUCKETS %u\n\n", macro, table.buckets);
+
+	fprintf(fp, "static const uint32_t ofc_sema_intrinsic__%s_disp[%u] =\n{",
+		prefix, table.buckets);
+	unsigned i;
+	for (i = 0; i < table.buckets; i++)
+		fprintf(fp, "%s%u,", ((i % 8) == 0 ? "\n\t" : " "), table.disp[i]);
+	fprintf(fp, "\n};\n\n");
+
+	fprintf(fp, "static const ofc_sema_intrinsic_t ofc_sema_intrinsic__%s_table[%u] =\n{\n",
+		prefix, table.slots);
+	for (i = 0; i < table.slots; i++)
+	{
+		if (table.slot[i] < 0)
+			continue;
+
+		const gen_key_t* k = &key[table.slot[i]];
+		fprintf(fp, "\t[%u] = { .type = %s, .name = { \"%s\", %u },"
+			" .%s = &ofc_sema_intrinsic__%s_list[%u] },\n",
+			i, k->type, k->name, (unsigned)strlen(k->name),
+			k->list, k->list, k->index);
+	}
+	fprintf(fp, "};\n\n");
+
+	free(table.disp);
+	free(table.slot);
+	return true;
+}
+
+static bool gen_add(
+	gen_key_t** key, unsigned* count,
+	const char* name, const char* type,
+	const char* list, unsigned index)
+{
+	if (!gen_name_valid(name))
+	{
+		fprintf(stderr, "Error: Invalid intrinsic name '%s'\n", name);
+		return false;
+	}
+
+	/* Names are matched without case, so they must be unique. */
+	unsigned i;
+	for (i = 0; i < *count; i++)
+	{
+		if (strcasecmp((*key)[i].name, name) == 0)
+		{
+			fprintf(stderr, "Error: Duplicate intrinsic '%s'\n", name);
+			return false;
+		}
+	}
+
+	gen_key_t* nkey = realloc(*key, ((*count + 1) * sizeof(gen_key_t)));
+	if (!nkey) return false;
+	*key = nkey;
+
+	(*key)[(*count)++] = (gen_key_t){ name, type, list, index };
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <output>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	gen_key_t* func = NULL;
+	gen_key_t* subr = NULL;
+	unsigned func_count = 0, subr_count = 0;
+
+	bool success = true;
+	unsigned i;
+	for (i = 0; success && ofc_sema_intrinsic__op_list[i].name; i++)
+	{
+		success = gen_add(&func, &func_count,
+			ofc_sema_intrinsic__op_list[i].name,
+			"OFC_SEMA_INTRINSIC_OP", "op", i);
+	}
+	for (i = 0; success && ofc_sema_intrinsic__func_list[i].name; i++)
+	{
+		success = gen_add(&func, &func_count,
+			ofc_sema_intrinsic__func_list[i].name,
+			"OFC_SEMA_INTRINSIC_FUNC", "func", i);
+	}
+	for (i = 0; success && ofc_sema_intrinsic__subr_list[i].name; i++)
+	{
+		success = gen_add(&subr, &subr_count,
+			ofc_sema_intrinsic__subr_list[i].name,
+			"OFC_SEMA_INTRINSIC_SUBR", "subr", i);
+	}
+
+	FILE* fp = (success ? fopen(argv[1], "w") : NULL);
+	if (fp)
+	{
+		fprintf(fp, "/* Generated by tools/intrinsic_hash"
+			" from intrinsic_list.h, do not edit. */\n\n");
+		success = gen_table(fp, "func", "FUNC", func, func_count)
+			&& gen_table(fp, "subr", "SUBR", subr, subr_count);
+		success = (fclose(fp) == 0) && success;
+
+		if (!success)
+		{
+			fprintf(stderr, "Error: Failed to generate '%s'\n", argv[1]);
+			remove(argv[1]);
+		}
+	}
+	else if (success)
+	{
+		fprintf(stderr, "Error: Failed to open '%s'\n", argv[1]);
+		success = false;
+	}
+
+	free(func);
+	free(subr);
+	return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}